@@ -0,0 +1,70 @@
+#include <nanorange/algorithm/dary_heap.hpp>
+#include <nanorange/algorithm/make_heap.hpp>
+#include <nanorange/algorithm/pop_heap.hpp>
+#include <nanorange/algorithm/push_heap.hpp>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+namespace {
+
+// Heap operations as used by a priority queue: each iteration pops the top
+// element and pushes a new one, so the heap stays the same size
+template <typename Heap>
+void pop_push(benchmark::State& state)
+{
+    const auto n = static_cast<std::size_t>(state.range(0));
+    std::mt19937_64 gen(n);
+    std::vector<std::uint64_t> heap(n);
+    for (auto& x : heap) {
+        x = gen();
+    }
+    Heap::make(heap);
+
+    for (auto _ : state) {
+        Heap::pop(heap);
+        heap.back() = gen();
+        Heap::push(heap);
+    }
+    benchmark::DoNotOptimize(heap.front());
+    state.SetItemsProcessed(state.iterations());
+}
+
+struct binary_heap {
+    template <typename V>
+    static void make(V& v) { nano::make_heap(v); }
+
+    template <typename V>
+    static void pop(V& v) { nano::pop_heap(v); }
+
+    template <typename V>
+    static void push(V& v) { nano::push_heap(v); }
+};
+
+template <std::ptrdiff_t D>
+struct dary_heap {
+    template <typename V>
+    static void make(V& v) { nano::make_dary_heap<D>(v); }
+
+    template <typename V>
+    static void pop(V& v) { nano::pop_dary_heap<D>(v); }
+
+    template <typename V>
+    static void push(V& v) { nano::push_dary_heap<D>(v); }
+};
+
+void set_sizes(benchmark::internal::Benchmark* bench)
+{
+    for (int size : {1'000, 100'000, 1'000'000, 16'000'000}) {
+        bench->Arg(size);
+    }
+}
+
+} // namespace
+
+BENCHMARK_TEMPLATE(pop_push, binary_heap)->Apply(set_sizes);
+BENCHMARK_TEMPLATE(pop_push, dary_heap<4>)->Apply(set_sizes);
+BENCHMARK_TEMPLATE(pop_push, dary_heap<8>)->Apply(set_sizes);
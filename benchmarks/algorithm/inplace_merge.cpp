@@ -0,0 +1,67 @@
+#include <nanorange/algorithm/inplace_merge.hpp>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <nanorange/algorithm/sort.hpp>
+
+#include "../sort_common.hpp"
+
+namespace {
+
+// Each half of the input is sorted first, so that the distribution describes
+// how the two halves interleave
+template <typename F, typename T>
+void inplace_merge_vector(benchmark::State& state)
+{
+    auto input = bench::make_input<T>(state);
+    const auto middle = static_cast<std::ptrdiff_t>(input.size() / 2);
+    nano::sort(input.begin(), input.begin() + middle);
+    nano::sort(input.begin() + middle, input.end());
+
+    bench::run_on_copies(state, input,
+                         [middle](auto& v) { F{}(v, v.begin() + middle); });
+}
+
+struct nano_inplace_merge {
+    template <typename V, typename I>
+    void operator()(V& v, I middle) const
+    {
+        nano::inplace_merge(v, middle);
+    }
+};
+
+struct std_inplace_merge {
+    template <typename V, typename I>
+    void operator()(V& v, I middle) const
+    {
+        std::inplace_merge(v.begin(), middle, v.end());
+    }
+};
+
+} // namespace
+
+// int -------------------------------------------------
+
+BENCHMARK_TEMPLATE(inplace_merge_vector, nano_inplace_merge, int)
+    ->Apply(bench::set_sort_inputs);
+
+BENCHMARK_TEMPLATE(inplace_merge_vector, std_inplace_merge, int)
+    ->Apply(bench::set_sort_inputs);
+
+// string -------------------------------------------------
+
+BENCHMARK_TEMPLATE(inplace_merge_vector, nano_inplace_merge, std::string)
+    ->Apply(bench::set_sort_inputs);
+
+BENCHMARK_TEMPLATE(inplace_merge_vector, std_inplace_merge, std::string)
+    ->Apply(bench::set_sort_inputs);
+
+// large POD -------------------------------------------------
+
+BENCHMARK_TEMPLATE(inplace_merge_vector, nano_inplace_merge, bench::large_pod)
+    ->Apply(bench::set_sort_inputs);
+
+BENCHMARK_TEMPLATE(inplace_merge_vector, std_inplace_merge, bench::large_pod)
+    ->Apply(bench::set_sort_inputs);
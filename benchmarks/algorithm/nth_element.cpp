@@ -0,0 +1,58 @@
+#include <nanorange/algorithm/nth_element.hpp>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "../sort_common.hpp"
+
+namespace {
+
+// Finds the median
+template <typename F, typename T>
+void nth_element_vector(benchmark::State& state)
+{
+    bench::run_on_copies(state, bench::make_input<T>(state), F{});
+}
+
+struct nano_nth_element {
+    template <typename V>
+    void operator()(V& v) const
+    {
+        nano::nth_element(v, v.begin() + v.size() / 2);
+    }
+};
+
+struct std_nth_element {
+    template <typename V>
+    void operator()(V& v) const
+    {
+        std::nth_element(v.begin(), v.begin() + v.size() / 2, v.end());
+    }
+};
+
+} // namespace
+
+// int -------------------------------------------------
+
+BENCHMARK_TEMPLATE(nth_element_vector, nano_nth_element, int)
+    ->Apply(bench::set_sort_inputs);
+
+BENCHMARK_TEMPLATE(nth_element_vector, std_nth_element, int)
+    ->Apply(bench::set_sort_inputs);
+
+// string -------------------------------------------------
+
+BENCHMARK_TEMPLATE(nth_element_vector, nano_nth_element, std::string)
+    ->Apply(bench::set_sort_inputs);
+
+BENCHMARK_TEMPLATE(nth_element_vector, std_nth_element, std::string)
+    ->Apply(bench::set_sort_inputs);
+
+// large POD -------------------------------------------------
+
+BENCHMARK_TEMPLATE(nth_element_vector, nano_nth_element, bench::large_pod)
+    ->Apply(bench::set_sort_inputs);
+
+BENCHMARK_TEMPLATE(nth_element_vector, std_nth_element, bench::large_pod)
+    ->Apply(bench::set_sort_inputs);
@@ -0,0 +1,58 @@
+#include <nanorange/algorithm/partial_sort.hpp>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "../sort_common.hpp"
+
+namespace {
+
+// Sorts the smallest tenth of the elements into place
+template <typename F, typename T>
+void partial_sort_vector(benchmark::State& state)
+{
+    bench::run_on_copies(state, bench::make_input<T>(state), F{});
+}
+
+struct nano_partial_sort {
+    template <typename V>
+    void operator()(V& v) const
+    {
+        nano::partial_sort(v, v.begin() + v.size() / 10);
+    }
+};
+
+struct std_partial_sort {
+    template <typename V>
+    void operator()(V& v) const
+    {
+        std::partial_sort(v.begin(), v.begin() + v.size() / 10, v.end());
+    }
+};
+
+} // namespace
+
+// int -------------------------------------------------
+
+BENCHMARK_TEMPLATE(partial_sort_vector, nano_partial_sort, int)
+    ->Apply(bench::set_sort_inputs);
+
+BENCHMARK_TEMPLATE(partial_sort_vector, std_partial_sort, int)
+    ->Apply(bench::set_sort_inputs);
+
+// string -------------------------------------------------
+
+BENCHMARK_TEMPLATE(partial_sort_vector, nano_partial_sort, std::string)
+    ->Apply(bench::set_sort_inputs);
+
+BENCHMARK_TEMPLATE(partial_sort_vector, std_partial_sort, std::string)
+    ->Apply(bench::set_sort_inputs);
+
+// large POD -------------------------------------------------
+
+BENCHMARK_TEMPLATE(partial_sort_vector, nano_partial_sort, bench::large_pod)
+    ->Apply(bench::set_sort_inputs);
+
+BENCHMARK_TEMPLATE(partial_sort_vector, std_partial_sort, bench::large_pod)
+    ->Apply(bench::set_sort_inputs);
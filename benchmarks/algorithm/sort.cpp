@@ -0,0 +1,57 @@
+#include <nanorange/algorithm/sort.hpp>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "../sort_common.hpp"
+
+namespace {
+
+template <typename F, typename T>
+void sort_vector(benchmark::State& state)
+{
+    bench::run_on_copies(state, bench::make_input<T>(state), F{});
+}
+
+struct nano_sort {
+    template <typename V>
+    void operator()(V& v) const
+    {
+        nano::sort(v);
+    }
+};
+
+struct std_sort {
+    template <typename V>
+    void operator()(V& v) const
+    {
+        std::sort(v.begin(), v.end());
+    }
+};
+
+} // namespace
+
+// int -------------------------------------------------
+
+BENCHMARK_TEMPLATE(sort_vector, nano_sort, int)
+    ->Apply(bench::set_sort_inputs);
+
+BENCHMARK_TEMPLATE(sort_vector, std_sort, int)
+    ->Apply(bench::set_sort_inputs);
+
+// string -------------------------------------------------
+
+BENCHMARK_TEMPLATE(sort_vector, nano_sort, std::string)
+    ->Apply(bench::set_sort_inputs);
+
+BENCHMARK_TEMPLATE(sort_vector, std_sort, std::string)
+    ->Apply(bench::set_sort_inputs);
+
+// large POD -------------------------------------------------
+
+BENCHMARK_TEMPLATE(sort_vector, nano_sort, bench::large_pod)
+    ->Apply(bench::set_sort_inputs);
+
+BENCHMARK_TEMPLATE(sort_vector, std_sort, bench::large_pod)
+    ->Apply(bench::set_sort_inputs);
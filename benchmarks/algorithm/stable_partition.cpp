@@ -0,0 +1,63 @@
+#include <nanorange/algorithm/stable_partition.hpp>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "../sort_common.hpp"
+
+namespace {
+
+// Moves the elements which are smaller than the median key to the front
+template <typename F, typename T>
+void stable_partition_vector(benchmark::State& state)
+{
+    const T pivot = bench::generator(bench::type_t<T>{})(
+        static_cast<int>(state.range(1) / 2));
+    const auto pred = [&pivot](const T& elem) { return elem < pivot; };
+
+    bench::run_on_copies(state, bench::make_input<T>(state),
+                         [&pred](auto& v) { F{}(v, pred); });
+}
+
+struct nano_stable_partition {
+    template <typename V, typename Pred>
+    void operator()(V& v, Pred pred) const
+    {
+        nano::stable_partition(v, pred);
+    }
+};
+
+struct std_stable_partition {
+    template <typename V, typename Pred>
+    void operator()(V& v, Pred pred) const
+    {
+        std::stable_partition(v.begin(), v.end(), pred);
+    }
+};
+
+} // namespace
+
+// int -------------------------------------------------
+
+BENCHMARK_TEMPLATE(stable_partition_vector, nano_stable_partition, int)
+    ->Apply(bench::set_sort_inputs);
+
+BENCHMARK_TEMPLATE(stable_partition_vector, std_stable_partition, int)
+    ->Apply(bench::set_sort_inputs);
+
+// string -------------------------------------------------
+
+BENCHMARK_TEMPLATE(stable_partition_vector, nano_stable_partition, std::string)
+    ->Apply(bench::set_sort_inputs);
+
+BENCHMARK_TEMPLATE(stable_partition_vector, std_stable_partition, std::string)
+    ->Apply(bench::set_sort_inputs);
+
+// large POD -------------------------------------------------
+
+BENCHMARK_TEMPLATE(stable_partition_vector, nano_stable_partition, bench::large_pod)
+    ->Apply(bench::set_sort_inputs);
+
+BENCHMARK_TEMPLATE(stable_partition_vector, std_stable_partition, bench::large_pod)
+    ->Apply(bench::set_sort_inputs);
@@ -0,0 +1,57 @@
+#include <nanorange/algorithm/stable_sort.hpp>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "../sort_common.hpp"
+
+namespace {
+
+template <typename F, typename T>
+void stable_sort_vector(benchmark::State& state)
+{
+    bench::run_on_copies(state, bench::make_input<T>(state), F{});
+}
+
+struct nano_stable_sort {
+    template <typename V>
+    void operator()(V& v) const
+    {
+        nano::stable_sort(v);
+    }
+};
+
+struct std_stable_sort {
+    template <typename V>
+    void operator()(V& v) const
+    {
+        std::stable_sort(v.begin(), v.end());
+    }
+};
+
+} // namespace
+
+// int -------------------------------------------------
+
+BENCHMARK_TEMPLATE(stable_sort_vector, nano_stable_sort, int)
+    ->Apply(bench::set_sort_inputs);
+
+BENCHMARK_TEMPLATE(stable_sort_vector, std_stable_sort, int)
+    ->Apply(bench::set_sort_inputs);
+
+// string -------------------------------------------------
+
+BENCHMARK_TEMPLATE(stable_sort_vector, nano_stable_sort, std::string)
+    ->Apply(bench::set_sort_inputs);
+
+BENCHMARK_TEMPLATE(stable_sort_vector, std_stable_sort, std::string)
+    ->Apply(bench::set_sort_inputs);
+
+// large POD -------------------------------------------------
+
+BENCHMARK_TEMPLATE(stable_sort_vector, nano_stable_sort, bench::large_pod)
+    ->Apply(bench::set_sort_inputs);
+
+BENCHMARK_TEMPLATE(stable_sort_vector, std_stable_sort, bench::large_pod)
+    ->Apply(bench::set_sort_inputs);
@@ -0,0 +1,86 @@
+#include <nanorange/algorithm/lower_bound.hpp>
+#include <nanorange/algorithm/static_search_index.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+namespace {
+
+constexpr std::size_t num_queries = 1 << 16;
+
+// Returns n sorted, distinct keys, spaced out so that half of the queries miss
+std::vector<std::uint32_t> make_keys(std::size_t n)
+{
+    std::vector<std::uint32_t> keys(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        keys[i] = static_cast<std::uint32_t>(2 * i);
+    }
+    return keys;
+}
+
+std::vector<std::uint32_t> make_queries(std::size_t n)
+{
+    std::vector<std::uint32_t> queries(num_queries);
+    std::mt19937 gen(static_cast<unsigned>(n));
+    std::uniform_int_distribution<std::uint32_t> dist(
+        0, static_cast<std::uint32_t>(2 * n));
+    for (auto& q : queries) {
+        q = dist(gen);
+    }
+    return queries;
+}
+
+template <typename Lookup>
+void run_queries(benchmark::State& state,
+                 const std::vector<std::uint32_t>& queries, Lookup lookup)
+{
+    for (auto _ : state) {
+        std::size_t sum = 0;
+        for (auto q : queries) {
+            sum += lookup(q);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() *
+                            static_cast<std::int64_t>(queries.size()));
+}
+
+void lower_bound_sorted(benchmark::State& state)
+{
+    const auto n = static_cast<std::size_t>(state.range(0));
+    const auto keys = make_keys(n);
+    run_queries(state, make_queries(n), [&](std::uint32_t q) {
+        return static_cast<std::size_t>(nano::lower_bound(keys, q) -
+                                        keys.begin());
+    });
+}
+
+template <nano::search_index_layout Layout>
+void lower_bound_index(benchmark::State& state)
+{
+    const auto n = static_cast<std::size_t>(state.range(0));
+    const nano::static_search_index index(make_keys(n), Layout);
+    run_queries(state, make_queries(n),
+                [&](std::uint32_t q) { return index.lower_bound(q); });
+}
+
+void set_sizes(benchmark::internal::Benchmark* bench)
+{
+    for (int size : {1'000, 100'000, 10'000'000, 50'000'000}) {
+        bench->Arg(size);
+    }
+}
+
+} // namespace
+
+BENCHMARK(lower_bound_sorted)->Apply(set_sizes);
+
+BENCHMARK_TEMPLATE(lower_bound_index, nano::search_index_layout::eytzinger)
+    ->Apply(set_sizes);
+
+BENCHMARK_TEMPLATE(lower_bound_index, nano::search_index_layout::btree)
+    ->Apply(set_sizes);
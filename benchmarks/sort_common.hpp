@@ -0,0 +1,172 @@
+// nanorange/benchmarks/sort_common.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Inputs shared by the sorting and partitioning benchmarks
+
+#ifndef NANORANGE_BENCHMARKS_SORT_COMMON_HPP_INCLUDED
+#define NANORANGE_BENCHMARKS_SORT_COMMON_HPP_INCLUDED
+
+#include <nanorange/algorithm/transform.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+namespace bench {
+
+template <typename T>
+struct type_t {
+    using type = T;
+};
+
+// Big enough that moving elements costs more than comparing them
+struct large_pod {
+    int key;
+    char payload[124];
+
+    friend bool operator==(const large_pod& lhs, const large_pod& rhs)
+    {
+        return lhs.key == rhs.key;
+    }
+
+    friend bool operator!=(const large_pod& lhs, const large_pod& rhs)
+    {
+        return lhs.key != rhs.key;
+    }
+
+    friend bool operator<(const large_pod& lhs, const large_pod& rhs)
+    {
+        return lhs.key < rhs.key;
+    }
+
+    friend bool operator>(const large_pod& lhs, const large_pod& rhs)
+    {
+        return lhs.key > rhs.key;
+    }
+
+    friend bool operator<=(const large_pod& lhs, const large_pod& rhs)
+    {
+        return lhs.key <= rhs.key;
+    }
+
+    friend bool operator>=(const large_pod& lhs, const large_pod& rhs)
+    {
+        return lhs.key >= rhs.key;
+    }
+};
+
+// Each generator maps an integer key to an element, such that the elements
+// are ordered in the same way as their keys
+
+inline auto generator(type_t<int>)
+{
+    return [](int key) { return key; };
+}
+
+// Long enough to need a heap allocation, and with a common prefix so that
+// comparisons have to look past the first few characters
+inline auto generator(type_t<std::string>)
+{
+    return [](int key) {
+        std::string digits = std::to_string(key);
+        return "nanorange-" + std::string(12 - digits.size(), '0') + digits;
+    };
+}
+
+inline auto generator(type_t<large_pod>)
+{
+    return [](int key) {
+        large_pod p{key, {}};
+        p.payload[0] = static_cast<char>(key);
+        return p;
+    };
+}
+
+enum class distribution : int {
+    sorted,
+    reversed,
+    organ_pipe,
+    few_unique,
+    random
+};
+
+constexpr const char* distribution_names[] = {
+    "sorted", "reversed", "organ_pipe", "few_unique", "random"
+};
+
+// Returns n keys in the range [0, n), arranged according to dist
+inline std::vector<int> make_keys(distribution dist, int n)
+{
+    std::vector<int> keys(static_cast<std::size_t>(n));
+    std::mt19937 gen(n);
+
+    for (int i = 0; i < n; ++i) {
+        int& k = keys[static_cast<std::size_t>(i)];
+        switch (dist) {
+        case distribution::sorted: k = i; break;
+        case distribution::reversed: k = n - 1 - i; break;
+        case distribution::organ_pipe: k = i < n / 2 ? 2 * i : 2 * (n - 1 - i) + 1; break;
+        case distribution::few_unique: k = static_cast<int>(gen() % 16); break;
+        case distribution::random: k = static_cast<int>(gen() % static_cast<unsigned>(n)); break;
+        }
+    }
+
+    return keys;
+}
+
+template <typename T>
+std::vector<T> make_input(distribution dist, int n)
+{
+    const auto keys = make_keys(dist, n);
+    std::vector<T> vec(keys.size());
+    nano::transform(keys, vec.begin(), generator(type_t<T>{}));
+    return vec;
+}
+
+// Benchmarks are registered with the arguments {distribution, size}
+inline void set_sort_inputs(benchmark::internal::Benchmark* bench)
+{
+    for (int dist = 0; dist < 5; ++dist) {
+        for (int size : {1'000, 100'000}) {
+            bench->Args({dist, size});
+        }
+    }
+}
+
+template <typename T>
+std::vector<T> make_input(benchmark::State& state)
+{
+    const auto dist = static_cast<distribution>(state.range(0));
+    const auto n = static_cast<int>(state.range(1));
+    state.SetLabel(distribution_names[state.range(0)]);
+    return make_input<T>(dist, n);
+}
+
+// Runs op on a fresh copy of input in each iteration. Making the copy is not
+// timed.
+template <typename T, typename Op>
+void run_on_copies(benchmark::State& state, const std::vector<T>& input, Op op)
+{
+    auto vec = input;
+    for (auto _ : state) {
+        state.PauseTiming();
+        vec = input;
+        state.ResumeTiming();
+
+        op(vec);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() *
+                            static_cast<std::int64_t>(input.size()));
+}
+
+} // namespace bench
+
+#endif
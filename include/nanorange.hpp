@@ -9,6 +9,7 @@
 
 #include <nanorange/algorithm.hpp>
 #include <nanorange/concepts.hpp>
+#include <nanorange/execution.hpp>
 #include <nanorange/functional.hpp>
 #include <nanorange/iterator.hpp>
 #include <nanorange/memory.hpp>
@@ -12,11 +12,15 @@
 #include <nanorange/algorithm/all_of.hpp>
 #include <nanorange/algorithm/any_of.hpp>
 #include <nanorange/algorithm/binary_search.hpp>
+#include <nanorange/algorithm/block_merge_sort.hpp>
+#include <nanorange/algorithm/boyer_moore_horspool_searcher.hpp>
 #include <nanorange/algorithm/clamp.hpp>
 #include <nanorange/algorithm/copy.hpp>
 #include <nanorange/algorithm/count.hpp>
+#include <nanorange/algorithm/dary_heap.hpp>
 #include <nanorange/algorithm/equal.hpp>
 #include <nanorange/algorithm/equal_range.hpp>
+#include <nanorange/algorithm/equal_range_batch.hpp>
 #include <nanorange/algorithm/fill.hpp>
 #include <nanorange/algorithm/fill_n.hpp>
 #include <nanorange/algorithm/find.hpp>
@@ -35,6 +39,7 @@
 #include <nanorange/algorithm/is_sorted_until.hpp>
 #include <nanorange/algorithm/lexicographical_compare.hpp>
 #include <nanorange/algorithm/lower_bound.hpp>
+#include <nanorange/algorithm/lower_bound_batch.hpp>
 #include <nanorange/algorithm/make_heap.hpp>
 #include <nanorange/algorithm/max.hpp>
 #include <nanorange/algorithm/max_element.hpp>
@@ -56,6 +61,8 @@
 #include <nanorange/algorithm/pop_heap.hpp>
 #include <nanorange/algorithm/prev_permutation.hpp>
 #include <nanorange/algorithm/push_heap.hpp>
+#include <nanorange/algorithm/radix_sort.hpp>
+#include <nanorange/algorithm/reduce.hpp>
 #include <nanorange/algorithm/remove.hpp>
 #include <nanorange/algorithm/remove_copy.hpp>
 #include <nanorange/algorithm/remove_copy_if.hpp>
@@ -69,6 +76,7 @@
 #include <nanorange/algorithm/rotate.hpp>
 #include <nanorange/algorithm/rotate_copy.hpp>
 #include <nanorange/algorithm/search.hpp>
+#include <nanorange/algorithm/search_any.hpp>
 #include <nanorange/algorithm/search_n.hpp>
 #include <nanorange/algorithm/set_difference.hpp>
 #include <nanorange/algorithm/set_intersection.hpp>
@@ -80,10 +88,13 @@
 #include <nanorange/algorithm/sort_heap.hpp>
 #include <nanorange/algorithm/stable_partition.hpp>
 #include <nanorange/algorithm/stable_sort.hpp>
+#include <nanorange/algorithm/static_search_index.hpp>
 #include <nanorange/algorithm/swap_ranges.hpp>
 #include <nanorange/algorithm/transform.hpp>
+#include <nanorange/algorithm/transform_reduce.hpp>
 #include <nanorange/algorithm/unique.hpp>
 #include <nanorange/algorithm/unique_copy.hpp>
 #include <nanorange/algorithm/upper_bound.hpp>
+#include <nanorange/algorithm/upper_bound_batch.hpp>
 
 #endif
@@ -0,0 +1,99 @@
+// nanorange/algorithm/block_merge_sort.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_ALGORITHM_BLOCK_MERGE_SORT_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_BLOCK_MERGE_SORT_HPP_INCLUDED
+
+#include <nanorange/algorithm/stable_sort.hpp>
+#include <nanorange/detail/algorithm/block_merge_sort.hpp>
+
+NANO_BEGIN_NAMESPACE
+
+// Extension: stably sorts a range like stable_sort(), but never asks for
+// more than O(sqrt(n)) elements' worth of extra space, for callers which
+// cannot afford a buffer of half the range. Takes O(n log n) time; if even
+// that much space is not available, falls back to merging by rotations,
+// which takes O(n log^2 n). stable_sort() does the same when it cannot get
+// its usual buffer.
+
+namespace detail {
+
+struct block_merge_sort_fn {
+private:
+    template <typename I, typename Comp, typename Proj>
+    static void impl(I first, I last, Comp& comp, Proj& proj,
+                     temporary_resource* resource = nullptr)
+    {
+        if (!detail::block_merge_sort(first, last, comp, proj, resource)) {
+            stable_sort_fn::inplace_stable_sort(std::move(first),
+                                                std::move(last), comp, proj);
+        }
+    }
+
+public:
+    template <typename I, typename S, typename Comp = ranges::less,
+              typename Proj = identity>
+    std::enable_if_t<random_access_iterator<I> && sentinel_for<S, I> &&
+                         sortable<I, Comp, Proj>, I>
+    operator()(I first, S last, Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        const auto ilast = nano::next(first, last);
+        block_merge_sort_fn::impl(std::move(first), ilast, comp, proj);
+        return ilast;
+    }
+
+    template <typename Rng, typename Comp = ranges::less,
+              typename Proj = identity>
+    std::enable_if_t<random_access_range<Rng> &&
+                         sortable<iterator_t<Rng>, Comp, Proj>,
+                     borrowed_iterator_t<Rng>>
+    operator()(Rng&& rng, Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        auto first = nano::begin(rng);
+        const auto last = nano::next(first, nano::end(rng));
+        block_merge_sort_fn::impl(std::move(first), last, comp, proj);
+        return last;
+    }
+
+#if NANO_HAS_MEMORY_RESOURCE
+    // Extension: as above, but the scratch space is obtained from resource
+    template <typename I, typename S, typename Comp = ranges::less,
+              typename Proj = identity>
+    std::enable_if_t<random_access_iterator<I> && sentinel_for<S, I> &&
+                         sortable<I, Comp, Proj>, I>
+    operator()(std::pmr::memory_resource* resource, I first, S last,
+               Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        const auto ilast = nano::next(first, last);
+        block_merge_sort_fn::impl(std::move(first), ilast, comp, proj,
+                                  resource);
+        return ilast;
+    }
+
+    template <typename Rng, typename Comp = ranges::less,
+              typename Proj = identity>
+    std::enable_if_t<random_access_range<Rng> &&
+                         sortable<iterator_t<Rng>, Comp, Proj>,
+                     borrowed_iterator_t<Rng>>
+    operator()(std::pmr::memory_resource* resource, Rng&& rng,
+               Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        auto first = nano::begin(rng);
+        const auto last = nano::next(first, nano::end(rng));
+        block_merge_sort_fn::impl(std::move(first), last, comp, proj,
+                                  resource);
+        return last;
+    }
+#endif
+};
+
+} // namespace detail
+
+NANO_INLINE_VAR(detail::block_merge_sort_fn, block_merge_sort)
+
+NANO_END_NAMESPACE
+
+#endif
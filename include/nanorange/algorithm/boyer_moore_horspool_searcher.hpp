@@ -0,0 +1,168 @@
+// nanorange/algorithm/boyer_moore_horspool_searcher.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_ALGORITHM_BOYER_MOORE_HORSPOOL_SEARCHER_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_BOYER_MOORE_HORSPOOL_SEARCHER_HPP_INCLUDED
+
+#include <nanorange/algorithm/search.hpp>
+
+#include <array>
+#include <unordered_map>
+
+NANO_BEGIN_NAMESPACE
+
+// Extension: a searcher for use with search(haystack, searcher), which
+// precomputes the Boyer-Moore-Horspool skip table for a needle once so that
+// it can be reused across many haystacks. Mismatches typically skip ahead by
+// close to the length of the needle, so long needles are found in sublinear
+// time; the worst case is O(nm).
+//
+// Like std::boyer_moore_horspool_searcher, the searcher refers to the needle
+// rather than copying it, so the needle must outlive the searcher. The
+// projected needle elements are compared with ranges::equal_to against the
+// projected haystack elements, which must have the same value type. One-byte
+// integral and enumeration types (including char and std::byte) use a flat
+// 256-entry table; other types must be hashable with std::hash.
+
+namespace detail {
+
+template <typename Key, typename Diff, bool = is_byte_like<Key>>
+struct bmh_skip_table {
+    explicit bmh_skip_table(Diff default_skip)
+        : default_skip_(default_skip)
+    {}
+
+    void set(const Key& key, Diff skip) { map_[key] = skip; }
+
+    Diff operator[](const Key& key) const
+    {
+        const auto it = map_.find(key);
+        return it == map_.end() ? default_skip_ : it->second;
+    }
+
+private:
+    std::unordered_map<Key, Diff> map_{};
+    Diff default_skip_;
+};
+
+template <typename Key, typename Diff>
+struct bmh_skip_table<Key, Diff, true> {
+    explicit bmh_skip_table(Diff default_skip)
+    {
+        table_.fill(default_skip);
+    }
+
+    void set(const Key& key, Diff skip)
+    {
+        table_[static_cast<unsigned char>(key)] = skip;
+    }
+
+    Diff operator[](const Key& key) const
+    {
+        return table_[static_cast<unsigned char>(key)];
+    }
+
+private:
+    std::array<Diff, 256> table_;
+};
+
+} // namespace detail
+
+template <typename I, typename Proj = identity>
+class boyer_moore_horspool_searcher {
+    static_assert(random_access_iterator<I>,
+                  "boyer_moore_horspool_searcher requires a random-access needle");
+
+    using key_type = iter_value_t<projected<I, Proj>>;
+    using diff_t = iter_difference_t<I>;
+
+public:
+    template <typename S, std::enable_if_t<sized_sentinel_for<S, I>, int> = 0>
+    boyer_moore_horspool_searcher(I first, S last, Proj proj = Proj{})
+        : first_(std::move(first)),
+          m_(last - first_),
+          proj_(std::move(proj)),
+          skip_(m_)
+    {
+        // The skip for each element is its distance from the end of the
+        // needle, ignoring the last element itself
+        for (diff_t i = 0; i < m_ - 1; ++i) {
+            skip_.set(nano::invoke(proj_, first_[i]), m_ - 1 - i);
+        }
+    }
+
+    template <typename Rng,
+              std::enable_if_t<borrowed_range<Rng> && sized_range<Rng> &&
+                                   same_as<iterator_t<Rng>, I>, int> = 0>
+    explicit boyer_moore_horspool_searcher(Rng&& needle, Proj proj = Proj{})
+        : boyer_moore_horspool_searcher(nano::begin(needle),
+                                        nano::begin(needle) +
+                                            nano::distance(needle),
+                                        std::move(proj))
+    {}
+
+    template <typename I2, typename S2, typename Proj2 = identity>
+    std::enable_if_t<random_access_iterator<I2> && sized_sentinel_for<S2, I2> &&
+                         same_as<iter_value_t<projected<I2, Proj2>>, key_type> &&
+                         indirectly_comparable<I2, I, ranges::equal_to, Proj2, Proj>,
+                     subrange<I2>>
+    operator()(I2 first, S2 last, Proj2 proj2 = Proj2{}) const
+    {
+        const iter_difference_t<I2> n = last - first;
+        if (m_ == 0) {
+            return {first, first};
+        }
+        if (n < m_) {
+            first += n;
+            return {first, first};
+        }
+
+        const auto matches = [&](auto&& x, diff_t i) -> bool {
+            return nano::invoke(ranges::equal_to{}, std::forward<decltype(x)>(x),
+                                nano::invoke(proj_, first_[i]));
+        };
+
+        // Compare the last element of each candidate position first: on a
+        // mismatch, the skip table says how far we can safely jump
+        const iter_difference_t<I2> last_start = n - m_;
+        for (iter_difference_t<I2> j = 0; j <= last_start;) {
+            auto&& key = nano::invoke(proj2, first[j + (m_ - 1)]);
+            if (matches(key, m_ - 1)) {
+                diff_t i = 0;
+                while (i < m_ - 1 && matches(nano::invoke(proj2, first[j + i]), i)) {
+                    ++i;
+                }
+                if (i == m_ - 1) {
+                    return {first + j, first + (j + m_)};
+                }
+            }
+            j += skip_[key];
+        }
+
+        first += n;
+        return {first, first};
+    }
+
+private:
+    I first_;
+    diff_t m_;
+    Proj proj_;
+    detail::bmh_skip_table<key_type, diff_t> skip_;
+};
+
+template <typename I, typename S, typename Proj = identity,
+          std::enable_if_t<sized_sentinel_for<S, I>, int> = 0>
+boyer_moore_horspool_searcher(I, S, Proj = Proj{})
+    -> boyer_moore_horspool_searcher<I, Proj>;
+
+template <typename Rng, typename Proj = identity,
+          std::enable_if_t<range<Rng>, int> = 0>
+boyer_moore_horspool_searcher(Rng&&, Proj = Proj{})
+    -> boyer_moore_horspool_searcher<iterator_t<Rng>, Proj>;
+
+NANO_END_NAMESPACE
+
+#endif
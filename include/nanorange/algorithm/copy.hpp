@@ -7,6 +7,7 @@
 #ifndef NANORANGE_ALGORITHM_COPY_HPP_INCLUDED
 #define NANORANGE_ALGORITHM_COPY_HPP_INCLUDED
 
+#include <nanorange/detail/algorithm/memmove.hpp>
 #include <nanorange/detail/algorithm/result_types.hpp>
 #include <nanorange/ranges.hpp>
 
@@ -19,6 +20,26 @@ namespace detail {
 
 struct copy_fn {
 private:
+    // Trivially copyable types in contiguous storage are copied with a single
+    // memmove(). This isn't possible during constant evaluation, so in that
+    // case we fall back to the element-by-element loop below.
+    template <typename I, typename S, typename O>
+    static constexpr std::enable_if_t<sized_sentinel_for<S, I> &&
+                                          is_memmove_copyable<I, O>,
+                                      copy_result<I, O>>
+    impl(I first, S last, O result, priority_tag<2>)
+    {
+        const auto dist = last - first;
+
+        if (!detail::is_constant_evaluated() && dist > 0) {
+            result = detail::memmove_n(first, dist, result);
+            return {first + dist, std::move(result)};
+        }
+
+        return impl(std::move(first), std::move(last), std::move(result),
+                    priority_tag<1>{});
+    }
+
     // If we know the distance between first and last, we can use that
     // information to (potentially) allow better codegen
     template <typename I, typename S, typename O>
@@ -49,6 +70,33 @@ private:
         return {std::move(first), std::move(result)};
     }
 
+    // Contiguous ranges may have iterators which we cannot tell are
+    // contiguous (see is_std_contiguous_iterator), so go via data() instead
+    template <typename Rng, typename O>
+    static constexpr std::enable_if_t<
+        contiguous_range<Rng> && sized_range<Rng> &&
+            is_memmove_copyable<range_pointer_t<Rng>, O>,
+        copy_result<iterator_t<Rng>, O>>
+    range_impl(Rng& rng, O result, priority_tag<1>)
+    {
+        const auto dist = nano::distance(rng);
+
+        if (!detail::is_constant_evaluated() && dist > 0) {
+            result = detail::memmove_n(nano::data(rng), dist, result);
+            return {nano::begin(rng) + dist, std::move(result)};
+        }
+
+        return range_impl(rng, std::move(result), priority_tag<0>{});
+    }
+
+    template <typename Rng, typename O>
+    static constexpr copy_result<iterator_t<Rng>, O>
+    range_impl(Rng& rng, O result, priority_tag<0>)
+    {
+        return copy_fn::impl(nano::begin(rng), nano::end(rng),
+                             std::move(result), priority_tag<2>{});
+    }
+
 public:
     template <typename I, typename S, typename O>
     constexpr std::enable_if_t<input_iterator<I> && sentinel_for<S, I> &&
@@ -58,7 +106,7 @@ public:
     operator()(I first, S last, O result) const
     {
         return copy_fn::impl(std::move(first), std::move(last),
-                             std::move(result), priority_tag<1>{});
+                             std::move(result), priority_tag<2>{});
     }
 
     template <typename Rng, typename O>
@@ -67,8 +115,7 @@ public:
                                copy_result<borrowed_iterator_t<Rng>, O>>
     operator()(Rng&& rng, O result) const
     {
-        return copy_fn::impl(nano::begin(rng), nano::end(rng),
-                             std::move(result), priority_tag<1>{});
+        return copy_fn::range_impl(rng, std::move(result), priority_tag<1>{});
     }
 };
 
@@ -82,11 +129,23 @@ using copy_n_result = in_out_result<I, O>;
 namespace detail {
 
 struct copy_n_fn {
+private:
     template <typename I, typename O>
-    constexpr std::enable_if_t<input_iterator<I> && weakly_incrementable<O> &&
-                                   indirectly_copyable<I, O>,
-                               copy_n_result<I, O>>
-    operator()(I first, iter_difference_t<I> n, O result) const
+    static constexpr std::enable_if_t<is_memmove_copyable<I, O>,
+                                      copy_n_result<I, O>>
+    impl(I first, iter_difference_t<I> n, O result, priority_tag<1>)
+    {
+        if (!detail::is_constant_evaluated() && n > 0) {
+            result = detail::memmove_n(first, n, result);
+            return {first + n, std::move(result)};
+        }
+
+        return impl(std::move(first), n, std::move(result), priority_tag<0>{});
+    }
+
+    template <typename I, typename O>
+    static constexpr copy_n_result<I, O>
+    impl(I first, iter_difference_t<I> n, O result, priority_tag<0>)
     {
         for (iter_difference_t<I> i{}; i < n; i++) {
             *result = *first;
@@ -96,6 +155,17 @@ struct copy_n_fn {
 
         return {std::move(first), std::move(result)};
     }
+
+public:
+    template <typename I, typename O>
+    constexpr std::enable_if_t<input_iterator<I> && weakly_incrementable<O> &&
+                                   indirectly_copyable<I, O>,
+                               copy_n_result<I, O>>
+    operator()(I first, iter_difference_t<I> n, O result) const
+    {
+        return copy_n_fn::impl(std::move(first), n, std::move(result),
+                               priority_tag<1>{});
+    }
 };
 
 } // namespace detail
@@ -163,9 +233,26 @@ namespace detail {
 
 struct copy_backward_fn {
 private:
+    template <typename I1, typename S1, typename I2>
+    static constexpr std::enable_if_t<is_memmove_copyable<I1, I2>,
+                                      copy_backward_result<I1, I2>>
+    impl(I1 first, S1 last, I2 result, priority_tag<1>)
+    {
+        I1 last_it = nano::next(first, std::move(last));
+        const auto dist = last_it - first;
+
+        if (!detail::is_constant_evaluated() && dist > 0) {
+            result = detail::memmove_backward_n(last_it, dist, result);
+            return {std::move(last_it), std::move(result)};
+        }
+
+        return impl(std::move(first), std::move(last_it), std::move(result),
+                    priority_tag<0>{});
+    }
+
     template <typename I1, typename S1, typename I2>
     static constexpr copy_backward_result<I1, I2>
-    impl(I1 first, S1 last, I2 result)
+    impl(I1 first, S1 last, I2 result, priority_tag<0>)
     {
         I1 last_it = nano::next(first, std::move(last));
         I1 it = last_it;
@@ -186,7 +273,7 @@ public:
     operator()(I1 first, S1 last, I2 result) const
     {
         return copy_backward_fn::impl(std::move(first), std::move(last),
-                                      std::move(result));
+                                      std::move(result), priority_tag<1>{});
     }
 
     template <typename Rng, typename I>
@@ -197,7 +284,7 @@ public:
     operator()(Rng&& rng, I result) const
     {
         return copy_backward_fn::impl(nano::begin(rng), nano::end(rng),
-                                      std::move(result));
+                                      std::move(result), priority_tag<1>{});
     }
 };
 
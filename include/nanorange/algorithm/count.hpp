@@ -7,6 +7,7 @@
 #ifndef NANORANGE_ALGORITHM_COUNT_HPP_INCLUDED
 #define NANORANGE_ALGORITHM_COUNT_HPP_INCLUDED
 
+#include <nanorange/detail/algorithm/simd.hpp>
 #include <nanorange/ranges.hpp>
 
 NANO_BEGIN_NAMESPACE
@@ -65,6 +66,46 @@ NANO_INLINE_VAR(detail::count_if_fn, count_if)
 namespace detail {
 
 struct count_fn {
+private:
+    template <typename I, typename S, typename T, typename Proj>
+    static constexpr iter_difference_t<I> impl(I first, S last,
+                                               const T& value, Proj& proj)
+    {
+        if constexpr (sized_sentinel_for<S, I> &&
+                      is_simd_find_candidate<I, T, Proj>) {
+            if (!detail::is_constant_evaluated()) {
+                const auto n = last - first;
+                if (n == 0) {
+                    return 0;
+                }
+                const auto ptr = detail::to_address(first);
+                return detail::simd_count(ptr, ptr + n, value);
+            }
+        }
+
+        const auto pred = [&value] (const auto& t) { return t == value; };
+        return count_if_fn::impl(std::move(first), std::move(last),
+                                 pred, proj);
+    }
+
+    template <typename Rng, typename T, typename Proj>
+    static constexpr range_difference_t<Rng> range_impl(Rng& rng,
+                                                        const T& value,
+                                                        Proj& proj)
+    {
+        if constexpr (contiguous_range<Rng> && sized_range<Rng> &&
+                      is_simd_find_candidate<range_pointer_t<Rng>, T, Proj>) {
+            if (!detail::is_constant_evaluated()) {
+                const auto ptr = nano::data(rng);
+                return detail::simd_count(ptr, ptr + nano::distance(rng),
+                                          value);
+            }
+        }
+
+        return count_fn::impl(nano::begin(rng), nano::end(rng), value, proj);
+    }
+
+public:
     template <typename I, typename S, typename T, typename Proj = identity>
     constexpr std::enable_if_t<
         input_iterator<I> && sentinel_for<S, I> &&
@@ -72,9 +113,7 @@ struct count_fn {
         iter_difference_t<I>>
     operator()(I first, S last, const T& value, Proj proj = Proj{}) const
     {
-        const auto pred = [&value] (const auto& t) { return t == value; };
-        return count_if_fn::impl(std::move(first), std::move(last),
-                                 pred, proj);
+        return count_fn::impl(std::move(first), std::move(last), value, proj);
     }
 
     template <typename Rng, typename T, typename Proj = identity>
@@ -85,9 +124,7 @@ struct count_fn {
         range_difference_t<Rng>>
     operator()(Rng&& rng, const T& value, Proj proj = Proj{}) const
     {
-        const auto pred = [&value] (const auto& t) { return t == value; };
-        return count_if_fn::impl(nano::begin(rng), nano::end(rng),
-                                 pred, proj);
+        return count_fn::range_impl(rng, value, proj);
     }
 };
 
@@ -0,0 +1,283 @@
+// nanorange/algorithm/dary_heap.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_ALGORITHM_DARY_HEAP_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_DARY_HEAP_HPP_INCLUDED
+
+#include <nanorange/detail/algorithm/heap_sift.hpp>
+#include <nanorange/ranges.hpp>
+
+NANO_BEGIN_NAMESPACE
+
+// Extension: heap algorithms for heaps in which each element has D children
+// rather than two. make_dary_heap<D>, push_dary_heap<D>, pop_dary_heap<D>,
+// sort_dary_heap<D>, is_dary_heap<D> and is_dary_heap_until<D> behave like
+// their binary counterparts, but must only be used on ranges which are
+// D-ary heaps.
+//
+// A D-ary heap is log2(D) times shallower than a binary heap, so
+// push_dary_heap does fewer comparisons than push_heap. pop_dary_heap
+// compares all D children at each level, so it does more comparisons than
+// pop_heap; with D = 4 it runs at about the same speed.
+// Note that a binary heap is a D-ary heap only for D = 2.
+
+namespace detail {
+
+template <std::ptrdiff_t D>
+struct sort_dary_heap_fn;
+
+template <std::ptrdiff_t D>
+struct is_dary_heap_fn;
+
+template <std::ptrdiff_t D>
+struct push_dary_heap_fn {
+    static_assert(D >= 2, "A heap must have at least two children per element");
+
+    template <typename I, typename S, typename Comp = ranges::less,
+              typename Proj = identity>
+    constexpr std::enable_if_t<random_access_iterator<I> && sentinel_for<S, I> &&
+                                   sortable<I, Comp, Proj>, I>
+    operator()(I first, S last, Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        const auto n = nano::distance(first, last);
+        detail::dary_sift_up_n<D>(first, n, comp, proj);
+        return first + n;
+    }
+
+    template <typename Rng, typename Comp = ranges::less, typename Proj = identity>
+    constexpr std::enable_if_t<random_access_range<Rng> &&
+                                   sortable<iterator_t<Rng>, Comp, Proj>,
+                               borrowed_iterator_t<Rng>>
+    operator()(Rng&& rng, Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        const auto n = nano::distance(rng);
+        detail::dary_sift_up_n<D>(nano::begin(rng), n, comp, proj);
+        return nano::begin(rng) + n;
+    }
+};
+
+template <std::ptrdiff_t D>
+struct pop_dary_heap_fn {
+    static_assert(D >= 2, "A heap must have at least two children per element");
+
+private:
+    friend struct sort_dary_heap_fn<D>;
+
+    template <typename I, typename Comp, typename Proj>
+    static constexpr I impl(I first, iter_difference_t<I> n, Comp& comp,
+                            Proj& proj)
+    {
+        if (n > 1) {
+            nano::iter_swap(first, first + (n - 1));
+            detail::dary_sift_down_n<D>(first, n - 1, first, comp, proj);
+        }
+
+        return first + n;
+    }
+
+public:
+    template <typename I, typename S, typename Comp = ranges::less,
+              typename Proj = identity>
+    constexpr std::enable_if_t<random_access_iterator<I> && sentinel_for<S, I> &&
+                                   sortable<I, Comp, Proj>, I>
+    operator()(I first, S last, Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        const auto n = nano::distance(first, last);
+        return pop_dary_heap_fn::impl(std::move(first), n, comp, proj);
+    }
+
+    template <typename Rng, typename Comp = ranges::less, typename Proj = identity>
+    constexpr std::enable_if_t<random_access_range<Rng> &&
+                                   sortable<iterator_t<Rng>, Comp, Proj>,
+                               borrowed_iterator_t<Rng>>
+    operator()(Rng&& rng, Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        return pop_dary_heap_fn::impl(nano::begin(rng), nano::distance(rng),
+                                      comp, proj);
+    }
+};
+
+template <std::ptrdiff_t D>
+struct make_dary_heap_fn {
+    static_assert(D >= 2, "A heap must have at least two children per element");
+
+private:
+    template <typename I, typename Comp, typename Proj>
+    static constexpr I impl(I first, iter_difference_t<I> n, Comp& comp,
+                            Proj& proj)
+    {
+        if (n > 1) {
+            // start from the last element with children
+            for (auto start = (n - 2) / D; start >= 0; --start) {
+                detail::dary_sift_down_n<D>(first, n, first + start, comp,
+                                            proj);
+            }
+        }
+
+        return first + n;
+    }
+
+public:
+    template <typename I, typename S, typename Comp = ranges::less,
+              typename Proj = identity>
+    constexpr std::enable_if_t<random_access_iterator<I> && sentinel_for<S, I> &&
+                                   sortable<I, Comp, Proj>, I>
+    operator()(I first, S last, Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        const auto n = nano::distance(first, last);
+        return make_dary_heap_fn::impl(std::move(first), n, comp, proj);
+    }
+
+    template <typename Rng, typename Comp = ranges::less, typename Proj = identity>
+    constexpr std::enable_if_t<random_access_range<Rng> &&
+                                   sortable<iterator_t<Rng>, Comp, Proj>,
+                               borrowed_iterator_t<Rng>>
+    operator()(Rng&& rng, Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        return make_dary_heap_fn::impl(nano::begin(rng), nano::distance(rng),
+                                       comp, proj);
+    }
+};
+
+template <std::ptrdiff_t D>
+struct sort_dary_heap_fn {
+    static_assert(D >= 2, "A heap must have at least two children per element");
+
+private:
+    template <typename I, typename Comp, typename Proj>
+    static constexpr I impl(I first, iter_difference_t<I> n, Comp& comp,
+                            Proj& proj)
+    {
+        for (auto i = n; i > 1; --i) {
+            pop_dary_heap_fn<D>::impl(first, i, comp, proj);
+        }
+
+        return first + n;
+    }
+
+public:
+    template <typename I, typename S, typename Comp = ranges::less,
+              typename Proj = identity>
+    constexpr std::enable_if_t<random_access_iterator<I> && sentinel_for<S, I> &&
+                                   sortable<I, Comp, Proj>, I>
+    operator()(I first, S last, Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        const auto n = nano::distance(first, last);
+        return sort_dary_heap_fn::impl(std::move(first), n, comp, proj);
+    }
+
+    template <typename Rng, typename Comp = ranges::less, typename Proj = identity>
+    constexpr std::enable_if_t<random_access_range<Rng> &&
+                                   sortable<iterator_t<Rng>, Comp, Proj>,
+                               borrowed_iterator_t<Rng>>
+    operator()(Rng&& rng, Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        return sort_dary_heap_fn::impl(nano::begin(rng), nano::distance(rng),
+                                       comp, proj);
+    }
+};
+
+template <std::ptrdiff_t D>
+struct is_dary_heap_until_fn {
+    static_assert(D >= 2, "A heap must have at least two children per element");
+
+private:
+    friend struct is_dary_heap_fn<D>;
+
+    template <typename I, typename Comp, typename Proj>
+    static constexpr I impl(I first, const iter_difference_t<I> n, Comp& comp,
+                            Proj& proj)
+    {
+        for (iter_difference_t<I> c = 1; c < n; ++c) {
+            if (nano::invoke(comp, nano::invoke(proj, first[(c - 1) / D]),
+                             nano::invoke(proj, first[c]))) {
+                return first + c;
+            }
+        }
+
+        return first + n;
+    }
+
+public:
+    template <typename I, typename S, typename Comp = ranges::less,
+              typename Proj = identity>
+    constexpr std::enable_if_t<
+        random_access_iterator<I> && sentinel_for<S, I> &&
+            indirect_strict_weak_order<Comp, projected<I, Proj>>,
+        I>
+    operator()(I first, S last, Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        const auto n = nano::distance(first, last);
+        return is_dary_heap_until_fn::impl(std::move(first), n, comp, proj);
+    }
+
+    template <typename Rng, typename Comp = ranges::less, typename Proj = identity>
+    constexpr std::enable_if_t<
+        random_access_range<Rng> &&
+            indirect_strict_weak_order<Comp, projected<iterator_t<Rng>, Proj>>,
+        borrowed_iterator_t<Rng>>
+    operator()(Rng&& rng, Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        return is_dary_heap_until_fn::impl(nano::begin(rng),
+                                           nano::distance(rng), comp, proj);
+    }
+};
+
+template <std::ptrdiff_t D>
+struct is_dary_heap_fn {
+    template <typename I, typename S, typename Comp = ranges::less,
+              typename Proj = identity>
+    constexpr std::enable_if_t<
+        random_access_iterator<I> && sentinel_for<S, I> &&
+            indirect_strict_weak_order<Comp, projected<I, Proj>>,
+        bool>
+    operator()(I first, S last, Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        const auto n = nano::distance(first, last);
+        return is_dary_heap_until_fn<D>::impl(first, n, comp, proj) ==
+               first + n;
+    }
+
+    template <typename Rng, typename Comp = ranges::less, typename Proj = identity>
+    constexpr std::enable_if_t<
+        random_access_range<Rng> &&
+            indirect_strict_weak_order<Comp, projected<iterator_t<Rng>, Proj>>,
+        bool>
+    operator()(Rng&& rng, Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        const auto n = nano::distance(rng);
+        return is_dary_heap_until_fn<D>::impl(nano::begin(rng), n, comp,
+                                              proj) == nano::begin(rng) + n;
+    }
+};
+
+} // namespace detail
+
+inline namespace function_objects {
+
+template <std::ptrdiff_t D>
+inline constexpr detail::push_dary_heap_fn<D> push_dary_heap{};
+
+template <std::ptrdiff_t D>
+inline constexpr detail::pop_dary_heap_fn<D> pop_dary_heap{};
+
+template <std::ptrdiff_t D>
+inline constexpr detail::make_dary_heap_fn<D> make_dary_heap{};
+
+template <std::ptrdiff_t D>
+inline constexpr detail::sort_dary_heap_fn<D> sort_dary_heap{};
+
+template <std::ptrdiff_t D>
+inline constexpr detail::is_dary_heap_until_fn<D> is_dary_heap_until{};
+
+template <std::ptrdiff_t D>
+inline constexpr detail::is_dary_heap_fn<D> is_dary_heap{};
+
+} // namespace function_objects
+
+NANO_END_NAMESPACE
+
+#endif
@@ -7,6 +7,7 @@
 #ifndef NANORANGE_ALGORITHM_EQUAL_HPP_INCLUDED
 #define NANORANGE_ALGORITHM_EQUAL_HPP_INCLUDED
 
+#include <nanorange/detail/algorithm/simd.hpp>
 #include <nanorange/iterator/operations.hpp>
 #include <nanorange/ranges.hpp>
 
@@ -38,6 +39,16 @@ private:
     static constexpr bool impl3(I1 first1, S1 last1, I2 first2, Pred pred,
                                 Proj1& proj1, Proj2& proj2)
     {
+        if constexpr (sized_sentinel_for<S1, I1> &&
+                      is_simd_mismatch_candidate<I1, I2, Pred, Proj1, Proj2>) {
+            if (!detail::is_constant_evaluated()) {
+                const auto n = last1 - first1;
+                return n == 0 ||
+                       detail::simd_equal(detail::to_address(first1),
+                                          detail::to_address(first2), n);
+            }
+        }
+
         while (first1 != last1) {
             if (!nano::invoke(pred, nano::invoke(proj1, *first1),
                               nano::invoke(proj2, *first2))) {
@@ -125,8 +136,16 @@ public:
             return false;
         }
 
-        return equal_fn::impl3(nano::begin(rng1), nano::end(rng1),
-                               nano::begin(rng2), pred, proj1, proj2);
+        return detail::simd_range_dispatch<is_simd_mismatch_candidate<
+            range_pointer_t<Rng1>, range_pointer_t<Rng2>, Pred, Proj1, Proj2>>(
+            rng1, rng2,
+            [](auto ptr1, auto n, auto ptr2, auto) {
+                return detail::simd_equal(ptr1, ptr2, n);
+            },
+            [&] {
+                return equal_fn::impl3(nano::begin(rng1), nano::end(rng1),
+                                       nano::begin(rng2), pred, proj1, proj2);
+            });
     }
 
     // Two ranges, not both sized
@@ -9,6 +9,7 @@
 
 #include <nanorange/algorithm/lower_bound.hpp>
 #include <nanorange/algorithm/upper_bound.hpp>
+#include <nanorange/detail/algorithm/gallop.hpp>
 #include <nanorange/views/subrange.hpp>
 
 NANO_BEGIN_NAMESPACE
@@ -21,6 +22,18 @@ private:
     static constexpr subrange<I> impl(I first, S last, const T& value,
                                       Comp& comp, Proj& proj)
     {
+        // There are usually only a few elements equal to value, so rather
+        // than a second binary search of the whole range, look for the end
+        // of them with an exponential search from the lower bound
+        if constexpr (random_access_iterator<I> && sized_sentinel_for<S, I>) {
+            I lower = lower_bound_fn::impl(std::move(first), last, value, comp,
+                                           proj);
+            I upper = detail::gallop(lower, last, [&](auto&& x) {
+                return !nano::invoke(comp, value, nano::invoke(proj, x));
+            });
+            return {std::move(lower), std::move(upper)};
+        }
+
         return {lower_bound_fn::impl(first, last, value, comp, proj),
                 upper_bound_fn::impl(first, last, value, comp, proj)};
     }
@@ -0,0 +1,94 @@
+// nanorange/algorithm/equal_range_batch.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_ALGORITHM_EQUAL_RANGE_BATCH_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_EQUAL_RANGE_BATCH_HPP_INCLUDED
+
+#include <nanorange/detail/algorithm/batch_search.hpp>
+#include <nanorange/detail/algorithm/gallop.hpp>
+#include <nanorange/views/subrange.hpp>
+
+NANO_BEGIN_NAMESPACE
+
+// Extension: as lower_bound_batch, but writes
+// equal_range(haystack, value, comp, proj) for each query
+
+template <typename I, typename O>
+using equal_range_batch_result = in_out_result<I, O>;
+
+namespace detail {
+
+struct equal_range_batch_fn {
+private:
+    // The batched search finds the lower bound for each query. The upper
+    // bound is usually close by, in memory which is already in cache, so we
+    // gallop forward to it.
+    template <typename I1, typename I2, typename S2, typename O, typename Comp,
+              typename Proj>
+    static constexpr equal_range_batch_result<I2, O>
+    impl(I1 first1, iter_difference_t<I1> n1, I2 first2, S2 last2, O out,
+         Comp& comp, Proj& proj)
+    {
+        const I1 last1 = first1 + n1;
+        auto last = detail::batch_bound<bound_kind::lower>(
+            first1, n1, std::move(first2), std::move(last2), comp, proj,
+            [&](const I2& it, iter_difference_t<I1> pos) {
+                auto&& value = *it;
+                const I1 lower = first1 + pos;
+                I1 upper = detail::gallop(lower, last1, [&](auto&& x) {
+                    return !nano::invoke(comp, value, nano::invoke(proj, x));
+                });
+                *out = subrange<I1>{lower, std::move(upper)};
+                ++out;
+            });
+        return {std::move(last), std::move(out)};
+    }
+
+public:
+    template <typename I1, typename S1, typename I2, typename S2, typename O,
+              typename Comp = ranges::less, typename Proj = identity>
+    constexpr std::enable_if_t<
+        random_access_iterator<I1> && sized_sentinel_for<S1, I1> &&
+            forward_iterator<I2> && sentinel_for<S2, I2> &&
+            weakly_incrementable<O> && writable<O, subrange<I1>> &&
+            indirect_strict_weak_order<Comp, I2, projected<I1, Proj>>,
+        equal_range_batch_result<I2, O>>
+    operator()(I1 first1, S1 last1, I2 first2, S2 last2, O out,
+               Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        const auto n1 = last1 - first1;
+        return equal_range_batch_fn::impl(std::move(first1), n1,
+                                          std::move(first2), std::move(last2),
+                                          std::move(out), comp, proj);
+    }
+
+    template <typename Rng1, typename Rng2, typename O,
+              typename Comp = ranges::less, typename Proj = identity>
+    constexpr std::enable_if_t<
+        random_access_range<Rng1> && sized_range<Rng1> &&
+            borrowed_range<Rng1> && forward_range<Rng2> &&
+            weakly_incrementable<O> &&
+            writable<O, subrange<iterator_t<Rng1>>> &&
+            indirect_strict_weak_order<Comp, iterator_t<Rng2>,
+                                       projected<iterator_t<Rng1>, Proj>>,
+        equal_range_batch_result<borrowed_iterator_t<Rng2>, O>>
+    operator()(Rng1&& rng1, Rng2&& rng2, O out, Comp comp = Comp{},
+               Proj proj = Proj{}) const
+    {
+        return equal_range_batch_fn::impl(nano::begin(rng1),
+                                          nano::distance(rng1),
+                                          nano::begin(rng2), nano::end(rng2),
+                                          std::move(out), comp, proj);
+    }
+};
+
+} // namespace detail
+
+NANO_INLINE_VAR(detail::equal_range_batch_fn, equal_range_batch)
+
+NANO_END_NAMESPACE
+
+#endif
@@ -7,6 +7,7 @@
 #ifndef NANORANGE_ALGORITHM_FIND_HPP_INCLUDED
 #define NANORANGE_ALGORITHM_FIND_HPP_INCLUDED
 
+#include <nanorange/detail/algorithm/simd.hpp>
 #include <nanorange/ranges.hpp>
 
 NANO_BEGIN_NAMESPACE
@@ -60,6 +61,55 @@ NANO_INLINE_VAR(detail::find_if_fn, find_if)
 namespace detail {
 
 struct find_fn {
+private:
+    template <typename I, typename S, typename T, typename Proj>
+    static constexpr I impl(I first, S last, const T& value, Proj& proj)
+    {
+        if constexpr (sized_sentinel_for<S, I> &&
+                      is_simd_find_candidate<I, T, Proj>) {
+            if (!detail::is_constant_evaluated()) {
+                const auto n = last - first;
+                if (n == 0) {
+                    return first;
+                }
+                const auto ptr = detail::to_address(first);
+                return first + (detail::simd_find(ptr, ptr + n, value) - ptr);
+            }
+        }
+
+        const auto pred = [&value] (const auto& t) {
+            using U = remove_cvref_t<decltype(t)>;
+            // Convert integers to their common type up front, as == would,
+            // so that mixing signedness doesn't warn
+            if constexpr (std::is_integral<U>::value &&
+                          std::is_integral<T>::value) {
+                using C = std::common_type_t<U, T>;
+                return static_cast<C>(t) == static_cast<C>(value);
+            } else {
+                return t == value;
+            }
+        };
+        return find_if_fn::impl(std::move(first), std::move(last), pred, proj);
+    }
+
+    template <typename Rng, typename T, typename Proj>
+    static constexpr iterator_t<Rng> range_impl(Rng& rng, const T& value,
+                                                Proj& proj)
+    {
+        return detail::simd_range_dispatch<
+            is_simd_find_candidate<range_pointer_t<Rng>, T, Proj>>(
+            rng,
+            [&](auto ptr, auto n) {
+                return nano::begin(rng) +
+                       (detail::simd_find(ptr, ptr + n, value) - ptr);
+            },
+            [&] {
+                return find_fn::impl(nano::begin(rng), nano::end(rng), value,
+                                     proj);
+            });
+    }
+
+public:
     template <typename I, typename S, typename T, typename Proj = identity>
     constexpr std::enable_if_t<
         input_iterator<I> && sentinel_for<S, I> &&
@@ -67,8 +117,7 @@ struct find_fn {
         I>
     operator()(I first, S last, const T& value, Proj proj = Proj{}) const
     {
-        const auto pred = [&value] (const auto& t) { return t == value; };
-        return find_if_fn::impl(std::move(first), std::move(last), pred, proj);
+        return find_fn::impl(std::move(first), std::move(last), value, proj);
     }
 
     template <typename Rng, typename T, typename Proj = identity>
@@ -79,8 +128,7 @@ struct find_fn {
         borrowed_iterator_t<Rng>>
     operator()(Rng&& rng, const T& value, Proj proj = Proj{}) const
     {
-        const auto pred = [&value] (const auto& t) { return t == value; };
-        return find_if_fn::impl(nano::begin(rng), nano::end(rng), pred, proj);
+        return find_fn::range_impl(rng, value, proj);
     }
 };
 } // namespace detail
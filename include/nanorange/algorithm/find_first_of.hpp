@@ -7,6 +7,7 @@
 #ifndef NANORANGE_ALGORITHM_FIND_FIRST_OF_HPP_INCLUDED
 #define NANORANGE_ALGORITHM_FIND_FIRST_OF_HPP_INCLUDED
 
+#include <nanorange/detail/algorithm/simd.hpp>
 #include <nanorange/ranges.hpp>
 
 NANO_BEGIN_NAMESPACE
@@ -15,13 +16,57 @@ NANO_BEGIN_NAMESPACE
 
 namespace detail {
 
+// Whether find_first_of() may look for the needle elements as a set of bytes
+template <typename I1, typename I2, typename Pred, typename Proj1,
+          typename Proj2>
+inline constexpr bool is_simd_find_first_of_candidate =
+    is_simd_iterator<I1> && sizeof(iter_value_t<I1>) == 1 &&
+    (std::is_integral<iter_value_t<I2>>::value ||
+     std::is_same<iter_value_t<I2>, iter_value_t<I1>>::value) &&
+    std::is_same<Pred, ranges::equal_to>::value &&
+    std::is_same<Proj1, identity>::value &&
+    std::is_same<Proj2, identity>::value;
+
 struct find_first_of_fn {
 private:
+    template <typename T, typename I2, typename S2>
+    static const T* simd_impl(const T* first1, const T* last1, I2 first2,
+                              S2 last2)
+    {
+        // Needle values which no T could be equal to are left out
+        simd_byte_set set;
+        for (; first2 != last2; ++first2) {
+            T t;
+            if (detail::simd_narrow(*first2, t)) {
+                unsigned char c;
+                std::memcpy(&c, &t, 1);
+                set.insert(c);
+            }
+        }
+        return detail::simd_find_first_of(first1, last1, set);
+    }
+
     template <typename I1, typename S1, typename I2, typename S2, typename Pred,
               typename Proj1, typename Proj2>
     static constexpr I1 impl(I1 first1, S1 last1, I2 first2, S2 last2,
                              Pred& pred, Proj1& proj1, Proj2& proj2)
     {
+        if constexpr (sized_sentinel_for<S1, I1> &&
+                      is_simd_find_first_of_candidate<I1, I2, Pred, Proj1,
+                                                      Proj2>) {
+            if (!detail::is_constant_evaluated()) {
+                const auto n = last1 - first1;
+                if (n == 0) {
+                    return first1;
+                }
+                const auto ptr = detail::to_address(first1);
+                return first1 + (find_first_of_fn::simd_impl(
+                                     ptr, ptr + n, std::move(first2),
+                                     std::move(last2)) -
+                                 ptr);
+            }
+        }
+
         for (; first1 != last1; ++first1) {
             for (I2 it = first2; it != last2; ++it) {
                 if (nano::invoke(pred, nano::invoke(proj1, *first1),
@@ -61,9 +106,21 @@ public:
     operator()(Rng1&& rng1, Rng2&& rng2, Pred pred = Pred{},
                Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
     {
-        return find_first_of_fn::impl(nano::begin(rng1), nano::end(rng1),
-                                      nano::begin(rng2), nano::end(rng2),
-                                      pred, proj1, proj2);
+        return detail::simd_range_dispatch<is_simd_find_first_of_candidate<
+            range_pointer_t<Rng1>, iterator_t<Rng2>, Pred, Proj1, Proj2>>(
+            rng1,
+            [&](auto ptr, auto n) {
+                return nano::begin(rng1) +
+                       (find_first_of_fn::simd_impl(ptr, ptr + n,
+                                                    nano::begin(rng2),
+                                                    nano::end(rng2)) -
+                        ptr);
+            },
+            [&] {
+                return find_first_of_fn::impl(
+                    nano::begin(rng1), nano::end(rng1), nano::begin(rng2),
+                    nano::end(rng2), pred, proj1, proj2);
+            });
     }
 };
 
@@ -8,6 +8,8 @@
 #define NANORANGE_ALGORITHM_FOR_EACH_HPP_INCLUDED
 
 #include <nanorange/detail/algorithm/result_types.hpp>
+#include <nanorange/detail/execution/parallel_for.hpp>
+#include <nanorange/execution.hpp>
 #include <nanorange/ranges.hpp>
 
 NANO_BEGIN_NAMESPACE
@@ -32,6 +34,29 @@ private:
         return {first, std::move(fun)};
     }
 
+    // With a parallel policy, sized random-access ranges are split into
+    // chunks, each of which is processed using its own copy of fun
+    template <typename EP, typename I, typename S, typename Proj, typename Fun>
+    static I impl(EP&&, I first, S last, Fun& fun, Proj& proj)
+    {
+        if constexpr (is_parallel_policy_v<EP> && random_access_iterator<I> &&
+                      sized_sentinel_for<S, I>) {
+            const auto n = static_cast<std::ptrdiff_t>(last - first);
+            constexpr auto chunk = parallel_chunk_size<iter_value_t<I>>;
+            if (detail::use_parallel_chunks(n, chunk)) {
+                detail::parallel_for_chunks(
+                    n, chunk,
+                    [&first, &fun, &proj](std::ptrdiff_t b, std::ptrdiff_t e) {
+                        Fun f = fun;
+                        for_each_fn::impl(first + b, first + e, f, proj);
+                    });
+                return first + n;
+            }
+        }
+        return for_each_fn::impl(std::move(first), std::move(last), fun, proj)
+            .in;
+    }
+
 public:
     template <typename I, typename S, typename Proj = identity, typename Fun>
     constexpr std::enable_if_t<
@@ -54,6 +79,33 @@ public:
         return for_each_fn::impl(nano::begin(rng), nano::end(rng),
                                  fun, proj);
     }
+
+    // Extension: as above, but using the given execution policy. As the
+    // function may be copied, only the end iterator is returned.
+    template <typename EP, typename I, typename S, typename Proj = identity,
+              typename Fun>
+    std::enable_if_t<
+        is_execution_policy_v<remove_cvref_t<EP>> && forward_iterator<I> &&
+            sentinel_for<S, I> && copy_constructible<Fun> &&
+            indirect_unary_invocable<Fun, projected<I, Proj>>,
+        I>
+    operator()(EP&& policy, I first, S last, Fun fun, Proj proj = Proj{}) const
+    {
+        return for_each_fn::impl(std::forward<EP>(policy), std::move(first),
+                                 std::move(last), fun, proj);
+    }
+
+    template <typename EP, typename Rng, typename Proj = identity, typename Fun>
+    std::enable_if_t<
+        is_execution_policy_v<remove_cvref_t<EP>> && forward_range<Rng> &&
+            copy_constructible<Fun> &&
+            indirect_unary_invocable<Fun, projected<iterator_t<Rng>, Proj>>,
+        borrowed_iterator_t<Rng>>
+    operator()(EP&& policy, Rng&& rng, Fun fun, Proj proj = Proj{}) const
+    {
+        return for_each_fn::impl(std::forward<EP>(policy), nano::begin(rng),
+                                 nano::end(rng), fun, proj);
+    }
 };
 } // namespace detail
 
@@ -7,6 +7,7 @@
 #ifndef NANORANGE_ALGORITHM_INCLUDES_HPP_INCLUDED
 #define NANORANGE_ALGORITHM_INCLUDES_HPP_INCLUDED
 
+#include <nanorange/detail/algorithm/gallop.hpp>
 #include <nanorange/ranges.hpp>
 
 NANO_BEGIN_NAMESPACE
@@ -20,6 +21,10 @@ private:
      static constexpr bool impl(I1 first1, S1 last1, I2 first2, S2 last2,
                                 Comp& comp, Proj1& proj1, Proj2& proj2)
     {
+        // With random access, count how many elements of range1 in a row we
+        // skip over so that we can gallop through long runs
+        [[maybe_unused]] std::ptrdiff_t run = 0;
+
         while (first2 != last2) {
             // If range1 is done but we still have elements in range2, then
             // it is not a subset
@@ -37,12 +42,24 @@ private:
             // Now we know that that !(r2 < r1). If we also have !(r1 < r2),
             // then it must be equal, so in range1 -- so move onto the next
             // element
-            if (!nano::invoke(comp, nano::invoke(proj1, *first1),
-                              nano::invoke(proj2, *first2))) {
+            const bool equal = !nano::invoke(comp, nano::invoke(proj1, *first1),
+                                             nano::invoke(proj2, *first2));
+            if (equal) {
                 ++first2;
             }
 
             ++first1;
+
+            if constexpr (is_gallop_candidate<I1, S1, I2, S2>) {
+                run = equal ? 0 : run + 1;
+                if (run == gallop_threshold) {
+                    first1 = detail::gallop(first1, last1, [&](auto&& x) {
+                        return nano::invoke(comp, nano::invoke(proj1, x),
+                                            nano::invoke(proj2, *first2));
+                    });
+                    run = 0;
+                }
+            }
         }
 
         return true;
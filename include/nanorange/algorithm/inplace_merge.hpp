@@ -130,6 +130,9 @@ private:
         }
     }
 
+    // Once the buffered half is exhausted, the remaining elements of the
+    // other half are already in their final positions, so we stop there
+    // rather than moving them onto themselves
     template <typename I, typename Buf, typename Comp, typename Proj>
     static void impl_buffered(I first, I middle, I last,
                               iter_difference_t<I> len1, iter_difference_t<I> len2,
@@ -137,32 +140,48 @@ private:
     {
         if (len1 <= len2) {
             nano::move(first, middle, nano::back_inserter(buf));
-            nano::merge(
-                nano::make_move_iterator(buf.begin()),
-                nano::make_move_sentinel(buf.end()),
-                nano::make_move_iterator(std::move(middle)),
-                nano::make_move_sentinel(std::move(last)),
-                std::move(first), std::ref(comp), std::ref(proj), std::ref(proj));
+            auto buf_first = buf.begin();
+            const auto buf_last = buf.end();
+
+            while (buf_first != buf_last) {
+                if (middle == last) {
+                    nano::move(buf_first, buf_last, std::move(first));
+                    break;
+                }
+                if (nano::invoke(comp, nano::invoke(proj, *middle),
+                                 nano::invoke(proj, *buf_first))) {
+                    *first = nano::iter_move(middle);
+                    ++middle;
+                } else {
+                    *first = std::move(*buf_first);
+                    ++buf_first;
+                }
+                ++first;
+            }
         } else {
             nano::move(middle, last, nano::back_inserter(buf));
-            using ri_t = nano::reverse_iterator<I>;
-            // TODO: C++17's not_fn would be useful
-            auto not_comp = [&comp] (auto&& a, auto&& b) {
-                return !nano::invoke(comp, std::forward<decltype(a)>(a),
-                        std::forward<decltype(b)>(b));
-            };
-            nano::merge(
-                nano::make_move_iterator(ri_t{std::move(middle)}),
-                nano::make_move_sentinel(ri_t{std::move(first)}),
-                nano::make_move_iterator(nano::rbegin(buf)),
-                nano::make_move_sentinel(nano::rend(buf)),
-                nano::make_reverse_iterator(std::move(last)),
-                not_comp, std::ref(proj), std::ref(proj));
+            const auto buf_first = buf.begin();
+            auto buf_last = buf.end();
+
+            while (buf_first != buf_last) {
+                if (middle == first) {
+                    nano::move_backward(buf_first, buf_last, std::move(last));
+                    break;
+                }
+                if (nano::invoke(comp, nano::invoke(proj, *(buf_last - 1)),
+                                 nano::invoke(proj, *nano::prev(middle)))) {
+                    *--last = nano::iter_move(--middle);
+                } else {
+                    *--last = std::move(*--buf_last);
+                }
+            }
         }
+        buf.clear();
     }
 
     template <typename I, typename S, typename Comp, typename Proj>
-    static I impl(I first, I middle, S last, Comp& comp, Proj& proj)
+    static I impl(I first, I middle, S last, Comp& comp, Proj& proj,
+                  temporary_resource* resource = nullptr)
     {
         auto dist1 = nano::distance(first, middle);
         I ilast = middle;
@@ -173,7 +192,7 @@ private:
         }
 
         const auto sz = (nano::min)(dist1, dist2);
-        auto buf = detail::temporary_vector<iter_value_t<I>>(sz);
+        auto buf = detail::temporary_vector<iter_value_t<I>>(sz, resource);
 
         if (buf.capacity() >= static_cast<std::size_t>(sz)) {
             impl_buffered(std::move(first), std::move(middle), std::move(ilast),
@@ -205,6 +224,31 @@ public:
         return inplace_merge_fn::impl(nano::begin(rng), std::move(middle),
                                       nano::end(rng), comp, proj);
     }
+
+#if NANO_HAS_MEMORY_RESOURCE
+    // Extension: as above, but any scratch space is obtained from resource
+    template <typename I, typename S, typename Comp = ranges::less, typename Proj = identity>
+    std::enable_if_t<bidirectional_iterator<I> && sentinel_for<S, I> &&
+                         sortable<I, Comp, Proj>, I>
+    operator()(std::pmr::memory_resource* resource, I first, I middle, S last,
+               Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        return inplace_merge_fn::impl(std::move(first), std::move(middle),
+                                      std::move(last), comp, proj, resource);
+    }
+
+    template <typename Rng, typename Comp = ranges::less, typename Proj = identity>
+    std::enable_if_t<bidirectional_range<Rng> &&
+                         sortable<iterator_t<Rng>, Comp, Proj>,
+                     borrowed_iterator_t<Rng>>
+    operator()(std::pmr::memory_resource* resource, Rng&& rng,
+               iterator_t<Rng> middle, Comp comp = Comp{},
+               Proj proj = Proj{}) const
+    {
+        return inplace_merge_fn::impl(nano::begin(rng), std::move(middle),
+                                      nano::end(rng), comp, proj, resource);
+    }
+#endif
 };
 
 }
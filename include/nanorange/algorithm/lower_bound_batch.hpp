@@ -0,0 +1,28 @@
+// nanorange/algorithm/lower_bound_batch.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_ALGORITHM_LOWER_BOUND_BATCH_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_LOWER_BOUND_BATCH_HPP_INCLUDED
+
+#include <nanorange/detail/algorithm/batch_search.hpp>
+
+NANO_BEGIN_NAMESPACE
+
+// Extension: looks up each value in the range of queries in the sorted
+// random-access haystack, writing lower_bound(haystack, value, comp, proj)
+// to the output iterator for each in turn. The searches are run in groups,
+// in lockstep, so that their cache misses overlap; sorted runs of queries
+// are also searched for in successively narrower parts of the haystack.
+
+template <typename I, typename O>
+using lower_bound_batch_result = in_out_result<I, O>;
+
+NANO_INLINE_VAR(detail::bound_batch_fn<detail::bound_kind::lower>,
+                lower_bound_batch)
+
+NANO_END_NAMESPACE
+
+#endif
@@ -8,6 +8,7 @@
 #define NANORANGE_ALGORITHM_MERGE_HPP_INCLUDED
 
 #include <nanorange/algorithm/copy.hpp>
+#include <nanorange/detail/algorithm/gallop.hpp>
 #include <nanorange/detail/algorithm/result_types.hpp>
 
 NANO_BEGIN_NAMESPACE
@@ -25,6 +26,14 @@ private:
     impl(I1 first1, S1 last1, I2 first2, S2 last2, O result, Comp& comp,
          Proj1& proj1, Proj2& proj2)
     {
+        // With random access, count how many elements in a row we take from
+        // each range so that we can gallop through long runs. The threshold
+        // adapts so that we stay within N - 1 comparisons for inputs whose
+        // runs are only a little longer than it.
+        [[maybe_unused]] std::ptrdiff_t run1 = 0;
+        [[maybe_unused]] std::ptrdiff_t run2 = 0;
+        [[maybe_unused]] std::ptrdiff_t threshold = gallop_threshold;
+
         while (first1 != last1) {
             // If we've reached the end of the second range, copy any remaining
             // elements from the first range directly
@@ -43,11 +52,62 @@ private:
                              nano::invoke(proj1, *first1))) {
                 *result = *first2;
                 ++first2;
+                ++result;
+
+                if constexpr (is_gallop_candidate<I1, S1, I2, S2>) {
+                    run1 = 0;
+                    if (++run2 >= threshold) {
+                        // Copy the rest of the elements of range2 which are
+                        // less than this element of range1 in one go
+                        const I2 mid2 = detail::gallop(first2, last2, [&](auto&& y) {
+                            return nano::invoke(comp, nano::invoke(proj2, y),
+                                                nano::invoke(proj1, *first1));
+                        });
+                        threshold = detail::next_gallop_threshold(
+                            threshold, mid2 - first2);
+                        result = nano::copy(first2, mid2, std::move(result)).out;
+                        first2 = mid2;
+                        run2 = 0;
+
+                        // The gallop stopped at an element which isn't less
+                        // than this one, so this one comes next
+                        if (first2 != last2) {
+                            *result = *first1;
+                            ++first1;
+                            ++result;
+                            run1 = 1;
+                        }
+                    }
+                }
             } else {
                 *result = *first1;
                 ++first1;
+                ++result;
+
+                if constexpr (is_gallop_candidate<I1, S1, I2, S2>) {
+                    run2 = 0;
+                    if (++run1 >= threshold) {
+                        // Likewise, copy the rest of the elements of range1
+                        // which are not greater than this element of range2
+                        const I1 mid1 = detail::gallop(first1, last1, [&](auto&& x) {
+                            return !nano::invoke(comp, nano::invoke(proj2, *first2),
+                                                 nano::invoke(proj1, x));
+                        });
+                        threshold = detail::next_gallop_threshold(
+                            threshold, mid1 - first1);
+                        result = nano::copy(first1, mid1, std::move(result)).out;
+                        first1 = mid1;
+                        run1 = 0;
+
+                        if (first1 != last1) {
+                            *result = *first2;
+                            ++first2;
+                            ++result;
+                            run2 = 1;
+                        }
+                    }
+                }
             }
-            ++result;
         }
 
         // We've reached the end of range1, so copy any remaining elements
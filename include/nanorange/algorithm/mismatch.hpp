@@ -8,6 +8,7 @@
 #define NANORANGE_ALGORITHM_MISMATCH_HPP_INCLUDED
 
 #include <nanorange/detail/algorithm/result_types.hpp>
+#include <nanorange/detail/algorithm/simd.hpp>
 #include <nanorange/ranges.hpp>
 
 NANO_BEGIN_NAMESPACE
@@ -28,6 +29,15 @@ private:
     static constexpr mismatch_result<I1, I2>
     impl3(I1 first1, S1 last1, I2 first2, Pred& pred, Proj1& proj1, Proj2& proj2)
     {
+        if constexpr (sized_sentinel_for<S1, I1> &&
+                      is_simd_mismatch_candidate<I1, I2, Pred, Proj1, Proj2>) {
+            if (!detail::is_constant_evaluated()) {
+                return mismatch_fn::simd_impl(std::move(first1),
+                                              std::move(first2),
+                                              last1 - first1);
+            }
+        }
+
         while (first1 != last1 &&
                nano::invoke(pred, nano::invoke(proj1, *first1),
                             nano::invoke(proj2, *first2))) {
@@ -44,6 +54,17 @@ private:
     impl4(I1 first1, S1 last1, I2 first2, S2 last2, Pred& pred, Proj1& proj1,
           Proj2& proj2)
     {
+        if constexpr (sized_sentinel_for<S1, I1> && sized_sentinel_for<S2, I2> &&
+                      is_simd_mismatch_candidate<I1, I2, Pred, Proj1, Proj2>) {
+            if (!detail::is_constant_evaluated()) {
+                const auto len1 = last1 - first1;
+                const auto len2 = last2 - first2;
+                return mismatch_fn::simd_impl(std::move(first1),
+                                              std::move(first2),
+                                              len1 < len2 ? len1 : len2);
+            }
+        }
+
         while (first1 != last1 && first2 != last2 &&
                nano::invoke(pred, nano::invoke(proj1, *first1),
                             nano::invoke(proj2, *first2))) {
@@ -54,6 +75,43 @@ private:
         return {first1, first2};
     }
 
+    // Compares n elements of two contiguous sequences of integers
+    template <typename I1, typename I2>
+    static mismatch_result<I1, I2> simd_impl(I1 first1, I2 first2,
+                                             iter_difference_t<I1> n)
+    {
+        if (n > 0) {
+            const auto i = detail::simd_mismatch(detail::to_address(first1),
+                                                 detail::to_address(first2), n);
+            first1 += i;
+            first2 += i;
+        }
+
+        return {std::move(first1), std::move(first2)};
+    }
+
+    template <typename Rng1, typename Rng2, typename Pred, typename Proj1,
+              typename Proj2>
+    static constexpr mismatch_result<iterator_t<Rng1>, iterator_t<Rng2>>
+    range_impl(Rng1& rng1, Rng2& rng2, Pred& pred, Proj1& proj1, Proj2& proj2)
+    {
+        return detail::simd_range_dispatch<is_simd_mismatch_candidate<
+            range_pointer_t<Rng1>, range_pointer_t<Rng2>, Pred, Proj1, Proj2>>(
+            rng1, rng2,
+            [&](auto ptr1, auto n1, auto ptr2, auto n2)
+                -> mismatch_result<iterator_t<Rng1>, iterator_t<Rng2>> {
+                const auto res =
+                    mismatch_fn::simd_impl(ptr1, ptr2, n1 < n2 ? n1 : n2);
+                return {nano::begin(rng1) + (res.in1 - ptr1),
+                        nano::begin(rng2) + (res.in2 - ptr2)};
+            },
+            [&] {
+                return mismatch_fn::impl4(nano::begin(rng1), nano::end(rng1),
+                                          nano::begin(rng2), nano::end(rng2),
+                                          pred, proj1, proj2);
+            });
+    }
+
 public:
     // three legged
     template <typename I1, typename S1, typename I2, typename Proj1 = identity,
@@ -117,9 +175,7 @@ public:
     operator()(Rng1&& rng1, Rng2&& rng2, Pred pred = Pred{},
                Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
     {
-        return mismatch_fn::impl4(nano::begin(rng1), nano::end(rng1),
-                                  nano::begin(rng2), nano::end(rng2),
-                                  pred, proj1, proj2);
+        return mismatch_fn::range_impl(rng1, rng2, pred, proj1, proj2);
     }
 };
 
@@ -7,6 +7,7 @@
 #ifndef NANORANGE_ALGORITHM_MOVE_HPP_INCLUDED
 #define NANORANGE_ALGORITHM_MOVE_HPP_INCLUDED
 
+#include <nanorange/detail/algorithm/memmove.hpp>
 #include <nanorange/detail/algorithm/result_types.hpp>
 #include <nanorange/ranges.hpp>
 
@@ -19,6 +20,24 @@ namespace detail {
 
 struct move_fn {
 private:
+    // As copy(), moving a trivially copyable type is just a memmove()
+    template <typename I, typename S, typename O>
+    static constexpr std::enable_if_t<sized_sentinel_for<S, I> &&
+                                          is_memmove_movable<I, O>,
+                                      move_result<I, O>>
+    impl(I first, S last, O result, priority_tag<2>)
+    {
+        const auto dist = last - first;
+
+        if (!detail::is_constant_evaluated() && dist > 0) {
+            result = detail::memmove_n(first, dist, result);
+            return {first + dist, std::move(result)};
+        }
+
+        return impl(std::move(first), std::move(last), std::move(result),
+                    priority_tag<1>{});
+    }
+
     template <typename I, typename S, typename O>
     static constexpr std::enable_if_t<sized_sentinel_for<S, I>, move_result<I, O>>
     impl(I first, S last, O result, priority_tag<1>)
@@ -47,6 +66,31 @@ private:
         return {std::move(first), std::move(result)};
     }
 
+    template <typename Rng, typename O>
+    static constexpr std::enable_if_t<
+        contiguous_range<Rng> && sized_range<Rng> &&
+            is_memmove_movable<range_pointer_t<Rng>, O>,
+        move_result<iterator_t<Rng>, O>>
+    range_impl(Rng& rng, O result, priority_tag<1>)
+    {
+        const auto dist = nano::distance(rng);
+
+        if (!detail::is_constant_evaluated() && dist > 0) {
+            result = detail::memmove_n(nano::data(rng), dist, result);
+            return {nano::begin(rng) + dist, std::move(result)};
+        }
+
+        return range_impl(rng, std::move(result), priority_tag<0>{});
+    }
+
+    template <typename Rng, typename O>
+    static constexpr move_result<iterator_t<Rng>, O>
+    range_impl(Rng& rng, O result, priority_tag<0>)
+    {
+        return move_fn::impl(nano::begin(rng), nano::end(rng),
+                             std::move(result), priority_tag<2>{});
+    }
+
 public:
     template <typename I, typename S, typename O>
     constexpr std::enable_if_t<input_iterator<I> && sentinel_for<S, I> &&
@@ -56,7 +100,7 @@ public:
     operator()(I first, S last, O result) const
     {
         return move_fn::impl(std::move(first), std::move(last),
-                             std::move(result), priority_tag<1>{});
+                             std::move(result), priority_tag<2>{});
     }
 
     template <typename Rng, typename O>
@@ -65,8 +109,7 @@ public:
                                move_result<borrowed_iterator_t<Rng>, O>>
     operator()(Rng&& rng, O result) const
     {
-        return move_fn::impl(nano::begin(rng), nano::end(rng),
-                             std::move(result), priority_tag<1>{});
+        return move_fn::range_impl(rng, std::move(result), priority_tag<1>{});
     }
 };
 
@@ -84,6 +127,15 @@ private:
     template <typename I, typename O>
     static constexpr move_backward_result<I, O> impl(I first, I last, O result)
     {
+        if constexpr (is_memmove_movable<I, O>) {
+            const auto dist = last - first;
+
+            if (!detail::is_constant_evaluated() && dist > 0) {
+                result = detail::memmove_backward_n(last, dist, result);
+                return {std::move(last), std::move(result)};
+            }
+        }
+
         auto it = last;
 
         while (it != first) {
@@ -12,8 +12,7 @@
 #ifndef NANORANGE_ALGORITHM_PARTIAL_SORT_HPP_INCLUDED
 #define NANORANGE_ALGORITHM_PARTIAL_SORT_HPP_INCLUDED
 
-#include <nanorange/algorithm/make_heap.hpp>
-#include <nanorange/algorithm/sort_heap.hpp>
+#include <nanorange/detail/algorithm/pdqselect.hpp>
 
 NANO_BEGIN_NAMESPACE
 
@@ -21,22 +20,16 @@ namespace detail {
 
 struct partial_sort_fn {
 private:
+    // Selects the elements which belong in [first, middle) and then sorts
+    // them, taking O(n + k log k) comparisons rather than the O(n log k) of
+    // the classic heap-based algorithm
     template <typename I, typename S, typename Comp, typename Proj>
     static constexpr I impl(I first, I middle, S last, Comp& comp, Proj& proj)
     {
-        nano::make_heap(first, middle, comp, proj);
-        const auto len = nano::distance(first, middle);
-        I i = middle;
-
-        while (i != last) {
-            if (nano::invoke(comp, nano::invoke(proj, *i), nano::invoke(proj, *first))) {
-                nano::iter_swap(i, first);
-                detail::sift_down_n(first, len, first, comp, proj);
-            }
-            ++i;
-        }
-        nano::sort_heap(first, middle, comp, proj);
-        return i;
+        I ilast = nano::next(middle, last);
+        detail::pdqselect(first, middle, ilast, comp, proj);
+        detail::pdqsort(std::move(first), std::move(middle), comp, proj);
+        return ilast;
     }
 
 public:
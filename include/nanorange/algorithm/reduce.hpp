@@ -0,0 +1,149 @@
+// nanorange/algorithm/reduce.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_ALGORITHM_REDUCE_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_REDUCE_HPP_INCLUDED
+
+#include <nanorange/detail/execution/parallel_for.hpp>
+#include <nanorange/execution.hpp>
+#include <nanorange/ranges.hpp>
+
+#include <functional>
+
+NANO_BEGIN_NAMESPACE
+
+// Extension: ranges versions of std::reduce() and std::transform_reduce().
+// As with the standard versions, op is assumed to be associative and
+// commutative. When given a parallel execution policy, sized random-access
+// ranges are reduced in chunks on the thread pool, and the partial results are
+// then combined from left to right.
+
+namespace detail {
+
+// Whether init = op(std::move(init), u) is valid
+template <typename Op, typename T, typename U, bool = invocable<Op&, T, U>>
+inline constexpr bool is_reduction_op = false;
+
+template <typename Op, typename T, typename U>
+inline constexpr bool is_reduction_op<Op, T, U, true> =
+    movable<T> && assignable_from<T&, invoke_result_t<Op&, T, U>>;
+
+// Additionally, a parallel reduction must be able to start from a single
+// element, and to combine partial results
+template <typename Op, typename T, typename U>
+inline constexpr bool is_parallel_reduction_op =
+    is_reduction_op<Op, T, U> && is_reduction_op<Op, T, T> &&
+    constructible_from<T, U>;
+
+// Whether [first, last) can be divided into chunks for a parallel algorithm
+template <typename EP, typename I, typename S>
+inline constexpr bool is_parallel_chunkable =
+    is_parallel_policy_v<EP> && random_access_iterator<I> &&
+    sized_sentinel_for<S, I>;
+
+struct reduce_fn {
+private:
+    friend struct transform_reduce_fn;
+
+    template <typename I, typename S, typename T, typename Op, typename Proj>
+    static constexpr T impl(I first, S last, T init, Op& op, Proj& proj)
+    {
+        while (first != last) {
+            init = nano::invoke(op, std::move(init), nano::invoke(proj, *first));
+            ++first;
+        }
+        return init;
+    }
+
+    template <typename EP, typename I, typename S, typename T, typename Op,
+              typename Proj>
+    static T impl(EP&&, I first, S last, T init, Op& op, Proj& proj)
+    {
+        if constexpr (is_parallel_chunkable<EP, I, S>) {
+            const auto n = static_cast<std::ptrdiff_t>(last - first);
+            constexpr auto chunk = parallel_chunk_size<iter_value_t<I>>;
+            if (detail::use_parallel_chunks(n, chunk)) {
+                return detail::parallel_reduce_chunks(
+                    n, chunk, std::move(init), op,
+                    [&first, &op, &proj](std::ptrdiff_t b, std::ptrdiff_t e) {
+                        I it = first + b;
+                        T acc(nano::invoke(proj, *it));
+                        return reduce_fn::impl(++it, first + e, std::move(acc),
+                                               op, proj);
+                    });
+            }
+        }
+        return reduce_fn::impl(std::move(first), std::move(last),
+                               std::move(init), op, proj);
+    }
+
+public:
+    template <typename I, typename S, typename Proj = identity,
+              typename T = iter_value_t<projected<I, Proj>>,
+              typename Op = std::plus<>>
+    constexpr std::enable_if_t<
+        input_iterator<I> && sentinel_for<S, I> &&
+            is_reduction_op<Op, T, iter_reference_t<projected<I, Proj>>>,
+        T>
+    operator()(I first, S last, T init = T{}, Op op = Op{},
+               Proj proj = Proj{}) const
+    {
+        return reduce_fn::impl(std::move(first), std::move(last),
+                               std::move(init), op, proj);
+    }
+
+    template <typename Rng, typename Proj = identity,
+              typename T = iter_value_t<projected<iterator_t<Rng>, Proj>>,
+              typename Op = std::plus<>>
+    constexpr std::enable_if_t<
+        input_range<Rng> &&
+            is_reduction_op<Op, T,
+                            iter_reference_t<projected<iterator_t<Rng>, Proj>>>,
+        T>
+    operator()(Rng&& rng, T init = T{}, Op op = Op{}, Proj proj = Proj{}) const
+    {
+        return reduce_fn::impl(nano::begin(rng), nano::end(rng),
+                               std::move(init), op, proj);
+    }
+
+    template <typename EP, typename I, typename S, typename Proj = identity,
+              typename T = iter_value_t<projected<I, Proj>>,
+              typename Op = std::plus<>>
+    std::enable_if_t<
+        is_execution_policy_v<remove_cvref_t<EP>> && forward_iterator<I> &&
+            sentinel_for<S, I> &&
+            is_parallel_reduction_op<Op, T, iter_reference_t<projected<I, Proj>>>,
+        T>
+    operator()(EP&& policy, I first, S last, T init = T{}, Op op = Op{},
+               Proj proj = Proj{}) const
+    {
+        return reduce_fn::impl(std::forward<EP>(policy), std::move(first),
+                               std::move(last), std::move(init), op, proj);
+    }
+
+    template <typename EP, typename Rng, typename Proj = identity,
+              typename T = iter_value_t<projected<iterator_t<Rng>, Proj>>,
+              typename Op = std::plus<>>
+    std::enable_if_t<
+        is_execution_policy_v<remove_cvref_t<EP>> && forward_range<Rng> &&
+            is_parallel_reduction_op<
+                Op, T, iter_reference_t<projected<iterator_t<Rng>, Proj>>>,
+        T>
+    operator()(EP&& policy, Rng&& rng, T init = T{}, Op op = Op{},
+               Proj proj = Proj{}) const
+    {
+        return reduce_fn::impl(std::forward<EP>(policy), nano::begin(rng),
+                               nano::end(rng), std::move(init), op, proj);
+    }
+};
+
+} // namespace detail
+
+NANO_INLINE_VAR(detail::reduce_fn, reduce)
+
+NANO_END_NAMESPACE
+
+#endif
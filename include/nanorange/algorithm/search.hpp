@@ -7,6 +7,7 @@
 #ifndef NANORANGE_ALGORITHM_SEARCH_HPP_INCLUDED
 #define NANORANGE_ALGORITHM_SEARCH_HPP_INCLUDED
 
+#include <nanorange/detail/algorithm/two_way_search.hpp>
 #include <nanorange/ranges.hpp>
 #include <nanorange/views/subrange.hpp>
 
@@ -14,6 +15,22 @@ NANO_BEGIN_NAMESPACE
 
 namespace detail {
 
+struct searcher_for_concept {
+    template <typename Searcher, typename I, typename S, typename Proj>
+    auto requires_(const Searcher& searcher, I i, S s, Proj proj)
+        -> decltype(requires_expr<same_as<
+                        decltype(searcher(std::move(i), std::move(s),
+                                          std::move(proj))),
+                        subrange<I>>>{});
+};
+
+// A searcher is a function object such as boyer_moore_horspool_searcher,
+// which is called with the haystack's iterator, sentinel and projection and
+// returns the subrange of the first match
+template <typename Searcher, typename I, typename S, typename Proj>
+NANO_CONCEPT searcher_for =
+    requires_<searcher_for_concept, Searcher, I, S, Proj>;
+
 struct search_fn {
 private:
     friend struct find_end_fn;
@@ -24,6 +41,16 @@ private:
     impl(I1 first1, S1 last1, I2 first2, S2 last2, Pred& pred, Proj1& proj1,
          Proj2& proj2)
     {
+        if constexpr (is_two_way_candidate<I1, S1, I2, S2, Pred, Proj2>) {
+            const auto m = last2 - first2;
+            if (m >= two_way_search_threshold) {
+                return detail::two_way_search(std::move(first1),
+                                              last1 - first1,
+                                              std::move(first2), m, pred,
+                                              proj1, proj2);
+            }
+        }
+
         while (true) {
             auto it1 = first1;
             auto it2 = first2;
@@ -76,6 +103,30 @@ public:
                                nano::begin(rng2), nano::end(rng2),
                                pred, proj1, proj2);
     }
+
+    // Extension: searches for the needle with which the searcher was
+    // constructed, applying proj to the elements of the haystack
+    template <typename I, typename S, typename Searcher,
+              typename Proj = identity>
+    constexpr std::enable_if_t<forward_iterator<I> && sentinel_for<S, I> &&
+                                   searcher_for<Searcher, I, S, Proj>,
+                               subrange<I>>
+    operator()(I first, S last, const Searcher& searcher,
+               Proj proj = Proj{}) const
+    {
+        return searcher(std::move(first), std::move(last), std::move(proj));
+    }
+
+    // Extension: as above, with a range
+    template <typename Rng, typename Searcher, typename Proj = identity>
+    constexpr std::enable_if_t<
+        forward_range<Rng> &&
+            searcher_for<Searcher, iterator_t<Rng>, sentinel_t<Rng>, Proj>,
+        borrowed_subrange_t<Rng>>
+    operator()(Rng&& rng, const Searcher& searcher, Proj proj = Proj{}) const
+    {
+        return searcher(nano::begin(rng), nano::end(rng), std::move(proj));
+    }
 };
 
 }
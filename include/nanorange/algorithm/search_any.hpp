@@ -0,0 +1,332 @@
+// nanorange/algorithm/search_any.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_ALGORITHM_SEARCH_ANY_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_SEARCH_ANY_HPP_INCLUDED
+
+#include <nanorange/detail/algorithm/result_types.hpp>
+#include <nanorange/ranges.hpp>
+
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+NANO_BEGIN_NAMESPACE
+
+// Extension: multi-pattern search. An aho_corasick_searcher<T> compiles a set
+// of patterns, each a range of T, into an Aho-Corasick automaton. search_any()
+// then runs the automaton over a haystack, writing a search_any_match to the
+// output iterator for every occurrence of every pattern (including
+// overlapping ones) in a single pass. Each element of the haystack costs one
+// table lookup however many patterns there are, plus the cost of reporting
+// any matches which end there.
+//
+// The haystack need only be an input range, as it is never rewound, so
+// matches are reported as offsets from its start. Matches are reported in
+// order of their end position; matches ending at the same position are
+// reported longest first, and then in the order of the patterns. Elements
+// are compared using std::hash<T> and operator==, except that one-byte
+// integral and enumeration types use a flat 256-entry table. Empty patterns
+// never match.
+
+struct search_any_match {
+    // Index of the pattern in the range passed to the searcher
+    std::size_t pattern;
+    // Offset of the start of the match from the start of the haystack
+    std::ptrdiff_t offset;
+    std::ptrdiff_t length;
+
+    friend constexpr bool operator==(const search_any_match& lhs,
+                                     const search_any_match& rhs)
+    {
+        return lhs.pattern == rhs.pattern && lhs.offset == rhs.offset &&
+               lhs.length == rhs.length;
+    }
+
+    friend constexpr bool operator!=(const search_any_match& lhs,
+                                     const search_any_match& rhs)
+    {
+        return !(lhs == rhs);
+    }
+};
+
+template <typename I, typename O>
+using search_any_result = in_out_result<I, O>;
+
+namespace detail {
+
+struct search_any_fn;
+
+// Maps each element value which occurs in some pattern to a distinct column
+// of the transition table. All other values map to column zero.
+template <typename T, bool = is_byte_like<T>>
+struct aho_corasick_alphabet {
+    std::uint32_t insert(const T& t)
+    {
+        return map_.try_emplace(t, static_cast<std::uint32_t>(map_.size() + 1))
+            .first->second;
+    }
+
+    std::uint32_t operator[](const T& t) const
+    {
+        const auto it = map_.find(t);
+        return it == map_.end() ? 0 : it->second;
+    }
+
+    std::uint32_t size() const
+    {
+        return static_cast<std::uint32_t>(map_.size() + 1);
+    }
+
+private:
+    std::unordered_map<T, std::uint32_t> map_{};
+};
+
+template <typename T>
+struct aho_corasick_alphabet<T, true> {
+    std::uint32_t insert(const T& t)
+    {
+        auto& col = columns_[static_cast<unsigned char>(t)];
+        if (col == 0) {
+            col = size_++;
+        }
+        return col;
+    }
+
+    std::uint32_t operator[](const T& t) const
+    {
+        return columns_[static_cast<unsigned char>(t)];
+    }
+
+    std::uint32_t size() const { return size_; }
+
+private:
+    std::array<std::uint32_t, 256> columns_{};
+    std::uint32_t size_ = 1;
+};
+
+} // namespace detail
+
+template <typename T>
+class aho_corasick_searcher {
+    using state_t = std::uint32_t;
+
+    static constexpr std::size_t no_pattern = std::size_t(-1);
+    static constexpr state_t report_tag = state_t(1) << 31;
+
+public:
+    template <typename Rng, typename Proj = identity,
+              std::enable_if_t<
+                  forward_range<Rng> && forward_range<range_reference_t<Rng>> &&
+                      same_as<iter_value_t<projected<
+                                  iterator_t<range_reference_t<Rng>>, Proj>>,
+                              T>,
+                  int> = 0>
+    explicit aho_corasick_searcher(Rng&& patterns, Proj proj = Proj{})
+    {
+        // Number the element values first, so that the trie can be built
+        // directly into a transition table of the right width
+        for (auto&& pattern : patterns) {
+            for (auto&& elem : pattern) {
+                alphabet_.insert(nano::invoke(proj, elem));
+            }
+        }
+        width_ = alphabet_.size();
+
+        // Build the trie. A zero entry in the table means "no child", as the
+        // root is never anyone's child.
+        add_state();
+        std::vector<state_t> pattern_end;
+        for (auto&& pattern : patterns) {
+            state_t s = 0;
+            std::ptrdiff_t len = 0;
+            for (auto&& elem : pattern) {
+                const auto col = alphabet_[nano::invoke(proj, elem)];
+                state_t t = next_[s * width_ + col];
+                if (t == 0) {
+                    t = add_state();
+                    next_[s * width_ + col] = t;
+                }
+                s = t;
+                ++len;
+            }
+            pattern_end.push_back(s);
+            lengths_.push_back(len);
+        }
+
+        // Renumber the states in breadth-first order. Most of the time is
+        // spent in the shallowest states, which then share as few cache lines
+        // as possible, and each state's failure state comes before it.
+        const std::size_t num_states = fail_.size();
+        std::vector<state_t> order{0};
+        order.reserve(num_states);
+        for (std::size_t i = 0; i < order.size(); ++i) {
+            for (std::size_t col = 0; col < width_; ++col) {
+                if (const state_t t = next_[order[i] * width_ + col]; t != 0) {
+                    order.push_back(t);
+                }
+            }
+        }
+
+        std::vector<state_t> new_id(num_states);
+        for (std::size_t i = 0; i < num_states; ++i) {
+            new_id[order[i]] = static_cast<state_t>(i);
+        }
+        std::vector<state_t> next(next_.size());
+        for (std::size_t i = 0; i < num_states; ++i) {
+            for (std::size_t col = 0; col < width_; ++col) {
+                next[i * width_ + col] = new_id[next_[order[i] * width_ + col]];
+            }
+        }
+        next_ = std::move(next);
+
+        // Chain together the patterns ending at each state, in order. Empty
+        // patterns end at the root, which is never reported.
+        next_same_.resize(pattern_end.size(), no_pattern);
+        for (std::size_t p = pattern_end.size(); p-- > 0;) {
+            if (const state_t s = new_id[pattern_end[p]]; s != 0) {
+                next_same_[p] = first_pattern_[s];
+                first_pattern_[s] = p;
+            }
+        }
+
+        // Compute the failure links, and at the same time turn the trie into
+        // a DFA by replacing each missing transition with the transition from
+        // the failure state. The root's children fail to the root, and its
+        // missing transitions already lead there.
+        for (std::size_t s = 1; s < num_states; ++s) {
+            const state_t f = fail_[s];
+            report_[s] = first_pattern_[s] != no_pattern ? static_cast<state_t>(s)
+                                                         : report_[f];
+
+            for (std::size_t col = 0; col < width_; ++col) {
+                state_t& t = next_[s * width_ + col];
+                if (t != 0) {
+                    fail_[t] = next_[f * width_ + col];
+                } else {
+                    t = next_[f * width_ + col];
+                }
+            }
+        }
+
+        // Finally, replace each transition with the offset of the target's
+        // row, tagged if there are matches to report there, so that the scan
+        // only needs a single load per element
+        for (auto& t : next_) {
+            t = static_cast<state_t>(t * width_) |
+                (report_[t] != 0 ? report_tag : 0);
+        }
+    }
+
+    // The number of patterns, including any empty ones
+    std::size_t size() const noexcept { return lengths_.size(); }
+
+private:
+    friend struct detail::search_any_fn;
+
+    state_t add_state()
+    {
+        if (next_.size() + width_ > report_tag) {
+            throw std::length_error(
+                "nano::aho_corasick_searcher: too many states");
+        }
+        const auto s = static_cast<state_t>(fail_.size());
+        next_.resize(next_.size() + width_, 0);
+        fail_.push_back(0);
+        report_.push_back(0);
+        first_pattern_.push_back(no_pattern);
+        return s;
+    }
+
+    template <typename I, typename S, typename O, typename Proj>
+    search_any_result<I, O> run(I first, S last, O out, Proj& proj) const
+    {
+        state_t t = 0;
+        std::ptrdiff_t pos = 0;
+
+        for (; first != last; ++first) {
+            t = next_[(t & ~report_tag) + alphabet_[nano::invoke(proj, *first)]];
+            ++pos;
+            if ((t & report_tag) == 0) {
+                continue;
+            }
+
+            // Walk the chain of states for the pattern suffixes ending here
+            const state_t s = (t & ~report_tag) / width_;
+            for (state_t r = report_[s]; r != 0; r = report_[fail_[r]]) {
+                for (auto p = first_pattern_[r]; p != no_pattern;
+                     p = next_same_[p]) {
+                    *out = search_any_match{p, pos - lengths_[p], lengths_[p]};
+                    ++out;
+                }
+            }
+        }
+
+        return {std::move(first), std::move(out)};
+    }
+
+    detail::aho_corasick_alphabet<T> alphabet_{};
+    std::size_t width_ = 0;
+    // Row-major transitions, width_ entries per state. Once construction is
+    // complete, each entry holds the offset of the target state's row, tagged
+    // with report_tag if some pattern ends there.
+    std::vector<state_t> next_{};
+    std::vector<state_t> fail_{};
+    // The nearest state (the state itself, or one on its chain of failure
+    // links) at which some pattern ends, or zero if there is none
+    std::vector<state_t> report_{};
+    std::vector<std::size_t> first_pattern_{};
+    std::vector<std::size_t> next_same_{};
+    std::vector<std::ptrdiff_t> lengths_{};
+};
+
+template <typename Rng, typename Proj = identity,
+          std::enable_if_t<forward_range<Rng> &&
+                               forward_range<range_reference_t<Rng>>, int> = 0>
+aho_corasick_searcher(Rng&&, Proj = Proj{})
+    -> aho_corasick_searcher<
+        iter_value_t<projected<iterator_t<range_reference_t<Rng>>, Proj>>>;
+
+namespace detail {
+
+struct search_any_fn {
+    template <typename I, typename S, typename T, typename O,
+              typename Proj = identity>
+    std::enable_if_t<input_iterator<I> && sentinel_for<S, I> &&
+                         weakly_incrementable<O> &&
+                         writable<O, const search_any_match&> &&
+                         same_as<iter_value_t<projected<I, Proj>>, T>,
+                     search_any_result<I, O>>
+    operator()(I first, S last, const aho_corasick_searcher<T>& searcher,
+               O out, Proj proj = Proj{}) const
+    {
+        return searcher.run(std::move(first), std::move(last), std::move(out),
+                            proj);
+    }
+
+    template <typename Rng, typename T, typename O, typename Proj = identity>
+    std::enable_if_t<
+        input_range<Rng> && weakly_incrementable<O> &&
+            writable<O, const search_any_match&> &&
+            same_as<iter_value_t<projected<iterator_t<Rng>, Proj>>, T>,
+        search_any_result<borrowed_iterator_t<Rng>, O>>
+    operator()(Rng&& rng, const aho_corasick_searcher<T>& searcher, O out,
+               Proj proj = Proj{}) const
+    {
+        return searcher.run(nano::begin(rng), nano::end(rng), std::move(out),
+                            proj);
+    }
+};
+
+} // namespace detail
+
+NANO_INLINE_VAR(detail::search_any_fn, search_any)
+
+NANO_END_NAMESPACE
+
+#endif
@@ -7,25 +7,76 @@
 #ifndef NANORANGE_ALGORITHM_SEARCH_N_HPP_INCLUDED
 #define NANORANGE_ALGORITHM_SEARCH_N_HPP_INCLUDED
 
+#include <nanorange/detail/algorithm/simd.hpp>
 #include <nanorange/ranges.hpp>
 #include <nanorange/views/subrange.hpp>
 
 NANO_BEGIN_NAMESPACE
 
-
 namespace detail {
 
+template <typename I, typename T, typename Pred, typename Proj>
+inline constexpr bool is_simd_search_n_candidate =
+    is_simd_find_candidate<I, T, Proj> &&
+    std::is_same<Pred, ranges::equal_to>::value;
+
 struct search_n_fn {
 private:
+    // With random access, we can check the last element of each candidate
+    // window first. If it doesn't match, no window containing it can either,
+    // so the next candidate starts just after it: when matches are rare, we
+    // only look at about one element in every count.
+    template <typename I, typename T, typename Pred, typename Proj>
+    static constexpr subrange<I>
+    random_access_impl(I first, iter_difference_t<I> n,
+                       iter_difference_t<I> count, const T& value, Pred& pred,
+                       Proj& proj)
+    {
+        // [start, checked) is known to match
+        iter_difference_t<I> start = 0;
+        iter_difference_t<I> checked = 0;
+
+        while (n - start >= count) {
+            iter_difference_t<I> i = start + count - 1;
+            while (i >= checked &&
+                   nano::invoke(pred, nano::invoke(proj, first[i]), value)) {
+                --i;
+            }
+
+            if (i < checked) {
+                return {first + start, first + (start + count)};
+            }
+
+            checked = start + count;
+            start = i + 1;
+        }
+
+        return {first + n, first + n};
+    }
+
     template <typename I, typename S, typename T, typename Pred, typename Proj>
     static constexpr subrange<I>
     impl(I first, S last, iter_difference_t<I> count, const T& value, Pred pred,
          Proj& proj)
     {
-        if (count == iter_difference_t<I>{0}) {
+        if (count <= iter_difference_t<I>{0}) {
             return {first, first};
         }
 
+        if constexpr (random_access_iterator<I> && sized_sentinel_for<S, I>) {
+            const auto n = last - first;
+            if constexpr (is_simd_search_n_candidate<I, T, Pred, Proj>) {
+                if (!detail::is_constant_evaluated() && n > 0) {
+                    const auto ptr = detail::to_address(first);
+                    const auto pos =
+                        detail::simd_search_n(ptr, ptr + n, count, value) - ptr;
+                    return {first + pos, first + (pos == n ? n : pos + count)};
+                }
+            }
+            return search_n_fn::random_access_impl(std::move(first), n, count,
+                                                   value, pred, proj);
+        }
+
         for (; first != last; ++first) {
             if (!nano::invoke(pred, nano::invoke(proj, *first), value)) {
                 continue;
@@ -78,8 +129,23 @@ public:
                 indirectly_comparable<iterator_t<Rng>, const T*, Pred, Proj>,
             borrowed_subrange_t<Rng>>
     {
-        return search_n_fn::impl(nano::begin(rng), nano::end(rng), count, value, pred,
-                                 proj);
+        using I = iterator_t<Rng>;
+        return detail::simd_range_dispatch<
+            is_simd_search_n_candidate<range_pointer_t<Rng>, T, Pred, Proj>>(
+            rng,
+            [&](auto ptr, auto n) -> subrange<I> {
+                if (count <= iter_difference_t<I>{0}) {
+                    return {nano::begin(rng), nano::begin(rng)};
+                }
+                const auto pos =
+                    detail::simd_search_n(ptr, ptr + n, count, value) - ptr;
+                return {nano::begin(rng) + pos,
+                        nano::begin(rng) + (pos == n ? n : pos + count)};
+            },
+            [&] {
+                return search_n_fn::impl(nano::begin(rng), nano::end(rng),
+                                         count, value, pred, proj);
+            });
     }
 };
 
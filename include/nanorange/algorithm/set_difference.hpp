@@ -10,7 +10,9 @@
 #include <nanorange/ranges.hpp>
 
 #include <nanorange/algorithm/copy.hpp>
+#include <nanorange/detail/algorithm/gallop.hpp>
 #include <nanorange/detail/algorithm/result_types.hpp>
+#include <nanorange/detail/algorithm/simd.hpp>
 
 NANO_BEGIN_NAMESPACE
 
@@ -27,6 +29,18 @@ private:
     impl(I1 first1, S1 last1, I2 first2, S2 last2, O result,
          Comp& comp, Proj1& proj1, Proj2& proj2)
     {
+        // For sorted integers, the vectorised kernel does as much of the work
+        // as it can
+        detail::simd_set_prefix<Comp, Proj1, Proj2>(
+            first1, last1, first2, last2, result, [](auto... args) {
+                return detail::simd_set_match<false>(std::move(args)...);
+            });
+
+        // With random access, count how many elements in a row we take from
+        // each range so that we can gallop through long runs
+        [[maybe_unused]] std::ptrdiff_t run1 = 0;
+        [[maybe_unused]] std::ptrdiff_t run2 = 0;
+
         while (first1 != last1) {
             if (first2 == last2) {
                 // We've reached the end of range2, so copy all the remaining
@@ -46,14 +60,44 @@ private:
                 *result = *first1;
                 ++first1;
                 ++result;
+
+                if constexpr (is_gallop_candidate<I1, S1, I2, S2>) {
+                    run2 = 0;
+                    if (++run1 == gallop_threshold) {
+                        // Copy the rest of the elements of r1 which are less
+                        // than this element of r2 in one go
+                        const I1 mid1 = detail::gallop(first1, last1, [&](auto&& x) {
+                            return nano::invoke(comp, nano::invoke(proj1, x),
+                                                nano::invoke(proj2, *first2));
+                        });
+                        result = nano::copy(first1, mid1, std::move(result)).out;
+                        first1 = mid1;
+                        run1 = 0;
+                    }
+                }
             } else{
                 // We now know that !(r1 < r2). If !(r2 < r1) as well, then
                 // elements are equal and we can skip
-                if (!nano::invoke(comp, nano::invoke(proj2, *first2),
-                                  nano::invoke(proj1, *first1))) {
+                const bool equal = !nano::invoke(comp, nano::invoke(proj2, *first2),
+                                                 nano::invoke(proj1, *first1));
+                if (equal) {
                     ++first1;
                 }
                 ++first2;
+
+                if constexpr (is_gallop_candidate<I1, S1, I2, S2>) {
+                    run1 = 0;
+                    run2 = equal ? 0 : run2 + 1;
+                    if (run2 == gallop_threshold) {
+                        // Likewise, skip the rest of the elements of r2 which
+                        // are less than this element of r1
+                        first2 = detail::gallop(first2, last2, [&](auto&& y) {
+                            return nano::invoke(comp, nano::invoke(proj2, y),
+                                                nano::invoke(proj1, *first1));
+                        });
+                        run2 = 0;
+                    }
+                }
             }
         }
 
@@ -91,10 +135,12 @@ public:
     operator()(Rng1&& rng1, Rng2&& rng2, O result, Comp comp = Comp{},
                Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
     {
-        return set_difference_fn::impl(nano::begin(rng1), nano::end(rng1),
-                                       nano::begin(rng2), nano::end(rng2),
-                                       std::move(result), comp,
-                                       proj1, proj2);
+        return detail::simd_set_dispatch<Comp, Proj1, Proj2>(
+            rng1, rng2, [&](auto f1, auto l1, auto f2, auto l2) {
+                return set_difference_fn::impl(
+                    std::move(f1), std::move(l1), std::move(f2), std::move(l2),
+                    std::move(result), comp, proj1, proj2);
+            });
     }
 };
 
@@ -7,20 +7,67 @@
 #ifndef NANORANGE_ALGORITHM_SORT_HPP_INCLUDED
 #define NANORANGE_ALGORITHM_SORT_HPP_INCLUDED
 
+#include <nanorange/detail/algorithm/parallel_sort.hpp>
 #include <nanorange/detail/algorithm/pdqsort.hpp>
+#include <nanorange/detail/algorithm/radix_sort.hpp>
+#include <nanorange/detail/algorithm/sorting_network.hpp>
+#include <nanorange/execution.hpp>
+
+#include <array>
 
 NANO_BEGIN_NAMESPACE
 
 namespace detail {
 
 struct sort_fn {
+private:
+    // Large ranges with integer or floating point keys, sorted in their
+    // natural order, are radix sorted if we can get a buffer
+    template <typename I, typename Comp, typename Proj>
+    static constexpr void impl(I first, I last, Comp& comp, Proj& proj)
+    {
+        if constexpr (is_radix_sortable<I, Comp, Proj>) {
+            if (!detail::is_constant_evaluated() &&
+                last - first >= radix_sort_threshold<radix_key_t<I, Proj>> &&
+                detail::radix_sort(first, last, comp, proj)) {
+                return;
+            }
+        }
+
+        detail::pdqsort(std::move(first), std::move(last), comp, proj);
+    }
+
+    // Arrays small enough for a sorting network use the one for their size
+    template <std::size_t N, typename I, typename Comp, typename Proj>
+    static constexpr void fixed_size_impl(I first, Comp& comp, Proj& proj)
+    {
+        if constexpr (N <= std::size_t(sorting_network_max)) {
+            detail::sorting_network<pdqsort_use_branchless<I, Comp, Proj>, N>(
+                std::move(first), comp, proj);
+        } else {
+            sort_fn::impl(first, first + N, comp, proj);
+        }
+    }
+
+    template <typename EP, typename I, typename Comp, typename Proj>
+    static void impl(EP&&, I first, I last, Comp& comp, Proj& proj)
+    {
+        if constexpr (is_parallel_policy_v<EP>) {
+            detail::parallel_pdqsort(std::move(first), std::move(last), comp,
+                                     proj);
+        } else {
+            sort_fn::impl(std::move(first), std::move(last), comp, proj);
+        }
+    }
+
+public:
     template <typename I, typename S, typename Comp = ranges::less, typename Proj = identity>
     constexpr std::enable_if_t<random_access_iterator<I> && sentinel_for<S, I> &&
                                    sortable<I, Comp, Proj>, I>
     operator()(I first, S last, Comp comp = Comp{}, Proj proj = Proj{}) const
     {
         I last_it = nano::next(first, last);
-        detail::pdqsort(std::move(first), last_it, comp, proj);
+        sort_fn::impl(std::move(first), last_it, comp, proj);
         return last_it;
     }
 
@@ -31,7 +78,59 @@ struct sort_fn {
     operator()(Rng&& rng, Comp comp = Comp{}, Proj proj = Proj{}) const
     {
         iterator_t<Rng> last_it = nano::next(nano::begin(rng), nano::end(rng));
-        detail::pdqsort(nano::begin(rng), last_it, comp, proj);
+        sort_fn::impl(nano::begin(rng), last_it, comp, proj);
+        return last_it;
+    }
+
+    // Extension: arrays whose size is known at compile time, of up to 16
+    // elements, are sorted with a sorting network chosen for that size
+    template <typename T, std::size_t N, typename Comp = ranges::less,
+              typename Proj = identity>
+    constexpr std::enable_if_t<sortable<T*, Comp, Proj>, T*>
+    operator()(T (&arr)[N], Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        sort_fn::fixed_size_impl<N>(arr + 0, comp, proj);
+        return arr + N;
+    }
+
+    template <typename T, std::size_t N, typename Comp = ranges::less,
+              typename Proj = identity>
+    constexpr std::enable_if_t<
+        sortable<typename std::array<T, N>::iterator, Comp, Proj>,
+        typename std::array<T, N>::iterator>
+    operator()(std::array<T, N>& arr, Comp comp = Comp{},
+               Proj proj = Proj{}) const
+    {
+        sort_fn::fixed_size_impl<N>(arr.begin(), comp, proj);
+        return arr.end();
+    }
+
+    template <typename EP, typename I, typename S, typename Comp = ranges::less,
+              typename Proj = identity>
+    std::enable_if_t<is_execution_policy_v<remove_cvref_t<EP>> &&
+                         random_access_iterator<I> && sentinel_for<S, I> &&
+                         sortable<I, Comp, Proj>, I>
+    operator()(EP&& policy, I first, S last, Comp comp = Comp{},
+               Proj proj = Proj{}) const
+    {
+        I last_it = nano::next(first, last);
+        sort_fn::impl(std::forward<EP>(policy), std::move(first), last_it, comp,
+                      proj);
+        return last_it;
+    }
+
+    template <typename EP, typename Rng, typename Comp = ranges::less,
+              typename Proj = identity>
+    std::enable_if_t<is_execution_policy_v<remove_cvref_t<EP>> &&
+                         random_access_range<Rng> &&
+                         sortable<iterator_t<Rng>, Comp, Proj>,
+                     borrowed_iterator_t<Rng>>
+    operator()(EP&& policy, Rng&& rng, Comp comp = Comp{},
+               Proj proj = Proj{}) const
+    {
+        iterator_t<Rng> last_it = nano::next(nano::begin(rng), nano::end(rng));
+        sort_fn::impl(std::forward<EP>(policy), nano::begin(rng), last_it, comp,
+                      proj);
         return last_it;
     }
 };
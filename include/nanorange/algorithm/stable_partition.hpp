@@ -115,7 +115,8 @@ private:
     }
 
     template <typename I, typename Pred, typename Proj>
-    static subrange<I> impl(I first, I last, Pred& pred, Proj& proj)
+    static subrange<I> impl(I first, I last, Pred& pred, Proj& proj,
+                            temporary_resource* resource = nullptr)
     {
         // Find the first non-true value
         first = nano::find_if_not(std::move(first), last, std::ref(pred), std::ref(proj));
@@ -133,7 +134,7 @@ private:
 
         const auto dist = nano::distance(first, it);
 
-        auto buf = detail::temporary_vector<iter_value_t<I>>(dist);
+        auto buf = detail::temporary_vector<iter_value_t<I>>(dist, resource);
         if (buf.capacity() < static_cast<std::size_t>(dist)) {
             return {impl_unbuffered(first, --it, dist, pred, proj).begin(), last};
         }
@@ -142,9 +143,10 @@ private:
 
     template <typename I, typename S, typename Pred, typename Proj>
     static std::enable_if_t<!same_as<I, S>, subrange<I>>
-    impl(I first, S last, Pred& pred, Proj& proj)
+    impl(I first, S last, Pred& pred, Proj& proj,
+         temporary_resource* resource = nullptr)
     {
-        return impl(first, nano::next(first, last), pred, proj);
+        return impl(first, nano::next(first, last), pred, proj, resource);
     }
 
 public:
@@ -169,6 +171,33 @@ public:
         return stable_partition_fn::impl(nano::begin(rng), nano::end(rng),
                                          pred, proj);
     }
+
+#if NANO_HAS_MEMORY_RESOURCE
+    // Extension: as above, but any scratch space is obtained from resource
+    template <typename I, typename S, typename Pred, typename Proj = identity>
+    std::enable_if_t<bidirectional_iterator<I> && sentinel_for<S, I> &&
+                         indirect_unary_predicate<Pred, projected<I, Proj>> &&
+                         permutable<I>, subrange<I>>
+    operator()(std::pmr::memory_resource* resource, I first, S last, Pred pred,
+               Proj proj = Proj{}) const
+    {
+        return stable_partition_fn::impl(std::move(first), std::move(last),
+                                         pred, proj, resource);
+    }
+
+    template <typename Rng, typename Pred, typename Proj = identity>
+    std::enable_if_t<
+        bidirectional_range<Rng> &&
+            indirect_unary_predicate<Pred, projected<iterator_t<Rng>, Proj>> &&
+            permutable<iterator_t<Rng>>,
+        borrowed_subrange_t<Rng>>
+    operator()(std::pmr::memory_resource* resource, Rng&& rng, Pred pred,
+               Proj proj = Proj{}) const
+    {
+        return stable_partition_fn::impl(nano::begin(rng), nano::end(rng),
+                                         pred, proj, resource);
+    }
+#endif
 };
 
 }
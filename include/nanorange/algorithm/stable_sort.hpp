@@ -38,7 +38,11 @@
 #define NANORANGE_ALGORITHM_STABLE_SORT_HPP_INCLUDED
 
 #include <nanorange/algorithm/inplace_merge.hpp>
+#include <nanorange/detail/algorithm/block_merge_sort.hpp>
+#include <nanorange/detail/algorithm/parallel_sort.hpp>
 #include <nanorange/detail/algorithm/pdqsort.hpp>
+#include <nanorange/detail/algorithm/powersort.hpp>
+#include <nanorange/execution.hpp>
 
 NANO_BEGIN_NAMESPACE
 
@@ -46,7 +50,7 @@ namespace detail {
 
 struct stable_sort_fn {
 private:
-    static constexpr int merge_sort_chunk_size = 7;
+    friend struct block_merge_sort_fn;
 
     template <typename I, typename Comp, typename Proj>
     static void inplace_stable_sort(I first, I last, Comp& comp, Proj& proj)
@@ -63,96 +67,103 @@ private:
         }
     }
 
-    template <typename I, typename Buf, typename Comp, typename Proj>
-    static void stable_sort_adaptive(I first, I last, Buf& buf, Comp& comp, Proj& proj)
-    {
-        auto len = iter_difference_t<I>((last - first + 1) / 2);
-        auto middle = first + len;
-        if (static_cast<std::size_t>(len) > buf.capacity()) {
-            stable_sort_adaptive(first, middle, buf, comp, proj);
-            stable_sort_adaptive(middle, last, buf, comp, proj);
-        } else {
-            merge_sort_with_buffer(first, middle, buf, comp, proj);
-            merge_sort_with_buffer(middle, last, buf, comp, proj);
-        }
-        inplace_merge_fn::impl_buffered(first, middle, last,
-                                        middle - first, last - middle, buf,
-                                        comp, proj);
-    }
-
-    template <typename I, typename Buf, typename Comp, typename Proj>
-    static void merge_sort_with_buffer(I first, I last, Buf& buf, Comp& comp, Proj& proj)
+    template <typename I, typename Comp, typename Proj>
+    static void impl(I first, I last, Comp& comp, Proj& proj,
+                     temporary_resource* resource = nullptr)
     {
-        auto len = iter_difference_t<I>(last - first);
-        auto step_size = iter_difference_t<I>(merge_sort_chunk_size);
-        chunk_insertion_sort(first, last, step_size, comp, proj);
-        if (step_size >= len) {
+        auto len = last - first;
+        if (len == 0) {
             return;
         }
-        assert(buf.empty());
-        merge_sort_loop(first, last, nano::back_inserter(buf), step_size, comp, proj);
-        step_size *= 2;
-        while (true) {
-            merge_sort_loop(buf.begin(), buf.end(), first, step_size, comp, proj);
-            step_size *= 2;
-            if (step_size >= len) {
-                buf.clear();
+
+        if (len > 256) {
+            // The merges never buffer more than the shorter of two runs
+            temporary_vector<iter_value_t<I>> buf((len + 1) / 2, resource);
+            if (buf.capacity() != 0) {
+                detail::powersort(std::move(first), std::move(last), buf, comp,
+                                  proj);
                 return;
             }
-            merge_sort_loop(first, last, buf.begin(), step_size, comp, proj);
-            step_size *= 2;
         }
-        buf.clear();
+
+        // Without that much room, make do with O(sqrt(n)) extra space, or
+        // failing that, with merging by rotations
+        if (!detail::block_merge_sort(first, last, comp, proj, resource)) {
+            inplace_stable_sort(std::move(first), std::move(last), comp, proj);
+        }
     }
 
-    template <typename I, typename Comp, typename Proj>
-    static void chunk_insertion_sort(I first, I last, iter_difference_t<I> chunk_size,
-                                     Comp& comp, Proj& proj)
+    // Stably sorts the len elements beginning at src. If result_in_buf is
+    // true the sorted elements are then moved into the corresponding
+    // positions beginning at buf, otherwise they are left in src. The two
+    // halves of each subrange are sorted in parallel into the opposite
+    // buffer, and then merged back with a parallel merge. The leaves are
+    // sorted concurrently, so they always use the global heap.
+    template <typename I, typename B, typename Comp, typename Proj>
+    static void parallel_merge_sort(I src, B buf, iter_difference_t<I> len,
+                                    bool result_in_buf, Comp& comp, Proj& proj)
     {
-            while (last - first >= chunk_size) {
-                detail::insertion_sort(first, first + chunk_size, comp, proj);
-                first += chunk_size;
+        if (len < parallel_sort_grain_size) {
+            impl(src, src + len, comp, proj);
+            if (result_in_buf) {
+                nano::move(src, src + len, std::move(buf));
             }
-            detail::insertion_sort(first, last, comp, proj);
-    }
+            return;
+        }
 
-    template <typename I, typename O, typename Comp, typename Proj>
-    static void merge_sort_loop(I first, I last, O result, iter_difference_t<I> step_size,
-                                Comp& comp, Proj& proj)
-    {
-        auto two_step = iter_difference_t<I>(2 * step_size);
-        while (last - first >= two_step) {
-            result = nano::merge(
-                         nano::make_move_iterator(first),
-                         nano::make_move_iterator(first + step_size),
-                         nano::make_move_iterator(first + step_size),
-                         nano::make_move_iterator(first + two_step),
-                         result, std::ref(comp), std::ref(proj), std::ref(proj)).out;
-            first += two_step;
+        const auto half = len / 2;
+        task_group tasks;
+        tasks.run([src, buf, half, result_in_buf, &comp, &proj] {
+            parallel_merge_sort(src, buf, half, !result_in_buf, comp, proj);
+        });
+        parallel_merge_sort(src + half, buf + half, len - half, !result_in_buf,
+                            comp, proj);
+        tasks.wait();
+
+        if (result_in_buf) {
+            detail::parallel_move_merge(tasks, src, src + half, src + half,
+                                        src + len, std::move(buf), comp, proj);
+        } else {
+            detail::parallel_move_merge(tasks, buf, buf + half, buf + half,
+                                        buf + len, std::move(src), comp, proj);
         }
-        step_size = (nano::min)(iter_difference_t<I>(last - first), step_size);
-        nano::merge(
-                nano::make_move_iterator(first),
-                nano::make_move_iterator(first + step_size),
-                nano::make_move_iterator(first + step_size),
-                nano::make_move_iterator(last),
-                result, std::ref(comp), std::ref(proj), std::ref(proj));
+        tasks.wait();
     }
 
     template <typename I, typename Comp, typename Proj>
-    static void impl(I first, I last, Comp& comp, Proj& proj)
+    static void parallel_impl(I first, I last, Comp& comp, Proj& proj,
+                              temporary_resource* resource = nullptr)
     {
-        auto len = last - first;
-        if (len == 0) {
+        const auto len = last - first;
+        if (len < parallel_sort_grain_size ||
+            task_pool::instance().concurrency() == 1) {
+            impl(std::move(first), std::move(last), comp, proj, resource);
+            return;
+        }
+
+        temporary_vector<iter_value_t<I>> buf(len, resource);
+        if (buf.capacity() == 0) {
+            impl(std::move(first), std::move(last), comp, proj, resource);
             return;
         }
 
-        temporary_vector<iter_value_t<I>> buf(len > 256 ? len : 0);
+        // Move everything into the buffer, and sort it back into place
+        for (I it = first; it != last; ++it) {
+            buf.push_back(nano::iter_move(it));
+        }
+        parallel_merge_sort(buf.begin(), std::move(first), len, true, comp,
+                            proj);
+    }
 
-        if (buf.capacity() != 0) {
-            stable_sort_adaptive(std::move(first), std::move(last), buf, comp, proj);
+    template <typename EP, typename I, typename Comp, typename Proj>
+    static void impl(EP&&, I first, I last, Comp& comp, Proj& proj,
+                     temporary_resource* resource = nullptr)
+    {
+        if constexpr (is_parallel_policy_v<EP>) {
+            parallel_impl(std::move(first), std::move(last), comp, proj,
+                          resource);
         } else {
-            inplace_stable_sort(std::move(first), std::move(last), comp, proj);
+            impl(std::move(first), std::move(last), comp, proj, resource);
         }
     }
 
@@ -178,6 +189,93 @@ public:
         impl(std::move(first), last, comp, proj);
         return last;
     }
+
+    template <typename EP, typename I, typename S, typename Comp = ranges::less,
+              typename Proj = identity>
+    std::enable_if_t<is_execution_policy_v<remove_cvref_t<EP>> &&
+                         random_access_iterator<I> && sentinel_for<S, I> &&
+                         sortable<I, Comp, Proj>, I>
+    operator()(EP&& policy, I first, S last, Comp comp = Comp{},
+               Proj proj = Proj{}) const
+    {
+        const auto ilast = nano::next(first, last);
+        impl(std::forward<EP>(policy), std::move(first), ilast, comp, proj);
+        return ilast;
+    }
+
+    template <typename EP, typename Rng, typename Comp = ranges::less,
+              typename Proj = identity>
+    std::enable_if_t<is_execution_policy_v<remove_cvref_t<EP>> &&
+                         random_access_range<Rng> &&
+                         sortable<iterator_t<Rng>, Comp, Proj>,
+                     borrowed_iterator_t<Rng>>
+    operator()(EP&& policy, Rng&& rng, Comp comp = Comp{},
+               Proj proj = Proj{}) const
+    {
+        auto first = nano::begin(rng);
+        const auto last = nano::next(first, nano::end(rng));
+        impl(std::forward<EP>(policy), std::move(first), last, comp, proj);
+        return last;
+    }
+
+#if NANO_HAS_MEMORY_RESOURCE
+    // Extension: as above, but any scratch space is obtained from resource.
+    // With a parallel policy, only the buffer used by the final merges comes
+    // from resource, so it need not be thread-safe.
+    template <typename I, typename S, typename Comp = ranges::less, typename Proj = identity>
+    std::enable_if_t<random_access_iterator<I> && sentinel_for<S, I> &&
+                         sortable<I, Comp, Proj>, I>
+    operator()(std::pmr::memory_resource* resource, I first, S last,
+               Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        const auto ilast = nano::next(first, last);
+        impl(std::move(first), ilast, comp, proj, resource);
+        return ilast;
+    }
+
+    template <typename Rng, typename Comp = ranges::less, typename Proj = identity>
+    std::enable_if_t<random_access_range<Rng> &&
+                         sortable<iterator_t<Rng>, Comp, Proj>,
+                     borrowed_iterator_t<Rng>>
+    operator()(std::pmr::memory_resource* resource, Rng&& rng,
+               Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        auto first = nano::begin(rng);
+        const auto last = nano::next(first, nano::end(rng));
+        impl(std::move(first), last, comp, proj, resource);
+        return last;
+    }
+
+    template <typename EP, typename I, typename S, typename Comp = ranges::less,
+              typename Proj = identity>
+    std::enable_if_t<is_execution_policy_v<remove_cvref_t<EP>> &&
+                         random_access_iterator<I> && sentinel_for<S, I> &&
+                         sortable<I, Comp, Proj>, I>
+    operator()(EP&& policy, std::pmr::memory_resource* resource, I first,
+               S last, Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        const auto ilast = nano::next(first, last);
+        impl(std::forward<EP>(policy), std::move(first), ilast, comp, proj,
+             resource);
+        return ilast;
+    }
+
+    template <typename EP, typename Rng, typename Comp = ranges::less,
+              typename Proj = identity>
+    std::enable_if_t<is_execution_policy_v<remove_cvref_t<EP>> &&
+                         random_access_range<Rng> &&
+                         sortable<iterator_t<Rng>, Comp, Proj>,
+                     borrowed_iterator_t<Rng>>
+    operator()(EP&& policy, std::pmr::memory_resource* resource, Rng&& rng,
+               Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        auto first = nano::begin(rng);
+        const auto last = nano::next(first, nano::end(rng));
+        impl(std::forward<EP>(policy), std::move(first), last, comp, proj,
+             resource);
+        return last;
+    }
+#endif
 };
 
 }
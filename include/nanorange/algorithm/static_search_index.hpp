@@ -0,0 +1,328 @@
+// nanorange/algorithm/static_search_index.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_ALGORITHM_STATIC_SEARCH_INDEX_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_STATIC_SEARCH_INDEX_HPP_INCLUDED
+
+#include <nanorange/detail/algorithm/simd.hpp>
+#include <nanorange/ranges.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+NANO_BEGIN_NAMESPACE
+
+// Extension: a read-only copy of a sorted range of keys, laid out so that
+// lookups touch as few cache lines as possible. With the Eytzinger layout the
+// keys are stored in breadth-first order of the implicit binary search tree,
+// so the first few levels of every search share a handful of hot cache lines,
+// and the descendants several levels down are contiguous and can be
+// prefetched. With the B-tree layout, each node of an implicit B-tree holds a
+// cache line's worth of keys, and a lookup reads one node per level.
+//
+// Lookups return the position of the result in the original sorted range
+// (that is, the number of keys before it), so they can be used to index a
+// parallel array of values. The keys must be sorted with respect to comp.
+
+enum class search_index_layout { eytzinger, btree };
+
+namespace detail {
+
+// The number of keys in a node of the B-tree layout
+template <typename T>
+constexpr std::size_t search_index_block =
+    sizeof(T) >= 32 ? 2 : sizeof(T) > 4 ? 64 / sizeof(T) : 16;
+
+// How far the Eytzinger search prefetches: node k's descendants this many
+// times further down the tree start at index k * search_index_ahead, and are
+// adjacent. This is four levels for keys of up to 16 bytes, and fewer for
+// larger keys, so that no more than a few cache lines are fetched per step.
+template <typename T>
+constexpr std::size_t search_index_ahead =
+    sizeof(T) <= 16 ? 16 : sizeof(T) <= 32 ? 4 : 2;
+
+// Returns floor(log2(n)) + 1 for n > 0, and 0 for n == 0
+inline std::size_t search_index_bit_width(std::size_t n)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return n == 0 ? 0
+                  : std::numeric_limits<unsigned long long>::digits -
+                        static_cast<std::size_t>(__builtin_clzll(n));
+#else
+    std::size_t w = 0;
+    for (; n != 0; n >>= 1) {
+        ++w;
+    }
+    return w;
+#endif
+}
+
+// Returns n with its trailing one bits, and the zero bit above them, removed
+inline std::size_t search_index_strip_ones(std::size_t n)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return n >> (__builtin_ctzll(~static_cast<unsigned long long>(n)) + 1);
+#else
+    while (n & 1) {
+        n >>= 1;
+    }
+    return n >> 1;
+#endif
+}
+
+} // namespace detail
+
+template <typename T, typename Comp = ranges::less>
+class static_search_index {
+    using block_size = std::integral_constant<std::size_t,
+                                              detail::search_index_block<T>>;
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using key_compare = Comp;
+
+    static_search_index() = default;
+
+    template <typename I, typename S, typename Proj = identity,
+              std::enable_if_t<input_iterator<I> && sentinel_for<S, I> &&
+                                   constructible_from<
+                                       T, indirect_result_t<Proj&, I>>,
+                               int> = 0>
+    static_search_index(
+        I first, S last,
+        search_index_layout layout = search_index_layout::eytzinger,
+        Comp comp = Comp{}, Proj proj = Proj{})
+        : comp_(std::move(comp)), layout_(layout)
+    {
+        std::vector<T> sorted;
+        for (; first != last; ++first) {
+            sorted.emplace_back(nano::invoke(proj, *first));
+        }
+        n_ = sorted.size();
+
+        if (layout_ == search_index_layout::eytzinger) {
+            build_eytzinger(sorted);
+        } else {
+            build_btree(sorted);
+        }
+    }
+
+    template <typename Rng, typename Proj = identity,
+              std::enable_if_t<
+                  input_range<Rng> &&
+                      constructible_from<
+                          T, indirect_result_t<Proj&, iterator_t<Rng>>>,
+                  int> = 0>
+    explicit static_search_index(
+        Rng&& rng, search_index_layout layout = search_index_layout::eytzinger,
+        Comp comp = Comp{}, Proj proj = Proj{})
+        : static_search_index(nano::begin(rng), nano::end(rng), layout,
+                              std::move(comp), std::move(proj))
+    {}
+
+    size_type size() const noexcept { return n_; }
+
+    bool empty() const noexcept { return n_ == 0; }
+
+    search_index_layout layout() const noexcept { return layout_; }
+
+    // Returns the position of the first key which is not less than value,
+    // or size() if there is none
+    template <typename U>
+    size_type lower_bound(const U& value) const
+    {
+        return search([&](const T& key) {
+            return nano::invoke(comp_, key, value);
+        }).pos;
+    }
+
+    // Returns the position of the first key which is greater than value,
+    // or size() if there is none
+    template <typename U>
+    size_type upper_bound(const U& value) const
+    {
+        return search([&](const T& key) {
+            return !nano::invoke(comp_, value, key);
+        }).pos;
+    }
+
+    template <typename U>
+    bool contains(const U& value) const
+    {
+        const auto res = search([&](const T& key) {
+            return nano::invoke(comp_, key, value);
+        });
+        return res.key != nullptr && !nano::invoke(comp_, value, *res.key);
+    }
+
+private:
+    struct search_result {
+        size_type pos;
+        const T* key;
+    };
+
+    // Returns the position in the sorted keys of node k (counting from one)
+    // of the Eytzinger layout. This is its in-order position in a perfect
+    // tree of the same height, less the number of leaves missing from the
+    // bottom level before it.
+    size_type eytzinger_rank(size_type k) const
+    {
+        const size_type depth = detail::search_index_bit_width(k) - 1;
+        const size_type padded = ((2 * (k - (size_type(1) << depth)) + 1)
+                                  << (height_ - 1 - depth)) - 1;
+        const size_type before = (padded + 1) / 2;
+        return padded - (before > leaves_ ? before - leaves_ : 0);
+    }
+
+    void build_eytzinger(const std::vector<T>& sorted)
+    {
+        if (n_ > 0) {
+            height_ = detail::search_index_bit_width(n_);
+            leaves_ = n_ - ((size_type(1) << (height_ - 1)) - 1);
+        }
+        keys_.reserve(n_);
+        for (size_type k = 1; k <= n_; ++k) {
+            keys_.push_back(sorted[eytzinger_rank(k)]);
+        }
+    }
+
+    // Numbers the slots of the subtree rooted at node k in order
+    void number_btree(size_type k, size_type blocks, size_type& next)
+    {
+        constexpr size_type B = block_size::value;
+        if (k >= blocks) {
+            return;
+        }
+        for (size_type i = 0; i < B; ++i) {
+            number_btree(k * (B + 1) + i + 1, blocks, next);
+            ranks_[k * B + i] = next++;
+        }
+        number_btree(k * (B + 1) + B + 1, blocks, next);
+    }
+
+    // The slots at the end of the in-order numbering which are left over
+    // once the keys run out are filled with copies of the largest key. This
+    // keeps every node full without changing the result of any search.
+    void build_btree(const std::vector<T>& sorted)
+    {
+        constexpr size_type B = block_size::value;
+        const size_type blocks = (n_ + B - 1) / B;
+        ranks_.resize(blocks * B);
+
+        size_type next = 0;
+        number_btree(0, blocks, next);
+
+        keys_.reserve(ranks_.size());
+        for (size_type rank : ranks_) {
+            keys_.push_back(sorted[rank < n_ ? rank : n_ - 1]);
+        }
+    }
+
+    template <typename Pred>
+    search_result search(Pred pred) const
+    {
+        return layout_ == search_index_layout::eytzinger
+                   ? search_eytzinger(pred)
+                   : search_btree(pred);
+    }
+
+    // Descends the tree without branching on the comparisons, prefetching
+    // the descendants of the current node a few levels down (see
+    // search_index_ahead). The path taken is recorded in the bits of k: the
+    // result is the last node at which we went left, which is found by
+    // stripping the trailing rights.
+    template <typename Pred>
+    search_result search_eytzinger(Pred& pred) const
+    {
+        constexpr size_type ahead = detail::search_index_ahead<T>;
+        constexpr size_type span = ahead * sizeof(T);
+        const T* const keys = keys_.data();
+
+        size_type k = 1;
+        while (k <= n_) {
+            // Past the bottom of the tree this points beyond the keys, which
+            // is harmless for a prefetch. Working in integers avoids forming
+            // an out-of-bounds pointer.
+            const auto descendants = reinterpret_cast<std::uintptr_t>(keys) +
+                                     (k * ahead - 1) * sizeof(T);
+            for (size_type i = 0; i < span; i += 64) {
+                detail::simd_prefetch(
+                    reinterpret_cast<const void*>(descendants + i));
+            }
+            detail::simd_prefetch(
+                reinterpret_cast<const void*>(descendants + span - 1));
+            k = 2 * k + (pred(keys[k - 1]) ? 1 : 0);
+        }
+
+        k = detail::search_index_strip_ones(k);
+
+        if (k == 0) {
+            return {n_, nullptr};
+        }
+        return {eytzinger_rank(k), keys + (k - 1)};
+    }
+
+    // Counts the keys in each node which satisfy pred, without branching,
+    // and descends to the child between them and the rest
+    template <typename Pred>
+    search_result search_btree(Pred& pred) const
+    {
+        constexpr size_type B = block_size::value;
+        const T* const keys = keys_.data();
+        const size_type blocks = keys_.size() / B;
+
+        size_type slot = keys_.size();
+        size_type k = 0;
+        while (k < blocks) {
+            const T* const node = keys + k * B;
+            size_type i = 0;
+            for (size_type j = 0; j < B; ++j) {
+                i += pred(node[j]) ? 1 : 0;
+            }
+            slot = i < B ? k * B + i : slot;
+            k = k * (B + 1) + i + 1;
+        }
+
+        // A padding slot is only found when every real key is before it
+        if (slot == keys_.size() || ranks_[slot] >= n_) {
+            return {n_, nullptr};
+        }
+        return {ranks_[slot], keys + slot};
+    }
+
+    std::vector<T> keys_{};
+    // For the B-tree layout, the position of each slot's key in the sorted
+    // keys. Padding slots are numbered from size() upwards.
+    std::vector<size_type> ranks_{};
+    size_type n_ = 0;
+    // For the Eytzinger layout, the height of the tree and the number of
+    // nodes on its bottom level
+    size_type height_ = 0;
+    size_type leaves_ = 0;
+    NANO_NO_UNIQUE_ADDRESS Comp comp_{};
+    search_index_layout layout_ = search_index_layout::eytzinger;
+};
+
+template <typename I, typename S, typename Comp = ranges::less,
+          typename Proj = identity,
+          std::enable_if_t<input_iterator<I> && sentinel_for<S, I>, int> = 0>
+static_search_index(I, S, search_index_layout = search_index_layout::eytzinger,
+                    Comp = Comp{}, Proj = Proj{})
+    -> static_search_index<iter_value_t<projected<I, Proj>>, Comp>;
+
+template <typename Rng, typename Comp = ranges::less, typename Proj = identity,
+          std::enable_if_t<input_range<Rng>, int> = 0>
+static_search_index(Rng&&, search_index_layout = search_index_layout::eytzinger,
+                    Comp = Comp{}, Proj = Proj{})
+    -> static_search_index<iter_value_t<projected<iterator_t<Rng>, Proj>>,
+                           Comp>;
+
+NANO_END_NAMESPACE
+
+#endif
@@ -7,7 +7,10 @@
 #ifndef NANORANGE_ALGORITHM_TRANSFORM_HPP_INCLUDED
 #define NANORANGE_ALGORITHM_TRANSFORM_HPP_INCLUDED
 
+#include <nanorange/algorithm/min.hpp>
 #include <nanorange/detail/algorithm/result_types.hpp>
+#include <nanorange/detail/execution/parallel_for.hpp>
+#include <nanorange/execution.hpp>
 #include <nanorange/ranges.hpp>
 
 NANO_BEGIN_NAMESPACE
@@ -69,6 +72,58 @@ private:
         return {std::move(first1), std::move(first2), std::move(result)};
     }
 
+    // With a parallel policy, sized random-access ranges are split into
+    // chunks, each of which is processed using its own copy of op
+    template <typename EP, typename I, typename S, typename O, typename F,
+              typename Proj>
+    static unary_transform_result<I, O>
+    unary_impl(EP&&, I first, S last, O result, F& op, Proj& proj)
+    {
+        if constexpr (is_parallel_policy_v<EP> && random_access_iterator<I> &&
+                      sized_sentinel_for<S, I> && random_access_iterator<O>) {
+            const auto n = static_cast<std::ptrdiff_t>(last - first);
+            constexpr auto chunk = parallel_chunk_size<iter_value_t<I>>;
+            if (detail::use_parallel_chunks(n, chunk)) {
+                detail::parallel_for_chunks(
+                    n, chunk, [&](std::ptrdiff_t b, std::ptrdiff_t e) {
+                        F f = op;
+                        unary_impl(first + b, first + e, result + b, f, proj);
+                    });
+                return {first + n, result + n};
+            }
+        }
+        return unary_impl(std::move(first), std::move(last), std::move(result),
+                          op, proj);
+    }
+
+    template <typename EP, typename I1, typename S1, typename I2, typename S2,
+              typename O, typename F, typename Proj1, typename Proj2>
+    static binary_transform_result<I1, I2, O>
+    binary_impl4(EP&&, I1 first1, S1 last1, I2 first2, S2 last2, O result,
+                 F& op, Proj1& proj1, Proj2& proj2)
+    {
+        if constexpr (is_parallel_policy_v<EP> && random_access_iterator<I1> &&
+                      sized_sentinel_for<S1, I1> &&
+                      random_access_iterator<I2> &&
+                      sized_sentinel_for<S2, I2> && random_access_iterator<O>) {
+            const auto n = (nano::min)(static_cast<std::ptrdiff_t>(last1 - first1),
+                                       static_cast<std::ptrdiff_t>(last2 - first2));
+            constexpr auto chunk = parallel_chunk_size<iter_value_t<I1>>;
+            if (detail::use_parallel_chunks(n, chunk)) {
+                detail::parallel_for_chunks(
+                    n, chunk, [&](std::ptrdiff_t b, std::ptrdiff_t e) {
+                        F f = op;
+                        binary_impl3(first1 + b, first1 + e, first2 + b,
+                                     result + b, f, proj1, proj2);
+                    });
+                return {first1 + n, first2 + n, result + n};
+            }
+        }
+        return binary_impl4(std::move(first1), std::move(last1),
+                            std::move(first2), std::move(last2),
+                            std::move(result), op, proj1, proj2);
+    }
+
 public:
     // Unary op, iterators
     template <typename I, typename S, typename O, typename F,
@@ -171,6 +226,81 @@ public:
                                           std::forward<I2>(first2), std::move(result),
                                           op, proj1, proj2);
     }
+
+    // Extension: unary op, policy and iterators
+    template <typename EP, typename I, typename S, typename O, typename F,
+              typename Proj = identity>
+    std::enable_if_t<
+        is_execution_policy_v<remove_cvref_t<EP>> && forward_iterator<I> &&
+            sentinel_for<S, I> && weakly_incrementable<O> &&
+            copy_constructible<F> &&
+            writable<O, indirect_result_t<F&, projected<I, Proj>>>,
+        unary_transform_result<I, O>>
+    operator()(EP&& policy, I first, S last, O result, F op,
+               Proj proj = Proj{}) const
+    {
+        return transform_fn::unary_impl(std::forward<EP>(policy),
+                                        std::move(first), std::move(last),
+                                        std::move(result), op, proj);
+    }
+
+    // Extension: unary op, policy and range
+    template <typename EP, typename Rng, typename O, typename F,
+              typename Proj = identity>
+    std::enable_if_t<
+        is_execution_policy_v<remove_cvref_t<EP>> && forward_range<Rng> &&
+            weakly_incrementable<O> && copy_constructible<F> &&
+            writable<O,
+                     indirect_result_t<F&, projected<iterator_t<Rng>, Proj>>>,
+        unary_transform_result<borrowed_iterator_t<Rng>, O>>
+    operator()(EP&& policy, Rng&& rng, O result, F op, Proj proj = Proj{}) const
+    {
+        return transform_fn::unary_impl(std::forward<EP>(policy),
+                                        nano::begin(rng), nano::end(rng),
+                                        std::move(result), op, proj);
+    }
+
+    // Extension: binary op, policy and four-legged
+    template <typename EP, typename I1, typename S1, typename I2, typename S2,
+              typename O, typename F, typename Proj1 = identity,
+              typename Proj2 = identity>
+    std::enable_if_t<
+        is_execution_policy_v<remove_cvref_t<EP>> && forward_iterator<I1> &&
+            sentinel_for<S1, I1> && forward_iterator<I2> &&
+            sentinel_for<S2, I2> && weakly_incrementable<O> &&
+            copy_constructible<F> &&
+            writable<O, indirect_result_t<F&, projected<I1, Proj1>,
+                                          projected<I2, Proj2>>>,
+        binary_transform_result<I1, I2, O>>
+    operator()(EP&& policy, I1 first1, S1 last1, I2 first2, S2 last2, O result,
+               F op, Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
+    {
+        return transform_fn::binary_impl4(std::forward<EP>(policy),
+                                          std::move(first1), std::move(last1),
+                                          std::move(first2), std::move(last2),
+                                          std::move(result), op, proj1, proj2);
+    }
+
+    // Extension: binary op, policy and two ranges
+    template <typename EP, typename Rng1, typename Rng2, typename O, typename F,
+              typename Proj1 = identity, typename Proj2 = identity>
+    std::enable_if_t<
+        is_execution_policy_v<remove_cvref_t<EP>> && forward_range<Rng1> &&
+            forward_range<Rng2> && weakly_incrementable<O> &&
+            copy_constructible<F> &&
+            writable<O,
+                     indirect_result_t<F&, projected<iterator_t<Rng1>, Proj1>,
+                                       projected<iterator_t<Rng2>, Proj2>>>,
+        binary_transform_result<borrowed_iterator_t<Rng1>,
+                                borrowed_iterator_t<Rng2>, O>>
+    operator()(EP&& policy, Rng1&& rng1, Rng2&& rng2, O result, F op,
+               Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
+    {
+        return transform_fn::binary_impl4(std::forward<EP>(policy),
+                                          nano::begin(rng1), nano::end(rng1),
+                                          nano::begin(rng2), nano::end(rng2),
+                                          std::move(result), op, proj1, proj2);
+    }
 };
 
 } // namespace detail
@@ -0,0 +1,259 @@
+// nanorange/algorithm/transform_reduce.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_ALGORITHM_TRANSFORM_REDUCE_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_TRANSFORM_REDUCE_HPP_INCLUDED
+
+#include <nanorange/algorithm/min.hpp>
+#include <nanorange/algorithm/reduce.hpp>
+
+NANO_BEGIN_NAMESPACE
+
+// Extension: see reduce.hpp
+
+namespace detail {
+
+template <typename Void, typename ROp, typename T, typename TOp,
+          typename... Is>
+struct transform_reduce_traits {
+    static constexpr bool value = false;
+    static constexpr bool parallel = false;
+};
+
+// Whether init = rop(std::move(init), top(*i...)) is valid, where each i is
+// an iterator of the corresponding type in Is
+template <typename ROp, typename T, typename TOp, typename... Is>
+struct transform_reduce_traits<
+    std::enable_if_t<invocable<TOp&, iter_reference_t<Is>...>>, ROp, T, TOp,
+    Is...> {
+    using element_type = invoke_result_t<TOp&, iter_reference_t<Is>...>;
+
+    static constexpr bool value = is_reduction_op<ROp, T, element_type>;
+    static constexpr bool parallel =
+        is_parallel_reduction_op<ROp, T, element_type>;
+};
+
+struct transform_reduce_fn {
+private:
+    // Applies the transformation to the projected element, so that the
+    // unary form can be reduced with reduce_fn::impl()
+    template <typename TOp, typename Proj>
+    struct transform_proj {
+        TOp& op;
+        Proj& proj;
+
+        template <typename T>
+        constexpr decltype(auto) operator()(T&& t) const
+        {
+            return nano::invoke(op, nano::invoke(proj, std::forward<T>(t)));
+        }
+    };
+
+    template <typename I1, typename S1, typename I2, typename S2, typename T,
+              typename ROp, typename BOp, typename Proj1, typename Proj2>
+    static constexpr T binary_impl(I1 first1, S1 last1, I2 first2, S2 last2,
+                                   T init, ROp& rop, BOp& bop, Proj1& proj1,
+                                   Proj2& proj2)
+    {
+        while (first1 != last1 && first2 != last2) {
+            init = nano::invoke(rop, std::move(init),
+                                nano::invoke(bop, nano::invoke(proj1, *first1),
+                                             nano::invoke(proj2, *first2)));
+            ++first1;
+            ++first2;
+        }
+        return init;
+    }
+
+    template <typename EP, typename I1, typename S1, typename I2, typename S2,
+              typename T, typename ROp, typename BOp, typename Proj1,
+              typename Proj2>
+    static T binary_impl(EP&&, I1 first1, S1 last1, I2 first2, S2 last2,
+                         T init, ROp& rop, BOp& bop, Proj1& proj1, Proj2& proj2)
+    {
+        if constexpr (is_parallel_chunkable<EP, I1, S1> &&
+                      is_parallel_chunkable<EP, I2, S2>) {
+            const auto n = (nano::min)(static_cast<std::ptrdiff_t>(last1 - first1),
+                                       static_cast<std::ptrdiff_t>(last2 - first2));
+            constexpr auto chunk = parallel_chunk_size<iter_value_t<I1>>;
+            if (detail::use_parallel_chunks(n, chunk)) {
+                return detail::parallel_reduce_chunks(
+                    n, chunk, std::move(init), rop,
+                    [&](std::ptrdiff_t b, std::ptrdiff_t e) {
+                        I1 it1 = first1 + b;
+                        I2 it2 = first2 + b;
+                        T acc(nano::invoke(bop, nano::invoke(proj1, *it1),
+                                           nano::invoke(proj2, *it2)));
+                        return binary_impl(++it1, first1 + e, ++it2,
+                                           first2 + e, std::move(acc), rop,
+                                           bop, proj1, proj2);
+                    });
+            }
+        }
+        return binary_impl(std::move(first1), std::move(last1),
+                           std::move(first2), std::move(last2),
+                           std::move(init), rop, bop, proj1, proj2);
+    }
+
+public:
+    // Unary op, iterators
+    template <typename I, typename S, typename T, typename ROp, typename TOp,
+              typename Proj = identity>
+    constexpr std::enable_if_t<
+        input_iterator<I> && sentinel_for<S, I> &&
+            transform_reduce_traits<void, ROp, T, TOp,
+                                    projected<I, Proj>>::value,
+        T>
+    operator()(I first, S last, T init, ROp reduce_op, TOp transform_op,
+               Proj proj = Proj{}) const
+    {
+        transform_proj<TOp, Proj> tproj{transform_op, proj};
+        return reduce_fn::impl(std::move(first), std::move(last),
+                               std::move(init), reduce_op, tproj);
+    }
+
+    // Unary op, range
+    template <typename Rng, typename T, typename ROp, typename TOp,
+              typename Proj = identity>
+    constexpr std::enable_if_t<
+        input_range<Rng> &&
+            transform_reduce_traits<void, ROp, T, TOp,
+                                    projected<iterator_t<Rng>, Proj>>::value,
+        T>
+    operator()(Rng&& rng, T init, ROp reduce_op, TOp transform_op,
+               Proj proj = Proj{}) const
+    {
+        transform_proj<TOp, Proj> tproj{transform_op, proj};
+        return reduce_fn::impl(nano::begin(rng), nano::end(rng),
+                               std::move(init), reduce_op, tproj);
+    }
+
+    // Binary op, iterators
+    template <typename I1, typename S1, typename I2, typename S2, typename T,
+              typename ROp = std::plus<>, typename BOp = std::multiplies<>,
+              typename Proj1 = identity, typename Proj2 = identity>
+    constexpr std::enable_if_t<
+        input_iterator<I1> && sentinel_for<S1, I1> && input_iterator<I2> &&
+            sentinel_for<S2, I2> &&
+            transform_reduce_traits<void, ROp, T, BOp, projected<I1, Proj1>,
+                                    projected<I2, Proj2>>::value,
+        T>
+    operator()(I1 first1, S1 last1, I2 first2, S2 last2, T init,
+               ROp reduce_op = ROp{}, BOp binary_op = BOp{},
+               Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
+    {
+        return transform_reduce_fn::binary_impl(
+            std::move(first1), std::move(last1), std::move(first2),
+            std::move(last2), std::move(init), reduce_op, binary_op, proj1,
+            proj2);
+    }
+
+    // Binary op, ranges
+    template <typename Rng1, typename Rng2, typename T,
+              typename ROp = std::plus<>, typename BOp = std::multiplies<>,
+              typename Proj1 = identity, typename Proj2 = identity>
+    constexpr std::enable_if_t<
+        input_range<Rng1> && input_range<Rng2> &&
+            transform_reduce_traits<void, ROp, T, BOp,
+                                    projected<iterator_t<Rng1>, Proj1>,
+                                    projected<iterator_t<Rng2>, Proj2>>::value,
+        T>
+    operator()(Rng1&& rng1, Rng2&& rng2, T init, ROp reduce_op = ROp{},
+               BOp binary_op = BOp{}, Proj1 proj1 = Proj1{},
+               Proj2 proj2 = Proj2{}) const
+    {
+        return transform_reduce_fn::binary_impl(
+            nano::begin(rng1), nano::end(rng1), nano::begin(rng2),
+            nano::end(rng2), std::move(init), reduce_op, binary_op, proj1,
+            proj2);
+    }
+
+    // Unary op, policy and iterators
+    template <typename EP, typename I, typename S, typename T, typename ROp,
+              typename TOp, typename Proj = identity>
+    std::enable_if_t<
+        is_execution_policy_v<remove_cvref_t<EP>> && forward_iterator<I> &&
+            sentinel_for<S, I> &&
+            transform_reduce_traits<void, ROp, T, TOp,
+                                    projected<I, Proj>>::parallel,
+        T>
+    operator()(EP&& policy, I first, S last, T init, ROp reduce_op,
+               TOp transform_op, Proj proj = Proj{}) const
+    {
+        transform_proj<TOp, Proj> tproj{transform_op, proj};
+        return reduce_fn::impl(std::forward<EP>(policy), std::move(first),
+                               std::move(last), std::move(init), reduce_op,
+                               tproj);
+    }
+
+    // Unary op, policy and range
+    template <typename EP, typename Rng, typename T, typename ROp,
+              typename TOp, typename Proj = identity>
+    std::enable_if_t<
+        is_execution_policy_v<remove_cvref_t<EP>> && forward_range<Rng> &&
+            transform_reduce_traits<void, ROp, T, TOp,
+                                    projected<iterator_t<Rng>, Proj>>::parallel,
+        T>
+    operator()(EP&& policy, Rng&& rng, T init, ROp reduce_op, TOp transform_op,
+               Proj proj = Proj{}) const
+    {
+        transform_proj<TOp, Proj> tproj{transform_op, proj};
+        return reduce_fn::impl(std::forward<EP>(policy), nano::begin(rng),
+                               nano::end(rng), std::move(init), reduce_op,
+                               tproj);
+    }
+
+    // Binary op, policy and iterators
+    template <typename EP, typename I1, typename S1, typename I2, typename S2,
+              typename T, typename ROp = std::plus<>,
+              typename BOp = std::multiplies<>, typename Proj1 = identity,
+              typename Proj2 = identity>
+    std::enable_if_t<
+        is_execution_policy_v<remove_cvref_t<EP>> && forward_iterator<I1> &&
+            sentinel_for<S1, I1> && forward_iterator<I2> &&
+            sentinel_for<S2, I2> &&
+            transform_reduce_traits<void, ROp, T, BOp, projected<I1, Proj1>,
+                                    projected<I2, Proj2>>::parallel,
+        T>
+    operator()(EP&& policy, I1 first1, S1 last1, I2 first2, S2 last2, T init,
+               ROp reduce_op = ROp{}, BOp binary_op = BOp{},
+               Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
+    {
+        return transform_reduce_fn::binary_impl(
+            std::forward<EP>(policy), std::move(first1), std::move(last1),
+            std::move(first2), std::move(last2), std::move(init), reduce_op,
+            binary_op, proj1, proj2);
+    }
+
+    // Binary op, policy and ranges
+    template <typename EP, typename Rng1, typename Rng2, typename T,
+              typename ROp = std::plus<>, typename BOp = std::multiplies<>,
+              typename Proj1 = identity, typename Proj2 = identity>
+    std::enable_if_t<
+        is_execution_policy_v<remove_cvref_t<EP>> && forward_range<Rng1> &&
+            forward_range<Rng2> &&
+            transform_reduce_traits<void, ROp, T, BOp,
+                                    projected<iterator_t<Rng1>, Proj1>,
+                                    projected<iterator_t<Rng2>, Proj2>>::parallel,
+        T>
+    operator()(EP&& policy, Rng1&& rng1, Rng2&& rng2, T init,
+               ROp reduce_op = ROp{}, BOp binary_op = BOp{},
+               Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
+    {
+        return transform_reduce_fn::binary_impl(
+            std::forward<EP>(policy), nano::begin(rng1), nano::end(rng1),
+            nano::begin(rng2), nano::end(rng2), std::move(init), reduce_op,
+            binary_op, proj1, proj2);
+    }
+};
+
+} // namespace detail
+
+NANO_INLINE_VAR(detail::transform_reduce_fn, transform_reduce)
+
+NANO_END_NAMESPACE
+
+#endif
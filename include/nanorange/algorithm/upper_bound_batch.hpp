@@ -0,0 +1,25 @@
+// nanorange/algorithm/upper_bound_batch.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_ALGORITHM_UPPER_BOUND_BATCH_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_UPPER_BOUND_BATCH_HPP_INCLUDED
+
+#include <nanorange/detail/algorithm/batch_search.hpp>
+
+NANO_BEGIN_NAMESPACE
+
+// Extension: as lower_bound_batch, but writes
+// upper_bound(haystack, value, comp, proj) for each query
+
+template <typename I, typename O>
+using upper_bound_batch_result = in_out_result<I, O>;
+
+NANO_INLINE_VAR(detail::bound_batch_fn<detail::bound_kind::upper>,
+                upper_bound_batch)
+
+NANO_END_NAMESPACE
+
+#endif
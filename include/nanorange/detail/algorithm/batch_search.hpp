@@ -0,0 +1,235 @@
+// nanorange/detail/algorithm/batch_search.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_DETAIL_ALGORITHM_BATCH_SEARCH_HPP_INCLUDED
+#define NANORANGE_DETAIL_ALGORITHM_BATCH_SEARCH_HPP_INCLUDED
+
+#include <nanorange/detail/algorithm/gallop.hpp>
+#include <nanorange/detail/algorithm/result_types.hpp>
+#include <nanorange/detail/algorithm/simd.hpp>
+#include <nanorange/ranges.hpp>
+
+#include <array>
+
+NANO_BEGIN_NAMESPACE
+
+namespace detail {
+
+// The batched binary searches take the queries this many at a time, and
+// advance all the searches in a group by one step before moving on to the
+// next step. A search's next probe is prefetched as soon as it is known, and
+// is not needed until the rest of the group has taken its turn, so the cache
+// misses of different searches overlap rather than each waiting on the last.
+constexpr std::ptrdiff_t batch_search_group = 16;
+
+// For each of the count queries starting at q, stores in pos the offset from
+// first of the partition point of [first, first + n) with respect to
+// pred(x, query), where x is a projected element.
+template <typename I, typename Q, typename Pred, typename Proj>
+constexpr void batch_partition_points(I first, iter_difference_t<I> n, Q q,
+                                      std::ptrdiff_t count, Pred& pred,
+                                      Proj& proj, iter_difference_t<I>* pos)
+{
+    for (std::ptrdiff_t k = 0; k < count; ++k) {
+        pos[k] = 0;
+    }
+
+    if (n == 0) {
+        return;
+    }
+
+    // As in partition_point, every search in the group halves its length at
+    // each step whatever the result, so they all take the same number of
+    // steps
+    while (n > 1) {
+        const auto half = n / 2;
+        const auto next_half = (n - half) / 2;
+
+        Q it = q;
+        for (std::ptrdiff_t k = 0; k < count; ++k, ++it) {
+            pos[k] += nano::invoke(pred, nano::invoke(proj, first[pos[k] + half]),
+                                   *it)
+                          ? half : iter_difference_t<I>{0};
+
+            using ref_t = iter_reference_t<I>;
+            if constexpr (std::is_lvalue_reference<ref_t>::value &&
+                          !std::is_volatile<
+                              std::remove_reference_t<ref_t>>::value) {
+                if (!detail::is_constant_evaluated()) {
+                    detail::simd_prefetch(
+                        std::addressof(first[pos[k] + next_half]));
+                }
+            }
+        }
+
+        n -= half;
+    }
+
+    Q it = q;
+    for (std::ptrdiff_t k = 0; k < count; ++k, ++it) {
+        pos[k] += nano::invoke(pred, nano::invoke(proj, first[pos[k]]), *it)
+                      ? 1 : 0;
+    }
+}
+
+// Finds the partition point of [first, first + n) with respect to
+// pred(x, query) for each query in [qfirst, qlast), calling
+// emit(query_iterator, offset) for each in turn, and returns the end of the
+// queries.
+//
+// The partition point is monotonic in the query, so when the queries in a
+// group are sorted, we gallop to the result for the last one, and confine the
+// rest of the group to the part of the haystack before it. If the group also
+// follows on from the previous one, the gallop starts from the previous
+// group's last result. For a sorted batch of many queries, each group then
+// only touches a short stretch of the haystack.
+template <typename I, typename QI, typename QS, typename Pred, typename Comp,
+          typename Proj, typename Emit>
+constexpr QI batch_search(I first, iter_difference_t<I> n, QI qfirst,
+                          QS qlast, Pred& pred, Comp& comp, Proj& proj,
+                          Emit emit)
+{
+    std::array<iter_difference_t<I>, batch_search_group> pos{};
+
+    bool have_prev = false;
+    QI prev_last = qfirst;
+    iter_difference_t<I> prev_pos = 0;
+
+    while (qfirst != qlast) {
+        const QI group_first = qfirst;
+        QI group_last = qfirst;
+        std::ptrdiff_t count = 0;
+        bool sorted = true;
+
+        for (; count < batch_search_group && qfirst != qlast;
+             ++count, ++qfirst) {
+            // Don't branch on this, as it is unpredictable for random queries
+            if (count > 0) {
+                sorted &= !nano::invoke(comp, *qfirst, *group_last);
+            }
+            group_last = qfirst;
+        }
+
+        if (sorted) {
+            const iter_difference_t<I> lo =
+                have_prev && !nano::invoke(comp, *group_first, *prev_last)
+                    ? prev_pos : 0;
+            const auto hi =
+                detail::gallop(first + lo, first + n,
+                               [&](auto&& x) {
+                                   return nano::invoke(
+                                       pred, nano::invoke(proj, x),
+                                       *group_last);
+                               }) -
+                first;
+            pos[count - 1] = hi - lo;
+            detail::batch_partition_points(first + lo, hi - lo, group_first,
+                                           count - 1, pred, proj, pos.data());
+            for (std::ptrdiff_t k = 0; k < count; ++k) {
+                pos[k] += lo;
+            }
+        } else {
+            detail::batch_partition_points(first, n, group_first, count, pred,
+                                           proj, pos.data());
+        }
+
+        QI it = group_first;
+        for (std::ptrdiff_t k = 0; k < count; ++k, ++it) {
+            emit(it, pos[k]);
+        }
+
+        have_prev = true;
+        prev_last = group_last;
+        prev_pos = pos[count - 1];
+    }
+
+    return qfirst;
+}
+
+enum class bound_kind { lower, upper };
+
+// As batch_search, for the lower or upper bound of each query with respect to
+// comp
+template <bound_kind Kind, typename I1, typename I2, typename S2,
+          typename Comp, typename Proj, typename Emit>
+constexpr I2 batch_bound(I1 first1, iter_difference_t<I1> n1, I2 first2,
+                         S2 last2, Comp& comp, Proj& proj, Emit emit)
+{
+    auto pred = [&comp](auto&& x, auto&& val) {
+        if constexpr (Kind == bound_kind::lower) {
+            return nano::invoke(comp, std::forward<decltype(x)>(x),
+                                std::forward<decltype(val)>(val));
+        } else {
+            return !nano::invoke(comp, std::forward<decltype(val)>(val),
+                                 std::forward<decltype(x)>(x));
+        }
+    };
+    return detail::batch_search(std::move(first1), n1, std::move(first2),
+                                std::move(last2), pred, comp, proj,
+                                std::move(emit));
+}
+
+// The implementation of lower_bound_batch and upper_bound_batch
+template <bound_kind Kind>
+struct bound_batch_fn {
+private:
+    template <typename I1, typename I2, typename S2, typename O, typename Comp,
+              typename Proj>
+    static constexpr in_out_result<I2, O>
+    impl(I1 first1, iter_difference_t<I1> n1, I2 first2, S2 last2, O out,
+         Comp& comp, Proj& proj)
+    {
+        auto last = detail::batch_bound<Kind>(
+            first1, n1, std::move(first2), std::move(last2), comp, proj,
+            [&](const I2&, iter_difference_t<I1> pos) {
+                *out = first1 + pos;
+                ++out;
+            });
+        return {std::move(last), std::move(out)};
+    }
+
+public:
+    template <typename I1, typename S1, typename I2, typename S2, typename O,
+              typename Comp = ranges::less, typename Proj = identity>
+    constexpr std::enable_if_t<
+        random_access_iterator<I1> && sized_sentinel_for<S1, I1> &&
+            forward_iterator<I2> && sentinel_for<S2, I2> &&
+            weakly_incrementable<O> && writable<O, const I1&> &&
+            indirect_strict_weak_order<Comp, I2, projected<I1, Proj>>,
+        in_out_result<I2, O>>
+    operator()(I1 first1, S1 last1, I2 first2, S2 last2, O out,
+               Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        const auto n1 = last1 - first1;
+        return bound_batch_fn::impl(std::move(first1), n1, std::move(first2),
+                                    std::move(last2), std::move(out), comp,
+                                    proj);
+    }
+
+    template <typename Rng1, typename Rng2, typename O,
+              typename Comp = ranges::less, typename Proj = identity>
+    constexpr std::enable_if_t<
+        random_access_range<Rng1> && sized_range<Rng1> &&
+            borrowed_range<Rng1> && forward_range<Rng2> &&
+            weakly_incrementable<O> &&
+            writable<O, const iterator_t<Rng1>&> &&
+            indirect_strict_weak_order<Comp, iterator_t<Rng2>,
+                                       projected<iterator_t<Rng1>, Proj>>,
+        in_out_result<borrowed_iterator_t<Rng2>, O>>
+    operator()(Rng1&& rng1, Rng2&& rng2, O out, Comp comp = Comp{},
+               Proj proj = Proj{}) const
+    {
+        return bound_batch_fn::impl(nano::begin(rng1), nano::distance(rng1),
+                                    nano::begin(rng2), nano::end(rng2),
+                                    std::move(out), comp, proj);
+    }
+};
+
+} // namespace detail
+
+NANO_END_NAMESPACE
+
+#endif
@@ -0,0 +1,247 @@
+// nanorange/detail/algorithm/block_merge_sort.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// A stable O(n log n) merge sort which needs only O(sqrt(n)) extra space,
+// for when there is no room for a buffer of half the range. It finds and
+// merges runs in the same order as powersort, but runs which are both too
+// long for the buffer are merged by the block merge of Kim and Kutzner, as
+// used by WikiSort (Mike McFadden, https://github.com/BonzaiThePenguin/WikiSort).
+//
+// To merge A with B, A is cut into blocks of sqrt(n) elements, which are
+// "rolled" through B by swapping each with the next block of B. Whenever
+// the first element of the smallest A block is not greater than the last B
+// value rolled past, that A block is dropped in place, and the previous one
+// is merged with the B values which followed it using the buffer. Every
+// element is swapped O(1) times, so each merge takes linear time.
+//
+// WikiSort keeps the order of the rolled A blocks by overwriting one
+// element of each with a distinct value extracted from the input. Here we
+// track the order in a separate array of block numbers instead, which works
+// whether or not the input has enough distinct values and keeps the
+// extraction and redistribution steps out of the picture.
+
+#ifndef NANORANGE_DETAIL_ALGORITHM_BLOCK_MERGE_SORT_HPP_INCLUDED
+#define NANORANGE_DETAIL_ALGORITHM_BLOCK_MERGE_SORT_HPP_INCLUDED
+
+#include <nanorange/algorithm/lower_bound.hpp>
+#include <nanorange/algorithm/rotate.hpp>
+#include <nanorange/algorithm/swap_ranges.hpp>
+#include <nanorange/detail/algorithm/powersort.hpp>
+#include <nanorange/detail/memory/temporary_vector.hpp>
+
+#include <cmath>
+
+NANO_BEGIN_NAMESPACE
+
+namespace detail {
+
+// Returns the number of elements in a block for a range of n elements,
+// which is also the number of elements in the buffer
+inline std::size_t block_merge_block_size(std::size_t n)
+{
+    auto k = static_cast<std::size_t>(std::sqrt(static_cast<double>(n)));
+    while (k * k < n) {
+        ++k;
+    }
+    return k < 16 ? 16 : k;
+}
+
+// Merges the elements held in buf with [middle, last), writing them from
+// first onwards. [first, middle) must have as many elements as buf, none of
+// whose values matter.
+template <typename I, typename Buf, typename Comp, typename Proj>
+void block_merge_from_buffer(I first, I middle, I last, Buf& buf, Comp& comp,
+                             Proj& proj)
+{
+    auto buf_first = buf.begin();
+    const auto buf_last = buf.end();
+
+    while (buf_first != buf_last && middle != last) {
+        if (nano::invoke(comp, nano::invoke(proj, *middle),
+                         nano::invoke(proj, *buf_first))) {
+            *first = nano::iter_move(middle);
+            ++middle;
+        } else {
+            *first = std::move(*buf_first);
+            ++buf_first;
+        }
+        ++first;
+    }
+
+    nano::move(buf_first, buf_last, std::move(first));
+    buf.clear();
+}
+
+// Merges the adjacent sorted runs [first, middle) and [middle, last), both
+// longer than the buffer. buf and tags must be empty, with room for a block
+// of elements and for a block number per block of the first run.
+template <typename I, typename Buf, typename Tags, typename Comp,
+          typename Proj>
+void block_merge(I first, I middle, I last, Buf& buf, Tags& tags, Comp& comp,
+                 Proj& proj)
+{
+    using diff_t = iter_difference_t<I>;
+
+    const auto k = static_cast<diff_t>(buf.capacity());
+    const diff_t len = last - first;
+
+    // Offsets from first of the rolling A blocks, the next block of B, the
+    // previous A block, which is waiting in buf to be merged, and the B
+    // values which have been rolled past since it was dropped. If the
+    // length of A is not a multiple of k, the short block at the front
+    // starts out as the previous A block.
+    diff_t a_first = (middle - first) % k;
+    diff_t a_last = middle - first;
+    diff_t b_first = a_last;
+    diff_t b_last = b_first + (nano::min)(k, len - b_first);
+    diff_t prev_a_first = 0;
+    diff_t prev_a_last = a_first;
+    diff_t prev_b_first = a_first;
+    diff_t prev_b_last = a_first;
+
+    nano::move(first, first + a_first, nano::back_inserter(buf));
+
+    // The number of the A block at each position among the rolling blocks,
+    // stored as a ring starting at head. The A blocks are dropped in their
+    // original order, so the smallest block is always block number next.
+    const diff_t blocks = (a_last - a_first) / k;
+    for (diff_t i = 0; i < blocks; ++i) {
+        tags.push_back(i);
+    }
+    const auto tag = [&](diff_t pos) -> diff_t& {
+        return tags.begin()[pos % blocks];
+    };
+    diff_t head = 0;
+    diff_t next = 0;
+    diff_t min_a = a_first;
+
+    while (a_first != a_last) {
+        if (b_first == b_last ||
+            (prev_b_first != prev_b_last &&
+             !nano::invoke(comp, nano::invoke(proj, first[prev_b_last - 1]),
+                           nano::invoke(proj, first[min_a])))) {
+            // Drop the smallest A block behind, after the B values which are
+            // less than its first element
+            const diff_t b_split =
+                nano::lower_bound(first + prev_b_first, first + prev_b_last,
+                                  nano::invoke(proj, first[min_a]),
+                                  std::ref(comp), std::ref(proj)) -
+                first;
+            const diff_t b_remaining = prev_b_last - b_split;
+
+            if (min_a != a_first) {
+                nano::swap_ranges(first + a_first, first + (a_first + k),
+                                  first + min_a, first + (min_a + k));
+                nano::swap(tag(head), tag(head + (min_a - a_first) / k));
+            }
+
+            detail::block_merge_from_buffer(first + prev_a_first,
+                                            first + prev_a_last,
+                                            first + b_split, buf, comp, proj);
+
+            // Once this block is in the buffer its old place holds nothing
+            // we need, so rather than rotating it past the rest of the
+            // previous B values we can swap them into the end of it
+            nano::move(first + a_first, first + (a_first + k),
+                       nano::back_inserter(buf));
+            nano::swap_ranges(first + b_split, first + a_first,
+                              first + (a_first + k - b_remaining),
+                              first + (a_first + k));
+
+            prev_a_first = a_first - b_remaining;
+            prev_a_last = prev_a_first + k;
+            prev_b_first = prev_a_last;
+            prev_b_last = prev_b_first + b_remaining;
+
+            a_first += k;
+            head = (head + 1) % blocks;
+            ++next;
+
+            for (diff_t i = 0, n = (a_last - a_first) / k; i < n; ++i) {
+                if (tag(head + i) == next) {
+                    min_a = a_first + i * k;
+                    break;
+                }
+            }
+        } else if (b_last - b_first < k) {
+            // Move the short last block of B in front of the A blocks
+            nano::rotate(first + a_first, first + b_first, first + b_last);
+            const diff_t b_len = b_last - b_first;
+            prev_b_first = a_first;
+            prev_b_last = a_first + b_len;
+            a_first += b_len;
+            a_last += b_len;
+            min_a += b_len;
+            b_first = b_last;
+        } else {
+            // Roll the first A block to the end by swapping it with the next
+            // block of B
+            nano::swap_ranges(first + a_first, first + (a_first + k),
+                              first + b_first, first + b_last);
+            prev_b_first = a_first;
+            prev_b_last = a_first + k;
+            if (min_a == a_first) {
+                min_a = a_last;
+            }
+            const diff_t remaining = (a_last - a_first) / k;
+            tag(head + remaining) = tag(head);
+            head = (head + 1) % blocks;
+
+            a_first += k;
+            a_last += k;
+            b_first += k;
+            b_last = b_first + (nano::min)(k, len - b_first);
+        }
+    }
+
+    detail::block_merge_from_buffer(first + prev_a_first, first + prev_a_last,
+                                    last, buf, comp, proj);
+    tags.clear();
+}
+
+// Stably sorts [first, last) using O(sqrt(n)) extra space. Returns false,
+// leaving the range untouched, if even that much space is not available.
+template <typename I, typename Comp, typename Proj>
+bool block_merge_sort(I first, I last, Comp& comp, Proj& proj,
+                      temporary_resource* resource = nullptr)
+{
+    using diff_t = iter_difference_t<I>;
+
+    const auto n = static_cast<std::size_t>(last - first);
+    if (n <= static_cast<std::size_t>(powersort_min_run)) {
+        detail::insertion_sort(std::move(first), std::move(last), comp, proj);
+        return true;
+    }
+
+    const std::size_t k = detail::block_merge_block_size(n);
+    temporary_vector<iter_value_t<I>> buf(k, resource);
+    temporary_vector<diff_t> tags(n / k + 1, resource);
+    if (buf.capacity() == 0 || tags.capacity() == 0) {
+        return false;
+    }
+
+    detail::powersort_runs(
+        std::move(first), std::move(last), comp, proj,
+        [&](I begin, I middle, I end) {
+            if (!detail::powersort_trim(begin, middle, end, comp, proj)) {
+                return;
+            }
+            if (end - middle <= diff_t(k)) {
+                detail::powersort_merge_hi(begin, middle, end, buf, comp, proj);
+            } else if (middle - begin <= diff_t(k)) {
+                detail::powersort_merge_lo(begin, middle, end, buf, comp, proj);
+            } else {
+                detail::block_merge(begin, middle, end, buf, tags, comp, proj);
+            }
+        });
+    return true;
+}
+
+} // namespace detail
+
+NANO_END_NAMESPACE
+
+#endif
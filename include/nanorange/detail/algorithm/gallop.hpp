@@ -0,0 +1,78 @@
+// nanorange/detail/algorithm/gallop.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_DETAIL_ALGORITHM_GALLOP_HPP_INCLUDED
+#define NANORANGE_DETAIL_ALGORITHM_GALLOP_HPP_INCLUDED
+
+#include <nanorange/ranges.hpp>
+
+NANO_BEGIN_NAMESPACE
+
+namespace detail {
+
+// The merge-like algorithms step through their inputs one element at a time
+// while they are well interleaved. Once one input has supplied this many
+// elements in a row, they switch to an exponential search to find the end of
+// the run, as in TimSort's "galloping mode", so that combining m elements
+// with n takes O(m log(n/m)) comparisons rather than O(m + n).
+constexpr std::ptrdiff_t gallop_threshold = 8;
+
+// A gallop which finds a run of d elements takes about 2 log2(d) comparisons,
+// against the d + 1 it takes to step through them, so it can cost one more
+// comparison than stepping when the run turns out to be short. As in TimSort,
+// callers bound to a comparison count can adapt the threshold for each call,
+// raising it after a gallop which copied fewer than gallop_threshold elements
+// and lowering it after one which copied more, so that runs only a little
+// longer than the threshold don't pay that cost over and over.
+constexpr std::ptrdiff_t next_gallop_threshold(std::ptrdiff_t threshold,
+                                               std::ptrdiff_t copied)
+{
+    if (copied < gallop_threshold) {
+        return 2 * threshold;
+    }
+    return threshold > gallop_threshold ? threshold - 1 : gallop_threshold;
+}
+
+template <typename I1, typename S1, typename I2, typename S2>
+inline constexpr bool is_gallop_candidate =
+    random_access_iterator<I1> && sized_sentinel_for<S1, I1> &&
+    random_access_iterator<I2> && sized_sentinel_for<S2, I2>;
+
+// Given that pred holds for some prefix of [first, last) and not for the
+// rest, returns the end of that prefix. Takes O(log d) applications of pred,
+// where d is the length of the prefix.
+template <typename I, typename S, typename Pred>
+constexpr I gallop(I first, S last, Pred pred)
+{
+    const auto n = last - first;
+
+    // Find a bound hi on the end of the prefix, doubling the step each time,
+    // such that pred holds for [0, lo) and not for hi
+    iter_difference_t<I> lo = 0;
+    iter_difference_t<I> step = 1;
+    while (step - 1 < n - lo && pred(first[lo + step - 1])) {
+        lo += step;
+        step *= 2;
+    }
+    iter_difference_t<I> hi = step - 1 < n - lo ? lo + step - 1 : n;
+
+    while (lo < hi) {
+        const auto mid = lo + (hi - lo) / 2;
+        if (pred(first[mid])) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    return first + lo;
+}
+
+} // namespace detail
+
+NANO_END_NAMESPACE
+
+#endif
@@ -28,12 +28,13 @@
 #ifndef NANORANGE_DETAIL_ALGORITHM_HEAP_SIFT_HPP
 #define NANORANGE_DETAIL_ALGORITHM_HEAP_SIFT_HPP
 
+#include <nanorange/detail/algorithm/simd.hpp>
 #include <nanorange/detail/iterator/associated_types.hpp>
 #include <nanorange/detail/iterator/iter_move.hpp>
 #include <nanorange/functional.hpp>
 
 ///////////////////////////////////////////////////////////////////////////
-// detail::sift_up_n and detail::sift_down_n
+// detail::sift_up_n and detail::sift_down_n, and their d-ary counterparts
 // (heap implementation details)
 //
 
@@ -124,6 +125,176 @@ constexpr void sift_down_n(I first, iter_difference_t<I> n, I start, Comp& comp,
     *start = std::move(top);
 }
 
+// Moves the larger child of each element along the path from the top of
+// the heap [first, first + n) up one level, leaving a hole at a leaf, and
+// returns the position of the hole. This takes one comparison per level,
+// rather than the two of sift_down_n, as it doesn't check whether some
+// other element belongs in the hole. Requires n >= 2, and the top element
+// to have been moved out.
+template <typename I, typename Comp, typename Proj>
+constexpr I floyd_sift_down_n(I first, iter_difference_t<I> n, Comp& comp,
+                              Proj& proj)
+{
+    I hole = first;
+    iter_difference_t<I> child = 0;
+
+    while (true) {
+        child = 2 * child + 1;
+        I child_i = first + child;
+
+        if ((child + 1) < n &&
+            nano::invoke(comp, nano::invoke(proj, *child_i),
+                         nano::invoke(proj, *(child_i + 1)))) {
+            // right-child exists and is greater than left-child
+            ++child_i;
+            ++child;
+        }
+
+        *hole = nano::iter_move(child_i);
+        hole = child_i;
+
+        if ((n - 2) / 2 < child) {
+            return hole;
+        }
+    }
+}
+
+// In a D-ary heap, the children of the element at index i are at indices
+// D * i + 1 to D * i + D, so for small D they share one or two cache lines,
+// and the heap is log2(D) times shallower than a binary heap.
+
+template <std::ptrdiff_t D, typename I, typename Comp, typename Proj>
+constexpr void dary_sift_up_n(I first, iter_difference_t<I> n, Comp& comp,
+                              Proj& proj)
+{
+    if (n > 1) {
+        I last = first + n;
+        n = (n - 2) / D;
+        I i = first + n;
+        if (nano::invoke(comp, nano::invoke(proj, *i),
+                         nano::invoke(proj, *--last))) {
+            iter_value_t<I> v = nano::iter_move(last);
+            do {
+                *last = nano::iter_move(i);
+                last = i;
+                if (n == 0) {
+                    break;
+                }
+                n = (n - 1) / D;
+                i = first + n;
+            } while (nano::invoke(comp, nano::invoke(proj, *i),
+                                  nano::invoke(proj, v)));
+            *last = std::move(v);
+        }
+    }
+}
+
+// Returns the index of the largest of the K elements starting at index i.
+// The elements are compared in a balanced tournament, so the chain of
+// dependent comparisons is log2(K) long rather than K - 1.
+template <std::ptrdiff_t K, typename I, typename Comp, typename Proj>
+constexpr iter_difference_t<I> dary_largest_of(I first, iter_difference_t<I> i,
+                                               Comp& comp, Proj& proj)
+{
+    if constexpr (K == 1) {
+        return i;
+    } else {
+        const auto a = detail::dary_largest_of<K / 2>(first, i, comp, proj);
+        const auto b =
+            detail::dary_largest_of<K - K / 2>(first, i + K / 2, comp, proj);
+        // Ties go to the left, as in a sequential scan
+        return nano::invoke(comp, nano::invoke(proj, first[a]),
+                            nano::invoke(proj, first[b]))
+                   ? b : a;
+    }
+}
+
+// Returns the index of the largest of the children of a D-ary heap element,
+// the first of which is at index child
+template <std::ptrdiff_t D, typename I, typename Comp, typename Proj>
+constexpr iter_difference_t<I>
+dary_largest_child(I first, iter_difference_t<I> n, iter_difference_t<I> child,
+                   Comp& comp, Proj& proj)
+{
+    if (n - child >= D) {
+        return detail::dary_largest_of<D>(first, child, comp, proj);
+    }
+
+    auto largest = child;
+    for (auto c = child + 1; c < n; ++c) {
+        if (nano::invoke(comp, nano::invoke(proj, first[largest]),
+                         nano::invoke(proj, first[c]))) {
+            largest = c;
+        }
+    }
+    return largest;
+}
+
+// The D * D grandchildren of an element are adjacent, so while we choose
+// between its children, we can fetch all the candidates for the next level
+template <std::ptrdiff_t D, typename I>
+constexpr void dary_prefetch_grandchildren(I first, iter_difference_t<I> n,
+                                           iter_difference_t<I> parent)
+{
+    using ref_t = iter_reference_t<I>;
+    if constexpr (std::is_lvalue_reference<ref_t>::value &&
+                  !std::is_volatile<std::remove_reference_t<ref_t>>::value) {
+        if (!detail::is_constant_evaluated()) {
+            const auto begin = D * (D * parent + 1) + 1;
+            const auto end = begin + D * D < n ? begin + D * D : n;
+            constexpr iter_difference_t<I> step =
+                sizeof(iter_value_t<I>) < 64 ? 64 / sizeof(iter_value_t<I>) : 1;
+            for (auto i = begin; i < end; i += step) {
+                detail::simd_prefetch(std::addressof(first[i]));
+            }
+            if (begin < end) {
+                detail::simd_prefetch(std::addressof(first[end - 1]));
+            }
+        }
+    }
+}
+
+template <std::ptrdiff_t D, typename I, typename Comp, typename Proj>
+constexpr void dary_sift_down_n(I first, iter_difference_t<I> n, I start,
+                                Comp& comp, Proj& proj)
+{
+    auto parent = start - first;
+
+    // the last element with children is at (n - 2) / D
+    if (n < 2 || (n - 2) / D < parent) {
+        return;
+    }
+
+    detail::dary_prefetch_grandchildren<D>(first, n, parent);
+    auto child = detail::dary_largest_child<D>(first, n, D * parent + 1, comp,
+                                               proj);
+    I child_i = first + child;
+
+    // check if we are in heap-order
+    if (nano::invoke(comp, nano::invoke(proj, *child_i),
+                     nano::invoke(proj, *start))) {
+        return;
+    }
+
+    iter_value_t<I> top = nano::iter_move(start);
+    do {
+        *start = nano::iter_move(child_i);
+        start = child_i;
+        parent = child;
+
+        if ((n - 2) / D < parent) {
+            break;
+        }
+
+        detail::dary_prefetch_grandchildren<D>(first, n, parent);
+        child = detail::dary_largest_child<D>(first, n, D * parent + 1, comp,
+                                              proj);
+        child_i = first + child;
+    } while (!nano::invoke(comp, nano::invoke(proj, *child_i),
+                           nano::invoke(proj, top)));
+    *start = std::move(top);
+}
+
 } // namespace detail
 
 NANO_END_NAMESPACE
@@ -0,0 +1,110 @@
+// nanorange/detail/algorithm/memmove.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_DETAIL_ALGORITHM_MEMMOVE_HPP_INCLUDED
+#define NANORANGE_DETAIL_ALGORITHM_MEMMOVE_HPP_INCLUDED
+
+#include <nanorange/ranges.hpp>
+
+#include <cstring>
+#include <memory>
+
+NANO_BEGIN_NAMESPACE
+
+namespace detail {
+
+// Returns a raw pointer to the element referred to by a contiguous iterator.
+// Unless I is a pointer type, i must be dereferenceable.
+template <typename I>
+constexpr auto to_address(const I& i) noexcept
+{
+    if constexpr (std::is_pointer<I>::value) {
+        return i;
+    } else {
+        return std::addressof(*i);
+    }
+}
+
+template <typename From, typename To>
+inline constexpr bool is_memmove_assignable =
+    std::is_same<remove_cvref_t<From>, remove_cvref_t<To>>::value &&
+    std::is_trivially_copyable<remove_cvref_t<To>>::value &&
+    std::is_trivially_assignable<To, From>::value &&
+    !std::is_volatile<std::remove_reference_t<From>>::value &&
+    !std::is_volatile<std::remove_reference_t<To>>::value;
+
+template <typename Rng>
+using range_pointer_t = std::add_pointer_t<range_reference_t<Rng>>;
+
+// Standard library iterators don't carry our contiguous_iterator_tag, so we
+// also recognise the wrappers which libstdc++ and libc++ use for the
+// iterators of std::vector and std::basic_string. (std::array's iterators are
+// plain pointers in both.) With other standard libraries, only the range
+// overloads of copy() and move(), which go via data(), can use memmove() on
+// these containers.
+template <typename I>
+inline constexpr bool is_std_contiguous_iterator = false;
+
+#if defined(__GLIBCXX__)
+template <typename T, typename C>
+inline constexpr bool
+    is_std_contiguous_iterator<__gnu_cxx::__normal_iterator<T*, C>> = true;
+#endif
+
+#if defined(_LIBCPP_VERSION)
+template <typename T>
+inline constexpr bool is_std_contiguous_iterator<std::__wrap_iter<T*>> = true;
+#endif
+
+template <typename I>
+inline constexpr bool is_memmove_iterator =
+    contiguous_iterator<I> || is_std_contiguous_iterator<I>;
+
+// Whether *o = *i may be performed by memmove()
+template <typename I, typename O,
+          bool = is_memmove_iterator<I> && is_memmove_iterator<O>>
+inline constexpr bool is_memmove_copyable = false;
+
+template <typename I, typename O>
+inline constexpr bool is_memmove_copyable<I, O, true> =
+    is_memmove_assignable<iter_reference_t<I>, iter_reference_t<O>>;
+
+// Whether *o = iter_move(i) may be performed by memmove()
+template <typename I, typename O,
+          bool = is_memmove_iterator<I> && is_memmove_iterator<O>>
+inline constexpr bool is_memmove_movable = false;
+
+template <typename I, typename O>
+inline constexpr bool is_memmove_movable<I, O, true> =
+    is_memmove_assignable<iter_rvalue_reference_t<I>, iter_reference_t<O>>;
+
+// Copies the n elements beginning at first to the range beginning at result,
+// which may overlap. Returns result + n. Requires n > 0.
+template <typename I, typename O>
+O memmove_n(I first, iter_difference_t<I> n, O result)
+{
+    std::memmove(detail::to_address(result), detail::to_address(first),
+                 static_cast<std::size_t>(n) * sizeof(iter_value_t<I>));
+    return result + n;
+}
+
+// Copies the n elements ending at last to the range ending at result, which
+// may overlap. Returns result - n. Requires n > 0.
+template <typename I, typename O>
+O memmove_backward_n(I last, iter_difference_t<I> n, O result)
+{
+    result -= n;
+    last -= n;
+    std::memmove(detail::to_address(result), detail::to_address(last),
+                 static_cast<std::size_t>(n) * sizeof(iter_value_t<I>));
+    return result;
+}
+
+} // namespace detail
+
+NANO_END_NAMESPACE
+
+#endif
@@ -0,0 +1,114 @@
+// nanorange/detail/algorithm/parallel_sort.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_DETAIL_ALGORITHM_PARALLEL_SORT_HPP_INCLUDED
+#define NANORANGE_DETAIL_ALGORITHM_PARALLEL_SORT_HPP_INCLUDED
+
+#include <nanorange/algorithm/lower_bound.hpp>
+#include <nanorange/algorithm/merge.hpp>
+#include <nanorange/algorithm/upper_bound.hpp>
+#include <nanorange/detail/algorithm/pdqsort.hpp>
+#include <nanorange/detail/execution/task_pool.hpp>
+#include <nanorange/iterator/move_iterator.hpp>
+
+#include <functional>
+
+NANO_BEGIN_NAMESPACE
+
+namespace detail {
+
+// Ranges shorter than this are not worth handing off to another thread
+constexpr int parallel_sort_grain_size = 1 << 14;
+
+// As pdqsort_loop(), but left-hand partitions which are large enough are
+// forked onto the task pool rather than sorted on this thread
+template <bool Branchless, typename I, typename Comp, typename Proj>
+void parallel_pdqsort_loop(task_group& tasks, I begin, I end, Comp& comp,
+                           Proj& proj, int bad_allowed, bool leftmost)
+{
+    auto recurse = [&tasks, &comp, &proj](I b, I e, int bad, bool lm) {
+        if (e - b < parallel_sort_grain_size) {
+            detail::pdqsort_loop<Branchless>(std::move(b), std::move(e), comp,
+                                             proj, bad, lm);
+        } else {
+            tasks.run([&tasks, &comp, &proj, b, e, bad, lm] {
+                detail::parallel_pdqsort_loop<Branchless>(tasks, b, e, comp,
+                                                          proj, bad, lm);
+            });
+        }
+    };
+
+    detail::pdqsort_loop<Branchless>(std::move(begin), std::move(end), comp,
+                                     proj, bad_allowed, leftmost, recurse);
+}
+
+template <typename I, typename Comp, typename Proj>
+void parallel_pdqsort(I begin, I end, Comp& comp, Proj& proj)
+{
+    const auto len = end - begin;
+
+    if (len < parallel_sort_grain_size ||
+        task_pool::instance().concurrency() == 1) {
+        detail::pdqsort(std::move(begin), std::move(end), comp, proj);
+        return;
+    }
+
+    task_group tasks;
+    detail::parallel_pdqsort_loop<pdqsort_use_branchless<I, Comp, Proj>>(
+        tasks, std::move(begin), std::move(end), comp, proj,
+        detail::log2(len), true);
+    tasks.wait();
+}
+
+// Merges the sorted ranges [first1, last1) and [first2, last2) into the range
+// beginning at out, moving rather than copying elements. The merge is stable.
+// We repeatedly split the longer input at its midpoint, binary search for the
+// corresponding split point in the other input, and fork the upper halves.
+template <typename I1, typename I2, typename O, typename Comp, typename Proj>
+void parallel_move_merge(task_group& tasks, I1 first1, I1 last1, I2 first2,
+                         I2 last2, O out, Comp& comp, Proj& proj)
+{
+    while (true) {
+        const auto len1 = last1 - first1;
+        const auto len2 = last2 - first2;
+
+        if (len1 + len2 < parallel_sort_grain_size) {
+            nano::merge(nano::make_move_iterator(std::move(first1)),
+                        nano::make_move_iterator(std::move(last1)),
+                        nano::make_move_iterator(std::move(first2)),
+                        nano::make_move_iterator(std::move(last2)),
+                        std::move(out), std::ref(comp), std::ref(proj),
+                        std::ref(proj));
+            return;
+        }
+
+        I1 mid1 = first1;
+        I2 mid2 = first2;
+        if (len1 >= len2) {
+            mid1 += len1 / 2;
+            mid2 = nano::lower_bound(first2, last2, nano::invoke(proj, *mid1),
+                                     std::ref(comp), std::ref(proj));
+        } else {
+            mid2 += len2 / 2;
+            mid1 = nano::upper_bound(first1, last1, nano::invoke(proj, *mid2),
+                                     std::ref(comp), std::ref(proj));
+        }
+
+        O mid_out = out + ((mid1 - first1) + (mid2 - first2));
+        tasks.run([&tasks, &comp, &proj, mid1, last1, mid2, last2, mid_out] {
+            detail::parallel_move_merge(tasks, mid1, last1, mid2, last2,
+                                        mid_out, comp, proj);
+        });
+        last1 = std::move(mid1);
+        last2 = std::move(mid2);
+    }
+}
+
+} // namespace detail
+
+NANO_END_NAMESPACE
+
+#endif
@@ -0,0 +1,206 @@
+// nanorange/detail/algorithm/pdqselect.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Selection using the partitioning machinery from pdqsort: like quickselect,
+// but recursing only into the side of each partition which contains nth
+
+#ifndef NANORANGE_DETAIL_ALGORITHM_PDQSELECT_HPP_INCLUDED
+#define NANORANGE_DETAIL_ALGORITHM_PDQSELECT_HPP_INCLUDED
+
+#include <nanorange/detail/algorithm/pdqsort.hpp>
+
+NANO_BEGIN_NAMESPACE
+
+namespace detail {
+
+// Partitions which are not highly unbalanced shrink the range geometrically,
+// while bad partitions may shrink it by as little as one element. Once
+// partitioning has examined this many times the size of the input, a bad
+// partition makes us switch to the median of medians, keeping the total work
+// linear. Random inputs rarely need more than half this budget.
+constexpr int pdqselect_work_factor = 8;
+
+// Rearranges [begin, end) so that *nth is the element which would be there if
+// the range were sorted, with no element before it greater and no element after
+// it less. Uses the median of medians to choose each pivot, guaranteeing O(n)
+// comparisons at the cost of a large constant factor. Used as the fallback for
+// pdqselect_loop().
+template <typename I, typename Comp, typename Proj>
+constexpr void median_of_medians_select(I begin, I nth, I end, Comp& comp,
+                                        Proj& proj)
+{
+    using diff_t = iter_difference_t<I>;
+
+    while (true) {
+        diff_t size = end - begin;
+
+        if (size < pdqsort_insertion_sort_threshold) {
+            insertion_sort(begin, end, comp, proj);
+            return;
+        }
+
+        // Sort each group of five elements and move its median to the front.
+        I medians = begin;
+        for (I group = begin; end - group >= 5; group += 5) {
+            insertion_sort(group, group + 5, comp, proj);
+            nano::iter_swap(medians, group + 2);
+            ++medians;
+        }
+
+        // Use the median of those medians as the pivot. At least three tenths
+        // of the range is no less than it, so partition_right() will find an
+        // element to stop its first scan.
+        I mid = begin + (medians - begin) / 2;
+        detail::median_of_medians_select(begin, mid, medians, comp, proj);
+        nano::iter_swap(begin, mid);
+
+        I pivot_pos = partition_right(begin, end, comp, proj).first;
+        if (pivot_pos == nth) {
+            return;
+        }
+
+        if (nth < pivot_pos) {
+            end = pivot_pos;
+            continue;
+        }
+
+        // Elements equal to the pivot all went to the right, so gather them
+        // next to it; otherwise a run of equal elements would only shrink the
+        // range by one element per pass.
+        I equal_end = pivot_pos + 1;
+        for (I it = equal_end; it != end; ++it) {
+            if (!nano::invoke(comp, nano::invoke(proj, *pivot_pos),
+                              nano::invoke(proj, *it))) {
+                nano::iter_swap(it, equal_end);
+                ++equal_end;
+            }
+        }
+
+        if (nth < equal_end) {
+            return;
+        }
+        begin = equal_end;
+    }
+}
+
+// The main selection loop, following pdqsort_loop() closely
+template <bool Branchless, typename I, typename Comp, typename Proj>
+constexpr void pdqselect_loop(I begin, I nth, I end, Comp& comp, Proj& proj)
+{
+    using diff_t = iter_difference_t<I>;
+
+    diff_t work_allowed = (end - begin) * pdqselect_work_factor;
+    bool leftmost = true;
+
+    while (true) {
+        diff_t size = end - begin;
+
+        if (size < pdqsort_insertion_sort_threshold) {
+            if (leftmost) {
+                insertion_sort(begin, end, comp, proj);
+            } else {
+                unguarded_insertion_sort(begin, end, comp, proj);
+            }
+            return;
+        }
+
+        // Choose pivot as median of 3 or pseudomedian of 9.
+        diff_t s2 = size / 2;
+        if (size > pdqsort_ninther_threshold) {
+            sort3(begin, begin + s2, end - 1, comp, proj);
+            sort3(begin + 1, begin + (s2 - 1), end - 2, comp, proj);
+            sort3(begin + 2, begin + (s2 + 1), end - 3, comp, proj);
+            sort3(begin + (s2 - 1), begin + s2, begin + (s2 + 1), comp, proj);
+            nano::iter_swap(begin, begin + s2);
+        } else {
+            sort3(begin + s2, begin, end - 1, comp, proj);
+        }
+
+        work_allowed -= size;
+
+        // As in pdqsort_loop(), if the pivot is equal to *(begin - 1) then
+        // gather the elements equal to it on the left. They are then in their
+        // final positions, so we are done if nth is among them.
+        if (!leftmost && !nano::invoke(comp, nano::invoke(proj, *(begin - 1)),
+                                       nano::invoke(proj, *begin))) {
+            begin = partition_left(begin, end, comp, proj) + 1;
+            if (nth < begin) {
+                return;
+            }
+            continue;
+        }
+
+        std::pair<I, bool> part_result =
+            Branchless ? partition_right_branchless(begin, end, comp, proj)
+                       : partition_right(begin, end, comp, proj);
+        I pivot_pos = part_result.first;
+        bool already_partitioned = part_result.second;
+
+        if (pivot_pos == nth) {
+            return;
+        }
+
+        diff_t l_size = pivot_pos - begin;
+        diff_t r_size = end - (pivot_pos + 1);
+        bool highly_unbalanced = l_size < size / 8 || r_size < size / 8;
+
+        // Continue with the partition containing nth
+        if (nth < pivot_pos) {
+            end = pivot_pos;
+            size = l_size;
+        } else {
+            begin = pivot_pos + 1;
+            size = r_size;
+            leftmost = false;
+        }
+
+        if (highly_unbalanced) {
+            // If we have used up our budget, switch to the median of medians
+            // to guarantee O(n).
+            if (work_allowed <= 0) {
+                detail::median_of_medians_select(std::move(begin),
+                                                 std::move(nth),
+                                                 std::move(end), comp, proj);
+                return;
+            }
+
+            // Otherwise shuffle some elements to break up patterns
+            if (size >= pdqsort_insertion_sort_threshold) {
+                nano::iter_swap(begin, begin + size / 4);
+                nano::iter_swap(end - 1, end - size / 4);
+
+                if (size > pdqsort_ninther_threshold) {
+                    nano::iter_swap(begin + 1, begin + (size / 4 + 1));
+                    nano::iter_swap(begin + 2, begin + (size / 4 + 2));
+                    nano::iter_swap(end - 2, end - (size / 4 + 1));
+                    nano::iter_swap(end - 3, end - (size / 4 + 2));
+                }
+            }
+        } else if (already_partitioned &&
+                   partial_insertion_sort(begin, end, comp, proj)) {
+            // The partition was already sorted
+            return;
+        }
+    }
+}
+
+template <typename I, typename Comp, typename Proj,
+          bool Branchless = pdqsort_use_branchless<I, Comp, Proj>>
+constexpr void pdqselect(I begin, I nth, I end, Comp& comp, Proj& proj)
+{
+    if (nth == end) {
+        return;
+    }
+
+    detail::pdqselect_loop<Branchless>(std::move(begin), std::move(nth),
+                                       std::move(end), comp, proj);
+}
+
+} // namespace detail
+
+NANO_END_NAMESPACE
+
+#endif
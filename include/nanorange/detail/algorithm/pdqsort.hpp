@@ -14,6 +14,7 @@
 #include <nanorange/algorithm/make_heap.hpp>
 #include <nanorange/algorithm/min.hpp>
 #include <nanorange/algorithm/sort_heap.hpp>
+#include <nanorange/detail/algorithm/sorting_network.hpp>
 #include <nanorange/ranges.hpp>
 
 NANO_BEGIN_NAMESPACE
@@ -527,9 +528,13 @@ constexpr I partition_left(I begin, I end, Comp& comp, Proj& proj)
     return pivot_pos;
 }
 
-template <bool Branchless, typename I, typename Comp, typename Proj>
+// The main pdqsort loop. After each partitioning step the left-hand
+// partition is passed to recurse(begin, end, bad_allowed, leftmost), while the
+// right-hand partition is handled by the next iteration of the loop.
+template <bool Branchless, typename I, typename Comp, typename Proj,
+          typename Recurse>
 constexpr void pdqsort_loop(I begin, I end, Comp& comp, Proj& proj,
-                            int bad_allowed, bool leftmost = true)
+                            int bad_allowed, bool leftmost, Recurse& recurse)
 {
     using diff_t = iter_difference_t<I>;
 
@@ -537,14 +542,23 @@ constexpr void pdqsort_loop(I begin, I end, Comp& comp, Proj& proj,
     while (true) {
         diff_t size = nano::distance(begin, end);
 
-        // Insertion sort is faster for small arrays.
-        if (size < pdqsort_insertion_sort_threshold) {
-            if (leftmost) {
-                insertion_sort(begin, end, comp, proj);
-            } else {
-                unguarded_insertion_sort(begin, end, comp, proj);
+        // Small partitions of arithmetic values are sorted by a network,
+        // which doesn't branch. Insertion sort is faster for other small
+        // arrays.
+        if constexpr (Branchless) {
+            if (size <= sorting_network_max) {
+                detail::sorting_network<Branchless>(begin, size, comp, proj);
+                return;
+            }
+        } else {
+            if (size < pdqsort_insertion_sort_threshold) {
+                if (leftmost) {
+                    insertion_sort(begin, end, comp, proj);
+                } else {
+                    unguarded_insertion_sort(begin, end, comp, proj);
+                }
+                return;
             }
-            return;
         }
 
         // Choose pivot as median of 3 or pseudomedian of 9.
@@ -632,16 +646,31 @@ constexpr void pdqsort_loop(I begin, I end, Comp& comp, Proj& proj,
 
         // Sort the left partition first using recursion and do tail recursion
         // elimination for the right-hand partition.
-        detail::pdqsort_loop<Branchless>(begin, pivot_pos, comp, proj,
-                                         bad_allowed, leftmost);
+        recurse(begin, pivot_pos, bad_allowed, leftmost);
         begin = pivot_pos + 1;
         leftmost = false;
     }
 }
 
+template <bool Branchless, typename I, typename Comp, typename Proj>
+constexpr void pdqsort_loop(I begin, I end, Comp& comp, Proj& proj,
+                            int bad_allowed, bool leftmost = true)
+{
+    auto recurse = [&comp, &proj](I b, I e, int bad, bool lm) {
+        detail::pdqsort_loop<Branchless>(std::move(b), std::move(e), comp,
+                                         proj, bad, lm);
+    };
+    detail::pdqsort_loop<Branchless>(std::move(begin), std::move(end), comp,
+                                     proj, bad_allowed, leftmost, recurse);
+}
+
+template <typename I, typename Comp, typename Proj>
+inline constexpr bool pdqsort_use_branchless =
+    is_default_compare_v<std::remove_const_t<Comp>> &&
+    same_as<Proj, identity> && std::is_arithmetic<iter_value_t<I>>::value;
+
 template <typename I, typename Comp, typename Proj,
-          bool Branchless = is_default_compare_v<std::remove_const_t<Comp>>&&
-              same_as<Proj, identity>&& std::is_arithmetic<iter_value_t<I>>::value>
+          bool Branchless = pdqsort_use_branchless<I, Comp, Proj>>
 constexpr void pdqsort(I begin, I end, Comp& comp, Proj& proj)
 {
     if (begin == end) {
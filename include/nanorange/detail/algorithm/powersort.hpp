@@ -0,0 +1,322 @@
+// nanorange/detail/algorithm/powersort.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// An adaptive, stable merge sort which takes advantage of existing order in
+// its input. It splits the input into maximal ascending and strictly
+// descending runs, reversing the latter, and merges them in the order given
+// by the "powersort" policy of J. Ian Munro and Sebastian Wild, "Nearly-Optimal
+// Mergesorts: Fast, Practical Sorting Methods That Optimally Adapt to Existing
+// Runs" (ESA 2018). The merges gallop through long stretches taken from one
+// run, as in TimSort.
+//
+// A sorted or reverse-sorted input is handled with n - 1 comparisons, and an
+// input made up of r runs with O(n log r) comparisons.
+
+#ifndef NANORANGE_DETAIL_ALGORITHM_POWERSORT_HPP_INCLUDED
+#define NANORANGE_DETAIL_ALGORITHM_POWERSORT_HPP_INCLUDED
+
+#include <nanorange/algorithm/move.hpp>
+#include <nanorange/algorithm/reverse.hpp>
+#include <nanorange/detail/algorithm/gallop.hpp>
+#include <nanorange/detail/algorithm/pdqsort.hpp>
+#include <nanorange/iterator/back_insert_iterator.hpp>
+#include <nanorange/iterator/reverse_iterator.hpp>
+
+#include <array>
+#include <cstdint>
+
+NANO_BEGIN_NAMESPACE
+
+namespace detail {
+
+// Runs shorter than this are extended with insertion sort before merging
+constexpr std::ptrdiff_t powersort_min_run = 32;
+
+// Returns the end of the run beginning at first. If the run is strictly
+// descending, it is reversed, so that the elements of [first, end) are
+// ascending afterwards. Strict descent is required for stability.
+template <typename I, typename Comp, typename Proj>
+I powersort_find_run(I first, I last, Comp& comp, Proj& proj)
+{
+    if (last - first < 2) {
+        return last;
+    }
+
+    I it = first + 1;
+    if (nano::invoke(comp, nano::invoke(proj, *it),
+                     nano::invoke(proj, *first))) {
+        while (++it != last &&
+               nano::invoke(comp, nano::invoke(proj, *it),
+                            nano::invoke(proj, *(it - 1)))) {}
+        nano::reverse(first, it);
+    } else {
+        while (++it != last &&
+               !nano::invoke(comp, nano::invoke(proj, *it),
+                             nano::invoke(proj, *(it - 1)))) {}
+    }
+
+    return it;
+}
+
+// Returns the depth in the merge tree of the boundary between the adjacent
+// runs [begin1, end1) and [end1, end2) of a range of n elements beginning at
+// offset 0. This is the number of leading bits which the binary expansions
+// of the runs' midpoints, as fractions of n, have in common, plus one.
+inline int powersort_node_power(std::uint64_t n, std::uint64_t begin1,
+                                std::uint64_t end1, std::uint64_t end2)
+{
+    // Twice the midpoints, compared against twice n
+    std::uint64_t a = begin1 + end1;
+    std::uint64_t b = end1 + end2;
+    const std::uint64_t two_n = 2 * n;
+
+    int power = 0;
+    while (true) {
+        ++power;
+        if (a >= two_n) {
+            a -= two_n;
+            b -= two_n;
+        } else if (b >= two_n) {
+            return power;
+        }
+        a <<= 1;
+        b <<= 1;
+    }
+}
+
+// Merges [first, middle) with the shorter [middle, last), which has been
+// moved into buf, working backwards from the end
+template <typename I, typename Buf, typename Comp, typename Proj>
+void powersort_merge_hi(I first, I middle, I last, Buf& buf, Comp& comp,
+                        Proj& proj)
+{
+    nano::move(middle, last, nano::back_inserter(buf));
+    const auto buf_first = buf.begin();
+    auto buf_last = buf.end();
+
+    std::ptrdiff_t run1 = 0;
+    std::ptrdiff_t run2 = 0;
+
+    while (buf_last != buf_first && middle != first) {
+        // Ties go to the second run, which comes last
+        if (nano::invoke(comp, nano::invoke(proj, *(buf_last - 1)),
+                         nano::invoke(proj, *(middle - 1)))) {
+            *--last = nano::iter_move(--middle);
+            run2 = 0;
+            if (++run1 == gallop_threshold) {
+                // Move the rest of the elements of the first run which are
+                // greater than the last element of the second run in one go
+                const I mid = detail::gallop(
+                    nano::make_reverse_iterator(middle),
+                    nano::make_reverse_iterator(first), [&](auto&& x) {
+                        return nano::invoke(comp,
+                                            nano::invoke(proj, *(buf_last - 1)),
+                                            nano::invoke(proj, x));
+                    }).base();
+                last = nano::move_backward(mid, middle, std::move(last)).out;
+                middle = mid;
+                run1 = 0;
+            }
+        } else {
+            *--last = std::move(*--buf_last);
+            run1 = 0;
+            if (++run2 == gallop_threshold) {
+                // Likewise the elements of the second run which are not less
+                // than the last element of the first run
+                const auto mid = detail::gallop(
+                    nano::make_reverse_iterator(buf_last),
+                    nano::make_reverse_iterator(buf_first), [&](auto&& y) {
+                        return !nano::invoke(comp, nano::invoke(proj, y),
+                                             nano::invoke(proj, *(middle - 1)));
+                    }).base();
+                last = nano::move_backward(mid, buf_last, std::move(last)).out;
+                buf_last = mid;
+                run2 = 0;
+            }
+        }
+    }
+
+    // Any elements left in the first run are already in place
+    nano::move_backward(buf_first, buf_last, std::move(last));
+    buf.clear();
+}
+
+// Merges the shorter [first, middle), which has been moved into buf, with
+// [middle, last), working forwards from the beginning
+template <typename I, typename Buf, typename Comp, typename Proj>
+void powersort_merge_lo(I first, I middle, I last, Buf& buf, Comp& comp,
+                        Proj& proj)
+{
+    nano::move(first, middle, nano::back_inserter(buf));
+    auto buf_first = buf.begin();
+    const auto buf_last = buf.end();
+
+    std::ptrdiff_t run1 = 0;
+    std::ptrdiff_t run2 = 0;
+
+    while (buf_first != buf_last && middle != last) {
+        // Ties go to the first run, which comes first
+        if (nano::invoke(comp, nano::invoke(proj, *middle),
+                         nano::invoke(proj, *buf_first))) {
+            *first = nano::iter_move(middle);
+            ++first;
+            ++middle;
+            run1 = 0;
+            if (++run2 == gallop_threshold) {
+                const I mid = detail::gallop(middle, last, [&](auto&& y) {
+                    return nano::invoke(comp, nano::invoke(proj, y),
+                                        nano::invoke(proj, *buf_first));
+                });
+                first = nano::move(middle, mid, std::move(first)).out;
+                middle = mid;
+                run2 = 0;
+            }
+        } else {
+            *first = std::move(*buf_first);
+            ++first;
+            ++buf_first;
+            run2 = 0;
+            if (++run1 == gallop_threshold) {
+                const auto mid = detail::gallop(buf_first, buf_last,
+                                                [&](auto&& x) {
+                    return !nano::invoke(comp, nano::invoke(proj, *middle),
+                                         nano::invoke(proj, x));
+                });
+                first = nano::move(buf_first, mid, std::move(first)).out;
+                buf_first = mid;
+                run1 = 0;
+            }
+        }
+    }
+
+    // Any elements left in the second run are already in place
+    nano::move(buf_first, buf_last, std::move(first));
+    buf.clear();
+}
+
+// Given adjacent sorted runs [first, middle) and [middle, last), skips the
+// elements at the start of the first run which are not greater than the
+// first element of the second run, and those at the end of the second run
+// which are not less than the last element of the first, since they are
+// already in place. For nearly sorted input, this is most of them. Returns
+// false if nothing is left to merge.
+template <typename I, typename Comp, typename Proj>
+bool powersort_trim(I& first, I middle, I& last, Comp& comp, Proj& proj)
+{
+    first = detail::gallop(first, middle, [&](auto&& x) {
+        return !nano::invoke(comp, nano::invoke(proj, *middle),
+                             nano::invoke(proj, x));
+    });
+    if (first == middle) {
+        return false;
+    }
+
+    last = detail::gallop(nano::make_reverse_iterator(last),
+                          nano::make_reverse_iterator(middle), [&](auto&& y) {
+                              return !nano::invoke(
+                                  comp, nano::invoke(proj, y),
+                                  nano::invoke(proj, *(middle - 1)));
+                          }).base();
+    return true;
+}
+
+// Merges the adjacent sorted runs [first, middle) and [middle, last). buf
+// must be empty, and have room for the shorter of the two.
+template <typename I, typename Buf, typename Comp, typename Proj>
+void powersort_merge(I first, I middle, I last, Buf& buf, Comp& comp,
+                     Proj& proj)
+{
+    if (!detail::powersort_trim(first, middle, last, comp, proj)) {
+        return;
+    }
+
+    if (last - middle < middle - first) {
+        detail::powersort_merge_hi(first, middle, last, buf, comp, proj);
+    } else {
+        detail::powersort_merge_lo(first, middle, last, buf, comp, proj);
+    }
+}
+
+// Stably sorts [first, last), calling merge(begin, middle, end) to merge
+// pairs of adjacent sorted runs
+template <typename I, typename Comp, typename Proj, typename Merge>
+void powersort_runs(I first, I last, Comp& comp, Proj& proj, Merge merge)
+{
+    using diff_t = iter_difference_t<I>;
+
+    struct run {
+        diff_t begin;
+        diff_t end;
+        int power;
+    };
+
+    const diff_t n = last - first;
+
+    // Returns the end of the run starting at offset begin, extended to
+    // powersort_min_run elements if it is shorter
+    const auto next_run = [&](diff_t begin) {
+        const I run_first = first + begin;
+        I end = detail::powersort_find_run(run_first, last, comp, proj);
+        if (end - run_first < powersort_min_run && end != last) {
+            end = last - run_first > powersort_min_run
+                      ? run_first + powersort_min_run
+                      : last;
+            detail::insertion_sort(run_first, end, comp, proj);
+        }
+        return diff_t(end - first);
+    };
+
+    // The powers of the runs on the stack strictly increase from the bottom
+    // up, and are at most 64, so it can never overflow
+    std::array<run, 65> stack;
+    int top = 0;
+
+    diff_t begin1 = 0;
+    diff_t end1 = next_run(0);
+
+    while (end1 < n) {
+        const diff_t end2 = next_run(end1);
+        const int power = detail::powersort_node_power(
+            static_cast<std::uint64_t>(n), static_cast<std::uint64_t>(begin1),
+            static_cast<std::uint64_t>(end1), static_cast<std::uint64_t>(end2));
+
+        while (top > 0 && stack[top - 1].power > power) {
+            --top;
+            merge(first + stack[top].begin, first + stack[top].end,
+                  first + end1);
+            begin1 = stack[top].begin;
+        }
+
+        stack[top++] = run{begin1, end1, power};
+        begin1 = end1;
+        end1 = end2;
+    }
+
+    while (top > 0) {
+        --top;
+        merge(first + stack[top].begin, first + stack[top].end, first + end1);
+    }
+}
+
+// Stably sorts [first, last). buf must be empty, and have room for half of
+// the elements, rounded up.
+template <typename I, typename Buf, typename Comp, typename Proj>
+void powersort(I first, I last, Buf& buf, Comp& comp, Proj& proj)
+{
+    detail::powersort_runs(std::move(first), std::move(last), comp, proj,
+                           [&](I begin, I middle, I end) {
+                               detail::powersort_merge(std::move(begin),
+                                                       std::move(middle),
+                                                       std::move(end), buf,
+                                                       comp, proj);
+                           });
+}
+
+} // namespace detail
+
+NANO_END_NAMESPACE
+
+#endif
@@ -0,0 +1,317 @@
+// nanorange/detail/algorithm/radix_sort.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_DETAIL_ALGORITHM_RADIX_SORT_HPP_INCLUDED
+#define NANORANGE_DETAIL_ALGORITHM_RADIX_SORT_HPP_INCLUDED
+
+#include <nanorange/ranges.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <new>
+
+NANO_BEGIN_NAMESPACE
+
+namespace detail {
+
+// Keys which we know how to map to an unsigned integer with the same ordering
+template <typename K>
+inline constexpr bool is_radix_key =
+    (std::is_integral<K>::value && sizeof(K) <= 8) ||
+    (std::is_floating_point<K>::value && std::numeric_limits<K>::is_iec559 &&
+     (sizeof(K) == 4 || sizeof(K) == 8));
+
+template <std::size_t Size>
+struct radix_uint;
+
+template <> struct radix_uint<1> { using type = std::uint8_t; };
+template <> struct radix_uint<2> { using type = std::uint16_t; };
+template <> struct radix_uint<4> { using type = std::uint32_t; };
+template <> struct radix_uint<8> { using type = std::uint64_t; };
+
+template <typename K>
+using radix_uint_t = typename radix_uint<sizeof(K)>::type;
+
+// Returns an unsigned integer which compares (with <) in the same way that
+// key does
+template <typename K>
+radix_uint_t<K> radix_encode(K key)
+{
+    using U = radix_uint_t<K>;
+    constexpr U sign_bit = U(1) << (8 * sizeof(U) - 1);
+
+    U u;
+    if constexpr (std::is_same<K, bool>::value) {
+        u = key;
+    } else {
+        std::memcpy(&u, &key, sizeof(U));
+    }
+
+    if constexpr (std::is_floating_point<K>::value) {
+        // Negative numbers are stored as sign and magnitude, so we flip all
+        // the bits to reverse their order; positive numbers need only move
+        // above them
+        return (u & sign_bit) ? U(~u) : U(u | sign_bit);
+    } else if constexpr (std::is_signed<K>::value) {
+        return U(u ^ sign_bit);
+    } else {
+        return u;
+    }
+}
+
+// 1 if Comp sorts keys of type K in ascending order, -1 if descending, and
+// 0 if we can't tell
+template <typename Comp, typename K>
+inline constexpr int radix_direction = 0;
+
+template <typename K>
+inline constexpr int radix_direction<ranges::less, K> = 1;
+template <typename K>
+inline constexpr int radix_direction<std::less<>, K> = 1;
+template <typename K>
+inline constexpr int radix_direction<std::less<K>, K> = 1;
+template <typename K>
+inline constexpr int radix_direction<ranges::greater, K> = -1;
+template <typename K>
+inline constexpr int radix_direction<std::greater<>, K> = -1;
+template <typename K>
+inline constexpr int radix_direction<std::greater<K>, K> = -1;
+
+// Ranges shorter than this are sorted faster by pdqsort
+template <typename K>
+inline constexpr int radix_sort_threshold = 512 * int(sizeof(K));
+
+template <typename I, typename Proj>
+using radix_key_t = remove_cvref_t<indirect_result_t<Proj&, I>>;
+
+template <typename I, typename Comp, typename Proj,
+          bool = random_access_iterator<I> &&
+                 invocable<Proj&, iter_reference_t<I>>>
+inline constexpr bool is_radix_sortable = false;
+
+template <typename I, typename Comp, typename Proj>
+inline constexpr bool is_radix_sortable<I, Comp, Proj, true> =
+    std::is_same<iter_reference_t<I>, iter_value_t<I>&>::value &&
+    std::is_trivially_copyable<iter_value_t<I>>::value &&
+    is_radix_key<radix_key_t<I, Proj>> &&
+    radix_direction<Comp, radix_key_t<I, Proj>> != 0;
+
+// Buckets are sorted by LSD passes over all of their remaining digits when
+// that amount of work is below this limit, so that it runs on data which fits
+// in cache. Larger buckets are split by their most significant digit first.
+constexpr int radix_sort_lsd_limit = 1 << 18;
+
+// Below this size, the fixed cost of an LSD sort is too high and we split by
+// the most significant digit instead
+constexpr int radix_sort_lsd_min = 256;
+
+// Buckets no larger than this are insertion sorted
+constexpr int radix_sort_insertion_limit = 32;
+
+// Moves v into *out. The scratch buffer is raw memory, so when writing to a
+// pointer we construct in place; this is fine for the trivially copyable,
+// trivially destructible types we sort, even if there is already an object
+// there.
+template <typename V>
+void radix_put(V* out, V& v)
+{
+    ::new (static_cast<void*>(out)) V(std::move(v));
+}
+
+template <typename I, typename V>
+void radix_put(I out, V& v)
+{
+    *out = std::move(v);
+}
+
+template <typename Src, typename Dst, typename D>
+void radix_move(Src src, Dst dst, D n)
+{
+    for (D i = 0; i < n; ++i) {
+        detail::radix_put(dst + i, *(src + i));
+    }
+}
+
+template <typename K, typename Comp, typename Proj>
+struct radix_sorter {
+    using U = radix_uint_t<K>;
+
+    Proj& proj;
+
+    template <typename T>
+    U key(T& elem) const
+    {
+        const U u = detail::radix_encode<K>(nano::invoke(proj, elem));
+        return radix_direction<Comp, K> > 0 ? u : U(~u);
+    }
+
+    static unsigned digit(U u, int d)
+    {
+        return static_cast<unsigned>((u >> (8 * d)) & 0xFF);
+    }
+
+    // Moves [src, src + n) to [dst, dst + n) ordered by digit d, given the
+    // starting offset of each bucket
+    template <typename Src, typename Dst, typename D>
+    void scatter(Src src, Dst dst, D n, int d, D (&offsets)[256]) const
+    {
+        for (D i = 0; i < n; ++i) {
+            auto& elem = *(src + i);
+            detail::radix_put(dst + offsets[digit(key(elem), d)]++, elem);
+        }
+    }
+
+    // Sorts the n elements at src on the low num_digits digits of their
+    // keys, using the n elements at dst as scratch space. The result ends up
+    // at src if result_in_src is true, and at dst otherwise.
+    template <typename Src, typename Dst, typename D>
+    void sort(Src src, Dst dst, D n, int num_digits, bool result_in_src) const
+    {
+        if (n <= radix_sort_insertion_limit || num_digits == 0) {
+            if (result_in_src) {
+                insertion_sort(src, n);
+            } else {
+                detail::radix_move(src, dst, n);
+                insertion_sort(dst, n);
+            }
+        } else if (n >= radix_sort_lsd_min &&
+                   n * num_digits <= radix_sort_lsd_limit) {
+            lsd_sort(src, dst, n, num_digits, result_in_src);
+        } else {
+            msd_sort(src, dst, n, num_digits, result_in_src);
+        }
+    }
+
+    template <typename It, typename D>
+    void insertion_sort(It first, D n) const
+    {
+        for (D i = 1; i < n; ++i) {
+            iter_value_t<It> tmp = std::move(*(first + i));
+            const U k = key(tmp);
+            D j = i;
+            for (; j > 0 && k < key(*(first + (j - 1))); --j) {
+                *(first + j) = std::move(*(first + (j - 1)));
+            }
+            *(first + j) = std::move(tmp);
+        }
+    }
+
+    template <typename Src, typename Dst, typename D>
+    void lsd_sort(Src src, Dst dst, D n, int num_digits,
+                  bool result_in_src) const
+    {
+        // Build the histograms for every digit in a single pass
+        D counts[sizeof(U)][256] = {};
+        for (D i = 0; i < n; ++i) {
+            const U u = key(*(src + i));
+            for (int d = 0; d < num_digits; ++d) {
+                ++counts[d][digit(u, d)];
+            }
+        }
+        const U first_key = key(*src);
+
+        bool in_src = true;
+        for (int d = 0; d < num_digits; ++d) {
+            // If every element has the same digit, this pass would do nothing
+            if (counts[d][digit(first_key, d)] == n) {
+                continue;
+            }
+
+            D offsets[256];
+            D sum = 0;
+            for (int b = 0; b < 256; ++b) {
+                offsets[b] = sum;
+                sum += counts[d][b];
+            }
+
+            if (in_src) {
+                scatter(src, dst, n, d, offsets);
+            } else {
+                scatter(dst, src, n, d, offsets);
+            }
+            in_src = !in_src;
+        }
+
+        if (in_src != result_in_src) {
+            if (in_src) {
+                detail::radix_move(src, dst, n);
+            } else {
+                detail::radix_move(dst, src, n);
+            }
+        }
+    }
+
+    template <typename Src, typename Dst, typename D>
+    void msd_sort(Src src, Dst dst, D n, int num_digits,
+                  bool result_in_src) const
+    {
+        const int d = num_digits - 1;
+
+        D counts[256] = {};
+        for (D i = 0; i < n; ++i) {
+            ++counts[digit(key(*(src + i)), d)];
+        }
+
+        if (counts[digit(key(*src), d)] == n) {
+            sort(src, dst, n, d, result_in_src);
+            return;
+        }
+
+        D offsets[256];
+        D sum = 0;
+        for (int b = 0; b < 256; ++b) {
+            offsets[b] = sum;
+            sum += counts[b];
+        }
+        scatter(src, dst, n, d, offsets);
+
+        // The elements are now at dst, so the roles of the two buffers swap
+        D start = 0;
+        for (int b = 0; b < 256; ++b) {
+            if (counts[b] > 0) {
+                sort(dst + start, src + start, counts[b], d, !result_in_src);
+            }
+            start += counts[b];
+        }
+    }
+};
+
+// Sorts [first, last) by radix sorting the projected keys, one byte at a
+// time. The sort is stable. Returns false, leaving the range untouched, if a
+// temporary buffer could not be allocated.
+template <typename I, typename Comp, typename Proj>
+bool radix_sort(I first, I last, Comp&, Proj& proj)
+{
+    using V = iter_value_t<I>;
+    using K = radix_key_t<I, Proj>;
+
+    const auto n = last - first;
+    if (n < 2) {
+        return true;
+    }
+
+    struct deleter {
+        void operator()(V* ptr) const { ::operator delete(ptr); }
+    };
+    std::unique_ptr<V, deleter> buf(static_cast<V*>(::operator new(
+        static_cast<std::size_t>(n) * sizeof(V), std::nothrow)));
+    if (!buf) {
+        return false;
+    }
+
+    radix_sorter<K, Comp, Proj>{proj}.sort(std::move(first), buf.get(), n,
+                                           int(sizeof(K)), true);
+    return true;
+}
+
+} // namespace detail
+
+NANO_END_NAMESPACE
+
+#endif
@@ -0,0 +1,944 @@
+// nanorange/detail/algorithm/simd.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_DETAIL_ALGORITHM_SIMD_HPP_INCLUDED
+#define NANORANGE_DETAIL_ALGORITHM_SIMD_HPP_INCLUDED
+
+#include <nanorange/detail/algorithm/memmove.hpp>
+#include <nanorange/detail/algorithm/result_types.hpp>
+#include <nanorange/detail/functional/comparisons.hpp>
+#include <nanorange/detail/functional/identity.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Vectorised kernels are selected at compile time. SSE2 is part of the x86-64
+// baseline; AVX2 is used when the compiler is allowed to emit it (e.g. with
+// -mavx2 or /arch:AVX2). Define NANORANGE_NO_SIMD to disable both.
+#if !defined(NANORANGE_NO_SIMD) && defined(__AVX2__)
+#define NANO_HAS_AVX2 1
+#else
+#define NANO_HAS_AVX2 0
+#endif
+
+#if !defined(NANORANGE_NO_SIMD) &&                                             \
+    (defined(__SSE2__) || defined(_M_X64) ||                                   \
+     (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define NANO_HAS_SSE2 1
+#else
+#define NANO_HAS_SSE2 0
+#endif
+
+// SSSE3 adds a byte shuffle, which we use as a 16-entry table lookup
+#if NANO_HAS_SSE2 && (NANO_HAS_AVX2 || defined(__SSSE3__))
+#define NANO_HAS_SIMD_SHUFFLE 1
+#else
+#define NANO_HAS_SIMD_SHUFFLE 0
+#endif
+
+#if NANO_HAS_AVX2
+#include <immintrin.h>
+#elif NANO_HAS_SIMD_SHUFFLE
+#include <tmmintrin.h>
+#elif NANO_HAS_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+NANO_BEGIN_NAMESPACE
+
+namespace detail {
+
+// Types for which == is a bitwise comparison, and which we know how to scan
+template <typename T>
+inline constexpr bool is_simd_scannable =
+    (std::is_integral<T>::value || std::is_same<T, std::byte>::value) &&
+    (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8);
+
+template <typename I, bool = contiguous_iterator<I>>
+inline constexpr bool is_simd_iterator = false;
+
+template <typename I>
+inline constexpr bool is_simd_iterator<I, true> =
+    is_simd_scannable<iter_value_t<I>> &&
+    !std::is_volatile<std::remove_reference_t<iter_reference_t<I>>>::value;
+
+// Whether find(first, last, value, proj) and count(...) may use the kernels
+// below. Values of other integral types are converted to the element type
+// first; see simd_narrow().
+template <typename I, typename T, typename Proj>
+inline constexpr bool is_simd_find_candidate =
+    is_simd_iterator<I> && std::is_same<Proj, identity>::value &&
+    (std::is_integral<T>::value ||
+     std::is_same<T, remove_cvref_t<iter_reference_t<I>>>::value);
+
+// Whether mismatch() and equal() may compare the two sequences bytewise
+template <typename I1, typename I2, typename Pred, typename Proj1,
+          typename Proj2>
+inline constexpr bool is_simd_mismatch_candidate =
+    is_simd_iterator<I1> && is_simd_iterator<I2> &&
+    std::is_same<iter_value_t<I1>, iter_value_t<I2>>::value &&
+    std::is_same<Pred, ranges::equal_to>::value &&
+    std::is_same<Proj1, identity>::value &&
+    std::is_same<Proj2, identity>::value;
+
+// Whether set_intersection(), set_difference() and set_union() may use the
+// kernels for sorted sequences of integers below
+template <typename I1, typename S1, typename I2, typename S2, typename Comp,
+          typename Proj1, typename Proj2>
+inline constexpr bool is_simd_set_candidate =
+    is_simd_iterator<I1> && sized_sentinel_for<S1, I1> &&
+    is_simd_iterator<I2> && sized_sentinel_for<S2, I2> &&
+    std::is_same<iter_value_t<I1>, iter_value_t<I2>>::value &&
+    std::is_integral<iter_value_t<I1>>::value &&
+    (sizeof(iter_value_t<I1>) == 4 || sizeof(iter_value_t<I1>) == 8) &&
+    std::is_same<Comp, ranges::less>::value &&
+    std::is_same<Proj1, identity>::value &&
+    std::is_same<Proj2, identity>::value;
+
+// Converts value to T for comparison against elements of type T. Returns
+// false if no element of type T could compare equal to value.
+template <typename T, typename U>
+bool simd_narrow(const U& value, T& out)
+{
+    out = static_cast<T>(value);
+    if constexpr (std::is_same<T, U>::value) {
+        return true;
+    } else {
+        return static_cast<U>(out) == value;
+    }
+}
+
+inline int simd_ctz(std::uint32_t mask)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long idx;
+    _BitScanForward(&idx, mask);
+    return static_cast<int>(idx);
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+// Returns the index of the highest set bit. Requires mask != 0.
+inline int simd_highest_bit(std::uint32_t mask)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long idx;
+    _BitScanReverse(&idx, mask);
+    return static_cast<int>(idx);
+#else
+    return 31 - __builtin_clz(mask);
+#endif
+}
+
+// Hints that the cache line containing p will be read soon
+inline void simd_prefetch(const void* p)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+#if defined(_M_IX86) || defined(_M_X64)
+    _mm_prefetch(static_cast<const char*>(p), _MM_HINT_T0);
+#else
+    (void) p;
+#endif
+#else
+    __builtin_prefetch(p);
+#endif
+}
+
+#if NANO_HAS_AVX2 || NANO_HAS_SSE2
+
+// A thin wrapper around the widest available integer vector register. All
+// comparisons produce a mask with one bit per byte, so a matching element of
+// size N sets N consecutive bits.
+struct simd_vec {
+#if NANO_HAS_AVX2
+    using type = __m256i;
+    static constexpr std::ptrdiff_t bytes = 32;
+
+    static type load(const void* p)
+    {
+        return _mm256_loadu_si256(static_cast<const __m256i*>(p));
+    }
+
+    static std::uint32_t movemask(type v)
+    {
+        return static_cast<std::uint32_t>(_mm256_movemask_epi8(v));
+    }
+
+    template <typename T>
+    static type splat(T value)
+    {
+        if constexpr (sizeof(T) == 1) {
+            std::int8_t i;
+            std::memcpy(&i, &value, 1);
+            return _mm256_set1_epi8(i);
+        } else if constexpr (sizeof(T) == 2) {
+            std::int16_t i;
+            std::memcpy(&i, &value, 2);
+            return _mm256_set1_epi16(i);
+        } else if constexpr (sizeof(T) == 4) {
+            std::int32_t i;
+            std::memcpy(&i, &value, 4);
+            return _mm256_set1_epi32(i);
+        } else {
+            long long i;
+            std::memcpy(&i, &value, 8);
+            return _mm256_set1_epi64x(i);
+        }
+    }
+
+    template <std::size_t N>
+    static type eq(type a, type b)
+    {
+        if constexpr (N == 1) {
+            return _mm256_cmpeq_epi8(a, b);
+        } else if constexpr (N == 2) {
+            return _mm256_cmpeq_epi16(a, b);
+        } else if constexpr (N == 4) {
+            return _mm256_cmpeq_epi32(a, b);
+        } else {
+            return _mm256_cmpeq_epi64(a, b);
+        }
+    }
+
+    static type zero() { return _mm256_setzero_si256(); }
+
+    static type sub_bytes(type a, type b) { return _mm256_sub_epi8(a, b); }
+
+    static type bit_and(type a, type b) { return _mm256_and_si256(a, b); }
+
+    static type bit_or(type a, type b) { return _mm256_or_si256(a, b); }
+
+    // Rotates the N-byte lanes of v down by one, for N = 4 or 8
+    template <std::size_t N>
+    static type rotate(type v)
+    {
+        if constexpr (N == 4) {
+            return _mm256_permutevar8x32_epi32(
+                v, _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0));
+        } else {
+            return _mm256_permute4x64_epi64(v, _MM_SHUFFLE(0, 3, 2, 1));
+        }
+    }
+
+    // Splits each byte into its low and high nibbles
+    static type low_nibbles(type v)
+    {
+        return _mm256_and_si256(v, _mm256_set1_epi8(0x0F));
+    }
+
+    static type high_nibbles(type v)
+    {
+        return _mm256_and_si256(_mm256_srli_epi16(v, 4), _mm256_set1_epi8(0x0F));
+    }
+
+    // Loads a 16-byte table for use with lookup16()
+    static type load_table16(const unsigned char* table)
+    {
+        return _mm256_broadcastsi128_si256(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(table)));
+    }
+
+    // Replaces each byte of idx, which must be less than 16, by that entry of
+    // the table
+    static type lookup16(type table, type idx)
+    {
+        return _mm256_shuffle_epi8(table, idx);
+    }
+
+    // Returns the sum of all the (unsigned) bytes of v
+    static std::ptrdiff_t sum_bytes(type v)
+    {
+        const __m256i s = _mm256_sad_epu8(v, zero());
+        const __m128i t = _mm_add_epi64(_mm256_castsi256_si128(s),
+                                        _mm256_extracti128_si256(s, 1));
+        return _mm_cvtsi128_si32(t) + _mm_extract_epi16(t, 4);
+    }
+
+    static constexpr std::uint32_t all_ones = 0xFFFFFFFFu;
+#else
+    using type = __m128i;
+    static constexpr std::ptrdiff_t bytes = 16;
+
+    static type load(const void* p)
+    {
+        return _mm_loadu_si128(static_cast<const __m128i*>(p));
+    }
+
+    static std::uint32_t movemask(type v)
+    {
+        return static_cast<std::uint32_t>(_mm_movemask_epi8(v));
+    }
+
+    template <typename T>
+    static type splat(T value)
+    {
+        if constexpr (sizeof(T) == 1) {
+            std::int8_t i;
+            std::memcpy(&i, &value, 1);
+            return _mm_set1_epi8(i);
+        } else if constexpr (sizeof(T) == 2) {
+            std::int16_t i;
+            std::memcpy(&i, &value, 2);
+            return _mm_set1_epi16(i);
+        } else if constexpr (sizeof(T) == 4) {
+            std::int32_t i;
+            std::memcpy(&i, &value, 4);
+            return _mm_set1_epi32(i);
+        } else {
+            std::int32_t i[2];
+            std::memcpy(i, &value, 8);
+            return _mm_set_epi32(i[1], i[0], i[1], i[0]);
+        }
+    }
+
+    template <std::size_t N>
+    static type eq(type a, type b)
+    {
+        if constexpr (N == 1) {
+            return _mm_cmpeq_epi8(a, b);
+        } else if constexpr (N == 2) {
+            return _mm_cmpeq_epi16(a, b);
+        } else if constexpr (N == 4) {
+            return _mm_cmpeq_epi32(a, b);
+        } else {
+            // SSE2 has no 64-bit compare: a 64-bit lane is equal if both of
+            // its 32-bit halves are
+            const type e = _mm_cmpeq_epi32(a, b);
+            return _mm_and_si128(e,
+                                 _mm_shuffle_epi32(e, _MM_SHUFFLE(2, 3, 0, 1)));
+        }
+    }
+
+    static type zero() { return _mm_setzero_si128(); }
+
+    static type sub_bytes(type a, type b) { return _mm_sub_epi8(a, b); }
+
+    static type bit_and(type a, type b) { return _mm_and_si128(a, b); }
+
+    static type bit_or(type a, type b) { return _mm_or_si128(a, b); }
+
+    // Rotates the N-byte lanes of v down by one, for N = 4 or 8
+    template <std::size_t N>
+    static type rotate(type v)
+    {
+        if constexpr (N == 4) {
+            return _mm_shuffle_epi32(v, _MM_SHUFFLE(0, 3, 2, 1));
+        } else {
+            return _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2));
+        }
+    }
+
+    // Splits each byte into its low and high nibbles
+    static type low_nibbles(type v)
+    {
+        return _mm_and_si128(v, _mm_set1_epi8(0x0F));
+    }
+
+    static type high_nibbles(type v)
+    {
+        return _mm_and_si128(_mm_srli_epi16(v, 4), _mm_set1_epi8(0x0F));
+    }
+
+#if NANO_HAS_SIMD_SHUFFLE
+    // Loads a 16-byte table for use with lookup16()
+    static type load_table16(const unsigned char* table)
+    {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(table));
+    }
+
+    // Replaces each byte of idx, which must be less than 16, by that entry of
+    // the table
+    static type lookup16(type table, type idx)
+    {
+        return _mm_shuffle_epi8(table, idx);
+    }
+#endif
+
+    // Returns the sum of all the (unsigned) bytes of v
+    static std::ptrdiff_t sum_bytes(type v)
+    {
+        const __m128i s = _mm_sad_epu8(v, zero());
+        return _mm_cvtsi128_si32(s) + _mm_extract_epi16(s, 4);
+    }
+
+    static constexpr std::uint32_t all_ones = 0xFFFFu;
+#endif
+
+    template <std::size_t N>
+    static std::uint32_t eq_mask(type a, type b)
+    {
+        return movemask(eq<N>(a, b));
+    }
+
+    template <typename T>
+    static constexpr std::ptrdiff_t lanes = bytes / sizeof(T);
+
+    // The lowest of the bits which a movemask() sets for each N-byte lane
+    template <std::size_t N>
+    static constexpr std::uint32_t lane_bits = all_ones / ((1u << N) - 1);
+};
+
+#endif // NANO_HAS_AVX2 || NANO_HAS_SSE2
+
+// Returns a pointer to the first element of [first, last) which is equal to
+// value, or last if there is no such element
+template <typename T, typename U>
+const T* simd_find(const T* first, const T* last, const U& value)
+{
+    T needle;
+    if (!detail::simd_narrow(value, needle)) {
+        return last;
+    }
+
+#if NANO_HAS_AVX2 || NANO_HAS_SSE2
+    const auto vneedle = simd_vec::splat(needle);
+    while (last - first >= simd_vec::lanes<T>) {
+        const std::uint32_t mask =
+            simd_vec::eq_mask<sizeof(T)>(simd_vec::load(first), vneedle);
+        if (mask != 0) {
+            return first + detail::simd_ctz(mask) / int(sizeof(T));
+        }
+        first += simd_vec::lanes<T>;
+    }
+#endif
+
+    while (first != last && !(*first == needle)) {
+        ++first;
+    }
+    return first;
+}
+
+// Returns a pointer to the first element of [first, last) which is not equal
+// to value, or last if there is no such element
+template <typename T>
+const T* simd_find_not(const T* first, const T* last, T value)
+{
+#if NANO_HAS_AVX2 || NANO_HAS_SSE2
+    const auto vvalue = simd_vec::splat(value);
+    while (last - first >= simd_vec::lanes<T>) {
+        const std::uint32_t mask =
+            simd_vec::eq_mask<sizeof(T)>(simd_vec::load(first), vvalue);
+        if (mask != simd_vec::all_ones) {
+            return first + detail::simd_ctz(~mask) / int(sizeof(T));
+        }
+        first += simd_vec::lanes<T>;
+    }
+#endif
+
+    while (first != last && *first == value) {
+        ++first;
+    }
+    return first;
+}
+
+// Returns a pointer to the start of the longest suffix of [first, last) whose
+// elements are all equal to value
+template <typename T>
+const T* simd_find_run_start(const T* first, const T* last, T value)
+{
+#if NANO_HAS_AVX2 || NANO_HAS_SSE2
+    const auto vvalue = simd_vec::splat(value);
+    while (last - first >= simd_vec::lanes<T>) {
+        const std::uint32_t mask = simd_vec::eq_mask<sizeof(T)>(
+            simd_vec::load(last - simd_vec::lanes<T>), vvalue);
+        if (mask != simd_vec::all_ones) {
+            // The highest clear bit belongs to the last unequal element
+            const int bit = detail::simd_highest_bit(~mask & simd_vec::all_ones);
+            return last - simd_vec::lanes<T> + bit / int(sizeof(T)) + 1;
+        }
+        last -= simd_vec::lanes<T>;
+    }
+#endif
+
+    while (last != first && *(last - 1) == value) {
+        --last;
+    }
+    return last;
+}
+
+// Returns a pointer to the first of count consecutive elements of
+// [first, last) which are equal to value, or last if there are none.
+// Requires count > 0.
+template <typename T, typename U>
+const T* simd_search_n(const T* first, const T* const last,
+                       std::ptrdiff_t count, const U& value)
+{
+    T needle;
+    if (!detail::simd_narrow(value, needle)) {
+        return last;
+    }
+
+    // Any run of count elements must include one of the elements count - 1,
+    // 2 * count - 1, ... places from the start of the range. For short runs
+    // it's quicker to scan for the next equal element than to probe each of
+    // them in turn.
+    constexpr std::ptrdiff_t probe_threshold = 16;
+
+    while (last - first >= count) {
+        const T* probe = first + (count - 1);
+        if (count < probe_threshold) {
+            probe = detail::simd_find(probe, last, needle);
+            if (probe == last) {
+                break;
+            }
+        } else if (!(*probe == needle)) {
+            first = probe + 1;
+            continue;
+        }
+
+        // Extend the run around the probe in both directions, but no further
+        // forward than we need to
+        const T* const run_first =
+            detail::simd_find_run_start(first, probe, needle);
+        const T* const limit =
+            last - run_first > count ? run_first + count : last;
+        const T* const run_last = detail::simd_find_not(probe + 1, limit, needle);
+        if (run_last - run_first == count) {
+            return run_first;
+        }
+        if (run_last == last) {
+            break;
+        }
+        first = run_last + 1;
+    }
+
+    return last;
+}
+
+// A set of byte values, for find_first_of(). Membership is tested with a
+// 256-bit bitmap. The vectorised kernels instead use one of:
+//
+//  * with a byte shuffle, a pair of 16-entry tables indexed by the low and
+//    high nibbles of each byte. Each distinct high nibble in the set is
+//    given one of eight bits; the low table has that bit set for each low
+//    nibble which occurs with it, so a byte is in the set if the two entries
+//    have a bit in common. This handles any set with at most eight distinct
+//    high nibbles, including every set of up to eight bytes.
+//
+//  * otherwise, one comparison for each byte in the set, if there are at
+//    most four of them
+struct simd_byte_set {
+    static constexpr int max_compares = 4;
+
+    void insert(unsigned char c)
+    {
+        if (contains(c)) {
+            return;
+        }
+        bits_[c >> 6] |= std::uint64_t(1) << (c & 63);
+
+        if (size_ < max_compares) {
+            values_[size_] = c;
+        }
+        ++size_;
+
+        unsigned char& hi = high_table_[c >> 4];
+        if (hi == 0) {
+            if (num_high_ == 8) {
+                nibble_tables_ok_ = false;
+                return;
+            }
+            hi = static_cast<unsigned char>(1u << num_high_++);
+        }
+        low_table_[c & 15] |= hi;
+    }
+
+    bool contains(unsigned char c) const
+    {
+        return (bits_[c >> 6] >> (c & 63)) & 1;
+    }
+
+    int size() const { return size_; }
+
+private:
+    template <typename T>
+    friend const T* simd_find_first_of(const T*, const T*,
+                                       const simd_byte_set&);
+
+    std::uint64_t bits_[4] = {};
+    unsigned char low_table_[16] = {};
+    unsigned char high_table_[16] = {};
+    unsigned char values_[max_compares] = {};
+    int size_ = 0;
+    int num_high_ = 0;
+    bool nibble_tables_ok_ = true;
+};
+
+// Returns a pointer to the first element of [first, last) which is in set,
+// or last if there is no such element. Requires sizeof(T) == 1.
+template <typename T>
+const T* simd_find_first_of(const T* first, const T* last,
+                            const simd_byte_set& set)
+{
+    static_assert(sizeof(T) == 1, "");
+
+    if (set.size() == 0) {
+        return last;
+    }
+
+#if NANO_HAS_SIMD_SHUFFLE
+    if (set.nibble_tables_ok_) {
+        const auto low = simd_vec::load_table16(set.low_table_);
+        const auto high = simd_vec::load_table16(set.high_table_);
+        const auto zero = simd_vec::zero();
+        while (last - first >= simd_vec::bytes) {
+            const auto v = simd_vec::load(first);
+            const auto hits = simd_vec::bit_and(
+                simd_vec::lookup16(low, simd_vec::low_nibbles(v)),
+                simd_vec::lookup16(high, simd_vec::high_nibbles(v)));
+            const std::uint32_t mask =
+                ~simd_vec::eq_mask<1>(hits, zero) & simd_vec::all_ones;
+            if (mask != 0) {
+                return first + detail::simd_ctz(mask);
+            }
+            first += simd_vec::bytes;
+        }
+    }
+#elif NANO_HAS_SSE2
+    if (set.size() <= simd_byte_set::max_compares) {
+        simd_vec::type needles[simd_byte_set::max_compares];
+        for (int i = 0; i < set.size(); ++i) {
+            needles[i] = simd_vec::splat(set.values_[i]);
+        }
+        while (last - first >= simd_vec::bytes) {
+            const auto v = simd_vec::load(first);
+            auto hits = simd_vec::eq<1>(v, needles[0]);
+            for (int i = 1; i < set.size(); ++i) {
+                hits = simd_vec::bit_or(hits, simd_vec::eq<1>(v, needles[i]));
+            }
+            const std::uint32_t mask = simd_vec::movemask(hits);
+            if (mask != 0) {
+                return first + detail::simd_ctz(mask);
+            }
+            first += simd_vec::bytes;
+        }
+    }
+#endif
+
+    for (; first != last; ++first) {
+        unsigned char c;
+        std::memcpy(&c, first, 1);
+        if (set.contains(c)) {
+            break;
+        }
+    }
+    return first;
+}
+
+// Returns the number of elements of [first, last) which are equal to value
+template <typename T, typename U>
+std::ptrdiff_t simd_count(const T* first, const T* last, const U& value)
+{
+    T needle;
+    if (!detail::simd_narrow(value, needle)) {
+        return 0;
+    }
+
+    std::ptrdiff_t count = 0;
+
+#if NANO_HAS_AVX2 || NANO_HAS_SSE2
+    // Each comparison sets every byte of a matching element to 0xFF, which
+    // we subtract from per-byte counters. These are summed and reset before
+    // they can overflow.
+    const auto vneedle = simd_vec::splat(needle);
+    while (last - first >= simd_vec::lanes<T>) {
+        auto counters = simd_vec::zero();
+        for (int i = 0; i < 255 && last - first >= simd_vec::lanes<T>; ++i) {
+            counters = simd_vec::sub_bytes(
+                counters,
+                simd_vec::eq<sizeof(T)>(simd_vec::load(first), vneedle));
+            first += simd_vec::lanes<T>;
+        }
+        count += simd_vec::sum_bytes(counters);
+    }
+    count /= static_cast<std::ptrdiff_t>(sizeof(T));
+#endif
+
+    for (; first != last; ++first) {
+        count += (*first == needle);
+    }
+    return count;
+}
+
+// Returns the index of the first position at which the n-element sequences
+// beginning at first1 and first2 differ, or n if they do not
+template <typename T>
+std::ptrdiff_t simd_mismatch(const T* first1, const T* first2,
+                             std::ptrdiff_t n)
+{
+    std::ptrdiff_t i = 0;
+
+#if NANO_HAS_AVX2 || NANO_HAS_SSE2
+    for (; n - i >= simd_vec::lanes<T>; i += simd_vec::lanes<T>) {
+        const std::uint32_t mask = simd_vec::eq_mask<sizeof(T)>(
+            simd_vec::load(first1 + i), simd_vec::load(first2 + i));
+        if (mask != simd_vec::all_ones) {
+            return i + detail::simd_ctz(~mask) / int(sizeof(T));
+        }
+    }
+#endif
+
+    while (i != n && first1[i] == first2[i]) {
+        ++i;
+    }
+    return i;
+}
+
+// The set kernels take time proportional to the total length of both ranges,
+// so very lopsided inputs are better left to the galloping loops
+inline bool simd_set_is_balanced(std::ptrdiff_t n1, std::ptrdiff_t n2)
+{
+    return n1 / 16 <= n2 && n2 / 16 <= n1;
+}
+
+// Computes a prefix of set_intersection() (if Intersect) or set_difference()
+// of the sorted ranges [first1, last1) and [first2, last2), returning how far
+// it got in each so that the element-by-element loop can finish the job.
+//
+// Each block of simd_vec::lanes<T> elements from range1 is compared with
+// every rotation of the block from range2, and whichever block has the
+// smaller last element is replaced by the next one. An element of range1 is
+// in range2 if it matched any of the blocks it was compared with. This only
+// works if each value occurs at most once in each range, so we stop at the
+// first block containing a repeated value.
+template <bool Intersect, typename T, typename O>
+in_in_out_result<const T*, const T*, O>
+simd_set_match(const T* first1, const T* last1, const T* first2,
+               const T* last2, O out)
+{
+#if NANO_HAS_AVX2 || NANO_HAS_SSE2
+    constexpr std::size_t N = sizeof(T);
+    constexpr std::ptrdiff_t L = simd_vec::lanes<T>;
+
+    // Checks for repeats in a block, and between it and the next element
+    const auto distinct = [](const T* p) {
+        return simd_vec::eq_mask<N>(simd_vec::load(p),
+                                    simd_vec::load(p + 1)) == 0;
+    };
+
+    const auto emit = [&out](const T* block, std::uint32_t mask) {
+        mask &= simd_vec::lane_bits<N>;
+        while (mask != 0) {
+            *out = block[detail::simd_ctz(mask) / int(N)];
+            ++out;
+            mask &= mask - 1;
+        }
+    };
+
+    if (last1 - first1 <= L || last2 - first2 <= L || !distinct(first1) ||
+        !distinct(first2)) {
+        return {first1, first2, std::move(out)};
+    }
+
+    auto block1 = simd_vec::load(first1);
+    auto block2 = simd_vec::load(first2);
+    // Which elements of the current block of range1 have matched so far
+    std::uint32_t matched = 0;
+
+    while (true) {
+        auto rotated = block2;
+        auto eq = simd_vec::eq<N>(block1, rotated);
+        for (std::ptrdiff_t i = 1; i < L; ++i) {
+            rotated = simd_vec::rotate<N>(rotated);
+            eq = simd_vec::bit_or(eq, simd_vec::eq<N>(block1, rotated));
+        }
+        matched |= simd_vec::movemask(eq);
+
+        const T max1 = first1[L - 1];
+        const T max2 = first2[L - 1];
+        if (!(max2 < max1)) {
+            // Every element of this block which is in range2 has been seen
+            emit(first1, Intersect ? matched : ~matched);
+            matched = 0;
+            first1 += L;
+            if (last1 - first1 <= L || !distinct(first1)) {
+                break;
+            }
+            block1 = simd_vec::load(first1);
+        }
+        if (!(max1 < max2)) {
+            first2 += L;
+            if (last2 - first2 <= L || !distinct(first2)) {
+                break;
+            }
+            block2 = simd_vec::load(first2);
+        }
+    }
+
+    // Settle those elements of the current block of range1 which are less
+    // than everything left in range2, so that what remains has not been
+    // compared with anything
+    const std::ptrdiff_t n = last1 - first1 < L ? last1 - first1 : L;
+    std::ptrdiff_t i = 0;
+    for (; i < n && (first2 == last2 || first1[i] < *first2); ++i) {
+        if (((matched >> (i * N)) & 1u) == (Intersect ? 1u : 0u)) {
+            *out = first1[i];
+            ++out;
+        }
+    }
+    first1 += i;
+#else
+    (void) last1;
+    (void) last2;
+#endif
+
+    return {first1, first2, std::move(out)};
+}
+
+// Merges the sorted ranges [first1, last1) and [first2, last2) as
+// set_union() does, until one of them runs out. SSE2 has no integer min and
+// max with which to build a merging network, so this is a scalar loop, but
+// one in which the compiler can use conditional moves instead of branching
+// on every comparison.
+template <typename T, typename O>
+in_in_out_result<const T*, const T*, O>
+simd_set_union(const T* first1, const T* last1, const T* first2,
+               const T* last2, O out)
+{
+    const std::ptrdiff_t n1 = last1 - first1;
+    const std::ptrdiff_t n2 = last2 - first2;
+    std::ptrdiff_t i = 0;
+    std::ptrdiff_t j = 0;
+    while (i < n1 && j < n2) {
+        const T a = first1[i];
+        const T b = first2[j];
+        *out = b < a ? b : a;
+        ++out;
+        i += (a <= b);
+        j += (b <= a);
+    }
+    return {first1 + i, first2 + j, std::move(out)};
+}
+
+// If rng is a sized, contiguous range and Candidate holds, returns
+// kernel(ptr, n) for a pointer to its n elements, going via data() as we
+// can't tell that e.g. vector::iterator is contiguous. Otherwise, and during
+// constant evaluation, returns fallback().
+template <bool Candidate, typename Rng, typename Kernel, typename Fallback>
+constexpr auto simd_range_dispatch(Rng& rng, [[maybe_unused]] Kernel kernel,
+                                   Fallback fallback)
+{
+    if constexpr (Candidate && contiguous_range<Rng> && sized_range<Rng>) {
+        if (!detail::is_constant_evaluated()) {
+            return kernel(nano::data(rng), nano::distance(rng));
+        }
+    }
+    return fallback();
+}
+
+// As above, for a pair of ranges, calling kernel(ptr1, n1, ptr2, n2)
+template <bool Candidate, typename Rng1, typename Rng2, typename Kernel,
+          typename Fallback>
+constexpr auto simd_range_dispatch(Rng1& rng1, Rng2& rng2,
+                                   [[maybe_unused]] Kernel kernel,
+                                   Fallback fallback)
+{
+    if constexpr (Candidate && contiguous_range<Rng1> && sized_range<Rng1> &&
+                  contiguous_range<Rng2> && sized_range<Rng2>) {
+        if (!detail::is_constant_evaluated()) {
+            return kernel(nano::data(rng1), nano::distance(rng1),
+                          nano::data(rng2), nano::distance(rng2));
+        }
+    }
+    return fallback();
+}
+
+// If the set kernels apply to [first1, last1) and [first2, last2), calls
+// kernel(first1, last1, first2, last2, result) on pointers to them, and
+// advances first1, first2 and result past the prefix it has dealt with
+template <typename Comp, typename Proj1, typename Proj2, typename I1,
+          typename S1, typename I2, typename S2, typename O, typename Kernel>
+constexpr void simd_set_prefix([[maybe_unused]] I1& first1,
+                               [[maybe_unused]] const S1& last1,
+                               [[maybe_unused]] I2& first2,
+                               [[maybe_unused]] const S2& last2,
+                               [[maybe_unused]] O& result,
+                               [[maybe_unused]] Kernel kernel)
+{
+    if constexpr (is_simd_set_candidate<I1, S1, I2, S2, Comp, Proj1, Proj2>) {
+        const auto n1 = last1 - first1;
+        const auto n2 = last2 - first2;
+        if (!detail::is_constant_evaluated() && n1 > 0 && n2 > 0 &&
+            detail::simd_set_is_balanced(n1, n2)) {
+            const auto p1 = detail::to_address(first1);
+            const auto p2 = detail::to_address(first2);
+            auto res = kernel(p1, p1 + n1, p2, p2 + n2, std::move(result));
+            first1 += res.in1 - p1;
+            first2 += res.in2 - p2;
+            result = std::move(res.out);
+        }
+    }
+}
+
+// Maps the input positions in the result of a set algorithm run on the
+// pointers p1 and p2 back to the iterators first1 and first2
+template <typename O, typename P1, typename I1, typename P2, typename I2>
+constexpr O simd_set_rebase(O out, P1, I1, P2, I2)
+{
+    return out;
+}
+
+template <typename O, typename P1, typename I1, typename P2, typename I2>
+constexpr in_out_result<I1, O>
+simd_set_rebase(in_out_result<P1, O> res, P1 p1, I1 first1, P2, I2)
+{
+    return {std::move(first1) + (res.in - p1), std::move(res.out)};
+}
+
+template <typename O, typename P1, typename I1, typename P2, typename I2>
+constexpr in_in_out_result<I1, I2, O>
+simd_set_rebase(in_in_out_result<P1, P2, O> res, P1 p1, I1 first1, P2 p2,
+                I2 first2)
+{
+    return {std::move(first1) + (res.in1 - p1),
+            std::move(first2) + (res.in2 - p2), std::move(res.out)};
+}
+
+// Calls f(first1, last1, first2, last2) on the elements of rng1 and rng2.
+// Where the set kernels could apply, we pass pointers as simd_range_dispatch()
+// does, and map the result back.
+template <typename Comp, typename Proj1, typename Proj2, typename Rng1,
+          typename Rng2, typename F>
+constexpr auto simd_set_dispatch(Rng1& rng1, Rng2& rng2, F f)
+{
+    if constexpr (contiguous_range<Rng1> && sized_range<Rng1> &&
+                  contiguous_range<Rng2> && sized_range<Rng2> &&
+                  is_simd_set_candidate<range_pointer_t<Rng1>,
+                                        range_pointer_t<Rng1>,
+                                        range_pointer_t<Rng2>,
+                                        range_pointer_t<Rng2>, Comp, Proj1,
+                                        Proj2>) {
+        const auto p1 = nano::data(rng1);
+        const auto p2 = nano::data(rng2);
+        return detail::simd_set_rebase(
+            f(p1, p1 + nano::distance(rng1), p2, p2 + nano::distance(rng2)),
+            p1, nano::begin(rng1), p2, nano::begin(rng2));
+    } else {
+        return f(nano::begin(rng1), nano::end(rng1), nano::begin(rng2),
+                 nano::end(rng2));
+    }
+}
+
+// Returns whether the n-element sequences beginning at first1 and first2 are
+// equal
+template <typename T>
+bool simd_equal(const T* first1, const T* first2, std::ptrdiff_t n)
+{
+    return n == 0 || std::memcmp(first1, first2,
+                                 static_cast<std::size_t>(n) * sizeof(T)) == 0;
+}
+
+} // namespace detail
+
+NANO_END_NAMESPACE
+
+#endif
@@ -0,0 +1,390 @@
+// nanorange/detail/algorithm/sorting_network.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Sorting networks for 2 to 16 elements. Each is a fixed sequence of
+// compare-exchange operations, so for arithmetic values compared in their
+// natural order the whole sort compiles to straight-line code with
+// conditional moves, and no branches to mispredict. The networks are those
+// with the fewest comparators known (optimal for up to 12 elements), as
+// listed by Bert Dobbelaere, "SorterHunter"
+// (https://bertdobbelaere.github.io/sorting_networks.html); the network for
+// 15 elements is the one for 16 with its last input removed. Each row is one
+// layer of independent comparators.
+
+#ifndef NANORANGE_DETAIL_ALGORITHM_SORTING_NETWORK_HPP_INCLUDED
+#define NANORANGE_DETAIL_ALGORITHM_SORTING_NETWORK_HPP_INCLUDED
+
+#include <nanorange/detail/algorithm/radix_sort.hpp>
+#include <nanorange/detail/algorithm/simd.hpp>
+#include <nanorange/ranges.hpp>
+
+#include <cstddef>
+#include <utility>
+
+NANO_BEGIN_NAMESPACE
+
+namespace detail {
+
+// The largest number of elements for which we have a network
+constexpr std::ptrdiff_t sorting_network_max = 16;
+
+// The comparators of the network for N elements, as pairs of positions
+template <std::size_t N>
+struct sorting_network_pairs;
+
+template <>
+struct sorting_network_pairs<2> {
+    static constexpr unsigned char value[][2] = {
+        {0, 1},
+    };
+};
+
+template <>
+struct sorting_network_pairs<3> {
+    static constexpr unsigned char value[][2] = {
+        {0, 2},
+        {0, 1},
+        {1, 2},
+    };
+};
+
+template <>
+struct sorting_network_pairs<4> {
+    static constexpr unsigned char value[][2] = {
+        {0, 2}, {1, 3},
+        {0, 1}, {2, 3},
+        {1, 2},
+    };
+};
+
+template <>
+struct sorting_network_pairs<5> {
+    static constexpr unsigned char value[][2] = {
+        {0, 3}, {1, 4},
+        {0, 2}, {1, 3},
+        {0, 1}, {2, 4},
+        {1, 2}, {3, 4},
+        {2, 3},
+    };
+};
+
+template <>
+struct sorting_network_pairs<6> {
+    static constexpr unsigned char value[][2] = {
+        {0, 5}, {1, 3}, {2, 4},
+        {1, 2}, {3, 4},
+        {0, 3}, {2, 5},
+        {0, 1}, {2, 3}, {4, 5},
+        {1, 2}, {3, 4},
+    };
+};
+
+template <>
+struct sorting_network_pairs<7> {
+    static constexpr unsigned char value[][2] = {
+        {0, 6}, {2, 3}, {4, 5},
+        {0, 2}, {1, 4}, {3, 6},
+        {0, 1}, {2, 5}, {3, 4},
+        {1, 2}, {4, 6},
+        {2, 3}, {4, 5},
+        {1, 2}, {3, 4}, {5, 6},
+    };
+};
+
+template <>
+struct sorting_network_pairs<8> {
+    static constexpr unsigned char value[][2] = {
+        {0, 2}, {1, 3}, {4, 6}, {5, 7},
+        {0, 4}, {1, 5}, {2, 6}, {3, 7},
+        {0, 1}, {2, 3}, {4, 5}, {6, 7},
+        {2, 4}, {3, 5},
+        {1, 4}, {3, 6},
+        {1, 2}, {3, 4}, {5, 6},
+    };
+};
+
+template <>
+struct sorting_network_pairs<9> {
+    static constexpr unsigned char value[][2] = {
+        {0, 3}, {1, 7}, {2, 5}, {4, 8},
+        {0, 7}, {2, 4}, {3, 8}, {5, 6},
+        {0, 2}, {1, 3}, {4, 5}, {7, 8},
+        {1, 4}, {3, 6}, {5, 7},
+        {0, 1}, {2, 4}, {3, 5}, {6, 8},
+        {2, 3}, {4, 5}, {6, 7},
+        {1, 2}, {3, 4}, {5, 6},
+    };
+};
+
+template <>
+struct sorting_network_pairs<10> {
+    static constexpr unsigned char value[][2] = {
+        {0, 8}, {1, 9}, {2, 7}, {3, 5}, {4, 6},
+        {0, 2}, {1, 4}, {5, 8}, {7, 9},
+        {0, 3}, {2, 4}, {5, 7}, {6, 9},
+        {0, 1}, {3, 6}, {8, 9},
+        {1, 5}, {2, 3}, {4, 8}, {6, 7},
+        {1, 2}, {3, 5}, {4, 6}, {7, 8},
+        {2, 3}, {4, 5}, {6, 7},
+        {3, 4}, {5, 6},
+    };
+};
+
+template <>
+struct sorting_network_pairs<11> {
+    static constexpr unsigned char value[][2] = {
+        {0, 9}, {1, 6}, {2, 4}, {3, 7}, {5, 8},
+        {0, 1}, {3, 5}, {4, 10}, {6, 9}, {7, 8},
+        {1, 3}, {2, 5}, {4, 7}, {8, 10},
+        {0, 4}, {1, 2}, {3, 7}, {5, 9}, {6, 8},
+        {0, 1}, {2, 6}, {4, 5}, {7, 8}, {9, 10},
+        {2, 4}, {3, 6}, {5, 7}, {8, 9},
+        {1, 2}, {3, 4}, {5, 6}, {7, 8},
+        {2, 3}, {4, 5}, {6, 7},
+    };
+};
+
+template <>
+struct sorting_network_pairs<12> {
+    static constexpr unsigned char value[][2] = {
+        {0, 8}, {1, 7}, {2, 6}, {3, 11}, {4, 10}, {5, 9},
+        {0, 1}, {2, 5}, {3, 4}, {6, 9}, {7, 8}, {10, 11},
+        {0, 2}, {1, 6}, {5, 10}, {9, 11},
+        {0, 3}, {1, 2}, {4, 6}, {5, 7}, {8, 11}, {9, 10},
+        {1, 4}, {3, 5}, {6, 8}, {7, 10},
+        {1, 3}, {2, 5}, {6, 9}, {8, 10},
+        {2, 3}, {4, 5}, {6, 7}, {8, 9},
+        {4, 6}, {5, 7},
+        {3, 4}, {5, 6}, {7, 8},
+    };
+};
+
+template <>
+struct sorting_network_pairs<13> {
+    static constexpr unsigned char value[][2] = {
+        {0, 12}, {1, 10}, {2, 9}, {3, 7}, {5, 11}, {6, 8},
+        {1, 6}, {2, 3}, {4, 11}, {7, 9}, {8, 10},
+        {0, 4}, {1, 2}, {3, 6}, {7, 8}, {9, 10}, {11, 12},
+        {4, 6}, {5, 9}, {8, 11}, {10, 12},
+        {0, 5}, {3, 8}, {4, 7}, {6, 11}, {9, 10},
+        {0, 1}, {2, 5}, {6, 9}, {7, 8}, {10, 11},
+        {1, 3}, {2, 4}, {5, 6}, {9, 10},
+        {1, 2}, {3, 4}, {5, 7}, {6, 8},
+        {2, 3}, {4, 5}, {6, 7}, {8, 9},
+        {3, 4}, {5, 6},
+    };
+};
+
+template <>
+struct sorting_network_pairs<14> {
+    static constexpr unsigned char value[][2] = {
+        {0, 1}, {2, 3}, {4, 5}, {6, 7}, {8, 9}, {10, 11}, {12, 13},
+        {0, 2}, {1, 3}, {4, 8}, {5, 9}, {10, 12}, {11, 13},
+        {0, 4}, {1, 2}, {3, 7}, {5, 8}, {6, 10}, {9, 13}, {11, 12},
+        {0, 6}, {1, 5}, {3, 9}, {4, 10}, {7, 13}, {8, 12},
+        {2, 10}, {3, 11}, {4, 6}, {7, 9},
+        {1, 3}, {2, 8}, {5, 11}, {6, 7}, {10, 12},
+        {1, 4}, {2, 6}, {3, 5}, {7, 11}, {8, 10}, {9, 12},
+        {2, 4}, {3, 6}, {5, 8}, {7, 10}, {9, 11},
+        {3, 4}, {5, 6}, {7, 8}, {9, 10},
+        {6, 7},
+    };
+};
+
+template <>
+struct sorting_network_pairs<15> {
+    static constexpr unsigned char value[][2] = {
+        {0, 13}, {1, 12}, {3, 14}, {4, 8}, {5, 6}, {7, 11}, {9, 10},
+        {0, 5}, {1, 7}, {2, 9}, {3, 4}, {6, 13}, {8, 14}, {11, 12},
+        {0, 1}, {2, 3}, {4, 5}, {6, 8}, {7, 9}, {10, 11}, {12, 13},
+        {0, 2}, {1, 3}, {4, 10}, {5, 11}, {6, 7}, {8, 9}, {12, 14},
+        {1, 2}, {3, 12}, {4, 6}, {5, 7}, {8, 10}, {9, 11}, {13, 14},
+        {1, 4}, {2, 6}, {5, 8}, {7, 10}, {9, 13}, {11, 14},
+        {2, 4}, {3, 6}, {9, 12}, {11, 13},
+        {3, 5}, {6, 8}, {7, 9}, {10, 12},
+        {3, 4}, {5, 6}, {7, 8}, {9, 10}, {11, 12},
+        {6, 7}, {8, 9},
+    };
+};
+
+template <>
+struct sorting_network_pairs<16> {
+    static constexpr unsigned char value[][2] = {
+        {0, 13}, {1, 12}, {2, 15}, {3, 14}, {4, 8}, {5, 6}, {7, 11}, {9, 10},
+        {0, 5}, {1, 7}, {2, 9}, {3, 4}, {6, 13}, {8, 14}, {10, 15}, {11, 12},
+        {0, 1}, {2, 3}, {4, 5}, {6, 8}, {7, 9}, {10, 11}, {12, 13}, {14, 15},
+        {0, 2}, {1, 3}, {4, 10}, {5, 11}, {6, 7}, {8, 9}, {12, 14}, {13, 15},
+        {1, 2}, {3, 12}, {4, 6}, {5, 7}, {8, 10}, {9, 11}, {13, 14},
+        {1, 4}, {2, 6}, {5, 8}, {7, 10}, {9, 13}, {11, 14},
+        {2, 4}, {3, 6}, {9, 12}, {11, 13},
+        {3, 5}, {6, 8}, {7, 9}, {10, 12},
+        {3, 4}, {5, 6}, {7, 8}, {9, 10}, {11, 12},
+        {6, 7}, {8, 9},
+    };
+};
+
+// Compilers tend to turn a compare-exchange of floating point values back
+// into a branch, so we use the SSE2 min and max instructions directly. These
+// return their second operand when the first is not less (or greater) than
+// it, which gives exactly the same results as the comparisons below, NaNs
+// and signed zeros included.
+template <typename T, typename Comp>
+inline constexpr bool is_simd_network_candidate =
+    NANO_HAS_SSE2 &&
+    (std::is_same<T, float>::value || std::is_same<T, double>::value) &&
+    radix_direction<std::remove_const_t<Comp>, T> != 0;
+
+#if NANO_HAS_SSE2
+template <int Direction>
+inline void simd_network_exchange(float& x, float& y)
+{
+    const __m128 a = _mm_set_ss(x);
+    const __m128 b = _mm_set_ss(y);
+    if constexpr (Direction > 0) {
+        x = _mm_cvtss_f32(_mm_min_ss(b, a));
+        y = _mm_cvtss_f32(_mm_max_ss(a, b));
+    } else {
+        x = _mm_cvtss_f32(_mm_max_ss(b, a));
+        y = _mm_cvtss_f32(_mm_min_ss(a, b));
+    }
+}
+
+template <int Direction>
+inline void simd_network_exchange(double& x, double& y)
+{
+    const __m128d a = _mm_set_sd(x);
+    const __m128d b = _mm_set_sd(y);
+    if constexpr (Direction > 0) {
+        x = _mm_cvtsd_f64(_mm_min_sd(b, a));
+        y = _mm_cvtsd_f64(_mm_max_sd(a, b));
+    } else {
+        x = _mm_cvtsd_f64(_mm_max_sd(b, a));
+        y = _mm_cvtsd_f64(_mm_min_sd(a, b));
+    }
+}
+#endif
+
+// Puts *a and *b in order. With Branchless, both results are selected
+// unconditionally, which lets the compiler use conditional moves. Each
+// selection is written out with its own comparison, as that is the form the
+// compiler recognises.
+template <bool Branchless, typename I, typename Comp, typename Proj>
+constexpr void sorting_network_exchange(I a, I b, Comp& comp, Proj& proj)
+{
+    if constexpr (Branchless) {
+        using T = iter_value_t<I>;
+        T x = *a;
+        T y = *b;
+#if NANO_HAS_SSE2
+        if constexpr (is_simd_network_candidate<T, Comp>) {
+            if (!detail::is_constant_evaluated()) {
+                detail::simd_network_exchange<
+                    radix_direction<std::remove_const_t<Comp>, T>>(x, y);
+                *a = x;
+                *b = y;
+                return;
+            }
+        }
+#endif
+        *a = nano::invoke(comp, y, x) ? y : x;
+        *b = nano::invoke(comp, y, x) ? x : y;
+    } else {
+        if (nano::invoke(comp, nano::invoke(proj, *b),
+                         nano::invoke(proj, *a))) {
+            nano::iter_swap(a, b);
+        }
+    }
+}
+
+template <bool Branchless, std::size_t N, typename I, typename Comp,
+          typename Proj, std::size_t... Is>
+constexpr void sorting_network_apply(I first, Comp& comp, Proj& proj,
+                                     std::index_sequence<Is...>)
+{
+    using pairs = sorting_network_pairs<N>;
+    (detail::sorting_network_exchange<Branchless>(
+         first + pairs::value[Is][0], first + pairs::value[Is][1], comp, proj),
+     ...);
+}
+
+// Sorts the N elements beginning at first, for N <= sorting_network_max.
+// Branchless may only be set for arithmetic values with the identity
+// projection.
+template <bool Branchless, std::size_t N, typename I, typename Comp,
+          typename Proj>
+constexpr void sorting_network(I first, Comp& comp, Proj& proj)
+{
+    static_assert(N <= sorting_network_max);
+    if constexpr (N >= 2) {
+        using pairs = sorting_network_pairs<N>;
+        detail::sorting_network_apply<Branchless, N>(
+            std::move(first), comp, proj,
+            std::make_index_sequence<sizeof(pairs::value) /
+                                     sizeof(pairs::value[0])>{});
+    }
+}
+
+// As above, choosing the network for n elements at run time
+template <bool Branchless, typename I, typename Comp, typename Proj>
+constexpr void sorting_network(I first, iter_difference_t<I> n, Comp& comp,
+                               Proj& proj)
+{
+    switch (n) {
+    case 2:
+        detail::sorting_network<Branchless, 2>(std::move(first), comp, proj);
+        break;
+    case 3:
+        detail::sorting_network<Branchless, 3>(std::move(first), comp, proj);
+        break;
+    case 4:
+        detail::sorting_network<Branchless, 4>(std::move(first), comp, proj);
+        break;
+    case 5:
+        detail::sorting_network<Branchless, 5>(std::move(first), comp, proj);
+        break;
+    case 6:
+        detail::sorting_network<Branchless, 6>(std::move(first), comp, proj);
+        break;
+    case 7:
+        detail::sorting_network<Branchless, 7>(std::move(first), comp, proj);
+        break;
+    case 8:
+        detail::sorting_network<Branchless, 8>(std::move(first), comp, proj);
+        break;
+    case 9:
+        detail::sorting_network<Branchless, 9>(std::move(first), comp, proj);
+        break;
+    case 10:
+        detail::sorting_network<Branchless, 10>(std::move(first), comp, proj);
+        break;
+    case 11:
+        detail::sorting_network<Branchless, 11>(std::move(first), comp, proj);
+        break;
+    case 12:
+        detail::sorting_network<Branchless, 12>(std::move(first), comp, proj);
+        break;
+    case 13:
+        detail::sorting_network<Branchless, 13>(std::move(first), comp, proj);
+        break;
+    case 14:
+        detail::sorting_network<Branchless, 14>(std::move(first), comp, proj);
+        break;
+    case 15:
+        detail::sorting_network<Branchless, 15>(std::move(first), comp, proj);
+        break;
+    case 16:
+        detail::sorting_network<Branchless, 16>(std::move(first), comp, proj);
+        break;
+    default:
+        break;
+    }
+}
+
+} // namespace detail
+
+NANO_END_NAMESPACE
+
+#endif
@@ -0,0 +1,245 @@
+// nanorange/detail/algorithm/two_way_search.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// The Two-Way string matching algorithm of Crochemore and Perrin, as described
+// in "Two-way string-matching", Journal of the ACM 38(3):651-675, 1991. The
+// structure follows the implementation in glibc's str-two-way.h.
+
+#ifndef NANORANGE_DETAIL_ALGORITHM_TWO_WAY_SEARCH_HPP_INCLUDED
+#define NANORANGE_DETAIL_ALGORITHM_TWO_WAY_SEARCH_HPP_INCLUDED
+
+#include <nanorange/algorithm/find.hpp>
+#include <nanorange/views/subrange.hpp>
+
+#include <functional>
+
+NANO_BEGIN_NAMESPACE
+
+namespace detail {
+
+// Needles shorter than this are searched for with the naive algorithm, which
+// is faster when it cannot go quadratic
+constexpr std::ptrdiff_t two_way_search_threshold = 8;
+
+template <typename Pred>
+inline constexpr bool is_equal_to_pred =
+    same_as<Pred, ranges::equal_to> || same_as<Pred, std::equal_to<>>;
+
+template <typename I2, typename Proj2, bool = readable<projected<I2, Proj2>>>
+inline constexpr bool is_ordered_needle = false;
+
+template <typename I2, typename Proj2>
+inline constexpr bool is_ordered_needle<I2, Proj2, true> =
+    totally_ordered<iter_value_t<projected<I2, Proj2>>>;
+
+// Two-Way needs random access to both sequences and their lengths, an
+// equality predicate, and (to factorise the needle) a total order which is
+// consistent with that equality
+template <typename I1, typename S1, typename I2, typename S2, typename Pred,
+          typename Proj2>
+inline constexpr bool is_two_way_candidate =
+    random_access_iterator<I1> && sized_sentinel_for<S1, I1> &&
+    random_access_iterator<I2> && sized_sentinel_for<S2, I2> &&
+    is_equal_to_pred<Pred> && is_ordered_needle<I2, Proj2>;
+
+// Returns the starting position of the maximal suffix of the needle [first,
+// first + m) with respect to the given order, and sets period to the period
+// of that suffix
+template <typename I, typename Less, typename Proj>
+constexpr iter_difference_t<I> two_way_maximal_suffix(I first,
+                                                      iter_difference_t<I> m,
+                                                      Less less, Proj& proj,
+                                                      iter_difference_t<I>& period)
+{
+    iter_difference_t<I> max_suffix = -1;
+    iter_difference_t<I> j = 0;
+    iter_difference_t<I> k = 1;
+    iter_difference_t<I> p = 1;
+
+    while (j + k < m) {
+        auto&& a = nano::invoke(proj, first[j + k]);
+        auto&& b = nano::invoke(proj, first[max_suffix + k]);
+        if (less(a, b)) {
+            // Suffix is smaller, period is the entire prefix so far
+            j += k;
+            k = 1;
+            p = j - max_suffix;
+        } else if (less(b, a)) {
+            // Suffix is larger, start over from the current location
+            max_suffix = j++;
+            k = p = 1;
+        } else if (k != p) {
+            // Advance through the repetition of the current period
+            ++k;
+        } else {
+            // Done with the current repetition of the period
+            j += p;
+            k = 1;
+        }
+    }
+
+    period = p;
+    return max_suffix + 1;
+}
+
+// Returns the position of a critical factorization of the needle, and sets
+// period to the period of its right half
+template <typename I, typename Proj>
+constexpr iter_difference_t<I>
+two_way_critical_factorization(I first, iter_difference_t<I> m, Proj& proj,
+                               iter_difference_t<I>& period)
+{
+    // The later of the maximal suffixes for an order and its reverse gives a
+    // critical factorization
+    iter_difference_t<I> period_rev = 0;
+    const auto suffix =
+        detail::two_way_maximal_suffix(first, m, nano::less{}, proj, period);
+    const auto suffix_rev = detail::two_way_maximal_suffix(
+        first, m, nano::greater{}, proj, period_rev);
+
+    if (suffix_rev > suffix) {
+        period = period_rev;
+        return suffix_rev;
+    }
+    return suffix;
+}
+
+// Searches for [first2, first2 + m) in [first1, first1 + n), in O(n + m)
+// time and constant space. Requires 0 < m.
+template <typename I1, typename I2, typename Pred, typename Proj1,
+          typename Proj2>
+constexpr subrange<I1> two_way_search(I1 first1, iter_difference_t<I1> n,
+                                      I2 first2, iter_difference_t<I2> m,
+                                      Pred& pred, Proj1& proj1, Proj2& proj2)
+{
+    using diff_t = iter_difference_t<I1>;
+
+    if (n < m) {
+        return {first1 + n, first1 + n};
+    }
+
+    const auto eq = [&](diff_t i, diff_t j) {
+        return nano::invoke(pred, nano::invoke(proj1, first1[j + i]),
+                            nano::invoke(proj2, first2[i]));
+    };
+
+    iter_difference_t<I2> period = 0;
+    const diff_t suffix =
+        detail::two_way_critical_factorization(first2, m, proj2, period);
+
+    // Whether the needle's left half is a repetition of its period
+    bool periodic = true;
+    for (diff_t i = 0; i < suffix; ++i) {
+        if (!nano::invoke(pred, nano::invoke(proj2, first2[i]),
+                          nano::invoke(proj2, first2[i + period]))) {
+            periodic = false;
+            break;
+        }
+    }
+
+    // Most attempts fail on the first comparison, so look for the first
+    // element of the right half with find(), which is much faster than the
+    // main loop and may be vectorised
+    auto&& key = nano::invoke(proj2, first2[suffix]);
+    const I1 key_last = first1 + (n - m + suffix + 1);
+    const auto skip_to_key = [&](diff_t j) {
+        if (j > n - m) {
+            return j;
+        }
+        I1 it = first1 + (j + suffix);
+        if constexpr (same_as<iter_value_t<projected<I1, Proj1>>,
+                              remove_cvref_t<decltype(key)>>) {
+            it = nano::find(std::move(it), key_last, key, proj1);
+        } else {
+            // Leave mixed-type comparisons to the predicate
+            while (it != key_last &&
+                   !nano::invoke(pred, nano::invoke(proj1, *it), key)) {
+                ++it;
+            }
+        }
+        return (it - first1) - suffix;
+    };
+
+    diff_t j = 0;
+    if (periodic) {
+        // Entire needle is periodic; a mismatch in the left half can only
+        // advance by the period, so use memory to avoid rescanning known
+        // occurrences of the period.
+        diff_t memory = 0;
+        while (true) {
+            diff_t i = suffix;
+            if (memory == 0) {
+                j = skip_to_key(j);
+                if (j > n - m) {
+                    break;
+                }
+                ++i;
+            } else if (memory > i) {
+                i = memory;
+            }
+
+            // Scan for matches in the right half
+            while (i < m && eq(i, j)) {
+                ++i;
+            }
+            if (i < m) {
+                j += i - suffix + 1;
+                memory = 0;
+                continue;
+            }
+
+            // Scan for matches in the left half
+            i = suffix - 1;
+            while (memory < i + 1 && eq(i, j)) {
+                --i;
+            }
+            if (i < memory) {
+                return {first1 + j, first1 + (j + m)};
+            }
+            j += period;
+            memory = m - period;
+            if (j > n - m) {
+                break;
+            }
+        }
+    } else {
+        // The two halves of the needle are distinct; no extra memory is
+        // required, and any mismatch results in a maximal shift.
+        const diff_t shift = (suffix > m - suffix ? suffix : m - suffix) + 1;
+        while (true) {
+            j = skip_to_key(j);
+            if (j > n - m) {
+                break;
+            }
+
+            diff_t i = suffix + 1;
+            while (i < m && eq(i, j)) {
+                ++i;
+            }
+            if (i < m) {
+                j += i - suffix + 1;
+                continue;
+            }
+
+            i = suffix - 1;
+            while (i >= 0 && eq(i, j)) {
+                --i;
+            }
+            if (i < 0) {
+                return {first1 + j, first1 + (j + m)};
+            }
+            j += shift;
+        }
+    }
+
+    return {first1 + n, first1 + n};
+}
+
+} // namespace detail
+
+NANO_END_NAMESPACE
+
+#endif
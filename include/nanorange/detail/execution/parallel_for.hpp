@@ -0,0 +1,101 @@
+// nanorange/detail/execution/parallel_for.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_DETAIL_EXECUTION_PARALLEL_FOR_HPP_INCLUDED
+#define NANORANGE_DETAIL_EXECUTION_PARALLEL_FOR_HPP_INCLUDED
+
+#include <nanorange/detail/execution/task_pool.hpp>
+#include <nanorange/detail/functional/invoke.hpp>
+
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+NANO_BEGIN_NAMESPACE
+
+namespace detail {
+
+// The element-wise parallel algorithms hand out work in chunks of about this
+// many bytes of input, which fit comfortably in a core's private cache
+constexpr std::size_t parallel_chunk_bytes = 1 << 16;
+
+// ...but never fewer than this many elements, so that a task does enough work
+// to pay for its scheduling
+constexpr std::ptrdiff_t parallel_min_chunk_size = 1 << 10;
+
+template <typename T>
+constexpr std::ptrdiff_t parallel_chunk_size =
+    parallel_chunk_bytes / sizeof(T) > std::size_t(parallel_min_chunk_size)
+        ? std::ptrdiff_t(parallel_chunk_bytes / sizeof(T))
+        : parallel_min_chunk_size;
+
+// Whether it is worth splitting n elements into chunks of the given size
+inline bool use_parallel_chunks(std::ptrdiff_t n, std::ptrdiff_t chunk)
+{
+    return n > chunk && task_pool::instance().concurrency() > 1;
+}
+
+// Calls f(i) for each chunk index i in [first, last). The range is split in
+// half recursively, with the upper halves forked onto the pool, so that idle
+// threads steal large blocks of chunks rather than one chunk at a time.
+template <typename F>
+void parallel_for_chunk_indices(task_group& tasks, std::ptrdiff_t first,
+                                std::ptrdiff_t last, F& f)
+{
+    while (last - first > 1) {
+        const std::ptrdiff_t mid = first + (last - first) / 2;
+        tasks.run([&tasks, &f, mid, last] {
+            detail::parallel_for_chunk_indices(tasks, mid, last, f);
+        });
+        last = mid;
+    }
+    f(first);
+}
+
+// Calls f(begin, end) for consecutive subranges [begin, end) of [0, n), each
+// no longer than chunk, in parallel. Exceptions thrown by f are rethrown.
+template <typename F>
+void parallel_for_chunks(std::ptrdiff_t n, std::ptrdiff_t chunk, F f)
+{
+    const std::ptrdiff_t num_chunks = (n + chunk - 1) / chunk;
+    auto run_chunk = [&f, n, chunk](std::ptrdiff_t i) {
+        const std::ptrdiff_t begin = i * chunk;
+        f(begin, n - begin < chunk ? n : begin + chunk);
+    };
+
+    task_group tasks;
+    detail::parallel_for_chunk_indices(tasks, 0, num_chunks, run_chunk);
+    tasks.wait();
+}
+
+// Reduces [0, n) by calling f(begin, end), which must return the reduction
+// of a non-empty subrange as a T, for each chunk in parallel, and then folds
+// the partial results into init from left to right using op
+template <typename T, typename Op, typename F>
+T parallel_reduce_chunks(std::ptrdiff_t n, std::ptrdiff_t chunk, T init,
+                         Op& op, F f)
+{
+    const std::ptrdiff_t num_chunks = (n + chunk - 1) / chunk;
+    std::vector<std::optional<T>> partials(
+        static_cast<std::size_t>(num_chunks));
+
+    detail::parallel_for_chunks(
+        n, chunk, [&partials, &f, chunk](std::ptrdiff_t begin, std::ptrdiff_t end) {
+            partials[static_cast<std::size_t>(begin / chunk)].emplace(
+                f(begin, end));
+        });
+
+    for (auto& p : partials) {
+        init = nano::invoke(op, std::move(init), std::move(*p));
+    }
+    return init;
+}
+
+} // namespace detail
+
+NANO_END_NAMESPACE
+
+#endif
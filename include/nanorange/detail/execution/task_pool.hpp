@@ -0,0 +1,260 @@
+// nanorange/detail/execution/task_pool.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_DETAIL_EXECUTION_TASK_POOL_HPP_INCLUDED
+#define NANORANGE_DETAIL_EXECUTION_TASK_POOL_HPP_INCLUDED
+
+#include <nanorange/detail/macros.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+NANO_BEGIN_NAMESPACE
+
+namespace detail {
+
+// A work-stealing thread pool used by the parallel algorithms.
+//
+// Each worker thread owns a task queue. Workers push and pop at the back of
+// their own queue (so the most recently forked, and most cache-friendly, work
+// runs first) and steal from the front of the other queues when their own
+// queue is empty. Queue 0 is shared by all threads which are not part of the
+// pool. Threads waiting on a task_group run queued tasks rather than blocking,
+// so nested fork-join parallelism cannot deadlock.
+class task_pool {
+public:
+    using task = std::function<void()>;
+
+    static task_pool& instance() { return *holder(); }
+
+    // Replaces the pool with one which has the given number of worker
+    // threads, or the default number if workers is -1. This lets the tests
+    // run the parallel algorithms with real concurrency on any machine. No
+    // tasks may be running.
+    static void set_worker_count(std::ptrdiff_t workers)
+    {
+        auto& pool = holder();
+        pool.reset();
+        pool.reset(new task_pool(workers < 0 ? default_thread_count()
+                                             : std::size_t(workers) + 1));
+    }
+
+    task_pool(const task_pool&) = delete;
+    task_pool& operator=(const task_pool&) = delete;
+
+    ~task_pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex_);
+            done_ = true;
+        }
+        wake_.notify_all();
+        for (auto& t : threads_) {
+            t.join();
+        }
+    }
+
+    // The number of threads which may run tasks, including the caller
+    std::size_t concurrency() const { return threads_.size() + 1; }
+
+    void submit(task t)
+    {
+        queue& q = queues_[this_thread_index()];
+        {
+            std::lock_guard<std::mutex> lock(q.mutex);
+            q.tasks.push_back(std::move(t));
+        }
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex_);
+            ++pending_;
+        }
+        wake_.notify_one();
+    }
+
+    // Runs a single queued task if one is available, returning whether it
+    // did so
+    bool try_run_one()
+    {
+        task t;
+        if (!try_pop(t)) {
+            return false;
+        }
+        t();
+        return true;
+    }
+
+private:
+    struct queue {
+        std::mutex mutex;
+        std::deque<task> tasks;
+    };
+
+    explicit task_pool(std::size_t threads) : queues_(threads)
+    {
+        threads_.reserve(queues_.size() - 1);
+        for (std::size_t i = 1; i < queues_.size(); ++i) {
+            threads_.emplace_back([this, i] { worker_loop(i); });
+        }
+    }
+
+    static std::unique_ptr<task_pool>& holder()
+    {
+        static std::unique_ptr<task_pool> pool(
+            new task_pool(default_thread_count()));
+        return pool;
+    }
+
+    static std::size_t default_thread_count()
+    {
+        const unsigned n = std::thread::hardware_concurrency();
+        return n > 0 ? n : 1;
+    }
+
+    static std::size_t& this_thread_index()
+    {
+        static thread_local std::size_t index = 0;
+        return index;
+    }
+
+    bool try_pop(task& t)
+    {
+        const std::size_t self = this_thread_index();
+        const std::size_t n = queues_.size();
+
+        for (std::size_t i = 0; i < n; ++i) {
+            queue& q = queues_[(self + i) % n];
+            std::lock_guard<std::mutex> lock(q.mutex);
+            if (q.tasks.empty()) {
+                continue;
+            }
+            if (i == 0) {
+                t = std::move(q.tasks.back());
+                q.tasks.pop_back();
+            } else {
+                t = std::move(q.tasks.front());
+                q.tasks.pop_front();
+            }
+            --pending_;
+            return true;
+        }
+
+        return false;
+    }
+
+    void worker_loop(std::size_t index)
+    {
+        this_thread_index() = index;
+
+        while (true) {
+            if (try_run_one()) {
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleep_mutex_);
+            wake_.wait(lock, [this] { return done_ || pending_ > 0; });
+            if (done_) {
+                return;
+            }
+        }
+    }
+
+    std::vector<queue> queues_;
+    std::vector<std::thread> threads_;
+    std::mutex sleep_mutex_;
+    std::condition_variable wake_;
+    // May briefly go negative if a task is stolen before it is counted
+    std::atomic<std::ptrdiff_t> pending_{0};
+    bool done_ = false;
+};
+
+// A set of tasks forked onto the pool, which may be joined with wait().
+// Tasks may themselves fork further tasks into the same group. The first
+// exception thrown by any task is rethrown from wait().
+class task_group {
+public:
+    task_group() = default;
+    task_group(const task_group&) = delete;
+    task_group& operator=(const task_group&) = delete;
+
+    ~task_group()
+    {
+        // Tasks may refer to the caller's stack frame, so we must not return
+        // while any are still running
+        while (count_ != 0) {
+            help_or_yield();
+        }
+    }
+
+    template <typename F>
+    void run(F f)
+    {
+        ++count_;
+        pool_.submit([this, f = std::move(f)]() mutable {
+            execute(f);
+            // This must be the last access to *this
+            --count_;
+        });
+    }
+
+    void wait()
+    {
+        while (count_ != 0) {
+            help_or_yield();
+        }
+#if NANO_HAS_EXCEPTIONS
+        if (error_) {
+            std::exception_ptr e = std::move(error_);
+            error_ = nullptr;
+            std::rethrow_exception(std::move(e));
+        }
+#endif
+    }
+
+private:
+    template <typename F>
+    void execute(F& f)
+    {
+#if NANO_HAS_EXCEPTIONS
+        try {
+            f();
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(error_mutex_);
+            if (!error_) {
+                error_ = std::current_exception();
+            }
+        }
+#else
+        f();
+#endif
+    }
+
+    void help_or_yield()
+    {
+        if (!pool_.try_run_one()) {
+            std::this_thread::yield();
+        }
+    }
+
+    task_pool& pool_ = task_pool::instance();
+    std::atomic<std::size_t> count_{0};
+#if NANO_HAS_EXCEPTIONS
+    std::mutex error_mutex_;
+    std::exception_ptr error_;
+#endif
+};
+
+} // namespace detail
+
+NANO_END_NAMESPACE
+
+#endif
@@ -65,4 +65,25 @@ inline namespace ranges                                                        \
 #define NANO_MSVC_LAMBDA_PIPE_WORKAROUND 1
 #endif
 
+#if defined(__has_builtin)
+#if __has_builtin(__builtin_is_constant_evaluated)
+#define NANO_HAS_IS_CONSTANT_EVALUATED 1
+#endif
+#endif
+
+#ifndef NANO_HAS_IS_CONSTANT_EVALUATED
+#if (defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 9) ||             \
+    (defined(_MSC_VER) && _MSC_VER >= 1925)
+#define NANO_HAS_IS_CONSTANT_EVALUATED 1
+#else
+#define NANO_HAS_IS_CONSTANT_EVALUATED 0
+#endif
+#endif
+
+#if defined(__cpp_exceptions) || defined(_CPPUNWIND)
+#define NANO_HAS_EXCEPTIONS 1
+#else
+#define NANO_HAS_EXCEPTIONS 0
+#endif
+
 #endif
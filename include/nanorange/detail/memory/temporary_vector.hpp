@@ -14,22 +14,80 @@
 #include <memory>
 #include <new>
 
+#if defined(__has_include)
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#endif
+#endif
+
+#if defined(__cpp_lib_memory_resource) && !defined(NANORANGE_NO_MEMORY_RESOURCE)
+#define NANO_HAS_MEMORY_RESOURCE 1
+#else
+#define NANO_HAS_MEMORY_RESOURCE 0
+#endif
+
 NANO_BEGIN_NAMESPACE
 
 namespace detail {
 
+// Where algorithms which take an optional memory resource get their scratch
+// space from. A null pointer means the global operator new.
+#if NANO_HAS_MEMORY_RESOURCE
+using temporary_resource = std::pmr::memory_resource;
+#else
+struct temporary_resource;
+#endif
+
 template <typename T>
 struct temporary_vector {
 private:
     struct deleter {
-        void operator()(T* ptr) const { ::operator delete[](ptr); }
+        temporary_resource* resource = nullptr;
+        std::size_t capacity = 0;
+
+        void operator()(T* ptr) const
+        {
+#if NANO_HAS_MEMORY_RESOURCE
+            if (resource) {
+                resource->deallocate(ptr, capacity * sizeof(T), alignof(T));
+                return;
+            }
+#endif
+            ::operator delete[](ptr);
+        }
     };
 
+    // Like the global nothrow new, returns null rather than throwing if the
+    // memory is not available
+    static T* allocate(std::size_t capacity, temporary_resource* resource)
+    {
+#if NANO_HAS_MEMORY_RESOURCE
+        if (resource) {
+            if (capacity == 0) {
+                return nullptr;
+            }
+#if NANO_HAS_EXCEPTIONS
+            try {
+                return static_cast<T*>(
+                    resource->allocate(capacity * sizeof(T), alignof(T)));
+            } catch (const std::bad_alloc&) {
+                return nullptr;
+            }
+#else
+            return static_cast<T*>(
+                resource->allocate(capacity * sizeof(T), alignof(T)));
+#endif
+        }
+#endif
+        return static_cast<T*>(::operator new[](capacity * sizeof(T), std::nothrow));
+    }
+
 public:
     temporary_vector() = default;
 
-    explicit temporary_vector(std::size_t capacity)
-        : start_(static_cast<T*>(::operator new[](capacity * sizeof(T), std::nothrow))),
+    explicit temporary_vector(std::size_t capacity,
+                              temporary_resource* resource = nullptr)
+        : start_(allocate(capacity, resource), deleter{resource, capacity}),
           end_cap_(start_ ? start_.get() + capacity : nullptr)
     {}
 
@@ -77,6 +77,23 @@ template <>
 struct priority_tag<0> {
 };
 
+// Types which can be used directly as an index into a 256-entry table
+template <typename T>
+inline constexpr bool is_byte_like =
+    sizeof(T) == 1 && (std::is_integral<T>::value || std::is_enum<T>::value);
+
+// Returns true when called during constant evaluation. If the compiler gives
+// us no way to tell, we always return true: callers use this to guard
+// optimisations which are only valid at run time.
+constexpr bool is_constant_evaluated() noexcept
+{
+#if NANO_HAS_IS_CONSTANT_EVALUATED
+    return __builtin_is_constant_evaluated();
+#else
+    return true;
+#endif
+}
+
 } // namespace detail
 
 NANO_END_NAMESPACE
@@ -0,0 +1,57 @@
+// nanorange/execution.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_EXECUTION_HPP_INCLUDED
+#define NANORANGE_EXECUTION_HPP_INCLUDED
+
+#include <nanorange/detail/type_traits.hpp>
+
+NANO_BEGIN_NAMESPACE
+
+// [execpol]
+// We provide our own policy types rather than using those from <execution>,
+// as some standard libraries refuse to compile that header without TBB
+
+namespace execution {
+
+struct sequenced_policy {};
+struct parallel_policy {};
+struct parallel_unsequenced_policy {};
+
+inline constexpr sequenced_policy seq{};
+inline constexpr parallel_policy par{};
+inline constexpr parallel_unsequenced_policy par_unseq{};
+
+} // namespace execution
+
+template <typename T>
+struct is_execution_policy : std::false_type {};
+
+template <>
+struct is_execution_policy<execution::sequenced_policy> : std::true_type {};
+
+template <>
+struct is_execution_policy<execution::parallel_policy> : std::true_type {};
+
+template <>
+struct is_execution_policy<execution::parallel_unsequenced_policy>
+    : std::true_type {};
+
+template <typename T>
+inline constexpr bool is_execution_policy_v = is_execution_policy<T>::value;
+
+namespace detail {
+
+template <typename EP>
+inline constexpr bool is_parallel_policy_v =
+    is_execution_policy_v<remove_cvref_t<EP>> &&
+    !std::is_same<remove_cvref_t<EP>, execution::sequenced_policy>::value;
+
+} // namespace detail
+
+NANO_END_NAMESPACE
+
+#endif
@@ -0,0 +1,106 @@
+// nanorange/memory/scratch_arena.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_MEMORY_SCRATCH_ARENA_HPP_INCLUDED
+#define NANORANGE_MEMORY_SCRATCH_ARENA_HPP_INCLUDED
+
+#include <nanorange/detail/memory/temporary_vector.hpp>
+
+#include <cassert>
+#include <cstddef>
+
+#if NANO_HAS_MEMORY_RESOURCE
+
+NANO_BEGIN_NAMESPACE
+
+// Extension: a memory resource which holds on to a single block of memory
+// and hands it out again and again, so that repeated calls to algorithms
+// such as stable_sort() only go to the upstream resource when they need more
+// space than they did before. While the block is in use, further requests
+// are passed on to the upstream resource. Not thread-safe.
+class scratch_arena : public std::pmr::memory_resource {
+public:
+    explicit scratch_arena(
+        std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+        : upstream_(upstream)
+    {}
+
+    explicit scratch_arena(
+        std::size_t initial_size,
+        std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+        : upstream_(upstream)
+    {
+        if (initial_size > 0) {
+            block_ = upstream_->allocate(initial_size, block_align);
+            size_ = initial_size;
+        }
+    }
+
+    scratch_arena(const scratch_arena&) = delete;
+    scratch_arena& operator=(const scratch_arena&) = delete;
+
+    ~scratch_arena() override { release(); }
+
+    // Returns the block to the upstream resource. The block must not be in
+    // use.
+    void release()
+    {
+        assert(!in_use_);
+        if (block_) {
+            upstream_->deallocate(block_, size_, block_align);
+            block_ = nullptr;
+            size_ = 0;
+        }
+    }
+
+    std::size_t capacity() const { return size_; }
+
+    std::pmr::memory_resource* upstream_resource() const { return upstream_; }
+
+private:
+    static constexpr std::size_t block_align = alignof(std::max_align_t);
+
+    void* do_allocate(std::size_t bytes, std::size_t align) override
+    {
+        if (in_use_ || align > block_align) {
+            return upstream_->allocate(bytes, align);
+        }
+
+        if (bytes > size_) {
+            release();
+            block_ = upstream_->allocate(bytes, block_align);
+            size_ = bytes;
+        }
+        in_use_ = true;
+        return block_;
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t align) override
+    {
+        if (p == block_) {
+            in_use_ = false;
+        } else {
+            upstream_->deallocate(p, bytes, align);
+        }
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const
+        noexcept override
+    {
+        return this == &other;
+    }
+
+    std::pmr::memory_resource* upstream_;
+    void* block_ = nullptr;
+    std::size_t size_ = 0;
+    bool in_use_ = false;
+};
+
+NANO_END_NAMESPACE
+
+#endif // NANO_HAS_MEMORY_RESOURCE
+
+#endif
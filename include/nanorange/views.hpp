@@ -19,6 +19,8 @@
 #include <nanorange/views/iota.hpp>
 #include <nanorange/views/istream.hpp>
 #include <nanorange/views/join.hpp>
+#include <nanorange/views/mapped_file.hpp>
+#include <nanorange/views/parse.hpp>
 #include <nanorange/views/ref.hpp>
 #include <nanorange/views/reverse.hpp>
 #include <nanorange/views/single.hpp>
@@ -0,0 +1,200 @@
+// nanorange/views/mapped_file.hpp
+//
+// Copyright (c) 2019 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_VIEWS_MAPPED_FILE_HPP_INCLUDED
+#define NANORANGE_VIEWS_MAPPED_FILE_HPP_INCLUDED
+
+#include <nanorange/views/interface.hpp>
+
+#include <cerrno>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#if defined(__has_include)
+#if __has_include(<sys/mman.h>) && __has_include(<sys/stat.h>) && \
+    __has_include(<fcntl.h>) && __has_include(<unistd.h>)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define NANO_HAS_MMAP 1
+#endif
+#endif
+
+#ifndef NANO_HAS_MMAP
+#define NANO_HAS_MMAP 0
+#endif
+
+#if NANO_HAS_MMAP
+
+NANO_BEGIN_NAMESPACE
+
+// Extension: memory-mapped files. A mapped_file owns a mapping of a whole
+// file, which is either read-only, or private and writable so that changes
+// are never written back to the file. A mapped_file_view<T> then presents the
+// mapping as a contiguous, borrowed range of T, without copying. As with
+// other borrowed ranges, the view (and its iterators) must not outlive the
+// mapped_file it refers to.
+
+enum class mapped_file_mode {
+    read_only,
+    copy_on_write
+};
+
+template <typename T>
+class mapped_file_view;
+
+class mapped_file {
+public:
+    mapped_file() = default;
+
+    // Throws std::system_error if the file cannot be opened or mapped
+    explicit mapped_file(const char* path,
+                         mapped_file_mode mode = mapped_file_mode::read_only)
+        : mode_(mode)
+    {
+        const int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            mapped_file::throw_error("open");
+        }
+
+        struct ::stat st {};
+        if (::fstat(fd, &st) != 0) {
+            mapped_file::close_and_throw(fd, "fstat");
+        }
+
+        // mmap() rejects empty mappings, so empty files are left unmapped
+        size_ = static_cast<std::size_t>(st.st_size);
+        if (size_ > 0) {
+            const bool writable = mode == mapped_file_mode::copy_on_write;
+            void* const addr =
+                ::mmap(nullptr, size_,
+                       writable ? PROT_READ | PROT_WRITE : PROT_READ,
+                       writable ? MAP_PRIVATE : MAP_SHARED, fd, 0);
+            if (addr == MAP_FAILED) {
+                mapped_file::close_and_throw(fd, "mmap");
+            }
+            data_ = static_cast<std::byte*>(addr);
+        }
+
+        // The mapping keeps its own reference to the file
+        ::close(fd);
+    }
+
+    explicit mapped_file(const std::string& path,
+                         mapped_file_mode mode = mapped_file_mode::read_only)
+        : mapped_file(path.c_str(), mode)
+    {}
+
+    mapped_file(mapped_file&& other) noexcept
+        : data_(std::exchange(other.data_, nullptr)),
+          size_(std::exchange(other.size_, 0)),
+          mode_(other.mode_)
+    {}
+
+    mapped_file& operator=(mapped_file&& other) noexcept
+    {
+        if (this != std::addressof(other)) {
+            unmap();
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+            mode_ = other.mode_;
+        }
+        return *this;
+    }
+
+    ~mapped_file() { unmap(); }
+
+    const std::byte* data() const noexcept { return data_; }
+
+    std::size_t size() const noexcept { return size_; }
+
+    mapped_file_mode mode() const noexcept { return mode_; }
+
+private:
+    template <typename T>
+    friend class mapped_file_view;
+
+    [[noreturn]] static void throw_error(const char* what)
+    {
+        throw std::system_error(errno, std::generic_category(),
+                                std::string("nano::mapped_file: ") + what);
+    }
+
+    [[noreturn]] static void close_and_throw(int fd, const char* what)
+    {
+        const int err = errno;
+        ::close(fd);
+        errno = err;
+        mapped_file::throw_error(what);
+    }
+
+    void unmap() noexcept
+    {
+        if (data_) {
+            ::munmap(data_, size_);
+        }
+    }
+
+    std::byte* data_ = nullptr;
+    std::size_t size_ = 0;
+    mapped_file_mode mode_ = mapped_file_mode::read_only;
+};
+
+template <typename T = const std::byte>
+class mapped_file_view : public view_interface<mapped_file_view<T>> {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "mapped_file_view requires a trivially copyable type");
+
+public:
+    mapped_file_view() = default;
+
+    // Views as many whole Ts as the file contains. A view of non-const T
+    // requires a copy-on-write mapping, and throws std::invalid_argument
+    // otherwise.
+    explicit mapped_file_view(mapped_file& file)
+        : data_(reinterpret_cast<T*>(file.data_)),
+          size_(static_cast<std::ptrdiff_t>(file.size_ / sizeof(T)))
+    {
+        if (!std::is_const<T>::value &&
+            file.mode() != mapped_file_mode::copy_on_write) {
+            throw std::invalid_argument(
+                "nano::mapped_file_view: a mutable view requires a "
+                "copy_on_write mapping");
+        }
+    }
+
+    template <typename U = T, std::enable_if_t<std::is_const<U>::value, int> = 0>
+    explicit mapped_file_view(const mapped_file& file)
+        : data_(reinterpret_cast<T*>(file.data_)),
+          size_(static_cast<std::ptrdiff_t>(file.size_ / sizeof(T)))
+    {}
+
+    // The view would immediately dangle
+    mapped_file_view(mapped_file&&) = delete;
+
+    constexpr T* begin() const noexcept { return data_; }
+    constexpr T* end() const noexcept { return data_ + size_; }
+    constexpr T* data() const noexcept { return data_; }
+    constexpr std::ptrdiff_t size() const noexcept { return size_; }
+
+private:
+    T* data_ = nullptr;
+    std::ptrdiff_t size_ = 0;
+};
+
+template <typename T>
+inline constexpr bool enable_borrowed_range<mapped_file_view<T>> = true;
+
+NANO_END_NAMESPACE
+
+#endif // NANO_HAS_MMAP
+
+#endif
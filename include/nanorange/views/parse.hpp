@@ -0,0 +1,369 @@
+// nanorange/views/parse.hpp
+//
+// Copyright (c) 2019 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_VIEWS_PARSE_HPP_INCLUDED
+#define NANORANGE_VIEWS_PARSE_HPP_INCLUDED
+
+#include <nanorange/detail/iterator/traits.hpp>
+#include <nanorange/iterator/default_sentinel.hpp>
+#include <nanorange/views/interface.hpp>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <istream>
+#include <streambuf>
+#include <vector>
+
+#if defined(__has_include)
+#if __has_include(<charconv>)
+#include <charconv>
+#define NANO_HAS_CHARCONV 1
+#endif
+#if __has_include(<unistd.h>)
+#include <unistd.h>
+#define NANO_HAS_POSIX_READ 1
+#endif
+#endif
+
+#ifndef NANO_HAS_CHARCONV
+#define NANO_HAS_CHARCONV 0
+#endif
+
+#ifndef NANO_HAS_POSIX_READ
+#define NANO_HAS_POSIX_READ 0
+#endif
+
+// Standard libraries only define this once from_chars() supports floating
+// point types
+#if defined(__cpp_lib_to_chars)
+#define NANO_HAS_FLOAT_FROM_CHARS 1
+#else
+#define NANO_HAS_FLOAT_FROM_CHARS 0
+#endif
+
+#if NANO_HAS_CHARCONV
+
+NANO_BEGIN_NAMESPACE
+
+// Extension: a view of the whitespace-separated numbers in a stream buffer or
+// (on POSIX systems) a file descriptor, parsed with from_chars(). The input is
+// read in large blocks, bypassing the stream's formatted input functions and
+// locale altogether. Iteration stops at the end of the input, or at the first
+// token which is not a valid Val, after which failed() returns true.
+//
+// Like basic_istream_view, this is a single-pass view. As it reads ahead,
+// the stream's read position is unspecified once iteration has begun.
+
+struct from_fd_t {
+    explicit from_fd_t() = default;
+};
+
+inline constexpr from_fd_t from_fd{};
+
+namespace detail {
+
+constexpr std::size_t parse_view_buffer_size = 1 << 16;
+
+// Numbers up to this long can be parsed without first finding the end of the
+// token
+constexpr std::size_t parse_view_lookahead = 128;
+
+template <typename T>
+NANO_CONCEPT parsable_number =
+    std::is_arithmetic<T>::value && !same_as<T, bool>;
+
+// The same characters as std::isspace() in the "C" locale
+constexpr bool is_parse_space(char c)
+{
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+struct parse_source {
+    std::streambuf* buf = nullptr;
+    int fd = -1;
+
+    // Reads up to n bytes into out, returning the number read (zero at the
+    // end of the input) or -1 on error
+    std::ptrdiff_t read(char* out, std::size_t n) const
+    {
+        if (buf) {
+            return static_cast<std::ptrdiff_t>(
+                buf->sgetn(out, static_cast<std::streamsize>(n)));
+        }
+#if NANO_HAS_POSIX_READ
+        if (fd >= 0) {
+            while (true) {
+                const auto r = ::read(fd, out, n);
+                if (r >= 0 || errno != EINTR) {
+                    return static_cast<std::ptrdiff_t>(r);
+                }
+            }
+        }
+#endif
+        return 0;
+    }
+};
+
+// Parses a T from the start of [first, last), returning a pointer to the
+// first character not consumed, or null if there is no valid T there. Like
+// operator>>, accepts a leading plus sign. Requires *last to be '\0'.
+template <typename T>
+const char* parse_number(const char* first, const char* last, T& value)
+{
+    if (*first == '+' && last - first > 1 && first[1] != '-' &&
+        first[1] != '+') {
+        ++first;
+    }
+
+    if constexpr (std::is_integral<T>::value || NANO_HAS_FLOAT_FROM_CHARS) {
+        const auto res = std::from_chars(first, last, value);
+        return res.ec == std::errc{} ? res.ptr : nullptr;
+    } else {
+        // Fall back to strtod() and friends, which stop at the terminator
+        char* end = nullptr;
+        errno = 0;
+        if constexpr (same_as<T, float>) {
+            value = std::strtof(first, &end);
+        } else if constexpr (same_as<T, double>) {
+            value = std::strtod(first, &end);
+        } else {
+            value = std::strtold(first, &end);
+        }
+        return end != first && errno != ERANGE ? end : nullptr;
+    }
+}
+
+} // namespace detail
+
+template <typename Val>
+struct parse_view : view_interface<parse_view<Val>> {
+
+    static_assert(detail::parsable_number<Val>,
+                  "parse_view requires an integer or floating point type");
+
+    parse_view() = default;
+
+    explicit parse_view(std::streambuf& buf,
+                        std::size_t buffer_size = detail::parse_view_buffer_size)
+        : buffer_size_(buffer_size > 0 ? buffer_size : 1)
+    {
+        source_.buf = std::addressof(buf);
+    }
+
+    explicit parse_view(std::istream& stream,
+                        std::size_t buffer_size = detail::parse_view_buffer_size)
+        : buffer_size_(buffer_size > 0 ? buffer_size : 1)
+    {
+        source_.buf = stream.rdbuf();
+    }
+
+#if NANO_HAS_POSIX_READ
+    parse_view(from_fd_t, int fd,
+               std::size_t buffer_size = detail::parse_view_buffer_size)
+        : buffer_size_(buffer_size > 0 ? buffer_size : 1)
+    {
+        source_.fd = fd;
+    }
+#endif
+
+    auto begin()
+    {
+        if (buffer_.empty()) {
+            // One spare byte, so that the contents can always be
+            // null-terminated
+            buffer_.resize(buffer_size_ + 1);
+        }
+        read_next();
+        return iterator{*this};
+    }
+
+    default_sentinel_t end() const noexcept
+    {
+        return default_sentinel;
+    }
+
+    // Whether iteration stopped because of invalid input or a read error,
+    // rather than at the end of the input
+    bool failed() const noexcept
+    {
+        return failed_;
+    }
+
+private:
+    struct iterator {
+        using iterator_category = input_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = Val;
+
+        iterator() = default;
+
+        explicit iterator(parse_view& parent) noexcept
+            : parent_(std::addressof(parent))
+        {}
+
+        iterator& operator++()
+        {
+            parent_->read_next();
+            return *this;
+        }
+
+        void operator++(int)
+        {
+            ++*this;
+        }
+
+        Val& operator*() const { return parent_->value_; }
+
+        friend bool operator==(const iterator& x, default_sentinel_t)
+        {
+            return x.done();
+        }
+
+        friend bool operator==(default_sentinel_t s, const iterator& x)
+        {
+            return x == s;
+        }
+
+        friend bool operator!=(const iterator& x, default_sentinel_t s)
+        {
+            return !(x == s);
+        }
+
+        friend bool operator!=(default_sentinel_t s, const iterator& x)
+        {
+            return !(x == s);
+        }
+
+    private:
+        [[nodiscard]] bool done() const
+        {
+            return parent_ == nullptr || parent_->done_;
+        }
+
+        parse_view* parent_{};
+    };
+
+    // Appends as much input as will fit to the buffer, returning false at the
+    // end of the input
+    bool read_more()
+    {
+        if (eof_) {
+            return false;
+        }
+
+        const auto n = source_.read(buffer_.data() + end_,
+                                    buffer_.size() - 1 - end_);
+        if (n <= 0) {
+            eof_ = true;
+            failed_ = failed_ || n < 0;
+            return false;
+        }
+        end_ += static_cast<std::size_t>(n);
+        buffer_[end_] = '\0';
+        return true;
+    }
+
+    // Moves the unread part of the buffer to the front and reads some more,
+    // growing the buffer if it is already full
+    bool compact_and_read_more()
+    {
+        if (pos_ == 0 && end_ == buffer_.size() - 1) {
+            buffer_.resize(2 * buffer_.size() - 1);
+        } else if (pos_ != 0) {
+            std::memmove(buffer_.data(), buffer_.data() + pos_, end_ - pos_);
+            end_ -= pos_;
+            pos_ = 0;
+            buffer_[end_] = '\0';
+        }
+        return read_more();
+    }
+
+    void read_next()
+    {
+        done_ = true;
+        if (failed_) {
+            return;
+        }
+
+        // Skip leading whitespace
+        while (true) {
+            const char* const data = buffer_.data();
+            std::size_t pos = pos_;
+            while (pos != end_ && detail::is_parse_space(data[pos])) {
+                ++pos;
+            }
+            pos_ = pos;
+            if (pos_ != end_) {
+                break;
+            }
+            pos_ = end_ = 0;
+            if (!read_more()) {
+                return;
+            }
+        }
+
+        // Make sure that the buffer holds at least as much as the longest
+        // number we expect to see
+        if (end_ - pos_ < detail::parse_view_lookahead && !eof_) {
+            compact_and_read_more();
+        }
+
+        // Parse straight out of the buffer. If the number is followed by
+        // whitespace, we're done.
+        const char* const first = buffer_.data() + pos_;
+        const char* const last = buffer_.data() + end_;
+        const char* stop = detail::parse_number(first, last, value_);
+        if (stop != nullptr && stop != last && detail::is_parse_space(*stop)) {
+            pos_ = static_cast<std::size_t>(stop - buffer_.data());
+            done_ = false;
+            return;
+        }
+
+        // Otherwise, either the token is invalid or it might continue past the
+        // end of the buffer. Read until we find its end, and try again.
+        std::size_t tok_end = pos_;
+        while (true) {
+            const char* const data = buffer_.data();
+            while (tok_end != end_ && !detail::is_parse_space(data[tok_end])) {
+                ++tok_end;
+            }
+            if (tok_end != end_ || eof_) {
+                break;
+            }
+            const std::size_t offset = tok_end - pos_;
+            compact_and_read_more();
+            tok_end = pos_ + offset;
+        }
+
+        stop = detail::parse_number(buffer_.data() + pos_,
+                                    buffer_.data() + end_, value_);
+        if (stop != buffer_.data() + tok_end) {
+            failed_ = true;
+            return;
+        }
+
+        pos_ = tok_end;
+        done_ = false;
+    }
+
+    detail::parse_source source_{};
+    std::size_t buffer_size_ = detail::parse_view_buffer_size;
+    std::vector<char> buffer_{};
+    std::size_t pos_ = 0;
+    std::size_t end_ = 0;
+    bool eof_ = false;
+    bool done_ = true;
+    bool failed_ = false;
+    Val value_ = Val();
+};
+
+NANO_END_NAMESPACE
+
+#endif // NANO_HAS_CHARCONV
+
+#endif
@@ -138,6 +138,27 @@ inline namespace ranges                                                        \
 #define NANO_MSVC_LAMBDA_PIPE_WORKAROUND 1
 #endif
 
+#if defined(__has_builtin)
+#if __has_builtin(__builtin_is_constant_evaluated)
+#define NANO_HAS_IS_CONSTANT_EVALUATED 1
+#endif
+#endif
+
+#ifndef NANO_HAS_IS_CONSTANT_EVALUATED
+#if (defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 9) ||             \
+    (defined(_MSC_VER) && _MSC_VER >= 1925)
+#define NANO_HAS_IS_CONSTANT_EVALUATED 1
+#else
+#define NANO_HAS_IS_CONSTANT_EVALUATED 0
+#endif
+#endif
+
+#if defined(__cpp_exceptions) || defined(_CPPUNWIND)
+#define NANO_HAS_EXCEPTIONS 1
+#else
+#define NANO_HAS_EXCEPTIONS 0
+#endif
+
 #endif
 
 // nanorange/type_traits.hpp
@@ -238,6 +259,23 @@ template <>
 struct priority_tag<0> {
 };
 
+// Types which can be used directly as an index into a 256-entry table
+template <typename T>
+inline constexpr bool is_byte_like =
+    sizeof(T) == 1 && (std::is_integral<T>::value || std::is_enum<T>::value);
+
+// Returns true when called during constant evaluation. If the compiler gives
+// us no way to tell, we always return true: callers use this to guard
+// optimisations which are only valid at run time.
+constexpr bool is_constant_evaluated() noexcept
+{
+#if NANO_HAS_IS_CONSTANT_EVALUATED
+    return __builtin_is_constant_evaluated();
+#else
+    return true;
+#endif
+}
+
 } // namespace detail
 
 NANO_END_NAMESPACE
@@ -4485,331 +4523,198 @@ NANO_END_NAMESPACE
 #ifndef NANORANGE_ALGORITHM_PARTITION_POINT_HPP_INCLUDED
 #define NANORANGE_ALGORITHM_PARTITION_POINT_HPP_INCLUDED
 
+// nanorange/detail/algorithm/simd.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_DETAIL_ALGORITHM_SIMD_HPP_INCLUDED
+#define NANORANGE_DETAIL_ALGORITHM_SIMD_HPP_INCLUDED
+
+// nanorange/detail/algorithm/memmove.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
+#ifndef NANORANGE_DETAIL_ALGORITHM_MEMMOVE_HPP_INCLUDED
+#define NANORANGE_DETAIL_ALGORITHM_MEMMOVE_HPP_INCLUDED
+
+
+
+#include <cstring>
+#include <memory>
 
 NANO_BEGIN_NAMESPACE
 
 namespace detail {
 
-struct partition_point_fn {
-private:
-    friend struct lower_bound_fn;
-    friend struct upper_bound_fn;
+// Returns a raw pointer to the element referred to by a contiguous iterator.
+// Unless I is a pointer type, i must be dereferenceable.
+template <typename I>
+constexpr auto to_address(const I& i) noexcept
+{
+    if constexpr (std::is_pointer<I>::value) {
+        return i;
+    } else {
+        return std::addressof(*i);
+    }
+}
 
-    template <typename I, typename Pred, typename Proj>
-    static constexpr I impl_n(I first, iter_difference_t<I> n, Pred& pred,
-                              Proj& proj)
-    {
-        while (n != 0) {
-            const auto half = n/2;
+template <typename From, typename To>
+inline constexpr bool is_memmove_assignable =
+    std::is_same<remove_cvref_t<From>, remove_cvref_t<To>>::value &&
+    std::is_trivially_copyable<remove_cvref_t<To>>::value &&
+    std::is_trivially_assignable<To, From>::value &&
+    !std::is_volatile<std::remove_reference_t<From>>::value &&
+    !std::is_volatile<std::remove_reference_t<To>>::value;
+
+template <typename Rng>
+using range_pointer_t = std::add_pointer_t<range_reference_t<Rng>>;
+
+// Standard library iterators don't carry our contiguous_iterator_tag, so we
+// also recognise the wrappers which libstdc++ and libc++ use for the
+// iterators of std::vector and std::basic_string. (std::array's iterators are
+// plain pointers in both.) With other standard libraries, only the range
+// overloads of copy() and move(), which go via data(), can use memmove() on
+// these containers.
+template <typename I>
+inline constexpr bool is_std_contiguous_iterator = false;
 
-            auto middle = nano::next(first, half);
+#if defined(__GLIBCXX__)
+template <typename T, typename C>
+inline constexpr bool
+    is_std_contiguous_iterator<__gnu_cxx::__normal_iterator<T*, C>> = true;
+#endif
 
-            if (nano::invoke(pred, nano::invoke(proj, *middle))) {
-                first = std::move(++middle);
-                n -= half + 1;
-            } else {
-                n = half;
-            }
-        }
+#if defined(_LIBCPP_VERSION)
+template <typename T>
+inline constexpr bool is_std_contiguous_iterator<std::__wrap_iter<T*>> = true;
+#endif
 
-        return first;
-    }
+template <typename I>
+inline constexpr bool is_memmove_iterator =
+    contiguous_iterator<I> || is_std_contiguous_iterator<I>;
 
-    template <typename I, typename S, typename Pred, typename Proj>
-    static constexpr std::enable_if_t<sized_sentinel_for<S, I>, I>
-    impl(I first, S last, Pred& pred, Proj& proj)
-    {
-        const auto n = nano::distance(first, std::move(last));
-        return partition_point_fn::impl_n(std::move(first), n, pred, proj);
-    }
+// Whether *o = *i may be performed by memmove()
+template <typename I, typename O,
+          bool = is_memmove_iterator<I> && is_memmove_iterator<O>>
+inline constexpr bool is_memmove_copyable = false;
 
-    template <typename I, typename S, typename Pred, typename Proj>
-    static constexpr std::enable_if_t<!sized_sentinel_for<S, I>, I>
-    impl(I first, S last, Pred& pred, Proj& proj)
-    {
-        // Probe exponentially for either end-of-range or an iterator
-        // that is past the partition point (i.e., does not satisfy pred).
-        iter_difference_t<I> n{1};
+template <typename I, typename O>
+inline constexpr bool is_memmove_copyable<I, O, true> =
+    is_memmove_assignable<iter_reference_t<I>, iter_reference_t<O>>;
 
-        while (true) {
-            auto m = first;
-            auto d = nano::advance(m, n, last);
-            if (m == last || !nano::invoke(pred, nano::invoke(proj, *m))) {
-                n -= d;
-                return partition_point_fn::impl_n(std::move(first), n,
-                                                  pred, proj);
-            }
-            first = std::move(m);
-            n *= 2;
-        }
-    }
+// Whether *o = iter_move(i) may be performed by memmove()
+template <typename I, typename O,
+          bool = is_memmove_iterator<I> && is_memmove_iterator<O>>
+inline constexpr bool is_memmove_movable = false;
 
-public:
-    template <typename I, typename S, typename Pred, typename Proj = identity>
-    std::enable_if_t<forward_iterator<I> && sentinel_for<S, I> &&
-                         indirect_unary_predicate<Pred, projected<I, Proj>>, I>
-    constexpr operator()(I first, S last, Pred pred, Proj proj = Proj{}) const
-    {
-        return partition_point_fn::impl(std::move(first), std::move(last),
-                                        pred, proj);
-    }
+template <typename I, typename O>
+inline constexpr bool is_memmove_movable<I, O, true> =
+    is_memmove_assignable<iter_rvalue_reference_t<I>, iter_reference_t<O>>;
 
-    template <typename Rng, typename Pred, typename Proj = identity>
-    std::enable_if_t<
-        forward_range<Rng> &&
-            indirect_unary_predicate<Pred, projected<iterator_t<Rng>, Proj>>,
-        borrowed_iterator_t<Rng>>
-    constexpr operator()(Rng&& rng, Pred pred, Proj proj = Proj{}) const
-    {
-        return partition_point_fn::impl(nano::begin(rng), nano::end(rng),
-                                        pred, proj);
-    }
-};
+// Copies the n elements beginning at first to the range beginning at result,
+// which may overlap. Returns result + n. Requires n > 0.
+template <typename I, typename O>
+O memmove_n(I first, iter_difference_t<I> n, O result)
+{
+    std::memmove(detail::to_address(result), detail::to_address(first),
+                 static_cast<std::size_t>(n) * sizeof(iter_value_t<I>));
+    return result + n;
+}
 
+// Copies the n elements ending at last to the range ending at result, which
+// may overlap. Returns result - n. Requires n > 0.
+template <typename I, typename O>
+O memmove_backward_n(I last, iter_difference_t<I> n, O result)
+{
+    result -= n;
+    last -= n;
+    std::memmove(detail::to_address(result), detail::to_address(last),
+                 static_cast<std::size_t>(n) * sizeof(iter_value_t<I>));
+    return result;
 }
 
-NANO_INLINE_VAR(detail::partition_point_fn, partition_point)
+} // namespace detail
 
 NANO_END_NAMESPACE
 
 #endif
 
+// nanorange/detail/algorithm/result_types.hpp
+//
+// Copyright (c) 2020 Boris Staletic (boris dot staletic at gmail dot com)
+// Copyright (c) 2020 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
-NANO_BEGIN_NAMESPACE
+#ifndef NANORANGE_DETAIL_ALGORITHM_RETURN_TYPES
+#define NANORANGE_DETAIL_ALGORITHM_RETURN_TYPES
 
-namespace detail {
 
-struct lower_bound_fn {
-private:
-    friend struct binary_search_fn;
-    friend struct equal_range_fn;
 
-    template <typename Comp, typename T>
-    struct compare {
-        Comp& comp;
-        const T& val;
 
-        template <typename U>
-        constexpr bool operator()(U&& u) const
-        {
-            return nano::invoke(comp, std::forward<U>(u), val);
-        }
-    };
+#include <type_traits>
 
+NANO_BEGIN_NAMESPACE
 
-    template <typename I, typename S, typename T, typename Comp, typename Proj>
-    static constexpr I impl(I first, S last, const T& value, Comp& comp, Proj& proj)
-    {
-        const auto comparator = compare<Comp, T>{comp, value};
-        return partition_point_fn::impl(std::move(first), std::move(last),
-                                        comparator, proj);
-    }
+template <typename I, typename F>
+struct in_fun_result {
+    NANO_NO_UNIQUE_ADDRESS I in;
+    NANO_NO_UNIQUE_ADDRESS F fun;
 
-public:
-    template <typename I, typename S, typename T, typename Comp = ranges::less,
-              typename Proj = identity>
-    std::enable_if_t<
-        forward_iterator<I> && sentinel_for<S, I> &&
-            indirect_strict_weak_order<Comp, const T*, projected<I, Proj>>,
-        I>
-    constexpr operator()(I first, S last, const T& value, Comp comp = Comp{},
-                         Proj proj = Proj{}) const
+    template <typename I2, typename F2,
+              std::enable_if_t<convertible_to<const I&, I2> &&
+                               convertible_to<const F&, F2>, int> = 0>
+    constexpr operator in_fun_result<I2, F2>() const &
     {
-        return lower_bound_fn::impl(std::move(first), std::move(last),
-                                    value, comp, proj);
+        return {in, fun};
     }
 
-    template <typename Rng, typename T, typename Comp = ranges::less,
-              typename Proj = identity>
-    std::enable_if_t<forward_range<Rng> &&
-                         indirect_strict_weak_order<Comp, const T*, projected<iterator_t<Rng>, Proj>>,
-                     borrowed_iterator_t<Rng>>
-    constexpr operator()(Rng&& rng, const T& value, Comp comp = Comp{},
-                         Proj proj = Proj{}) const
+    template <typename I2, typename F2,
+        std::enable_if_t<convertible_to<I, I2> &&
+                         convertible_to<F, F2>, int> = 0>
+    constexpr operator in_fun_result<I2, F2>() &&
     {
-        return lower_bound_fn::impl(nano::begin(rng), nano::end(rng),
-                                    value, comp, proj);
+        return {std::move(in), std::move(fun)};
     }
 };
 
-}
-
-NANO_INLINE_VAR(detail::lower_bound_fn, lower_bound)
-
-NANO_END_NAMESPACE
-
-#endif
-
-
-NANO_BEGIN_NAMESPACE
-
-namespace detail {
+template <typename I1, typename I2>
+struct in_in_result {
+    NANO_NO_UNIQUE_ADDRESS I1 in1;
+    NANO_NO_UNIQUE_ADDRESS I2 in2;
 
-struct binary_search_fn {
-private:
-    template <typename I, typename S, typename T, typename Comp, typename Proj>
-    static constexpr bool impl(I first, S last, const T& value, Comp& comp,
-                               Proj& proj)
+    template <typename II1, typename II2,
+        std::enable_if_t<convertible_to<const I1&, II1> &&
+                         convertible_to<const I2&, II2>, int> = 0>
+    constexpr operator in_in_result<II1, II2>() const &
     {
-        first = lower_bound_fn::impl(std::move(first), last, value, comp, proj);
-        return (first != last && !nano::invoke(comp, value, nano::invoke(proj, *first)));
+        return {in1, in2};
     }
 
-public:
-    template <typename I, typename S, typename T, typename Comp = ranges::less,
-              typename Proj = identity>
-    std::enable_if_t<
-        forward_iterator<I> && sentinel_for<S, I> &&
-            indirect_strict_weak_order<Comp, const T*, projected<I, Proj>>,
-    bool>
-    constexpr operator()(I first, S last, const T& value, Comp comp = Comp{},
-               Proj proj = Proj{}) const
+    template <typename II1, typename II2,
+        std::enable_if_t<convertible_to<I1, II1> &&
+                         convertible_to<I2, II2>, int> = 0>
+    constexpr operator in_in_result<II1, II2>() &&
     {
-        return binary_search_fn::impl(std::move(first), std::move(last),
-                                      value, comp, proj);
+        return {std::move(in1), std::move(in2)};
     }
+};
 
-    template <typename Rng, typename T, typename Comp = ranges::less,
-              typename Proj = identity>
-    std::enable_if_t<forward_range<Rng> &&
-                         indirect_strict_weak_order<Comp, const T*, projected<iterator_t<Rng>, Proj>>,
-    bool>
-    constexpr operator()(Rng&& rng, const T& value, Comp comp = Comp{},
-                         Proj proj = Proj{}) const
+template <typename I, typename O>
+struct in_out_result {
+    NANO_NO_UNIQUE_ADDRESS I in;
+    NANO_NO_UNIQUE_ADDRESS O out;
+
+    template <typename I2, typename O2,
+              std::enable_if_t<convertible_to<const I&, I2> &&
+                               convertible_to<const O&, O2>, int> = 0>
+    constexpr operator in_out_result<I2, O2>() const &
     {
-        return binary_search_fn::impl(nano::begin(rng), nano::end(rng),
-                                      value, comp, proj);
-    }
-};
-
-}
-
-NANO_INLINE_VAR(detail::binary_search_fn, binary_search)
-
-NANO_END_NAMESPACE
-
-#endif
-
-// nanorange/algorithm/clamp.hpp
-//
-// Copyright (c) 2020 Boris Staletic (boris dot staletic at gmail dot com)
-// Distributed under the Boost Software License, Version 1.0. (See accompanying
-// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
-
-#ifndef NANORANGE_ALGORITHM_CLAMP_HPP_INCLUDED
-#define NANORANGE_ALGORITHM_CLAMP_HPP_INCLUDED
-
-
-
-NANO_BEGIN_NAMESPACE
-
-namespace detail {
-
-struct clamp_fn {
-    template <typename T, typename Proj = identity, typename Comp = nano::less>
-    constexpr std::enable_if_t<indirect_strict_weak_order<Comp, projected<const T*, Proj>>, const T&>
-    operator()(const T& value, const T& low, const T& high, Comp comp = {}, Proj proj = Proj{}) const
-    {
-        auto&& projected_value = nano::invoke(proj, value);
-        if (nano::invoke(comp, projected_value, nano::invoke(proj, low))) {
-            return low;
-        } else if (nano::invoke(comp, nano::invoke(proj, high), projected_value)) {
-            return high;
-        } else {
-            return value;
-        }
-    }
-};
-} // namespace detail
-
-NANO_INLINE_VAR(detail::clamp_fn, clamp)
-
-NANO_END_NAMESPACE
-
-#endif
-
-// nanorange/algorithm/copy.hpp
-//
-// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
-// Distributed under the Boost Software License, Version 1.0. (See accompanying
-// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
-
-#ifndef NANORANGE_ALGORITHM_COPY_HPP_INCLUDED
-#define NANORANGE_ALGORITHM_COPY_HPP_INCLUDED
-
-// nanorange/detail/algorithm/result_types.hpp
-//
-// Copyright (c) 2020 Boris Staletic (boris dot staletic at gmail dot com)
-// Copyright (c) 2020 Tristan Brindle (tcbrindle at gmail dot com)
-// Distributed under the Boost Software License, Version 1.0. (See accompanying
-// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
-
-#ifndef NANORANGE_DETAIL_ALGORITHM_RETURN_TYPES
-#define NANORANGE_DETAIL_ALGORITHM_RETURN_TYPES
-
-
-
-
-#include <type_traits>
-
-NANO_BEGIN_NAMESPACE
-
-template <typename I, typename F>
-struct in_fun_result {
-    NANO_NO_UNIQUE_ADDRESS I in;
-    NANO_NO_UNIQUE_ADDRESS F fun;
-
-    template <typename I2, typename F2,
-              std::enable_if_t<convertible_to<const I&, I2> &&
-                               convertible_to<const F&, F2>, int> = 0>
-    constexpr operator in_fun_result<I2, F2>() const &
-    {
-        return {in, fun};
-    }
-
-    template <typename I2, typename F2,
-        std::enable_if_t<convertible_to<I, I2> &&
-                         convertible_to<F, F2>, int> = 0>
-    constexpr operator in_fun_result<I2, F2>() &&
-    {
-        return {std::move(in), std::move(fun)};
-    }
-};
-
-template <typename I1, typename I2>
-struct in_in_result {
-    NANO_NO_UNIQUE_ADDRESS I1 in1;
-    NANO_NO_UNIQUE_ADDRESS I2 in2;
-
-    template <typename II1, typename II2,
-        std::enable_if_t<convertible_to<const I1&, II1> &&
-                         convertible_to<const I2&, II2>, int> = 0>
-    constexpr operator in_in_result<II1, II2>() const &
-    {
-        return {in1, in2};
-    }
-
-    template <typename II1, typename II2,
-        std::enable_if_t<convertible_to<I1, II1> &&
-                         convertible_to<I2, II2>, int> = 0>
-    constexpr operator in_in_result<II1, II2>() &&
-    {
-        return {std::move(in1), std::move(in2)};
-    }
-};
-
-template <typename I, typename O>
-struct in_out_result {
-    NANO_NO_UNIQUE_ADDRESS I in;
-    NANO_NO_UNIQUE_ADDRESS O out;
-
-    template <typename I2, typename O2,
-              std::enable_if_t<convertible_to<const I&, I2> &&
-                               convertible_to<const O&, O2>, int> = 0>
-    constexpr operator in_out_result<I2, O2>() const &
-    {
-        return {in, out};
+        return {in, out};
     }
 
     template <typename I2, typename O2,
@@ -4913,2774 +4818,3202 @@ NANO_END_NAMESPACE
 
 
 
-NANO_BEGIN_NAMESPACE
 
-template <typename I, typename O>
-using copy_result = in_out_result<I, O>;
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Vectorised kernels are selected at compile time. SSE2 is part of the x86-64
+// baseline; AVX2 is used when the compiler is allowed to emit it (e.g. with
+// -mavx2 or /arch:AVX2). Define NANORANGE_NO_SIMD to disable both.
+#if !defined(NANORANGE_NO_SIMD) && defined(__AVX2__)
+#define NANO_HAS_AVX2 1
+#else
+#define NANO_HAS_AVX2 0
+#endif
+
+#if !defined(NANORANGE_NO_SIMD) &&                                             \
+    (defined(__SSE2__) || defined(_M_X64) ||                                   \
+     (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define NANO_HAS_SSE2 1
+#else
+#define NANO_HAS_SSE2 0
+#endif
+
+// SSSE3 adds a byte shuffle, which we use as a 16-entry table lookup
+#if NANO_HAS_SSE2 && (NANO_HAS_AVX2 || defined(__SSSE3__))
+#define NANO_HAS_SIMD_SHUFFLE 1
+#else
+#define NANO_HAS_SIMD_SHUFFLE 0
+#endif
+
+#if NANO_HAS_AVX2
+#include <immintrin.h>
+#elif NANO_HAS_SIMD_SHUFFLE
+#include <tmmintrin.h>
+#elif NANO_HAS_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+NANO_BEGIN_NAMESPACE
 
 namespace detail {
 
-struct copy_fn {
-private:
-    // If we know the distance between first and last, we can use that
-    // information to (potentially) allow better codegen
-    template <typename I, typename S, typename O>
-    static constexpr std::enable_if_t<sized_sentinel_for<S, I>, copy_result<I, O>>
-    impl(I first, S last, O result, priority_tag<1>)
-    {
-        const auto dist = last - first;
+// Types for which == is a bitwise comparison, and which we know how to scan
+template <typename T>
+inline constexpr bool is_simd_scannable =
+    (std::is_integral<T>::value || std::is_same<T, std::byte>::value) &&
+    (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8);
 
-        for (iter_difference_t<I> i = 0; i < dist; ++i) {
-            *result = *first;
-            ++first;
-            ++result;
-        }
+template <typename I, bool = contiguous_iterator<I>>
+inline constexpr bool is_simd_iterator = false;
 
-        return {std::move(first), std::move(result)};
+template <typename I>
+inline constexpr bool is_simd_iterator<I, true> =
+    is_simd_scannable<iter_value_t<I>> &&
+    !std::is_volatile<std::remove_reference_t<iter_reference_t<I>>>::value;
+
+// Whether find(first, last, value, proj) and count(...) may use the kernels
+// below. Values of other integral types are converted to the element type
+// first; see simd_narrow().
+template <typename I, typename T, typename Proj>
+inline constexpr bool is_simd_find_candidate =
+    is_simd_iterator<I> && std::is_same<Proj, identity>::value &&
+    (std::is_integral<T>::value ||
+     std::is_same<T, remove_cvref_t<iter_reference_t<I>>>::value);
+
+// Whether mismatch() and equal() may compare the two sequences bytewise
+template <typename I1, typename I2, typename Pred, typename Proj1,
+          typename Proj2>
+inline constexpr bool is_simd_mismatch_candidate =
+    is_simd_iterator<I1> && is_simd_iterator<I2> &&
+    std::is_same<iter_value_t<I1>, iter_value_t<I2>>::value &&
+    std::is_same<Pred, ranges::equal_to>::value &&
+    std::is_same<Proj1, identity>::value &&
+    std::is_same<Proj2, identity>::value;
+
+// Whether set_intersection(), set_difference() and set_union() may use the
+// kernels for sorted sequences of integers below
+template <typename I1, typename S1, typename I2, typename S2, typename Comp,
+          typename Proj1, typename Proj2>
+inline constexpr bool is_simd_set_candidate =
+    is_simd_iterator<I1> && sized_sentinel_for<S1, I1> &&
+    is_simd_iterator<I2> && sized_sentinel_for<S2, I2> &&
+    std::is_same<iter_value_t<I1>, iter_value_t<I2>>::value &&
+    std::is_integral<iter_value_t<I1>>::value &&
+    (sizeof(iter_value_t<I1>) == 4 || sizeof(iter_value_t<I1>) == 8) &&
+    std::is_same<Comp, ranges::less>::value &&
+    std::is_same<Proj1, identity>::value &&
+    std::is_same<Proj2, identity>::value;
+
+// Converts value to T for comparison against elements of type T. Returns
+// false if no element of type T could compare equal to value.
+template <typename T, typename U>
+bool simd_narrow(const U& value, T& out)
+{
+    out = static_cast<T>(value);
+    if constexpr (std::is_same<T, U>::value) {
+        return true;
+    } else {
+        return static_cast<U>(out) == value;
     }
+}
 
-    template <typename I, typename S, typename O>
-    static constexpr copy_result<I, O> impl(I first, S last, O result,
-                                            priority_tag<0>)
-    {
-        while (first != last) {
-            *result = *first;
-            ++first;
-            ++result;
-        }
+inline int simd_ctz(std::uint32_t mask)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long idx;
+    _BitScanForward(&idx, mask);
+    return static_cast<int>(idx);
+#else
+    return __builtin_ctz(mask);
+#endif
+}
 
-        return {std::move(first), std::move(result)};
-    }
+// Returns the index of the highest set bit. Requires mask != 0.
+inline int simd_highest_bit(std::uint32_t mask)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long idx;
+    _BitScanReverse(&idx, mask);
+    return static_cast<int>(idx);
+#else
+    return 31 - __builtin_clz(mask);
+#endif
+}
 
-public:
-    template <typename I, typename S, typename O>
-    constexpr std::enable_if_t<input_iterator<I> && sentinel_for<S, I> &&
-                                   weakly_incrementable<O> &&
-                                   indirectly_copyable<I, O>,
-                               copy_result<I, O>>
-    operator()(I first, S last, O result) const
+// Hints that the cache line containing p will be read soon
+inline void simd_prefetch(const void* p)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+#if defined(_M_IX86) || defined(_M_X64)
+    _mm_prefetch(static_cast<const char*>(p), _MM_HINT_T0);
+#else
+    (void) p;
+#endif
+#else
+    __builtin_prefetch(p);
+#endif
+}
+
+#if NANO_HAS_AVX2 || NANO_HAS_SSE2
+
+// A thin wrapper around the widest available integer vector register. All
+// comparisons produce a mask with one bit per byte, so a matching element of
+// size N sets N consecutive bits.
+struct simd_vec {
+#if NANO_HAS_AVX2
+    using type = __m256i;
+    static constexpr std::ptrdiff_t bytes = 32;
+
+    static type load(const void* p)
     {
-        return copy_fn::impl(std::move(first), std::move(last),
-                             std::move(result), priority_tag<1>{});
+        return _mm256_loadu_si256(static_cast<const __m256i*>(p));
     }
 
-    template <typename Rng, typename O>
-    constexpr std::enable_if_t<input_range<Rng> && weakly_incrementable<O> &&
-                                   indirectly_copyable<iterator_t<Rng>, O>,
-                               copy_result<borrowed_iterator_t<Rng>, O>>
-    operator()(Rng&& rng, O result) const
+    static std::uint32_t movemask(type v)
     {
-        return copy_fn::impl(nano::begin(rng), nano::end(rng),
-                             std::move(result), priority_tag<1>{});
+        return static_cast<std::uint32_t>(_mm256_movemask_epi8(v));
     }
-};
-
-} // namespace detail
-
-NANO_INLINE_VAR(detail::copy_fn, copy)
-
-template <typename I, typename O>
-using copy_n_result = in_out_result<I, O>;
 
-namespace detail {
+    template <typename T>
+    static type splat(T value)
+    {
+        if constexpr (sizeof(T) == 1) {
+            std::int8_t i;
+            std::memcpy(&i, &value, 1);
+            return _mm256_set1_epi8(i);
+        } else if constexpr (sizeof(T) == 2) {
+            std::int16_t i;
+            std::memcpy(&i, &value, 2);
+            return _mm256_set1_epi16(i);
+        } else if constexpr (sizeof(T) == 4) {
+            std::int32_t i;
+            std::memcpy(&i, &value, 4);
+            return _mm256_set1_epi32(i);
+        } else {
+            long long i;
+            std::memcpy(&i, &value, 8);
+            return _mm256_set1_epi64x(i);
+        }
+    }
 
-struct copy_n_fn {
-    template <typename I, typename O>
-    constexpr std::enable_if_t<input_iterator<I> && weakly_incrementable<O> &&
-                                   indirectly_copyable<I, O>,
-                               copy_n_result<I, O>>
-    operator()(I first, iter_difference_t<I> n, O result) const
+    template <std::size_t N>
+    static type eq(type a, type b)
     {
-        for (iter_difference_t<I> i{}; i < n; i++) {
-            *result = *first;
-            ++first;
-            ++result;
+        if constexpr (N == 1) {
+            return _mm256_cmpeq_epi8(a, b);
+        } else if constexpr (N == 2) {
+            return _mm256_cmpeq_epi16(a, b);
+        } else if constexpr (N == 4) {
+            return _mm256_cmpeq_epi32(a, b);
+        } else {
+            return _mm256_cmpeq_epi64(a, b);
         }
-
-        return {std::move(first), std::move(result)};
     }
-};
 
-} // namespace detail
+    static type zero() { return _mm256_setzero_si256(); }
 
-NANO_INLINE_VAR(detail::copy_n_fn, copy_n)
+    static type sub_bytes(type a, type b) { return _mm256_sub_epi8(a, b); }
 
-template <typename I, typename O>
-using copy_if_result = in_out_result<I, O>;
+    static type bit_and(type a, type b) { return _mm256_and_si256(a, b); }
 
-namespace detail {
+    static type bit_or(type a, type b) { return _mm256_or_si256(a, b); }
 
-struct copy_if_fn {
-private:
-    template <typename I, typename S, typename O, typename Pred, typename Proj>
-    static constexpr copy_if_result<I, O> impl(I first, S last, O result,
-                                               Pred pred, Proj proj)
+    // Rotates the N-byte lanes of v down by one, for N = 4 or 8
+    template <std::size_t N>
+    static type rotate(type v)
     {
-        while (first != last) {
-            if (nano::invoke(pred, nano::invoke(proj, *first))) {
-                *result = *first;
-                ++result;
-            }
-            ++first;
+        if constexpr (N == 4) {
+            return _mm256_permutevar8x32_epi32(
+                v, _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0));
+        } else {
+            return _mm256_permute4x64_epi64(v, _MM_SHUFFLE(0, 3, 2, 1));
         }
+    }
 
-        return {std::move(first), std::move(result)};
+    // Splits each byte into its low and high nibbles
+    static type low_nibbles(type v)
+    {
+        return _mm256_and_si256(v, _mm256_set1_epi8(0x0F));
     }
 
-public:
-    template <typename I, typename S, typename O, typename Proj = identity,
-              typename Pred>
-    constexpr std::enable_if_t<
-        input_iterator<I> && sentinel_for<S, I> && weakly_incrementable<O> &&
-            indirect_unary_predicate<Pred, projected<I, Proj>> &&
-            indirectly_copyable<I, O>,
-        copy_if_result<I, O>>
-    operator()(I first, S last, O result, Pred pred, Proj proj = Proj{}) const
+    static type high_nibbles(type v)
     {
-        return copy_if_fn::impl(std::move(first), std::move(last),
-                                std::move(result), std::move(pred),
-                                std::move(proj));
+        return _mm256_and_si256(_mm256_srli_epi16(v, 4), _mm256_set1_epi8(0x0F));
     }
 
-    template <typename Rng, typename O, typename Proj = identity, typename Pred>
-    constexpr std::enable_if_t<
-        input_range<Rng> && weakly_incrementable<O> &&
-            indirect_unary_predicate<Pred, projected<iterator_t<Rng>, Proj>>,
-        copy_if_result<borrowed_iterator_t<Rng>, O>>
-    operator()(Rng&& rng, O result, Pred pred, Proj proj = Proj{}) const
+    // Loads a 16-byte table for use with lookup16()
+    static type load_table16(const unsigned char* table)
     {
-        return copy_if_fn::impl(nano::begin(rng), nano::end(rng),
-                                std::move(result), std::move(pred),
-                                std::move(proj));
+        return _mm256_broadcastsi128_si256(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(table)));
     }
-};
 
-} // namespace detail
+    // Replaces each byte of idx, which must be less than 16, by that entry of
+    // the table
+    static type lookup16(type table, type idx)
+    {
+        return _mm256_shuffle_epi8(table, idx);
+    }
 
-NANO_INLINE_VAR(detail::copy_if_fn, copy_if)
+    // Returns the sum of all the (unsigned) bytes of v
+    static std::ptrdiff_t sum_bytes(type v)
+    {
+        const __m256i s = _mm256_sad_epu8(v, zero());
+        const __m128i t = _mm_add_epi64(_mm256_castsi256_si128(s),
+                                        _mm256_extracti128_si256(s, 1));
+        return _mm_cvtsi128_si32(t) + _mm_extract_epi16(t, 4);
+    }
 
-template <typename I, typename O>
-using copy_backward_result = in_out_result<I, O>;
+    static constexpr std::uint32_t all_ones = 0xFFFFFFFFu;
+#else
+    using type = __m128i;
+    static constexpr std::ptrdiff_t bytes = 16;
 
-namespace detail {
+    static type load(const void* p)
+    {
+        return _mm_loadu_si128(static_cast<const __m128i*>(p));
+    }
 
-struct copy_backward_fn {
-private:
-    template <typename I1, typename S1, typename I2>
-    static constexpr copy_backward_result<I1, I2>
-    impl(I1 first, S1 last, I2 result)
+    static std::uint32_t movemask(type v)
     {
-        I1 last_it = nano::next(first, std::move(last));
-        I1 it = last_it;
+        return static_cast<std::uint32_t>(_mm_movemask_epi8(v));
+    }
 
-        while (it != first) {
-            *--result = *--it;
+    template <typename T>
+    static type splat(T value)
+    {
+        if constexpr (sizeof(T) == 1) {
+            std::int8_t i;
+            std::memcpy(&i, &value, 1);
+            return _mm_set1_epi8(i);
+        } else if constexpr (sizeof(T) == 2) {
+            std::int16_t i;
+            std::memcpy(&i, &value, 2);
+            return _mm_set1_epi16(i);
+        } else if constexpr (sizeof(T) == 4) {
+            std::int32_t i;
+            std::memcpy(&i, &value, 4);
+            return _mm_set1_epi32(i);
+        } else {
+            std::int32_t i[2];
+            std::memcpy(i, &value, 8);
+            return _mm_set_epi32(i[1], i[0], i[1], i[0]);
         }
-
-        return {std::move(last_it), std::move(result)};
     }
 
-public:
-    template <typename I1, typename S1, typename I2>
-    constexpr std::enable_if_t<
-        bidirectional_iterator<I1> && sentinel_for<S1, I1> &&
-            bidirectional_iterator<I2> && indirectly_copyable<I1, I2>,
-                               copy_backward_result<I1, I2>>
-    operator()(I1 first, S1 last, I2 result) const
+    template <std::size_t N>
+    static type eq(type a, type b)
     {
-        return copy_backward_fn::impl(std::move(first), std::move(last),
-                                      std::move(result));
+        if constexpr (N == 1) {
+            return _mm_cmpeq_epi8(a, b);
+        } else if constexpr (N == 2) {
+            return _mm_cmpeq_epi16(a, b);
+        } else if constexpr (N == 4) {
+            return _mm_cmpeq_epi32(a, b);
+        } else {
+            // SSE2 has no 64-bit compare: a 64-bit lane is equal if both of
+            // its 32-bit halves are
+            const type e = _mm_cmpeq_epi32(a, b);
+            return _mm_and_si128(e,
+                                 _mm_shuffle_epi32(e, _MM_SHUFFLE(2, 3, 0, 1)));
+        }
     }
 
-    template <typename Rng, typename I>
-    constexpr std::enable_if_t<bidirectional_range<Rng> &&
-                                   bidirectional_iterator<I> &&
-                                   indirectly_copyable<iterator_t<Rng>, I>,
-                               copy_backward_result<borrowed_iterator_t<Rng>, I>>
-    operator()(Rng&& rng, I result) const
+    static type zero() { return _mm_setzero_si128(); }
+
+    static type sub_bytes(type a, type b) { return _mm_sub_epi8(a, b); }
+
+    static type bit_and(type a, type b) { return _mm_and_si128(a, b); }
+
+    static type bit_or(type a, type b) { return _mm_or_si128(a, b); }
+
+    // Rotates the N-byte lanes of v down by one, for N = 4 or 8
+    template <std::size_t N>
+    static type rotate(type v)
     {
-        return copy_backward_fn::impl(nano::begin(rng), nano::end(rng),
-                                      std::move(result));
+        if constexpr (N == 4) {
+            return _mm_shuffle_epi32(v, _MM_SHUFFLE(0, 3, 2, 1));
+        } else {
+            return _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2));
+        }
     }
-};
 
-} // namespace detail
+    // Splits each byte into its low and high nibbles
+    static type low_nibbles(type v)
+    {
+        return _mm_and_si128(v, _mm_set1_epi8(0x0F));
+    }
 
-NANO_INLINE_VAR(detail::copy_backward_fn, copy_backward)
+    static type high_nibbles(type v)
+    {
+        return _mm_and_si128(_mm_srli_epi16(v, 4), _mm_set1_epi8(0x0F));
+    }
 
-NANO_END_NAMESPACE
+#if NANO_HAS_SIMD_SHUFFLE
+    // Loads a 16-byte table for use with lookup16()
+    static type load_table16(const unsigned char* table)
+    {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(table));
+    }
 
+    // Replaces each byte of idx, which must be less than 16, by that entry of
+    // the table
+    static type lookup16(type table, type idx)
+    {
+        return _mm_shuffle_epi8(table, idx);
+    }
 #endif
 
-// nanorange/algorithm/count.hpp
-//
-// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
-// Distributed under the Boost Software License, Version 1.0. (See accompanying
-// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+    // Returns the sum of all the (unsigned) bytes of v
+    static std::ptrdiff_t sum_bytes(type v)
+    {
+        const __m128i s = _mm_sad_epu8(v, zero());
+        return _mm_cvtsi128_si32(s) + _mm_extract_epi16(s, 4);
+    }
 
-#ifndef NANORANGE_ALGORITHM_COUNT_HPP_INCLUDED
-#define NANORANGE_ALGORITHM_COUNT_HPP_INCLUDED
+    static constexpr std::uint32_t all_ones = 0xFFFFu;
+#endif
 
+    template <std::size_t N>
+    static std::uint32_t eq_mask(type a, type b)
+    {
+        return movemask(eq<N>(a, b));
+    }
 
+    template <typename T>
+    static constexpr std::ptrdiff_t lanes = bytes / sizeof(T);
 
-NANO_BEGIN_NAMESPACE
+    // The lowest of the bits which a movemask() sets for each N-byte lane
+    template <std::size_t N>
+    static constexpr std::uint32_t lane_bits = all_ones / ((1u << N) - 1);
+};
 
-// [rng.alg.count]
+#endif // NANO_HAS_AVX2 || NANO_HAS_SSE2
 
-namespace detail {
+// Returns a pointer to the first element of [first, last) which is equal to
+// value, or last if there is no such element
+template <typename T, typename U>
+const T* simd_find(const T* first, const T* last, const U& value)
+{
+    T needle;
+    if (!detail::simd_narrow(value, needle)) {
+        return last;
+    }
 
-struct count_if_fn {
-private:
-    friend struct count_fn;
-    friend struct is_permutation_fn;
+#if NANO_HAS_AVX2 || NANO_HAS_SSE2
+    const auto vneedle = simd_vec::splat(needle);
+    while (last - first >= simd_vec::lanes<T>) {
+        const std::uint32_t mask =
+            simd_vec::eq_mask<sizeof(T)>(simd_vec::load(first), vneedle);
+        if (mask != 0) {
+            return first + detail::simd_ctz(mask) / int(sizeof(T));
+        }
+        first += simd_vec::lanes<T>;
+    }
+#endif
 
-    template <typename I, typename S, typename Proj, typename Pred>
-    static constexpr iter_difference_t<I> impl(I first, S last, Pred& pred,
-                                               Proj& proj)
-    {
-        iter_difference_t<I> counter = 0;
+    while (first != last && !(*first == needle)) {
+        ++first;
+    }
+    return first;
+}
 
-        for (; first != last; ++first) {
-            if (nano::invoke(pred, nano::invoke(proj, *first))) {
-                ++counter;
-            }
+// Returns a pointer to the first element of [first, last) which is not equal
+// to value, or last if there is no such element
+template <typename T>
+const T* simd_find_not(const T* first, const T* last, T value)
+{
+#if NANO_HAS_AVX2 || NANO_HAS_SSE2
+    const auto vvalue = simd_vec::splat(value);
+    while (last - first >= simd_vec::lanes<T>) {
+        const std::uint32_t mask =
+            simd_vec::eq_mask<sizeof(T)>(simd_vec::load(first), vvalue);
+        if (mask != simd_vec::all_ones) {
+            return first + detail::simd_ctz(~mask) / int(sizeof(T));
         }
+        first += simd_vec::lanes<T>;
+    }
+#endif
 
-        return counter;
+    while (first != last && *first == value) {
+        ++first;
     }
+    return first;
+}
 
-public:
-    template <typename I, typename S, typename Proj = identity, typename Pred>
-    constexpr std::enable_if_t<
-        input_iterator<I> && sentinel_for<S, I> &&
-            indirect_unary_predicate<Pred, projected<I, Proj>>,
-        iter_difference_t<I>>
-    operator()(I first, S last, Pred pred, Proj proj = Proj{}) const
-    {
-        return count_if_fn::impl(std::move(first), std::move(last),
-                                 pred, proj);
+// Returns a pointer to the start of the longest suffix of [first, last) whose
+// elements are all equal to value
+template <typename T>
+const T* simd_find_run_start(const T* first, const T* last, T value)
+{
+#if NANO_HAS_AVX2 || NANO_HAS_SSE2
+    const auto vvalue = simd_vec::splat(value);
+    while (last - first >= simd_vec::lanes<T>) {
+        const std::uint32_t mask = simd_vec::eq_mask<sizeof(T)>(
+            simd_vec::load(last - simd_vec::lanes<T>), vvalue);
+        if (mask != simd_vec::all_ones) {
+            // The highest clear bit belongs to the last unequal element
+            const int bit = detail::simd_highest_bit(~mask & simd_vec::all_ones);
+            return last - simd_vec::lanes<T> + bit / int(sizeof(T)) + 1;
+        }
+        last -= simd_vec::lanes<T>;
     }
+#endif
 
-    template <typename Rng, typename Proj = identity, typename Pred>
-    constexpr std::enable_if_t<
-        input_range<Rng> &&
-            indirect_unary_predicate<Pred, projected<iterator_t<Rng>, Proj>>,
-        range_difference_t<Rng>>
-    operator()(Rng&& rng, Pred pred, Proj proj = Proj{}) const
-    {
-        return count_if_fn::impl(nano::begin(rng), nano::end(rng),
-                                 pred, proj);
+    while (last != first && *(last - 1) == value) {
+        --last;
     }
-};
-} // namespace detail
+    return last;
+}
 
-NANO_INLINE_VAR(detail::count_if_fn, count_if)
+// Returns a pointer to the first of count consecutive elements of
+// [first, last) which are equal to value, or last if there are none.
+// Requires count > 0.
+template <typename T, typename U>
+const T* simd_search_n(const T* first, const T* const last,
+                       std::ptrdiff_t count, const U& value)
+{
+    T needle;
+    if (!detail::simd_narrow(value, needle)) {
+        return last;
+    }
 
-namespace detail {
+    // Any run of count elements must include one of the elements count - 1,
+    // 2 * count - 1, ... places from the start of the range. For short runs
+    // it's quicker to scan for the next equal element than to probe each of
+    // them in turn.
+    constexpr std::ptrdiff_t probe_threshold = 16;
 
-struct count_fn {
-    template <typename I, typename S, typename T, typename Proj = identity>
-    constexpr std::enable_if_t<
-        input_iterator<I> && sentinel_for<S, I> &&
-            indirect_relation<ranges::equal_to, projected<I, Proj>, const T*>,
-        iter_difference_t<I>>
-    operator()(I first, S last, const T& value, Proj proj = Proj{}) const
-    {
-        const auto pred = [&value] (const auto& t) { return t == value; };
-        return count_if_fn::impl(std::move(first), std::move(last),
-                                 pred, proj);
-    }
+    while (last - first >= count) {
+        const T* probe = first + (count - 1);
+        if (count < probe_threshold) {
+            probe = detail::simd_find(probe, last, needle);
+            if (probe == last) {
+                break;
+            }
+        } else if (!(*probe == needle)) {
+            first = probe + 1;
+            continue;
+        }
 
-    template <typename Rng, typename T, typename Proj = identity>
-    constexpr std::enable_if_t<
-        input_range<Rng> &&
-            indirect_relation<ranges::equal_to, projected<iterator_t<Rng>, Proj>,
-                             const T*>,
-        range_difference_t<Rng>>
-    operator()(Rng&& rng, const T& value, Proj proj = Proj{}) const
-    {
-        const auto pred = [&value] (const auto& t) { return t == value; };
-        return count_if_fn::impl(nano::begin(rng), nano::end(rng),
-                                 pred, proj);
+        // Extend the run around the probe in both directions, but no further
+        // forward than we need to
+        const T* const run_first =
+            detail::simd_find_run_start(first, probe, needle);
+        const T* const limit =
+            last - run_first > count ? run_first + count : last;
+        const T* const run_last = detail::simd_find_not(probe + 1, limit, needle);
+        if (run_last - run_first == count) {
+            return run_first;
+        }
+        if (run_last == last) {
+            break;
+        }
+        first = run_last + 1;
     }
-};
 
-} // namespace detail
+    return last;
+}
 
-NANO_INLINE_VAR(detail::count_fn, count)
+// A set of byte values, for find_first_of(). Membership is tested with a
+// 256-bit bitmap. The vectorised kernels instead use one of:
+//
+//  * with a byte shuffle, a pair of 16-entry tables indexed by the low and
+//    high nibbles of each byte. Each distinct high nibble in the set is
+//    given one of eight bits; the low table has that bit set for each low
+//    nibble which occurs with it, so a byte is in the set if the two entries
+//    have a bit in common. This handles any set with at most eight distinct
+//    high nibbles, including every set of up to eight bytes.
+//
+//  * otherwise, one comparison for each byte in the set, if there are at
+//    most four of them
+struct simd_byte_set {
+    static constexpr int max_compares = 4;
 
-NANO_END_NAMESPACE
+    void insert(unsigned char c)
+    {
+        if (contains(c)) {
+            return;
+        }
+        bits_[c >> 6] |= std::uint64_t(1) << (c & 63);
 
-#endif
+        if (size_ < max_compares) {
+            values_[size_] = c;
+        }
+        ++size_;
 
-// nanorange/algorithm/equal.hpp
-//
-// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
-// Distributed under the Boost Software License, Version 1.0. (See accompanying
-// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+        unsigned char& hi = high_table_[c >> 4];
+        if (hi == 0) {
+            if (num_high_ == 8) {
+                nibble_tables_ok_ = false;
+                return;
+            }
+            hi = static_cast<unsigned char>(1u << num_high_++);
+        }
+        low_table_[c & 15] |= hi;
+    }
 
-#ifndef NANORANGE_ALGORITHM_EQUAL_HPP_INCLUDED
-#define NANORANGE_ALGORITHM_EQUAL_HPP_INCLUDED
+    bool contains(unsigned char c) const
+    {
+        return (bits_[c >> 6] >> (c & 63)) & 1;
+    }
 
+    int size() const { return size_; }
 
+private:
+    template <typename T>
+    friend const T* simd_find_first_of(const T*, const T*,
+                                       const simd_byte_set&);
 
+    std::uint64_t bits_[4] = {};
+    unsigned char low_table_[16] = {};
+    unsigned char high_table_[16] = {};
+    unsigned char values_[max_compares] = {};
+    int size_ = 0;
+    int num_high_ = 0;
+    bool nibble_tables_ok_ = true;
+};
 
-NANO_BEGIN_NAMESPACE
+// Returns a pointer to the first element of [first, last) which is in set,
+// or last if there is no such element. Requires sizeof(T) == 1.
+template <typename T>
+const T* simd_find_first_of(const T* first, const T* last,
+                            const simd_byte_set& set)
+{
+    static_assert(sizeof(T) == 1, "");
 
-namespace detail {
+    if (set.size() == 0) {
+        return last;
+    }
 
-struct equal_fn {
-private:
-    template <typename I1, typename S1, typename I2, typename S2, typename Pred,
-              typename Proj1, typename Proj2>
-    static constexpr bool impl4(I1 first1, S1 last1, I2 first2, S2 last2,
-                                Pred& pred, Proj1& proj1, Proj2& proj2)
-    {
-        while (first1 != last1 && first2 != last2) {
-            if (!nano::invoke(pred, nano::invoke(proj1, *first1),
-                              nano::invoke(proj2, *first2))) {
-                return false;
+#if NANO_HAS_SIMD_SHUFFLE
+    if (set.nibble_tables_ok_) {
+        const auto low = simd_vec::load_table16(set.low_table_);
+        const auto high = simd_vec::load_table16(set.high_table_);
+        const auto zero = simd_vec::zero();
+        while (last - first >= simd_vec::bytes) {
+            const auto v = simd_vec::load(first);
+            const auto hits = simd_vec::bit_and(
+                simd_vec::lookup16(low, simd_vec::low_nibbles(v)),
+                simd_vec::lookup16(high, simd_vec::high_nibbles(v)));
+            const std::uint32_t mask =
+                ~simd_vec::eq_mask<1>(hits, zero) & simd_vec::all_ones;
+            if (mask != 0) {
+                return first + detail::simd_ctz(mask);
             }
-            ++first1;
-            ++first2;
+            first += simd_vec::bytes;
         }
-
-        return first1 == last1 && first2 == last2;
     }
-
-    template <typename I1, typename S1, typename I2, typename Pred,
-              typename Proj1, typename Proj2>
-    static constexpr bool impl3(I1 first1, S1 last1, I2 first2, Pred pred,
-                                Proj1& proj1, Proj2& proj2)
-    {
-        while (first1 != last1) {
-            if (!nano::invoke(pred, nano::invoke(proj1, *first1),
-                              nano::invoke(proj2, *first2))) {
-                return false;
+#elif NANO_HAS_SSE2
+    if (set.size() <= simd_byte_set::max_compares) {
+        simd_vec::type needles[simd_byte_set::max_compares];
+        for (int i = 0; i < set.size(); ++i) {
+            needles[i] = simd_vec::splat(set.values_[i]);
+        }
+        while (last - first >= simd_vec::bytes) {
+            const auto v = simd_vec::load(first);
+            auto hits = simd_vec::eq<1>(v, needles[0]);
+            for (int i = 1; i < set.size(); ++i) {
+                hits = simd_vec::bit_or(hits, simd_vec::eq<1>(v, needles[i]));
             }
-            ++first1;
-            ++first2;
+            const std::uint32_t mask = simd_vec::movemask(hits);
+            if (mask != 0) {
+                return first + detail::simd_ctz(mask);
+            }
+            first += simd_vec::bytes;
         }
-
-        return true;
     }
+#endif
 
-public:
-    // Four-legged, sized sentinels
-    template <typename I1, typename S1, typename I2, typename S2,
-              typename Pred = ranges::equal_to, typename Proj1 = identity,
-              typename Proj2 = identity>
-    constexpr std::enable_if_t<
-        input_iterator<I1> && sentinel_for<S1, I1> && input_iterator<I2> &&
-            sentinel_for<S2, I2> &&
-            indirectly_comparable<I1, I2, Pred, Proj1, Proj2> &&
-            sized_sentinel_for<S1, I1> && sized_sentinel_for<S2, I2>,
-        bool>
-    operator()(I1 first1, S1 last1, I2 first2, S2 last2, Pred pred = Pred{},
-               Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
-    {
-        if (last1 - first1 != last2 - first2) {
-            return false;
+    for (; first != last; ++first) {
+        unsigned char c;
+        std::memcpy(&c, first, 1);
+        if (set.contains(c)) {
+            break;
         }
-
-        // Ranges are the same size, so call the 3-legged version
-        // and save ourselves a comparison
-        return equal_fn::impl3(std::move(first1), std::move(last1),
-                               std::move(first2), pred,
-                               proj1, proj2);
     }
+    return first;
+}
 
-    // Four-legged, unsized sentinels
-    template <typename I1, typename S1, typename I2, typename S2,
-              typename Pred = ranges::equal_to, typename Proj1 = identity,
-              typename Proj2 = identity>
-    constexpr std::enable_if_t<
-        input_iterator<I1> && sentinel_for<S1, I1> && input_iterator<I2> &&
-            sentinel_for<S2, I2> &&
-            indirectly_comparable<I1, I2, Pred, Proj1, Proj2> &&
-            !(sized_sentinel_for<S1, I1> && sized_sentinel_for<S2, I2>),
-        bool>
-    operator()(I1 first1, S1 last1, I2 first2, S2 last2, Pred pred = Pred{},
-               Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
-    {
-        return equal_fn::impl4(std::move(first1), std::move(last1),
-                               std::move(first2), std::move(last2),
-                               pred, proj1, proj2);
+// Returns the number of elements of [first, last) which are equal to value
+template <typename T, typename U>
+std::ptrdiff_t simd_count(const T* first, const T* last, const U& value)
+{
+    T needle;
+    if (!detail::simd_narrow(value, needle)) {
+        return 0;
     }
 
-    // Three legged
-    template <typename I1, typename S1, typename I2, typename Pred = ranges::equal_to,
-              typename Proj1 = identity, typename Proj2 = identity>
-    NANO_DEPRECATED constexpr std::enable_if_t<
-        input_iterator<I1> && sentinel_for<S1, I1> &&
-            input_iterator<std::decay_t<I2>> &&
-                !input_range<I2> &&
-            indirectly_comparable<I1, std::decay_t<I2>, Pred, Proj1, Proj2>,
-        bool>
-    operator()(I1 first1, S1 last1, I2 first2, Pred pred = Pred{},
-               Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
-    {
-        return equal_fn::impl3(std::move(first1), std::move(last1),
-                               std::forward<I2>(first2), pred, proj1, proj2);
-    }
+    std::ptrdiff_t count = 0;
 
-    // Two ranges, both sized
-    template <typename Rng1, typename Rng2, typename Pred = ranges::equal_to,
-              typename Proj1 = identity, typename Proj2 = identity>
-    constexpr std::enable_if_t<
-        input_range<Rng1> && input_range<Rng2> &&
-            indirectly_comparable<iterator_t<Rng1>, iterator_t<Rng2>, Pred,
-                                 Proj1, Proj2> &&
-            sized_range<Rng1> && sized_range<Rng2>,
-        bool>
-    operator()(Rng1&& rng1, Rng2&& rng2, Pred pred = Pred{},
-               Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
-    {
-        if (nano::distance(rng1) != nano::distance(rng2)) {
-            return false;
+#if NANO_HAS_AVX2 || NANO_HAS_SSE2
+    // Each comparison sets every byte of a matching element to 0xFF, which
+    // we subtract from per-byte counters. These are summed and reset before
+    // they can overflow.
+    const auto vneedle = simd_vec::splat(needle);
+    while (last - first >= simd_vec::lanes<T>) {
+        auto counters = simd_vec::zero();
+        for (int i = 0; i < 255 && last - first >= simd_vec::lanes<T>; ++i) {
+            counters = simd_vec::sub_bytes(
+                counters,
+                simd_vec::eq<sizeof(T)>(simd_vec::load(first), vneedle));
+            first += simd_vec::lanes<T>;
         }
-
-        return equal_fn::impl3(nano::begin(rng1), nano::end(rng1),
-                               nano::begin(rng2), pred, proj1, proj2);
-    }
-
-    // Two ranges, not both sized
-    template <typename Rng1, typename Rng2, typename Pred = ranges::equal_to,
-              typename Proj1 = identity, typename Proj2 = identity>
-    constexpr std::enable_if_t<
-        input_range<Rng1> && input_range<Rng2> &&
-            indirectly_comparable<iterator_t<Rng1>, iterator_t<Rng2>, Pred,
-                                 Proj1, Proj2> &&
-            !(sized_range<Rng1> && sized_range<Rng2>),
-        bool>
-    operator()(Rng1&& rng1, Rng2&& rng2, Pred pred = Pred{},
-               Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
-    {
-        return equal_fn::impl4(nano::begin(rng1), nano::end(rng1),
-                               nano::begin(rng2), nano::end(rng2),
-                               pred, proj1, proj2);
+        count += simd_vec::sum_bytes(counters);
     }
+    count /= static_cast<std::ptrdiff_t>(sizeof(T));
+#endif
 
-    // Range and a half
-    template <typename Rng1, typename I2, typename Pred = ranges::equal_to,
-              typename Proj1 = identity, typename Proj2 = identity>
-    NANO_DEPRECATED constexpr std::enable_if_t<
-        input_range<Rng1> && input_iterator<std::decay_t<I2>> &&
-                !input_range<I2> &&
-            indirectly_comparable<iterator_t<Rng1>, std::decay_t<I2>, Pred, Proj1, Proj2>,
-        bool>
-    operator()(Rng1&& rng1, I2&& first2, Pred pred = Pred{},
-               Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
-    {
-        return equal_fn::impl3(nano::begin(rng1), nano::end(rng1),
-                               std::forward<I2>(first2), pred, proj1, proj2);
+    for (; first != last; ++first) {
+        count += (*first == needle);
     }
-};
-
-} // namespace detail
-
-NANO_INLINE_VAR(detail::equal_fn, equal)
+    return count;
+}
 
-NANO_END_NAMESPACE
+// Returns the index of the first position at which the n-element sequences
+// beginning at first1 and first2 differ, or n if they do not
+template <typename T>
+std::ptrdiff_t simd_mismatch(const T* first1, const T* first2,
+                             std::ptrdiff_t n)
+{
+    std::ptrdiff_t i = 0;
 
+#if NANO_HAS_AVX2 || NANO_HAS_SSE2
+    for (; n - i >= simd_vec::lanes<T>; i += simd_vec::lanes<T>) {
+        const std::uint32_t mask = simd_vec::eq_mask<sizeof(T)>(
+            simd_vec::load(first1 + i), simd_vec::load(first2 + i));
+        if (mask != simd_vec::all_ones) {
+            return i + detail::simd_ctz(~mask) / int(sizeof(T));
+        }
+    }
 #endif
 
-// nanorange/algorithm/equal_range.hpp
-//
-// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
-// Distributed under the Boost Software License, Version 1.0. (See accompanying
-// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
-
-#ifndef NANORANGE_ALGORITHM_EQUAL_RANGE_HPP_INCLUDED
-#define NANORANGE_ALGORITHM_EQUAL_RANGE_HPP_INCLUDED
+    while (i != n && first1[i] == first2[i]) {
+        ++i;
+    }
+    return i;
+}
 
+// The set kernels take time proportional to the total length of both ranges,
+// so very lopsided inputs are better left to the galloping loops
+inline bool simd_set_is_balanced(std::ptrdiff_t n1, std::ptrdiff_t n2)
+{
+    return n1 / 16 <= n2 && n2 / 16 <= n1;
+}
 
-// nanorange/algorithm/upper_bound.hpp
+// Computes a prefix of set_intersection() (if Intersect) or set_difference()
+// of the sorted ranges [first1, last1) and [first2, last2), returning how far
+// it got in each so that the element-by-element loop can finish the job.
 //
-// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
-// Distributed under the Boost Software License, Version 1.0. (See accompanying
-// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+// Each block of simd_vec::lanes<T> elements from range1 is compared with
+// every rotation of the block from range2, and whichever block has the
+// smaller last element is replaced by the next one. An element of range1 is
+// in range2 if it matched any of the blocks it was compared with. This only
+// works if each value occurs at most once in each range, so we stop at the
+// first block containing a repeated value.
+template <bool Intersect, typename T, typename O>
+in_in_out_result<const T*, const T*, O>
+simd_set_match(const T* first1, const T* last1, const T* first2,
+               const T* last2, O out)
+{
+#if NANO_HAS_AVX2 || NANO_HAS_SSE2
+    constexpr std::size_t N = sizeof(T);
+    constexpr std::ptrdiff_t L = simd_vec::lanes<T>;
+
+    // Checks for repeats in a block, and between it and the next element
+    const auto distinct = [](const T* p) {
+        return simd_vec::eq_mask<N>(simd_vec::load(p),
+                                    simd_vec::load(p + 1)) == 0;
+    };
 
-#ifndef NANORANGE_ALGORITHM_UPPER_BOUND_HPP_INCLUDED
-#define NANORANGE_ALGORITHM_UPPER_BOUND_HPP_INCLUDED
+    const auto emit = [&out](const T* block, std::uint32_t mask) {
+        mask &= simd_vec::lane_bits<N>;
+        while (mask != 0) {
+            *out = block[detail::simd_ctz(mask) / int(N)];
+            ++out;
+            mask &= mask - 1;
+        }
+    };
 
+    if (last1 - first1 <= L || last2 - first2 <= L || !distinct(first1) ||
+        !distinct(first2)) {
+        return {first1, first2, std::move(out)};
+    }
 
+    auto block1 = simd_vec::load(first1);
+    auto block2 = simd_vec::load(first2);
+    // Which elements of the current block of range1 have matched so far
+    std::uint32_t matched = 0;
 
-NANO_BEGIN_NAMESPACE
+    while (true) {
+        auto rotated = block2;
+        auto eq = simd_vec::eq<N>(block1, rotated);
+        for (std::ptrdiff_t i = 1; i < L; ++i) {
+            rotated = simd_vec::rotate<N>(rotated);
+            eq = simd_vec::bit_or(eq, simd_vec::eq<N>(block1, rotated));
+        }
+        matched |= simd_vec::movemask(eq);
+
+        const T max1 = first1[L - 1];
+        const T max2 = first2[L - 1];
+        if (!(max2 < max1)) {
+            // Every element of this block which is in range2 has been seen
+            emit(first1, Intersect ? matched : ~matched);
+            matched = 0;
+            first1 += L;
+            if (last1 - first1 <= L || !distinct(first1)) {
+                break;
+            }
+            block1 = simd_vec::load(first1);
+        }
+        if (!(max1 < max2)) {
+            first2 += L;
+            if (last2 - first2 <= L || !distinct(first2)) {
+                break;
+            }
+            block2 = simd_vec::load(first2);
+        }
+    }
 
-namespace detail {
+    // Settle those elements of the current block of range1 which are less
+    // than everything left in range2, so that what remains has not been
+    // compared with anything
+    const std::ptrdiff_t n = last1 - first1 < L ? last1 - first1 : L;
+    std::ptrdiff_t i = 0;
+    for (; i < n && (first2 == last2 || first1[i] < *first2); ++i) {
+        if (((matched >> (i * N)) & 1u) == (Intersect ? 1u : 0u)) {
+            *out = first1[i];
+            ++out;
+        }
+    }
+    first1 += i;
+#else
+    (void) last1;
+    (void) last2;
+#endif
 
-struct upper_bound_fn {
-private:
-    friend struct equal_range_fn;
+    return {first1, first2, std::move(out)};
+}
 
-    template <typename Comp, typename T>
-    struct compare {
-        Comp& comp;
-        const T& val;
+// Merges the sorted ranges [first1, last1) and [first2, last2) as
+// set_union() does, until one of them runs out. SSE2 has no integer min and
+// max with which to build a merging network, so this is a scalar loop, but
+// one in which the compiler can use conditional moves instead of branching
+// on every comparison.
+template <typename T, typename O>
+in_in_out_result<const T*, const T*, O>
+simd_set_union(const T* first1, const T* last1, const T* first2,
+               const T* last2, O out)
+{
+    const std::ptrdiff_t n1 = last1 - first1;
+    const std::ptrdiff_t n2 = last2 - first2;
+    std::ptrdiff_t i = 0;
+    std::ptrdiff_t j = 0;
+    while (i < n1 && j < n2) {
+        const T a = first1[i];
+        const T b = first2[j];
+        *out = b < a ? b : a;
+        ++out;
+        i += (a <= b);
+        j += (b <= a);
+    }
+    return {first1 + i, first2 + j, std::move(out)};
+}
 
-        template <typename U>
-        constexpr bool operator()(U&& u) const
-        {
-            return !nano::invoke(comp, val, std::forward<U>(u));
+// If rng is a sized, contiguous range and Candidate holds, returns
+// kernel(ptr, n) for a pointer to its n elements, going via data() as we
+// can't tell that e.g. vector::iterator is contiguous. Otherwise, and during
+// constant evaluation, returns fallback().
+template <bool Candidate, typename Rng, typename Kernel, typename Fallback>
+constexpr auto simd_range_dispatch(Rng& rng, [[maybe_unused]] Kernel kernel,
+                                   Fallback fallback)
+{
+    if constexpr (Candidate && contiguous_range<Rng> && sized_range<Rng>) {
+        if (!detail::is_constant_evaluated()) {
+            return kernel(nano::data(rng), nano::distance(rng));
         }
-    };
-
+    }
+    return fallback();
+}
 
-    template <typename I, typename S, typename T, typename Comp, typename Proj>
-    static constexpr I impl(I first, S last, const T& value, Comp& comp, Proj& proj)
-    {
-        const auto comparator = compare<Comp, T>{comp, value};
-        return partition_point_fn::impl(std::move(first), std::move(last),
-                                        comparator, proj);
+// As above, for a pair of ranges, calling kernel(ptr1, n1, ptr2, n2)
+template <bool Candidate, typename Rng1, typename Rng2, typename Kernel,
+          typename Fallback>
+constexpr auto simd_range_dispatch(Rng1& rng1, Rng2& rng2,
+                                   [[maybe_unused]] Kernel kernel,
+                                   Fallback fallback)
+{
+    if constexpr (Candidate && contiguous_range<Rng1> && sized_range<Rng1> &&
+                  contiguous_range<Rng2> && sized_range<Rng2>) {
+        if (!detail::is_constant_evaluated()) {
+            return kernel(nano::data(rng1), nano::distance(rng1),
+                          nano::data(rng2), nano::distance(rng2));
+        }
     }
+    return fallback();
+}
 
-public:
-    template <typename I, typename S, typename T, typename Comp = ranges::less,
-              typename Proj = identity>
-    std::enable_if_t<
-        forward_iterator<I> && sentinel_for<S, I> &&
-            indirect_strict_weak_order<Comp, const T*, projected<I, Proj>>,
-    I>
-    constexpr operator()(I first, S last, const T& value, Comp comp = Comp{},
-                         Proj proj = Proj{}) const
-    {
-        return upper_bound_fn::impl(std::move(first), std::move(last),
-                                    value, comp, proj);
+// If the set kernels apply to [first1, last1) and [first2, last2), calls
+// kernel(first1, last1, first2, last2, result) on pointers to them, and
+// advances first1, first2 and result past the prefix it has dealt with
+template <typename Comp, typename Proj1, typename Proj2, typename I1,
+          typename S1, typename I2, typename S2, typename O, typename Kernel>
+constexpr void simd_set_prefix([[maybe_unused]] I1& first1,
+                               [[maybe_unused]] const S1& last1,
+                               [[maybe_unused]] I2& first2,
+                               [[maybe_unused]] const S2& last2,
+                               [[maybe_unused]] O& result,
+                               [[maybe_unused]] Kernel kernel)
+{
+    if constexpr (is_simd_set_candidate<I1, S1, I2, S2, Comp, Proj1, Proj2>) {
+        const auto n1 = last1 - first1;
+        const auto n2 = last2 - first2;
+        if (!detail::is_constant_evaluated() && n1 > 0 && n2 > 0 &&
+            detail::simd_set_is_balanced(n1, n2)) {
+            const auto p1 = detail::to_address(first1);
+            const auto p2 = detail::to_address(first2);
+            auto res = kernel(p1, p1 + n1, p2, p2 + n2, std::move(result));
+            first1 += res.in1 - p1;
+            first2 += res.in2 - p2;
+            result = std::move(res.out);
+        }
     }
+}
 
-    template <typename Rng, typename T, typename Comp = ranges::less,
-              typename Proj = identity>
-    std::enable_if_t<forward_range<Rng> &&
-                         indirect_strict_weak_order<Comp, const T*, projected<iterator_t<Rng>, Proj>>,
-                     borrowed_iterator_t<Rng>>
-    constexpr operator()(Rng&& rng, const T& value, Comp comp = Comp{},
-                         Proj proj = Proj{}) const
-    {
-        return upper_bound_fn::impl(nano::begin(rng), nano::end(rng),
-                                    value, comp, proj);
+// Maps the input positions in the result of a set algorithm run on the
+// pointers p1 and p2 back to the iterators first1 and first2
+template <typename O, typename P1, typename I1, typename P2, typename I2>
+constexpr O simd_set_rebase(O out, P1, I1, P2, I2)
+{
+    return out;
+}
+
+template <typename O, typename P1, typename I1, typename P2, typename I2>
+constexpr in_out_result<I1, O>
+simd_set_rebase(in_out_result<P1, O> res, P1 p1, I1 first1, P2, I2)
+{
+    return {std::move(first1) + (res.in - p1), std::move(res.out)};
+}
+
+template <typename O, typename P1, typename I1, typename P2, typename I2>
+constexpr in_in_out_result<I1, I2, O>
+simd_set_rebase(in_in_out_result<P1, P2, O> res, P1 p1, I1 first1, P2 p2,
+                I2 first2)
+{
+    return {std::move(first1) + (res.in1 - p1),
+            std::move(first2) + (res.in2 - p2), std::move(res.out)};
+}
+
+// Calls f(first1, last1, first2, last2) on the elements of rng1 and rng2.
+// Where the set kernels could apply, we pass pointers as simd_range_dispatch()
+// does, and map the result back.
+template <typename Comp, typename Proj1, typename Proj2, typename Rng1,
+          typename Rng2, typename F>
+constexpr auto simd_set_dispatch(Rng1& rng1, Rng2& rng2, F f)
+{
+    if constexpr (contiguous_range<Rng1> && sized_range<Rng1> &&
+                  contiguous_range<Rng2> && sized_range<Rng2> &&
+                  is_simd_set_candidate<range_pointer_t<Rng1>,
+                                        range_pointer_t<Rng1>,
+                                        range_pointer_t<Rng2>,
+                                        range_pointer_t<Rng2>, Comp, Proj1,
+                                        Proj2>) {
+        const auto p1 = nano::data(rng1);
+        const auto p2 = nano::data(rng2);
+        return detail::simd_set_rebase(
+            f(p1, p1 + nano::distance(rng1), p2, p2 + nano::distance(rng2)),
+            p1, nano::begin(rng1), p2, nano::begin(rng2));
+    } else {
+        return f(nano::begin(rng1), nano::end(rng1), nano::begin(rng2),
+                 nano::end(rng2));
     }
-};
+}
 
+// Returns whether the n-element sequences beginning at first1 and first2 are
+// equal
+template <typename T>
+bool simd_equal(const T* first1, const T* first2, std::ptrdiff_t n)
+{
+    return n == 0 || std::memcmp(first1, first2,
+                                 static_cast<std::size_t>(n) * sizeof(T)) == 0;
 }
 
-NANO_INLINE_VAR(detail::upper_bound_fn, upper_bound)
+} // namespace detail
 
 NANO_END_NAMESPACE
 
 #endif
 
-// nanorange/views/subrange.hpp
-//
-// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
-// Distributed under the Boost Software License, Version 1.0. (See accompanying
-// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
-#ifndef NANORANGE_VIEWS_SUBRANGE_HPP_INCLUDED
-#define NANORANGE_VIEWS_SUBRANGE_HPP_INCLUDED
 
+NANO_BEGIN_NAMESPACE
 
-// nanorange/views/interface.hpp
-//
-// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
-// Distributed under the Boost Software License, Version 1.0. (See accompanying
-// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+namespace detail {
 
-#ifndef NANORANGE_VIEWS_INTERFACE_HPP_INCLUDED
-#define NANORANGE_VIEWS_INTERFACE_HPP_INCLUDED
+struct partition_point_fn {
+private:
+    friend struct lower_bound_fn;
+    friend struct upper_bound_fn;
 
+    // With random access, the branch on pred in the loop below mispredicts
+    // half the time for random queries. Instead, we halve the length whatever
+    // the result, and select the new start of the range with a conditional
+    // move. When the elements are real objects, we also prefetch both of the
+    // possible midpoints for the next step, so that its cache miss overlaps
+    // with this one.
+    template <typename I, typename Pred, typename Proj>
+    static constexpr I branchless_impl_n(I first, iter_difference_t<I> n,
+                                         Pred& pred, Proj& proj)
+    {
+        if (n == 0) {
+            return first;
+        }
 
-// nanorange/iterator/common_iterator.hpp
-//
-// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
-// Distributed under the Boost Software License, Version 1.0. (See accompanying
-// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+        while (n > 1) {
+            const auto half = n / 2;
 
-#ifndef NANORANGE_ITERATOR_COMMON_ITERATOR_HPP_INCLUDED
-#define NANORANGE_ITERATOR_COMMON_ITERATOR_HPP_INCLUDED
+            using ref_t = iter_reference_t<I>;
+            if constexpr (std::is_lvalue_reference<ref_t>::value &&
+                          !std::is_volatile<
+                              std::remove_reference_t<ref_t>>::value) {
+                if (!detail::is_constant_evaluated()) {
+                    const auto next_half = (n - half) / 2;
+                    detail::simd_prefetch(std::addressof(first[next_half]));
+                    detail::simd_prefetch(
+                        std::addressof(first[half + next_half]));
+                }
+            }
 
-// nanorange/iterator/concepts.hpp
-//
-// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
-// Distributed under the Boost Software License, Version 1.0. (See accompanying
-// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+            first += nano::invoke(pred, nano::invoke(proj, first[half]))
+                         ? half : iter_difference_t<I>{0};
+            n -= half;
+        }
 
-#ifndef NANORANGE_ITERATOR_CONCEPTS_HPP_INCLUDED
-#define NANORANGE_ITERATOR_CONCEPTS_HPP_INCLUDED
+        return first + (nano::invoke(pred, nano::invoke(proj, *first))
+                            ? 1 : 0);
+    }
 
+    template <typename I, typename Pred, typename Proj>
+    static constexpr I impl_n(I first, iter_difference_t<I> n, Pred& pred,
+                              Proj& proj)
+    {
+        if constexpr (random_access_iterator<I>) {
+            return partition_point_fn::branchless_impl_n(std::move(first), n,
+                                                         pred, proj);
+        }
 
+        while (n != 0) {
+            const auto half = n/2;
 
+            auto middle = nano::next(first, half);
 
+            if (nano::invoke(pred, nano::invoke(proj, *middle))) {
+                first = std::move(++middle);
+                n -= half + 1;
+            } else {
+                n = half;
+            }
+        }
 
-#endif
+        return first;
+    }
 
+    template <typename I, typename S, typename Pred, typename Proj>
+    static constexpr std::enable_if_t<sized_sentinel_for<S, I>, I>
+    impl(I first, S last, Pred& pred, Proj& proj)
+    {
+        const auto n = nano::distance(first, std::move(last));
+        return partition_point_fn::impl_n(std::move(first), n, pred, proj);
+    }
 
-NANO_BEGIN_NAMESPACE
+    template <typename I, typename S, typename Pred, typename Proj>
+    static constexpr std::enable_if_t<!sized_sentinel_for<S, I>, I>
+    impl(I first, S last, Pred& pred, Proj& proj)
+    {
+        // Probe exponentially for either end-of-range or an iterator
+        // that is past the partition point (i.e., does not satisfy pred).
+        iter_difference_t<I> n{1};
 
-// [range.iterators.common]
+        while (true) {
+            auto m = first;
+            auto d = nano::advance(m, n, last);
+            if (m == last || !nano::invoke(pred, nano::invoke(proj, *m))) {
+                n -= d;
+                return partition_point_fn::impl_n(std::move(first), n,
+                                                  pred, proj);
+            }
+            first = std::move(m);
+            n *= 2;
+        }
+    }
 
-namespace common_iterator_ {
+public:
+    template <typename I, typename S, typename Pred, typename Proj = identity>
+    std::enable_if_t<forward_iterator<I> && sentinel_for<S, I> &&
+                         indirect_unary_predicate<Pred, projected<I, Proj>>, I>
+    constexpr operator()(I first, S last, Pred pred, Proj proj = Proj{}) const
+    {
+        return partition_point_fn::impl(std::move(first), std::move(last),
+                                        pred, proj);
+    }
 
-template <typename I, typename S>
-class common_iterator {
-    static_assert(input_or_output_iterator<I>, "");
-    static_assert(sentinel_for<S, I>, "");
-    static_assert(!same_as<I, S>, "");
+    template <typename Rng, typename Pred, typename Proj = identity>
+    std::enable_if_t<
+        forward_range<Rng> &&
+            indirect_unary_predicate<Pred, projected<iterator_t<Rng>, Proj>>,
+        borrowed_iterator_t<Rng>>
+    constexpr operator()(Rng&& rng, Pred pred, Proj proj = Proj{}) const
+    {
+        return partition_point_fn::impl(nano::begin(rng), nano::end(rng),
+                                        pred, proj);
+    }
+};
 
-    template <typename II, typename SS>
-    friend class common_iterator;
+}
 
-    class op_arrow_proxy {
-        iter_value_t<I> keep_;
+NANO_INLINE_VAR(detail::partition_point_fn, partition_point)
 
-        constexpr op_arrow_proxy(iter_reference_t<I>&& x) : keep_(std::move(x)) {}
+NANO_END_NAMESPACE
 
-    public:
-        constexpr const iter_value_t<I>* operator->() const
+#endif
+
+
+NANO_BEGIN_NAMESPACE
+
+namespace detail {
+
+struct lower_bound_fn {
+private:
+    friend struct binary_search_fn;
+    friend struct equal_range_fn;
+
+    template <typename Comp, typename T>
+    struct compare {
+        Comp& comp;
+        const T& val;
+
+        template <typename U>
+        constexpr bool operator()(U&& u) const
         {
-            return std::addressof(keep_);
+            return nano::invoke(comp, std::forward<U>(u), val);
         }
     };
 
-    template <typename II>
-    using op_arrow_t = decltype(std::declval<const II&>().operator->());
 
-    template <typename II>
-    static constexpr auto do_op_arrow(const II& i, detail::priority_tag<2>)
-        -> std::enable_if_t<
-            std::is_pointer<II>::value || detail::exists_v<op_arrow_t, II>, I>
+    template <typename I, typename S, typename T, typename Comp, typename Proj>
+    static constexpr I impl(I first, S last, const T& value, Comp& comp, Proj& proj)
     {
-        return i;
+        const auto comparator = compare<Comp, T>{comp, value};
+        return partition_point_fn::impl(std::move(first), std::move(last),
+                                        comparator, proj);
     }
 
-    template <typename II>
-    static constexpr auto do_op_arrow(const II& i, detail::priority_tag<1>)
-        -> std::enable_if_t<std::is_reference<iter_reference_t<const II>>::value,
-                            std::add_pointer_t<iter_reference_t<const II>>>
+public:
+    template <typename I, typename S, typename T, typename Comp = ranges::less,
+              typename Proj = identity>
+    std::enable_if_t<
+        forward_iterator<I> && sentinel_for<S, I> &&
+            indirect_strict_weak_order<Comp, const T*, projected<I, Proj>>,
+        I>
+    constexpr operator()(I first, S last, const T& value, Comp comp = Comp{},
+                         Proj proj = Proj{}) const
     {
-        auto&& tmp = *i;
-        return std::addressof(tmp);
+        return lower_bound_fn::impl(std::move(first), std::move(last),
+                                    value, comp, proj);
     }
 
-    template <typename II>
-    static constexpr auto do_op_arrow(const II& i, detail::priority_tag<0>)
-        -> op_arrow_proxy
+    template <typename Rng, typename T, typename Comp = ranges::less,
+              typename Proj = identity>
+    std::enable_if_t<forward_range<Rng> &&
+                         indirect_strict_weak_order<Comp, const T*, projected<iterator_t<Rng>, Proj>>,
+                     borrowed_iterator_t<Rng>>
+    constexpr operator()(Rng&& rng, const T& value, Comp comp = Comp{},
+                         Proj proj = Proj{}) const
     {
-        return {i};
+        return lower_bound_fn::impl(nano::begin(rng), nano::end(rng),
+                                    value, comp, proj);
     }
+};
 
-public:
-    using difference_type = iter_difference_t<I>;
+}
 
-    constexpr common_iterator() : is_sentinel_{false}, iter_{} {}
+NANO_INLINE_VAR(detail::lower_bound_fn, lower_bound)
 
-    constexpr common_iterator(I i) : is_sentinel_{false}, iter_(i) {}
+NANO_END_NAMESPACE
 
-    constexpr common_iterator(S s) : is_sentinel_{true}, sentinel_{s} {}
+#endif
 
-    template <
-        typename II, typename SS,
-        std::enable_if_t<convertible_to<II, I> && convertible_to<SS, S>, int> = 0>
-    constexpr common_iterator(const common_iterator<II, SS>& other)
-        : is_sentinel_{other.is_sentinel_},
-          iter_(other.iter_),
-          sentinel_(other.sentinel_)
-    {}
 
-    template <typename II, typename SS>
-    constexpr std::enable_if_t<convertible_to<II, I> && convertible_to<SS, S>,
-                               common_iterator&>
-    operator=(const common_iterator<II, SS>& other)
-    {
-        is_sentinel_ = other.is_sentinel_;
-        iter_ = other.iter_;
-        sentinel_ = other.sentinel_;
-        return *this;
-    }
+NANO_BEGIN_NAMESPACE
 
-    constexpr decltype(auto) operator*() { return *iter_; }
+namespace detail {
 
-    template <typename II = I,
-              std::enable_if_t<detail::dereferenceable<const I>, int> = 0>
-    constexpr decltype(auto) operator*() const
+struct binary_search_fn {
+private:
+    template <typename I, typename S, typename T, typename Comp, typename Proj>
+    static constexpr bool impl(I first, S last, const T& value, Comp& comp,
+                               Proj& proj)
     {
-        return *iter_;
+        first = lower_bound_fn::impl(std::move(first), last, value, comp, proj);
+        return (first != last && !nano::invoke(comp, value, nano::invoke(proj, *first)));
     }
 
-    template <typename II = I>
-    constexpr auto operator-> () const
-        -> decltype(common_iterator::do_op_arrow(std::declval<const II&>(),
-                                                 detail::priority_tag<2>{}))
+public:
+    template <typename I, typename S, typename T, typename Comp = ranges::less,
+              typename Proj = identity>
+    std::enable_if_t<
+        forward_iterator<I> && sentinel_for<S, I> &&
+            indirect_strict_weak_order<Comp, const T*, projected<I, Proj>>,
+    bool>
+    constexpr operator()(I first, S last, const T& value, Comp comp = Comp{},
+               Proj proj = Proj{}) const
     {
-        return do_op_arrow(iter_, detail::priority_tag<2>{});
+        return binary_search_fn::impl(std::move(first), std::move(last),
+                                      value, comp, proj);
     }
 
-    constexpr common_iterator& operator++()
+    template <typename Rng, typename T, typename Comp = ranges::less,
+              typename Proj = identity>
+    std::enable_if_t<forward_range<Rng> &&
+                         indirect_strict_weak_order<Comp, const T*, projected<iterator_t<Rng>, Proj>>,
+    bool>
+    constexpr operator()(Rng&& rng, const T& value, Comp comp = Comp{},
+                         Proj proj = Proj{}) const
     {
-        ++iter_;
-        return *this;
+        return binary_search_fn::impl(nano::begin(rng), nano::end(rng),
+                                      value, comp, proj);
     }
+};
 
-    template <typename II = I, std::enable_if_t<!forward_iterator<II>, int> = 0>
-    constexpr  decltype(auto) operator++(int)
-    {
-        return iter_++;
-    }
+}
 
-    template <typename II = I, std::enable_if_t<forward_iterator<II>, int> = 0>
-    constexpr common_iterator operator++(int)
-    {
-        common_iterator tmp = *this;
-        ++iter_;
-        return tmp;
-    }
+NANO_INLINE_VAR(detail::binary_search_fn, binary_search)
 
-    template <typename I2, typename S2>
-    friend constexpr auto operator==(const common_iterator& x,
-                                     const common_iterator<I2, S2>& y)
-        -> std::enable_if_t<sentinel_for<S2, I> && sentinel_for<S, I2> &&
-                            !equality_comparable_with<I, I2>, bool>
-    {
-        return x.is_sentinel_ ? (y.is_sentinel_ || y.iter_ == x.sentinel_)
-                              : (!y.is_sentinel_ || x.iter_ == y.sentinel_);
-    }
+NANO_END_NAMESPACE
 
-    template <typename I2, typename S2>
-    friend constexpr auto operator==(const common_iterator& x,
-                                     const common_iterator<I2, S2>& y)
-        -> std::enable_if_t<sentinel_for<S2, I> && sentinel_for<S, I2> &&
-                            equality_comparable_with<I, I2>, bool>
-    {
-        return x.is_sentinel_
-               ? (y.is_sentinel_ || y.iter_ == x.sentinel_)
-               : (y.is_sentinel_ ? x.iter_ == y.sentinel_ : x.iter_ == y.iter_);
-    }
-
-    template <typename I2, typename S2>
-    friend constexpr auto operator!=(const common_iterator& x,
-                                     const common_iterator<I2, S2>& y)
-        -> std::enable_if_t<sentinel_for<S2, I> && sentinel_for<S, I2>, bool>
-    {
-        return !(x == y);
-    }
-
-    template <typename I2, typename S2>
-    friend constexpr auto operator-(const common_iterator& x,
-                                    const common_iterator<I2, S2>& y)
-        -> std::enable_if_t<sized_sentinel_for<I, I2> && sized_sentinel_for<S, I2> &&
-                            sized_sentinel_for<S, I2>, iter_difference_t<I2>>
-    {
-        return x.is_sentinel_
-               ? (y.is_sentinel_ ? 0 : x.sentinel_ - y.iter_)
-               : (y.is_sentinel_ ? x.iter_ - y.sentinel_ : x.iter_ - y.iter_);
-    }
-
-    friend constexpr iter_rvalue_reference_t<I> iter_move(const common_iterator& i)
-    {
-        return ranges::iter_move(i.iter_);
-    }
+#endif
 
-    template <typename I2, typename S2>
-    friend constexpr std::enable_if_t<indirectly_swappable<I2, I>>
-    iter_swap(const common_iterator& x, const common_iterator<I2, S2>& y)
-    {
-        return ranges::iter_swap(x.iter_, y.iter_);
-    }
+// nanorange/algorithm/block_merge_sort.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
-    // private:
-    // TODO: Some sort of variant-like union
-    bool is_sentinel_{};
-    I iter_{};
-    S sentinel_{};
-};
+#ifndef NANORANGE_ALGORITHM_BLOCK_MERGE_SORT_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_BLOCK_MERGE_SORT_HPP_INCLUDED
 
-} // namespace common_iterator_
+// nanorange/algorithm/stable_sort.hpp
+//
+// Copyright (c) 2019 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
-using common_iterator_::common_iterator;
+// Uses code from cmcstl2 - A concept-enabled C++ standard library
+//
+//  Copyright Eric Niebler 2014
+//  Copyright Casey Carter 2015
+//
 
-template <typename I, typename S>
-struct readable_traits<common_iterator<I, S>> {
-    using value_type = iter_value_t<I>;
-};
+//
+//  Copyright (c) 1994
+//  Hewlett-Packard Company
+//
+//  Permission to use, copy, modify, distribute and sell this software
+//  and its documentation for any purpose is hereby granted without fee,
+//  provided that the above copyright notice appear in all copies and
+//  that both that copyright notice and this permission notice appear
+//  in supporting documentation.  Hewlett-Packard Company makes no
+//  representations about the suitability of this software for any
+//  purpose.  It is provided "as is" without express or implied warranty.
+//
+//  Copyright (c) 1996
+//  Silicon Graphics Computer Systems, Inc.
+//
+//  Permission to use, copy, modify, distribute and sell this software
+//  and its documentation for any purpose is hereby granted without fee,
+//  provided that the above copyright notice appear in all copies and
+//  that both that copyright notice and this permission notice appear
+//  in supporting documentation.  Silicon Graphics makes no
+//  representations about the suitability of this software for any
+//  purpose.  It is provided "as is" without express or implied warranty.
 
-template <typename I, typename S>
-struct iterator_category<common_iterator<I, S>>
-    : std::conditional<forward_iterator<I>, forward_iterator_tag,
-                       input_iterator_tag> {
-};
 
-NANO_END_NAMESPACE
+#ifndef NANORANGE_ALGORITHM_STABLE_SORT_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_STABLE_SORT_HPP_INCLUDED
 
-namespace std {
+// nanorange/algorithm/inplace_merge.hpp
+//
+// Copyright (c) 2019 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
-template <typename I, typename S>
-struct iterator_traits<::nano::common_iterator<I, S>> {
-    using difference_type =
-        ::nano::iter_difference_t<::nano::common_iterator<I, S>>;
-    using value_type = ::nano::iter_value_t<::nano::common_iterator<I, S>>;
-    using pointer =
-        std::add_pointer_t<::nano::iter_reference_t<::nano::common_iterator<I, S>>>;
-    using reference = ::nano::iter_reference_t<::nano::common_iterator<I, S>>;
-    using iterator_category =
-        ::nano::detail::conditional_t<::nano::forward_iterator<I>,
-                           std::forward_iterator_tag,
-                           std::input_iterator_tag>;
-};
+// Uses code from cmcstl2 - A concept-enabled C++ standard library
+//
+//  Copyright Eric Niebler 2014
+//  Copyright Casey Carter 2015
+//
 
-} // namespace std
+//===----------------------------------------------------------------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is dual licensed under the MIT and the University of Illinois Open
+// Source Licenses. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
 
-#endif
+#ifndef NANORANGE_ALGORITHM_INPLACE_MERGE_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_INPLACE_MERGE_HPP_INCLUDED
 
 
+// nanorange/algorithm/merge.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
-NANO_BEGIN_NAMESPACE
+#ifndef NANORANGE_ALGORITHM_MERGE_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_MERGE_HPP_INCLUDED
 
-// [ranges.view_interface]
+// nanorange/algorithm/copy.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
-namespace detail {
+#ifndef NANORANGE_ALGORITHM_COPY_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_COPY_HPP_INCLUDED
 
-template <typename, typename = void>
-struct range_common_iterator_impl;
 
-template <typename R>
-struct range_common_iterator_impl<
-    R, std::enable_if_t<range<R> && !common_range<R>>> {
-    using type = common_iterator<iterator_t<R>, sentinel_t<R>>;
-};
 
-template <typename R>
-struct range_common_iterator_impl<R, std::enable_if_t<common_range<R>>> {
-    using type = iterator_t<R>;
-};
 
-template <typename R>
-using range_common_iterator_t = typename range_common_iterator_impl<R>::type;
 
-} // namespace detail
+NANO_BEGIN_NAMESPACE
 
-template <typename D>
-class view_interface : public view_base {
+template <typename I, typename O>
+using copy_result = in_out_result<I, O>;
 
-    static_assert(std::is_class<D>::value, "");
-    static_assert(same_as<D, std::remove_cv_t<D>>, "");
+namespace detail {
 
+struct copy_fn {
 private:
-    constexpr D& derived() noexcept { return static_cast<D&>(*this); }
-
-    constexpr const D& derived() const noexcept
+    // Trivially copyable types in contiguous storage are copied with a single
+    // memmove(). This isn't possible during constant evaluation, so in that
+    // case we fall back to the element-by-element loop below.
+    template <typename I, typename S, typename O>
+    static constexpr std::enable_if_t<sized_sentinel_for<S, I> &&
+                                          is_memmove_copyable<I, O>,
+                                      copy_result<I, O>>
+    impl(I first, S last, O result, priority_tag<2>)
     {
-        return static_cast<const D&>(*this);
-    }
+        const auto dist = last - first;
 
-public:
-    template <typename R = D>
-    [[nodiscard]] constexpr auto empty()
-        -> std::enable_if_t<forward_range<R>, bool>
-    {
-        return ranges::begin(derived()) == ranges::end(derived());
-    }
+        if (!detail::is_constant_evaluated() && dist > 0) {
+            result = detail::memmove_n(first, dist, result);
+            return {first + dist, std::move(result)};
+        }
 
-    template <typename R = D>
-    [[nodiscard]] constexpr auto empty() const
-        -> std::enable_if_t<forward_range<const R>, bool>
-    {
-        return ranges::begin(derived()) == ranges::end(derived());
+        return impl(std::move(first), std::move(last), std::move(result),
+                    priority_tag<1>{});
     }
 
-    template <typename R = D, typename = decltype(ranges::empty(std::declval<R&>()))>
-    constexpr explicit operator bool()
+    // If we know the distance between first and last, we can use that
+    // information to (potentially) allow better codegen
+    template <typename I, typename S, typename O>
+    static constexpr std::enable_if_t<sized_sentinel_for<S, I>, copy_result<I, O>>
+    impl(I first, S last, O result, priority_tag<1>)
     {
-        return !ranges::empty(derived());
+        const auto dist = last - first;
+
+        for (iter_difference_t<I> i = 0; i < dist; ++i) {
+            *result = *first;
+            ++first;
+            ++result;
+        }
+
+        return {std::move(first), std::move(result)};
     }
 
-    template <typename R = D, typename = decltype(ranges::empty(std::declval<const R&>()))>
-    constexpr explicit operator bool() const
+    template <typename I, typename S, typename O>
+    static constexpr copy_result<I, O> impl(I first, S last, O result,
+                                            priority_tag<0>)
     {
-        return !ranges::empty(derived());
+        while (first != last) {
+            *result = *first;
+            ++first;
+            ++result;
+        }
+
+        return {std::move(first), std::move(result)};
     }
 
-    template <typename R = D, typename = std::enable_if_t<contiguous_iterator<iterator_t<R>>>>
-    constexpr auto data()
+    // Contiguous ranges may have iterators which we cannot tell are
+    // contiguous (see is_std_contiguous_iterator), so go via data() instead
+    template <typename Rng, typename O>
+    static constexpr std::enable_if_t<
+        contiguous_range<Rng> && sized_range<Rng> &&
+            is_memmove_copyable<range_pointer_t<Rng>, O>,
+        copy_result<iterator_t<Rng>, O>>
+    range_impl(Rng& rng, O result, priority_tag<1>)
     {
-        return ranges::empty(derived()) ? nullptr : std::addressof(*ranges::begin(derived()));
+        const auto dist = nano::distance(rng);
+
+        if (!detail::is_constant_evaluated() && dist > 0) {
+            result = detail::memmove_n(nano::data(rng), dist, result);
+            return {nano::begin(rng) + dist, std::move(result)};
+        }
+
+        return range_impl(rng, std::move(result), priority_tag<0>{});
     }
 
-    template <typename R = D, typename = std::enable_if_t<
-                  range<const R> && contiguous_iterator<iterator_t<const R>>>>
-    constexpr auto data() const
+    template <typename Rng, typename O>
+    static constexpr copy_result<iterator_t<Rng>, O>
+    range_impl(Rng& rng, O result, priority_tag<0>)
     {
-        return ranges::empty(derived()) ? nullptr : std::addressof(*ranges::begin(derived()));
+        return copy_fn::impl(nano::begin(rng), nano::end(rng),
+                             std::move(result), priority_tag<2>{});
     }
 
-    template <typename R = D, typename = std::enable_if_t<
-                  forward_range<R> &&
-                  sized_sentinel_for<sentinel_t<R>, iterator_t<R>>>>
-    constexpr auto size()
+public:
+    template <typename I, typename S, typename O>
+    constexpr std::enable_if_t<input_iterator<I> && sentinel_for<S, I> &&
+                                   weakly_incrementable<O> &&
+                                   indirectly_copyable<I, O>,
+                               copy_result<I, O>>
+    operator()(I first, S last, O result) const
     {
-        return ranges::end(derived()) - ranges::begin(derived());
+        return copy_fn::impl(std::move(first), std::move(last),
+                             std::move(result), priority_tag<2>{});
     }
 
-    template <typename R = D, typename = std::enable_if_t<
-                  forward_range<const R> &&
-                  sized_sentinel_for<sentinel_t<const R>, iterator_t<const R>>>>
-    constexpr auto size() const
+    template <typename Rng, typename O>
+    constexpr std::enable_if_t<input_range<Rng> && weakly_incrementable<O> &&
+                                   indirectly_copyable<iterator_t<Rng>, O>,
+                               copy_result<borrowed_iterator_t<Rng>, O>>
+    operator()(Rng&& rng, O result) const
     {
-        return ranges::end(derived()) - ranges::begin(derived());
+        return copy_fn::range_impl(rng, std::move(result), priority_tag<1>{});
     }
+};
 
-    template <typename R = D, typename = std::enable_if_t<forward_range<R>>>
-    constexpr decltype(auto) front()
+} // namespace detail
+
+NANO_INLINE_VAR(detail::copy_fn, copy)
+
+template <typename I, typename O>
+using copy_n_result = in_out_result<I, O>;
+
+namespace detail {
+
+struct copy_n_fn {
+private:
+    template <typename I, typename O>
+    static constexpr std::enable_if_t<is_memmove_copyable<I, O>,
+                                      copy_n_result<I, O>>
+    impl(I first, iter_difference_t<I> n, O result, priority_tag<1>)
     {
-        return *ranges::begin(derived());
+        if (!detail::is_constant_evaluated() && n > 0) {
+            result = detail::memmove_n(first, n, result);
+            return {first + n, std::move(result)};
+        }
+
+        return impl(std::move(first), n, std::move(result), priority_tag<0>{});
     }
 
-    template <typename R = D, typename = std::enable_if_t<forward_range<const R>>>
-    constexpr decltype(auto) front() const
+    template <typename I, typename O>
+    static constexpr copy_n_result<I, O>
+    impl(I first, iter_difference_t<I> n, O result, priority_tag<0>)
     {
-        return *ranges::begin(derived());
+        for (iter_difference_t<I> i{}; i < n; i++) {
+            *result = *first;
+            ++first;
+            ++result;
+        }
+
+        return {std::move(first), std::move(result)};
     }
 
-    template <typename R = D, typename = std::enable_if_t<
-                                  bidirectional_range<R> && common_range<R>>>
-    constexpr decltype(auto) back()
+public:
+    template <typename I, typename O>
+    constexpr std::enable_if_t<input_iterator<I> && weakly_incrementable<O> &&
+                                   indirectly_copyable<I, O>,
+                               copy_n_result<I, O>>
+    operator()(I first, iter_difference_t<I> n, O result) const
     {
-        return *ranges::prev(ranges::end(derived()));
+        return copy_n_fn::impl(std::move(first), n, std::move(result),
+                               priority_tag<1>{});
     }
+};
 
-    template <typename R = D, typename = std::enable_if_t<bidirectional_range<const R> &&
-                                          common_range<const R>>>
-    constexpr decltype(auto) back() const
+} // namespace detail
+
+NANO_INLINE_VAR(detail::copy_n_fn, copy_n)
+
+template <typename I, typename O>
+using copy_if_result = in_out_result<I, O>;
+
+namespace detail {
+
+struct copy_if_fn {
+private:
+    template <typename I, typename S, typename O, typename Pred, typename Proj>
+    static constexpr copy_if_result<I, O> impl(I first, S last, O result,
+                                               Pred pred, Proj proj)
     {
-        return *ranges::prev(ranges::end(derived()));
+        while (first != last) {
+            if (nano::invoke(pred, nano::invoke(proj, *first))) {
+                *result = *first;
+                ++result;
+            }
+            ++first;
+        }
+
+        return {std::move(first), std::move(result)};
     }
 
-    template <typename R = D, typename = std::enable_if_t<random_access_range<R>>>
-    constexpr decltype(auto) operator[](iter_difference_t<iterator_t<R>> n)
+public:
+    template <typename I, typename S, typename O, typename Proj = identity,
+              typename Pred>
+    constexpr std::enable_if_t<
+        input_iterator<I> && sentinel_for<S, I> && weakly_incrementable<O> &&
+            indirect_unary_predicate<Pred, projected<I, Proj>> &&
+            indirectly_copyable<I, O>,
+        copy_if_result<I, O>>
+    operator()(I first, S last, O result, Pred pred, Proj proj = Proj{}) const
     {
-        return ranges::begin(derived())[n];
+        return copy_if_fn::impl(std::move(first), std::move(last),
+                                std::move(result), std::move(pred),
+                                std::move(proj));
     }
 
-    template <typename R = D,  typename = std::enable_if_t<random_access_range<const R>>>
-    constexpr decltype(auto) operator[](iter_difference_t<iterator_t<const R>> n) const
+    template <typename Rng, typename O, typename Proj = identity, typename Pred>
+    constexpr std::enable_if_t<
+        input_range<Rng> && weakly_incrementable<O> &&
+            indirect_unary_predicate<Pred, projected<iterator_t<Rng>, Proj>>,
+        copy_if_result<borrowed_iterator_t<Rng>, O>>
+    operator()(Rng&& rng, O result, Pred pred, Proj proj = Proj{}) const
     {
-        return ranges::begin(derived())[n];
+        return copy_if_fn::impl(nano::begin(rng), nano::end(rng),
+                                std::move(result), std::move(pred),
+                                std::move(proj));
     }
 };
 
-NANO_END_NAMESPACE
+} // namespace detail
 
-#endif
+NANO_INLINE_VAR(detail::copy_if_fn, copy_if)
 
+template <typename I, typename O>
+using copy_backward_result = in_out_result<I, O>;
 
-NANO_BEGIN_NAMESPACE
+namespace detail {
 
-// [ranges.subrange]
+struct copy_backward_fn {
+private:
+    template <typename I1, typename S1, typename I2>
+    static constexpr std::enable_if_t<is_memmove_copyable<I1, I2>,
+                                      copy_backward_result<I1, I2>>
+    impl(I1 first, S1 last, I2 result, priority_tag<1>)
+    {
+        I1 last_it = nano::next(first, std::move(last));
+        const auto dist = last_it - first;
 
-enum class subrange_kind : bool { unsized, sized };
+        if (!detail::is_constant_evaluated() && dist > 0) {
+            result = detail::memmove_backward_n(last_it, dist, result);
+            return {std::move(last_it), std::move(result)};
+        }
 
-namespace detail {
+        return impl(std::move(first), std::move(last_it), std::move(result),
+                    priority_tag<0>{});
+    }
 
-template <typename I, typename S, bool = sized_sentinel_for<S, I>>
-struct default_subrange_kind {
-    static constexpr subrange_kind kind = subrange_kind::unsized;
-};
+    template <typename I1, typename S1, typename I2>
+    static constexpr copy_backward_result<I1, I2>
+    impl(I1 first, S1 last, I2 result, priority_tag<0>)
+    {
+        I1 last_it = nano::next(first, std::move(last));
+        I1 it = last_it;
 
-template <typename I, typename S>
-struct default_subrange_kind<I, S, true> {
-    static constexpr subrange_kind kind = subrange_kind::sized;
-};
+        while (it != first) {
+            *--result = *--it;
+        }
 
-}
+        return {std::move(last_it), std::move(result)};
+    }
 
-namespace subrange_ {
+public:
+    template <typename I1, typename S1, typename I2>
+    constexpr std::enable_if_t<
+        bidirectional_iterator<I1> && sentinel_for<S1, I1> &&
+            bidirectional_iterator<I2> && indirectly_copyable<I1, I2>,
+                               copy_backward_result<I1, I2>>
+    operator()(I1 first, S1 last, I2 result) const
+    {
+        return copy_backward_fn::impl(std::move(first), std::move(last),
+                                      std::move(result), priority_tag<1>{});
+    }
 
-template <typename I, typename S = I,
-          subrange_kind = detail::default_subrange_kind<I, S>::kind>
-class subrange;
+    template <typename Rng, typename I>
+    constexpr std::enable_if_t<bidirectional_range<Rng> &&
+                                   bidirectional_iterator<I> &&
+                                   indirectly_copyable<iterator_t<Rng>, I>,
+                               copy_backward_result<borrowed_iterator_t<Rng>, I>>
+    operator()(Rng&& rng, I result) const
+    {
+        return copy_backward_fn::impl(nano::begin(rng), nano::end(rng),
+                                      std::move(result), priority_tag<1>{});
+    }
+};
 
-}
+} // namespace detail
 
-using subrange_::subrange;
+NANO_INLINE_VAR(detail::copy_backward_fn, copy_backward)
 
-namespace detail {
+NANO_END_NAMESPACE
 
-struct convertible_to_non_slicing_concept {
-    template <typename, typename>
-    static auto test(long) -> std::false_type;
+#endif
 
-    template <typename From, typename To>
-    static auto test(int) -> std::enable_if_t<
-        convertible_to<From, To> &&
-        !(std::is_pointer_v<std::decay_t<From>> &&
-          std::is_pointer_v<std::decay_t<To>> &&
-          not_same_as<std::remove_pointer_t<std::decay_t<From>>,
-                      std::remove_pointer_t<std::decay_t<To>>>),
-        std::true_type>;
-};
+// nanorange/detail/algorithm/gallop.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
-template <typename From, typename To>
-NANO_CONCEPT convertible_to_non_slicing =
-    decltype(convertible_to_non_slicing_concept::test<From, To>(0))::value;
+#ifndef NANORANGE_DETAIL_ALGORITHM_GALLOP_HPP_INCLUDED
+#define NANORANGE_DETAIL_ALGORITHM_GALLOP_HPP_INCLUDED
 
-struct pair_like_concept {
-    template <typename>
-    static auto test(long) -> std::false_type;
 
-    template <typename T,
-              typename = typename std::tuple_size<T>::type,
-              typename = std::enable_if_t<detail::requires_<pair_like_concept, T>>>
-    static auto test(int) -> std::true_type;
 
-    template <typename T>
-    auto requires_(T t) -> decltype(
-        requires_expr<derived_from<std::tuple_size<T>, std::integral_constant<std::size_t, 2>>>{},
-        std::declval<std::tuple_element_t<0, std::remove_const_t<T>>>(),
-        std::declval<std::tuple_element_t<1, std::remove_const_t<T>>>(),
-        requires_expr<convertible_to<decltype(std::get<0>(t)), const std::tuple_element<0, T>&>>{},
-        requires_expr<convertible_to<decltype(std::get<1>(t)), const std::tuple_element<1, T>&>>{}
-    );
-};
+NANO_BEGIN_NAMESPACE
 
-template <typename T>
-NANO_CONCEPT pair_like = !std::is_reference_v<T> &&
-    decltype(pair_like_concept::test<T>(0))::value;
+namespace detail {
 
-struct pair_like_convertible_from_concept {
-    template <typename, typename, typename>
-    static auto test(long) -> std::false_type;
+// The merge-like algorithms step through their inputs one element at a time
+// while they are well interleaved. Once one input has supplied this many
+// elements in a row, they switch to an exponential search to find the end of
+// the run, as in TimSort's "galloping mode", so that combining m elements
+// with n takes O(m log(n/m)) comparisons rather than O(m + n).
+constexpr std::ptrdiff_t gallop_threshold = 8;
+
+// A gallop which finds a run of d elements takes about 2 log2(d) comparisons,
+// against the d + 1 it takes to step through them, so it can cost one more
+// comparison than stepping when the run turns out to be short. As in TimSort,
+// callers bound to a comparison count can adapt the threshold for each call,
+// raising it after a gallop which copied fewer than gallop_threshold elements
+// and lowering it after one which copied more, so that runs only a little
+// longer than the threshold don't pay that cost over and over.
+constexpr std::ptrdiff_t next_gallop_threshold(std::ptrdiff_t threshold,
+                                               std::ptrdiff_t copied)
+{
+    if (copied < gallop_threshold) {
+        return 2 * threshold;
+    }
+    return threshold > gallop_threshold ? threshold - 1 : gallop_threshold;
+}
 
-    template <typename T, typename U, typename V,
-              std::enable_if_t<!range<T>, int> = 0,
-              std::enable_if_t<pair_like<T>, int> = 0,
-              std::enable_if_t<constructible_from<T, U, V>, int> = 0,
-              std::enable_if_t<convertible_to_non_slicing<U, std::tuple_element<0, T>>, int> = 0,
-              std::enable_if_t<convertible_to<V, std::tuple_element<1, T>>, int> = 0>
-    static auto test(int) -> std::true_type;
-};
+template <typename I1, typename S1, typename I2, typename S2>
+inline constexpr bool is_gallop_candidate =
+    random_access_iterator<I1> && sized_sentinel_for<S1, I1> &&
+    random_access_iterator<I2> && sized_sentinel_for<S2, I2>;
 
-template <typename T, typename U, typename V>
-NANO_CONCEPT pair_like_convertible_from =
-    decltype(pair_like_convertible_from_concept::test<T, U, V>(0))::value;
+// Given that pred holds for some prefix of [first, last) and not for the
+// rest, returns the end of that prefix. Takes O(log d) applications of pred,
+// where d is the length of the prefix.
+template <typename I, typename S, typename Pred>
+constexpr I gallop(I first, S last, Pred pred)
+{
+    const auto n = last - first;
+
+    // Find a bound hi on the end of the prefix, doubling the step each time,
+    // such that pred holds for [0, lo) and not for hi
+    iter_difference_t<I> lo = 0;
+    iter_difference_t<I> step = 1;
+    while (step - 1 < n - lo && pred(first[lo + step - 1])) {
+        lo += step;
+        step *= 2;
+    }
+    iter_difference_t<I> hi = step - 1 < n - lo ? lo + step - 1 : n;
+
+    while (lo < hi) {
+        const auto mid = lo + (hi - lo) / 2;
+        if (pred(first[mid])) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
 
+    return first + lo;
+}
 
-struct iterator_sentinel_pair_concept {
-    template <typename T>
-    static auto test(long) -> std::false_type;
+} // namespace detail
 
-    template <typename T>
-    static auto test(int) -> std::enable_if_t<
-        !range<T> && pair_like<T> &&
-        sentinel_for<std::tuple_element_t<1, T>,  std::tuple_element_t<0, T>>,
-        std::true_type>;
-};
+NANO_END_NAMESPACE
 
-template <typename T>
-NANO_CONCEPT iterator_sentinel_pair =
-    decltype(iterator_sentinel_pair_concept::test<T>(0))::value;
+#endif
 
-template <typename I, typename S, bool StoreSize = false>
-struct subrange_data {
-    constexpr subrange_data() = default;
 
-    constexpr subrange_data(I&& begin, S&& end)
-        : begin_(std::move(begin)), end_(std::move(end))
-    {}
 
-    constexpr subrange_data(I&& begin, S&& end, iter_difference_t<I> /*unused*/)
-        : begin_(std::move(begin)), end_(std::move(end))
-    {}
+NANO_BEGIN_NAMESPACE
 
-    I begin_{};
-    S end_{};
-};
+template <typename I1, typename I2, typename O>
+using merge_result = in_in_out_result<I1, I2, O>;
 
-template <typename I, typename S>
-struct subrange_data<I, S, true> {
-    constexpr subrange_data() = default;
+namespace detail {
 
-    constexpr subrange_data(I&& begin, S&& end, iter_difference_t<I> size)
-        : begin_(std::move(begin)), end_(std::move(end)), size_(size)
-    {}
-
-    I begin_{};
-    S end_{};
-    iter_difference_t<I> size_ = 0;
-};
-
-// MSVC gets confused if enable_if conditions in template param lists are too
-// complex, so give it some help by calculating the constraints in a helper
-// variable
-template <typename R, typename I, typename S, subrange_kind K>
-auto subrange_range_constructor_constraint_helper_fn(long) -> std::false_type;
+struct merge_fn {
+private:
+    template <typename I1, typename S1, typename I2, typename S2, typename O,
+              typename Comp, typename Proj1, typename Proj2>
+    static constexpr merge_result<I1, I2, O>
+    impl(I1 first1, S1 last1, I2 first2, S2 last2, O result, Comp& comp,
+         Proj1& proj1, Proj2& proj2)
+    {
+        // With random access, count how many elements in a row we take from
+        // each range so that we can gallop through long runs. The threshold
+        // adapts so that we stay within N - 1 comparisons for inputs whose
+        // runs are only a little longer than it.
+        [[maybe_unused]] std::ptrdiff_t run1 = 0;
+        [[maybe_unused]] std::ptrdiff_t run2 = 0;
+        [[maybe_unused]] std::ptrdiff_t threshold = gallop_threshold;
 
-template <typename R, typename I, typename S, subrange_kind K>
-auto subrange_range_constructor_constraint_helper_fn(int) -> std::enable_if_t<borrowed_range<R>&&
-                convertible_to_non_slicing<iterator_t<R>, I> &&
-                convertible_to<sentinel_t<R>, S>, std::true_type>;
+        while (first1 != last1) {
+            // If we've reached the end of the second range, copy any remaining
+            // elements from the first range directly
+            if (first2 == last2) {
+                auto res = nano::copy(std::move(first1),
+                                      std::move(last1),
+                                      std::move(result));
+                first1 = std::move(res.in);
+                result = std::move(res.out);
+                break;
+            }
 
-template <typename R, typename I, typename S, subrange_kind K>
-constexpr bool subrange_range_constructor_constraint_helper =
-    decltype(subrange_range_constructor_constraint_helper_fn<R, I, S, K>(0))::value;
+            // (Only) if the element from range2 compares less than the element
+            // from range1, copy it. Otherwise copy the element from the first
+            if (nano::invoke(comp, nano::invoke(proj2, *first2),
+                             nano::invoke(proj1, *first1))) {
+                *result = *first2;
+                ++first2;
+                ++result;
 
-template <typename R>
-constexpr subrange_kind subrange_deduction_guide_helper()
-{
-    return (sized_range<R> || sized_sentinel_for<sentinel_t<R>, iterator_t<R>>)
-           ? subrange_kind::sized : subrange_kind::unsized;
-}
+                if constexpr (is_gallop_candidate<I1, S1, I2, S2>) {
+                    run1 = 0;
+                    if (++run2 >= threshold) {
+                        // Copy the rest of the elements of range2 which are
+                        // less than this element of range1 in one go
+                        const I2 mid2 = detail::gallop(first2, last2, [&](auto&& y) {
+                            return nano::invoke(comp, nano::invoke(proj2, y),
+                                                nano::invoke(proj1, *first1));
+                        });
+                        threshold = detail::next_gallop_threshold(
+                            threshold, mid2 - first2);
+                        result = nano::copy(first2, mid2, std::move(result)).out;
+                        first2 = mid2;
+                        run2 = 0;
+
+                        // The gallop stopped at an element which isn't less
+                        // than this one, so this one comes next
+                        if (first2 != last2) {
+                            *result = *first1;
+                            ++first1;
+                            ++result;
+                            run1 = 1;
+                        }
+                    }
+                }
+            } else {
+                *result = *first1;
+                ++first1;
+                ++result;
 
-} // namespace detail
+                if constexpr (is_gallop_candidate<I1, S1, I2, S2>) {
+                    run2 = 0;
+                    if (++run1 >= threshold) {
+                        // Likewise, copy the rest of the elements of range1
+                        // which are not greater than this element of range2
+                        const I1 mid1 = detail::gallop(first1, last1, [&](auto&& x) {
+                            return !nano::invoke(comp, nano::invoke(proj2, *first2),
+                                                 nano::invoke(proj1, x));
+                        });
+                        threshold = detail::next_gallop_threshold(
+                            threshold, mid1 - first1);
+                        result = nano::copy(first1, mid1, std::move(result)).out;
+                        first1 = mid1;
+                        run1 = 0;
+
+                        if (first1 != last1) {
+                            *result = *first2;
+                            ++first2;
+                            ++result;
+                            run2 = 1;
+                        }
+                    }
+                }
+            }
+        }
 
-namespace subrange_ {
+        // We've reached the end of range1, so copy any remaining elements
+        // from range2
+        auto res = nano::copy(std::move(first2), std::move(last2),
+                              std::move(result));
+        first2 = std::move(res.in);
+        result = std::move(res.out);
 
-template <typename I, typename S, subrange_kind K>
-class subrange : public view_interface<subrange<I, S, K>> {
-    static_assert(input_or_output_iterator<I>);
-    static_assert(sentinel_for<S, I>);
-    static_assert(K == subrange_kind::sized || !sized_sentinel_for<S, I>, "");
+        return {std::move(first1), std::move(first2),  std::move(result)};
+    }
 
-private:
-    static constexpr bool StoreSize =
-            K == subrange_kind::sized && !sized_sentinel_for<S, I>;
+public:
+    template <typename I1, typename S1, typename I2, typename S2, typename O,
+              typename Comp = ranges::less, typename Proj1 = identity,
+              typename Proj2 = identity>
+    constexpr std::enable_if_t<input_iterator<I1> && sentinel_for<S1, I1> &&
+                                   input_iterator<I2> && sentinel_for<S2, I2> &&
+        weakly_incrementable<O> &&
+                                   mergeable<I1, I2, O, Comp, Proj1, Proj1>,
+        merge_result<I1, I2, O>>
+    operator()(I1 first1, S1 last1, I2 first2, S2 last2, O result,
+               Comp comp = Comp{}, Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
+    {
+        return merge_fn::impl(std::move(first1), std::move(last1),
+                              std::move(first2), std::move(last2),
+                              std::move(result), comp,
+                              proj1, proj2);
+    }
 
-    detail::subrange_data<I, S, StoreSize> data_{};
+    template <typename Rng1, typename Rng2, typename O, typename Comp = ranges::less,
+              typename Proj1 = identity, typename Proj2 = identity>
+    constexpr std::enable_if_t<
+        input_range<Rng1> && input_range<Rng2> &&
+        weakly_incrementable<O> &&
+            mergeable<iterator_t<Rng1>, iterator_t<Rng2>, O, Comp, Proj1, Proj2>,
+        merge_result<borrowed_iterator_t<Rng1>, borrowed_iterator_t<Rng2>, O>>
+    operator()(Rng1&& rng1, Rng2&& rng2, O result, Comp comp = Comp{},
+               Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
+    {
+        return merge_fn::impl(nano::begin(rng1), nano::end(rng1),
+                              nano::begin(rng2), nano::end(rng2),
+                              std::move(result), comp,
+                              proj1, proj2);
+    }
+};
 
-public:
-    subrange() = default;
+}
 
-    template <typename II, bool SS = StoreSize,
-             typename = std::enable_if_t<
-                 detail::convertible_to_non_slicing<II, I> &&
-                 !SS>>
-    constexpr subrange(II i, S s)
-            : data_{std::move(i), std::move(s)} {}
+NANO_INLINE_VAR(detail::merge_fn, merge)
 
-    template <typename II, subrange_kind KK = K,
-              typename = std::enable_if_t<
-                  detail::convertible_to_non_slicing<II, I> &&
-                  KK == subrange_kind::sized>>
-    constexpr subrange(II i, S s, iter_difference_t<I> n)
-            : data_{std::move(i), std::move(s), n} {}
+NANO_END_NAMESPACE
 
-    template <typename R, bool SS = StoreSize,
-            std::enable_if_t<detail::not_same_as<R, subrange>, int> = 0,
-            std::enable_if_t<
-                    detail::subrange_range_constructor_constraint_helper<R, I, S, K>
-                    && SS && sized_range<R>, int> = 0>
-    constexpr subrange(R&& r)
-            : subrange(ranges::begin(r), ranges::end(r), ranges::size(r)) {}
+#endif
 
-    template <typename R, bool SS = StoreSize,
-            std::enable_if_t<detail::not_same_as<R, subrange>, int> = 0,
-            std::enable_if_t<
-                    detail::subrange_range_constructor_constraint_helper<R, I, S, K>
-                     && !SS, int> = 0>
-    constexpr subrange(R&& r)
-            : subrange(ranges::begin(r), ranges::end(r)) {}
+// nanorange/algorithm/min.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
-    template <typename R, subrange_kind KK = K, std::enable_if_t<
-            borrowed_range<R> &&
-            detail::convertible_to_non_slicing<iterator_t<R>, I> &&
-            convertible_to<sentinel_t<R>, S> &&
-            KK == subrange_kind::sized, int> = 0>
-    constexpr subrange(R&& r, iter_difference_t<I> n)
-            : subrange(ranges::begin(r), ranges::end(r), n) {}
+#ifndef NANORANGE_ALGORITHM_MIN_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_MIN_HPP_INCLUDED
 
 
-    template <typename PairLike_,
-            std::enable_if_t<detail::not_same_as<PairLike_, subrange>, int> = 0,
-            std::enable_if_t<detail::pair_like_convertible_from<
-                                PairLike_, const I&, const S&>, int> = 0>
-    constexpr operator PairLike_() const
-    {
-        return PairLike_(begin(), end());
-    }
 
-    constexpr I begin() const { return data_.begin_; }
+NANO_BEGIN_NAMESPACE
 
-    constexpr S end() const { return data_.end_; }
+namespace detail {
 
-    [[nodiscard]] constexpr bool empty() const
+struct min_fn {
+private:
+    template <typename Rng, typename Comp, typename Proj>
+    static constexpr iter_value_t<iterator_t<Rng>>
+    impl(Rng&& rng, Comp& comp, Proj& proj)
     {
-        return data_.begin_ == data_.end_;
-    }
+        auto first = nano::begin(rng);
+        const auto last = nano::end(rng);
 
-    template <subrange_kind KK = K>
-    constexpr auto size() const
-        -> std::enable_if_t<KK == subrange_kind::sized, iter_difference_t<I>>
-    {
-        if constexpr (StoreSize) {
-            return data_.size_;
-        } else {
-            return data_.end_ - data_.begin_;
+        // Empty ranges not allowed
+        auto result = *first;
+
+        while(++first != last) {
+            auto&& val = *first;
+            if (nano::invoke(comp, nano::invoke(proj, val),
+                             nano::invoke(proj, result))) {
+                result = std::forward<decltype(val)>(val);
+            }
         }
+
+        return result;
     }
 
-    [[nodiscard]] constexpr subrange next(iter_difference_t<I> n = 1) const
+public:
+    template <typename T, typename Comp = ranges::less, typename Proj = identity>
+    constexpr std::enable_if_t<
+        indirect_strict_weak_order<Comp, projected<const T*, Proj>>,
+        const T&>
+    operator()(const T& a, const T& b, Comp comp = Comp{}, Proj proj = Proj{}) const
     {
-        auto tmp = *this;
-        tmp.advance(n);
-        return tmp;
+        return nano::invoke(comp, nano::invoke(proj, b),
+                            nano::invoke(proj, a)) ? b : a;
     }
 
-    template <typename II = I>
-    [[nodiscard]] constexpr auto prev(iter_difference_t<I> n = 1) const
-        -> std::enable_if_t<bidirectional_iterator<II>, subrange>
+    template <typename T, typename Comp = ranges::less, typename Proj = identity>
+    constexpr std::enable_if_t<
+        copyable<T> &&
+            indirect_strict_weak_order<Comp, projected<const T*, Proj>>,
+        T>
+    operator()(std::initializer_list<T> rng, Comp comp = Comp{},
+               Proj proj = Proj{}) const
     {
-        auto tmp = *this;
-        tmp.advance(-n);
-        return tmp;
+        return min_fn::impl(rng, comp, proj);
     }
 
-    constexpr subrange& advance(iter_difference_t<I> n)
+    template <typename Rng, typename Comp = ranges::less, typename Proj = identity>
+    constexpr std::enable_if_t<
+        input_range<Rng> && copyable<iter_value_t<iterator_t<Rng>>> &&
+            indirect_strict_weak_order<Comp, projected<iterator_t<Rng>, Proj>>,
+        range_value_t<Rng>>
+    operator()(Rng&& rng, Comp comp = Comp{}, Proj proj = Proj{}) const
     {
-        if constexpr (StoreSize) {
-            data_.size_ -= n - ranges::advance(data_.begin_, n, data_.end_);
-        } else {
-            ranges::advance(data_.begin_, n, data_.end_);
-        }
-        return *this;
+        return min_fn::impl(std::forward<Rng>(rng), comp, proj);
     }
 };
 
-template <typename I, typename S,
-          std::enable_if_t<input_or_output_iterator<I> && sentinel_for<S, I>, int> = 0>
-subrange(I, S) -> subrange<I, S>;
+}
 
-template <typename I, typename S, std::enable_if_t<input_or_output_iterator<I> && sentinel_for<S, I>, int> = 0>
-subrange(I, S, iter_difference_t<I>) -> subrange<I, S, subrange_kind::sized>;
+NANO_INLINE_VAR(detail::min_fn, min)
 
-template <typename P, std::enable_if_t<detail::iterator_sentinel_pair<P>, int> = 0>
-subrange(P) -> subrange<std::tuple_element_t<0, P>, std::tuple_element_t<1, P>>;
+NANO_END_NAMESPACE
 
-template <typename P, std::enable_if_t<detail::iterator_sentinel_pair<P>, int> = 0>
-subrange(P, iter_difference_t<std::tuple_element_t<0, P>>) ->
-    subrange<std::tuple_element_t<0, P>, std::tuple_element_t<1, P>, subrange_kind::sized>;
+#endif
 
-template <typename R, std::enable_if_t<borrowed_range<R>, int> = 0>
-subrange(R&&) ->
-    subrange<iterator_t<R>, sentinel_t<R>,
-             detail::subrange_deduction_guide_helper<R>()>;
+// nanorange/algorithm/move.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
-template <typename R, std::enable_if_t<borrowed_range<R>, int> = 0>
-subrange(R&&, iter_difference_t<iterator_t<R>>) ->
-    subrange<iterator_t<R>, sentinel_t<R>, subrange_kind::sized>;
+#ifndef NANORANGE_ALGORITHM_MOVE_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_MOVE_HPP_INCLUDED
 
-} // namespace subrange_
 
-template <typename I, typename S, subrange_kind K>
-inline constexpr bool enable_borrowed_range<subrange<I, S, K>> = true;
 
-template <std::size_t N, typename I, typename S, subrange_kind K,
-          std::enable_if_t<(N < 2), int> = 0>
-constexpr auto get(const subrange<I, S, K>& r)
-{
-    if constexpr (N == 0) {
-        return r.begin();
-    } else {
-        return r.end();
-    }
-}
 
-template <typename R>
-using borrowed_subrange_t =
-    detail::conditional_t<borrowed_range<R>, subrange<iterator_t<R>>, dangling>;
 
-NANO_END_NAMESPACE
+NANO_BEGIN_NAMESPACE
 
-namespace std {
+template <typename I, typename O>
+using move_result = in_out_result<I, O>;
 
-template <typename I, typename S, ::nano::subrange_kind K>
-class tuple_size<::nano::subrange<I, S, K>>
-    : public integral_constant<size_t, 2> {
-};
+namespace detail {
 
-template <typename I, typename S, ::nano::subrange_kind K>
-class tuple_element<0, ::nano::subrange<I, S, K>> {
-public:
-    using type = I;
-};
+struct move_fn {
+private:
+    // As copy(), moving a trivially copyable type is just a memmove()
+    template <typename I, typename S, typename O>
+    static constexpr std::enable_if_t<sized_sentinel_for<S, I> &&
+                                          is_memmove_movable<I, O>,
+                                      move_result<I, O>>
+    impl(I first, S last, O result, priority_tag<2>)
+    {
+        const auto dist = last - first;
 
-template <typename I, typename S, ::nano::subrange_kind K>
-class tuple_element<1, ::nano::subrange<I, S, K>> {
-public:
-    using type = S;
-};
+        if (!detail::is_constant_evaluated() && dist > 0) {
+            result = detail::memmove_n(first, dist, result);
+            return {first + dist, std::move(result)};
+        }
 
-using ::nano::ranges::get;
+        return impl(std::move(first), std::move(last), std::move(result),
+                    priority_tag<1>{});
+    }
 
-} // namespace std
+    template <typename I, typename S, typename O>
+    static constexpr std::enable_if_t<sized_sentinel_for<S, I>, move_result<I, O>>
+    impl(I first, S last, O result, priority_tag<1>)
+    {
+        const auto dist = last - first;
 
-#endif
+        for (iter_difference_t<I> i{0}; i < dist; i++) {
+            *result = nano::iter_move(first);
+            ++first;
+            ++result;
+        }
 
+        return {std::move(first), std::move(result)};
+    }
 
-NANO_BEGIN_NAMESPACE
+    template <typename I, typename S, typename O>
+    static constexpr move_result<I, O> impl(I first, S last, O result,
+                                            priority_tag<0>)
+    {
+        while (first != last) {
+            *result = nano::iter_move(first);
+            ++first;
+            ++result;
+        }
 
-namespace detail {
+        return {std::move(first), std::move(result)};
+    }
 
-struct equal_range_fn {
-private:
-    template <typename I, typename S, typename T, typename Comp, typename Proj>
-    static constexpr subrange<I> impl(I first, S last, const T& value,
-                                      Comp& comp, Proj& proj)
+    template <typename Rng, typename O>
+    static constexpr std::enable_if_t<
+        contiguous_range<Rng> && sized_range<Rng> &&
+            is_memmove_movable<range_pointer_t<Rng>, O>,
+        move_result<iterator_t<Rng>, O>>
+    range_impl(Rng& rng, O result, priority_tag<1>)
     {
-        return {lower_bound_fn::impl(first, last, value, comp, proj),
-                upper_bound_fn::impl(first, last, value, comp, proj)};
+        const auto dist = nano::distance(rng);
+
+        if (!detail::is_constant_evaluated() && dist > 0) {
+            result = detail::memmove_n(nano::data(rng), dist, result);
+            return {nano::begin(rng) + dist, std::move(result)};
+        }
+
+        return range_impl(rng, std::move(result), priority_tag<0>{});
+    }
+
+    template <typename Rng, typename O>
+    static constexpr move_result<iterator_t<Rng>, O>
+    range_impl(Rng& rng, O result, priority_tag<0>)
+    {
+        return move_fn::impl(nano::begin(rng), nano::end(rng),
+                             std::move(result), priority_tag<2>{});
     }
 
 public:
-    template <typename I, typename S, typename T, typename Comp = ranges::less,
-              typename Proj = identity>
-    std::enable_if_t<
-        forward_iterator<I> && sentinel_for<S, I> &&
-            indirect_strict_weak_order<Comp, const T*, projected<I, Proj>>,
-    subrange<I>>
-    constexpr operator()(I first, S last, const T& value, Comp comp = Comp{},
-               Proj proj = Proj{}) const
+    template <typename I, typename S, typename O>
+    constexpr std::enable_if_t<input_iterator<I> && sentinel_for<S, I> &&
+                                   weakly_incrementable<O> &&
+                                   indirectly_movable<I, O>,
+                               move_result<I, O>>
+    operator()(I first, S last, O result) const
     {
-        return equal_range_fn::impl(std::move(first), std::move(last),
-                                    value, comp, proj);
+        return move_fn::impl(std::move(first), std::move(last),
+                             std::move(result), priority_tag<2>{});
     }
 
-    template <typename Rng, typename T, typename Comp = ranges::less,
-              typename Proj = identity>
-    std::enable_if_t<forward_range<Rng> &&
-                         indirect_strict_weak_order<Comp, const T*, projected<iterator_t<Rng>, Proj>>,
-                     borrowed_subrange_t<Rng>>
-    constexpr operator()(Rng&& rng, const T& value, Comp comp = Comp{},
-                         Proj proj = Proj{}) const
+    template <typename Rng, typename O>
+    constexpr std::enable_if_t<input_range<Rng> && weakly_incrementable<O> &&
+                                   indirectly_movable<iterator_t<Rng>, O>,
+                               move_result<borrowed_iterator_t<Rng>, O>>
+    operator()(Rng&& rng, O result) const
     {
-        return equal_range_fn::impl(nano::begin(rng), nano::end(rng),
-                                    value, comp, proj);
+        return move_fn::range_impl(rng, std::move(result), priority_tag<1>{});
     }
 };
 
-}
-
-NANO_INLINE_VAR(detail::equal_range_fn, equal_range)
+} // namespace detail
 
-NANO_END_NAMESPACE
+NANO_INLINE_VAR(detail::move_fn, move)
 
-#endif
+template <typename I, typename O>
+using move_backward_result = in_out_result<I, O>;
 
-// nanorange/algorithm/fill.hpp
-//
-// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
-// Distributed under the Boost Software License, Version 1.0. (See accompanying
-// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+namespace detail {
 
-#ifndef NANORANGE_ALGORITHM_FILL_HPP_INCLUDED
-#define NANORANGE_ALGORITHM_FILL_HPP_INCLUDED
+struct move_backward_fn {
+private:
+    template <typename I, typename O>
+    static constexpr move_backward_result<I, O> impl(I first, I last, O result)
+    {
+        if constexpr (is_memmove_movable<I, O>) {
+            const auto dist = last - first;
 
+            if (!detail::is_constant_evaluated() && dist > 0) {
+                result = detail::memmove_backward_n(last, dist, result);
+                return {std::move(last), std::move(result)};
+            }
+        }
 
+        auto it = last;
 
-NANO_BEGIN_NAMESPACE
+        while (it != first) {
+            *--result = nano::iter_move(--it);
+        }
 
-namespace detail {
+        return {std::move(last), std::move(result)};
+    }
 
-struct fill_fn {
-private:
-    template <typename T, typename O, typename S>
-    static constexpr O impl(O first, S last, const T& value)
+    template <typename I, typename S, typename O>
+    static constexpr std::enable_if_t<!same_as<I, S>, move_backward_result<I, O>>
+    impl(I first, S sent, O result)
     {
-        while (first != last) {
-            *first = value;
-            ++first;
-        }
-
-        return first;
+        I last = nano::next(first, sent);
+        return impl(std::move(first), std::move(last), std::move(result));
     }
 
 public:
-    template <typename T, typename O, typename S>
+    template <typename I, typename S, typename O>
     constexpr std::enable_if_t<
-        output_iterator<O, const T&> && sentinel_for<S, O>, O>
-    operator()(O first, S last, const T& value) const
+        bidirectional_iterator<I> && sentinel_for<S, I> &&
+            bidirectional_iterator<O> && indirectly_movable<I, O>,
+                               move_backward_result<I, O>>
+    operator()(I first, S last, O result) const
     {
-        return fill_fn::impl(std::move(first), std::move(last), value);
+        return move_backward_fn::impl(std::move(first), std::move(last),
+                                      std::move(result));
     }
 
-    template <typename T, typename Rng>
-    constexpr std::enable_if_t<output_range<Rng, const T&>,
-                               borrowed_iterator_t<Rng>>
-    operator()(Rng&& rng, const T& value) const
+    template <typename Rng, typename O>
+    constexpr std::enable_if_t<bidirectional_range<Rng> &&
+                                   bidirectional_iterator<O> &&
+                                   indirectly_movable<iterator_t<Rng>, O>,
+                               move_backward_result<borrowed_iterator_t<Rng>, O>>
+    operator()(Rng&& rng, O result) const
     {
-        return fill_fn::impl(nano::begin(rng), nano::end(rng), value);
+        return move_backward_fn::impl(nano::begin(rng), nano::end(rng),
+                                      std::move(result));
     }
 };
 
 } // namespace detail
 
-NANO_INLINE_VAR(detail::fill_fn, fill)
+NANO_INLINE_VAR(detail::move_backward_fn, move_backward)
 
 NANO_END_NAMESPACE
 
 #endif
 
-// nanorange/algorithm/fill_n.hpp
+// nanorange/algorithm/rotate.hpp
 //
 // Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
 // Distributed under the Boost Software License, Version 1.0. (See accompanying
 // file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
-#ifndef NANORANGE_ALGORITHM_FILL_N_HPP_INCLUDED
-#define NANORANGE_ALGORITHM_FILL_N_HPP_INCLUDED
-
-
-
-NANO_BEGIN_NAMESPACE
-
-namespace detail {
-
-struct fill_n_fn {
-    template <typename T, typename O>
-    constexpr std::enable_if_t<output_iterator<O, const T&>, O>
-    operator()(O first, iter_difference_t<O> n, const T& value) const
-    {
-        for (iter_difference_t<O> i{0}; i < n; ++i, ++first) {
-            *first = value;
-        }
-        return first;
-    }
-};
-
-} // namespace detail
-
-NANO_INLINE_VAR(detail::fill_n_fn, fill_n)
-
-NANO_END_NAMESPACE
+#ifndef NANORANGE_ALGORITHM_ROTATE_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_ROTATE_HPP_INCLUDED
 
-#endif
 
-// nanorange/algorithm/find.hpp
+// nanorange/algorithm/swap_ranges.hpp
 //
 // Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
 // Distributed under the Boost Software License, Version 1.0. (See accompanying
 // file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
-#ifndef NANORANGE_ALGORITHM_FIND_HPP_INCLUDED
-#define NANORANGE_ALGORITHM_FIND_HPP_INCLUDED
+#ifndef NANORANGE_ALGORITHM_SWAP_RANGES_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_SWAP_RANGES_HPP_INCLUDED
+
 
 
 
 NANO_BEGIN_NAMESPACE
 
-// [ranges.alg.find]
+template <typename I1, typename I2>
+using swap_ranges_result = in_in_result<I1, I2>;
 
 namespace detail {
 
-struct find_if_fn {
-private:
-    friend struct find_fn;
-    friend struct find_if_not_fn;
-
-    template <typename I, typename S, typename Pred, typename Proj>
-    static constexpr I impl(I first, S last, Pred& pred, Proj& proj)
-    {
-        while (first != last) {
-            if (nano::invoke(pred, nano::invoke(proj, *first))) {
-                return first;
-            }
-            ++first;
+struct swap_ranges_fn {
+    template <typename I1, typename S1, typename I2, typename S2>
+    static constexpr swap_ranges_result<I1, I2>
+    impl4(I1 first1 ,S1 last1, I2 first2, S2 last2)
+    {
+        while (first1 != last1 && first2 != last2) {
+            nano::iter_swap(first1, first2);
+            ++first1; ++first2;
         }
-        return first;
+        return {std::move(first1), std::move(first2)};
+    }
+
+    template <typename I1, typename S1, typename I2>
+    static constexpr swap_ranges_result<I1, I2>
+    impl3(I1 first1, S1 last1, I2 first2)
+    {
+        while (first1 != last1) {
+            nano::iter_swap(first1, first2);
+            ++first1; ++first2;
+        }
+        return {std::move(first1), std::move(first2)};
     }
 
 public:
-    template <typename I, typename S, typename Proj = identity, typename Pred>
+    template <typename I1, typename S1, typename I2, typename S2>
     constexpr std::enable_if_t<
-        input_iterator<I> && sentinel_for<S, I> &&
-            indirect_unary_predicate<Pred, projected<I, Proj>>,
-        I>
-    operator()(I first, S last, Pred pred, Proj proj = Proj{}) const
+        forward_iterator<I1> && sentinel_for<S1, I1> && forward_iterator<I2> &&
+            sentinel_for<S2, I2> && indirectly_swappable<I1, I2>,
+        swap_ranges_result<I1, I2>>
+    operator()(I1 first1 ,S1 last1, I2 first2, S2 last2) const
     {
-        return find_if_fn::impl(std::move(first), std::move(last), pred, proj);
+        return swap_ranges_fn::impl4(std::move(first1), std::move(last1),
+                                     std::move(first2), std::move(last2));
     }
 
-    template <typename Rng, typename Proj = identity, typename Pred>
+    template <typename I1, typename S1, typename I2>
+    NANO_DEPRECATED
     constexpr std::enable_if_t<
-        input_range<Rng> &&
-            indirect_unary_predicate<Pred, projected<iterator_t<Rng>, Proj>>,
-        borrowed_iterator_t<Rng>>
-    operator()(Rng&& rng, Pred pred, Proj proj = Proj{}) const
+        forward_iterator<I1> && sentinel_for<S1, I1> && forward_iterator<I2> &&
+            indirectly_swappable<I1, I2>,
+            swap_ranges_result<I1, I2>>
+    operator()(I1 first1 ,S1 last1, I2 first2) const
     {
-        return find_if_fn::impl(nano::begin(rng), nano::end(rng), pred, proj);
+        return swap_ranges_fn::impl3(std::move(first1), std::move(last1),
+                                     std::move(first2));
     }
-};
-} // namespace detail
-
-NANO_INLINE_VAR(detail::find_if_fn, find_if)
-
-namespace detail {
 
-struct find_fn {
-    template <typename I, typename S, typename T, typename Proj = identity>
+    template <typename Rng1, typename Rng2>
     constexpr std::enable_if_t<
-        input_iterator<I> && sentinel_for<S, I> &&
-            indirect_relation<ranges::equal_to, projected<I, Proj>, const T*>,
-        I>
-    operator()(I first, S last, const T& value, Proj proj = Proj{}) const
+        forward_range<Rng1> && forward_range<Rng2> &&
+            indirectly_swappable<iterator_t<Rng1>, iterator_t<Rng2>>,
+            swap_ranges_result<borrowed_iterator_t<Rng1>,
+                           borrowed_iterator_t<Rng2>>>
+    operator()(Rng1&& rng1, Rng2&& rng2) const
     {
-        const auto pred = [&value] (const auto& t) { return t == value; };
-        return find_if_fn::impl(std::move(first), std::move(last), pred, proj);
+        return swap_ranges_fn::impl4(nano::begin(rng1), nano::end(rng1),
+                                     nano::begin(rng2), nano::end(rng2));
     }
 
-    template <typename Rng, typename T, typename Proj = identity>
+    template <typename Rng1, typename I2>
+    NANO_DEPRECATED
     constexpr std::enable_if_t<
-        input_range<Rng> &&
-            indirect_relation<ranges::equal_to, projected<iterator_t<Rng>, Proj>,
-                             const T*>,
-        borrowed_iterator_t<Rng>>
-    operator()(Rng&& rng, const T& value, Proj proj = Proj{}) const
+        forward_range<Rng1> && forward_iterator<I2> &&
+            indirectly_swappable<iterator_t<Rng1>, I2>,
+            swap_ranges_result<borrowed_iterator_t<Rng1>, I2>>
+    operator()(Rng1&& rng1, I2 first2) const
     {
-        const auto pred = [&value] (const auto& t) { return t == value; };
-        return find_if_fn::impl(nano::begin(rng), nano::end(rng), pred, proj);
+        return swap_ranges_fn::impl3(nano::begin(rng1), nano::end(rng1),
+                                     std::move(first2));
     }
 };
-} // namespace detail
 
-NANO_INLINE_VAR(detail::find_fn, find)
+}
 
-namespace detail {
+NANO_INLINE_VAR(detail::swap_ranges_fn, swap_ranges)
 
-struct find_if_not_fn {
-private:
-    template <typename Pred>
-    struct not_pred {
-        Pred& p;
+NANO_END_NAMESPACE
 
-        template <typename T>
-        constexpr bool operator()(T&& t) const
-        {
-            return !nano::invoke(p, std::forward<T>(t));
-        }
-    };
+#endif
 
-public:
-    template <typename I, typename S, typename Proj = identity, typename Pred>
-    constexpr std::enable_if_t<
-        input_iterator<I> && sentinel_for<S, I> &&
-            indirect_unary_predicate<Pred, projected<I, Proj>>,
-        I>
-    operator()(I first, S last, Pred pred, Proj proj = Proj{}) const
+// nanorange/iterator/unreachable.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_ITERATOR_UNREACHABLE_HPP_INCLUDED
+#define NANORANGE_ITERATOR_UNREACHABLE_HPP_INCLUDED
+
+
+
+NANO_BEGIN_NAMESPACE
+
+// [range.unreachable.sentinels]
+
+struct unreachable_sentinel_t {
+    template<typename I>
+    friend constexpr std::enable_if_t<weakly_incrementable<I>, bool>
+    operator==(const I &, unreachable_sentinel_t) noexcept
     {
-        const auto find_if_pred = not_pred<Pred>{pred};
-        return find_if_fn::impl(std::move(first), std::move(last),
-                                find_if_pred, proj);
+        return false;
     }
 
-    template <typename Rng, typename Proj = identity, typename Pred>
-    constexpr std::enable_if_t<
-        input_range<Rng> &&
-            indirect_unary_predicate<Pred, projected<iterator_t<Rng>, Proj>>,
-        borrowed_iterator_t<Rng>>
-    operator()(Rng&& rng, Pred pred, Proj proj = Proj{}) const
+    template<typename I>
+    friend constexpr std::enable_if_t<weakly_incrementable<I>, bool>
+    operator==(unreachable_sentinel_t, const I &) noexcept
     {
-        const auto find_if_pred = not_pred<Pred>{pred};
-        return find_if_fn::impl(nano::begin(rng), nano::end(rng),
-                                find_if_pred, proj);
+        return false;
+    }
+
+    template<typename I>
+    friend constexpr std::enable_if_t<weakly_incrementable<I>, bool>
+    operator!=(const I &, unreachable_sentinel_t) noexcept
+    {
+        return true;
+    }
+
+    template<typename I>
+    friend constexpr std::enable_if_t<weakly_incrementable<I>, bool>
+    operator!=(unreachable_sentinel_t, const I &) noexcept
+    {
+        return true;
     }
 };
-} // namespace detail
 
-NANO_INLINE_VAR(detail::find_if_not_fn, find_if_not)
+inline constexpr unreachable_sentinel_t unreachable_sentinel{};
 
 NANO_END_NAMESPACE
 
 #endif
 
-// nanorange/algorithm/find_end.hpp
+// nanorange/views/subrange.hpp
 //
 // Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
 // Distributed under the Boost Software License, Version 1.0. (See accompanying
 // file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
-#ifndef NANORANGE_ALGORITHM_FIND_END_HPP_INCLUDED
-#define NANORANGE_ALGORITHM_FIND_END_HPP_INCLUDED
+#ifndef NANORANGE_VIEWS_SUBRANGE_HPP_INCLUDED
+#define NANORANGE_VIEWS_SUBRANGE_HPP_INCLUDED
+
 
+// nanorange/views/interface.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
+#ifndef NANORANGE_VIEWS_INTERFACE_HPP_INCLUDED
+#define NANORANGE_VIEWS_INTERFACE_HPP_INCLUDED
 
-// nanorange/algorithm/search.hpp
+
+// nanorange/iterator/common_iterator.hpp
 //
 // Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
 // Distributed under the Boost Software License, Version 1.0. (See accompanying
 // file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
-#ifndef NANORANGE_ALGORITHM_SEARCH_HPP_INCLUDED
-#define NANORANGE_ALGORITHM_SEARCH_HPP_INCLUDED
+#ifndef NANORANGE_ITERATOR_COMMON_ITERATOR_HPP_INCLUDED
+#define NANORANGE_ITERATOR_COMMON_ITERATOR_HPP_INCLUDED
+
+// nanorange/iterator/concepts.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_ITERATOR_CONCEPTS_HPP_INCLUDED
+#define NANORANGE_ITERATOR_CONCEPTS_HPP_INCLUDED
+
 
 
 
 
+#endif
+
+
 NANO_BEGIN_NAMESPACE
 
-namespace detail {
+// [range.iterators.common]
 
-struct search_fn {
-private:
-    friend struct find_end_fn;
+namespace common_iterator_ {
 
-    template <typename I1, typename S1, typename I2, typename S2,
-              typename Pred, typename Proj1, typename Proj2 = identity>
-    static constexpr subrange<I1>
-    impl(I1 first1, S1 last1, I2 first2, S2 last2, Pred& pred, Proj1& proj1,
-         Proj2& proj2)
-    {
-        while (true) {
-            auto it1 = first1;
-            auto it2 = first2;
+template <typename I, typename S>
+class common_iterator {
+    static_assert(input_or_output_iterator<I>, "");
+    static_assert(sentinel_for<S, I>, "");
+    static_assert(!same_as<I, S>, "");
 
-            while (true) {
-                if (it2 == last2) {
-                    return {first1, it1};
-                }
-                if (it1 == last1) {
-                    return {it1, it1};
-                }
-                if (!nano::invoke(pred, nano::invoke(proj1, *it1), nano::invoke(proj2, *it2))) {
-                    break;
-                }
-                ++it1; ++it2;
-            }
+    template <typename II, typename SS>
+    friend class common_iterator;
 
+    class op_arrow_proxy {
+        iter_value_t<I> keep_;
 
-            ++first1;
+        constexpr op_arrow_proxy(iter_reference_t<I>&& x) : keep_(std::move(x)) {}
+
+    public:
+        constexpr const iter_value_t<I>* operator->() const
+        {
+            return std::addressof(keep_);
         }
-    }
+    };
 
-public:
-    template <typename I1, typename S1, typename I2, typename S2,
-              typename Pred = ranges::equal_to, typename Proj1 = identity,
-              typename Proj2 = identity>
-    constexpr std::enable_if_t<
-        forward_iterator<I1> && sentinel_for<S1, I1> && forward_iterator<I2> &&
-            sentinel_for<S2, I2> &&
-            indirectly_comparable<I1, I2, Pred, Proj1, Proj2>,
-         subrange<I1>>
-    operator()(I1 first1, S1 last1, I2 first2, S2 last2,
-               Pred pred = Pred{}, Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
+    template <typename II>
+    using op_arrow_t = decltype(std::declval<const II&>().operator->());
+
+    template <typename II>
+    static constexpr auto do_op_arrow(const II& i, detail::priority_tag<2>)
+        -> std::enable_if_t<
+            std::is_pointer<II>::value || detail::exists_v<op_arrow_t, II>, I>
     {
-        return search_fn::impl(std::move(first1), std::move(last1),
-                               std::move(first2), std::move(last2),
-                               pred, proj1, proj2);
+        return i;
     }
 
-    template <typename Rng1, typename Rng2, typename Pred = ranges::equal_to,
-              typename Proj1 = identity, typename Proj2 = identity>
-    constexpr std::enable_if_t<
-        forward_range<Rng1> && forward_range<Rng2> &&
-            indirectly_comparable<iterator_t<Rng1>, iterator_t<Rng2>, Pred, Proj1, Proj2>,
-        borrowed_subrange_t<Rng1>>
-    operator()(Rng1&& rng1, Rng2&& rng2, Pred pred = Pred{},
-               Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
+    template <typename II>
+    static constexpr auto do_op_arrow(const II& i, detail::priority_tag<1>)
+        -> std::enable_if_t<std::is_reference<iter_reference_t<const II>>::value,
+                            std::add_pointer_t<iter_reference_t<const II>>>
     {
-        return search_fn::impl(nano::begin(rng1), nano::end(rng1),
-                               nano::begin(rng2), nano::end(rng2),
-                               pred, proj1, proj2);
+        auto&& tmp = *i;
+        return std::addressof(tmp);
     }
-};
 
-}
+    template <typename II>
+    static constexpr auto do_op_arrow(const II& i, detail::priority_tag<0>)
+        -> op_arrow_proxy
+    {
+        return {i};
+    }
 
-NANO_INLINE_VAR(detail::search_fn, search)
+public:
+    using difference_type = iter_difference_t<I>;
 
-NANO_END_NAMESPACE
+    constexpr common_iterator() : is_sentinel_{false}, iter_{} {}
 
-#endif
+    constexpr common_iterator(I i) : is_sentinel_{false}, iter_(i) {}
 
-NANO_BEGIN_NAMESPACE
+    constexpr common_iterator(S s) : is_sentinel_{true}, sentinel_{s} {}
 
-// [ranges.alg.find.end]
-namespace detail {
+    template <
+        typename II, typename SS,
+        std::enable_if_t<convertible_to<II, I> && convertible_to<SS, S>, int> = 0>
+    constexpr common_iterator(const common_iterator<II, SS>& other)
+        : is_sentinel_{other.is_sentinel_},
+          iter_(other.iter_),
+          sentinel_(other.sentinel_)
+    {}
 
-// TODO: For BiDir iterators, we can be smarter and search backwards
-struct find_end_fn {
-private:
-    template <typename I1, typename S1, typename I2, typename S2,
-              typename Pred, typename Proj1, typename Proj2>
-    static constexpr subrange<I1>
-    impl(I1 first1, S1 last1, I2 first2, S2 last2, Pred& pred, Proj1& proj1,
-         Proj2& proj2)
+    template <typename II, typename SS>
+    constexpr std::enable_if_t<convertible_to<II, I> && convertible_to<SS, S>,
+                               common_iterator&>
+    operator=(const common_iterator<II, SS>& other)
     {
-        if (first2 == last2) {
-            auto last_it = nano::next(first1, last1);
-            return {last_it, last_it};
-        }
-
-        auto result = search_fn::impl(std::move(first1), last1, first2, last2, pred, proj1, proj2);
+        is_sentinel_ = other.is_sentinel_;
+        iter_ = other.iter_;
+        sentinel_ = other.sentinel_;
+        return *this;
+    }
 
-        if (result.empty()) {
-            return result;
-        }
+    constexpr decltype(auto) operator*() { return *iter_; }
 
-        while (true) {
-            auto new_result = search_fn::impl(next(result.begin()), last1, first2, last2, pred, proj1, proj2);
-            if (new_result.empty()) {
-                return result;
-            } else {
-                result = std::move(new_result);
-            }
-        }
+    template <typename II = I,
+              std::enable_if_t<detail::dereferenceable<const I>, int> = 0>
+    constexpr decltype(auto) operator*() const
+    {
+        return *iter_;
     }
 
-public:
-    template <typename I1, typename S1, typename I2, typename S2,
-            typename Pred = ranges::equal_to, typename Proj1 = identity,
-            typename Proj2 = identity>
-    constexpr std::enable_if_t<
-        forward_iterator<I1> && sentinel_for<S1, I1> && forward_iterator<I2> &&
-            sentinel_for<S2, I2> &&
-            indirectly_comparable<I1, I2, Pred, Proj1, Proj2>,
-        subrange<I1>>
-    operator()(I1 first1, S1 last1, I2 first2, S2 last2, Pred pred = Pred{},
-               Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
+    template <typename II = I>
+    constexpr auto operator-> () const
+        -> decltype(common_iterator::do_op_arrow(std::declval<const II&>(),
+                                                 detail::priority_tag<2>{}))
     {
-        return find_end_fn::impl(std::move(first1), std::move(last1),
-                                 std::move(first2), std::move(last2),
-                                 pred, proj1, proj2);
+        return do_op_arrow(iter_, detail::priority_tag<2>{});
     }
 
-    template <typename Rng1, typename Rng2, typename Pred = ranges::equal_to,
-              typename Proj1 = identity, typename Proj2 = identity>
-    constexpr std::enable_if_t<
-        forward_range<Rng1> && forward_range<Rng2> &&
-            indirectly_comparable<iterator_t<Rng1>, iterator_t<Rng2>, Pred, Proj1, Proj2>,
-        borrowed_subrange_t<Rng1>>
-    operator()(Rng1&& rng1, Rng2&& rng2, Pred pred = Pred{},
-               Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
+    constexpr common_iterator& operator++()
     {
-        return find_end_fn::impl(nano::begin(rng1), nano::end(rng1),
-                                 nano::begin(rng2), nano::end(rng2),
-                                 pred, proj1, proj2);
+        ++iter_;
+        return *this;
     }
 
-};
-
-}
-
-NANO_INLINE_VAR(detail::find_end_fn, find_end)
-
-NANO_END_NAMESPACE
-
-#endif
-
-// nanorange/algorithm/find_first_of.hpp
-//
-// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
-// Distributed under the Boost Software License, Version 1.0. (See accompanying
-// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
-
-#ifndef NANORANGE_ALGORITHM_FIND_FIRST_OF_HPP_INCLUDED
-#define NANORANGE_ALGORITHM_FIND_FIRST_OF_HPP_INCLUDED
-
-
+    template <typename II = I, std::enable_if_t<!forward_iterator<II>, int> = 0>
+    constexpr  decltype(auto) operator++(int)
+    {
+        return iter_++;
+    }
 
-NANO_BEGIN_NAMESPACE
+    template <typename II = I, std::enable_if_t<forward_iterator<II>, int> = 0>
+    constexpr common_iterator operator++(int)
+    {
+        common_iterator tmp = *this;
+        ++iter_;
+        return tmp;
+    }
 
-// [range.alg.find.first.of]
+    template <typename I2, typename S2>
+    friend constexpr auto operator==(const common_iterator& x,
+                                     const common_iterator<I2, S2>& y)
+        -> std::enable_if_t<sentinel_for<S2, I> && sentinel_for<S, I2> &&
+                            !equality_comparable_with<I, I2>, bool>
+    {
+        return x.is_sentinel_ ? (y.is_sentinel_ || y.iter_ == x.sentinel_)
+                              : (!y.is_sentinel_ || x.iter_ == y.sentinel_);
+    }
 
-namespace detail {
+    template <typename I2, typename S2>
+    friend constexpr auto operator==(const common_iterator& x,
+                                     const common_iterator<I2, S2>& y)
+        -> std::enable_if_t<sentinel_for<S2, I> && sentinel_for<S, I2> &&
+                            equality_comparable_with<I, I2>, bool>
+    {
+        return x.is_sentinel_
+               ? (y.is_sentinel_ || y.iter_ == x.sentinel_)
+               : (y.is_sentinel_ ? x.iter_ == y.sentinel_ : x.iter_ == y.iter_);
+    }
 
-struct find_first_of_fn {
-private:
-    template <typename I1, typename S1, typename I2, typename S2, typename Pred,
-              typename Proj1, typename Proj2>
-    static constexpr I1 impl(I1 first1, S1 last1, I2 first2, S2 last2,
-                             Pred& pred, Proj1& proj1, Proj2& proj2)
+    template <typename I2, typename S2>
+    friend constexpr auto operator!=(const common_iterator& x,
+                                     const common_iterator<I2, S2>& y)
+        -> std::enable_if_t<sentinel_for<S2, I> && sentinel_for<S, I2>, bool>
     {
-        for (; first1 != last1; ++first1) {
-            for (I2 it = first2; it != last2; ++it) {
-                if (nano::invoke(pred, nano::invoke(proj1, *first1),
-                                 nano::invoke(proj2, *it))) {
-                    return first1;
-                }
-            }
-        }
+        return !(x == y);
+    }
 
-        return first1;
+    template <typename I2, typename S2>
+    friend constexpr auto operator-(const common_iterator& x,
+                                    const common_iterator<I2, S2>& y)
+        -> std::enable_if_t<sized_sentinel_for<I, I2> && sized_sentinel_for<S, I2> &&
+                            sized_sentinel_for<S, I2>, iter_difference_t<I2>>
+    {
+        return x.is_sentinel_
+               ? (y.is_sentinel_ ? 0 : x.sentinel_ - y.iter_)
+               : (y.is_sentinel_ ? x.iter_ - y.sentinel_ : x.iter_ - y.iter_);
     }
 
-public:
-    template <typename I1, typename S1, typename I2, typename S2,
-              typename Proj1 = identity, typename Proj2 = identity,
-              typename Pred = ranges::equal_to>
-    constexpr std::enable_if_t<
-        input_iterator<I1> && sentinel_for<S1, I1> && forward_iterator<I2> &&
-            sentinel_for<S2, I2> &&
-            indirect_relation<Pred, projected<I1, Proj1>, projected<I2, Proj2>>,
-        I1>
-    operator()(I1 first1, S1 last1, I2 first2, S2 last2, Pred pred = Pred{},
-               Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
+    friend constexpr iter_rvalue_reference_t<I> iter_move(const common_iterator& i)
     {
-        return find_first_of_fn::impl(std::move(first1), std::move(last1),
-                                      std::move(first2), std::move(last2),
-                                      pred, proj1, proj2);
+        return ranges::iter_move(i.iter_);
     }
 
-    template <typename Rng1, typename Rng2, typename Proj1 = identity,
-              typename Proj2 = identity, typename Pred = ranges::equal_to>
-    constexpr std::enable_if_t<
-        input_range<Rng1> && forward_range<Rng2> &&
-            indirect_relation<Pred, projected<iterator_t<Rng1>, Proj1>,
-                             projected<iterator_t<Rng2>, Proj2>>,
-        borrowed_iterator_t<Rng1>>
-    operator()(Rng1&& rng1, Rng2&& rng2, Pred pred = Pred{},
-               Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
+    template <typename I2, typename S2>
+    friend constexpr std::enable_if_t<indirectly_swappable<I2, I>>
+    iter_swap(const common_iterator& x, const common_iterator<I2, S2>& y)
     {
-        return find_first_of_fn::impl(nano::begin(rng1), nano::end(rng1),
-                                      nano::begin(rng2), nano::end(rng2),
-                                      pred, proj1, proj2);
+        return ranges::iter_swap(x.iter_, y.iter_);
     }
+
+    // private:
+    // TODO: Some sort of variant-like union
+    bool is_sentinel_{};
+    I iter_{};
+    S sentinel_{};
 };
 
-} // namespace detail
+} // namespace common_iterator_
 
-NANO_INLINE_VAR(detail::find_first_of_fn, find_first_of)
+using common_iterator_::common_iterator;
 
-NANO_END_NAMESPACE
+template <typename I, typename S>
+struct readable_traits<common_iterator<I, S>> {
+    using value_type = iter_value_t<I>;
+};
 
-#endif
-// nanorange/algorithm/for_each.hpp
-//
-// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
-// Distributed under the Boost Software License, Version 1.0. (See accompanying
-// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+template <typename I, typename S>
+struct iterator_category<common_iterator<I, S>>
+    : std::conditional<forward_iterator<I>, forward_iterator_tag,
+                       input_iterator_tag> {
+};
 
-#ifndef NANORANGE_ALGORITHM_FOR_EACH_HPP_INCLUDED
-#define NANORANGE_ALGORITHM_FOR_EACH_HPP_INCLUDED
+NANO_END_NAMESPACE
+
+namespace std {
+
+template <typename I, typename S>
+struct iterator_traits<::nano::common_iterator<I, S>> {
+    using difference_type =
+        ::nano::iter_difference_t<::nano::common_iterator<I, S>>;
+    using value_type = ::nano::iter_value_t<::nano::common_iterator<I, S>>;
+    using pointer =
+        std::add_pointer_t<::nano::iter_reference_t<::nano::common_iterator<I, S>>>;
+    using reference = ::nano::iter_reference_t<::nano::common_iterator<I, S>>;
+    using iterator_category =
+        ::nano::detail::conditional_t<::nano::forward_iterator<I>,
+                           std::forward_iterator_tag,
+                           std::input_iterator_tag>;
+};
+
+} // namespace std
 
+#endif
 
 
 
 NANO_BEGIN_NAMESPACE
 
-// [range.alg.foreach]
-
-template <typename I, typename F>
-using for_each_result = in_fun_result<I, F>;
+// [ranges.view_interface]
 
 namespace detail {
 
-struct for_each_fn {
+template <typename, typename = void>
+struct range_common_iterator_impl;
+
+template <typename R>
+struct range_common_iterator_impl<
+    R, std::enable_if_t<range<R> && !common_range<R>>> {
+    using type = common_iterator<iterator_t<R>, sentinel_t<R>>;
+};
+
+template <typename R>
+struct range_common_iterator_impl<R, std::enable_if_t<common_range<R>>> {
+    using type = iterator_t<R>;
+};
+
+template <typename R>
+using range_common_iterator_t = typename range_common_iterator_impl<R>::type;
+
+} // namespace detail
+
+template <typename D>
+class view_interface : public view_base {
+
+    static_assert(std::is_class<D>::value, "");
+    static_assert(same_as<D, std::remove_cv_t<D>>, "");
+
 private:
-    template <typename I, typename S, typename Proj, typename Fun>
-    static constexpr for_each_result<I, Fun>
-    impl(I first, S last, Fun& fun, Proj& proj)
+    constexpr D& derived() noexcept { return static_cast<D&>(*this); }
+
+    constexpr const D& derived() const noexcept
     {
-        while (first != last) {
-            nano::invoke(fun, nano::invoke(proj, *first));
-            ++first;
-        }
-        return {first, std::move(fun)};
+        return static_cast<const D&>(*this);
     }
 
 public:
-    template <typename I, typename S, typename Proj = identity, typename Fun>
-    constexpr std::enable_if_t<
-        input_iterator<I> && sentinel_for<S, I> &&
-            indirect_unary_invocable<Fun, projected<I, Proj>>,
-        for_each_result<I, Fun>>
-    operator()(I first, S last, Fun fun, Proj proj = Proj{}) const
+    template <typename R = D>
+    [[nodiscard]] constexpr auto empty()
+        -> std::enable_if_t<forward_range<R>, bool>
     {
-        return for_each_fn::impl(std::move(first), std::move(last),
-                                 fun, proj);
+        return ranges::begin(derived()) == ranges::end(derived());
     }
 
-    template <typename Rng, typename Proj = identity, typename Fun>
-    constexpr std::enable_if_t<
-        input_range<Rng> &&
-            indirect_unary_invocable<Fun, projected<iterator_t<Rng>, Proj>>,
-        for_each_result<borrowed_iterator_t<Rng>, Fun>>
-    operator()(Rng&& rng, Fun fun, Proj proj = Proj{}) const
+    template <typename R = D>
+    [[nodiscard]] constexpr auto empty() const
+        -> std::enable_if_t<forward_range<const R>, bool>
     {
-        return for_each_fn::impl(nano::begin(rng), nano::end(rng),
-                                 fun, proj);
+        return ranges::begin(derived()) == ranges::end(derived());
     }
-};
-} // namespace detail
-
-NANO_INLINE_VAR(detail::for_each_fn, for_each)
-
-template <typename I, typename F>
-using for_each_n_result = in_fun_result<I, F>;
-
-namespace detail {
 
-struct for_each_n_fn {
-    template <typename I, typename Proj = identity, typename Fun>
-    constexpr std::enable_if_t<
-        input_iterator<I> &&
-            indirect_unary_invocable<Fun, projected<I, Proj>>,
-        for_each_n_result<I, Fun>>
-    operator()(I first, iter_difference_t<I> n, Fun fun, Proj proj = Proj{}) const
+    template <typename R = D, typename = decltype(ranges::empty(std::declval<R&>()))>
+    constexpr explicit operator bool()
     {
-        while (n-- > 0) {
-            nano::invoke(fun, nano::invoke(proj, *first));
-            ++first;
-        }
-        return {std::move(first), std::move(fun)};
+        return !ranges::empty(derived());
     }
-};
-} // namespace detail
-
-NANO_INLINE_VAR(detail::for_each_n_fn, for_each_n)
 
-NANO_END_NAMESPACE
-
-#endif
+    template <typename R = D, typename = decltype(ranges::empty(std::declval<const R&>()))>
+    constexpr explicit operator bool() const
+    {
+        return !ranges::empty(derived());
+    }
 
-// nanorange/algorithm/generate.hpp
-//
-// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
-// Distributed under the Boost Software License, Version 1.0. (See accompanying
-// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+    template <typename R = D, typename = std::enable_if_t<contiguous_iterator<iterator_t<R>>>>
+    constexpr auto data()
+    {
+        return ranges::empty(derived()) ? nullptr : std::addressof(*ranges::begin(derived()));
+    }
 
-#ifndef NANORANGE_ALGORITHM_GENERATE_HPP_INCLUDED
-#define NANORANGE_ALGORITHM_GENERATE_HPP_INCLUDED
+    template <typename R = D, typename = std::enable_if_t<
+                  range<const R> && contiguous_iterator<iterator_t<const R>>>>
+    constexpr auto data() const
+    {
+        return ranges::empty(derived()) ? nullptr : std::addressof(*ranges::begin(derived()));
+    }
 
+    template <typename R = D, typename = std::enable_if_t<
+                  forward_range<R> &&
+                  sized_sentinel_for<sentinel_t<R>, iterator_t<R>>>>
+    constexpr auto size()
+    {
+        return ranges::end(derived()) - ranges::begin(derived());
+    }
 
+    template <typename R = D, typename = std::enable_if_t<
+                  forward_range<const R> &&
+                  sized_sentinel_for<sentinel_t<const R>, iterator_t<const R>>>>
+    constexpr auto size() const
+    {
+        return ranges::end(derived()) - ranges::begin(derived());
+    }
 
-NANO_BEGIN_NAMESPACE
+    template <typename R = D, typename = std::enable_if_t<forward_range<R>>>
+    constexpr decltype(auto) front()
+    {
+        return *ranges::begin(derived());
+    }
 
-namespace detail {
+    template <typename R = D, typename = std::enable_if_t<forward_range<const R>>>
+    constexpr decltype(auto) front() const
+    {
+        return *ranges::begin(derived());
+    }
 
-struct generate_fn {
-private:
-    template <typename O, typename S, typename F>
-    static constexpr O impl(O first, S last, F& gen)
+    template <typename R = D, typename = std::enable_if_t<
+                                  bidirectional_range<R> && common_range<R>>>
+    constexpr decltype(auto) back()
     {
-        while (first != last) {
-            *first = gen();
-            ++first;
-        }
+        return *ranges::prev(ranges::end(derived()));
+    }
 
-        return first;
+    template <typename R = D, typename = std::enable_if_t<bidirectional_range<const R> &&
+                                          common_range<const R>>>
+    constexpr decltype(auto) back() const
+    {
+        return *ranges::prev(ranges::end(derived()));
     }
 
-public:
-    template <typename O, typename S, typename F>
-    constexpr std::enable_if_t<input_or_output_iterator<O> &&
-                                   sentinel_for<S, O> &&
-                                   copy_constructible<F> && invocable<F&> &&
-                                   writable<O, invoke_result_t<F&>>,
-                               O>
-    operator()(O first, S last, F gen) const
+    template <typename R = D, typename = std::enable_if_t<random_access_range<R>>>
+    constexpr decltype(auto) operator[](iter_difference_t<iterator_t<R>> n)
     {
-        return generate_fn::impl(std::move(first), std::move(last), gen);
+        return ranges::begin(derived())[n];
     }
 
-    template <typename Rng, typename F>
-    constexpr std::enable_if_t<invocable<F&> &&
-                                   output_range<Rng, invoke_result_t<F&>>,
-                               borrowed_iterator_t<Rng>>
-    operator()(Rng&& rng, F gen) const
+    template <typename R = D,  typename = std::enable_if_t<random_access_range<const R>>>
+    constexpr decltype(auto) operator[](iter_difference_t<iterator_t<const R>> n) const
     {
-        return generate_fn::impl(nano::begin(rng), nano::end(rng), gen);
+        return ranges::begin(derived())[n];
     }
 };
 
-} // namespace detail
-
-NANO_INLINE_VAR(detail::generate_fn, generate)
-
 NANO_END_NAMESPACE
 
 #endif
 
-// nanorange/algorithm/generate_n.hpp
-//
-// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
-// Distributed under the Boost Software License, Version 1.0. (See accompanying
-// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
-
-#ifndef NANORANGE_ALGORITHM_GENERATE_N_HPP_INCLUDED
-#define NANORANGE_ALGORITHM_GENERATE_N_HPP_INCLUDED
 
+NANO_BEGIN_NAMESPACE
 
+// [ranges.subrange]
 
-NANO_BEGIN_NAMESPACE
+enum class subrange_kind : bool { unsized, sized };
 
 namespace detail {
 
-struct generate_n_fn {
-    template <typename O, typename F>
-    constexpr std::enable_if_t<input_or_output_iterator<O> && copy_constructible<F> &&
-                                   invocable<F&> &&
-                                   writable<O, invoke_result_t<F&>>,
-                               O>
-    operator()(O first, iter_difference_t<O> n, F gen) const
-    {
-        for (iter_difference_t<O> i{0}; i < n; ++i, ++first) {
-            *first = gen();
-        }
+template <typename I, typename S, bool = sized_sentinel_for<S, I>>
+struct default_subrange_kind {
+    static constexpr subrange_kind kind = subrange_kind::unsized;
+};
 
-        return first;
-    }
+template <typename I, typename S>
+struct default_subrange_kind<I, S, true> {
+    static constexpr subrange_kind kind = subrange_kind::sized;
 };
 
-} // namespace detail
+}
 
-NANO_INLINE_VAR(detail::generate_n_fn, generate_n)
+namespace subrange_ {
 
-NANO_END_NAMESPACE
+template <typename I, typename S = I,
+          subrange_kind = detail::default_subrange_kind<I, S>::kind>
+class subrange;
 
-#endif
+}
 
-// nanorange/algorithm/includes.hpp
-//
-// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
-// Distributed under the Boost Software License, Version 1.0. (See accompanying
-// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+using subrange_::subrange;
 
-#ifndef NANORANGE_ALGORITHM_INCLUDES_HPP_INCLUDED
-#define NANORANGE_ALGORITHM_INCLUDES_HPP_INCLUDED
+namespace detail {
 
+struct convertible_to_non_slicing_concept {
+    template <typename, typename>
+    static auto test(long) -> std::false_type;
 
+    template <typename From, typename To>
+    static auto test(int) -> std::enable_if_t<
+        convertible_to<From, To> &&
+        !(std::is_pointer_v<std::decay_t<From>> &&
+          std::is_pointer_v<std::decay_t<To>> &&
+          not_same_as<std::remove_pointer_t<std::decay_t<From>>,
+                      std::remove_pointer_t<std::decay_t<To>>>),
+        std::true_type>;
+};
 
-NANO_BEGIN_NAMESPACE
+template <typename From, typename To>
+NANO_CONCEPT convertible_to_non_slicing =
+    decltype(convertible_to_non_slicing_concept::test<From, To>(0))::value;
 
-namespace detail {
+struct pair_like_concept {
+    template <typename>
+    static auto test(long) -> std::false_type;
 
-struct includes_fn {
-private:
-    template <typename I1, typename S1, typename I2, typename S2,
-              typename Comp, typename Proj1, typename Proj2>
-     static constexpr bool impl(I1 first1, S1 last1, I2 first2, S2 last2,
-                                Comp& comp, Proj1& proj1, Proj2& proj2)
-    {
-        while (first2 != last2) {
-            // If range1 is done but we still have elements in range2, then
-            // it is not a subset
-            if (first1 == last1)  {
-                return false;
-            }
+    template <typename T,
+              typename = typename std::tuple_size<T>::type,
+              typename = std::enable_if_t<detail::requires_<pair_like_concept, T>>>
+    static auto test(int) -> std::true_type;
 
-            // If the current element of r2 is less than the current
-            // element of r1, then it is not in r1 => not a subset
-            if (nano::invoke(comp, nano::invoke(proj2, *first2),
-                             nano::invoke(proj1, *first1))) {
-                return false;
-            }
+    template <typename T>
+    auto requires_(T t) -> decltype(
+        requires_expr<derived_from<std::tuple_size<T>, std::integral_constant<std::size_t, 2>>>{},
+        std::declval<std::tuple_element_t<0, std::remove_const_t<T>>>(),
+        std::declval<std::tuple_element_t<1, std::remove_const_t<T>>>(),
+        requires_expr<convertible_to<decltype(std::get<0>(t)), const std::tuple_element<0, T>&>>{},
+        requires_expr<convertible_to<decltype(std::get<1>(t)), const std::tuple_element<1, T>&>>{}
+    );
+};
 
-            // Now we know that that !(r2 < r1). If we also have !(r1 < r2),
-            // then it must be equal, so in range1 -- so move onto the next
-            // element
-            if (!nano::invoke(comp, nano::invoke(proj1, *first1),
-                              nano::invoke(proj2, *first2))) {
-                ++first2;
-            }
+template <typename T>
+NANO_CONCEPT pair_like = !std::is_reference_v<T> &&
+    decltype(pair_like_concept::test<T>(0))::value;
 
-            ++first1;
-        }
+struct pair_like_convertible_from_concept {
+    template <typename, typename, typename>
+    static auto test(long) -> std::false_type;
 
-        return true;
-    }
+    template <typename T, typename U, typename V,
+              std::enable_if_t<!range<T>, int> = 0,
+              std::enable_if_t<pair_like<T>, int> = 0,
+              std::enable_if_t<constructible_from<T, U, V>, int> = 0,
+              std::enable_if_t<convertible_to_non_slicing<U, std::tuple_element<0, T>>, int> = 0,
+              std::enable_if_t<convertible_to<V, std::tuple_element<1, T>>, int> = 0>
+    static auto test(int) -> std::true_type;
+};
 
-public:
-    template <typename I1, typename S1, typename I2, typename S2,
-              typename Comp = ranges::less, typename Proj1 = identity, typename Proj2 = identity>
-    constexpr std::enable_if_t<
-        input_iterator<I1> && sentinel_for<S1, I1> && input_iterator<I2> &&
-            sentinel_for<S2, I2> &&
-            indirect_strict_weak_order<Comp, projected<I1, Proj1>, projected<I2, Proj2>>,
-        bool>
-    operator()(I1 first1, S1 last1, I2 first2, S2 last2,
-               Comp comp = Comp{}, Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
-    {
-        return includes_fn::impl(std::move(first1), std::move(last1),
-                                 std::move(first2), std::move(last2),
-                                 comp, proj1, proj2);
-    }
+template <typename T, typename U, typename V>
+NANO_CONCEPT pair_like_convertible_from =
+    decltype(pair_like_convertible_from_concept::test<T, U, V>(0))::value;
 
-    template <typename Rng1, typename Rng2, typename Comp = ranges::less,
-              typename Proj1 = identity, typename Proj2 = identity>
-    constexpr std::enable_if_t<
-        input_range<Rng1> && input_range<Rng2> &&
-            indirect_strict_weak_order<Comp,
-                                projected<iterator_t<Rng1>, Proj1>,
-                                projected<iterator_t<Rng2>, Proj2>>,
-        bool>
-    operator()(Rng1&& rng1, Rng2&& rng2, Comp comp = Comp{},
-               Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
-    {
-        return includes_fn::impl(nano::begin(rng1), nano::end(rng1),
-                                 nano::begin(rng2), nano::end(rng2),
-                                 comp, proj1, proj2);
-    }
-};
 
-}
+struct iterator_sentinel_pair_concept {
+    template <typename T>
+    static auto test(long) -> std::false_type;
 
-NANO_INLINE_VAR(detail::includes_fn, includes)
+    template <typename T>
+    static auto test(int) -> std::enable_if_t<
+        !range<T> && pair_like<T> &&
+        sentinel_for<std::tuple_element_t<1, T>,  std::tuple_element_t<0, T>>,
+        std::true_type>;
+};
 
-NANO_END_NAMESPACE
+template <typename T>
+NANO_CONCEPT iterator_sentinel_pair =
+    decltype(iterator_sentinel_pair_concept::test<T>(0))::value;
 
-#endif
+template <typename I, typename S, bool StoreSize = false>
+struct subrange_data {
+    constexpr subrange_data() = default;
 
-// nanorange/algorithm/inplace_merge.hpp
-//
-// Copyright (c) 2019 Tristan Brindle (tcbrindle at gmail dot com)
-// Distributed under the Boost Software License, Version 1.0. (See accompanying
-// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+    constexpr subrange_data(I&& begin, S&& end)
+        : begin_(std::move(begin)), end_(std::move(end))
+    {}
 
-// Uses code from cmcstl2 - A concept-enabled C++ standard library
-//
-//  Copyright Eric Niebler 2014
-//  Copyright Casey Carter 2015
-//
+    constexpr subrange_data(I&& begin, S&& end, iter_difference_t<I> /*unused*/)
+        : begin_(std::move(begin)), end_(std::move(end))
+    {}
 
-//===----------------------------------------------------------------------===//
-//
-//                     The LLVM Compiler Infrastructure
-//
-// This file is dual licensed under the MIT and the University of Illinois Open
-// Source Licenses. See LICENSE.TXT for details.
-//
-//===----------------------------------------------------------------------===//
+    I begin_{};
+    S end_{};
+};
 
-#ifndef NANORANGE_ALGORITHM_INPLACE_MERGE_HPP_INCLUDED
-#define NANORANGE_ALGORITHM_INPLACE_MERGE_HPP_INCLUDED
+template <typename I, typename S>
+struct subrange_data<I, S, true> {
+    constexpr subrange_data() = default;
 
+    constexpr subrange_data(I&& begin, S&& end, iter_difference_t<I> size)
+        : begin_(std::move(begin)), end_(std::move(end)), size_(size)
+    {}
 
-// nanorange/algorithm/merge.hpp
-//
-// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
-// Distributed under the Boost Software License, Version 1.0. (See accompanying
-// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+    I begin_{};
+    S end_{};
+    iter_difference_t<I> size_ = 0;
+};
 
-#ifndef NANORANGE_ALGORITHM_MERGE_HPP_INCLUDED
-#define NANORANGE_ALGORITHM_MERGE_HPP_INCLUDED
+// MSVC gets confused if enable_if conditions in template param lists are too
+// complex, so give it some help by calculating the constraints in a helper
+// variable
+template <typename R, typename I, typename S, subrange_kind K>
+auto subrange_range_constructor_constraint_helper_fn(long) -> std::false_type;
 
+template <typename R, typename I, typename S, subrange_kind K>
+auto subrange_range_constructor_constraint_helper_fn(int) -> std::enable_if_t<borrowed_range<R>&&
+                convertible_to_non_slicing<iterator_t<R>, I> &&
+                convertible_to<sentinel_t<R>, S>, std::true_type>;
 
+template <typename R, typename I, typename S, subrange_kind K>
+constexpr bool subrange_range_constructor_constraint_helper =
+    decltype(subrange_range_constructor_constraint_helper_fn<R, I, S, K>(0))::value;
 
+template <typename R>
+constexpr subrange_kind subrange_deduction_guide_helper()
+{
+    return (sized_range<R> || sized_sentinel_for<sentinel_t<R>, iterator_t<R>>)
+           ? subrange_kind::sized : subrange_kind::unsized;
+}
 
-NANO_BEGIN_NAMESPACE
+} // namespace detail
 
-template <typename I1, typename I2, typename O>
-using merge_result = in_in_out_result<I1, I2, O>;
+namespace subrange_ {
 
-namespace detail {
+template <typename I, typename S, subrange_kind K>
+class subrange : public view_interface<subrange<I, S, K>> {
+    static_assert(input_or_output_iterator<I>);
+    static_assert(sentinel_for<S, I>);
+    static_assert(K == subrange_kind::sized || !sized_sentinel_for<S, I>, "");
 
-struct merge_fn {
 private:
-    template <typename I1, typename S1, typename I2, typename S2, typename O,
-              typename Comp, typename Proj1, typename Proj2>
-    static constexpr merge_result<I1, I2, O>
-    impl(I1 first1, S1 last1, I2 first2, S2 last2, O result, Comp& comp,
-         Proj1& proj1, Proj2& proj2)
-    {
-        while (first1 != last1) {
-            // If we've reached the end of the second range, copy any remaining
-            // elements from the first range directly
-            if (first2 == last2) {
-                auto res = nano::copy(std::move(first1),
-                                      std::move(last1),
-                                      std::move(result));
-                first1 = std::move(res.in);
-                result = std::move(res.out);
-                break;
-            }
+    static constexpr bool StoreSize =
+            K == subrange_kind::sized && !sized_sentinel_for<S, I>;
 
-            // (Only) if the element from range2 compares less than the element
-            // from range1, copy it. Otherwise copy the element from the first
-            if (nano::invoke(comp, nano::invoke(proj2, *first2),
-                             nano::invoke(proj1, *first1))) {
-                *result = *first2;
-                ++first2;
-            } else {
-                *result = *first1;
-                ++first1;
-            }
-            ++result;
-        }
-
-        // We've reached the end of range1, so copy any remaining elements
-        // from range2
-        auto res = nano::copy(std::move(first2), std::move(last2),
-                              std::move(result));
-        first2 = std::move(res.in);
-        result = std::move(res.out);
-
-        return {std::move(first1), std::move(first2),  std::move(result)};
-    }
+    detail::subrange_data<I, S, StoreSize> data_{};
 
 public:
-    template <typename I1, typename S1, typename I2, typename S2, typename O,
-              typename Comp = ranges::less, typename Proj1 = identity,
-              typename Proj2 = identity>
-    constexpr std::enable_if_t<input_iterator<I1> && sentinel_for<S1, I1> &&
-                                   input_iterator<I2> && sentinel_for<S2, I2> &&
-        weakly_incrementable<O> &&
-                                   mergeable<I1, I2, O, Comp, Proj1, Proj1>,
-        merge_result<I1, I2, O>>
-    operator()(I1 first1, S1 last1, I2 first2, S2 last2, O result,
-               Comp comp = Comp{}, Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
-    {
-        return merge_fn::impl(std::move(first1), std::move(last1),
-                              std::move(first2), std::move(last2),
-                              std::move(result), comp,
-                              proj1, proj2);
-    }
-
-    template <typename Rng1, typename Rng2, typename O, typename Comp = ranges::less,
-              typename Proj1 = identity, typename Proj2 = identity>
-    constexpr std::enable_if_t<
-        input_range<Rng1> && input_range<Rng2> &&
-        weakly_incrementable<O> &&
-            mergeable<iterator_t<Rng1>, iterator_t<Rng2>, O, Comp, Proj1, Proj2>,
-        merge_result<borrowed_iterator_t<Rng1>, borrowed_iterator_t<Rng2>, O>>
-    operator()(Rng1&& rng1, Rng2&& rng2, O result, Comp comp = Comp{},
-               Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
-    {
-        return merge_fn::impl(nano::begin(rng1), nano::end(rng1),
-                              nano::begin(rng2), nano::end(rng2),
-                              std::move(result), comp,
-                              proj1, proj2);
-    }
-};
-
-}
+    subrange() = default;
 
-NANO_INLINE_VAR(detail::merge_fn, merge)
+    template <typename II, bool SS = StoreSize,
+             typename = std::enable_if_t<
+                 detail::convertible_to_non_slicing<II, I> &&
+                 !SS>>
+    constexpr subrange(II i, S s)
+            : data_{std::move(i), std::move(s)} {}
 
-NANO_END_NAMESPACE
+    template <typename II, subrange_kind KK = K,
+              typename = std::enable_if_t<
+                  detail::convertible_to_non_slicing<II, I> &&
+                  KK == subrange_kind::sized>>
+    constexpr subrange(II i, S s, iter_difference_t<I> n)
+            : data_{std::move(i), std::move(s), n} {}
 
-#endif
+    template <typename R, bool SS = StoreSize,
+            std::enable_if_t<detail::not_same_as<R, subrange>, int> = 0,
+            std::enable_if_t<
+                    detail::subrange_range_constructor_constraint_helper<R, I, S, K>
+                    && SS && sized_range<R>, int> = 0>
+    constexpr subrange(R&& r)
+            : subrange(ranges::begin(r), ranges::end(r), ranges::size(r)) {}
 
-// nanorange/algorithm/min.hpp
-//
-// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
-// Distributed under the Boost Software License, Version 1.0. (See accompanying
-// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+    template <typename R, bool SS = StoreSize,
+            std::enable_if_t<detail::not_same_as<R, subrange>, int> = 0,
+            std::enable_if_t<
+                    detail::subrange_range_constructor_constraint_helper<R, I, S, K>
+                     && !SS, int> = 0>
+    constexpr subrange(R&& r)
+            : subrange(ranges::begin(r), ranges::end(r)) {}
 
-#ifndef NANORANGE_ALGORITHM_MIN_HPP_INCLUDED
-#define NANORANGE_ALGORITHM_MIN_HPP_INCLUDED
+    template <typename R, subrange_kind KK = K, std::enable_if_t<
+            borrowed_range<R> &&
+            detail::convertible_to_non_slicing<iterator_t<R>, I> &&
+            convertible_to<sentinel_t<R>, S> &&
+            KK == subrange_kind::sized, int> = 0>
+    constexpr subrange(R&& r, iter_difference_t<I> n)
+            : subrange(ranges::begin(r), ranges::end(r), n) {}
 
 
+    template <typename PairLike_,
+            std::enable_if_t<detail::not_same_as<PairLike_, subrange>, int> = 0,
+            std::enable_if_t<detail::pair_like_convertible_from<
+                                PairLike_, const I&, const S&>, int> = 0>
+    constexpr operator PairLike_() const
+    {
+        return PairLike_(begin(), end());
+    }
 
-NANO_BEGIN_NAMESPACE
+    constexpr I begin() const { return data_.begin_; }
 
-namespace detail {
+    constexpr S end() const { return data_.end_; }
 
-struct min_fn {
-private:
-    template <typename Rng, typename Comp, typename Proj>
-    static constexpr iter_value_t<iterator_t<Rng>>
-    impl(Rng&& rng, Comp& comp, Proj& proj)
+    [[nodiscard]] constexpr bool empty() const
     {
-        auto first = nano::begin(rng);
-        const auto last = nano::end(rng);
-
-        // Empty ranges not allowed
-        auto result = *first;
+        return data_.begin_ == data_.end_;
+    }
 
-        while(++first != last) {
-            auto&& val = *first;
-            if (nano::invoke(comp, nano::invoke(proj, val),
-                             nano::invoke(proj, result))) {
-                result = std::forward<decltype(val)>(val);
-            }
+    template <subrange_kind KK = K>
+    constexpr auto size() const
+        -> std::enable_if_t<KK == subrange_kind::sized, iter_difference_t<I>>
+    {
+        if constexpr (StoreSize) {
+            return data_.size_;
+        } else {
+            return data_.end_ - data_.begin_;
         }
-
-        return result;
     }
 
-public:
-    template <typename T, typename Comp = ranges::less, typename Proj = identity>
-    constexpr std::enable_if_t<
-        indirect_strict_weak_order<Comp, projected<const T*, Proj>>,
-        const T&>
-    operator()(const T& a, const T& b, Comp comp = Comp{}, Proj proj = Proj{}) const
+    [[nodiscard]] constexpr subrange next(iter_difference_t<I> n = 1) const
     {
-        return nano::invoke(comp, nano::invoke(proj, b),
-                            nano::invoke(proj, a)) ? b : a;
+        auto tmp = *this;
+        tmp.advance(n);
+        return tmp;
     }
 
-    template <typename T, typename Comp = ranges::less, typename Proj = identity>
-    constexpr std::enable_if_t<
-        copyable<T> &&
-            indirect_strict_weak_order<Comp, projected<const T*, Proj>>,
-        T>
-    operator()(std::initializer_list<T> rng, Comp comp = Comp{},
-               Proj proj = Proj{}) const
+    template <typename II = I>
+    [[nodiscard]] constexpr auto prev(iter_difference_t<I> n = 1) const
+        -> std::enable_if_t<bidirectional_iterator<II>, subrange>
     {
-        return min_fn::impl(rng, comp, proj);
+        auto tmp = *this;
+        tmp.advance(-n);
+        return tmp;
     }
 
-    template <typename Rng, typename Comp = ranges::less, typename Proj = identity>
-    constexpr std::enable_if_t<
-        input_range<Rng> && copyable<iter_value_t<iterator_t<Rng>>> &&
-            indirect_strict_weak_order<Comp, projected<iterator_t<Rng>, Proj>>,
-        range_value_t<Rng>>
-    operator()(Rng&& rng, Comp comp = Comp{}, Proj proj = Proj{}) const
+    constexpr subrange& advance(iter_difference_t<I> n)
     {
-        return min_fn::impl(std::forward<Rng>(rng), comp, proj);
+        if constexpr (StoreSize) {
+            data_.size_ -= n - ranges::advance(data_.begin_, n, data_.end_);
+        } else {
+            ranges::advance(data_.begin_, n, data_.end_);
+        }
+        return *this;
     }
 };
 
+template <typename I, typename S,
+          std::enable_if_t<input_or_output_iterator<I> && sentinel_for<S, I>, int> = 0>
+subrange(I, S) -> subrange<I, S>;
+
+template <typename I, typename S, std::enable_if_t<input_or_output_iterator<I> && sentinel_for<S, I>, int> = 0>
+subrange(I, S, iter_difference_t<I>) -> subrange<I, S, subrange_kind::sized>;
+
+template <typename P, std::enable_if_t<detail::iterator_sentinel_pair<P>, int> = 0>
+subrange(P) -> subrange<std::tuple_element_t<0, P>, std::tuple_element_t<1, P>>;
+
+template <typename P, std::enable_if_t<detail::iterator_sentinel_pair<P>, int> = 0>
+subrange(P, iter_difference_t<std::tuple_element_t<0, P>>) ->
+    subrange<std::tuple_element_t<0, P>, std::tuple_element_t<1, P>, subrange_kind::sized>;
+
+template <typename R, std::enable_if_t<borrowed_range<R>, int> = 0>
+subrange(R&&) ->
+    subrange<iterator_t<R>, sentinel_t<R>,
+             detail::subrange_deduction_guide_helper<R>()>;
+
+template <typename R, std::enable_if_t<borrowed_range<R>, int> = 0>
+subrange(R&&, iter_difference_t<iterator_t<R>>) ->
+    subrange<iterator_t<R>, sentinel_t<R>, subrange_kind::sized>;
+
+} // namespace subrange_
+
+template <typename I, typename S, subrange_kind K>
+inline constexpr bool enable_borrowed_range<subrange<I, S, K>> = true;
+
+template <std::size_t N, typename I, typename S, subrange_kind K,
+          std::enable_if_t<(N < 2), int> = 0>
+constexpr auto get(const subrange<I, S, K>& r)
+{
+    if constexpr (N == 0) {
+        return r.begin();
+    } else {
+        return r.end();
+    }
 }
 
-NANO_INLINE_VAR(detail::min_fn, min)
+template <typename R>
+using borrowed_subrange_t =
+    detail::conditional_t<borrowed_range<R>, subrange<iterator_t<R>>, dangling>;
 
 NANO_END_NAMESPACE
 
-#endif
+namespace std {
 
-// nanorange/algorithm/move.hpp
-//
-// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
-// Distributed under the Boost Software License, Version 1.0. (See accompanying
-// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+template <typename I, typename S, ::nano::subrange_kind K>
+class tuple_size<::nano::subrange<I, S, K>>
+    : public integral_constant<size_t, 2> {
+};
 
-#ifndef NANORANGE_ALGORITHM_MOVE_HPP_INCLUDED
-#define NANORANGE_ALGORITHM_MOVE_HPP_INCLUDED
+template <typename I, typename S, ::nano::subrange_kind K>
+class tuple_element<0, ::nano::subrange<I, S, K>> {
+public:
+    using type = I;
+};
+
+template <typename I, typename S, ::nano::subrange_kind K>
+class tuple_element<1, ::nano::subrange<I, S, K>> {
+public:
+    using type = S;
+};
+
+using ::nano::ranges::get;
 
+} // namespace std
 
+#endif
 
 
 NANO_BEGIN_NAMESPACE
 
-template <typename I, typename O>
-using move_result = in_out_result<I, O>;
-
 namespace detail {
 
-struct move_fn {
+struct rotate_fn {
 private:
-    template <typename I, typename S, typename O>
-    static constexpr std::enable_if_t<sized_sentinel_for<S, I>, move_result<I, O>>
-    impl(I first, S last, O result, priority_tag<1>)
+    template <typename I, typename S>
+    static constexpr subrange<I> do_rotate_one_left(I first, S last)
     {
-        const auto dist = last - first;
-
-        for (iter_difference_t<I> i{0}; i < dist; i++) {
-            *result = nano::iter_move(first);
-            ++first;
-            ++result;
-        }
+        // Stash the first element and move everything one place
+        iter_value_t<I> val = nano::iter_move(first);
+        auto ret = nano::move(nano::next(first), std::move(last), first);
+        *ret.out = std::move(val);
+        return {std::move(ret.out), std::move(ret.in)};
+    }
 
-        return {std::move(first), std::move(result)};
+    template <typename I>
+    static constexpr subrange<I> do_rotate_one_right(I first, I middle)
+    {
+        I last = nano::next(middle);
+        iter_value_t<I> val = nano::iter_move(middle);
+        nano::move_backward(first, middle, last);
+        *first = std::move(val);
+        return {std::move(++first), std::move(last)};
     }
 
-    template <typename I, typename S, typename O>
-    static constexpr move_result<I, O> impl(I first, S last, O result,
-                                            priority_tag<0>)
+    template <typename I, typename S>
+    static constexpr std::enable_if_t<
+        random_access_iterator<I> && sized_sentinel_for<S, I>,
+            subrange<I>>
+    do_rotate(I first, I middle, S last, priority_tag<2>)
     {
-        while (first != last) {
-            *result = nano::iter_move(first);
-            ++first;
-            ++result;
+        constexpr bool is_tma = std::is_trivially_move_assignable<iter_value_t<I>>::value;
+
+        auto i = nano::distance(first, middle);
+        auto j = nano::distance(first, last) - i;
+        I out = first + (last - middle);
+
+        while (i != j) {
+            if (i > j) {
+                if (is_tma && j == 1) {
+                    do_rotate_one_right(middle - i, middle);
+                    return {std::move(out), nano::next(first, last)};
+                }
+                nano::swap_ranges(middle - i, unreachable_sentinel, middle, middle + j);
+                i -= j;
+            } else {
+                if (is_tma && i == 1) {
+                    do_rotate_one_left(middle - i, middle + j);
+                    return {std::move(out), nano::next(first, last)};
+                }
+                nano::swap_ranges(middle - i, middle, middle + j - i, unreachable_sentinel);
+                j -= i;
+            }
         }
+        nano::swap_ranges(middle  - i, middle, middle, unreachable_sentinel);
 
-        return {std::move(first), std::move(result)};
+        return {std::move(out), nano::next(first, last)};
     }
 
-public:
-    template <typename I, typename S, typename O>
-    constexpr std::enable_if_t<input_iterator<I> && sentinel_for<S, I> &&
-                                   weakly_incrementable<O> &&
-                                   indirectly_movable<I, O>,
-                               move_result<I, O>>
-    operator()(I first, S last, O result) const
+    template <typename I, typename S>
+    static constexpr std::enable_if_t<bidirectional_iterator<I>, subrange<I>>
+    do_rotate(I first, I middle, S last, priority_tag<1>)
     {
-        return move_fn::impl(std::move(first), std::move(last),
-                             std::move(result), priority_tag<1>{});
-    }
+        if (std::is_trivially_move_assignable<iter_value_t<I>>::value &&
+                nano::next(middle) == last) {
+            return do_rotate_one_right(std::move(first), std::move(middle));
+        }
 
-    template <typename Rng, typename O>
-    constexpr std::enable_if_t<input_range<Rng> && weakly_incrementable<O> &&
-                                   indirectly_movable<iterator_t<Rng>, O>,
-                               move_result<borrowed_iterator_t<Rng>, O>>
-    operator()(Rng&& rng, O result) const
-    {
-        return move_fn::impl(nano::begin(rng), nano::end(rng),
-                             std::move(result), priority_tag<1>{});
+        return do_rotate(std::move(first), std::move(middle), std::move(last),
+                         priority_tag<0>{});
     }
-};
 
-} // namespace detail
+    template <typename I, typename S>
+    static constexpr subrange<I>
+    do_rotate(I first, I middle, S last, priority_tag<0>)
+    {
+        if (std::is_trivially_move_assignable<iter_value_t<I>>::value &&
+                nano::next(first) == middle) {
+            return do_rotate_one_left(std::move(first), std::move(last));
+        }
 
-NANO_INLINE_VAR(detail::move_fn, move)
+        if (sized_sentinel_for<I, I> && sized_sentinel_for<S, I> &&
+            nano::distance(first, middle) == nano::distance(middle, last))
+        {
+            auto ret = nano::swap_ranges(first, middle, middle, unreachable_sentinel);
+            return {std::move(ret.in1), std::move(ret.in2)};
+        }
 
-template <typename I, typename O>
-using move_backward_result = in_out_result<I, O>;
+        I next = middle;
 
-namespace detail {
+        do {
+            nano::iter_swap(first++, next++);
+            if (first == middle) {
+                middle = next;
+            }
+        } while (next != last);
 
-struct move_backward_fn {
-private:
-    template <typename I, typename O>
-    static constexpr move_backward_result<I, O> impl(I first, I last, O result)
-    {
-        auto it = last;
+        I ret = first;
+        next = middle;
 
-        while (it != first) {
-            *--result = nano::iter_move(--it);
+        while (next != last) {
+            nano::iter_swap(first++, next++);
+            if (first == middle) {
+                middle = next;
+            } else if (next == last) {
+                next = middle;
+            }
         }
 
-        return {std::move(last), std::move(result)};
+        return {std::move(ret), std::move(next)};
     }
 
-    template <typename I, typename S, typename O>
-    static constexpr std::enable_if_t<!same_as<I, S>, move_backward_result<I, O>>
-    impl(I first, S sent, O result)
+    template <typename I, typename S>
+    static constexpr subrange<I> impl(I first, I middle, S last)
     {
-        I last = nano::next(first, sent);
-        return impl(std::move(first), std::move(last), std::move(result));
+        if (first == middle) {
+            auto ret = nano::next(first, last);
+            return {ret, ret};
+        }
+        if (middle == last) {
+            return {first, middle};
+        }
+
+        return do_rotate(std::move(first), std::move(middle), std::move(last),
+                         priority_tag<2>{});
     }
 
 public:
-    template <typename I, typename S, typename O>
+    template <typename I, typename S>
     constexpr std::enable_if_t<
-        bidirectional_iterator<I> && sentinel_for<S, I> &&
-            bidirectional_iterator<O> && indirectly_movable<I, O>,
-                               move_backward_result<I, O>>
-    operator()(I first, S last, O result) const
+        forward_iterator<I> && sentinel_for<S, I> && permutable<I>,
+        subrange<I>>
+    operator()(I first, I middle, S last) const
     {
-        return move_backward_fn::impl(std::move(first), std::move(last),
-                                      std::move(result));
+        return rotate_fn::impl(std::move(first), std::move(middle), std::move(last));
     }
 
-    template <typename Rng, typename O>
-    constexpr std::enable_if_t<bidirectional_range<Rng> &&
-                                   bidirectional_iterator<O> &&
-                                   indirectly_movable<iterator_t<Rng>, O>,
-                               move_backward_result<borrowed_iterator_t<Rng>, O>>
-    operator()(Rng&& rng, O result) const
+    template <typename Rng>
+    constexpr std::enable_if_t<
+        forward_range<Rng> && permutable<iterator_t<Rng>>,
+                               borrowed_subrange_t<Rng>>
+    operator()(Rng&& rng, iterator_t<Rng> middle) const
     {
-        return move_backward_fn::impl(nano::begin(rng), nano::end(rng),
-                                      std::move(result));
+        return rotate_fn::impl(nano::begin(rng), std::move(middle), nano::end(rng));
     }
 };
 
 } // namespace detail
 
-NANO_INLINE_VAR(detail::move_backward_fn, move_backward)
+NANO_INLINE_VAR(detail::rotate_fn, rotate)
 
 NANO_END_NAMESPACE
 
 #endif
 
-// nanorange/algorithm/rotate.hpp
+// nanorange/algorithm/upper_bound.hpp
 //
 // Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
 // Distributed under the Boost Software License, Version 1.0. (See accompanying
 // file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
-#ifndef NANORANGE_ALGORITHM_ROTATE_HPP_INCLUDED
-#define NANORANGE_ALGORITHM_ROTATE_HPP_INCLUDED
-
+#ifndef NANORANGE_ALGORITHM_UPPER_BOUND_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_UPPER_BOUND_HPP_INCLUDED
 
-// nanorange/algorithm/swap_ranges.hpp
-//
-// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
-// Distributed under the Boost Software License, Version 1.0. (See accompanying
-// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
-#ifndef NANORANGE_ALGORITHM_SWAP_RANGES_HPP_INCLUDED
-#define NANORANGE_ALGORITHM_SWAP_RANGES_HPP_INCLUDED
 
+NANO_BEGIN_NAMESPACE
 
+namespace detail {
 
+struct upper_bound_fn {
+private:
+    friend struct equal_range_fn;
 
-NANO_BEGIN_NAMESPACE
+    template <typename Comp, typename T>
+    struct compare {
+        Comp& comp;
+        const T& val;
 
-template <typename I1, typename I2>
-using swap_ranges_result = in_in_result<I1, I2>;
+        template <typename U>
+        constexpr bool operator()(U&& u) const
+        {
+            return !nano::invoke(comp, val, std::forward<U>(u));
+        }
+    };
 
-namespace detail {
 
-struct swap_ranges_fn {
-    template <typename I1, typename S1, typename I2, typename S2>
-    static constexpr swap_ranges_result<I1, I2>
-    impl4(I1 first1 ,S1 last1, I2 first2, S2 last2)
+    template <typename I, typename S, typename T, typename Comp, typename Proj>
+    static constexpr I impl(I first, S last, const T& value, Comp& comp, Proj& proj)
     {
-        while (first1 != last1 && first2 != last2) {
-            nano::iter_swap(first1, first2);
-            ++first1; ++first2;
-        }
-        return {std::move(first1), std::move(first2)};
+        const auto comparator = compare<Comp, T>{comp, value};
+        return partition_point_fn::impl(std::move(first), std::move(last),
+                                        comparator, proj);
     }
 
-    template <typename I1, typename S1, typename I2>
-    static constexpr swap_ranges_result<I1, I2>
-    impl3(I1 first1, S1 last1, I2 first2)
+public:
+    template <typename I, typename S, typename T, typename Comp = ranges::less,
+              typename Proj = identity>
+    std::enable_if_t<
+        forward_iterator<I> && sentinel_for<S, I> &&
+            indirect_strict_weak_order<Comp, const T*, projected<I, Proj>>,
+    I>
+    constexpr operator()(I first, S last, const T& value, Comp comp = Comp{},
+                         Proj proj = Proj{}) const
     {
-        while (first1 != last1) {
-            nano::iter_swap(first1, first2);
-            ++first1; ++first2;
-        }
-        return {std::move(first1), std::move(first2)};
+        return upper_bound_fn::impl(std::move(first), std::move(last),
+                                    value, comp, proj);
     }
 
-public:
-    template <typename I1, typename S1, typename I2, typename S2>
-    constexpr std::enable_if_t<
-        forward_iterator<I1> && sentinel_for<S1, I1> && forward_iterator<I2> &&
-            sentinel_for<S2, I2> && indirectly_swappable<I1, I2>,
-        swap_ranges_result<I1, I2>>
-    operator()(I1 first1 ,S1 last1, I2 first2, S2 last2) const
+    template <typename Rng, typename T, typename Comp = ranges::less,
+              typename Proj = identity>
+    std::enable_if_t<forward_range<Rng> &&
+                         indirect_strict_weak_order<Comp, const T*, projected<iterator_t<Rng>, Proj>>,
+                     borrowed_iterator_t<Rng>>
+    constexpr operator()(Rng&& rng, const T& value, Comp comp = Comp{},
+                         Proj proj = Proj{}) const
     {
-        return swap_ranges_fn::impl4(std::move(first1), std::move(last1),
-                                     std::move(first2), std::move(last2));
-    }
-
-    template <typename I1, typename S1, typename I2>
-    NANO_DEPRECATED
-    constexpr std::enable_if_t<
-        forward_iterator<I1> && sentinel_for<S1, I1> && forward_iterator<I2> &&
-            indirectly_swappable<I1, I2>,
-            swap_ranges_result<I1, I2>>
-    operator()(I1 first1 ,S1 last1, I2 first2) const
-    {
-        return swap_ranges_fn::impl3(std::move(first1), std::move(last1),
-                                     std::move(first2));
-    }
-
-    template <typename Rng1, typename Rng2>
-    constexpr std::enable_if_t<
-        forward_range<Rng1> && forward_range<Rng2> &&
-            indirectly_swappable<iterator_t<Rng1>, iterator_t<Rng2>>,
-            swap_ranges_result<borrowed_iterator_t<Rng1>,
-                           borrowed_iterator_t<Rng2>>>
-    operator()(Rng1&& rng1, Rng2&& rng2) const
-    {
-        return swap_ranges_fn::impl4(nano::begin(rng1), nano::end(rng1),
-                                     nano::begin(rng2), nano::end(rng2));
-    }
-
-    template <typename Rng1, typename I2>
-    NANO_DEPRECATED
-    constexpr std::enable_if_t<
-        forward_range<Rng1> && forward_iterator<I2> &&
-            indirectly_swappable<iterator_t<Rng1>, I2>,
-            swap_ranges_result<borrowed_iterator_t<Rng1>, I2>>
-    operator()(Rng1&& rng1, I2 first2) const
-    {
-        return swap_ranges_fn::impl3(nano::begin(rng1), nano::end(rng1),
-                                     std::move(first2));
+        return upper_bound_fn::impl(nano::begin(rng), nano::end(rng),
+                                    value, comp, proj);
     }
 };
 
 }
 
-NANO_INLINE_VAR(detail::swap_ranges_fn, swap_ranges)
-
-NANO_END_NAMESPACE
-
-#endif
-
-// nanorange/iterator/unreachable.hpp
-//
-// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
-// Distributed under the Boost Software License, Version 1.0. (See accompanying
-// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
-
-#ifndef NANORANGE_ITERATOR_UNREACHABLE_HPP_INCLUDED
-#define NANORANGE_ITERATOR_UNREACHABLE_HPP_INCLUDED
-
-
-
-NANO_BEGIN_NAMESPACE
-
-// [range.unreachable.sentinels]
-
-struct unreachable_sentinel_t {
-    template<typename I>
-    friend constexpr std::enable_if_t<weakly_incrementable<I>, bool>
-    operator==(const I &, unreachable_sentinel_t) noexcept
-    {
-        return false;
-    }
-
-    template<typename I>
-    friend constexpr std::enable_if_t<weakly_incrementable<I>, bool>
-    operator==(unreachable_sentinel_t, const I &) noexcept
-    {
-        return false;
-    }
-
-    template<typename I>
-    friend constexpr std::enable_if_t<weakly_incrementable<I>, bool>
-    operator!=(const I &, unreachable_sentinel_t) noexcept
-    {
-        return true;
-    }
-
-    template<typename I>
-    friend constexpr std::enable_if_t<weakly_incrementable<I>, bool>
-    operator!=(unreachable_sentinel_t, const I &) noexcept
-    {
-        return true;
-    }
-};
-
-inline constexpr unreachable_sentinel_t unreachable_sentinel{};
-
-NANO_END_NAMESPACE
-
-#endif
-
-
-
-NANO_BEGIN_NAMESPACE
-
-namespace detail {
-
-struct rotate_fn {
-private:
-    template <typename I, typename S>
-    static constexpr subrange<I> do_rotate_one_left(I first, S last)
-    {
-        // Stash the first element and move everything one place
-        iter_value_t<I> val = nano::iter_move(first);
-        auto ret = nano::move(nano::next(first), std::move(last), first);
-        *ret.out = std::move(val);
-        return {std::move(ret.out), std::move(ret.in)};
-    }
-
-    template <typename I>
-    static constexpr subrange<I> do_rotate_one_right(I first, I middle)
-    {
-        I last = nano::next(middle);
-        iter_value_t<I> val = nano::iter_move(middle);
-        nano::move_backward(first, middle, last);
-        *first = std::move(val);
-        return {std::move(++first), std::move(last)};
-    }
-
-    template <typename I, typename S>
-    static constexpr std::enable_if_t<
-        random_access_iterator<I> && sized_sentinel_for<S, I>,
-            subrange<I>>
-    do_rotate(I first, I middle, S last, priority_tag<2>)
-    {
-        constexpr bool is_tma = std::is_trivially_move_assignable<iter_value_t<I>>::value;
-
-        auto i = nano::distance(first, middle);
-        auto j = nano::distance(first, last) - i;
-        I out = first + (last - middle);
-
-        while (i != j) {
-            if (i > j) {
-                if (is_tma && j == 1) {
-                    do_rotate_one_right(middle - i, middle);
-                    return {std::move(out), nano::next(first, last)};
-                }
-                nano::swap_ranges(middle - i, unreachable_sentinel, middle, middle + j);
-                i -= j;
-            } else {
-                if (is_tma && i == 1) {
-                    do_rotate_one_left(middle - i, middle + j);
-                    return {std::move(out), nano::next(first, last)};
-                }
-                nano::swap_ranges(middle - i, middle, middle + j - i, unreachable_sentinel);
-                j -= i;
-            }
-        }
-        nano::swap_ranges(middle  - i, middle, middle, unreachable_sentinel);
-
-        return {std::move(out), nano::next(first, last)};
-    }
-
-    template <typename I, typename S>
-    static constexpr std::enable_if_t<bidirectional_iterator<I>, subrange<I>>
-    do_rotate(I first, I middle, S last, priority_tag<1>)
-    {
-        if (std::is_trivially_move_assignable<iter_value_t<I>>::value &&
-                nano::next(middle) == last) {
-            return do_rotate_one_right(std::move(first), std::move(middle));
-        }
-
-        return do_rotate(std::move(first), std::move(middle), std::move(last),
-                         priority_tag<0>{});
-    }
-
-    template <typename I, typename S>
-    static constexpr subrange<I>
-    do_rotate(I first, I middle, S last, priority_tag<0>)
-    {
-        if (std::is_trivially_move_assignable<iter_value_t<I>>::value &&
-                nano::next(first) == middle) {
-            return do_rotate_one_left(std::move(first), std::move(last));
-        }
-
-        if (sized_sentinel_for<I, I> && sized_sentinel_for<S, I> &&
-            nano::distance(first, middle) == nano::distance(middle, last))
-        {
-            auto ret = nano::swap_ranges(first, middle, middle, unreachable_sentinel);
-            return {std::move(ret.in1), std::move(ret.in2)};
-        }
-
-        I next = middle;
-
-        do {
-            nano::iter_swap(first++, next++);
-            if (first == middle) {
-                middle = next;
-            }
-        } while (next != last);
-
-        I ret = first;
-        next = middle;
-
-        while (next != last) {
-            nano::iter_swap(first++, next++);
-            if (first == middle) {
-                middle = next;
-            } else if (next == last) {
-                next = middle;
-            }
-        }
-
-        return {std::move(ret), std::move(next)};
-    }
-
-    template <typename I, typename S>
-    static constexpr subrange<I> impl(I first, I middle, S last)
-    {
-        if (first == middle) {
-            auto ret = nano::next(first, last);
-            return {ret, ret};
-        }
-        if (middle == last) {
-            return {first, middle};
-        }
-
-        return do_rotate(std::move(first), std::move(middle), std::move(last),
-                         priority_tag<2>{});
-    }
-
-public:
-    template <typename I, typename S>
-    constexpr std::enable_if_t<
-        forward_iterator<I> && sentinel_for<S, I> && permutable<I>,
-        subrange<I>>
-    operator()(I first, I middle, S last) const
-    {
-        return rotate_fn::impl(std::move(first), std::move(middle), std::move(last));
-    }
-
-    template <typename Rng>
-    constexpr std::enable_if_t<
-        forward_range<Rng> && permutable<iterator_t<Rng>>,
-                               borrowed_subrange_t<Rng>>
-    operator()(Rng&& rng, iterator_t<Rng> middle) const
-    {
-        return rotate_fn::impl(nano::begin(rng), std::move(middle), nano::end(rng));
-    }
-};
-
-} // namespace detail
-
-NANO_INLINE_VAR(detail::rotate_fn, rotate)
+NANO_INLINE_VAR(detail::upper_bound_fn, upper_bound)
 
 NANO_END_NAMESPACE
 
 #endif
 
 
-
 // nanorange/detail/memory/temporary_vector.hpp
 //
 // Copyright (c) 2019 Tristan Brindle (tcbrindle at gmail dot com)
@@ -8192,22 +8525,80 @@ NANO_END_NAMESPACE
 #include <memory>
 #include <new>
 
+#if defined(__has_include)
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#endif
+#endif
+
+#if defined(__cpp_lib_memory_resource) && !defined(NANORANGE_NO_MEMORY_RESOURCE)
+#define NANO_HAS_MEMORY_RESOURCE 1
+#else
+#define NANO_HAS_MEMORY_RESOURCE 0
+#endif
+
 NANO_BEGIN_NAMESPACE
 
 namespace detail {
 
-template <typename T>
-struct temporary_vector {
+// Where algorithms which take an optional memory resource get their scratch
+// space from. A null pointer means the global operator new.
+#if NANO_HAS_MEMORY_RESOURCE
+using temporary_resource = std::pmr::memory_resource;
+#else
+struct temporary_resource;
+#endif
+
+template <typename T>
+struct temporary_vector {
 private:
     struct deleter {
-        void operator()(T* ptr) const { ::operator delete[](ptr); }
+        temporary_resource* resource = nullptr;
+        std::size_t capacity = 0;
+
+        void operator()(T* ptr) const
+        {
+#if NANO_HAS_MEMORY_RESOURCE
+            if (resource) {
+                resource->deallocate(ptr, capacity * sizeof(T), alignof(T));
+                return;
+            }
+#endif
+            ::operator delete[](ptr);
+        }
     };
 
+    // Like the global nothrow new, returns null rather than throwing if the
+    // memory is not available
+    static T* allocate(std::size_t capacity, temporary_resource* resource)
+    {
+#if NANO_HAS_MEMORY_RESOURCE
+        if (resource) {
+            if (capacity == 0) {
+                return nullptr;
+            }
+#if NANO_HAS_EXCEPTIONS
+            try {
+                return static_cast<T*>(
+                    resource->allocate(capacity * sizeof(T), alignof(T)));
+            } catch (const std::bad_alloc&) {
+                return nullptr;
+            }
+#else
+            return static_cast<T*>(
+                resource->allocate(capacity * sizeof(T), alignof(T)));
+#endif
+        }
+#endif
+        return static_cast<T*>(::operator new[](capacity * sizeof(T), std::nothrow));
+    }
+
 public:
     temporary_vector() = default;
 
-    explicit temporary_vector(std::size_t capacity)
-        : start_(static_cast<T*>(::operator new[](capacity * sizeof(T), std::nothrow))),
+    explicit temporary_vector(std::size_t capacity,
+                              temporary_resource* resource = nullptr)
+        : start_(allocate(capacity, resource), deleter{resource, capacity}),
           end_cap_(start_ ? start_.get() + capacity : nullptr)
     {}
 
@@ -8754,6 +9145,9 @@ private:
         }
     }
 
+    // Once the buffered half is exhausted, the remaining elements of the
+    // other half are already in their final positions, so we stop there
+    // rather than moving them onto themselves
     template <typename I, typename Buf, typename Comp, typename Proj>
     static void impl_buffered(I first, I middle, I last,
                               iter_difference_t<I> len1, iter_difference_t<I> len2,
@@ -8761,32 +9155,48 @@ private:
     {
         if (len1 <= len2) {
             nano::move(first, middle, nano::back_inserter(buf));
-            nano::merge(
-                nano::make_move_iterator(buf.begin()),
-                nano::make_move_sentinel(buf.end()),
-                nano::make_move_iterator(std::move(middle)),
-                nano::make_move_sentinel(std::move(last)),
-                std::move(first), std::ref(comp), std::ref(proj), std::ref(proj));
+            auto buf_first = buf.begin();
+            const auto buf_last = buf.end();
+
+            while (buf_first != buf_last) {
+                if (middle == last) {
+                    nano::move(buf_first, buf_last, std::move(first));
+                    break;
+                }
+                if (nano::invoke(comp, nano::invoke(proj, *middle),
+                                 nano::invoke(proj, *buf_first))) {
+                    *first = nano::iter_move(middle);
+                    ++middle;
+                } else {
+                    *first = std::move(*buf_first);
+                    ++buf_first;
+                }
+                ++first;
+            }
         } else {
             nano::move(middle, last, nano::back_inserter(buf));
-            using ri_t = nano::reverse_iterator<I>;
-            // TODO: C++17's not_fn would be useful
-            auto not_comp = [&comp] (auto&& a, auto&& b) {
-                return !nano::invoke(comp, std::forward<decltype(a)>(a),
-                        std::forward<decltype(b)>(b));
-            };
-            nano::merge(
-                nano::make_move_iterator(ri_t{std::move(middle)}),
-                nano::make_move_sentinel(ri_t{std::move(first)}),
-                nano::make_move_iterator(nano::rbegin(buf)),
-                nano::make_move_sentinel(nano::rend(buf)),
-                nano::make_reverse_iterator(std::move(last)),
-                not_comp, std::ref(proj), std::ref(proj));
+            const auto buf_first = buf.begin();
+            auto buf_last = buf.end();
+
+            while (buf_first != buf_last) {
+                if (middle == first) {
+                    nano::move_backward(buf_first, buf_last, std::move(last));
+                    break;
+                }
+                if (nano::invoke(comp, nano::invoke(proj, *(buf_last - 1)),
+                                 nano::invoke(proj, *nano::prev(middle)))) {
+                    *--last = nano::iter_move(--middle);
+                } else {
+                    *--last = std::move(*--buf_last);
+                }
+            }
         }
+        buf.clear();
     }
 
     template <typename I, typename S, typename Comp, typename Proj>
-    static I impl(I first, I middle, S last, Comp& comp, Proj& proj)
+    static I impl(I first, I middle, S last, Comp& comp, Proj& proj,
+                  temporary_resource* resource = nullptr)
     {
         auto dist1 = nano::distance(first, middle);
         I ilast = middle;
@@ -8797,7 +9207,7 @@ private:
         }
 
         const auto sz = (nano::min)(dist1, dist2);
-        auto buf = detail::temporary_vector<iter_value_t<I>>(sz);
+        auto buf = detail::temporary_vector<iter_value_t<I>>(sz, resource);
 
         if (buf.capacity() >= static_cast<std::size_t>(sz)) {
             impl_buffered(std::move(first), std::move(middle), std::move(ilast),
@@ -8829,6 +9239,31 @@ public:
         return inplace_merge_fn::impl(nano::begin(rng), std::move(middle),
                                       nano::end(rng), comp, proj);
     }
+
+#if NANO_HAS_MEMORY_RESOURCE
+    // Extension: as above, but any scratch space is obtained from resource
+    template <typename I, typename S, typename Comp = ranges::less, typename Proj = identity>
+    std::enable_if_t<bidirectional_iterator<I> && sentinel_for<S, I> &&
+                         sortable<I, Comp, Proj>, I>
+    operator()(std::pmr::memory_resource* resource, I first, I middle, S last,
+               Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        return inplace_merge_fn::impl(std::move(first), std::move(middle),
+                                      std::move(last), comp, proj, resource);
+    }
+
+    template <typename Rng, typename Comp = ranges::less, typename Proj = identity>
+    std::enable_if_t<bidirectional_range<Rng> &&
+                         sortable<iterator_t<Rng>, Comp, Proj>,
+                     borrowed_iterator_t<Rng>>
+    operator()(std::pmr::memory_resource* resource, Rng&& rng,
+               iterator_t<Rng> middle, Comp comp = Comp{},
+               Proj proj = Proj{}) const
+    {
+        return inplace_merge_fn::impl(nano::begin(rng), std::move(middle),
+                                      nano::end(rng), comp, proj, resource);
+    }
+#endif
 };
 
 }
@@ -8839,28 +9274,66 @@ NANO_END_NAMESPACE
 
 #endif
 
-// nanorange/algorithm/is_heap.hpp
+// nanorange/detail/algorithm/block_merge_sort.hpp
 //
 // Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
 // Distributed under the Boost Software License, Version 1.0. (See accompanying
 // file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
-#ifndef NANORANGE_ALGORITHM_IS_HEAP_HPP_INCLUDED
-#define NANORANGE_ALGORITHM_IS_HEAP_HPP_INCLUDED
+// A stable O(n log n) merge sort which needs only O(sqrt(n)) extra space,
+// for when there is no room for a buffer of half the range. It finds and
+// merges runs in the same order as powersort, but runs which are both too
+// long for the buffer are merged by the block merge of Kim and Kutzner, as
+// used by WikiSort (Mike McFadden, https://github.com/BonzaiThePenguin/WikiSort).
+//
+// To merge A with B, A is cut into blocks of sqrt(n) elements, which are
+// "rolled" through B by swapping each with the next block of B. Whenever
+// the first element of the smallest A block is not greater than the last B
+// value rolled past, that A block is dropped in place, and the previous one
+// is merged with the B values which followed it using the buffer. Every
+// element is swapped O(1) times, so each merge takes linear time.
+//
+// WikiSort keeps the order of the rolled A blocks by overwriting one
+// element of each with a distinct value extracted from the input. Here we
+// track the order in a separate array of block numbers instead, which works
+// whether or not the input has enough distinct values and keeps the
+// extraction and redistribution steps out of the picture.
 
-// nanorange/algorithm/is_heap_until.hpp
+#ifndef NANORANGE_DETAIL_ALGORITHM_BLOCK_MERGE_SORT_HPP_INCLUDED
+#define NANORANGE_DETAIL_ALGORITHM_BLOCK_MERGE_SORT_HPP_INCLUDED
+
+
+
+
+// nanorange/detail/algorithm/powersort.hpp
 //
 // Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
 // Distributed under the Boost Software License, Version 1.0. (See accompanying
 // file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
-// Uses code from CMCSTL2
+// An adaptive, stable merge sort which takes advantage of existing order in
+// its input. It splits the input into maximal ascending and strictly
+// descending runs, reversing the latter, and merges them in the order given
+// by the "powersort" policy of J. Ian Munro and Sebastian Wild, "Nearly-Optimal
+// Mergesorts: Fast, Practical Sorting Methods That Optimally Adapt to Existing
+// Runs" (ESA 2018). The merges gallop through long stretches taken from one
+// run, as in TimSort.
 //
-// Copyright Eric Niebler 2014
-// Copyright Casey Carter 2015
+// A sorted or reverse-sorted input is handled with n - 1 comparisons, and an
+// input made up of r runs with O(n log r) comparisons.
 
-#ifndef NANORANGE_ALGORITHM_IS_HEAP_UNTIL_HPP_INCLUDED
-#define NANORANGE_ALGORITHM_IS_HEAP_UNTIL_HPP_INCLUDED
+#ifndef NANORANGE_DETAIL_ALGORITHM_POWERSORT_HPP_INCLUDED
+#define NANORANGE_DETAIL_ALGORITHM_POWERSORT_HPP_INCLUDED
+
+
+// nanorange/algorithm/reverse.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_ALGORITHM_REVERSE_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_REVERSE_HPP_INCLUDED
 
 
 
@@ -8868,527 +9341,457 @@ NANO_BEGIN_NAMESPACE
 
 namespace detail {
 
-struct is_heap_until_fn {
+struct reverse_fn {
 private:
-    friend struct is_heap_fn;
-
-    template <typename I, typename Comp, typename Proj>
-    static constexpr I impl(I first, const iter_difference_t<I> n, Comp& comp,
-                            Proj& proj)
+    template <typename I>
+    static constexpr I impl(I first, I last)
     {
-        iter_difference_t<I> p = 0, c = 1;
-
-        I pp = first;
-
-        while (c < n) {
-            I cp = first + c;
-
-            if (nano::invoke(comp, nano::invoke(proj, *pp),
-                             nano::invoke(proj, *cp))) {
-                return cp;
-            }
-
-            ++c;
-            ++cp;
-
-            if (c == n || nano::invoke(comp, nano::invoke(proj, *pp),
-                                       nano::invoke(proj, *cp))) {
-                return cp;
-            }
-
-            ++p;
-            ++pp;
-
-            c = 2 * p + 1;
+        I ret = last;
+        while (first != last && first !=  --last) {
+            nano::iter_swap(first, last);
+            ++first;
         }
 
-        return first + n;
-    }
-
-public:
-    template <typename I, typename S, typename Comp = ranges::less,
-              typename Proj = identity>
-    constexpr std::enable_if_t<
-        random_access_iterator<I> && sentinel_for<S, I> &&
-            indirect_strict_weak_order<Comp, projected<I, Proj>>,
-        I>
-    operator()(I first, S last, Comp comp = Comp{}, Proj proj = Proj{}) const
-    {
-        auto n = nano::distance(first, last);
-        return is_heap_until_fn::impl(std::move(first), n, comp, proj);
+        return ret;
     }
 
-    template <typename Rng, typename Comp = ranges::less, typename Proj = identity>
-    constexpr std::enable_if_t<
-        random_access_range<Rng> &&
-        indirect_strict_weak_order<Comp, projected<iterator_t<Rng>, Proj>>,
-        borrowed_iterator_t<Rng>>
-    operator()(Rng&& rng, Comp comp = Comp{}, Proj proj = Proj{}) const
+    template <typename I, typename S>
+    static constexpr std::enable_if_t<
+        !same_as<I, S>, I>
+    impl(I first, S bound)
     {
-        return is_heap_until_fn::impl(nano::begin(rng), nano::distance(rng),
-                                      comp, proj);
+        I last = next(first, bound);
+        return reverse_fn::impl(std::move(first), std::move(last));
     }
-};
-
-} // namespace detail
-
-NANO_INLINE_VAR(detail::is_heap_until_fn, is_heap_until)
-
-NANO_END_NAMESPACE
-
-#endif
-
 
-NANO_BEGIN_NAMESPACE
-
-namespace detail {
-
-struct is_heap_fn {
-    template <typename I, typename S, typename Comp = ranges::less,
-              typename Proj = identity>
-    std::enable_if_t<random_access_iterator<I> && sentinel_for<S, I> &&
-                         indirect_strict_weak_order<Comp, projected<I, Proj>>,
-                     bool>
-    operator()(I first, S last, Comp comp = Comp{}, Proj proj = Proj{}) const
+public:
+    template <typename I, typename S>
+    constexpr std::enable_if_t<bidirectional_iterator<I> && sentinel_for<S, I>,
+        I>
+    operator()(I first, S last) const
     {
-        const auto n = nano::distance(first, last);
-        return is_heap_until_fn::impl(std::move(first), n, comp, proj) == last;
+        return reverse_fn::impl(std::move(first), std::move(last));
     }
 
-    template <typename Rng, typename Comp = ranges::less, typename Proj = identity>
-    std::enable_if_t<
-        random_access_range<Rng> &&
-            indirect_strict_weak_order<Comp, projected<iterator_t<Rng>, Proj>>,
-        bool>
-    operator()(Rng&& rng, Comp comp = Comp{}, Proj proj = Proj{}) const
+    template <typename Rng>
+    constexpr std::enable_if_t<bidirectional_range<Rng>,
+                               borrowed_iterator_t<Rng>>
+    operator()(Rng&& rng) const
     {
-        return is_heap_until_fn::impl(nano::begin(rng), nano::distance(rng),
-                                      comp, proj) == nano::end(rng);
+        return reverse_fn::impl(nano::begin(rng), nano::end(rng));
     }
 };
 
 } // namespace detail
 
-NANO_INLINE_VAR(detail::is_heap_fn, is_heap)
+NANO_INLINE_VAR(detail::reverse_fn, reverse)
 
 NANO_END_NAMESPACE
 
 #endif
 
 
-// nanorange/algorithm/is_partitioned.hpp
+// nanorange/detail/algorithm/pqdsort.hpp
 //
+// Copyright Orson Peters 2017.
 // Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
 // Distributed under the Boost Software License, Version 1.0. (See accompanying
 // file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
-#ifndef NANORANGE_ALGORITHM_IS_PARTITIONED_HPP_INCLUDED
-#define NANORANGE_ALGORITHM_IS_PARTITIONED_HPP_INCLUDED
-
-
-
-NANO_BEGIN_NAMESPACE
-
-namespace detail {
-
-struct is_partitioned_fn {
-private:
-    template <typename I, typename S, typename Pred, typename Proj>
-    static constexpr bool impl(I first, S last, Pred& pred, Proj& proj)
-    {
-        first = nano::find_if_not(std::move(first), last, pred, proj);
-        return nano::find_if(std::move(first), last, pred, proj) == last;
-    }
-
-public:
-    template <typename I, typename S, typename Pred, typename Proj = identity>
-    constexpr std::enable_if_t<
-        input_iterator<I> && sentinel_for<S, I> &&
-            indirect_unary_predicate<Pred, projected<I, Proj>>, bool>
-    operator()(I first, S last, Pred pred = Pred{}, Proj proj = Proj{}) const
-    {
-        return is_partitioned_fn::impl(std::move(first), std::move(last),
-                                       pred, proj);
-    }
-
-    template <typename Rng, typename Pred, typename Proj = identity>
-    constexpr std::enable_if_t<
-        input_range<Rng> &&
-            indirect_unary_predicate<Pred, projected<iterator_t<Rng>, Proj>>, bool>
-    operator()(Rng&& rng, Pred pred = Pred{}, Proj proj = Proj{}) const
-    {
-        return is_partitioned_fn::impl(nano::begin(rng), nano::end(rng),
-                                       pred, proj);
-    }
-};
-
-}
-
-NANO_INLINE_VAR(detail::is_partitioned_fn, is_partitioned)
-
-NANO_END_NAMESPACE
+// Modified from Boost.Sort by Orson Peters
+// https://github.com/boostorg/sort/blob/develop/include/boost/sort/pdqsort/pdqsort.hpp
 
-#endif
+#ifndef NANORANGE_DETAIL_ALGORITHM_PDQSORT_HPP_INCLUDED
+#define NANORANGE_DETAIL_ALGORITHM_PDQSORT_HPP_INCLUDED
 
-// nanorange/algorithm/is_permutation.hpp
+// nanorange/algorithm/make_heap.hpp
 //
 // Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
 // Distributed under the Boost Software License, Version 1.0. (See accompanying
 // file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
-#ifndef NANORANGE_ALGORITHM_IS_PERMUTATION_HPP_INCLUDED
-#define NANORANGE_ALGORITHM_IS_PERMUTATION_HPP_INCLUDED
-
+// Uses code from CMCSTL2
+//  Copyright Eric Niebler 2014
+//  Copyright Casey Carter 2015
 
+#ifndef NANORANGE_ALGORITHM_MAKE_HEAP_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_MAKE_HEAP_HPP_INCLUDED
 
-// nanorange/algorithm/mismatch.hpp
+// nanorange/detail/algorithm/heap_sift.hpp
 //
 // Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
 // Distributed under the Boost Software License, Version 1.0. (See accompanying
 // file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
-#ifndef NANORANGE_ALGORITHM_MISMATCH_HPP_INCLUDED
-#define NANORANGE_ALGORITHM_MISMATCH_HPP_INCLUDED
-
-
-
+// cmcstl2 - A concept-enabled C++ standard library
+//
+//  Copyright Eric Niebler 2014
+//  Copyright Casey Carter 2015
+//
+//  Use, modification and distribution is subject to the
+//  Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+// Project home: https://github.com/caseycarter/cmcstl2
+//
+//===----------------------------------------------------------------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is dual licensed under the MIT and the University of Illinois Open
+// Source Licenses. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+#ifndef NANORANGE_DETAIL_ALGORITHM_HEAP_SIFT_HPP
+#define NANORANGE_DETAIL_ALGORITHM_HEAP_SIFT_HPP
 
-NANO_BEGIN_NAMESPACE
 
-// [range.mismatch]
 
-template <typename I1, typename I2>
-using mismatch_result = in_in_result<I1, I2>;
 
-namespace detail {
 
-struct mismatch_fn {
-private:
-    friend struct is_permutation_fn;
 
-    template <typename I1, typename S1, typename I2, typename Proj1,
-              typename Proj2, typename Pred>
-    static constexpr mismatch_result<I1, I2>
-    impl3(I1 first1, S1 last1, I2 first2, Pred& pred, Proj1& proj1, Proj2& proj2)
-    {
-        while (first1 != last1 &&
-               nano::invoke(pred, nano::invoke(proj1, *first1),
-                            nano::invoke(proj2, *first2))) {
-            ++first1;
-            ++first2;
-        }
+///////////////////////////////////////////////////////////////////////////
+// detail::sift_up_n and detail::sift_down_n, and their d-ary counterparts
+// (heap implementation details)
+//
 
-        return {first1, first2};
-    }
+NANO_BEGIN_NAMESPACE
 
-    template <typename I1, typename S1, typename I2, typename S2,
-              typename Proj1, typename Proj2, typename Pred>
-    static constexpr mismatch_result<I1, I2>
-    impl4(I1 first1, S1 last1, I2 first2, S2 last2, Pred& pred, Proj1& proj1,
-          Proj2& proj2)
-    {
-        while (first1 != last1 && first2 != last2 &&
-               nano::invoke(pred, nano::invoke(proj1, *first1),
-                            nano::invoke(proj2, *first2))) {
-            ++first1;
-            ++first2;
-        }
+namespace detail {
 
-        return {first1, first2};
+template <typename I, typename Comp, typename Proj>
+constexpr void sift_up_n(I first, iter_difference_t<I> n, Comp& comp,
+                         Proj& proj)
+{
+    if (n > 1) {
+        I last = first + n;
+        n = (n - 2) / 2;
+        I i = first + n;
+        if (nano::invoke(comp, nano::invoke(proj, *i),
+                         nano::invoke(proj, *--last))) {
+            iter_value_t<I> v = nano::iter_move(last);
+            do {
+                *last = nano::iter_move(i);
+                last = i;
+                if (n == 0) {
+                    break;
+                }
+                n = (n - 1) / 2;
+                i = first + n;
+            } while (nano::invoke(comp, nano::invoke(proj, *i),
+                                  nano::invoke(proj, v)));
+            *last = std::move(v);
+        }
     }
+}
 
-public:
-    // three legged
-    template <typename I1, typename S1, typename I2, typename Proj1 = identity,
-              typename Proj2 = identity, typename Pred = ranges::equal_to>
-    NANO_DEPRECATED constexpr std::enable_if_t<
-        input_iterator<I1> && sentinel_for<S1, I1> &&
-            input_iterator<std::decay_t<I2>> &&
-        !input_range<I1> &&
-            indirect_relation<Pred, projected<I1, Proj1>, projected<std::decay_t<I2>, Proj2>>,
-        mismatch_result<I1, std::decay_t<I2>>>
-    operator()(I1 first1, S1 last1, I2&& first2, Pred pred = Pred{},
-               Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
-    {
-        return mismatch_fn::impl3(std::move(first1), std::move(last1),
-                                  std::forward<I2>(first2), pred,
-                                  proj1, proj2);
-    }
+template <typename I, typename Comp, typename Proj>
+constexpr void sift_down_n(I first, iter_difference_t<I> n, I start, Comp& comp,
+                           Proj& proj)
+{
+    // left-child of start is at 2 * start + 1
+    // right-child of start is at 2 * start + 2
+    auto child = start - first;
 
-    // range and a half
-    template <typename Rng1, typename I2, typename Proj1 = identity,
-              typename Proj2 = identity, typename Pred = ranges::equal_to>
-    NANO_DEPRECATED constexpr std::enable_if_t<
-        input_range<Rng1> && input_iterator<std::decay_t<I2>> &&
-                !input_range<I2> &&
-            indirect_relation<Pred, projected<iterator_t<Rng1>, Proj1>,
-                             projected<std::decay_t<I2>, Proj2>>,
-        mismatch_result<borrowed_iterator_t<Rng1>, std::decay_t<I2>>>
-    operator()(Rng1&& rng1, I2&& first2, Pred pred = Pred{},
-               Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
-    {
-        return mismatch_fn::impl3(nano::begin(rng1), nano::end(rng1),
-                                  std::forward<I2>(first2), pred,
-                                  proj1, proj2);
+    if (n < 2 || (n - 2) / 2 < child) {
+        return;
     }
 
-    // four legged
-    template <typename I1, typename S1, typename I2, typename S2,
-              typename Proj1 = identity, typename Proj2 = identity,
-              typename Pred = ranges::equal_to>
-    constexpr std::enable_if_t<
-        input_iterator<I1> && sentinel_for<S1, I1> && input_iterator<I2> &&
-            sentinel_for<S2, I2> &&
-            indirect_relation<Pred, projected<I1, Proj1>, projected<I2, Proj2>>,
-        mismatch_result<I1, I2>>
-    operator()(I1 first1, S1 last1, I2 first2, S2 last2, Pred pred = Pred{},
-               Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
-    {
-        return mismatch_fn::impl4(std::move(first1), std::move(last1),
-                                  std::move(first2), std::move(last2),
-                                  pred, proj1, proj2);
-    }
+    child = 2 * child + 1;
+    I child_i = first + child;
 
-    // two ranges
-    template <typename Rng1, typename Rng2, typename Proj1 = identity,
-              typename Proj2 = identity, typename Pred = ranges::equal_to>
-    constexpr std::enable_if_t<
-        input_range<Rng1> && input_range<Rng2> &&
-            indirect_relation<Pred, projected<iterator_t<Rng1>, Proj1>,
-                             projected<iterator_t<Rng2>, Proj2>>,
-        mismatch_result<borrowed_iterator_t<Rng1>, borrowed_iterator_t<Rng2>>>
-    operator()(Rng1&& rng1, Rng2&& rng2, Pred pred = Pred{},
-               Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
-    {
-        return mismatch_fn::impl4(nano::begin(rng1), nano::end(rng1),
-                                  nano::begin(rng2), nano::end(rng2),
-                                  pred, proj1, proj2);
+    if ((child + 1) < n && nano::invoke(comp, nano::invoke(proj, *child_i),
+                                        nano::invoke(proj, *(child_i + 1)))) {
+        // right-child exists and is greater than left-child
+        ++child_i;
+        ++child;
     }
-};
-
-} // namespace detail
-
-NANO_INLINE_VAR(detail::mismatch_fn, mismatch)
 
-NANO_END_NAMESPACE
+    // check if we are in heap-order
+    if (nano::invoke(comp, nano::invoke(proj, *child_i),
+                     nano::invoke(proj, *start))) {
+        // we are, start is larger than its largest child
+        return;
+    }
 
-#endif
+    iter_value_t<I> top = nano::iter_move(start);
+    do {
+        // we are not in heap-order, swap the parent with it's largest child
+        *start = nano::iter_move(child_i);
+        start = child_i;
 
+        if ((n - 2) / 2 < child) {
+            break;
+        }
 
-NANO_BEGIN_NAMESPACE
+        // recompute the child based off of the updated parent
+        child = 2 * child + 1;
+        child_i = first + child;
 
-namespace detail {
+        if ((child + 1) < n &&
+            nano::invoke(comp, nano::invoke(proj, *child_i),
+                         nano::invoke(proj, *(child_i + 1)))) {
+            // right-child exists and is greater than left-child
+            ++child_i;
+            ++child;
+        }
 
-struct is_permutation_fn {
-private:
-    template <typename I1, typename S1, typename I2, typename S2, typename Pred,
-              typename Proj1, typename Proj2>
-    static constexpr bool process_tail(I1 first1, S1 last1, I2 first2, S2 last2,
-                                       Pred& pred, Proj1& proj1, Proj2& proj2)
-    {
-        for (auto it = first1; it != last1; ++it) {
-            const auto comp = [&pred, val = nano::invoke(proj1, *it)]
-                    (const auto& t) { return nano::invoke(pred, t, val); };
+        // check if we are in heap-order
+    } while (!nano::invoke(comp, nano::invoke(proj, *child_i),
+                           nano::invoke(proj, top)));
+    *start = std::move(top);
+}
 
-            // Check whether we have already seen this value
-            if (any_of_fn::impl(first1, it, comp, proj1)) {
-                continue;
-            }
+// Moves the larger child of each element along the path from the top of
+// the heap [first, first + n) up one level, leaving a hole at a leaf, and
+// returns the position of the hole. This takes one comparison per level,
+// rather than the two of sift_down_n, as it doesn't check whether some
+// other element belongs in the hole. Requires n >= 2, and the top element
+// to have been moved out.
+template <typename I, typename Comp, typename Proj>
+constexpr I floyd_sift_down_n(I first, iter_difference_t<I> n, Comp& comp,
+                              Proj& proj)
+{
+    I hole = first;
+    iter_difference_t<I> child = 0;
 
-            // Count how many times *it appears in range2
-            const auto count1 = count_if_fn::impl(first2, last2, comp, proj2);
+    while (true) {
+        child = 2 * child + 1;
+        I child_i = first + child;
 
-            // If we have a count of zero, we know the ranges are different
-            if (count1 == 0) {
-                return false;
-            }
+        if ((child + 1) < n &&
+            nano::invoke(comp, nano::invoke(proj, *child_i),
+                         nano::invoke(proj, *(child_i + 1)))) {
+            // right-child exists and is greater than left-child
+            ++child_i;
+            ++child;
+        }
 
-            // Count how many times *it appears in the remainder of range1
-            // (we can start from one)
-            const auto count2 = iter_difference_t<I1>{1} +
-                count_if_fn::impl(nano::next(it), last1, comp, proj1);
+        *hole = nano::iter_move(child_i);
+        hole = child_i;
 
-            if (count1 != count2) {
-                return false;
-            }
+        if ((n - 2) / 2 < child) {
+            return hole;
         }
-
-        return true;
     }
+}
 
-    template <typename I1, typename S1, typename I2, typename Pred,
-        typename Proj1, typename Proj2>
-    static constexpr bool impl3(I1 first1, S1 last1, I2 first2,
-                                Pred& pred, Proj1& proj1, Proj2& proj2)
-    {
-        // Strip equal prefixes from both ranges
-        auto result = mismatch_fn::impl3(std::move(first1), last1,
-                                         std::move(first2),
-                                         pred, proj1, proj2);
-        first1 = std::move(result).in1;
-        first2 = std::move(result).in2;
+// In a D-ary heap, the children of the element at index i are at indices
+// D * i + 1 to D * i + D, so for small D they share one or two cache lines,
+// and the heap is log2(D) times shallower than a binary heap.
 
-        if (first1 == last1) {
-            return true;
-        }
-
-        // If we have only one value left in range1, it can't be in range2
-        const auto d = nano::distance(first1, last1);
-        if (d == 1) {
-            return false;
+template <std::ptrdiff_t D, typename I, typename Comp, typename Proj>
+constexpr void dary_sift_up_n(I first, iter_difference_t<I> n, Comp& comp,
+                              Proj& proj)
+{
+    if (n > 1) {
+        I last = first + n;
+        n = (n - 2) / D;
+        I i = first + n;
+        if (nano::invoke(comp, nano::invoke(proj, *i),
+                         nano::invoke(proj, *--last))) {
+            iter_value_t<I> v = nano::iter_move(last);
+            do {
+                *last = nano::iter_move(i);
+                last = i;
+                if (n == 0) {
+                    break;
+                }
+                n = (n - 1) / D;
+                i = first + n;
+            } while (nano::invoke(comp, nano::invoke(proj, *i),
+                                  nano::invoke(proj, v)));
+            *last = std::move(v);
         }
-
-        auto last2 = nano::next(first2, d);
-
-        return is_permutation_fn::process_tail(std::move(first1), std::move(last1),
-                                               std::move(first2), std::move(last2),
-                                               pred, proj1, proj2);
     }
+}
 
-    template <typename I1, typename S1, typename I2, typename S2,
-              typename Pred, typename Proj1, typename Proj2>
-    static constexpr bool impl4(I1 first1, S1 last1, I2 first2, S2 last2,
-                                Pred& pred, Proj1& proj1, Proj2& proj2)
-    {
-        // Strip equal prefixes from both ranges
-        auto result = mismatch_fn::impl4(std::move(first1), last1,
-                                         std::move(first2), last2,
-                                         pred, proj1, proj2);
-        first1 = std::move(result).in1;
-        first2 = std::move(result).in2;
+// Returns the index of the largest of the K elements starting at index i.
+// The elements are compared in a balanced tournament, so the chain of
+// dependent comparisons is log2(K) long rather than K - 1.
+template <std::ptrdiff_t K, typename I, typename Comp, typename Proj>
+constexpr iter_difference_t<I> dary_largest_of(I first, iter_difference_t<I> i,
+                                               Comp& comp, Proj& proj)
+{
+    if constexpr (K == 1) {
+        return i;
+    } else {
+        const auto a = detail::dary_largest_of<K / 2>(first, i, comp, proj);
+        const auto b =
+            detail::dary_largest_of<K - K / 2>(first, i + K / 2, comp, proj);
+        // Ties go to the left, as in a sequential scan
+        return nano::invoke(comp, nano::invoke(proj, first[a]),
+                            nano::invoke(proj, first[b]))
+                   ? b : a;
+    }
+}
 
-        // If we have reached the end of both ranges, they were the same
-        if (first1 == last1 && first2 == last2) {
-            return true;
-        }
+// Returns the index of the largest of the children of a D-ary heap element,
+// the first of which is at index child
+template <std::ptrdiff_t D, typename I, typename Comp, typename Proj>
+constexpr iter_difference_t<I>
+dary_largest_child(I first, iter_difference_t<I> n, iter_difference_t<I> child,
+                   Comp& comp, Proj& proj)
+{
+    if (n - child >= D) {
+        return detail::dary_largest_of<D>(first, child, comp, proj);
+    }
 
-        // If we have different numbers of elements left in the ranges,
-        // they are not permutations of one another
-        if (nano::distance(first1, last1) != nano::distance(first2, last2)) {
-            return false;
+    auto largest = child;
+    for (auto c = child + 1; c < n; ++c) {
+        if (nano::invoke(comp, nano::invoke(proj, first[largest]),
+                         nano::invoke(proj, first[c]))) {
+            largest = c;
         }
-
-        return is_permutation_fn::process_tail(std::move(first1), std::move(last1),
-                                               std::move(first2), std::move(last2),
-                                               pred, proj1, proj2);
     }
+    return largest;
+}
 
-public:
-    // Four-legged
-    template <typename I1, typename S1, typename I2, typename S2,
-              typename Pred = ranges::equal_to, typename Proj1 = identity,
-              typename Proj2 = identity>
-    constexpr
-        std::enable_if_t<
-        forward_iterator<I1> && sentinel_for<S1, I1> && forward_iterator<I2> &&
-            sentinel_for<S2, I2> &&
-            indirectly_comparable<I1, I2, Pred, Proj1, Proj2>,
-                         bool>
-    operator()(I1 first1, S1 last1, I2 first2, S2 last2, Pred pred = Pred{},
-               Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
-    {
-        if constexpr (sized_sentinel_for<S1, I1> &&
-                      sized_sentinel_for<S2, I2>) {
-            if (nano::distance(first1, last1) != nano::distance(first2, last2)) {
-                return false;
+// The D * D grandchildren of an element are adjacent, so while we choose
+// between its children, we can fetch all the candidates for the next level
+template <std::ptrdiff_t D, typename I>
+constexpr void dary_prefetch_grandchildren(I first, iter_difference_t<I> n,
+                                           iter_difference_t<I> parent)
+{
+    using ref_t = iter_reference_t<I>;
+    if constexpr (std::is_lvalue_reference<ref_t>::value &&
+                  !std::is_volatile<std::remove_reference_t<ref_t>>::value) {
+        if (!detail::is_constant_evaluated()) {
+            const auto begin = D * (D * parent + 1) + 1;
+            const auto end = begin + D * D < n ? begin + D * D : n;
+            constexpr iter_difference_t<I> step =
+                sizeof(iter_value_t<I>) < 64 ? 64 / sizeof(iter_value_t<I>) : 1;
+            for (auto i = begin; i < end; i += step) {
+                detail::simd_prefetch(std::addressof(first[i]));
+            }
+            if (begin < end) {
+                detail::simd_prefetch(std::addressof(first[end - 1]));
             }
-            return is_permutation_fn::impl3(std::move(first1), std::move(last1),
-                                            std::move(first2), pred,
-                                            proj1, proj2);
         }
+    }
+}
 
-        return is_permutation_fn::impl4(std::move(first1), std::move(last1),
-                                        std::move(first2), std::move(last2),
-                                        pred, proj1, proj2);
+template <std::ptrdiff_t D, typename I, typename Comp, typename Proj>
+constexpr void dary_sift_down_n(I first, iter_difference_t<I> n, I start,
+                                Comp& comp, Proj& proj)
+{
+    auto parent = start - first;
+
+    // the last element with children is at (n - 2) / D
+    if (n < 2 || (n - 2) / D < parent) {
+        return;
     }
 
-    // Three-legged
-    template <typename I1, typename S1, typename I2,
-        typename Pred = ranges::equal_to, typename Proj1 = identity,
-        typename Proj2 = identity>
-    NANO_DEPRECATED
-    constexpr
-    std::enable_if_t<
-        forward_iterator<I1> && sentinel_for<S1, I1> && forward_iterator<I2> &&
-            indirectly_comparable<I1, I2, Pred, Proj1, Proj2>,
-        bool>
-    operator()(I1 first1, S1 last1, I2 first2, Pred pred = Pred{},
-               Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
-    {
-        return is_permutation_fn::impl3(std::move(first1), std::move(last1),
-                                        std::move(first2), pred,
-                                        proj1, proj2);
+    detail::dary_prefetch_grandchildren<D>(first, n, parent);
+    auto child = detail::dary_largest_child<D>(first, n, D * parent + 1, comp,
+                                               proj);
+    I child_i = first + child;
 
+    // check if we are in heap-order
+    if (nano::invoke(comp, nano::invoke(proj, *child_i),
+                     nano::invoke(proj, *start))) {
+        return;
     }
 
-    // Two ranges
-    template <typename Rng1, typename Rng2, typename Pred = ranges::equal_to,
-              typename Proj1 = identity, typename Proj2 = identity>
-    constexpr std::enable_if_t<
-        forward_range<Rng1> && forward_range<Rng2> &&
-            indirectly_comparable<iterator_t<Rng1>, iterator_t<Rng2>, Pred,
-                                 Proj1, Proj2>,
-        bool>
-    operator()(Rng1&& rng1, Rng2&& rng2, Pred pred = Pred{},
-               Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
+    iter_value_t<I> top = nano::iter_move(start);
+    do {
+        *start = nano::iter_move(child_i);
+        start = child_i;
+        parent = child;
+
+        if ((n - 2) / D < parent) {
+            break;
+        }
+
+        detail::dary_prefetch_grandchildren<D>(first, n, parent);
+        child = detail::dary_largest_child<D>(first, n, D * parent + 1, comp,
+                                              proj);
+        child_i = first + child;
+    } while (!nano::invoke(comp, nano::invoke(proj, *child_i),
+                           nano::invoke(proj, top)));
+    *start = std::move(top);
+}
+
+} // namespace detail
+
+NANO_END_NAMESPACE
+
+#endif
+
+
+
+NANO_BEGIN_NAMESPACE
+
+namespace detail {
+
+struct make_heap_fn {
+private:
+    template <typename I, typename Comp, typename Proj>
+    static constexpr I impl(I first, iter_difference_t<I> n, Comp& comp,
+                            Proj& proj)
     {
-        if (sized_range<Rng1> && sized_range<Rng2>) {
-            if (nano::distance(rng1) != nano::distance(rng2)) {
-                return false;
+        if (n > 1) {
+            // start from the first parent, there is no need to consider
+            // children
+            for (auto start = (n - 2) / 2; start >= 0; --start) {
+                detail::sift_down_n(first, n, first + start, comp, proj);
             }
-
-            return is_permutation_fn::impl3(nano::begin(rng1), nano::end(rng1),
-                                            nano::begin(rng2), pred,
-                                            proj1, proj2);
         }
 
-        return is_permutation_fn::impl4(nano::begin(rng1), nano::end(rng1),
-                                        nano::begin(rng2), nano::end(rng2),
-                                        pred, proj1, proj2);
+        return first + n;
     }
 
-    // Range and a half
-    template <typename Rng1, typename I2, typename Pred = ranges::equal_to,
-        typename Proj1 = identity, typename Proj2 = identity>
-    NANO_DEPRECATED
-    constexpr std::enable_if_t<
-        forward_range<Rng1> && forward_iterator<std::decay_t<I2>> &&
-        !range<I2> &&
-            indirectly_comparable<iterator_t<Rng1>, I2, Pred, Proj1, Proj2>,
-        bool>
-    operator()(Rng1&& rng1, I2&& first2, Pred pred = Pred{},
-               Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const {
-        return is_permutation_fn::impl3(nano::begin(rng1), nano::end(rng1),
-                                        std::forward<I2>(first2), pred,
-                                        proj1, proj2);
+public:
+    template <typename I, typename S, typename Comp = ranges::less,
+              typename Proj = identity>
+    constexpr std::enable_if_t<random_access_iterator<I> && sentinel_for<S, I> &&
+                                   sortable<I, Comp, Proj>, I>
+    operator()(I first, S last, Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        const auto n = nano::distance(first, last);
+        return make_heap_fn::impl(std::move(first), n, comp, proj);
+    }
+
+    template <typename Rng, typename Comp = ranges::less, typename Proj = identity>
+    constexpr std::enable_if_t<random_access_range<Rng> &&
+                                   sortable<iterator_t<Rng>, Comp>,
+                               borrowed_iterator_t<Rng>>
+    operator()(Rng&& rng, Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        return make_heap_fn::impl(nano::begin(rng), nano::distance(rng), comp,
+                                  proj);
     }
 };
 
 } // namespace detail
 
-NANO_INLINE_VAR(detail::is_permutation_fn, is_permutation)
+NANO_INLINE_VAR(detail::make_heap_fn, make_heap)
 
 NANO_END_NAMESPACE
 
 #endif
 
-// nanorange/algorithm/is_sorted.hpp
+
+// nanorange/algorithm/sort_heap.hpp
 //
 // Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
 // Distributed under the Boost Software License, Version 1.0. (See accompanying
 // file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
-#ifndef NANORANGE_ALGORITHM_IS_SORTED_HPP_INCLUDED
-#define NANORANGE_ALGORITHM_IS_SORTED_HPP_INCLUDED
+#ifndef NANORANGE_ALGORITHM_SORT_HEAP_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_SORT_HEAP_HPP_INCLUDED
 
-// nanorange/algorithm/is_sorted_until.hpp
+// nanorange/algorithm/pop_heap.hpp
 //
 // Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
 // Distributed under the Boost Software License, Version 1.0. (See accompanying
 // file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
-#ifndef NANORANGE_ALGORITHM_IS_SORTED_UNTIL_HPP_INCLUDED
-#define NANORANGE_ALGORITHM_IS_SORTED_UNTIL_HPP_INCLUDED
+#ifndef NANORANGE_ALGORITHM_POP_HEAP_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_POP_HEAP_HPP_INCLUDED
+
 
 
 
@@ -9396,58 +9799,62 @@ NANO_BEGIN_NAMESPACE
 
 namespace detail {
 
-struct is_sorted_until_fn {
+struct pop_heap_fn {
 private:
-    friend struct is_sorted_fn;
+    friend struct sort_heap_fn;
 
-    template <typename I, typename S, typename Comp, typename Proj>
-    static constexpr I impl(I first, S last, Comp& comp, Proj& proj)
+    // The element moved to the top from the back of the heap usually
+    // belongs near the bottom again. So rather than sifting it down, which
+    // compares it against the larger child at each level, we move the
+    // larger children up all the way down to a leaf, put it in the hole
+    // there and sift it up, which usually takes only a step or two. This
+    // is Floyd's bottom-up variant, and takes about half the comparisons.
+    template <typename I, typename Comp, typename Proj>
+    static constexpr I impl(I first, iter_difference_t<I> n, Comp& comp,
+                            Proj& proj)
     {
-        if (first == last) {
-            return first;
-        }
-
-        I n = next(first);
+        if (n > 1) {
+            I last = first + (n - 1);
+            iter_value_t<I> top = nano::iter_move(first);
+            I hole = detail::floyd_sift_down_n(first, n, comp, proj);
 
-        while (n != last) {
-            if (nano::invoke(comp, nano::invoke(proj, *n),
-                              nano::invoke(proj, *first))) {
-                return n;
+            if (hole == last) {
+                *hole = std::move(top);
+            } else {
+                *hole = nano::iter_move(last);
+                *last = std::move(top);
+                detail::sift_up_n(first, (hole - first) + 1, comp, proj);
             }
-            ++first;
-            ++n;
         }
 
-        return n;
+        return first + n;
     }
 
 public:
     template <typename I, typename S, typename Comp = ranges::less,
               typename Proj = identity>
-    constexpr std::enable_if_t<
-        forward_iterator<I> && sentinel_for<S, I> &&
-            indirect_strict_weak_order<Comp, projected<I, Proj>>, I>
+    constexpr std::enable_if_t<random_access_iterator<I> && sentinel_for<S, I> &&
+                                   sortable<I, Comp, Proj>, I>
     operator()(I first, S last, Comp comp = Comp{}, Proj proj = Proj{}) const
     {
-        return is_sorted_until_fn::impl(std::move(first), std::move(last),
-                                        comp, proj);
+        const auto n = nano::distance(first, last);
+        return pop_heap_fn::impl(std::move(first), n, comp, proj);
     }
 
     template <typename Rng, typename Comp = ranges::less, typename Proj = identity>
-    constexpr std::enable_if_t<
-        forward_range<Rng> &&
-            indirect_strict_weak_order<Comp, projected<iterator_t<Rng>, Proj>>,
-        borrowed_iterator_t<Rng>>
+    constexpr std::enable_if_t<random_access_range<Rng> &&
+                                   sortable<iterator_t<Rng>, Comp, Proj>,
+                               borrowed_iterator_t<Rng>>
     operator()(Rng&& rng, Comp comp = Comp{}, Proj proj = Proj{}) const
     {
-        return is_sorted_until_fn::impl(nano::begin(rng), nano::end(rng),
-                                        comp, proj);
+        return pop_heap_fn::impl(nano::begin(rng), nano::distance(rng), comp,
+                                 proj);
     }
 };
 
-}
+} // namespace detail
 
-NANO_INLINE_VAR(detail::is_sorted_until_fn, is_sorted_until)
+NANO_INLINE_VAR(detail::pop_heap_fn, pop_heap)
 
 NANO_END_NAMESPACE
 
@@ -9458,257 +9865,382 @@ NANO_BEGIN_NAMESPACE
 
 namespace detail {
 
-struct is_sorted_fn {
+struct sort_heap_fn {
+private:
+    template <typename I, typename Comp, typename Proj>
+    static constexpr I impl(I first, iter_difference_t<I> n, Comp& comp,
+                            Proj& proj)
+    {
+        if (n < 2) {
+            return first + n;
+        }
+
+        for (auto i = n; i > 1; --i) {
+            pop_heap_fn::impl(first, i, comp, proj);
+        }
+
+        return first + n;
+    }
+
+public:
     template <typename I, typename S, typename Comp = ranges::less,
-            typename Proj = identity>
-    constexpr std::enable_if_t<
-        forward_iterator<I> && sentinel_for<S, I> &&
-            indirect_strict_weak_order<Comp, projected<I, Proj>>, bool>
+              typename Proj = identity>
+    constexpr std::enable_if_t<random_access_iterator<I> && sentinel_for<S, I> &&
+                                   sortable<I, Comp, Proj>, I>
     operator()(I first, S last, Comp comp = Comp{}, Proj proj = Proj{}) const
     {
-        return is_sorted_until_fn::impl(std::move(first), last,
-                                        comp, proj) == last;
+        const auto n = nano::distance(first, last);
+        return sort_heap_fn::impl(std::move(first), n, comp, proj);
     }
 
     template <typename Rng, typename Comp = ranges::less, typename Proj = identity>
-    constexpr std::enable_if_t<
-        forward_range<Rng> &&
-            indirect_strict_weak_order<Comp, projected<iterator_t<Rng>, Proj>>,
-        bool>
+    constexpr std::enable_if_t<random_access_range<Rng> &&
+                                   sortable<iterator_t<Rng>, Comp, Proj>,
+                               borrowed_iterator_t<Rng>>
     operator()(Rng&& rng, Comp comp = Comp{}, Proj proj = Proj{}) const
     {
-        return is_sorted_until_fn::impl(nano::begin(rng), nano::end(rng),
-                                        comp, proj) == nano::end(rng);
+        return sort_heap_fn::impl(nano::begin(rng), nano::distance(rng), comp,
+                                  proj);
     }
 };
 
-}
+} // namespace detail
 
-NANO_INLINE_VAR(detail::is_sorted_fn, is_sorted)
+NANO_INLINE_VAR(detail::sort_heap_fn, sort_heap)
 
 NANO_END_NAMESPACE
 
 #endif
 
+// nanorange/detail/algorithm/sorting_network.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Sorting networks for 2 to 16 elements. Each is a fixed sequence of
+// compare-exchange operations, so for arithmetic values compared in their
+// natural order the whole sort compiles to straight-line code with
+// conditional moves, and no branches to mispredict. The networks are those
+// with the fewest comparators known (optimal for up to 12 elements), as
+// listed by Bert Dobbelaere, "SorterHunter"
+// (https://bertdobbelaere.github.io/sorting_networks.html); the network for
+// 15 elements is the one for 16 with its last input removed. Each row is one
+// layer of independent comparators.
 
-// nanorange/algorithm/stl/lexicographical_compare.hpp
+#ifndef NANORANGE_DETAIL_ALGORITHM_SORTING_NETWORK_HPP_INCLUDED
+#define NANORANGE_DETAIL_ALGORITHM_SORTING_NETWORK_HPP_INCLUDED
+
+// nanorange/detail/algorithm/radix_sort.hpp
 //
 // Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
 // Distributed under the Boost Software License, Version 1.0. (See accompanying
 // file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
-#ifndef NANORANGE_ALGORITHM_LEXICOGRAPHICAL_COMPARE_HPP_INCLUDED
-#define NANORANGE_ALGORITHM_LEXICOGRAPHICAL_COMPARE_HPP_INCLUDED
+#ifndef NANORANGE_DETAIL_ALGORITHM_RADIX_SORT_HPP_INCLUDED
+#define NANORANGE_DETAIL_ALGORITHM_RADIX_SORT_HPP_INCLUDED
+
 
 
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <new>
 
 NANO_BEGIN_NAMESPACE
 
 namespace detail {
 
-struct lexicographical_compare_fn {
-private:
-    template <typename I1, typename S1, typename I2, typename S2,
-              typename Comp, typename Proj1, typename Proj2>
-    static constexpr bool impl(I1 first1, S1 last1, I2 first2, S2 last2,
-                                Comp& comp, Proj1& proj1, Proj2& proj2)
-    {
-        while (first1 != last1 && first2 != last2) {
-            if (nano::invoke(comp, nano::invoke(proj1, *first1),
-                              nano::invoke(proj2, *first2))) {
-                return true;
-            }
-            if (nano::invoke(comp, nano::invoke(proj2, *first2),
-                             nano::invoke(proj1, *first1))) {
-                return false;
-            }
-            ++first1; ++first2;
-        }
+// Keys which we know how to map to an unsigned integer with the same ordering
+template <typename K>
+inline constexpr bool is_radix_key =
+    (std::is_integral<K>::value && sizeof(K) <= 8) ||
+    (std::is_floating_point<K>::value && std::numeric_limits<K>::is_iec559 &&
+     (sizeof(K) == 4 || sizeof(K) == 8));
 
-        return first1 == last1 && first2 != last2;
-    }
+template <std::size_t Size>
+struct radix_uint;
 
-public:
-    template <typename I1, typename S1, typename I2, typename S2,
-              typename Comp = ranges::less, typename Proj1 = identity,
-              typename Proj2 = identity>
-    constexpr std::enable_if_t<
-        input_iterator<I1> && sentinel_for<S1, I1> && input_iterator<I2> &&
-            sentinel_for<S2, I2> &&
-            indirect_strict_weak_order<Comp, projected<I1, Proj1>, projected<I2, Proj2>>,
-        bool>
-    operator()(I1 first1, S1 last1, I2 first2, S2 last2, Comp comp = Comp{},
-               Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
-    {
-        return lexicographical_compare_fn::impl(
-                std::move(first1), std::move(last1),
-                std::move(first2), std::move(last2),
-                comp, proj1, proj2);
+template <> struct radix_uint<1> { using type = std::uint8_t; };
+template <> struct radix_uint<2> { using type = std::uint16_t; };
+template <> struct radix_uint<4> { using type = std::uint32_t; };
+template <> struct radix_uint<8> { using type = std::uint64_t; };
+
+template <typename K>
+using radix_uint_t = typename radix_uint<sizeof(K)>::type;
+
+// Returns an unsigned integer which compares (with <) in the same way that
+// key does
+template <typename K>
+radix_uint_t<K> radix_encode(K key)
+{
+    using U = radix_uint_t<K>;
+    constexpr U sign_bit = U(1) << (8 * sizeof(U) - 1);
+
+    U u;
+    if constexpr (std::is_same<K, bool>::value) {
+        u = key;
+    } else {
+        std::memcpy(&u, &key, sizeof(U));
     }
 
-    template <typename Rng1, typename Rng2, typename Comp = ranges::less,
-              typename Proj1 = identity, typename Proj2 = identity>
-    constexpr std::enable_if_t<
-        input_range<Rng1> && input_range<Rng2> &&
-            indirect_strict_weak_order<Comp, projected<iterator_t<Rng1>, Proj1>,
-                                      projected<iterator_t<Rng2>, Proj2>>,
-            bool>
-    operator()(Rng1&& rng1, Rng2&& rng2, Comp comp = Comp{},
-               Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
-    {
-        return lexicographical_compare_fn::impl(
-                nano::begin(rng1), nano::end(rng1),
-                nano::begin(rng2), nano::end(rng2),
-                comp, proj1, proj2);
+    if constexpr (std::is_floating_point<K>::value) {
+        // Negative numbers are stored as sign and magnitude, so we flip all
+        // the bits to reverse their order; positive numbers need only move
+        // above them
+        return (u & sign_bit) ? U(~u) : U(u | sign_bit);
+    } else if constexpr (std::is_signed<K>::value) {
+        return U(u ^ sign_bit);
+    } else {
+        return u;
     }
-};
+}
+
+// 1 if Comp sorts keys of type K in ascending order, -1 if descending, and
+// 0 if we can't tell
+template <typename Comp, typename K>
+inline constexpr int radix_direction = 0;
+
+template <typename K>
+inline constexpr int radix_direction<ranges::less, K> = 1;
+template <typename K>
+inline constexpr int radix_direction<std::less<>, K> = 1;
+template <typename K>
+inline constexpr int radix_direction<std::less<K>, K> = 1;
+template <typename K>
+inline constexpr int radix_direction<ranges::greater, K> = -1;
+template <typename K>
+inline constexpr int radix_direction<std::greater<>, K> = -1;
+template <typename K>
+inline constexpr int radix_direction<std::greater<K>, K> = -1;
+
+// Ranges shorter than this are sorted faster by pdqsort
+template <typename K>
+inline constexpr int radix_sort_threshold = 512 * int(sizeof(K));
+
+template <typename I, typename Proj>
+using radix_key_t = remove_cvref_t<indirect_result_t<Proj&, I>>;
 
+template <typename I, typename Comp, typename Proj,
+          bool = random_access_iterator<I> &&
+                 invocable<Proj&, iter_reference_t<I>>>
+inline constexpr bool is_radix_sortable = false;
+
+template <typename I, typename Comp, typename Proj>
+inline constexpr bool is_radix_sortable<I, Comp, Proj, true> =
+    std::is_same<iter_reference_t<I>, iter_value_t<I>&>::value &&
+    std::is_trivially_copyable<iter_value_t<I>>::value &&
+    is_radix_key<radix_key_t<I, Proj>> &&
+    radix_direction<Comp, radix_key_t<I, Proj>> != 0;
+
+// Buckets are sorted by LSD passes over all of their remaining digits when
+// that amount of work is below this limit, so that it runs on data which fits
+// in cache. Larger buckets are split by their most significant digit first.
+constexpr int radix_sort_lsd_limit = 1 << 18;
+
+// Below this size, the fixed cost of an LSD sort is too high and we split by
+// the most significant digit instead
+constexpr int radix_sort_lsd_min = 256;
+
+// Buckets no larger than this are insertion sorted
+constexpr int radix_sort_insertion_limit = 32;
+
+// Moves v into *out. The scratch buffer is raw memory, so when writing to a
+// pointer we construct in place; this is fine for the trivially copyable,
+// trivially destructible types we sort, even if there is already an object
+// there.
+template <typename V>
+void radix_put(V* out, V& v)
+{
+    ::new (static_cast<void*>(out)) V(std::move(v));
 }
 
-NANO_INLINE_VAR(detail::lexicographical_compare_fn, lexicographical_compare)
+template <typename I, typename V>
+void radix_put(I out, V& v)
+{
+    *out = std::move(v);
+}
 
-NANO_END_NAMESPACE
+template <typename Src, typename Dst, typename D>
+void radix_move(Src src, Dst dst, D n)
+{
+    for (D i = 0; i < n; ++i) {
+        detail::radix_put(dst + i, *(src + i));
+    }
+}
 
-#endif
+template <typename K, typename Comp, typename Proj>
+struct radix_sorter {
+    using U = radix_uint_t<K>;
 
+    Proj& proj;
 
-// nanorange/algorithm/make_heap.hpp
-//
-// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
-// Distributed under the Boost Software License, Version 1.0. (See accompanying
-// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+    template <typename T>
+    U key(T& elem) const
+    {
+        const U u = detail::radix_encode<K>(nano::invoke(proj, elem));
+        return radix_direction<Comp, K> > 0 ? u : U(~u);
+    }
 
-// Uses code from CMCSTL2
-//  Copyright Eric Niebler 2014
-//  Copyright Casey Carter 2015
+    static unsigned digit(U u, int d)
+    {
+        return static_cast<unsigned>((u >> (8 * d)) & 0xFF);
+    }
 
-#ifndef NANORANGE_ALGORITHM_MAKE_HEAP_HPP_INCLUDED
-#define NANORANGE_ALGORITHM_MAKE_HEAP_HPP_INCLUDED
+    // Moves [src, src + n) to [dst, dst + n) ordered by digit d, given the
+    // starting offset of each bucket
+    template <typename Src, typename Dst, typename D>
+    void scatter(Src src, Dst dst, D n, int d, D (&offsets)[256]) const
+    {
+        for (D i = 0; i < n; ++i) {
+            auto& elem = *(src + i);
+            detail::radix_put(dst + offsets[digit(key(elem), d)]++, elem);
+        }
+    }
 
-// nanorange/detail/algorithm/heap_sift.hpp
-//
-// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
-// Distributed under the Boost Software License, Version 1.0. (See accompanying
-// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+    // Sorts the n elements at src on the low num_digits digits of their
+    // keys, using the n elements at dst as scratch space. The result ends up
+    // at src if result_in_src is true, and at dst otherwise.
+    template <typename Src, typename Dst, typename D>
+    void sort(Src src, Dst dst, D n, int num_digits, bool result_in_src) const
+    {
+        if (n <= radix_sort_insertion_limit || num_digits == 0) {
+            if (result_in_src) {
+                insertion_sort(src, n);
+            } else {
+                detail::radix_move(src, dst, n);
+                insertion_sort(dst, n);
+            }
+        } else if (n >= radix_sort_lsd_min &&
+                   n * num_digits <= radix_sort_lsd_limit) {
+            lsd_sort(src, dst, n, num_digits, result_in_src);
+        } else {
+            msd_sort(src, dst, n, num_digits, result_in_src);
+        }
+    }
 
-// cmcstl2 - A concept-enabled C++ standard library
-//
-//  Copyright Eric Niebler 2014
-//  Copyright Casey Carter 2015
-//
-//  Use, modification and distribution is subject to the
-//  Boost Software License, Version 1.0. (See accompanying
-//  file LICENSE_1_0.txt or copy at
-//  http://www.boost.org/LICENSE_1_0.txt)
-//
-// Project home: https://github.com/caseycarter/cmcstl2
-//
-//===----------------------------------------------------------------------===//
-//
-//                     The LLVM Compiler Infrastructure
-//
-// This file is dual licensed under the MIT and the University of Illinois Open
-// Source Licenses. See LICENSE.TXT for details.
-//
-//===----------------------------------------------------------------------===//
-//
-#ifndef NANORANGE_DETAIL_ALGORITHM_HEAP_SIFT_HPP
-#define NANORANGE_DETAIL_ALGORITHM_HEAP_SIFT_HPP
+    template <typename It, typename D>
+    void insertion_sort(It first, D n) const
+    {
+        for (D i = 1; i < n; ++i) {
+            iter_value_t<It> tmp = std::move(*(first + i));
+            const U k = key(tmp);
+            D j = i;
+            for (; j > 0 && k < key(*(first + (j - 1))); --j) {
+                *(first + j) = std::move(*(first + (j - 1)));
+            }
+            *(first + j) = std::move(tmp);
+        }
+    }
 
+    template <typename Src, typename Dst, typename D>
+    void lsd_sort(Src src, Dst dst, D n, int num_digits,
+                  bool result_in_src) const
+    {
+        // Build the histograms for every digit in a single pass
+        D counts[sizeof(U)][256] = {};
+        for (D i = 0; i < n; ++i) {
+            const U u = key(*(src + i));
+            for (int d = 0; d < num_digits; ++d) {
+                ++counts[d][digit(u, d)];
+            }
+        }
+        const U first_key = key(*src);
 
+        bool in_src = true;
+        for (int d = 0; d < num_digits; ++d) {
+            // If every element has the same digit, this pass would do nothing
+            if (counts[d][digit(first_key, d)] == n) {
+                continue;
+            }
 
+            D offsets[256];
+            D sum = 0;
+            for (int b = 0; b < 256; ++b) {
+                offsets[b] = sum;
+                sum += counts[d][b];
+            }
 
+            if (in_src) {
+                scatter(src, dst, n, d, offsets);
+            } else {
+                scatter(dst, src, n, d, offsets);
+            }
+            in_src = !in_src;
+        }
 
-///////////////////////////////////////////////////////////////////////////
-// detail::sift_up_n and detail::sift_down_n
-// (heap implementation details)
-//
+        if (in_src != result_in_src) {
+            if (in_src) {
+                detail::radix_move(src, dst, n);
+            } else {
+                detail::radix_move(dst, src, n);
+            }
+        }
+    }
 
-NANO_BEGIN_NAMESPACE
+    template <typename Src, typename Dst, typename D>
+    void msd_sort(Src src, Dst dst, D n, int num_digits,
+                  bool result_in_src) const
+    {
+        const int d = num_digits - 1;
 
-namespace detail {
+        D counts[256] = {};
+        for (D i = 0; i < n; ++i) {
+            ++counts[digit(key(*(src + i)), d)];
+        }
 
-template <typename I, typename Comp, typename Proj>
-constexpr void sift_up_n(I first, iter_difference_t<I> n, Comp& comp,
-                         Proj& proj)
-{
-    if (n > 1) {
-        I last = first + n;
-        n = (n - 2) / 2;
-        I i = first + n;
-        if (nano::invoke(comp, nano::invoke(proj, *i),
-                         nano::invoke(proj, *--last))) {
-            iter_value_t<I> v = nano::iter_move(last);
-            do {
-                *last = nano::iter_move(i);
-                last = i;
-                if (n == 0) {
-                    break;
-                }
-                n = (n - 1) / 2;
-                i = first + n;
-            } while (nano::invoke(comp, nano::invoke(proj, *i),
-                                  nano::invoke(proj, v)));
-            *last = std::move(v);
+        if (counts[digit(key(*src), d)] == n) {
+            sort(src, dst, n, d, result_in_src);
+            return;
+        }
+
+        D offsets[256];
+        D sum = 0;
+        for (int b = 0; b < 256; ++b) {
+            offsets[b] = sum;
+            sum += counts[b];
+        }
+        scatter(src, dst, n, d, offsets);
+
+        // The elements are now at dst, so the roles of the two buffers swap
+        D start = 0;
+        for (int b = 0; b < 256; ++b) {
+            if (counts[b] > 0) {
+                sort(dst + start, src + start, counts[b], d, !result_in_src);
+            }
+            start += counts[b];
         }
     }
-}
+};
 
+// Sorts [first, last) by radix sorting the projected keys, one byte at a
+// time. The sort is stable. Returns false, leaving the range untouched, if a
+// temporary buffer could not be allocated.
 template <typename I, typename Comp, typename Proj>
-constexpr void sift_down_n(I first, iter_difference_t<I> n, I start, Comp& comp,
-                           Proj& proj)
+bool radix_sort(I first, I last, Comp&, Proj& proj)
 {
-    // left-child of start is at 2 * start + 1
-    // right-child of start is at 2 * start + 2
-    auto child = start - first;
+    using V = iter_value_t<I>;
+    using K = radix_key_t<I, Proj>;
 
-    if (n < 2 || (n - 2) / 2 < child) {
-        return;
-    }
-
-    child = 2 * child + 1;
-    I child_i = first + child;
-
-    if ((child + 1) < n && nano::invoke(comp, nano::invoke(proj, *child_i),
-                                        nano::invoke(proj, *(child_i + 1)))) {
-        // right-child exists and is greater than left-child
-        ++child_i;
-        ++child;
+    const auto n = last - first;
+    if (n < 2) {
+        return true;
     }
 
-    // check if we are in heap-order
-    if (nano::invoke(comp, nano::invoke(proj, *child_i),
-                     nano::invoke(proj, *start))) {
-        // we are, start is larger than its largest child
-        return;
+    struct deleter {
+        void operator()(V* ptr) const { ::operator delete(ptr); }
+    };
+    std::unique_ptr<V, deleter> buf(static_cast<V*>(::operator new(
+        static_cast<std::size_t>(n) * sizeof(V), std::nothrow)));
+    if (!buf) {
+        return false;
     }
 
-    iter_value_t<I> top = nano::iter_move(start);
-    do {
-        // we are not in heap-order, swap the parent with it's largest child
-        *start = nano::iter_move(child_i);
-        start = child_i;
-
-        if ((n - 2) / 2 < child) {
-            break;
-        }
-
-        // recompute the child based off of the updated parent
-        child = 2 * child + 1;
-        child_i = first + child;
-
-        if ((child + 1) < n &&
-            nano::invoke(comp, nano::invoke(proj, *child_i),
-                         nano::invoke(proj, *(child_i + 1)))) {
-            // right-child exists and is greater than left-child
-            ++child_i;
-            ++child;
-        }
-
-        // check if we are in heap-order
-    } while (!nano::invoke(comp, nano::invoke(proj, *child_i),
-                           nano::invoke(proj, top)));
-    *start = std::move(top);
+    radix_sorter<K, Comp, Proj>{proj}.sort(std::move(first), buf.get(), n,
+                                           int(sizeof(K)), true);
+    return true;
 }
 
 } // namespace detail
@@ -9719,303 +10251,5945 @@ NANO_END_NAMESPACE
 
 
 
+
+#include <cstddef>
+#include <utility>
+
 NANO_BEGIN_NAMESPACE
 
 namespace detail {
 
-struct make_heap_fn {
-private:
-    template <typename I, typename Comp, typename Proj>
-    static constexpr I impl(I first, iter_difference_t<I> n, Comp& comp,
-                            Proj& proj)
-    {
-        if (n > 1) {
-            // start from the first parent, there is no need to consider
-            // children
-            for (auto start = (n - 2) / 2; start >= 0; --start) {
-                detail::sift_down_n(first, n, first + start, comp, proj);
-            }
-        }
+// The largest number of elements for which we have a network
+constexpr std::ptrdiff_t sorting_network_max = 16;
 
-        return first + n;
-    }
+// The comparators of the network for N elements, as pairs of positions
+template <std::size_t N>
+struct sorting_network_pairs;
 
-public:
-    template <typename I, typename S, typename Comp = ranges::less,
-              typename Proj = identity>
-    constexpr std::enable_if_t<random_access_iterator<I> && sentinel_for<S, I> &&
-                                   sortable<I, Comp, Proj>, I>
-    operator()(I first, S last, Comp comp = Comp{}, Proj proj = Proj{}) const
-    {
-        const auto n = nano::distance(first, last);
-        return make_heap_fn::impl(std::move(first), n, comp, proj);
-    }
+template <>
+struct sorting_network_pairs<2> {
+    static constexpr unsigned char value[][2] = {
+        {0, 1},
+    };
+};
 
-    template <typename Rng, typename Comp = ranges::less, typename Proj = identity>
-    constexpr std::enable_if_t<random_access_range<Rng> &&
-                                   sortable<iterator_t<Rng>, Comp>,
-                               borrowed_iterator_t<Rng>>
-    operator()(Rng&& rng, Comp comp = Comp{}, Proj proj = Proj{}) const
-    {
-        return make_heap_fn::impl(nano::begin(rng), nano::distance(rng), comp,
-                                  proj);
-    }
+template <>
+struct sorting_network_pairs<3> {
+    static constexpr unsigned char value[][2] = {
+        {0, 2},
+        {0, 1},
+        {1, 2},
+    };
 };
 
-} // namespace detail
+template <>
+struct sorting_network_pairs<4> {
+    static constexpr unsigned char value[][2] = {
+        {0, 2}, {1, 3},
+        {0, 1}, {2, 3},
+        {1, 2},
+    };
+};
 
-NANO_INLINE_VAR(detail::make_heap_fn, make_heap)
+template <>
+struct sorting_network_pairs<5> {
+    static constexpr unsigned char value[][2] = {
+        {0, 3}, {1, 4},
+        {0, 2}, {1, 3},
+        {0, 1}, {2, 4},
+        {1, 2}, {3, 4},
+        {2, 3},
+    };
+};
 
-NANO_END_NAMESPACE
+template <>
+struct sorting_network_pairs<6> {
+    static constexpr unsigned char value[][2] = {
+        {0, 5}, {1, 3}, {2, 4},
+        {1, 2}, {3, 4},
+        {0, 3}, {2, 5},
+        {0, 1}, {2, 3}, {4, 5},
+        {1, 2}, {3, 4},
+    };
+};
 
-#endif
+template <>
+struct sorting_network_pairs<7> {
+    static constexpr unsigned char value[][2] = {
+        {0, 6}, {2, 3}, {4, 5},
+        {0, 2}, {1, 4}, {3, 6},
+        {0, 1}, {2, 5}, {3, 4},
+        {1, 2}, {4, 6},
+        {2, 3}, {4, 5},
+        {1, 2}, {3, 4}, {5, 6},
+    };
+};
 
-// nanorange/algorithm/max.hpp
-//
-// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
-// Distributed under the Boost Software License, Version 1.0. (See accompanying
-// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+template <>
+struct sorting_network_pairs<8> {
+    static constexpr unsigned char value[][2] = {
+        {0, 2}, {1, 3}, {4, 6}, {5, 7},
+        {0, 4}, {1, 5}, {2, 6}, {3, 7},
+        {0, 1}, {2, 3}, {4, 5}, {6, 7},
+        {2, 4}, {3, 5},
+        {1, 4}, {3, 6},
+        {1, 2}, {3, 4}, {5, 6},
+    };
+};
 
-#ifndef NANORANGE_ALGORITHM_MAX_HPP_INCLUDED
-#define NANORANGE_ALGORITHM_MAX_HPP_INCLUDED
+template <>
+struct sorting_network_pairs<9> {
+    static constexpr unsigned char value[][2] = {
+        {0, 3}, {1, 7}, {2, 5}, {4, 8},
+        {0, 7}, {2, 4}, {3, 8}, {5, 6},
+        {0, 2}, {1, 3}, {4, 5}, {7, 8},
+        {1, 4}, {3, 6}, {5, 7},
+        {0, 1}, {2, 4}, {3, 5}, {6, 8},
+        {2, 3}, {4, 5}, {6, 7},
+        {1, 2}, {3, 4}, {5, 6},
+    };
+};
 
+template <>
+struct sorting_network_pairs<10> {
+    static constexpr unsigned char value[][2] = {
+        {0, 8}, {1, 9}, {2, 7}, {3, 5}, {4, 6},
+        {0, 2}, {1, 4}, {5, 8}, {7, 9},
+        {0, 3}, {2, 4}, {5, 7}, {6, 9},
+        {0, 1}, {3, 6}, {8, 9},
+        {1, 5}, {2, 3}, {4, 8}, {6, 7},
+        {1, 2}, {3, 5}, {4, 6}, {7, 8},
+        {2, 3}, {4, 5}, {6, 7},
+        {3, 4}, {5, 6},
+    };
+};
 
+template <>
+struct sorting_network_pairs<11> {
+    static constexpr unsigned char value[][2] = {
+        {0, 9}, {1, 6}, {2, 4}, {3, 7}, {5, 8},
+        {0, 1}, {3, 5}, {4, 10}, {6, 9}, {7, 8},
+        {1, 3}, {2, 5}, {4, 7}, {8, 10},
+        {0, 4}, {1, 2}, {3, 7}, {5, 9}, {6, 8},
+        {0, 1}, {2, 6}, {4, 5}, {7, 8}, {9, 10},
+        {2, 4}, {3, 6}, {5, 7}, {8, 9},
+        {1, 2}, {3, 4}, {5, 6}, {7, 8},
+        {2, 3}, {4, 5}, {6, 7},
+    };
+};
 
-NANO_BEGIN_NAMESPACE
+template <>
+struct sorting_network_pairs<12> {
+    static constexpr unsigned char value[][2] = {
+        {0, 8}, {1, 7}, {2, 6}, {3, 11}, {4, 10}, {5, 9},
+        {0, 1}, {2, 5}, {3, 4}, {6, 9}, {7, 8}, {10, 11},
+        {0, 2}, {1, 6}, {5, 10}, {9, 11},
+        {0, 3}, {1, 2}, {4, 6}, {5, 7}, {8, 11}, {9, 10},
+        {1, 4}, {3, 5}, {6, 8}, {7, 10},
+        {1, 3}, {2, 5}, {6, 9}, {8, 10},
+        {2, 3}, {4, 5}, {6, 7}, {8, 9},
+        {4, 6}, {5, 7},
+        {3, 4}, {5, 6}, {7, 8},
+    };
+};
 
-namespace detail {
+template <>
+struct sorting_network_pairs<13> {
+    static constexpr unsigned char value[][2] = {
+        {0, 12}, {1, 10}, {2, 9}, {3, 7}, {5, 11}, {6, 8},
+        {1, 6}, {2, 3}, {4, 11}, {7, 9}, {8, 10},
+        {0, 4}, {1, 2}, {3, 6}, {7, 8}, {9, 10}, {11, 12},
+        {4, 6}, {5, 9}, {8, 11}, {10, 12},
+        {0, 5}, {3, 8}, {4, 7}, {6, 11}, {9, 10},
+        {0, 1}, {2, 5}, {6, 9}, {7, 8}, {10, 11},
+        {1, 3}, {2, 4}, {5, 6}, {9, 10},
+        {1, 2}, {3, 4}, {5, 7}, {6, 8},
+        {2, 3}, {4, 5}, {6, 7}, {8, 9},
+        {3, 4}, {5, 6},
+    };
+};
 
-struct max_fn {
-private:
-    template <typename Rng, typename Comp, typename Proj>
-    static constexpr iter_value_t<iterator_t<Rng>>
-    impl(Rng&& rng, Comp& comp, Proj& proj)
-    {
-        auto first = nano::begin(rng);
-        const auto last = nano::end(rng);
+template <>
+struct sorting_network_pairs<14> {
+    static constexpr unsigned char value[][2] = {
+        {0, 1}, {2, 3}, {4, 5}, {6, 7}, {8, 9}, {10, 11}, {12, 13},
+        {0, 2}, {1, 3}, {4, 8}, {5, 9}, {10, 12}, {11, 13},
+        {0, 4}, {1, 2}, {3, 7}, {5, 8}, {6, 10}, {9, 13}, {11, 12},
+        {0, 6}, {1, 5}, {3, 9}, {4, 10}, {7, 13}, {8, 12},
+        {2, 10}, {3, 11}, {4, 6}, {7, 9},
+        {1, 3}, {2, 8}, {5, 11}, {6, 7}, {10, 12},
+        {1, 4}, {2, 6}, {3, 5}, {7, 11}, {8, 10}, {9, 12},
+        {2, 4}, {3, 6}, {5, 8}, {7, 10}, {9, 11},
+        {3, 4}, {5, 6}, {7, 8}, {9, 10},
+        {6, 7},
+    };
+};
 
-        // Empty ranges not allowed
-        auto result = *first;
+template <>
+struct sorting_network_pairs<15> {
+    static constexpr unsigned char value[][2] = {
+        {0, 13}, {1, 12}, {3, 14}, {4, 8}, {5, 6}, {7, 11}, {9, 10},
+        {0, 5}, {1, 7}, {2, 9}, {3, 4}, {6, 13}, {8, 14}, {11, 12},
+        {0, 1}, {2, 3}, {4, 5}, {6, 8}, {7, 9}, {10, 11}, {12, 13},
+        {0, 2}, {1, 3}, {4, 10}, {5, 11}, {6, 7}, {8, 9}, {12, 14},
+        {1, 2}, {3, 12}, {4, 6}, {5, 7}, {8, 10}, {9, 11}, {13, 14},
+        {1, 4}, {2, 6}, {5, 8}, {7, 10}, {9, 13}, {11, 14},
+        {2, 4}, {3, 6}, {9, 12}, {11, 13},
+        {3, 5}, {6, 8}, {7, 9}, {10, 12},
+        {3, 4}, {5, 6}, {7, 8}, {9, 10}, {11, 12},
+        {6, 7}, {8, 9},
+    };
+};
 
-        while(++first != last) {
-            auto&& val = *first;
-            if (nano::invoke(comp, nano::invoke(proj, result),
-                              nano::invoke(proj, val))) {
-                result = std::forward<decltype(val)>(val);
-            }
-        }
+template <>
+struct sorting_network_pairs<16> {
+    static constexpr unsigned char value[][2] = {
+        {0, 13}, {1, 12}, {2, 15}, {3, 14}, {4, 8}, {5, 6}, {7, 11}, {9, 10},
+        {0, 5}, {1, 7}, {2, 9}, {3, 4}, {6, 13}, {8, 14}, {10, 15}, {11, 12},
+        {0, 1}, {2, 3}, {4, 5}, {6, 8}, {7, 9}, {10, 11}, {12, 13}, {14, 15},
+        {0, 2}, {1, 3}, {4, 10}, {5, 11}, {6, 7}, {8, 9}, {12, 14}, {13, 15},
+        {1, 2}, {3, 12}, {4, 6}, {5, 7}, {8, 10}, {9, 11}, {13, 14},
+        {1, 4}, {2, 6}, {5, 8}, {7, 10}, {9, 13}, {11, 14},
+        {2, 4}, {3, 6}, {9, 12}, {11, 13},
+        {3, 5}, {6, 8}, {7, 9}, {10, 12},
+        {3, 4}, {5, 6}, {7, 8}, {9, 10}, {11, 12},
+        {6, 7}, {8, 9},
+    };
+};
 
-        return result;
+// Compilers tend to turn a compare-exchange of floating point values back
+// into a branch, so we use the SSE2 min and max instructions directly. These
+// return their second operand when the first is not less (or greater) than
+// it, which gives exactly the same results as the comparisons below, NaNs
+// and signed zeros included.
+template <typename T, typename Comp>
+inline constexpr bool is_simd_network_candidate =
+    NANO_HAS_SSE2 &&
+    (std::is_same<T, float>::value || std::is_same<T, double>::value) &&
+    radix_direction<std::remove_const_t<Comp>, T> != 0;
+
+#if NANO_HAS_SSE2
+template <int Direction>
+inline void simd_network_exchange(float& x, float& y)
+{
+    const __m128 a = _mm_set_ss(x);
+    const __m128 b = _mm_set_ss(y);
+    if constexpr (Direction > 0) {
+        x = _mm_cvtss_f32(_mm_min_ss(b, a));
+        y = _mm_cvtss_f32(_mm_max_ss(a, b));
+    } else {
+        x = _mm_cvtss_f32(_mm_max_ss(b, a));
+        y = _mm_cvtss_f32(_mm_min_ss(a, b));
     }
+}
 
-public:
-    template <typename T, typename Comp = ranges::less, typename Proj = identity>
-    constexpr std::enable_if_t<
-        indirect_strict_weak_order<Comp, projected<const T*, Proj>>,
-    const T&>
-    operator()(const T& a, const T& b, Comp comp = Comp{}, Proj proj = Proj{}) const
-    {
-        // *sigh*, this should be fixed in STL2
-        return !nano::invoke(comp, nano::invoke(proj, a),
-                            nano::invoke(proj, b)) ? a : b;
+template <int Direction>
+inline void simd_network_exchange(double& x, double& y)
+{
+    const __m128d a = _mm_set_sd(x);
+    const __m128d b = _mm_set_sd(y);
+    if constexpr (Direction > 0) {
+        x = _mm_cvtsd_f64(_mm_min_sd(b, a));
+        y = _mm_cvtsd_f64(_mm_max_sd(a, b));
+    } else {
+        x = _mm_cvtsd_f64(_mm_max_sd(b, a));
+        y = _mm_cvtsd_f64(_mm_min_sd(a, b));
     }
+}
+#endif
 
-    template <typename T, typename Comp = ranges::less, typename Proj = identity>
-    constexpr std::enable_if_t<
-        copyable<T> &&
-            indirect_strict_weak_order<Comp, projected<const T*, Proj>>,
-            T>
-    operator()(std::initializer_list<T> rng, Comp comp = Comp{},
-               Proj proj = Proj{}) const
-    {
-        return max_fn::impl(rng, comp, proj);
+// Puts *a and *b in order. With Branchless, both results are selected
+// unconditionally, which lets the compiler use conditional moves. Each
+// selection is written out with its own comparison, as that is the form the
+// compiler recognises.
+template <bool Branchless, typename I, typename Comp, typename Proj>
+constexpr void sorting_network_exchange(I a, I b, Comp& comp, Proj& proj)
+{
+    if constexpr (Branchless) {
+        using T = iter_value_t<I>;
+        T x = *a;
+        T y = *b;
+#if NANO_HAS_SSE2
+        if constexpr (is_simd_network_candidate<T, Comp>) {
+            if (!detail::is_constant_evaluated()) {
+                detail::simd_network_exchange<
+                    radix_direction<std::remove_const_t<Comp>, T>>(x, y);
+                *a = x;
+                *b = y;
+                return;
+            }
+        }
+#endif
+        *a = nano::invoke(comp, y, x) ? y : x;
+        *b = nano::invoke(comp, y, x) ? x : y;
+    } else {
+        if (nano::invoke(comp, nano::invoke(proj, *b),
+                         nano::invoke(proj, *a))) {
+            nano::iter_swap(a, b);
+        }
     }
+}
 
-    template <typename Rng, typename Comp = ranges::less, typename Proj = identity>
-    constexpr std::enable_if_t<
-        input_range<Rng> && copyable<iter_value_t<iterator_t<Rng>>> &&
-            indirect_strict_weak_order<Comp, projected<iterator_t<Rng>, Proj>>,
-    range_value_t<Rng>>
-    operator()(Rng&& rng, Comp comp = Comp{}, Proj proj = Proj{}) const
-    {
-        return max_fn::impl(std::forward<Rng>(rng), comp, proj);
+template <bool Branchless, std::size_t N, typename I, typename Comp,
+          typename Proj, std::size_t... Is>
+constexpr void sorting_network_apply(I first, Comp& comp, Proj& proj,
+                                     std::index_sequence<Is...>)
+{
+    using pairs = sorting_network_pairs<N>;
+    (detail::sorting_network_exchange<Branchless>(
+         first + pairs::value[Is][0], first + pairs::value[Is][1], comp, proj),
+     ...);
+}
+
+// Sorts the N elements beginning at first, for N <= sorting_network_max.
+// Branchless may only be set for arithmetic values with the identity
+// projection.
+template <bool Branchless, std::size_t N, typename I, typename Comp,
+          typename Proj>
+constexpr void sorting_network(I first, Comp& comp, Proj& proj)
+{
+    static_assert(N <= sorting_network_max);
+    if constexpr (N >= 2) {
+        using pairs = sorting_network_pairs<N>;
+        detail::sorting_network_apply<Branchless, N>(
+            std::move(first), comp, proj,
+            std::make_index_sequence<sizeof(pairs::value) /
+                                     sizeof(pairs::value[0])>{});
     }
-};
+}
 
+// As above, choosing the network for n elements at run time
+template <bool Branchless, typename I, typename Comp, typename Proj>
+constexpr void sorting_network(I first, iter_difference_t<I> n, Comp& comp,
+                               Proj& proj)
+{
+    switch (n) {
+    case 2:
+        detail::sorting_network<Branchless, 2>(std::move(first), comp, proj);
+        break;
+    case 3:
+        detail::sorting_network<Branchless, 3>(std::move(first), comp, proj);
+        break;
+    case 4:
+        detail::sorting_network<Branchless, 4>(std::move(first), comp, proj);
+        break;
+    case 5:
+        detail::sorting_network<Branchless, 5>(std::move(first), comp, proj);
+        break;
+    case 6:
+        detail::sorting_network<Branchless, 6>(std::move(first), comp, proj);
+        break;
+    case 7:
+        detail::sorting_network<Branchless, 7>(std::move(first), comp, proj);
+        break;
+    case 8:
+        detail::sorting_network<Branchless, 8>(std::move(first), comp, proj);
+        break;
+    case 9:
+        detail::sorting_network<Branchless, 9>(std::move(first), comp, proj);
+        break;
+    case 10:
+        detail::sorting_network<Branchless, 10>(std::move(first), comp, proj);
+        break;
+    case 11:
+        detail::sorting_network<Branchless, 11>(std::move(first), comp, proj);
+        break;
+    case 12:
+        detail::sorting_network<Branchless, 12>(std::move(first), comp, proj);
+        break;
+    case 13:
+        detail::sorting_network<Branchless, 13>(std::move(first), comp, proj);
+        break;
+    case 14:
+        detail::sorting_network<Branchless, 14>(std::move(first), comp, proj);
+        break;
+    case 15:
+        detail::sorting_network<Branchless, 15>(std::move(first), comp, proj);
+        break;
+    case 16:
+        detail::sorting_network<Branchless, 16>(std::move(first), comp, proj);
+        break;
+    default:
+        break;
+    }
 }
 
-NANO_INLINE_VAR(detail::max_fn, max)
+} // namespace detail
 
 NANO_END_NAMESPACE
 
 #endif
 
-// nanorange/algorithm/max_element.hpp
-//
-// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
-// Distributed under the Boost Software License, Version 1.0. (See accompanying
-// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
-
-#ifndef NANORANGE_ALGORITHM_MAX_ELEMENT_HPP_INCLUDED
-#define NANORANGE_ALGORITHM_MAX_ELEMENT_HPP_INCLUDED
-
 
 
 NANO_BEGIN_NAMESPACE
 
 namespace detail {
 
-struct max_element_fn {
-    template <typename I, typename S, typename Comp, typename Proj>
-    static constexpr I impl(I first, S last, Comp& comp, Proj& proj)
-    {
-        if (first == last) {
-            return first;
-        }
+// Partitions below this size are sorted using insertion sort.
+constexpr int pdqsort_insertion_sort_threshold = 24;
 
-        I i = nano::next(first);
-        while (i != last) {
-            if (!nano::invoke(comp, nano::invoke(proj, *i),
-                              nano::invoke(proj, *first))) {
-                first = i;
-            }
-            ++i;
-        }
+// Partitions above this size use Tukey's ninther to select the pivot.
+constexpr int pdqsort_ninther_threshold = 128;
 
-        return first;
-    }
+// When we detect an already sorted partition, attempt an insertion sort that
+// allows this amount of element moves before giving up.
+constexpr int pqdsort_partial_insertion_sort_limit = 8;
 
-public:
-    template <typename I, typename S, typename Comp = ranges::less,
-            typename Proj = identity>
-    constexpr std::enable_if_t<
-        forward_iterator<I> && sentinel_for<S, I> &&
-            indirect_strict_weak_order<Comp, projected<I, Proj>>, I>
-    operator()(I first, S last, Comp comp = Comp{}, Proj proj = Proj{}) const
-    {
-        return max_element_fn::impl(std::move(first), std::move(last),
-                                    comp, proj);
-    }
+// Must be multiple of 8 due to loop unrolling, and < 256 to fit in unsigned
+// char.
+constexpr int pdqsort_block_size = 64;
 
-    template <typename Rng, typename Comp = ranges::less, typename Proj = identity>
-    constexpr std::enable_if_t<
-        forward_range<Rng> &&
-            indirect_strict_weak_order<Comp, projected<iterator_t<Rng>, Proj>>,
-        borrowed_iterator_t<Rng>>
-    operator()(Rng&& rng, Comp comp = Comp{}, Proj proj = Proj{}) const
-    {
-        return max_element_fn::impl(nano::begin(rng), nano::end(rng),
-                                    comp, proj);
-    }
-};
+// Cacheline size, assumes power of two.
+constexpr int pdqsort_cacheline_size = 64;
 
-}
+template <typename>
+struct is_default_compare : std::false_type {};
+template <>
+struct is_default_compare<nano::less> : std::true_type {};
+template <>
+struct is_default_compare<nano::greater> : std::true_type {};
+template <typename T>
+struct is_default_compare<std::less<T>> : std::true_type {};
+template <typename T>
+struct is_default_compare<std::greater<T>> : std::true_type {};
 
-NANO_INLINE_VAR(detail::max_element_fn, max_element)
+template <typename T>
+constexpr bool is_default_compare_v = is_default_compare<T>::value;
 
-NANO_END_NAMESPACE
+// Returns floor(log2(n)), assumes n > 0.
+template <class T>
+constexpr int log2(T n)
+{
+    int log = 0;
+    while (n >>= 1)
+        ++log;
+    return log;
+}
 
-#endif
+// Sorts [begin, end) using insertion sort with the given comparison function.
+template <typename I, typename Comp, typename Proj>
+constexpr void insertion_sort(I begin, I end, Comp& comp, Proj& proj)
+{
+    using T = iter_value_t<I>;
 
+    if (begin == end) {
+        return;
+    }
 
+    for (I cur = begin + 1; cur != end; ++cur) {
+        I sift = cur;
+        I sift_1 = cur - 1;
 
-// nanorange/algorithm/min_element.hpp
-//
-// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
-// Distributed under the Boost Software License, Version 1.0. (See accompanying
-// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+        // Compare first so we can avoid 2 moves for an element already
+        // positioned correctly.
+        if (nano::invoke(comp, nano::invoke(proj, *sift),
+                         nano::invoke(proj, *sift_1))) {
+            T tmp = nano::iter_move(sift);
 
-#ifndef NANORANGE_ALGORITHM_MIN_ELEMENT_HPP_INCLUDED
-#define NANORANGE_ALGORITHM_MIN_ELEMENT_HPP_INCLUDED
+            do {
+                *sift-- = nano::iter_move(sift_1);
+            } while (sift != begin &&
+                     nano::invoke(comp, nano::invoke(proj, tmp),
+                                  nano::invoke(proj, *--sift_1)));
 
+            *sift = std::move(tmp);
+        }
+    }
+}
 
+// Sorts [begin, end) using insertion sort with the given comparison function.
+// Assumes
+// *(begin - 1) is an element smaller than or equal to any element in [begin,
+// end).
+template <typename I, typename Comp, typename Proj>
+constexpr void unguarded_insertion_sort(I begin, I end, Comp& comp, Proj& proj)
+{
+    using T = iter_value_t<I>;
 
-NANO_BEGIN_NAMESPACE
+    if (begin == end) {
+        return;
+    }
 
-namespace detail {
+    for (I cur = begin + 1; cur != end; ++cur) {
+        I sift = cur;
+        I sift_1 = cur - 1;
 
-struct min_element_fn {
-private:
-    friend struct nth_element_fn;
+        // Compare first so we can avoid 2 moves for an element already
+        // positioned correctly.
+        if (nano::invoke(comp, nano::invoke(proj, *sift),
+                         nano::invoke(proj, *sift_1))) {
+            T tmp = nano::iter_move(sift);
 
-    template <typename I, typename S, typename Comp, typename Proj>
-    static constexpr I impl(I first, S last, Comp& comp, Proj& proj)
-    {
-        if (first == last) {
-            return first;
-        }
+            do {
+                *sift-- = nano::iter_move(sift_1);
+            } while (nano::invoke(comp, nano::invoke(proj, tmp),
+                                  nano::invoke(proj, *--sift_1)));
 
-        I i = nano::next(first);
-        while (i != last) {
-            if (nano::invoke(comp, nano::invoke(proj, *i),
-                             nano::invoke(proj, *first))) {
-                first = i;
-            }
-            ++i;
+            *sift = std::move(tmp);
         }
-
-        return first;
     }
+}
 
-public:
-    template <typename I, typename S, typename Comp = ranges::less,
-              typename Proj = identity>
-    constexpr std::enable_if_t<
-        forward_iterator<I> && sentinel_for<S, I> &&
-            indirect_strict_weak_order<Comp, projected<I, Proj>>, I>
-    operator()(I first, S last, Comp comp = Comp{}, Proj proj = Proj{}) const
-    {
-        return min_element_fn::impl(std::move(first), std::move(last),
-                                    comp, proj);
-    }
+// Attempts to use insertion sort on [begin, end). Will return false if more
+// than partial_insertion_sort_limit elements were moved, and abort sorting.
+// Otherwise it will successfully sort and return true.
+template <typename I, typename Comp, typename Proj>
+constexpr bool partial_insertion_sort(I begin, I end, Comp& comp, Proj& proj)
+{
+    using T = iter_value_t<I>;
 
-    template <typename Rng, typename Comp = ranges::less, typename Proj = identity>
-    constexpr std::enable_if_t<
-        forward_range<Rng> &&
-            indirect_strict_weak_order<Comp, projected<iterator_t<Rng>, Proj>>,
-        borrowed_iterator_t<Rng>>
-    operator()(Rng&& rng, Comp comp = Comp{}, Proj proj = Proj{}) const
-    {
-        return min_element_fn::impl(nano::begin(rng), nano::end(rng),
-                                    comp, proj);
+    if (begin == end) {
+        return true;
     }
-};
 
-}
+    iter_difference_t<I> limit = 0;
+    for (I cur = begin + 1; cur != end; ++cur) {
+        if (limit > pqdsort_partial_insertion_sort_limit) {
+            return false;
+        }
 
-NANO_INLINE_VAR(detail::min_element_fn, min_element)
+        I sift = cur;
+        I sift_1 = cur - 1;
 
-NANO_END_NAMESPACE
+        // Compare first so we can avoid 2 moves for an element already
+        // positioned correctly.
+        if (nano::invoke(comp, nano::invoke(proj, *sift),
+                         nano::invoke(proj, *sift_1))) {
+            T tmp = nano::iter_move(sift);
 
-#endif
+            do {
+                *sift-- = nano::iter_move(sift_1);
+            } while (sift != begin &&
+                     nano::invoke(comp, nano::invoke(proj, tmp),
+                                  nano::invoke(proj, *--sift_1)));
 
-// nanorange/algorithm/minmax.hpp
-//
-// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
-// Distributed under the Boost Software License, Version 1.0. (See accompanying
-// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+            *sift = std::move(tmp);
+            limit += cur - sift;
+        }
+    }
 
-// Uses code from CMCSTL2
-// Copyright Casey Carter 2015
+    return true;
+}
 
-#ifndef NANORANGE_ALGORITHM_MINMAX_HPP_INCLUDED
-#define NANORANGE_ALGORITHM_MINMAX_HPP_INCLUDED
+template <typename I, typename Comp, typename Proj>
+constexpr void sort2(I a, I b, Comp& comp, Proj& proj)
+{
+    if (nano::invoke(comp, nano::invoke(proj, *b), nano::invoke(proj, *a))) {
+        nano::iter_swap(a, b);
+    }
+}
 
+// Sorts the elements *a, *b and *c using comparison function comp.
+template <typename I, typename Comp, typename Proj>
+constexpr void sort3(I a, I b, I c, Comp& comp, Proj& proj)
+{
+    sort2(a, b, comp, proj);
+    sort2(b, c, comp, proj);
+    sort2(a, b, comp, proj);
+}
 
+template <typename I>
+constexpr void swap_offsets(I first, I last, unsigned char* offsets_l,
+                            unsigned char* offsets_r, int num, bool use_swaps)
+{
+    using T = iter_value_t<I>;
+    if (use_swaps) {
+        // This case is needed for the descending distribution, where we need
+        // to have proper swapping for pdqsort to remain O(n).
+        for (int i = 0; i < num; ++i) {
+            nano::iter_swap(first + offsets_l[i], last - offsets_r[i]);
+        }
+    } else if (num > 0) {
+        I l = first + offsets_l[0];
+        I r = last - offsets_r[0];
+        T tmp(nano::iter_move(l));
+        *l = nano::iter_move(r);
 
+        for (int i = 1; i < num; ++i) {
+            l = first + offsets_l[i];
+            *r = nano::iter_move(l);
+            r = last - offsets_r[i];
+            *l = nano::iter_move(r);
+        }
+        *r = std::move(tmp);
+    }
+}
 
-NANO_BEGIN_NAMESPACE
+// Partitions [begin, end) around pivot *begin using comparison function comp.
+// Elements equal to the pivot are put in the right-hand partition. Returns the
+// position of the pivot after partitioning and whether the passed sequence
+// already was correctly partitioned. Assumes the pivot is a median of at least
+// 3 elements and that [begin, end) is at least insertion_sort_threshold long.
+// Uses branchless partitioning.
+template <typename I, typename Comp, typename Pred>
+constexpr std::pair<I, bool> partition_right_branchless(I begin, I end,
+                                                        Comp& comp, Pred& pred)
+{
+    using T = iter_value_t<I>;
 
-template <typename T>
-using minmax_result = min_max_result<T>;
+    // Move pivot into local for speed.
+    T pivot(nano::iter_move(begin));
+    I first = begin;
+    I last = end;
 
-namespace detail {
+    // Find the first element greater than or equal than the pivot (the median
+    // of 3 guarantees this exists).
+    while (nano::invoke(comp, nano::invoke(pred, *++first),
+                        nano::invoke(pred, pivot)))
+        ;
 
-struct minmax_fn {
-private:
-    template <typename Rng, typename Comp, typename Proj,
-              typename T = iter_value_t<iterator_t<Rng>>>
-    static constexpr minmax_result<T>
+    // Find the first element strictly smaller than the pivot. We have to guard
+    // this search if there was no element before *first.
+    if (first - 1 == begin) {
+        while (first < last && !nano::invoke(comp, nano::invoke(pred, *--last),
+                                             nano::invoke(pred, pivot)))
+            ;
+    } else {
+        while (!nano::invoke(comp, nano::invoke(pred, *--last),
+                             nano::invoke(pred, pivot)))
+            ;
+    }
+
+    // If the first pair of elements that should be swapped to partition are the
+    // same element, the passed in sequence already was correctly partitioned.
+    bool already_partitioned = first >= last;
+    if (!already_partitioned) {
+        nano::iter_swap(first, last);
+        ++first;
+    }
+
+    // The following branchless partitioning is derived from "BlockQuicksort:
+    // How Branch Mispredictions don't affect Quicksort" by Stefan Edelkamp and
+    // Armin Weiss.
+    alignas(pdqsort_cacheline_size) unsigned char
+        offsets_l_storage[pdqsort_block_size] = {};
+    alignas(pdqsort_cacheline_size) unsigned char
+        offsets_r_storage[pdqsort_block_size] = {};
+    unsigned char* offsets_l = offsets_l_storage;
+    unsigned char* offsets_r = offsets_r_storage;
+    int num_l = 0, num_r = 0, start_l = 0, start_r = 0;
+
+    while (last - first > 2 * pdqsort_block_size) {
+        // Fill up offset blocks with elements that are on the wrong side.
+        if (num_l == 0) {
+            start_l = 0;
+            I it = first;
+            for (unsigned char i = 0; i < pdqsort_block_size;) {
+                offsets_l[num_l] = i++;
+                num_l += !nano::invoke(comp, nano::invoke(pred, *it),
+                                       nano::invoke(pred, pivot));
+                ++it;
+                offsets_l[num_l] = i++;
+                num_l += !nano::invoke(comp, nano::invoke(pred, *it),
+                                       nano::invoke(pred, pivot));
+                ++it;
+                offsets_l[num_l] = i++;
+                num_l += !nano::invoke(comp, nano::invoke(pred, *it),
+                                       nano::invoke(pred, pivot));
+                ++it;
+                offsets_l[num_l] = i++;
+                num_l += !nano::invoke(comp, nano::invoke(pred, *it),
+                                       nano::invoke(pred, pivot));
+                ++it;
+                offsets_l[num_l] = i++;
+                num_l += !nano::invoke(comp, nano::invoke(pred, *it),
+                                       nano::invoke(pred, pivot));
+                ++it;
+                offsets_l[num_l] = i++;
+                num_l += !nano::invoke(comp, nano::invoke(pred, *it),
+                                       nano::invoke(pred, pivot));
+                ++it;
+                offsets_l[num_l] = i++;
+                num_l += !nano::invoke(comp, nano::invoke(pred, *it),
+                                       nano::invoke(pred, pivot));
+                ++it;
+                offsets_l[num_l] = i++;
+                num_l += !nano::invoke(comp, nano::invoke(pred, *it),
+                                       nano::invoke(pred, pivot));
+                ++it;
+            }
+        }
+        if (num_r == 0) {
+            start_r = 0;
+            I it = last;
+            for (unsigned char i = 0; i < pdqsort_block_size;) {
+                offsets_r[num_r] = ++i;
+                num_r += nano::invoke(comp, nano::invoke(pred, *--it),
+                                      nano::invoke(pred, pivot));
+                offsets_r[num_r] = ++i;
+                num_r += nano::invoke(comp, nano::invoke(pred, *--it),
+                                      nano::invoke(pred, pivot));
+                offsets_r[num_r] = ++i;
+                num_r += nano::invoke(comp, nano::invoke(pred, *--it),
+                                      nano::invoke(pred, pivot));
+                offsets_r[num_r] = ++i;
+                num_r += nano::invoke(comp, nano::invoke(pred, *--it),
+                                      nano::invoke(pred, pivot));
+                offsets_r[num_r] = ++i;
+                num_r += nano::invoke(comp, nano::invoke(pred, *--it),
+                                      nano::invoke(pred, pivot));
+                offsets_r[num_r] = ++i;
+                num_r += nano::invoke(comp, nano::invoke(pred, *--it),
+                                      nano::invoke(pred, pivot));
+                offsets_r[num_r] = ++i;
+                num_r += nano::invoke(comp, nano::invoke(pred, *--it),
+                                      nano::invoke(pred, pivot));
+                offsets_r[num_r] = ++i;
+                num_r += nano::invoke(comp, nano::invoke(pred, *--it),
+                                      nano::invoke(pred, pivot));
+            }
+        }
+
+        // Swap elements and update block sizes and first/last boundaries.
+        int num = (nano::min)(num_l, num_r);
+        swap_offsets(first, last, offsets_l + start_l, offsets_r + start_r, num,
+                     num_l == num_r);
+        num_l -= num;
+        num_r -= num;
+        start_l += num;
+        start_r += num;
+        if (num_l == 0)
+            first += pdqsort_block_size;
+        if (num_r == 0)
+            last -= pdqsort_block_size;
+    }
+
+    iter_difference_t<I> l_size = 0, r_size = 0;
+    iter_difference_t<I> unknown_left =
+        (last - first) - ((num_r || num_l) ? pdqsort_block_size : 0);
+    if (num_r) {
+        // Handle leftover block by assigning the unknown elements to the other
+        // block.
+        l_size = unknown_left;
+        r_size = pdqsort_block_size;
+    } else if (num_l) {
+        l_size = pdqsort_block_size;
+        r_size = unknown_left;
+    } else {
+        // No leftover block, split the unknown elements in two blocks.
+        l_size = unknown_left / 2;
+        r_size = unknown_left - l_size;
+    }
+
+    // Fill offset buffers if needed.
+    if (unknown_left && !num_l) {
+        start_l = 0;
+        I it = first;
+        for (unsigned char i = 0; i < l_size;) {
+            offsets_l[num_l] = i++;
+            num_l += !nano::invoke(comp, nano::invoke(pred, *it),
+                                   nano::invoke(pred, pivot));
+            ++it;
+        }
+    }
+    if (unknown_left && !num_r) {
+        start_r = 0;
+        I it = last;
+        for (unsigned char i = 0; i < r_size;) {
+            offsets_r[num_r] = ++i;
+            num_r += nano::invoke(comp, nano::invoke(pred, *--it),
+                                  nano::invoke(pred, pivot));
+        }
+    }
+
+    int num = (nano::min)(num_l, num_r);
+    swap_offsets(first, last, offsets_l + start_l, offsets_r + start_r, num,
+                 num_l == num_r);
+    num_l -= num;
+    num_r -= num;
+    start_l += num;
+    start_r += num;
+    if (num_l == 0)
+        first += l_size;
+    if (num_r == 0)
+        last -= r_size;
+
+    // We have now fully identified [first, last)'s proper position. Swap the
+    // last elements.
+    if (num_l) {
+        offsets_l += start_l;
+        while (num_l--)
+            nano::iter_swap(first + offsets_l[num_l], --last);
+        first = last;
+    }
+    if (num_r) {
+        offsets_r += start_r;
+        while (num_r--)
+            nano::iter_swap(last - offsets_r[num_r], first), ++first;
+        last = first;
+    }
+
+    // Put the pivot in the right place.
+    I pivot_pos = first - 1;
+    *begin = nano::iter_move(pivot_pos);
+    *pivot_pos = std::move(pivot);
+
+    return std::make_pair(std::move(pivot_pos), already_partitioned);
+}
+
+// Partitions [begin, end) around pivot *begin using comparison function comp.
+// Elements equal to the pivot are put in the right-hand partition. Returns the
+// position of the pivot after partitioning and whether the passed sequence
+// already was correctly partitioned. Assumes the pivot is a median of at least
+// 3 elements and that [begin, end) is at least insertion_sort_threshold long.
+template <typename I, typename Comp, typename Proj>
+constexpr std::pair<I, bool> partition_right(I begin, I end, Comp& comp,
+                                             Proj& proj)
+{
+    using T = iter_value_t<I>;
+
+    // Move pivot into local for speed.
+    T pivot(nano::iter_move(begin));
+
+    I first = begin;
+    I last = end;
+
+    // Find the first element greater than or equal than the pivot (the median
+    // of 3 guarantees this exists).
+    while (nano::invoke(comp, nano::invoke(proj, *++first),
+                        nano::invoke(proj, pivot))) {
+    }
+
+    // Find the first element strictly smaller than the pivot. We have to guard
+    // this search if there was no element before *first.
+    if (first - 1 == begin) {
+        while (first < last && !nano::invoke(comp, nano::invoke(proj, *--last),
+                                             nano::invoke(proj, pivot))) {
+        }
+    } else {
+        while (!nano::invoke(comp, nano::invoke(proj, *--last),
+                             nano::invoke(proj, pivot))) {
+        }
+    }
+
+    // If the first pair of elements that should be swapped to partition are the
+    // same element, the passed in sequence already was correctly partitioned.
+    bool already_partitioned = first >= last;
+
+    // Keep swapping pairs of elements that are on the wrong side of the pivot.
+    // Previously swapped pairs guard the searches, which is why the first
+    // iteration is special-cased above.
+    while (first < last) {
+        nano::iter_swap(first, last);
+        while (nano::invoke(comp, nano::invoke(proj, *++first),
+                            nano::invoke(proj, pivot)))
+            ;
+        while (!nano::invoke(comp, nano::invoke(proj, *--last),
+                             nano::invoke(proj, pivot)))
+            ;
+    }
+
+    // Put the pivot in the right place.
+    I pivot_pos = first - 1;
+    *begin = nano::iter_move(pivot_pos);
+    *pivot_pos = std::move(pivot);
+
+    return std::make_pair(std::move(pivot_pos), already_partitioned);
+}
+
+// Similar function to the one above, except elements equal to the pivot are put
+// to the left of the pivot and it doesn't check or return if the passed
+// sequence already was partitioned. Since this is rarely used (the many equal
+// case), and in that case pdqsort already has O(n) performance, no block
+// quicksort is applied here for simplicity.
+template <typename I, typename Comp, typename Proj>
+constexpr I partition_left(I begin, I end, Comp& comp, Proj& proj)
+{
+    using T = iter_value_t<I>;
+
+    T pivot(nano::iter_move(begin));
+    I first = begin;
+    I last = end;
+
+    while (nano::invoke(comp, nano::invoke(proj, pivot),
+                        nano::invoke(proj, *--last)))
+        ;
+
+    if (last + 1 == end) {
+        while (first < last && !nano::invoke(comp, nano::invoke(proj, pivot),
+                                             nano::invoke(proj, *++first)))
+            ;
+    } else {
+        while (!nano::invoke(comp, nano::invoke(proj, pivot),
+                             nano::invoke(proj, *++first)))
+            ;
+    }
+
+    while (first < last) {
+        nano::iter_swap(first, last);
+        while (nano::invoke(comp, nano::invoke(proj, pivot),
+                            nano::invoke(proj, *--last)))
+            ;
+        while (!nano::invoke(comp, nano::invoke(proj, pivot),
+                             nano::invoke(proj, *++first)))
+            ;
+    }
+
+    I pivot_pos = last;
+    *begin = nano::iter_move(pivot_pos);
+    *pivot_pos = std::move(pivot);
+
+    return pivot_pos;
+}
+
+// The main pdqsort loop. After each partitioning step the left-hand
+// partition is passed to recurse(begin, end, bad_allowed, leftmost), while the
+// right-hand partition is handled by the next iteration of the loop.
+template <bool Branchless, typename I, typename Comp, typename Proj,
+          typename Recurse>
+constexpr void pdqsort_loop(I begin, I end, Comp& comp, Proj& proj,
+                            int bad_allowed, bool leftmost, Recurse& recurse)
+{
+    using diff_t = iter_difference_t<I>;
+
+    // Use a while loop for tail recursion elimination.
+    while (true) {
+        diff_t size = nano::distance(begin, end);
+
+        // Small partitions of arithmetic values are sorted by a network,
+        // which doesn't branch. Insertion sort is faster for other small
+        // arrays.
+        if constexpr (Branchless) {
+            if (size <= sorting_network_max) {
+                detail::sorting_network<Branchless>(begin, size, comp, proj);
+                return;
+            }
+        } else {
+            if (size < pdqsort_insertion_sort_threshold) {
+                if (leftmost) {
+                    insertion_sort(begin, end, comp, proj);
+                } else {
+                    unguarded_insertion_sort(begin, end, comp, proj);
+                }
+                return;
+            }
+        }
+
+        // Choose pivot as median of 3 or pseudomedian of 9.
+        diff_t s2 = size / 2;
+        if (size > pdqsort_ninther_threshold) {
+            sort3(begin, begin + s2, end - 1, comp, proj);
+            sort3(begin + 1, begin + (s2 - 1), end - 2, comp, proj);
+            sort3(begin + 2, begin + (s2 + 1), end - 3, comp, proj);
+            sort3(begin + (s2 - 1), begin + s2, begin + (s2 + 1), comp, proj);
+            nano::iter_swap(begin, begin + s2);
+        } else {
+            sort3(begin + s2, begin, end - 1, comp, proj);
+        }
+
+        // If *(begin - 1) is the end of the right partition of a previous
+        // partition operation there is no element in [begin, end) that is
+        // smaller than *(begin - 1). Then if our pivot compares equal to
+        // *(begin - 1) we change strategy, putting equal elements in the left
+        // partition, greater elements in the right partition. We do not have to
+        // recurse on the left partition, since it's sorted (all equal).
+        if (!leftmost && !nano::invoke(comp, nano::invoke(proj, *(begin - 1)),
+                                       nano::invoke(proj, *begin))) {
+            begin = partition_left(begin, end, comp, proj) + 1;
+            continue;
+        }
+
+        // Partition and get results.
+        std::pair<I, bool> part_result =
+            Branchless ? partition_right_branchless(begin, end, comp, proj)
+                       : partition_right(begin, end, comp, proj);
+        I pivot_pos = part_result.first;
+        bool already_partitioned = part_result.second;
+
+        // Check for a highly unbalanced partition.
+        diff_t l_size = pivot_pos - begin;
+        diff_t r_size = end - (pivot_pos + 1);
+        bool highly_unbalanced = l_size < size / 8 || r_size < size / 8;
+
+        // If we got a highly unbalanced partition we shuffle elements to break
+        // many patterns.
+        if (highly_unbalanced) {
+            // If we had too many bad partitions, switch to heapsort to
+            // guarantee O(n log n).
+            if (--bad_allowed == 0) {
+                nano::make_heap(begin, end, comp, proj);
+                nano::sort_heap(begin, end, comp, proj);
+                return;
+            }
+
+            if (l_size >= pdqsort_insertion_sort_threshold) {
+                nano::iter_swap(begin, begin + l_size / 4);
+                nano::iter_swap(pivot_pos - 1, pivot_pos - l_size / 4);
+
+                if (l_size > pdqsort_ninther_threshold) {
+                    nano::iter_swap(begin + 1, begin + (l_size / 4 + 1));
+                    nano::iter_swap(begin + 2, begin + (l_size / 4 + 2));
+                    nano::iter_swap(pivot_pos - 2,
+                                    pivot_pos - (l_size / 4 + 1));
+                    nano::iter_swap(pivot_pos - 3,
+                                    pivot_pos - (l_size / 4 + 2));
+                }
+            }
+
+            if (r_size >= pdqsort_insertion_sort_threshold) {
+                nano::iter_swap(pivot_pos + 1, pivot_pos + (1 + r_size / 4));
+                nano::iter_swap(end - 1, end - r_size / 4);
+
+                if (r_size > pdqsort_ninther_threshold) {
+                    nano::iter_swap(pivot_pos + 2,
+                                    pivot_pos + (2 + r_size / 4));
+                    nano::iter_swap(pivot_pos + 3,
+                                    pivot_pos + (3 + r_size / 4));
+                    nano::iter_swap(end - 2, end - (1 + r_size / 4));
+                    nano::iter_swap(end - 3, end - (2 + r_size / 4));
+                }
+            }
+        } else {
+            // If we were decently balanced and we tried to sort an already
+            // partitioned sequence try to use insertion sort.
+            if (already_partitioned &&
+                partial_insertion_sort(begin, pivot_pos, comp, proj) &&
+                partial_insertion_sort(pivot_pos + 1, end, comp, proj))
+                return;
+        }
+
+        // Sort the left partition first using recursion and do tail recursion
+        // elimination for the right-hand partition.
+        recurse(begin, pivot_pos, bad_allowed, leftmost);
+        begin = pivot_pos + 1;
+        leftmost = false;
+    }
+}
+
+template <bool Branchless, typename I, typename Comp, typename Proj>
+constexpr void pdqsort_loop(I begin, I end, Comp& comp, Proj& proj,
+                            int bad_allowed, bool leftmost = true)
+{
+    auto recurse = [&comp, &proj](I b, I e, int bad, bool lm) {
+        detail::pdqsort_loop<Branchless>(std::move(b), std::move(e), comp,
+                                         proj, bad, lm);
+    };
+    detail::pdqsort_loop<Branchless>(std::move(begin), std::move(end), comp,
+                                     proj, bad_allowed, leftmost, recurse);
+}
+
+template <typename I, typename Comp, typename Proj>
+inline constexpr bool pdqsort_use_branchless =
+    is_default_compare_v<std::remove_const_t<Comp>> &&
+    same_as<Proj, identity> && std::is_arithmetic<iter_value_t<I>>::value;
+
+template <typename I, typename Comp, typename Proj,
+          bool Branchless = pdqsort_use_branchless<I, Comp, Proj>>
+constexpr void pdqsort(I begin, I end, Comp& comp, Proj& proj)
+{
+    if (begin == end) {
+        return;
+    }
+
+    detail::pdqsort_loop<Branchless>(std::move(begin), std::move(end), comp,
+                                     proj,
+                                     detail::log2(nano::distance(begin, end)));
+}
+
+} // namespace detail
+
+NANO_END_NAMESPACE
+
+#endif
+
+
+
+#include <array>
+#include <cstdint>
+
+NANO_BEGIN_NAMESPACE
+
+namespace detail {
+
+// Runs shorter than this are extended with insertion sort before merging
+constexpr std::ptrdiff_t powersort_min_run = 32;
+
+// Returns the end of the run beginning at first. If the run is strictly
+// descending, it is reversed, so that the elements of [first, end) are
+// ascending afterwards. Strict descent is required for stability.
+template <typename I, typename Comp, typename Proj>
+I powersort_find_run(I first, I last, Comp& comp, Proj& proj)
+{
+    if (last - first < 2) {
+        return last;
+    }
+
+    I it = first + 1;
+    if (nano::invoke(comp, nano::invoke(proj, *it),
+                     nano::invoke(proj, *first))) {
+        while (++it != last &&
+               nano::invoke(comp, nano::invoke(proj, *it),
+                            nano::invoke(proj, *(it - 1)))) {}
+        nano::reverse(first, it);
+    } else {
+        while (++it != last &&
+               !nano::invoke(comp, nano::invoke(proj, *it),
+                             nano::invoke(proj, *(it - 1)))) {}
+    }
+
+    return it;
+}
+
+// Returns the depth in the merge tree of the boundary between the adjacent
+// runs [begin1, end1) and [end1, end2) of a range of n elements beginning at
+// offset 0. This is the number of leading bits which the binary expansions
+// of the runs' midpoints, as fractions of n, have in common, plus one.
+inline int powersort_node_power(std::uint64_t n, std::uint64_t begin1,
+                                std::uint64_t end1, std::uint64_t end2)
+{
+    // Twice the midpoints, compared against twice n
+    std::uint64_t a = begin1 + end1;
+    std::uint64_t b = end1 + end2;
+    const std::uint64_t two_n = 2 * n;
+
+    int power = 0;
+    while (true) {
+        ++power;
+        if (a >= two_n) {
+            a -= two_n;
+            b -= two_n;
+        } else if (b >= two_n) {
+            return power;
+        }
+        a <<= 1;
+        b <<= 1;
+    }
+}
+
+// Merges [first, middle) with the shorter [middle, last), which has been
+// moved into buf, working backwards from the end
+template <typename I, typename Buf, typename Comp, typename Proj>
+void powersort_merge_hi(I first, I middle, I last, Buf& buf, Comp& comp,
+                        Proj& proj)
+{
+    nano::move(middle, last, nano::back_inserter(buf));
+    const auto buf_first = buf.begin();
+    auto buf_last = buf.end();
+
+    std::ptrdiff_t run1 = 0;
+    std::ptrdiff_t run2 = 0;
+
+    while (buf_last != buf_first && middle != first) {
+        // Ties go to the second run, which comes last
+        if (nano::invoke(comp, nano::invoke(proj, *(buf_last - 1)),
+                         nano::invoke(proj, *(middle - 1)))) {
+            *--last = nano::iter_move(--middle);
+            run2 = 0;
+            if (++run1 == gallop_threshold) {
+                // Move the rest of the elements of the first run which are
+                // greater than the last element of the second run in one go
+                const I mid = detail::gallop(
+                    nano::make_reverse_iterator(middle),
+                    nano::make_reverse_iterator(first), [&](auto&& x) {
+                        return nano::invoke(comp,
+                                            nano::invoke(proj, *(buf_last - 1)),
+                                            nano::invoke(proj, x));
+                    }).base();
+                last = nano::move_backward(mid, middle, std::move(last)).out;
+                middle = mid;
+                run1 = 0;
+            }
+        } else {
+            *--last = std::move(*--buf_last);
+            run1 = 0;
+            if (++run2 == gallop_threshold) {
+                // Likewise the elements of the second run which are not less
+                // than the last element of the first run
+                const auto mid = detail::gallop(
+                    nano::make_reverse_iterator(buf_last),
+                    nano::make_reverse_iterator(buf_first), [&](auto&& y) {
+                        return !nano::invoke(comp, nano::invoke(proj, y),
+                                             nano::invoke(proj, *(middle - 1)));
+                    }).base();
+                last = nano::move_backward(mid, buf_last, std::move(last)).out;
+                buf_last = mid;
+                run2 = 0;
+            }
+        }
+    }
+
+    // Any elements left in the first run are already in place
+    nano::move_backward(buf_first, buf_last, std::move(last));
+    buf.clear();
+}
+
+// Merges the shorter [first, middle), which has been moved into buf, with
+// [middle, last), working forwards from the beginning
+template <typename I, typename Buf, typename Comp, typename Proj>
+void powersort_merge_lo(I first, I middle, I last, Buf& buf, Comp& comp,
+                        Proj& proj)
+{
+    nano::move(first, middle, nano::back_inserter(buf));
+    auto buf_first = buf.begin();
+    const auto buf_last = buf.end();
+
+    std::ptrdiff_t run1 = 0;
+    std::ptrdiff_t run2 = 0;
+
+    while (buf_first != buf_last && middle != last) {
+        // Ties go to the first run, which comes first
+        if (nano::invoke(comp, nano::invoke(proj, *middle),
+                         nano::invoke(proj, *buf_first))) {
+            *first = nano::iter_move(middle);
+            ++first;
+            ++middle;
+            run1 = 0;
+            if (++run2 == gallop_threshold) {
+                const I mid = detail::gallop(middle, last, [&](auto&& y) {
+                    return nano::invoke(comp, nano::invoke(proj, y),
+                                        nano::invoke(proj, *buf_first));
+                });
+                first = nano::move(middle, mid, std::move(first)).out;
+                middle = mid;
+                run2 = 0;
+            }
+        } else {
+            *first = std::move(*buf_first);
+            ++first;
+            ++buf_first;
+            run2 = 0;
+            if (++run1 == gallop_threshold) {
+                const auto mid = detail::gallop(buf_first, buf_last,
+                                                [&](auto&& x) {
+                    return !nano::invoke(comp, nano::invoke(proj, *middle),
+                                         nano::invoke(proj, x));
+                });
+                first = nano::move(buf_first, mid, std::move(first)).out;
+                buf_first = mid;
+                run1 = 0;
+            }
+        }
+    }
+
+    // Any elements left in the second run are already in place
+    nano::move(buf_first, buf_last, std::move(first));
+    buf.clear();
+}
+
+// Given adjacent sorted runs [first, middle) and [middle, last), skips the
+// elements at the start of the first run which are not greater than the
+// first element of the second run, and those at the end of the second run
+// which are not less than the last element of the first, since they are
+// already in place. For nearly sorted input, this is most of them. Returns
+// false if nothing is left to merge.
+template <typename I, typename Comp, typename Proj>
+bool powersort_trim(I& first, I middle, I& last, Comp& comp, Proj& proj)
+{
+    first = detail::gallop(first, middle, [&](auto&& x) {
+        return !nano::invoke(comp, nano::invoke(proj, *middle),
+                             nano::invoke(proj, x));
+    });
+    if (first == middle) {
+        return false;
+    }
+
+    last = detail::gallop(nano::make_reverse_iterator(last),
+                          nano::make_reverse_iterator(middle), [&](auto&& y) {
+                              return !nano::invoke(
+                                  comp, nano::invoke(proj, y),
+                                  nano::invoke(proj, *(middle - 1)));
+                          }).base();
+    return true;
+}
+
+// Merges the adjacent sorted runs [first, middle) and [middle, last). buf
+// must be empty, and have room for the shorter of the two.
+template <typename I, typename Buf, typename Comp, typename Proj>
+void powersort_merge(I first, I middle, I last, Buf& buf, Comp& comp,
+                     Proj& proj)
+{
+    if (!detail::powersort_trim(first, middle, last, comp, proj)) {
+        return;
+    }
+
+    if (last - middle < middle - first) {
+        detail::powersort_merge_hi(first, middle, last, buf, comp, proj);
+    } else {
+        detail::powersort_merge_lo(first, middle, last, buf, comp, proj);
+    }
+}
+
+// Stably sorts [first, last), calling merge(begin, middle, end) to merge
+// pairs of adjacent sorted runs
+template <typename I, typename Comp, typename Proj, typename Merge>
+void powersort_runs(I first, I last, Comp& comp, Proj& proj, Merge merge)
+{
+    using diff_t = iter_difference_t<I>;
+
+    struct run {
+        diff_t begin;
+        diff_t end;
+        int power;
+    };
+
+    const diff_t n = last - first;
+
+    // Returns the end of the run starting at offset begin, extended to
+    // powersort_min_run elements if it is shorter
+    const auto next_run = [&](diff_t begin) {
+        const I run_first = first + begin;
+        I end = detail::powersort_find_run(run_first, last, comp, proj);
+        if (end - run_first < powersort_min_run && end != last) {
+            end = last - run_first > powersort_min_run
+                      ? run_first + powersort_min_run
+                      : last;
+            detail::insertion_sort(run_first, end, comp, proj);
+        }
+        return diff_t(end - first);
+    };
+
+    // The powers of the runs on the stack strictly increase from the bottom
+    // up, and are at most 64, so it can never overflow
+    std::array<run, 65> stack;
+    int top = 0;
+
+    diff_t begin1 = 0;
+    diff_t end1 = next_run(0);
+
+    while (end1 < n) {
+        const diff_t end2 = next_run(end1);
+        const int power = detail::powersort_node_power(
+            static_cast<std::uint64_t>(n), static_cast<std::uint64_t>(begin1),
+            static_cast<std::uint64_t>(end1), static_cast<std::uint64_t>(end2));
+
+        while (top > 0 && stack[top - 1].power > power) {
+            --top;
+            merge(first + stack[top].begin, first + stack[top].end,
+                  first + end1);
+            begin1 = stack[top].begin;
+        }
+
+        stack[top++] = run{begin1, end1, power};
+        begin1 = end1;
+        end1 = end2;
+    }
+
+    while (top > 0) {
+        --top;
+        merge(first + stack[top].begin, first + stack[top].end, first + end1);
+    }
+}
+
+// Stably sorts [first, last). buf must be empty, and have room for half of
+// the elements, rounded up.
+template <typename I, typename Buf, typename Comp, typename Proj>
+void powersort(I first, I last, Buf& buf, Comp& comp, Proj& proj)
+{
+    detail::powersort_runs(std::move(first), std::move(last), comp, proj,
+                           [&](I begin, I middle, I end) {
+                               detail::powersort_merge(std::move(begin),
+                                                       std::move(middle),
+                                                       std::move(end), buf,
+                                                       comp, proj);
+                           });
+}
+
+} // namespace detail
+
+NANO_END_NAMESPACE
+
+#endif
+
+
+
+#include <cmath>
+
+NANO_BEGIN_NAMESPACE
+
+namespace detail {
+
+// Returns the number of elements in a block for a range of n elements,
+// which is also the number of elements in the buffer
+inline std::size_t block_merge_block_size(std::size_t n)
+{
+    auto k = static_cast<std::size_t>(std::sqrt(static_cast<double>(n)));
+    while (k * k < n) {
+        ++k;
+    }
+    return k < 16 ? 16 : k;
+}
+
+// Merges the elements held in buf with [middle, last), writing them from
+// first onwards. [first, middle) must have as many elements as buf, none of
+// whose values matter.
+template <typename I, typename Buf, typename Comp, typename Proj>
+void block_merge_from_buffer(I first, I middle, I last, Buf& buf, Comp& comp,
+                             Proj& proj)
+{
+    auto buf_first = buf.begin();
+    const auto buf_last = buf.end();
+
+    while (buf_first != buf_last && middle != last) {
+        if (nano::invoke(comp, nano::invoke(proj, *middle),
+                         nano::invoke(proj, *buf_first))) {
+            *first = nano::iter_move(middle);
+            ++middle;
+        } else {
+            *first = std::move(*buf_first);
+            ++buf_first;
+        }
+        ++first;
+    }
+
+    nano::move(buf_first, buf_last, std::move(first));
+    buf.clear();
+}
+
+// Merges the adjacent sorted runs [first, middle) and [middle, last), both
+// longer than the buffer. buf and tags must be empty, with room for a block
+// of elements and for a block number per block of the first run.
+template <typename I, typename Buf, typename Tags, typename Comp,
+          typename Proj>
+void block_merge(I first, I middle, I last, Buf& buf, Tags& tags, Comp& comp,
+                 Proj& proj)
+{
+    using diff_t = iter_difference_t<I>;
+
+    const auto k = static_cast<diff_t>(buf.capacity());
+    const diff_t len = last - first;
+
+    // Offsets from first of the rolling A blocks, the next block of B, the
+    // previous A block, which is waiting in buf to be merged, and the B
+    // values which have been rolled past since it was dropped. If the
+    // length of A is not a multiple of k, the short block at the front
+    // starts out as the previous A block.
+    diff_t a_first = (middle - first) % k;
+    diff_t a_last = middle - first;
+    diff_t b_first = a_last;
+    diff_t b_last = b_first + (nano::min)(k, len - b_first);
+    diff_t prev_a_first = 0;
+    diff_t prev_a_last = a_first;
+    diff_t prev_b_first = a_first;
+    diff_t prev_b_last = a_first;
+
+    nano::move(first, first + a_first, nano::back_inserter(buf));
+
+    // The number of the A block at each position among the rolling blocks,
+    // stored as a ring starting at head. The A blocks are dropped in their
+    // original order, so the smallest block is always block number next.
+    const diff_t blocks = (a_last - a_first) / k;
+    for (diff_t i = 0; i < blocks; ++i) {
+        tags.push_back(i);
+    }
+    const auto tag = [&](diff_t pos) -> diff_t& {
+        return tags.begin()[pos % blocks];
+    };
+    diff_t head = 0;
+    diff_t next = 0;
+    diff_t min_a = a_first;
+
+    while (a_first != a_last) {
+        if (b_first == b_last ||
+            (prev_b_first != prev_b_last &&
+             !nano::invoke(comp, nano::invoke(proj, first[prev_b_last - 1]),
+                           nano::invoke(proj, first[min_a])))) {
+            // Drop the smallest A block behind, after the B values which are
+            // less than its first element
+            const diff_t b_split =
+                nano::lower_bound(first + prev_b_first, first + prev_b_last,
+                                  nano::invoke(proj, first[min_a]),
+                                  std::ref(comp), std::ref(proj)) -
+                first;
+            const diff_t b_remaining = prev_b_last - b_split;
+
+            if (min_a != a_first) {
+                nano::swap_ranges(first + a_first, first + (a_first + k),
+                                  first + min_a, first + (min_a + k));
+                nano::swap(tag(head), tag(head + (min_a - a_first) / k));
+            }
+
+            detail::block_merge_from_buffer(first + prev_a_first,
+                                            first + prev_a_last,
+                                            first + b_split, buf, comp, proj);
+
+            // Once this block is in the buffer its old place holds nothing
+            // we need, so rather than rotating it past the rest of the
+            // previous B values we can swap them into the end of it
+            nano::move(first + a_first, first + (a_first + k),
+                       nano::back_inserter(buf));
+            nano::swap_ranges(first + b_split, first + a_first,
+                              first + (a_first + k - b_remaining),
+                              first + (a_first + k));
+
+            prev_a_first = a_first - b_remaining;
+            prev_a_last = prev_a_first + k;
+            prev_b_first = prev_a_last;
+            prev_b_last = prev_b_first + b_remaining;
+
+            a_first += k;
+            head = (head + 1) % blocks;
+            ++next;
+
+            for (diff_t i = 0, n = (a_last - a_first) / k; i < n; ++i) {
+                if (tag(head + i) == next) {
+                    min_a = a_first + i * k;
+                    break;
+                }
+            }
+        } else if (b_last - b_first < k) {
+            // Move the short last block of B in front of the A blocks
+            nano::rotate(first + a_first, first + b_first, first + b_last);
+            const diff_t b_len = b_last - b_first;
+            prev_b_first = a_first;
+            prev_b_last = a_first + b_len;
+            a_first += b_len;
+            a_last += b_len;
+            min_a += b_len;
+            b_first = b_last;
+        } else {
+            // Roll the first A block to the end by swapping it with the next
+            // block of B
+            nano::swap_ranges(first + a_first, first + (a_first + k),
+                              first + b_first, first + b_last);
+            prev_b_first = a_first;
+            prev_b_last = a_first + k;
+            if (min_a == a_first) {
+                min_a = a_last;
+            }
+            const diff_t remaining = (a_last - a_first) / k;
+            tag(head + remaining) = tag(head);
+            head = (head + 1) % blocks;
+
+            a_first += k;
+            a_last += k;
+            b_first += k;
+            b_last = b_first + (nano::min)(k, len - b_first);
+        }
+    }
+
+    detail::block_merge_from_buffer(first + prev_a_first, first + prev_a_last,
+                                    last, buf, comp, proj);
+    tags.clear();
+}
+
+// Stably sorts [first, last) using O(sqrt(n)) extra space. Returns false,
+// leaving the range untouched, if even that much space is not available.
+template <typename I, typename Comp, typename Proj>
+bool block_merge_sort(I first, I last, Comp& comp, Proj& proj,
+                      temporary_resource* resource = nullptr)
+{
+    using diff_t = iter_difference_t<I>;
+
+    const auto n = static_cast<std::size_t>(last - first);
+    if (n <= static_cast<std::size_t>(powersort_min_run)) {
+        detail::insertion_sort(std::move(first), std::move(last), comp, proj);
+        return true;
+    }
+
+    const std::size_t k = detail::block_merge_block_size(n);
+    temporary_vector<iter_value_t<I>> buf(k, resource);
+    temporary_vector<diff_t> tags(n / k + 1, resource);
+    if (buf.capacity() == 0 || tags.capacity() == 0) {
+        return false;
+    }
+
+    detail::powersort_runs(
+        std::move(first), std::move(last), comp, proj,
+        [&](I begin, I middle, I end) {
+            if (!detail::powersort_trim(begin, middle, end, comp, proj)) {
+                return;
+            }
+            if (end - middle <= diff_t(k)) {
+                detail::powersort_merge_hi(begin, middle, end, buf, comp, proj);
+            } else if (middle - begin <= diff_t(k)) {
+                detail::powersort_merge_lo(begin, middle, end, buf, comp, proj);
+            } else {
+                detail::block_merge(begin, middle, end, buf, tags, comp, proj);
+            }
+        });
+    return true;
+}
+
+} // namespace detail
+
+NANO_END_NAMESPACE
+
+#endif
+
+// nanorange/detail/algorithm/parallel_sort.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_DETAIL_ALGORITHM_PARALLEL_SORT_HPP_INCLUDED
+#define NANORANGE_DETAIL_ALGORITHM_PARALLEL_SORT_HPP_INCLUDED
+
+
+
+
+
+// nanorange/detail/execution/task_pool.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_DETAIL_EXECUTION_TASK_POOL_HPP_INCLUDED
+#define NANORANGE_DETAIL_EXECUTION_TASK_POOL_HPP_INCLUDED
+
+
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+NANO_BEGIN_NAMESPACE
+
+namespace detail {
+
+// A work-stealing thread pool used by the parallel algorithms.
+//
+// Each worker thread owns a task queue. Workers push and pop at the back of
+// their own queue (so the most recently forked, and most cache-friendly, work
+// runs first) and steal from the front of the other queues when their own
+// queue is empty. Queue 0 is shared by all threads which are not part of the
+// pool. Threads waiting on a task_group run queued tasks rather than blocking,
+// so nested fork-join parallelism cannot deadlock.
+class task_pool {
+public:
+    using task = std::function<void()>;
+
+    static task_pool& instance() { return *holder(); }
+
+    // Replaces the pool with one which has the given number of worker
+    // threads, or the default number if workers is -1. This lets the tests
+    // run the parallel algorithms with real concurrency on any machine. No
+    // tasks may be running.
+    static void set_worker_count(std::ptrdiff_t workers)
+    {
+        auto& pool = holder();
+        pool.reset();
+        pool.reset(new task_pool(workers < 0 ? default_thread_count()
+                                             : std::size_t(workers) + 1));
+    }
+
+    task_pool(const task_pool&) = delete;
+    task_pool& operator=(const task_pool&) = delete;
+
+    ~task_pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex_);
+            done_ = true;
+        }
+        wake_.notify_all();
+        for (auto& t : threads_) {
+            t.join();
+        }
+    }
+
+    // The number of threads which may run tasks, including the caller
+    std::size_t concurrency() const { return threads_.size() + 1; }
+
+    void submit(task t)
+    {
+        queue& q = queues_[this_thread_index()];
+        {
+            std::lock_guard<std::mutex> lock(q.mutex);
+            q.tasks.push_back(std::move(t));
+        }
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex_);
+            ++pending_;
+        }
+        wake_.notify_one();
+    }
+
+    // Runs a single queued task if one is available, returning whether it
+    // did so
+    bool try_run_one()
+    {
+        task t;
+        if (!try_pop(t)) {
+            return false;
+        }
+        t();
+        return true;
+    }
+
+private:
+    struct queue {
+        std::mutex mutex;
+        std::deque<task> tasks;
+    };
+
+    explicit task_pool(std::size_t threads) : queues_(threads)
+    {
+        threads_.reserve(queues_.size() - 1);
+        for (std::size_t i = 1; i < queues_.size(); ++i) {
+            threads_.emplace_back([this, i] { worker_loop(i); });
+        }
+    }
+
+    static std::unique_ptr<task_pool>& holder()
+    {
+        static std::unique_ptr<task_pool> pool(
+            new task_pool(default_thread_count()));
+        return pool;
+    }
+
+    static std::size_t default_thread_count()
+    {
+        const unsigned n = std::thread::hardware_concurrency();
+        return n > 0 ? n : 1;
+    }
+
+    static std::size_t& this_thread_index()
+    {
+        static thread_local std::size_t index = 0;
+        return index;
+    }
+
+    bool try_pop(task& t)
+    {
+        const std::size_t self = this_thread_index();
+        const std::size_t n = queues_.size();
+
+        for (std::size_t i = 0; i < n; ++i) {
+            queue& q = queues_[(self + i) % n];
+            std::lock_guard<std::mutex> lock(q.mutex);
+            if (q.tasks.empty()) {
+                continue;
+            }
+            if (i == 0) {
+                t = std::move(q.tasks.back());
+                q.tasks.pop_back();
+            } else {
+                t = std::move(q.tasks.front());
+                q.tasks.pop_front();
+            }
+            --pending_;
+            return true;
+        }
+
+        return false;
+    }
+
+    void worker_loop(std::size_t index)
+    {
+        this_thread_index() = index;
+
+        while (true) {
+            if (try_run_one()) {
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleep_mutex_);
+            wake_.wait(lock, [this] { return done_ || pending_ > 0; });
+            if (done_) {
+                return;
+            }
+        }
+    }
+
+    std::vector<queue> queues_;
+    std::vector<std::thread> threads_;
+    std::mutex sleep_mutex_;
+    std::condition_variable wake_;
+    // May briefly go negative if a task is stolen before it is counted
+    std::atomic<std::ptrdiff_t> pending_{0};
+    bool done_ = false;
+};
+
+// A set of tasks forked onto the pool, which may be joined with wait().
+// Tasks may themselves fork further tasks into the same group. The first
+// exception thrown by any task is rethrown from wait().
+class task_group {
+public:
+    task_group() = default;
+    task_group(const task_group&) = delete;
+    task_group& operator=(const task_group&) = delete;
+
+    ~task_group()
+    {
+        // Tasks may refer to the caller's stack frame, so we must not return
+        // while any are still running
+        while (count_ != 0) {
+            help_or_yield();
+        }
+    }
+
+    template <typename F>
+    void run(F f)
+    {
+        ++count_;
+        pool_.submit([this, f = std::move(f)]() mutable {
+            execute(f);
+            // This must be the last access to *this
+            --count_;
+        });
+    }
+
+    void wait()
+    {
+        while (count_ != 0) {
+            help_or_yield();
+        }
+#if NANO_HAS_EXCEPTIONS
+        if (error_) {
+            std::exception_ptr e = std::move(error_);
+            error_ = nullptr;
+            std::rethrow_exception(std::move(e));
+        }
+#endif
+    }
+
+private:
+    template <typename F>
+    void execute(F& f)
+    {
+#if NANO_HAS_EXCEPTIONS
+        try {
+            f();
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(error_mutex_);
+            if (!error_) {
+                error_ = std::current_exception();
+            }
+        }
+#else
+        f();
+#endif
+    }
+
+    void help_or_yield()
+    {
+        if (!pool_.try_run_one()) {
+            std::this_thread::yield();
+        }
+    }
+
+    task_pool& pool_ = task_pool::instance();
+    std::atomic<std::size_t> count_{0};
+#if NANO_HAS_EXCEPTIONS
+    std::mutex error_mutex_;
+    std::exception_ptr error_;
+#endif
+};
+
+} // namespace detail
+
+NANO_END_NAMESPACE
+
+#endif
+
+
+
+#include <functional>
+
+NANO_BEGIN_NAMESPACE
+
+namespace detail {
+
+// Ranges shorter than this are not worth handing off to another thread
+constexpr int parallel_sort_grain_size = 1 << 14;
+
+// As pdqsort_loop(), but left-hand partitions which are large enough are
+// forked onto the task pool rather than sorted on this thread
+template <bool Branchless, typename I, typename Comp, typename Proj>
+void parallel_pdqsort_loop(task_group& tasks, I begin, I end, Comp& comp,
+                           Proj& proj, int bad_allowed, bool leftmost)
+{
+    auto recurse = [&tasks, &comp, &proj](I b, I e, int bad, bool lm) {
+        if (e - b < parallel_sort_grain_size) {
+            detail::pdqsort_loop<Branchless>(std::move(b), std::move(e), comp,
+                                             proj, bad, lm);
+        } else {
+            tasks.run([&tasks, &comp, &proj, b, e, bad, lm] {
+                detail::parallel_pdqsort_loop<Branchless>(tasks, b, e, comp,
+                                                          proj, bad, lm);
+            });
+        }
+    };
+
+    detail::pdqsort_loop<Branchless>(std::move(begin), std::move(end), comp,
+                                     proj, bad_allowed, leftmost, recurse);
+}
+
+template <typename I, typename Comp, typename Proj>
+void parallel_pdqsort(I begin, I end, Comp& comp, Proj& proj)
+{
+    const auto len = end - begin;
+
+    if (len < parallel_sort_grain_size ||
+        task_pool::instance().concurrency() == 1) {
+        detail::pdqsort(std::move(begin), std::move(end), comp, proj);
+        return;
+    }
+
+    task_group tasks;
+    detail::parallel_pdqsort_loop<pdqsort_use_branchless<I, Comp, Proj>>(
+        tasks, std::move(begin), std::move(end), comp, proj,
+        detail::log2(len), true);
+    tasks.wait();
+}
+
+// Merges the sorted ranges [first1, last1) and [first2, last2) into the range
+// beginning at out, moving rather than copying elements. The merge is stable.
+// We repeatedly split the longer input at its midpoint, binary search for the
+// corresponding split point in the other input, and fork the upper halves.
+template <typename I1, typename I2, typename O, typename Comp, typename Proj>
+void parallel_move_merge(task_group& tasks, I1 first1, I1 last1, I2 first2,
+                         I2 last2, O out, Comp& comp, Proj& proj)
+{
+    while (true) {
+        const auto len1 = last1 - first1;
+        const auto len2 = last2 - first2;
+
+        if (len1 + len2 < parallel_sort_grain_size) {
+            nano::merge(nano::make_move_iterator(std::move(first1)),
+                        nano::make_move_iterator(std::move(last1)),
+                        nano::make_move_iterator(std::move(first2)),
+                        nano::make_move_iterator(std::move(last2)),
+                        std::move(out), std::ref(comp), std::ref(proj),
+                        std::ref(proj));
+            return;
+        }
+
+        I1 mid1 = first1;
+        I2 mid2 = first2;
+        if (len1 >= len2) {
+            mid1 += len1 / 2;
+            mid2 = nano::lower_bound(first2, last2, nano::invoke(proj, *mid1),
+                                     std::ref(comp), std::ref(proj));
+        } else {
+            mid2 += len2 / 2;
+            mid1 = nano::upper_bound(first1, last1, nano::invoke(proj, *mid2),
+                                     std::ref(comp), std::ref(proj));
+        }
+
+        O mid_out = out + ((mid1 - first1) + (mid2 - first2));
+        tasks.run([&tasks, &comp, &proj, mid1, last1, mid2, last2, mid_out] {
+            detail::parallel_move_merge(tasks, mid1, last1, mid2, last2,
+                                        mid_out, comp, proj);
+        });
+        last1 = std::move(mid1);
+        last2 = std::move(mid2);
+    }
+}
+
+} // namespace detail
+
+NANO_END_NAMESPACE
+
+#endif
+
+
+
+// nanorange/execution.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_EXECUTION_HPP_INCLUDED
+#define NANORANGE_EXECUTION_HPP_INCLUDED
+
+
+
+NANO_BEGIN_NAMESPACE
+
+// [execpol]
+// We provide our own policy types rather than using those from <execution>,
+// as some standard libraries refuse to compile that header without TBB
+
+namespace execution {
+
+struct sequenced_policy {};
+struct parallel_policy {};
+struct parallel_unsequenced_policy {};
+
+inline constexpr sequenced_policy seq{};
+inline constexpr parallel_policy par{};
+inline constexpr parallel_unsequenced_policy par_unseq{};
+
+} // namespace execution
+
+template <typename T>
+struct is_execution_policy : std::false_type {};
+
+template <>
+struct is_execution_policy<execution::sequenced_policy> : std::true_type {};
+
+template <>
+struct is_execution_policy<execution::parallel_policy> : std::true_type {};
+
+template <>
+struct is_execution_policy<execution::parallel_unsequenced_policy>
+    : std::true_type {};
+
+template <typename T>
+inline constexpr bool is_execution_policy_v = is_execution_policy<T>::value;
+
+namespace detail {
+
+template <typename EP>
+inline constexpr bool is_parallel_policy_v =
+    is_execution_policy_v<remove_cvref_t<EP>> &&
+    !std::is_same<remove_cvref_t<EP>, execution::sequenced_policy>::value;
+
+} // namespace detail
+
+NANO_END_NAMESPACE
+
+#endif
+
+
+NANO_BEGIN_NAMESPACE
+
+namespace detail {
+
+struct stable_sort_fn {
+private:
+    friend struct block_merge_sort_fn;
+
+    template <typename I, typename Comp, typename Proj>
+    static void inplace_stable_sort(I first, I last, Comp& comp, Proj& proj)
+    {
+        if (last - first < 15) {
+            detail::insertion_sort(std::move(first), std::move(last), comp, proj);
+        } else {
+            I middle = first + iter_difference_t<I>(last - first) / 2;
+            inplace_stable_sort(first, middle, comp, proj);
+            inplace_stable_sort(middle, last, comp, proj);
+            inplace_merge_fn::impl_slow(first, middle, last,
+                                        middle - first, last - middle,
+                                        comp, proj);
+        }
+    }
+
+    template <typename I, typename Comp, typename Proj>
+    static void impl(I first, I last, Comp& comp, Proj& proj,
+                     temporary_resource* resource = nullptr)
+    {
+        auto len = last - first;
+        if (len == 0) {
+            return;
+        }
+
+        if (len > 256) {
+            // The merges never buffer more than the shorter of two runs
+            temporary_vector<iter_value_t<I>> buf((len + 1) / 2, resource);
+            if (buf.capacity() != 0) {
+                detail::powersort(std::move(first), std::move(last), buf, comp,
+                                  proj);
+                return;
+            }
+        }
+
+        // Without that much room, make do with O(sqrt(n)) extra space, or
+        // failing that, with merging by rotations
+        if (!detail::block_merge_sort(first, last, comp, proj, resource)) {
+            inplace_stable_sort(std::move(first), std::move(last), comp, proj);
+        }
+    }
+
+    // Stably sorts the len elements beginning at src. If result_in_buf is
+    // true the sorted elements are then moved into the corresponding
+    // positions beginning at buf, otherwise they are left in src. The two
+    // halves of each subrange are sorted in parallel into the opposite
+    // buffer, and then merged back with a parallel merge. The leaves are
+    // sorted concurrently, so they always use the global heap.
+    template <typename I, typename B, typename Comp, typename Proj>
+    static void parallel_merge_sort(I src, B buf, iter_difference_t<I> len,
+                                    bool result_in_buf, Comp& comp, Proj& proj)
+    {
+        if (len < parallel_sort_grain_size) {
+            impl(src, src + len, comp, proj);
+            if (result_in_buf) {
+                nano::move(src, src + len, std::move(buf));
+            }
+            return;
+        }
+
+        const auto half = len / 2;
+        task_group tasks;
+        tasks.run([src, buf, half, result_in_buf, &comp, &proj] {
+            parallel_merge_sort(src, buf, half, !result_in_buf, comp, proj);
+        });
+        parallel_merge_sort(src + half, buf + half, len - half, !result_in_buf,
+                            comp, proj);
+        tasks.wait();
+
+        if (result_in_buf) {
+            detail::parallel_move_merge(tasks, src, src + half, src + half,
+                                        src + len, std::move(buf), comp, proj);
+        } else {
+            detail::parallel_move_merge(tasks, buf, buf + half, buf + half,
+                                        buf + len, std::move(src), comp, proj);
+        }
+        tasks.wait();
+    }
+
+    template <typename I, typename Comp, typename Proj>
+    static void parallel_impl(I first, I last, Comp& comp, Proj& proj,
+                              temporary_resource* resource = nullptr)
+    {
+        const auto len = last - first;
+        if (len < parallel_sort_grain_size ||
+            task_pool::instance().concurrency() == 1) {
+            impl(std::move(first), std::move(last), comp, proj, resource);
+            return;
+        }
+
+        temporary_vector<iter_value_t<I>> buf(len, resource);
+        if (buf.capacity() == 0) {
+            impl(std::move(first), std::move(last), comp, proj, resource);
+            return;
+        }
+
+        // Move everything into the buffer, and sort it back into place
+        for (I it = first; it != last; ++it) {
+            buf.push_back(nano::iter_move(it));
+        }
+        parallel_merge_sort(buf.begin(), std::move(first), len, true, comp,
+                            proj);
+    }
+
+    template <typename EP, typename I, typename Comp, typename Proj>
+    static void impl(EP&&, I first, I last, Comp& comp, Proj& proj,
+                     temporary_resource* resource = nullptr)
+    {
+        if constexpr (is_parallel_policy_v<EP>) {
+            parallel_impl(std::move(first), std::move(last), comp, proj,
+                          resource);
+        } else {
+            impl(std::move(first), std::move(last), comp, proj, resource);
+        }
+    }
+
+public:
+    template <typename I, typename S, typename Comp = ranges::less, typename Proj = identity>
+    std::enable_if_t<random_access_iterator<I> && sentinel_for<S, I> &&
+                         sortable<I, Comp, Proj>, I>
+    operator()(I first, S last, Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        const auto ilast = nano::next(first, last);
+        impl(std::move(first), ilast, comp, proj);
+        return ilast;
+    }
+
+    template <typename Rng, typename Comp = ranges::less, typename Proj = identity>
+    std::enable_if_t<random_access_range<Rng> &&
+                         sortable<iterator_t<Rng>, Comp, Proj>,
+                     borrowed_iterator_t<Rng>>
+    operator()(Rng&& rng, Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        auto first = nano::begin(rng);
+        const auto last = nano::next(first, nano::end(rng));
+        impl(std::move(first), last, comp, proj);
+        return last;
+    }
+
+    template <typename EP, typename I, typename S, typename Comp = ranges::less,
+              typename Proj = identity>
+    std::enable_if_t<is_execution_policy_v<remove_cvref_t<EP>> &&
+                         random_access_iterator<I> && sentinel_for<S, I> &&
+                         sortable<I, Comp, Proj>, I>
+    operator()(EP&& policy, I first, S last, Comp comp = Comp{},
+               Proj proj = Proj{}) const
+    {
+        const auto ilast = nano::next(first, last);
+        impl(std::forward<EP>(policy), std::move(first), ilast, comp, proj);
+        return ilast;
+    }
+
+    template <typename EP, typename Rng, typename Comp = ranges::less,
+              typename Proj = identity>
+    std::enable_if_t<is_execution_policy_v<remove_cvref_t<EP>> &&
+                         random_access_range<Rng> &&
+                         sortable<iterator_t<Rng>, Comp, Proj>,
+                     borrowed_iterator_t<Rng>>
+    operator()(EP&& policy, Rng&& rng, Comp comp = Comp{},
+               Proj proj = Proj{}) const
+    {
+        auto first = nano::begin(rng);
+        const auto last = nano::next(first, nano::end(rng));
+        impl(std::forward<EP>(policy), std::move(first), last, comp, proj);
+        return last;
+    }
+
+#if NANO_HAS_MEMORY_RESOURCE
+    // Extension: as above, but any scratch space is obtained from resource.
+    // With a parallel policy, only the buffer used by the final merges comes
+    // from resource, so it need not be thread-safe.
+    template <typename I, typename S, typename Comp = ranges::less, typename Proj = identity>
+    std::enable_if_t<random_access_iterator<I> && sentinel_for<S, I> &&
+                         sortable<I, Comp, Proj>, I>
+    operator()(std::pmr::memory_resource* resource, I first, S last,
+               Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        const auto ilast = nano::next(first, last);
+        impl(std::move(first), ilast, comp, proj, resource);
+        return ilast;
+    }
+
+    template <typename Rng, typename Comp = ranges::less, typename Proj = identity>
+    std::enable_if_t<random_access_range<Rng> &&
+                         sortable<iterator_t<Rng>, Comp, Proj>,
+                     borrowed_iterator_t<Rng>>
+    operator()(std::pmr::memory_resource* resource, Rng&& rng,
+               Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        auto first = nano::begin(rng);
+        const auto last = nano::next(first, nano::end(rng));
+        impl(std::move(first), last, comp, proj, resource);
+        return last;
+    }
+
+    template <typename EP, typename I, typename S, typename Comp = ranges::less,
+              typename Proj = identity>
+    std::enable_if_t<is_execution_policy_v<remove_cvref_t<EP>> &&
+                         random_access_iterator<I> && sentinel_for<S, I> &&
+                         sortable<I, Comp, Proj>, I>
+    operator()(EP&& policy, std::pmr::memory_resource* resource, I first,
+               S last, Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        const auto ilast = nano::next(first, last);
+        impl(std::forward<EP>(policy), std::move(first), ilast, comp, proj,
+             resource);
+        return ilast;
+    }
+
+    template <typename EP, typename Rng, typename Comp = ranges::less,
+              typename Proj = identity>
+    std::enable_if_t<is_execution_policy_v<remove_cvref_t<EP>> &&
+                         random_access_range<Rng> &&
+                         sortable<iterator_t<Rng>, Comp, Proj>,
+                     borrowed_iterator_t<Rng>>
+    operator()(EP&& policy, std::pmr::memory_resource* resource, Rng&& rng,
+               Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        auto first = nano::begin(rng);
+        const auto last = nano::next(first, nano::end(rng));
+        impl(std::forward<EP>(policy), std::move(first), last, comp, proj,
+             resource);
+        return last;
+    }
+#endif
+};
+
+}
+
+NANO_INLINE_VAR(detail::stable_sort_fn, stable_sort)
+
+NANO_END_NAMESPACE
+
+#endif
+
+
+
+NANO_BEGIN_NAMESPACE
+
+// Extension: stably sorts a range like stable_sort(), but never asks for
+// more than O(sqrt(n)) elements' worth of extra space, for callers which
+// cannot afford a buffer of half the range. Takes O(n log n) time; if even
+// that much space is not available, falls back to merging by rotations,
+// which takes O(n log^2 n). stable_sort() does the same when it cannot get
+// its usual buffer.
+
+namespace detail {
+
+struct block_merge_sort_fn {
+private:
+    template <typename I, typename Comp, typename Proj>
+    static void impl(I first, I last, Comp& comp, Proj& proj,
+                     temporary_resource* resource = nullptr)
+    {
+        if (!detail::block_merge_sort(first, last, comp, proj, resource)) {
+            stable_sort_fn::inplace_stable_sort(std::move(first),
+                                                std::move(last), comp, proj);
+        }
+    }
+
+public:
+    template <typename I, typename S, typename Comp = ranges::less,
+              typename Proj = identity>
+    std::enable_if_t<random_access_iterator<I> && sentinel_for<S, I> &&
+                         sortable<I, Comp, Proj>, I>
+    operator()(I first, S last, Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        const auto ilast = nano::next(first, last);
+        block_merge_sort_fn::impl(std::move(first), ilast, comp, proj);
+        return ilast;
+    }
+
+    template <typename Rng, typename Comp = ranges::less,
+              typename Proj = identity>
+    std::enable_if_t<random_access_range<Rng> &&
+                         sortable<iterator_t<Rng>, Comp, Proj>,
+                     borrowed_iterator_t<Rng>>
+    operator()(Rng&& rng, Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        auto first = nano::begin(rng);
+        const auto last = nano::next(first, nano::end(rng));
+        block_merge_sort_fn::impl(std::move(first), last, comp, proj);
+        return last;
+    }
+
+#if NANO_HAS_MEMORY_RESOURCE
+    // Extension: as above, but the scratch space is obtained from resource
+    template <typename I, typename S, typename Comp = ranges::less,
+              typename Proj = identity>
+    std::enable_if_t<random_access_iterator<I> && sentinel_for<S, I> &&
+                         sortable<I, Comp, Proj>, I>
+    operator()(std::pmr::memory_resource* resource, I first, S last,
+               Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        const auto ilast = nano::next(first, last);
+        block_merge_sort_fn::impl(std::move(first), ilast, comp, proj,
+                                  resource);
+        return ilast;
+    }
+
+    template <typename Rng, typename Comp = ranges::less,
+              typename Proj = identity>
+    std::enable_if_t<random_access_range<Rng> &&
+                         sortable<iterator_t<Rng>, Comp, Proj>,
+                     borrowed_iterator_t<Rng>>
+    operator()(std::pmr::memory_resource* resource, Rng&& rng,
+               Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        auto first = nano::begin(rng);
+        const auto last = nano::next(first, nano::end(rng));
+        block_merge_sort_fn::impl(std::move(first), last, comp, proj,
+                                  resource);
+        return last;
+    }
+#endif
+};
+
+} // namespace detail
+
+NANO_INLINE_VAR(detail::block_merge_sort_fn, block_merge_sort)
+
+NANO_END_NAMESPACE
+
+#endif
+
+// nanorange/algorithm/boyer_moore_horspool_searcher.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_ALGORITHM_BOYER_MOORE_HORSPOOL_SEARCHER_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_BOYER_MOORE_HORSPOOL_SEARCHER_HPP_INCLUDED
+
+// nanorange/algorithm/search.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_ALGORITHM_SEARCH_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_SEARCH_HPP_INCLUDED
+
+// nanorange/detail/algorithm/two_way_search.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// The Two-Way string matching algorithm of Crochemore and Perrin, as described
+// in "Two-way string-matching", Journal of the ACM 38(3):651-675, 1991. The
+// structure follows the implementation in glibc's str-two-way.h.
+
+#ifndef NANORANGE_DETAIL_ALGORITHM_TWO_WAY_SEARCH_HPP_INCLUDED
+#define NANORANGE_DETAIL_ALGORITHM_TWO_WAY_SEARCH_HPP_INCLUDED
+
+// nanorange/algorithm/find.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_ALGORITHM_FIND_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_FIND_HPP_INCLUDED
+
+
+
+
+NANO_BEGIN_NAMESPACE
+
+// [ranges.alg.find]
+
+namespace detail {
+
+struct find_if_fn {
+private:
+    friend struct find_fn;
+    friend struct find_if_not_fn;
+
+    template <typename I, typename S, typename Pred, typename Proj>
+    static constexpr I impl(I first, S last, Pred& pred, Proj& proj)
+    {
+        while (first != last) {
+            if (nano::invoke(pred, nano::invoke(proj, *first))) {
+                return first;
+            }
+            ++first;
+        }
+        return first;
+    }
+
+public:
+    template <typename I, typename S, typename Proj = identity, typename Pred>
+    constexpr std::enable_if_t<
+        input_iterator<I> && sentinel_for<S, I> &&
+            indirect_unary_predicate<Pred, projected<I, Proj>>,
+        I>
+    operator()(I first, S last, Pred pred, Proj proj = Proj{}) const
+    {
+        return find_if_fn::impl(std::move(first), std::move(last), pred, proj);
+    }
+
+    template <typename Rng, typename Proj = identity, typename Pred>
+    constexpr std::enable_if_t<
+        input_range<Rng> &&
+            indirect_unary_predicate<Pred, projected<iterator_t<Rng>, Proj>>,
+        borrowed_iterator_t<Rng>>
+    operator()(Rng&& rng, Pred pred, Proj proj = Proj{}) const
+    {
+        return find_if_fn::impl(nano::begin(rng), nano::end(rng), pred, proj);
+    }
+};
+} // namespace detail
+
+NANO_INLINE_VAR(detail::find_if_fn, find_if)
+
+namespace detail {
+
+struct find_fn {
+private:
+    template <typename I, typename S, typename T, typename Proj>
+    static constexpr I impl(I first, S last, const T& value, Proj& proj)
+    {
+        if constexpr (sized_sentinel_for<S, I> &&
+                      is_simd_find_candidate<I, T, Proj>) {
+            if (!detail::is_constant_evaluated()) {
+                const auto n = last - first;
+                if (n == 0) {
+                    return first;
+                }
+                const auto ptr = detail::to_address(first);
+                return first + (detail::simd_find(ptr, ptr + n, value) - ptr);
+            }
+        }
+
+        const auto pred = [&value] (const auto& t) {
+            using U = remove_cvref_t<decltype(t)>;
+            // Convert integers to their common type up front, as == would,
+            // so that mixing signedness doesn't warn
+            if constexpr (std::is_integral<U>::value &&
+                          std::is_integral<T>::value) {
+                using C = std::common_type_t<U, T>;
+                return static_cast<C>(t) == static_cast<C>(value);
+            } else {
+                return t == value;
+            }
+        };
+        return find_if_fn::impl(std::move(first), std::move(last), pred, proj);
+    }
+
+    template <typename Rng, typename T, typename Proj>
+    static constexpr iterator_t<Rng> range_impl(Rng& rng, const T& value,
+                                                Proj& proj)
+    {
+        return detail::simd_range_dispatch<
+            is_simd_find_candidate<range_pointer_t<Rng>, T, Proj>>(
+            rng,
+            [&](auto ptr, auto n) {
+                return nano::begin(rng) +
+                       (detail::simd_find(ptr, ptr + n, value) - ptr);
+            },
+            [&] {
+                return find_fn::impl(nano::begin(rng), nano::end(rng), value,
+                                     proj);
+            });
+    }
+
+public:
+    template <typename I, typename S, typename T, typename Proj = identity>
+    constexpr std::enable_if_t<
+        input_iterator<I> && sentinel_for<S, I> &&
+            indirect_relation<ranges::equal_to, projected<I, Proj>, const T*>,
+        I>
+    operator()(I first, S last, const T& value, Proj proj = Proj{}) const
+    {
+        return find_fn::impl(std::move(first), std::move(last), value, proj);
+    }
+
+    template <typename Rng, typename T, typename Proj = identity>
+    constexpr std::enable_if_t<
+        input_range<Rng> &&
+            indirect_relation<ranges::equal_to, projected<iterator_t<Rng>, Proj>,
+                             const T*>,
+        borrowed_iterator_t<Rng>>
+    operator()(Rng&& rng, const T& value, Proj proj = Proj{}) const
+    {
+        return find_fn::range_impl(rng, value, proj);
+    }
+};
+} // namespace detail
+
+NANO_INLINE_VAR(detail::find_fn, find)
+
+namespace detail {
+
+struct find_if_not_fn {
+private:
+    template <typename Pred>
+    struct not_pred {
+        Pred& p;
+
+        template <typename T>
+        constexpr bool operator()(T&& t) const
+        {
+            return !nano::invoke(p, std::forward<T>(t));
+        }
+    };
+
+public:
+    template <typename I, typename S, typename Proj = identity, typename Pred>
+    constexpr std::enable_if_t<
+        input_iterator<I> && sentinel_for<S, I> &&
+            indirect_unary_predicate<Pred, projected<I, Proj>>,
+        I>
+    operator()(I first, S last, Pred pred, Proj proj = Proj{}) const
+    {
+        const auto find_if_pred = not_pred<Pred>{pred};
+        return find_if_fn::impl(std::move(first), std::move(last),
+                                find_if_pred, proj);
+    }
+
+    template <typename Rng, typename Proj = identity, typename Pred>
+    constexpr std::enable_if_t<
+        input_range<Rng> &&
+            indirect_unary_predicate<Pred, projected<iterator_t<Rng>, Proj>>,
+        borrowed_iterator_t<Rng>>
+    operator()(Rng&& rng, Pred pred, Proj proj = Proj{}) const
+    {
+        const auto find_if_pred = not_pred<Pred>{pred};
+        return find_if_fn::impl(nano::begin(rng), nano::end(rng),
+                                find_if_pred, proj);
+    }
+};
+} // namespace detail
+
+NANO_INLINE_VAR(detail::find_if_not_fn, find_if_not)
+
+NANO_END_NAMESPACE
+
+#endif
+
+
+
+#include <functional>
+
+NANO_BEGIN_NAMESPACE
+
+namespace detail {
+
+// Needles shorter than this are searched for with the naive algorithm, which
+// is faster when it cannot go quadratic
+constexpr std::ptrdiff_t two_way_search_threshold = 8;
+
+template <typename Pred>
+inline constexpr bool is_equal_to_pred =
+    same_as<Pred, ranges::equal_to> || same_as<Pred, std::equal_to<>>;
+
+template <typename I2, typename Proj2, bool = readable<projected<I2, Proj2>>>
+inline constexpr bool is_ordered_needle = false;
+
+template <typename I2, typename Proj2>
+inline constexpr bool is_ordered_needle<I2, Proj2, true> =
+    totally_ordered<iter_value_t<projected<I2, Proj2>>>;
+
+// Two-Way needs random access to both sequences and their lengths, an
+// equality predicate, and (to factorise the needle) a total order which is
+// consistent with that equality
+template <typename I1, typename S1, typename I2, typename S2, typename Pred,
+          typename Proj2>
+inline constexpr bool is_two_way_candidate =
+    random_access_iterator<I1> && sized_sentinel_for<S1, I1> &&
+    random_access_iterator<I2> && sized_sentinel_for<S2, I2> &&
+    is_equal_to_pred<Pred> && is_ordered_needle<I2, Proj2>;
+
+// Returns the starting position of the maximal suffix of the needle [first,
+// first + m) with respect to the given order, and sets period to the period
+// of that suffix
+template <typename I, typename Less, typename Proj>
+constexpr iter_difference_t<I> two_way_maximal_suffix(I first,
+                                                      iter_difference_t<I> m,
+                                                      Less less, Proj& proj,
+                                                      iter_difference_t<I>& period)
+{
+    iter_difference_t<I> max_suffix = -1;
+    iter_difference_t<I> j = 0;
+    iter_difference_t<I> k = 1;
+    iter_difference_t<I> p = 1;
+
+    while (j + k < m) {
+        auto&& a = nano::invoke(proj, first[j + k]);
+        auto&& b = nano::invoke(proj, first[max_suffix + k]);
+        if (less(a, b)) {
+            // Suffix is smaller, period is the entire prefix so far
+            j += k;
+            k = 1;
+            p = j - max_suffix;
+        } else if (less(b, a)) {
+            // Suffix is larger, start over from the current location
+            max_suffix = j++;
+            k = p = 1;
+        } else if (k != p) {
+            // Advance through the repetition of the current period
+            ++k;
+        } else {
+            // Done with the current repetition of the period
+            j += p;
+            k = 1;
+        }
+    }
+
+    period = p;
+    return max_suffix + 1;
+}
+
+// Returns the position of a critical factorization of the needle, and sets
+// period to the period of its right half
+template <typename I, typename Proj>
+constexpr iter_difference_t<I>
+two_way_critical_factorization(I first, iter_difference_t<I> m, Proj& proj,
+                               iter_difference_t<I>& period)
+{
+    // The later of the maximal suffixes for an order and its reverse gives a
+    // critical factorization
+    iter_difference_t<I> period_rev = 0;
+    const auto suffix =
+        detail::two_way_maximal_suffix(first, m, nano::less{}, proj, period);
+    const auto suffix_rev = detail::two_way_maximal_suffix(
+        first, m, nano::greater{}, proj, period_rev);
+
+    if (suffix_rev > suffix) {
+        period = period_rev;
+        return suffix_rev;
+    }
+    return suffix;
+}
+
+// Searches for [first2, first2 + m) in [first1, first1 + n), in O(n + m)
+// time and constant space. Requires 0 < m.
+template <typename I1, typename I2, typename Pred, typename Proj1,
+          typename Proj2>
+constexpr subrange<I1> two_way_search(I1 first1, iter_difference_t<I1> n,
+                                      I2 first2, iter_difference_t<I2> m,
+                                      Pred& pred, Proj1& proj1, Proj2& proj2)
+{
+    using diff_t = iter_difference_t<I1>;
+
+    if (n < m) {
+        return {first1 + n, first1 + n};
+    }
+
+    const auto eq = [&](diff_t i, diff_t j) {
+        return nano::invoke(pred, nano::invoke(proj1, first1[j + i]),
+                            nano::invoke(proj2, first2[i]));
+    };
+
+    iter_difference_t<I2> period = 0;
+    const diff_t suffix =
+        detail::two_way_critical_factorization(first2, m, proj2, period);
+
+    // Whether the needle's left half is a repetition of its period
+    bool periodic = true;
+    for (diff_t i = 0; i < suffix; ++i) {
+        if (!nano::invoke(pred, nano::invoke(proj2, first2[i]),
+                          nano::invoke(proj2, first2[i + period]))) {
+            periodic = false;
+            break;
+        }
+    }
+
+    // Most attempts fail on the first comparison, so look for the first
+    // element of the right half with find(), which is much faster than the
+    // main loop and may be vectorised
+    auto&& key = nano::invoke(proj2, first2[suffix]);
+    const I1 key_last = first1 + (n - m + suffix + 1);
+    const auto skip_to_key = [&](diff_t j) {
+        if (j > n - m) {
+            return j;
+        }
+        I1 it = first1 + (j + suffix);
+        if constexpr (same_as<iter_value_t<projected<I1, Proj1>>,
+                              remove_cvref_t<decltype(key)>>) {
+            it = nano::find(std::move(it), key_last, key, proj1);
+        } else {
+            // Leave mixed-type comparisons to the predicate
+            while (it != key_last &&
+                   !nano::invoke(pred, nano::invoke(proj1, *it), key)) {
+                ++it;
+            }
+        }
+        return (it - first1) - suffix;
+    };
+
+    diff_t j = 0;
+    if (periodic) {
+        // Entire needle is periodic; a mismatch in the left half can only
+        // advance by the period, so use memory to avoid rescanning known
+        // occurrences of the period.
+        diff_t memory = 0;
+        while (true) {
+            diff_t i = suffix;
+            if (memory == 0) {
+                j = skip_to_key(j);
+                if (j > n - m) {
+                    break;
+                }
+                ++i;
+            } else if (memory > i) {
+                i = memory;
+            }
+
+            // Scan for matches in the right half
+            while (i < m && eq(i, j)) {
+                ++i;
+            }
+            if (i < m) {
+                j += i - suffix + 1;
+                memory = 0;
+                continue;
+            }
+
+            // Scan for matches in the left half
+            i = suffix - 1;
+            while (memory < i + 1 && eq(i, j)) {
+                --i;
+            }
+            if (i < memory) {
+                return {first1 + j, first1 + (j + m)};
+            }
+            j += period;
+            memory = m - period;
+            if (j > n - m) {
+                break;
+            }
+        }
+    } else {
+        // The two halves of the needle are distinct; no extra memory is
+        // required, and any mismatch results in a maximal shift.
+        const diff_t shift = (suffix > m - suffix ? suffix : m - suffix) + 1;
+        while (true) {
+            j = skip_to_key(j);
+            if (j > n - m) {
+                break;
+            }
+
+            diff_t i = suffix + 1;
+            while (i < m && eq(i, j)) {
+                ++i;
+            }
+            if (i < m) {
+                j += i - suffix + 1;
+                continue;
+            }
+
+            i = suffix - 1;
+            while (i >= 0 && eq(i, j)) {
+                --i;
+            }
+            if (i < 0) {
+                return {first1 + j, first1 + (j + m)};
+            }
+            j += shift;
+        }
+    }
+
+    return {first1 + n, first1 + n};
+}
+
+} // namespace detail
+
+NANO_END_NAMESPACE
+
+#endif
+
+
+
+
+NANO_BEGIN_NAMESPACE
+
+namespace detail {
+
+struct searcher_for_concept {
+    template <typename Searcher, typename I, typename S, typename Proj>
+    auto requires_(const Searcher& searcher, I i, S s, Proj proj)
+        -> decltype(requires_expr<same_as<
+                        decltype(searcher(std::move(i), std::move(s),
+                                          std::move(proj))),
+                        subrange<I>>>{});
+};
+
+// A searcher is a function object such as boyer_moore_horspool_searcher,
+// which is called with the haystack's iterator, sentinel and projection and
+// returns the subrange of the first match
+template <typename Searcher, typename I, typename S, typename Proj>
+NANO_CONCEPT searcher_for =
+    requires_<searcher_for_concept, Searcher, I, S, Proj>;
+
+struct search_fn {
+private:
+    friend struct find_end_fn;
+
+    template <typename I1, typename S1, typename I2, typename S2,
+              typename Pred, typename Proj1, typename Proj2 = identity>
+    static constexpr subrange<I1>
+    impl(I1 first1, S1 last1, I2 first2, S2 last2, Pred& pred, Proj1& proj1,
+         Proj2& proj2)
+    {
+        if constexpr (is_two_way_candidate<I1, S1, I2, S2, Pred, Proj2>) {
+            const auto m = last2 - first2;
+            if (m >= two_way_search_threshold) {
+                return detail::two_way_search(std::move(first1),
+                                              last1 - first1,
+                                              std::move(first2), m, pred,
+                                              proj1, proj2);
+            }
+        }
+
+        while (true) {
+            auto it1 = first1;
+            auto it2 = first2;
+
+            while (true) {
+                if (it2 == last2) {
+                    return {first1, it1};
+                }
+                if (it1 == last1) {
+                    return {it1, it1};
+                }
+                if (!nano::invoke(pred, nano::invoke(proj1, *it1), nano::invoke(proj2, *it2))) {
+                    break;
+                }
+                ++it1; ++it2;
+            }
+
+
+            ++first1;
+        }
+    }
+
+public:
+    template <typename I1, typename S1, typename I2, typename S2,
+              typename Pred = ranges::equal_to, typename Proj1 = identity,
+              typename Proj2 = identity>
+    constexpr std::enable_if_t<
+        forward_iterator<I1> && sentinel_for<S1, I1> && forward_iterator<I2> &&
+            sentinel_for<S2, I2> &&
+            indirectly_comparable<I1, I2, Pred, Proj1, Proj2>,
+         subrange<I1>>
+    operator()(I1 first1, S1 last1, I2 first2, S2 last2,
+               Pred pred = Pred{}, Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
+    {
+        return search_fn::impl(std::move(first1), std::move(last1),
+                               std::move(first2), std::move(last2),
+                               pred, proj1, proj2);
+    }
+
+    template <typename Rng1, typename Rng2, typename Pred = ranges::equal_to,
+              typename Proj1 = identity, typename Proj2 = identity>
+    constexpr std::enable_if_t<
+        forward_range<Rng1> && forward_range<Rng2> &&
+            indirectly_comparable<iterator_t<Rng1>, iterator_t<Rng2>, Pred, Proj1, Proj2>,
+        borrowed_subrange_t<Rng1>>
+    operator()(Rng1&& rng1, Rng2&& rng2, Pred pred = Pred{},
+               Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
+    {
+        return search_fn::impl(nano::begin(rng1), nano::end(rng1),
+                               nano::begin(rng2), nano::end(rng2),
+                               pred, proj1, proj2);
+    }
+
+    // Extension: searches for the needle with which the searcher was
+    // constructed, applying proj to the elements of the haystack
+    template <typename I, typename S, typename Searcher,
+              typename Proj = identity>
+    constexpr std::enable_if_t<forward_iterator<I> && sentinel_for<S, I> &&
+                                   searcher_for<Searcher, I, S, Proj>,
+                               subrange<I>>
+    operator()(I first, S last, const Searcher& searcher,
+               Proj proj = Proj{}) const
+    {
+        return searcher(std::move(first), std::move(last), std::move(proj));
+    }
+
+    // Extension: as above, with a range
+    template <typename Rng, typename Searcher, typename Proj = identity>
+    constexpr std::enable_if_t<
+        forward_range<Rng> &&
+            searcher_for<Searcher, iterator_t<Rng>, sentinel_t<Rng>, Proj>,
+        borrowed_subrange_t<Rng>>
+    operator()(Rng&& rng, const Searcher& searcher, Proj proj = Proj{}) const
+    {
+        return searcher(nano::begin(rng), nano::end(rng), std::move(proj));
+    }
+};
+
+}
+
+NANO_INLINE_VAR(detail::search_fn, search)
+
+NANO_END_NAMESPACE
+
+#endif
+
+#include <array>
+#include <unordered_map>
+
+NANO_BEGIN_NAMESPACE
+
+// Extension: a searcher for use with search(haystack, searcher), which
+// precomputes the Boyer-Moore-Horspool skip table for a needle once so that
+// it can be reused across many haystacks. Mismatches typically skip ahead by
+// close to the length of the needle, so long needles are found in sublinear
+// time; the worst case is O(nm).
+//
+// Like std::boyer_moore_horspool_searcher, the searcher refers to the needle
+// rather than copying it, so the needle must outlive the searcher. The
+// projected needle elements are compared with ranges::equal_to against the
+// projected haystack elements, which must have the same value type. One-byte
+// integral and enumeration types (including char and std::byte) use a flat
+// 256-entry table; other types must be hashable with std::hash.
+
+namespace detail {
+
+template <typename Key, typename Diff, bool = is_byte_like<Key>>
+struct bmh_skip_table {
+    explicit bmh_skip_table(Diff default_skip)
+        : default_skip_(default_skip)
+    {}
+
+    void set(const Key& key, Diff skip) { map_[key] = skip; }
+
+    Diff operator[](const Key& key) const
+    {
+        const auto it = map_.find(key);
+        return it == map_.end() ? default_skip_ : it->second;
+    }
+
+private:
+    std::unordered_map<Key, Diff> map_{};
+    Diff default_skip_;
+};
+
+template <typename Key, typename Diff>
+struct bmh_skip_table<Key, Diff, true> {
+    explicit bmh_skip_table(Diff default_skip)
+    {
+        table_.fill(default_skip);
+    }
+
+    void set(const Key& key, Diff skip)
+    {
+        table_[static_cast<unsigned char>(key)] = skip;
+    }
+
+    Diff operator[](const Key& key) const
+    {
+        return table_[static_cast<unsigned char>(key)];
+    }
+
+private:
+    std::array<Diff, 256> table_;
+};
+
+} // namespace detail
+
+template <typename I, typename Proj = identity>
+class boyer_moore_horspool_searcher {
+    static_assert(random_access_iterator<I>,
+                  "boyer_moore_horspool_searcher requires a random-access needle");
+
+    using key_type = iter_value_t<projected<I, Proj>>;
+    using diff_t = iter_difference_t<I>;
+
+public:
+    template <typename S, std::enable_if_t<sized_sentinel_for<S, I>, int> = 0>
+    boyer_moore_horspool_searcher(I first, S last, Proj proj = Proj{})
+        : first_(std::move(first)),
+          m_(last - first_),
+          proj_(std::move(proj)),
+          skip_(m_)
+    {
+        // The skip for each element is its distance from the end of the
+        // needle, ignoring the last element itself
+        for (diff_t i = 0; i < m_ - 1; ++i) {
+            skip_.set(nano::invoke(proj_, first_[i]), m_ - 1 - i);
+        }
+    }
+
+    template <typename Rng,
+              std::enable_if_t<borrowed_range<Rng> && sized_range<Rng> &&
+                                   same_as<iterator_t<Rng>, I>, int> = 0>
+    explicit boyer_moore_horspool_searcher(Rng&& needle, Proj proj = Proj{})
+        : boyer_moore_horspool_searcher(nano::begin(needle),
+                                        nano::begin(needle) +
+                                            nano::distance(needle),
+                                        std::move(proj))
+    {}
+
+    template <typename I2, typename S2, typename Proj2 = identity>
+    std::enable_if_t<random_access_iterator<I2> && sized_sentinel_for<S2, I2> &&
+                         same_as<iter_value_t<projected<I2, Proj2>>, key_type> &&
+                         indirectly_comparable<I2, I, ranges::equal_to, Proj2, Proj>,
+                     subrange<I2>>
+    operator()(I2 first, S2 last, Proj2 proj2 = Proj2{}) const
+    {
+        const iter_difference_t<I2> n = last - first;
+        if (m_ == 0) {
+            return {first, first};
+        }
+        if (n < m_) {
+            first += n;
+            return {first, first};
+        }
+
+        const auto matches = [&](auto&& x, diff_t i) -> bool {
+            return nano::invoke(ranges::equal_to{}, std::forward<decltype(x)>(x),
+                                nano::invoke(proj_, first_[i]));
+        };
+
+        // Compare the last element of each candidate position first: on a
+        // mismatch, the skip table says how far we can safely jump
+        const iter_difference_t<I2> last_start = n - m_;
+        for (iter_difference_t<I2> j = 0; j <= last_start;) {
+            auto&& key = nano::invoke(proj2, first[j + (m_ - 1)]);
+            if (matches(key, m_ - 1)) {
+                diff_t i = 0;
+                while (i < m_ - 1 && matches(nano::invoke(proj2, first[j + i]), i)) {
+                    ++i;
+                }
+                if (i == m_ - 1) {
+                    return {first + j, first + (j + m_)};
+                }
+            }
+            j += skip_[key];
+        }
+
+        first += n;
+        return {first, first};
+    }
+
+private:
+    I first_;
+    diff_t m_;
+    Proj proj_;
+    detail::bmh_skip_table<key_type, diff_t> skip_;
+};
+
+template <typename I, typename S, typename Proj = identity,
+          std::enable_if_t<sized_sentinel_for<S, I>, int> = 0>
+boyer_moore_horspool_searcher(I, S, Proj = Proj{})
+    -> boyer_moore_horspool_searcher<I, Proj>;
+
+template <typename Rng, typename Proj = identity,
+          std::enable_if_t<range<Rng>, int> = 0>
+boyer_moore_horspool_searcher(Rng&&, Proj = Proj{})
+    -> boyer_moore_horspool_searcher<iterator_t<Rng>, Proj>;
+
+NANO_END_NAMESPACE
+
+#endif
+
+// nanorange/algorithm/clamp.hpp
+//
+// Copyright (c) 2020 Boris Staletic (boris dot staletic at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_ALGORITHM_CLAMP_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_CLAMP_HPP_INCLUDED
+
+
+
+NANO_BEGIN_NAMESPACE
+
+namespace detail {
+
+struct clamp_fn {
+    template <typename T, typename Proj = identity, typename Comp = nano::less>
+    constexpr std::enable_if_t<indirect_strict_weak_order<Comp, projected<const T*, Proj>>, const T&>
+    operator()(const T& value, const T& low, const T& high, Comp comp = {}, Proj proj = Proj{}) const
+    {
+        auto&& projected_value = nano::invoke(proj, value);
+        if (nano::invoke(comp, projected_value, nano::invoke(proj, low))) {
+            return low;
+        } else if (nano::invoke(comp, nano::invoke(proj, high), projected_value)) {
+            return high;
+        } else {
+            return value;
+        }
+    }
+};
+} // namespace detail
+
+NANO_INLINE_VAR(detail::clamp_fn, clamp)
+
+NANO_END_NAMESPACE
+
+#endif
+
+
+// nanorange/algorithm/count.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_ALGORITHM_COUNT_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_COUNT_HPP_INCLUDED
+
+
+
+
+NANO_BEGIN_NAMESPACE
+
+// [rng.alg.count]
+
+namespace detail {
+
+struct count_if_fn {
+private:
+    friend struct count_fn;
+    friend struct is_permutation_fn;
+
+    template <typename I, typename S, typename Proj, typename Pred>
+    static constexpr iter_difference_t<I> impl(I first, S last, Pred& pred,
+                                               Proj& proj)
+    {
+        iter_difference_t<I> counter = 0;
+
+        for (; first != last; ++first) {
+            if (nano::invoke(pred, nano::invoke(proj, *first))) {
+                ++counter;
+            }
+        }
+
+        return counter;
+    }
+
+public:
+    template <typename I, typename S, typename Proj = identity, typename Pred>
+    constexpr std::enable_if_t<
+        input_iterator<I> && sentinel_for<S, I> &&
+            indirect_unary_predicate<Pred, projected<I, Proj>>,
+        iter_difference_t<I>>
+    operator()(I first, S last, Pred pred, Proj proj = Proj{}) const
+    {
+        return count_if_fn::impl(std::move(first), std::move(last),
+                                 pred, proj);
+    }
+
+    template <typename Rng, typename Proj = identity, typename Pred>
+    constexpr std::enable_if_t<
+        input_range<Rng> &&
+            indirect_unary_predicate<Pred, projected<iterator_t<Rng>, Proj>>,
+        range_difference_t<Rng>>
+    operator()(Rng&& rng, Pred pred, Proj proj = Proj{}) const
+    {
+        return count_if_fn::impl(nano::begin(rng), nano::end(rng),
+                                 pred, proj);
+    }
+};
+} // namespace detail
+
+NANO_INLINE_VAR(detail::count_if_fn, count_if)
+
+namespace detail {
+
+struct count_fn {
+private:
+    template <typename I, typename S, typename T, typename Proj>
+    static constexpr iter_difference_t<I> impl(I first, S last,
+                                               const T& value, Proj& proj)
+    {
+        if constexpr (sized_sentinel_for<S, I> &&
+                      is_simd_find_candidate<I, T, Proj>) {
+            if (!detail::is_constant_evaluated()) {
+                const auto n = last - first;
+                if (n == 0) {
+                    return 0;
+                }
+                const auto ptr = detail::to_address(first);
+                return detail::simd_count(ptr, ptr + n, value);
+            }
+        }
+
+        const auto pred = [&value] (const auto& t) { return t == value; };
+        return count_if_fn::impl(std::move(first), std::move(last),
+                                 pred, proj);
+    }
+
+    template <typename Rng, typename T, typename Proj>
+    static constexpr range_difference_t<Rng> range_impl(Rng& rng,
+                                                        const T& value,
+                                                        Proj& proj)
+    {
+        if constexpr (contiguous_range<Rng> && sized_range<Rng> &&
+                      is_simd_find_candidate<range_pointer_t<Rng>, T, Proj>) {
+            if (!detail::is_constant_evaluated()) {
+                const auto ptr = nano::data(rng);
+                return detail::simd_count(ptr, ptr + nano::distance(rng),
+                                          value);
+            }
+        }
+
+        return count_fn::impl(nano::begin(rng), nano::end(rng), value, proj);
+    }
+
+public:
+    template <typename I, typename S, typename T, typename Proj = identity>
+    constexpr std::enable_if_t<
+        input_iterator<I> && sentinel_for<S, I> &&
+            indirect_relation<ranges::equal_to, projected<I, Proj>, const T*>,
+        iter_difference_t<I>>
+    operator()(I first, S last, const T& value, Proj proj = Proj{}) const
+    {
+        return count_fn::impl(std::move(first), std::move(last), value, proj);
+    }
+
+    template <typename Rng, typename T, typename Proj = identity>
+    constexpr std::enable_if_t<
+        input_range<Rng> &&
+            indirect_relation<ranges::equal_to, projected<iterator_t<Rng>, Proj>,
+                             const T*>,
+        range_difference_t<Rng>>
+    operator()(Rng&& rng, const T& value, Proj proj = Proj{}) const
+    {
+        return count_fn::range_impl(rng, value, proj);
+    }
+};
+
+} // namespace detail
+
+NANO_INLINE_VAR(detail::count_fn, count)
+
+NANO_END_NAMESPACE
+
+#endif
+
+// nanorange/algorithm/dary_heap.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_ALGORITHM_DARY_HEAP_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_DARY_HEAP_HPP_INCLUDED
+
+
+
+
+NANO_BEGIN_NAMESPACE
+
+// Extension: heap algorithms for heaps in which each element has D children
+// rather than two. make_dary_heap<D>, push_dary_heap<D>, pop_dary_heap<D>,
+// sort_dary_heap<D>, is_dary_heap<D> and is_dary_heap_until<D> behave like
+// their binary counterparts, but must only be used on ranges which are
+// D-ary heaps.
+//
+// A D-ary heap is log2(D) times shallower than a binary heap, so
+// push_dary_heap does fewer comparisons than push_heap. pop_dary_heap
+// compares all D children at each level, so it does more comparisons than
+// pop_heap; with D = 4 it runs at about the same speed.
+// Note that a binary heap is a D-ary heap only for D = 2.
+
+namespace detail {
+
+template <std::ptrdiff_t D>
+struct sort_dary_heap_fn;
+
+template <std::ptrdiff_t D>
+struct is_dary_heap_fn;
+
+template <std::ptrdiff_t D>
+struct push_dary_heap_fn {
+    static_assert(D >= 2, "A heap must have at least two children per element");
+
+    template <typename I, typename S, typename Comp = ranges::less,
+              typename Proj = identity>
+    constexpr std::enable_if_t<random_access_iterator<I> && sentinel_for<S, I> &&
+                                   sortable<I, Comp, Proj>, I>
+    operator()(I first, S last, Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        const auto n = nano::distance(first, last);
+        detail::dary_sift_up_n<D>(first, n, comp, proj);
+        return first + n;
+    }
+
+    template <typename Rng, typename Comp = ranges::less, typename Proj = identity>
+    constexpr std::enable_if_t<random_access_range<Rng> &&
+                                   sortable<iterator_t<Rng>, Comp, Proj>,
+                               borrowed_iterator_t<Rng>>
+    operator()(Rng&& rng, Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        const auto n = nano::distance(rng);
+        detail::dary_sift_up_n<D>(nano::begin(rng), n, comp, proj);
+        return nano::begin(rng) + n;
+    }
+};
+
+template <std::ptrdiff_t D>
+struct pop_dary_heap_fn {
+    static_assert(D >= 2, "A heap must have at least two children per element");
+
+private:
+    friend struct sort_dary_heap_fn<D>;
+
+    template <typename I, typename Comp, typename Proj>
+    static constexpr I impl(I first, iter_difference_t<I> n, Comp& comp,
+                            Proj& proj)
+    {
+        if (n > 1) {
+            nano::iter_swap(first, first + (n - 1));
+            detail::dary_sift_down_n<D>(first, n - 1, first, comp, proj);
+        }
+
+        return first + n;
+    }
+
+public:
+    template <typename I, typename S, typename Comp = ranges::less,
+              typename Proj = identity>
+    constexpr std::enable_if_t<random_access_iterator<I> && sentinel_for<S, I> &&
+                                   sortable<I, Comp, Proj>, I>
+    operator()(I first, S last, Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        const auto n = nano::distance(first, last);
+        return pop_dary_heap_fn::impl(std::move(first), n, comp, proj);
+    }
+
+    template <typename Rng, typename Comp = ranges::less, typename Proj = identity>
+    constexpr std::enable_if_t<random_access_range<Rng> &&
+                                   sortable<iterator_t<Rng>, Comp, Proj>,
+                               borrowed_iterator_t<Rng>>
+    operator()(Rng&& rng, Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        return pop_dary_heap_fn::impl(nano::begin(rng), nano::distance(rng),
+                                      comp, proj);
+    }
+};
+
+template <std::ptrdiff_t D>
+struct make_dary_heap_fn {
+    static_assert(D >= 2, "A heap must have at least two children per element");
+
+private:
+    template <typename I, typename Comp, typename Proj>
+    static constexpr I impl(I first, iter_difference_t<I> n, Comp& comp,
+                            Proj& proj)
+    {
+        if (n > 1) {
+            // start from the last element with children
+            for (auto start = (n - 2) / D; start >= 0; --start) {
+                detail::dary_sift_down_n<D>(first, n, first + start, comp,
+                                            proj);
+            }
+        }
+
+        return first + n;
+    }
+
+public:
+    template <typename I, typename S, typename Comp = ranges::less,
+              typename Proj = identity>
+    constexpr std::enable_if_t<random_access_iterator<I> && sentinel_for<S, I> &&
+                                   sortable<I, Comp, Proj>, I>
+    operator()(I first, S last, Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        const auto n = nano::distance(first, last);
+        return make_dary_heap_fn::impl(std::move(first), n, comp, proj);
+    }
+
+    template <typename Rng, typename Comp = ranges::less, typename Proj = identity>
+    constexpr std::enable_if_t<random_access_range<Rng> &&
+                                   sortable<iterator_t<Rng>, Comp, Proj>,
+                               borrowed_iterator_t<Rng>>
+    operator()(Rng&& rng, Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        return make_dary_heap_fn::impl(nano::begin(rng), nano::distance(rng),
+                                       comp, proj);
+    }
+};
+
+template <std::ptrdiff_t D>
+struct sort_dary_heap_fn {
+    static_assert(D >= 2, "A heap must have at least two children per element");
+
+private:
+    template <typename I, typename Comp, typename Proj>
+    static constexpr I impl(I first, iter_difference_t<I> n, Comp& comp,
+                            Proj& proj)
+    {
+        for (auto i = n; i > 1; --i) {
+            pop_dary_heap_fn<D>::impl(first, i, comp, proj);
+        }
+
+        return first + n;
+    }
+
+public:
+    template <typename I, typename S, typename Comp = ranges::less,
+              typename Proj = identity>
+    constexpr std::enable_if_t<random_access_iterator<I> && sentinel_for<S, I> &&
+                                   sortable<I, Comp, Proj>, I>
+    operator()(I first, S last, Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        const auto n = nano::distance(first, last);
+        return sort_dary_heap_fn::impl(std::move(first), n, comp, proj);
+    }
+
+    template <typename Rng, typename Comp = ranges::less, typename Proj = identity>
+    constexpr std::enable_if_t<random_access_range<Rng> &&
+                                   sortable<iterator_t<Rng>, Comp, Proj>,
+                               borrowed_iterator_t<Rng>>
+    operator()(Rng&& rng, Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        return sort_dary_heap_fn::impl(nano::begin(rng), nano::distance(rng),
+                                       comp, proj);
+    }
+};
+
+template <std::ptrdiff_t D>
+struct is_dary_heap_until_fn {
+    static_assert(D >= 2, "A heap must have at least two children per element");
+
+private:
+    friend struct is_dary_heap_fn<D>;
+
+    template <typename I, typename Comp, typename Proj>
+    static constexpr I impl(I first, const iter_difference_t<I> n, Comp& comp,
+                            Proj& proj)
+    {
+        for (iter_difference_t<I> c = 1; c < n; ++c) {
+            if (nano::invoke(comp, nano::invoke(proj, first[(c - 1) / D]),
+                             nano::invoke(proj, first[c]))) {
+                return first + c;
+            }
+        }
+
+        return first + n;
+    }
+
+public:
+    template <typename I, typename S, typename Comp = ranges::less,
+              typename Proj = identity>
+    constexpr std::enable_if_t<
+        random_access_iterator<I> && sentinel_for<S, I> &&
+            indirect_strict_weak_order<Comp, projected<I, Proj>>,
+        I>
+    operator()(I first, S last, Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        const auto n = nano::distance(first, last);
+        return is_dary_heap_until_fn::impl(std::move(first), n, comp, proj);
+    }
+
+    template <typename Rng, typename Comp = ranges::less, typename Proj = identity>
+    constexpr std::enable_if_t<
+        random_access_range<Rng> &&
+            indirect_strict_weak_order<Comp, projected<iterator_t<Rng>, Proj>>,
+        borrowed_iterator_t<Rng>>
+    operator()(Rng&& rng, Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        return is_dary_heap_until_fn::impl(nano::begin(rng),
+                                           nano::distance(rng), comp, proj);
+    }
+};
+
+template <std::ptrdiff_t D>
+struct is_dary_heap_fn {
+    template <typename I, typename S, typename Comp = ranges::less,
+              typename Proj = identity>
+    constexpr std::enable_if_t<
+        random_access_iterator<I> && sentinel_for<S, I> &&
+            indirect_strict_weak_order<Comp, projected<I, Proj>>,
+        bool>
+    operator()(I first, S last, Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        const auto n = nano::distance(first, last);
+        return is_dary_heap_until_fn<D>::impl(first, n, comp, proj) ==
+               first + n;
+    }
+
+    template <typename Rng, typename Comp = ranges::less, typename Proj = identity>
+    constexpr std::enable_if_t<
+        random_access_range<Rng> &&
+            indirect_strict_weak_order<Comp, projected<iterator_t<Rng>, Proj>>,
+        bool>
+    operator()(Rng&& rng, Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        const auto n = nano::distance(rng);
+        return is_dary_heap_until_fn<D>::impl(nano::begin(rng), n, comp,
+                                              proj) == nano::begin(rng) + n;
+    }
+};
+
+} // namespace detail
+
+inline namespace function_objects {
+
+template <std::ptrdiff_t D>
+inline constexpr detail::push_dary_heap_fn<D> push_dary_heap{};
+
+template <std::ptrdiff_t D>
+inline constexpr detail::pop_dary_heap_fn<D> pop_dary_heap{};
+
+template <std::ptrdiff_t D>
+inline constexpr detail::make_dary_heap_fn<D> make_dary_heap{};
+
+template <std::ptrdiff_t D>
+inline constexpr detail::sort_dary_heap_fn<D> sort_dary_heap{};
+
+template <std::ptrdiff_t D>
+inline constexpr detail::is_dary_heap_until_fn<D> is_dary_heap_until{};
+
+template <std::ptrdiff_t D>
+inline constexpr detail::is_dary_heap_fn<D> is_dary_heap{};
+
+} // namespace function_objects
+
+NANO_END_NAMESPACE
+
+#endif
+
+// nanorange/algorithm/equal.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_ALGORITHM_EQUAL_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_EQUAL_HPP_INCLUDED
+
+
+
+
+
+NANO_BEGIN_NAMESPACE
+
+namespace detail {
+
+struct equal_fn {
+private:
+    template <typename I1, typename S1, typename I2, typename S2, typename Pred,
+              typename Proj1, typename Proj2>
+    static constexpr bool impl4(I1 first1, S1 last1, I2 first2, S2 last2,
+                                Pred& pred, Proj1& proj1, Proj2& proj2)
+    {
+        while (first1 != last1 && first2 != last2) {
+            if (!nano::invoke(pred, nano::invoke(proj1, *first1),
+                              nano::invoke(proj2, *first2))) {
+                return false;
+            }
+            ++first1;
+            ++first2;
+        }
+
+        return first1 == last1 && first2 == last2;
+    }
+
+    template <typename I1, typename S1, typename I2, typename Pred,
+              typename Proj1, typename Proj2>
+    static constexpr bool impl3(I1 first1, S1 last1, I2 first2, Pred pred,
+                                Proj1& proj1, Proj2& proj2)
+    {
+        if constexpr (sized_sentinel_for<S1, I1> &&
+                      is_simd_mismatch_candidate<I1, I2, Pred, Proj1, Proj2>) {
+            if (!detail::is_constant_evaluated()) {
+                const auto n = last1 - first1;
+                return n == 0 ||
+                       detail::simd_equal(detail::to_address(first1),
+                                          detail::to_address(first2), n);
+            }
+        }
+
+        while (first1 != last1) {
+            if (!nano::invoke(pred, nano::invoke(proj1, *first1),
+                              nano::invoke(proj2, *first2))) {
+                return false;
+            }
+            ++first1;
+            ++first2;
+        }
+
+        return true;
+    }
+
+public:
+    // Four-legged, sized sentinels
+    template <typename I1, typename S1, typename I2, typename S2,
+              typename Pred = ranges::equal_to, typename Proj1 = identity,
+              typename Proj2 = identity>
+    constexpr std::enable_if_t<
+        input_iterator<I1> && sentinel_for<S1, I1> && input_iterator<I2> &&
+            sentinel_for<S2, I2> &&
+            indirectly_comparable<I1, I2, Pred, Proj1, Proj2> &&
+            sized_sentinel_for<S1, I1> && sized_sentinel_for<S2, I2>,
+        bool>
+    operator()(I1 first1, S1 last1, I2 first2, S2 last2, Pred pred = Pred{},
+               Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
+    {
+        if (last1 - first1 != last2 - first2) {
+            return false;
+        }
+
+        // Ranges are the same size, so call the 3-legged version
+        // and save ourselves a comparison
+        return equal_fn::impl3(std::move(first1), std::move(last1),
+                               std::move(first2), pred,
+                               proj1, proj2);
+    }
+
+    // Four-legged, unsized sentinels
+    template <typename I1, typename S1, typename I2, typename S2,
+              typename Pred = ranges::equal_to, typename Proj1 = identity,
+              typename Proj2 = identity>
+    constexpr std::enable_if_t<
+        input_iterator<I1> && sentinel_for<S1, I1> && input_iterator<I2> &&
+            sentinel_for<S2, I2> &&
+            indirectly_comparable<I1, I2, Pred, Proj1, Proj2> &&
+            !(sized_sentinel_for<S1, I1> && sized_sentinel_for<S2, I2>),
+        bool>
+    operator()(I1 first1, S1 last1, I2 first2, S2 last2, Pred pred = Pred{},
+               Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
+    {
+        return equal_fn::impl4(std::move(first1), std::move(last1),
+                               std::move(first2), std::move(last2),
+                               pred, proj1, proj2);
+    }
+
+    // Three legged
+    template <typename I1, typename S1, typename I2, typename Pred = ranges::equal_to,
+              typename Proj1 = identity, typename Proj2 = identity>
+    NANO_DEPRECATED constexpr std::enable_if_t<
+        input_iterator<I1> && sentinel_for<S1, I1> &&
+            input_iterator<std::decay_t<I2>> &&
+                !input_range<I2> &&
+            indirectly_comparable<I1, std::decay_t<I2>, Pred, Proj1, Proj2>,
+        bool>
+    operator()(I1 first1, S1 last1, I2 first2, Pred pred = Pred{},
+               Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
+    {
+        return equal_fn::impl3(std::move(first1), std::move(last1),
+                               std::forward<I2>(first2), pred, proj1, proj2);
+    }
+
+    // Two ranges, both sized
+    template <typename Rng1, typename Rng2, typename Pred = ranges::equal_to,
+              typename Proj1 = identity, typename Proj2 = identity>
+    constexpr std::enable_if_t<
+        input_range<Rng1> && input_range<Rng2> &&
+            indirectly_comparable<iterator_t<Rng1>, iterator_t<Rng2>, Pred,
+                                 Proj1, Proj2> &&
+            sized_range<Rng1> && sized_range<Rng2>,
+        bool>
+    operator()(Rng1&& rng1, Rng2&& rng2, Pred pred = Pred{},
+               Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
+    {
+        if (nano::distance(rng1) != nano::distance(rng2)) {
+            return false;
+        }
+
+        return detail::simd_range_dispatch<is_simd_mismatch_candidate<
+            range_pointer_t<Rng1>, range_pointer_t<Rng2>, Pred, Proj1, Proj2>>(
+            rng1, rng2,
+            [](auto ptr1, auto n, auto ptr2, auto) {
+                return detail::simd_equal(ptr1, ptr2, n);
+            },
+            [&] {
+                return equal_fn::impl3(nano::begin(rng1), nano::end(rng1),
+                                       nano::begin(rng2), pred, proj1, proj2);
+            });
+    }
+
+    // Two ranges, not both sized
+    template <typename Rng1, typename Rng2, typename Pred = ranges::equal_to,
+              typename Proj1 = identity, typename Proj2 = identity>
+    constexpr std::enable_if_t<
+        input_range<Rng1> && input_range<Rng2> &&
+            indirectly_comparable<iterator_t<Rng1>, iterator_t<Rng2>, Pred,
+                                 Proj1, Proj2> &&
+            !(sized_range<Rng1> && sized_range<Rng2>),
+        bool>
+    operator()(Rng1&& rng1, Rng2&& rng2, Pred pred = Pred{},
+               Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
+    {
+        return equal_fn::impl4(nano::begin(rng1), nano::end(rng1),
+                               nano::begin(rng2), nano::end(rng2),
+                               pred, proj1, proj2);
+    }
+
+    // Range and a half
+    template <typename Rng1, typename I2, typename Pred = ranges::equal_to,
+              typename Proj1 = identity, typename Proj2 = identity>
+    NANO_DEPRECATED constexpr std::enable_if_t<
+        input_range<Rng1> && input_iterator<std::decay_t<I2>> &&
+                !input_range<I2> &&
+            indirectly_comparable<iterator_t<Rng1>, std::decay_t<I2>, Pred, Proj1, Proj2>,
+        bool>
+    operator()(Rng1&& rng1, I2&& first2, Pred pred = Pred{},
+               Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
+    {
+        return equal_fn::impl3(nano::begin(rng1), nano::end(rng1),
+                               std::forward<I2>(first2), pred, proj1, proj2);
+    }
+};
+
+} // namespace detail
+
+NANO_INLINE_VAR(detail::equal_fn, equal)
+
+NANO_END_NAMESPACE
+
+#endif
+
+// nanorange/algorithm/equal_range.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_ALGORITHM_EQUAL_RANGE_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_EQUAL_RANGE_HPP_INCLUDED
+
+
+
+
+
+
+NANO_BEGIN_NAMESPACE
+
+namespace detail {
+
+struct equal_range_fn {
+private:
+    template <typename I, typename S, typename T, typename Comp, typename Proj>
+    static constexpr subrange<I> impl(I first, S last, const T& value,
+                                      Comp& comp, Proj& proj)
+    {
+        // There are usually only a few elements equal to value, so rather
+        // than a second binary search of the whole range, look for the end
+        // of them with an exponential search from the lower bound
+        if constexpr (random_access_iterator<I> && sized_sentinel_for<S, I>) {
+            I lower = lower_bound_fn::impl(std::move(first), last, value, comp,
+                                           proj);
+            I upper = detail::gallop(lower, last, [&](auto&& x) {
+                return !nano::invoke(comp, value, nano::invoke(proj, x));
+            });
+            return {std::move(lower), std::move(upper)};
+        }
+
+        return {lower_bound_fn::impl(first, last, value, comp, proj),
+                upper_bound_fn::impl(first, last, value, comp, proj)};
+    }
+
+public:
+    template <typename I, typename S, typename T, typename Comp = ranges::less,
+              typename Proj = identity>
+    std::enable_if_t<
+        forward_iterator<I> && sentinel_for<S, I> &&
+            indirect_strict_weak_order<Comp, const T*, projected<I, Proj>>,
+    subrange<I>>
+    constexpr operator()(I first, S last, const T& value, Comp comp = Comp{},
+               Proj proj = Proj{}) const
+    {
+        return equal_range_fn::impl(std::move(first), std::move(last),
+                                    value, comp, proj);
+    }
+
+    template <typename Rng, typename T, typename Comp = ranges::less,
+              typename Proj = identity>
+    std::enable_if_t<forward_range<Rng> &&
+                         indirect_strict_weak_order<Comp, const T*, projected<iterator_t<Rng>, Proj>>,
+                     borrowed_subrange_t<Rng>>
+    constexpr operator()(Rng&& rng, const T& value, Comp comp = Comp{},
+                         Proj proj = Proj{}) const
+    {
+        return equal_range_fn::impl(nano::begin(rng), nano::end(rng),
+                                    value, comp, proj);
+    }
+};
+
+}
+
+NANO_INLINE_VAR(detail::equal_range_fn, equal_range)
+
+NANO_END_NAMESPACE
+
+#endif
+
+// nanorange/algorithm/equal_range_batch.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_ALGORITHM_EQUAL_RANGE_BATCH_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_EQUAL_RANGE_BATCH_HPP_INCLUDED
+
+// nanorange/detail/algorithm/batch_search.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_DETAIL_ALGORITHM_BATCH_SEARCH_HPP_INCLUDED
+#define NANORANGE_DETAIL_ALGORITHM_BATCH_SEARCH_HPP_INCLUDED
+
+
+
+
+
+
+#include <array>
+
+NANO_BEGIN_NAMESPACE
+
+namespace detail {
+
+// The batched binary searches take the queries this many at a time, and
+// advance all the searches in a group by one step before moving on to the
+// next step. A search's next probe is prefetched as soon as it is known, and
+// is not needed until the rest of the group has taken its turn, so the cache
+// misses of different searches overlap rather than each waiting on the last.
+constexpr std::ptrdiff_t batch_search_group = 16;
+
+// For each of the count queries starting at q, stores in pos the offset from
+// first of the partition point of [first, first + n) with respect to
+// pred(x, query), where x is a projected element.
+template <typename I, typename Q, typename Pred, typename Proj>
+constexpr void batch_partition_points(I first, iter_difference_t<I> n, Q q,
+                                      std::ptrdiff_t count, Pred& pred,
+                                      Proj& proj, iter_difference_t<I>* pos)
+{
+    for (std::ptrdiff_t k = 0; k < count; ++k) {
+        pos[k] = 0;
+    }
+
+    if (n == 0) {
+        return;
+    }
+
+    // As in partition_point, every search in the group halves its length at
+    // each step whatever the result, so they all take the same number of
+    // steps
+    while (n > 1) {
+        const auto half = n / 2;
+        const auto next_half = (n - half) / 2;
+
+        Q it = q;
+        for (std::ptrdiff_t k = 0; k < count; ++k, ++it) {
+            pos[k] += nano::invoke(pred, nano::invoke(proj, first[pos[k] + half]),
+                                   *it)
+                          ? half : iter_difference_t<I>{0};
+
+            using ref_t = iter_reference_t<I>;
+            if constexpr (std::is_lvalue_reference<ref_t>::value &&
+                          !std::is_volatile<
+                              std::remove_reference_t<ref_t>>::value) {
+                if (!detail::is_constant_evaluated()) {
+                    detail::simd_prefetch(
+                        std::addressof(first[pos[k] + next_half]));
+                }
+            }
+        }
+
+        n -= half;
+    }
+
+    Q it = q;
+    for (std::ptrdiff_t k = 0; k < count; ++k, ++it) {
+        pos[k] += nano::invoke(pred, nano::invoke(proj, first[pos[k]]), *it)
+                      ? 1 : 0;
+    }
+}
+
+// Finds the partition point of [first, first + n) with respect to
+// pred(x, query) for each query in [qfirst, qlast), calling
+// emit(query_iterator, offset) for each in turn, and returns the end of the
+// queries.
+//
+// The partition point is monotonic in the query, so when the queries in a
+// group are sorted, we gallop to the result for the last one, and confine the
+// rest of the group to the part of the haystack before it. If the group also
+// follows on from the previous one, the gallop starts from the previous
+// group's last result. For a sorted batch of many queries, each group then
+// only touches a short stretch of the haystack.
+template <typename I, typename QI, typename QS, typename Pred, typename Comp,
+          typename Proj, typename Emit>
+constexpr QI batch_search(I first, iter_difference_t<I> n, QI qfirst,
+                          QS qlast, Pred& pred, Comp& comp, Proj& proj,
+                          Emit emit)
+{
+    std::array<iter_difference_t<I>, batch_search_group> pos{};
+
+    bool have_prev = false;
+    QI prev_last = qfirst;
+    iter_difference_t<I> prev_pos = 0;
+
+    while (qfirst != qlast) {
+        const QI group_first = qfirst;
+        QI group_last = qfirst;
+        std::ptrdiff_t count = 0;
+        bool sorted = true;
+
+        for (; count < batch_search_group && qfirst != qlast;
+             ++count, ++qfirst) {
+            // Don't branch on this, as it is unpredictable for random queries
+            if (count > 0) {
+                sorted &= !nano::invoke(comp, *qfirst, *group_last);
+            }
+            group_last = qfirst;
+        }
+
+        if (sorted) {
+            const iter_difference_t<I> lo =
+                have_prev && !nano::invoke(comp, *group_first, *prev_last)
+                    ? prev_pos : 0;
+            const auto hi =
+                detail::gallop(first + lo, first + n,
+                               [&](auto&& x) {
+                                   return nano::invoke(
+                                       pred, nano::invoke(proj, x),
+                                       *group_last);
+                               }) -
+                first;
+            pos[count - 1] = hi - lo;
+            detail::batch_partition_points(first + lo, hi - lo, group_first,
+                                           count - 1, pred, proj, pos.data());
+            for (std::ptrdiff_t k = 0; k < count; ++k) {
+                pos[k] += lo;
+            }
+        } else {
+            detail::batch_partition_points(first, n, group_first, count, pred,
+                                           proj, pos.data());
+        }
+
+        QI it = group_first;
+        for (std::ptrdiff_t k = 0; k < count; ++k, ++it) {
+            emit(it, pos[k]);
+        }
+
+        have_prev = true;
+        prev_last = group_last;
+        prev_pos = pos[count - 1];
+    }
+
+    return qfirst;
+}
+
+enum class bound_kind { lower, upper };
+
+// As batch_search, for the lower or upper bound of each query with respect to
+// comp
+template <bound_kind Kind, typename I1, typename I2, typename S2,
+          typename Comp, typename Proj, typename Emit>
+constexpr I2 batch_bound(I1 first1, iter_difference_t<I1> n1, I2 first2,
+                         S2 last2, Comp& comp, Proj& proj, Emit emit)
+{
+    auto pred = [&comp](auto&& x, auto&& val) {
+        if constexpr (Kind == bound_kind::lower) {
+            return nano::invoke(comp, std::forward<decltype(x)>(x),
+                                std::forward<decltype(val)>(val));
+        } else {
+            return !nano::invoke(comp, std::forward<decltype(val)>(val),
+                                 std::forward<decltype(x)>(x));
+        }
+    };
+    return detail::batch_search(std::move(first1), n1, std::move(first2),
+                                std::move(last2), pred, comp, proj,
+                                std::move(emit));
+}
+
+// The implementation of lower_bound_batch and upper_bound_batch
+template <bound_kind Kind>
+struct bound_batch_fn {
+private:
+    template <typename I1, typename I2, typename S2, typename O, typename Comp,
+              typename Proj>
+    static constexpr in_out_result<I2, O>
+    impl(I1 first1, iter_difference_t<I1> n1, I2 first2, S2 last2, O out,
+         Comp& comp, Proj& proj)
+    {
+        auto last = detail::batch_bound<Kind>(
+            first1, n1, std::move(first2), std::move(last2), comp, proj,
+            [&](const I2&, iter_difference_t<I1> pos) {
+                *out = first1 + pos;
+                ++out;
+            });
+        return {std::move(last), std::move(out)};
+    }
+
+public:
+    template <typename I1, typename S1, typename I2, typename S2, typename O,
+              typename Comp = ranges::less, typename Proj = identity>
+    constexpr std::enable_if_t<
+        random_access_iterator<I1> && sized_sentinel_for<S1, I1> &&
+            forward_iterator<I2> && sentinel_for<S2, I2> &&
+            weakly_incrementable<O> && writable<O, const I1&> &&
+            indirect_strict_weak_order<Comp, I2, projected<I1, Proj>>,
+        in_out_result<I2, O>>
+    operator()(I1 first1, S1 last1, I2 first2, S2 last2, O out,
+               Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        const auto n1 = last1 - first1;
+        return bound_batch_fn::impl(std::move(first1), n1, std::move(first2),
+                                    std::move(last2), std::move(out), comp,
+                                    proj);
+    }
+
+    template <typename Rng1, typename Rng2, typename O,
+              typename Comp = ranges::less, typename Proj = identity>
+    constexpr std::enable_if_t<
+        random_access_range<Rng1> && sized_range<Rng1> &&
+            borrowed_range<Rng1> && forward_range<Rng2> &&
+            weakly_incrementable<O> &&
+            writable<O, const iterator_t<Rng1>&> &&
+            indirect_strict_weak_order<Comp, iterator_t<Rng2>,
+                                       projected<iterator_t<Rng1>, Proj>>,
+        in_out_result<borrowed_iterator_t<Rng2>, O>>
+    operator()(Rng1&& rng1, Rng2&& rng2, O out, Comp comp = Comp{},
+               Proj proj = Proj{}) const
+    {
+        return bound_batch_fn::impl(nano::begin(rng1), nano::distance(rng1),
+                                    nano::begin(rng2), nano::end(rng2),
+                                    std::move(out), comp, proj);
+    }
+};
+
+} // namespace detail
+
+NANO_END_NAMESPACE
+
+#endif
+
+
+
+
+NANO_BEGIN_NAMESPACE
+
+// Extension: as lower_bound_batch, but writes
+// equal_range(haystack, value, comp, proj) for each query
+
+template <typename I, typename O>
+using equal_range_batch_result = in_out_result<I, O>;
+
+namespace detail {
+
+struct equal_range_batch_fn {
+private:
+    // The batched search finds the lower bound for each query. The upper
+    // bound is usually close by, in memory which is already in cache, so we
+    // gallop forward to it.
+    template <typename I1, typename I2, typename S2, typename O, typename Comp,
+              typename Proj>
+    static constexpr equal_range_batch_result<I2, O>
+    impl(I1 first1, iter_difference_t<I1> n1, I2 first2, S2 last2, O out,
+         Comp& comp, Proj& proj)
+    {
+        const I1 last1 = first1 + n1;
+        auto last = detail::batch_bound<bound_kind::lower>(
+            first1, n1, std::move(first2), std::move(last2), comp, proj,
+            [&](const I2& it, iter_difference_t<I1> pos) {
+                auto&& value = *it;
+                const I1 lower = first1 + pos;
+                I1 upper = detail::gallop(lower, last1, [&](auto&& x) {
+                    return !nano::invoke(comp, value, nano::invoke(proj, x));
+                });
+                *out = subrange<I1>{lower, std::move(upper)};
+                ++out;
+            });
+        return {std::move(last), std::move(out)};
+    }
+
+public:
+    template <typename I1, typename S1, typename I2, typename S2, typename O,
+              typename Comp = ranges::less, typename Proj = identity>
+    constexpr std::enable_if_t<
+        random_access_iterator<I1> && sized_sentinel_for<S1, I1> &&
+            forward_iterator<I2> && sentinel_for<S2, I2> &&
+            weakly_incrementable<O> && writable<O, subrange<I1>> &&
+            indirect_strict_weak_order<Comp, I2, projected<I1, Proj>>,
+        equal_range_batch_result<I2, O>>
+    operator()(I1 first1, S1 last1, I2 first2, S2 last2, O out,
+               Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        const auto n1 = last1 - first1;
+        return equal_range_batch_fn::impl(std::move(first1), n1,
+                                          std::move(first2), std::move(last2),
+                                          std::move(out), comp, proj);
+    }
+
+    template <typename Rng1, typename Rng2, typename O,
+              typename Comp = ranges::less, typename Proj = identity>
+    constexpr std::enable_if_t<
+        random_access_range<Rng1> && sized_range<Rng1> &&
+            borrowed_range<Rng1> && forward_range<Rng2> &&
+            weakly_incrementable<O> &&
+            writable<O, subrange<iterator_t<Rng1>>> &&
+            indirect_strict_weak_order<Comp, iterator_t<Rng2>,
+                                       projected<iterator_t<Rng1>, Proj>>,
+        equal_range_batch_result<borrowed_iterator_t<Rng2>, O>>
+    operator()(Rng1&& rng1, Rng2&& rng2, O out, Comp comp = Comp{},
+               Proj proj = Proj{}) const
+    {
+        return equal_range_batch_fn::impl(nano::begin(rng1),
+                                          nano::distance(rng1),
+                                          nano::begin(rng2), nano::end(rng2),
+                                          std::move(out), comp, proj);
+    }
+};
+
+} // namespace detail
+
+NANO_INLINE_VAR(detail::equal_range_batch_fn, equal_range_batch)
+
+NANO_END_NAMESPACE
+
+#endif
+
+// nanorange/algorithm/fill.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_ALGORITHM_FILL_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_FILL_HPP_INCLUDED
+
+
+
+NANO_BEGIN_NAMESPACE
+
+namespace detail {
+
+struct fill_fn {
+private:
+    template <typename T, typename O, typename S>
+    static constexpr O impl(O first, S last, const T& value)
+    {
+        while (first != last) {
+            *first = value;
+            ++first;
+        }
+
+        return first;
+    }
+
+public:
+    template <typename T, typename O, typename S>
+    constexpr std::enable_if_t<
+        output_iterator<O, const T&> && sentinel_for<S, O>, O>
+    operator()(O first, S last, const T& value) const
+    {
+        return fill_fn::impl(std::move(first), std::move(last), value);
+    }
+
+    template <typename T, typename Rng>
+    constexpr std::enable_if_t<output_range<Rng, const T&>,
+                               borrowed_iterator_t<Rng>>
+    operator()(Rng&& rng, const T& value) const
+    {
+        return fill_fn::impl(nano::begin(rng), nano::end(rng), value);
+    }
+};
+
+} // namespace detail
+
+NANO_INLINE_VAR(detail::fill_fn, fill)
+
+NANO_END_NAMESPACE
+
+#endif
+
+// nanorange/algorithm/fill_n.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_ALGORITHM_FILL_N_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_FILL_N_HPP_INCLUDED
+
+
+
+NANO_BEGIN_NAMESPACE
+
+namespace detail {
+
+struct fill_n_fn {
+    template <typename T, typename O>
+    constexpr std::enable_if_t<output_iterator<O, const T&>, O>
+    operator()(O first, iter_difference_t<O> n, const T& value) const
+    {
+        for (iter_difference_t<O> i{0}; i < n; ++i, ++first) {
+            *first = value;
+        }
+        return first;
+    }
+};
+
+} // namespace detail
+
+NANO_INLINE_VAR(detail::fill_n_fn, fill_n)
+
+NANO_END_NAMESPACE
+
+#endif
+
+
+// nanorange/algorithm/find_end.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_ALGORITHM_FIND_END_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_FIND_END_HPP_INCLUDED
+
+
+
+
+
+NANO_BEGIN_NAMESPACE
+
+// [ranges.alg.find.end]
+namespace detail {
+
+// TODO: For BiDir iterators, we can be smarter and search backwards
+struct find_end_fn {
+private:
+    template <typename I1, typename S1, typename I2, typename S2,
+              typename Pred, typename Proj1, typename Proj2>
+    static constexpr subrange<I1>
+    impl(I1 first1, S1 last1, I2 first2, S2 last2, Pred& pred, Proj1& proj1,
+         Proj2& proj2)
+    {
+        if (first2 == last2) {
+            auto last_it = nano::next(first1, last1);
+            return {last_it, last_it};
+        }
+
+        auto result = search_fn::impl(std::move(first1), last1, first2, last2, pred, proj1, proj2);
+
+        if (result.empty()) {
+            return result;
+        }
+
+        while (true) {
+            auto new_result = search_fn::impl(next(result.begin()), last1, first2, last2, pred, proj1, proj2);
+            if (new_result.empty()) {
+                return result;
+            } else {
+                result = std::move(new_result);
+            }
+        }
+    }
+
+public:
+    template <typename I1, typename S1, typename I2, typename S2,
+            typename Pred = ranges::equal_to, typename Proj1 = identity,
+            typename Proj2 = identity>
+    constexpr std::enable_if_t<
+        forward_iterator<I1> && sentinel_for<S1, I1> && forward_iterator<I2> &&
+            sentinel_for<S2, I2> &&
+            indirectly_comparable<I1, I2, Pred, Proj1, Proj2>,
+        subrange<I1>>
+    operator()(I1 first1, S1 last1, I2 first2, S2 last2, Pred pred = Pred{},
+               Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
+    {
+        return find_end_fn::impl(std::move(first1), std::move(last1),
+                                 std::move(first2), std::move(last2),
+                                 pred, proj1, proj2);
+    }
+
+    template <typename Rng1, typename Rng2, typename Pred = ranges::equal_to,
+              typename Proj1 = identity, typename Proj2 = identity>
+    constexpr std::enable_if_t<
+        forward_range<Rng1> && forward_range<Rng2> &&
+            indirectly_comparable<iterator_t<Rng1>, iterator_t<Rng2>, Pred, Proj1, Proj2>,
+        borrowed_subrange_t<Rng1>>
+    operator()(Rng1&& rng1, Rng2&& rng2, Pred pred = Pred{},
+               Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
+    {
+        return find_end_fn::impl(nano::begin(rng1), nano::end(rng1),
+                                 nano::begin(rng2), nano::end(rng2),
+                                 pred, proj1, proj2);
+    }
+
+};
+
+}
+
+NANO_INLINE_VAR(detail::find_end_fn, find_end)
+
+NANO_END_NAMESPACE
+
+#endif
+
+// nanorange/algorithm/find_first_of.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_ALGORITHM_FIND_FIRST_OF_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_FIND_FIRST_OF_HPP_INCLUDED
+
+
+
+
+NANO_BEGIN_NAMESPACE
+
+// [range.alg.find.first.of]
+
+namespace detail {
+
+// Whether find_first_of() may look for the needle elements as a set of bytes
+template <typename I1, typename I2, typename Pred, typename Proj1,
+          typename Proj2>
+inline constexpr bool is_simd_find_first_of_candidate =
+    is_simd_iterator<I1> && sizeof(iter_value_t<I1>) == 1 &&
+    (std::is_integral<iter_value_t<I2>>::value ||
+     std::is_same<iter_value_t<I2>, iter_value_t<I1>>::value) &&
+    std::is_same<Pred, ranges::equal_to>::value &&
+    std::is_same<Proj1, identity>::value &&
+    std::is_same<Proj2, identity>::value;
+
+struct find_first_of_fn {
+private:
+    template <typename T, typename I2, typename S2>
+    static const T* simd_impl(const T* first1, const T* last1, I2 first2,
+                              S2 last2)
+    {
+        // Needle values which no T could be equal to are left out
+        simd_byte_set set;
+        for (; first2 != last2; ++first2) {
+            T t;
+            if (detail::simd_narrow(*first2, t)) {
+                unsigned char c;
+                std::memcpy(&c, &t, 1);
+                set.insert(c);
+            }
+        }
+        return detail::simd_find_first_of(first1, last1, set);
+    }
+
+    template <typename I1, typename S1, typename I2, typename S2, typename Pred,
+              typename Proj1, typename Proj2>
+    static constexpr I1 impl(I1 first1, S1 last1, I2 first2, S2 last2,
+                             Pred& pred, Proj1& proj1, Proj2& proj2)
+    {
+        if constexpr (sized_sentinel_for<S1, I1> &&
+                      is_simd_find_first_of_candidate<I1, I2, Pred, Proj1,
+                                                      Proj2>) {
+            if (!detail::is_constant_evaluated()) {
+                const auto n = last1 - first1;
+                if (n == 0) {
+                    return first1;
+                }
+                const auto ptr = detail::to_address(first1);
+                return first1 + (find_first_of_fn::simd_impl(
+                                     ptr, ptr + n, std::move(first2),
+                                     std::move(last2)) -
+                                 ptr);
+            }
+        }
+
+        for (; first1 != last1; ++first1) {
+            for (I2 it = first2; it != last2; ++it) {
+                if (nano::invoke(pred, nano::invoke(proj1, *first1),
+                                 nano::invoke(proj2, *it))) {
+                    return first1;
+                }
+            }
+        }
+
+        return first1;
+    }
+
+public:
+    template <typename I1, typename S1, typename I2, typename S2,
+              typename Proj1 = identity, typename Proj2 = identity,
+              typename Pred = ranges::equal_to>
+    constexpr std::enable_if_t<
+        input_iterator<I1> && sentinel_for<S1, I1> && forward_iterator<I2> &&
+            sentinel_for<S2, I2> &&
+            indirect_relation<Pred, projected<I1, Proj1>, projected<I2, Proj2>>,
+        I1>
+    operator()(I1 first1, S1 last1, I2 first2, S2 last2, Pred pred = Pred{},
+               Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
+    {
+        return find_first_of_fn::impl(std::move(first1), std::move(last1),
+                                      std::move(first2), std::move(last2),
+                                      pred, proj1, proj2);
+    }
+
+    template <typename Rng1, typename Rng2, typename Proj1 = identity,
+              typename Proj2 = identity, typename Pred = ranges::equal_to>
+    constexpr std::enable_if_t<
+        input_range<Rng1> && forward_range<Rng2> &&
+            indirect_relation<Pred, projected<iterator_t<Rng1>, Proj1>,
+                             projected<iterator_t<Rng2>, Proj2>>,
+        borrowed_iterator_t<Rng1>>
+    operator()(Rng1&& rng1, Rng2&& rng2, Pred pred = Pred{},
+               Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
+    {
+        return detail::simd_range_dispatch<is_simd_find_first_of_candidate<
+            range_pointer_t<Rng1>, iterator_t<Rng2>, Pred, Proj1, Proj2>>(
+            rng1,
+            [&](auto ptr, auto n) {
+                return nano::begin(rng1) +
+                       (find_first_of_fn::simd_impl(ptr, ptr + n,
+                                                    nano::begin(rng2),
+                                                    nano::end(rng2)) -
+                        ptr);
+            },
+            [&] {
+                return find_first_of_fn::impl(
+                    nano::begin(rng1), nano::end(rng1), nano::begin(rng2),
+                    nano::end(rng2), pred, proj1, proj2);
+            });
+    }
+};
+
+} // namespace detail
+
+NANO_INLINE_VAR(detail::find_first_of_fn, find_first_of)
+
+NANO_END_NAMESPACE
+
+#endif
+// nanorange/algorithm/for_each.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_ALGORITHM_FOR_EACH_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_FOR_EACH_HPP_INCLUDED
+
+
+// nanorange/detail/execution/parallel_for.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_DETAIL_EXECUTION_PARALLEL_FOR_HPP_INCLUDED
+#define NANORANGE_DETAIL_EXECUTION_PARALLEL_FOR_HPP_INCLUDED
+
+
+
+
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+NANO_BEGIN_NAMESPACE
+
+namespace detail {
+
+// The element-wise parallel algorithms hand out work in chunks of about this
+// many bytes of input, which fit comfortably in a core's private cache
+constexpr std::size_t parallel_chunk_bytes = 1 << 16;
+
+// ...but never fewer than this many elements, so that a task does enough work
+// to pay for its scheduling
+constexpr std::ptrdiff_t parallel_min_chunk_size = 1 << 10;
+
+template <typename T>
+constexpr std::ptrdiff_t parallel_chunk_size =
+    parallel_chunk_bytes / sizeof(T) > std::size_t(parallel_min_chunk_size)
+        ? std::ptrdiff_t(parallel_chunk_bytes / sizeof(T))
+        : parallel_min_chunk_size;
+
+// Whether it is worth splitting n elements into chunks of the given size
+inline bool use_parallel_chunks(std::ptrdiff_t n, std::ptrdiff_t chunk)
+{
+    return n > chunk && task_pool::instance().concurrency() > 1;
+}
+
+// Calls f(i) for each chunk index i in [first, last). The range is split in
+// half recursively, with the upper halves forked onto the pool, so that idle
+// threads steal large blocks of chunks rather than one chunk at a time.
+template <typename F>
+void parallel_for_chunk_indices(task_group& tasks, std::ptrdiff_t first,
+                                std::ptrdiff_t last, F& f)
+{
+    while (last - first > 1) {
+        const std::ptrdiff_t mid = first + (last - first) / 2;
+        tasks.run([&tasks, &f, mid, last] {
+            detail::parallel_for_chunk_indices(tasks, mid, last, f);
+        });
+        last = mid;
+    }
+    f(first);
+}
+
+// Calls f(begin, end) for consecutive subranges [begin, end) of [0, n), each
+// no longer than chunk, in parallel. Exceptions thrown by f are rethrown.
+template <typename F>
+void parallel_for_chunks(std::ptrdiff_t n, std::ptrdiff_t chunk, F f)
+{
+    const std::ptrdiff_t num_chunks = (n + chunk - 1) / chunk;
+    auto run_chunk = [&f, n, chunk](std::ptrdiff_t i) {
+        const std::ptrdiff_t begin = i * chunk;
+        f(begin, n - begin < chunk ? n : begin + chunk);
+    };
+
+    task_group tasks;
+    detail::parallel_for_chunk_indices(tasks, 0, num_chunks, run_chunk);
+    tasks.wait();
+}
+
+// Reduces [0, n) by calling f(begin, end), which must return the reduction
+// of a non-empty subrange as a T, for each chunk in parallel, and then folds
+// the partial results into init from left to right using op
+template <typename T, typename Op, typename F>
+T parallel_reduce_chunks(std::ptrdiff_t n, std::ptrdiff_t chunk, T init,
+                         Op& op, F f)
+{
+    const std::ptrdiff_t num_chunks = (n + chunk - 1) / chunk;
+    std::vector<std::optional<T>> partials(
+        static_cast<std::size_t>(num_chunks));
+
+    detail::parallel_for_chunks(
+        n, chunk, [&partials, &f, chunk](std::ptrdiff_t begin, std::ptrdiff_t end) {
+            partials[static_cast<std::size_t>(begin / chunk)].emplace(
+                f(begin, end));
+        });
+
+    for (auto& p : partials) {
+        init = nano::invoke(op, std::move(init), std::move(*p));
+    }
+    return init;
+}
+
+} // namespace detail
+
+NANO_END_NAMESPACE
+
+#endif
+
+
+
+
+NANO_BEGIN_NAMESPACE
+
+// [range.alg.foreach]
+
+template <typename I, typename F>
+using for_each_result = in_fun_result<I, F>;
+
+namespace detail {
+
+struct for_each_fn {
+private:
+    template <typename I, typename S, typename Proj, typename Fun>
+    static constexpr for_each_result<I, Fun>
+    impl(I first, S last, Fun& fun, Proj& proj)
+    {
+        while (first != last) {
+            nano::invoke(fun, nano::invoke(proj, *first));
+            ++first;
+        }
+        return {first, std::move(fun)};
+    }
+
+    // With a parallel policy, sized random-access ranges are split into
+    // chunks, each of which is processed using its own copy of fun
+    template <typename EP, typename I, typename S, typename Proj, typename Fun>
+    static I impl(EP&&, I first, S last, Fun& fun, Proj& proj)
+    {
+        if constexpr (is_parallel_policy_v<EP> && random_access_iterator<I> &&
+                      sized_sentinel_for<S, I>) {
+            const auto n = static_cast<std::ptrdiff_t>(last - first);
+            constexpr auto chunk = parallel_chunk_size<iter_value_t<I>>;
+            if (detail::use_parallel_chunks(n, chunk)) {
+                detail::parallel_for_chunks(
+                    n, chunk,
+                    [&first, &fun, &proj](std::ptrdiff_t b, std::ptrdiff_t e) {
+                        Fun f = fun;
+                        for_each_fn::impl(first + b, first + e, f, proj);
+                    });
+                return first + n;
+            }
+        }
+        return for_each_fn::impl(std::move(first), std::move(last), fun, proj)
+            .in;
+    }
+
+public:
+    template <typename I, typename S, typename Proj = identity, typename Fun>
+    constexpr std::enable_if_t<
+        input_iterator<I> && sentinel_for<S, I> &&
+            indirect_unary_invocable<Fun, projected<I, Proj>>,
+        for_each_result<I, Fun>>
+    operator()(I first, S last, Fun fun, Proj proj = Proj{}) const
+    {
+        return for_each_fn::impl(std::move(first), std::move(last),
+                                 fun, proj);
+    }
+
+    template <typename Rng, typename Proj = identity, typename Fun>
+    constexpr std::enable_if_t<
+        input_range<Rng> &&
+            indirect_unary_invocable<Fun, projected<iterator_t<Rng>, Proj>>,
+        for_each_result<borrowed_iterator_t<Rng>, Fun>>
+    operator()(Rng&& rng, Fun fun, Proj proj = Proj{}) const
+    {
+        return for_each_fn::impl(nano::begin(rng), nano::end(rng),
+                                 fun, proj);
+    }
+
+    // Extension: as above, but using the given execution policy. As the
+    // function may be copied, only the end iterator is returned.
+    template <typename EP, typename I, typename S, typename Proj = identity,
+              typename Fun>
+    std::enable_if_t<
+        is_execution_policy_v<remove_cvref_t<EP>> && forward_iterator<I> &&
+            sentinel_for<S, I> && copy_constructible<Fun> &&
+            indirect_unary_invocable<Fun, projected<I, Proj>>,
+        I>
+    operator()(EP&& policy, I first, S last, Fun fun, Proj proj = Proj{}) const
+    {
+        return for_each_fn::impl(std::forward<EP>(policy), std::move(first),
+                                 std::move(last), fun, proj);
+    }
+
+    template <typename EP, typename Rng, typename Proj = identity, typename Fun>
+    std::enable_if_t<
+        is_execution_policy_v<remove_cvref_t<EP>> && forward_range<Rng> &&
+            copy_constructible<Fun> &&
+            indirect_unary_invocable<Fun, projected<iterator_t<Rng>, Proj>>,
+        borrowed_iterator_t<Rng>>
+    operator()(EP&& policy, Rng&& rng, Fun fun, Proj proj = Proj{}) const
+    {
+        return for_each_fn::impl(std::forward<EP>(policy), nano::begin(rng),
+                                 nano::end(rng), fun, proj);
+    }
+};
+} // namespace detail
+
+NANO_INLINE_VAR(detail::for_each_fn, for_each)
+
+template <typename I, typename F>
+using for_each_n_result = in_fun_result<I, F>;
+
+namespace detail {
+
+struct for_each_n_fn {
+    template <typename I, typename Proj = identity, typename Fun>
+    constexpr std::enable_if_t<
+        input_iterator<I> &&
+            indirect_unary_invocable<Fun, projected<I, Proj>>,
+        for_each_n_result<I, Fun>>
+    operator()(I first, iter_difference_t<I> n, Fun fun, Proj proj = Proj{}) const
+    {
+        while (n-- > 0) {
+            nano::invoke(fun, nano::invoke(proj, *first));
+            ++first;
+        }
+        return {std::move(first), std::move(fun)};
+    }
+};
+} // namespace detail
+
+NANO_INLINE_VAR(detail::for_each_n_fn, for_each_n)
+
+NANO_END_NAMESPACE
+
+#endif
+
+// nanorange/algorithm/generate.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_ALGORITHM_GENERATE_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_GENERATE_HPP_INCLUDED
+
+
+
+NANO_BEGIN_NAMESPACE
+
+namespace detail {
+
+struct generate_fn {
+private:
+    template <typename O, typename S, typename F>
+    static constexpr O impl(O first, S last, F& gen)
+    {
+        while (first != last) {
+            *first = gen();
+            ++first;
+        }
+
+        return first;
+    }
+
+public:
+    template <typename O, typename S, typename F>
+    constexpr std::enable_if_t<input_or_output_iterator<O> &&
+                                   sentinel_for<S, O> &&
+                                   copy_constructible<F> && invocable<F&> &&
+                                   writable<O, invoke_result_t<F&>>,
+                               O>
+    operator()(O first, S last, F gen) const
+    {
+        return generate_fn::impl(std::move(first), std::move(last), gen);
+    }
+
+    template <typename Rng, typename F>
+    constexpr std::enable_if_t<invocable<F&> &&
+                                   output_range<Rng, invoke_result_t<F&>>,
+                               borrowed_iterator_t<Rng>>
+    operator()(Rng&& rng, F gen) const
+    {
+        return generate_fn::impl(nano::begin(rng), nano::end(rng), gen);
+    }
+};
+
+} // namespace detail
+
+NANO_INLINE_VAR(detail::generate_fn, generate)
+
+NANO_END_NAMESPACE
+
+#endif
+
+// nanorange/algorithm/generate_n.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_ALGORITHM_GENERATE_N_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_GENERATE_N_HPP_INCLUDED
+
+
+
+NANO_BEGIN_NAMESPACE
+
+namespace detail {
+
+struct generate_n_fn {
+    template <typename O, typename F>
+    constexpr std::enable_if_t<input_or_output_iterator<O> && copy_constructible<F> &&
+                                   invocable<F&> &&
+                                   writable<O, invoke_result_t<F&>>,
+                               O>
+    operator()(O first, iter_difference_t<O> n, F gen) const
+    {
+        for (iter_difference_t<O> i{0}; i < n; ++i, ++first) {
+            *first = gen();
+        }
+
+        return first;
+    }
+};
+
+} // namespace detail
+
+NANO_INLINE_VAR(detail::generate_n_fn, generate_n)
+
+NANO_END_NAMESPACE
+
+#endif
+
+// nanorange/algorithm/includes.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_ALGORITHM_INCLUDES_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_INCLUDES_HPP_INCLUDED
+
+
+
+
+NANO_BEGIN_NAMESPACE
+
+namespace detail {
+
+struct includes_fn {
+private:
+    template <typename I1, typename S1, typename I2, typename S2,
+              typename Comp, typename Proj1, typename Proj2>
+     static constexpr bool impl(I1 first1, S1 last1, I2 first2, S2 last2,
+                                Comp& comp, Proj1& proj1, Proj2& proj2)
+    {
+        // With random access, count how many elements of range1 in a row we
+        // skip over so that we can gallop through long runs
+        [[maybe_unused]] std::ptrdiff_t run = 0;
+
+        while (first2 != last2) {
+            // If range1 is done but we still have elements in range2, then
+            // it is not a subset
+            if (first1 == last1)  {
+                return false;
+            }
+
+            // If the current element of r2 is less than the current
+            // element of r1, then it is not in r1 => not a subset
+            if (nano::invoke(comp, nano::invoke(proj2, *first2),
+                             nano::invoke(proj1, *first1))) {
+                return false;
+            }
+
+            // Now we know that that !(r2 < r1). If we also have !(r1 < r2),
+            // then it must be equal, so in range1 -- so move onto the next
+            // element
+            const bool equal = !nano::invoke(comp, nano::invoke(proj1, *first1),
+                                             nano::invoke(proj2, *first2));
+            if (equal) {
+                ++first2;
+            }
+
+            ++first1;
+
+            if constexpr (is_gallop_candidate<I1, S1, I2, S2>) {
+                run = equal ? 0 : run + 1;
+                if (run == gallop_threshold) {
+                    first1 = detail::gallop(first1, last1, [&](auto&& x) {
+                        return nano::invoke(comp, nano::invoke(proj1, x),
+                                            nano::invoke(proj2, *first2));
+                    });
+                    run = 0;
+                }
+            }
+        }
+
+        return true;
+    }
+
+public:
+    template <typename I1, typename S1, typename I2, typename S2,
+              typename Comp = ranges::less, typename Proj1 = identity, typename Proj2 = identity>
+    constexpr std::enable_if_t<
+        input_iterator<I1> && sentinel_for<S1, I1> && input_iterator<I2> &&
+            sentinel_for<S2, I2> &&
+            indirect_strict_weak_order<Comp, projected<I1, Proj1>, projected<I2, Proj2>>,
+        bool>
+    operator()(I1 first1, S1 last1, I2 first2, S2 last2,
+               Comp comp = Comp{}, Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
+    {
+        return includes_fn::impl(std::move(first1), std::move(last1),
+                                 std::move(first2), std::move(last2),
+                                 comp, proj1, proj2);
+    }
+
+    template <typename Rng1, typename Rng2, typename Comp = ranges::less,
+              typename Proj1 = identity, typename Proj2 = identity>
+    constexpr std::enable_if_t<
+        input_range<Rng1> && input_range<Rng2> &&
+            indirect_strict_weak_order<Comp,
+                                projected<iterator_t<Rng1>, Proj1>,
+                                projected<iterator_t<Rng2>, Proj2>>,
+        bool>
+    operator()(Rng1&& rng1, Rng2&& rng2, Comp comp = Comp{},
+               Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
+    {
+        return includes_fn::impl(nano::begin(rng1), nano::end(rng1),
+                                 nano::begin(rng2), nano::end(rng2),
+                                 comp, proj1, proj2);
+    }
+};
+
+}
+
+NANO_INLINE_VAR(detail::includes_fn, includes)
+
+NANO_END_NAMESPACE
+
+#endif
+
+
+// nanorange/algorithm/is_heap.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_ALGORITHM_IS_HEAP_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_IS_HEAP_HPP_INCLUDED
+
+// nanorange/algorithm/is_heap_until.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Uses code from CMCSTL2
+//
+// Copyright Eric Niebler 2014
+// Copyright Casey Carter 2015
+
+#ifndef NANORANGE_ALGORITHM_IS_HEAP_UNTIL_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_IS_HEAP_UNTIL_HPP_INCLUDED
+
+
+
+NANO_BEGIN_NAMESPACE
+
+namespace detail {
+
+struct is_heap_until_fn {
+private:
+    friend struct is_heap_fn;
+
+    template <typename I, typename Comp, typename Proj>
+    static constexpr I impl(I first, const iter_difference_t<I> n, Comp& comp,
+                            Proj& proj)
+    {
+        iter_difference_t<I> p = 0, c = 1;
+
+        I pp = first;
+
+        while (c < n) {
+            I cp = first + c;
+
+            if (nano::invoke(comp, nano::invoke(proj, *pp),
+                             nano::invoke(proj, *cp))) {
+                return cp;
+            }
+
+            ++c;
+            ++cp;
+
+            if (c == n || nano::invoke(comp, nano::invoke(proj, *pp),
+                                       nano::invoke(proj, *cp))) {
+                return cp;
+            }
+
+            ++p;
+            ++pp;
+
+            c = 2 * p + 1;
+        }
+
+        return first + n;
+    }
+
+public:
+    template <typename I, typename S, typename Comp = ranges::less,
+              typename Proj = identity>
+    constexpr std::enable_if_t<
+        random_access_iterator<I> && sentinel_for<S, I> &&
+            indirect_strict_weak_order<Comp, projected<I, Proj>>,
+        I>
+    operator()(I first, S last, Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        auto n = nano::distance(first, last);
+        return is_heap_until_fn::impl(std::move(first), n, comp, proj);
+    }
+
+    template <typename Rng, typename Comp = ranges::less, typename Proj = identity>
+    constexpr std::enable_if_t<
+        random_access_range<Rng> &&
+        indirect_strict_weak_order<Comp, projected<iterator_t<Rng>, Proj>>,
+        borrowed_iterator_t<Rng>>
+    operator()(Rng&& rng, Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        return is_heap_until_fn::impl(nano::begin(rng), nano::distance(rng),
+                                      comp, proj);
+    }
+};
+
+} // namespace detail
+
+NANO_INLINE_VAR(detail::is_heap_until_fn, is_heap_until)
+
+NANO_END_NAMESPACE
+
+#endif
+
+
+NANO_BEGIN_NAMESPACE
+
+namespace detail {
+
+struct is_heap_fn {
+    template <typename I, typename S, typename Comp = ranges::less,
+              typename Proj = identity>
+    std::enable_if_t<random_access_iterator<I> && sentinel_for<S, I> &&
+                         indirect_strict_weak_order<Comp, projected<I, Proj>>,
+                     bool>
+    operator()(I first, S last, Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        const auto n = nano::distance(first, last);
+        return is_heap_until_fn::impl(std::move(first), n, comp, proj) == last;
+    }
+
+    template <typename Rng, typename Comp = ranges::less, typename Proj = identity>
+    std::enable_if_t<
+        random_access_range<Rng> &&
+            indirect_strict_weak_order<Comp, projected<iterator_t<Rng>, Proj>>,
+        bool>
+    operator()(Rng&& rng, Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        return is_heap_until_fn::impl(nano::begin(rng), nano::distance(rng),
+                                      comp, proj) == nano::end(rng);
+    }
+};
+
+} // namespace detail
+
+NANO_INLINE_VAR(detail::is_heap_fn, is_heap)
+
+NANO_END_NAMESPACE
+
+#endif
+
+
+// nanorange/algorithm/is_partitioned.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_ALGORITHM_IS_PARTITIONED_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_IS_PARTITIONED_HPP_INCLUDED
+
+
+
+NANO_BEGIN_NAMESPACE
+
+namespace detail {
+
+struct is_partitioned_fn {
+private:
+    template <typename I, typename S, typename Pred, typename Proj>
+    static constexpr bool impl(I first, S last, Pred& pred, Proj& proj)
+    {
+        first = nano::find_if_not(std::move(first), last, pred, proj);
+        return nano::find_if(std::move(first), last, pred, proj) == last;
+    }
+
+public:
+    template <typename I, typename S, typename Pred, typename Proj = identity>
+    constexpr std::enable_if_t<
+        input_iterator<I> && sentinel_for<S, I> &&
+            indirect_unary_predicate<Pred, projected<I, Proj>>, bool>
+    operator()(I first, S last, Pred pred = Pred{}, Proj proj = Proj{}) const
+    {
+        return is_partitioned_fn::impl(std::move(first), std::move(last),
+                                       pred, proj);
+    }
+
+    template <typename Rng, typename Pred, typename Proj = identity>
+    constexpr std::enable_if_t<
+        input_range<Rng> &&
+            indirect_unary_predicate<Pred, projected<iterator_t<Rng>, Proj>>, bool>
+    operator()(Rng&& rng, Pred pred = Pred{}, Proj proj = Proj{}) const
+    {
+        return is_partitioned_fn::impl(nano::begin(rng), nano::end(rng),
+                                       pred, proj);
+    }
+};
+
+}
+
+NANO_INLINE_VAR(detail::is_partitioned_fn, is_partitioned)
+
+NANO_END_NAMESPACE
+
+#endif
+
+// nanorange/algorithm/is_permutation.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_ALGORITHM_IS_PERMUTATION_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_IS_PERMUTATION_HPP_INCLUDED
+
+
+
+// nanorange/algorithm/mismatch.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_ALGORITHM_MISMATCH_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_MISMATCH_HPP_INCLUDED
+
+
+
+
+
+NANO_BEGIN_NAMESPACE
+
+// [range.mismatch]
+
+template <typename I1, typename I2>
+using mismatch_result = in_in_result<I1, I2>;
+
+namespace detail {
+
+struct mismatch_fn {
+private:
+    friend struct is_permutation_fn;
+
+    template <typename I1, typename S1, typename I2, typename Proj1,
+              typename Proj2, typename Pred>
+    static constexpr mismatch_result<I1, I2>
+    impl3(I1 first1, S1 last1, I2 first2, Pred& pred, Proj1& proj1, Proj2& proj2)
+    {
+        if constexpr (sized_sentinel_for<S1, I1> &&
+                      is_simd_mismatch_candidate<I1, I2, Pred, Proj1, Proj2>) {
+            if (!detail::is_constant_evaluated()) {
+                return mismatch_fn::simd_impl(std::move(first1),
+                                              std::move(first2),
+                                              last1 - first1);
+            }
+        }
+
+        while (first1 != last1 &&
+               nano::invoke(pred, nano::invoke(proj1, *first1),
+                            nano::invoke(proj2, *first2))) {
+            ++first1;
+            ++first2;
+        }
+
+        return {first1, first2};
+    }
+
+    template <typename I1, typename S1, typename I2, typename S2,
+              typename Proj1, typename Proj2, typename Pred>
+    static constexpr mismatch_result<I1, I2>
+    impl4(I1 first1, S1 last1, I2 first2, S2 last2, Pred& pred, Proj1& proj1,
+          Proj2& proj2)
+    {
+        if constexpr (sized_sentinel_for<S1, I1> && sized_sentinel_for<S2, I2> &&
+                      is_simd_mismatch_candidate<I1, I2, Pred, Proj1, Proj2>) {
+            if (!detail::is_constant_evaluated()) {
+                const auto len1 = last1 - first1;
+                const auto len2 = last2 - first2;
+                return mismatch_fn::simd_impl(std::move(first1),
+                                              std::move(first2),
+                                              len1 < len2 ? len1 : len2);
+            }
+        }
+
+        while (first1 != last1 && first2 != last2 &&
+               nano::invoke(pred, nano::invoke(proj1, *first1),
+                            nano::invoke(proj2, *first2))) {
+            ++first1;
+            ++first2;
+        }
+
+        return {first1, first2};
+    }
+
+    // Compares n elements of two contiguous sequences of integers
+    template <typename I1, typename I2>
+    static mismatch_result<I1, I2> simd_impl(I1 first1, I2 first2,
+                                             iter_difference_t<I1> n)
+    {
+        if (n > 0) {
+            const auto i = detail::simd_mismatch(detail::to_address(first1),
+                                                 detail::to_address(first2), n);
+            first1 += i;
+            first2 += i;
+        }
+
+        return {std::move(first1), std::move(first2)};
+    }
+
+    template <typename Rng1, typename Rng2, typename Pred, typename Proj1,
+              typename Proj2>
+    static constexpr mismatch_result<iterator_t<Rng1>, iterator_t<Rng2>>
+    range_impl(Rng1& rng1, Rng2& rng2, Pred& pred, Proj1& proj1, Proj2& proj2)
+    {
+        return detail::simd_range_dispatch<is_simd_mismatch_candidate<
+            range_pointer_t<Rng1>, range_pointer_t<Rng2>, Pred, Proj1, Proj2>>(
+            rng1, rng2,
+            [&](auto ptr1, auto n1, auto ptr2, auto n2)
+                -> mismatch_result<iterator_t<Rng1>, iterator_t<Rng2>> {
+                const auto res =
+                    mismatch_fn::simd_impl(ptr1, ptr2, n1 < n2 ? n1 : n2);
+                return {nano::begin(rng1) + (res.in1 - ptr1),
+                        nano::begin(rng2) + (res.in2 - ptr2)};
+            },
+            [&] {
+                return mismatch_fn::impl4(nano::begin(rng1), nano::end(rng1),
+                                          nano::begin(rng2), nano::end(rng2),
+                                          pred, proj1, proj2);
+            });
+    }
+
+public:
+    // three legged
+    template <typename I1, typename S1, typename I2, typename Proj1 = identity,
+              typename Proj2 = identity, typename Pred = ranges::equal_to>
+    NANO_DEPRECATED constexpr std::enable_if_t<
+        input_iterator<I1> && sentinel_for<S1, I1> &&
+            input_iterator<std::decay_t<I2>> &&
+        !input_range<I1> &&
+            indirect_relation<Pred, projected<I1, Proj1>, projected<std::decay_t<I2>, Proj2>>,
+        mismatch_result<I1, std::decay_t<I2>>>
+    operator()(I1 first1, S1 last1, I2&& first2, Pred pred = Pred{},
+               Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
+    {
+        return mismatch_fn::impl3(std::move(first1), std::move(last1),
+                                  std::forward<I2>(first2), pred,
+                                  proj1, proj2);
+    }
+
+    // range and a half
+    template <typename Rng1, typename I2, typename Proj1 = identity,
+              typename Proj2 = identity, typename Pred = ranges::equal_to>
+    NANO_DEPRECATED constexpr std::enable_if_t<
+        input_range<Rng1> && input_iterator<std::decay_t<I2>> &&
+                !input_range<I2> &&
+            indirect_relation<Pred, projected<iterator_t<Rng1>, Proj1>,
+                             projected<std::decay_t<I2>, Proj2>>,
+        mismatch_result<borrowed_iterator_t<Rng1>, std::decay_t<I2>>>
+    operator()(Rng1&& rng1, I2&& first2, Pred pred = Pred{},
+               Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
+    {
+        return mismatch_fn::impl3(nano::begin(rng1), nano::end(rng1),
+                                  std::forward<I2>(first2), pred,
+                                  proj1, proj2);
+    }
+
+    // four legged
+    template <typename I1, typename S1, typename I2, typename S2,
+              typename Proj1 = identity, typename Proj2 = identity,
+              typename Pred = ranges::equal_to>
+    constexpr std::enable_if_t<
+        input_iterator<I1> && sentinel_for<S1, I1> && input_iterator<I2> &&
+            sentinel_for<S2, I2> &&
+            indirect_relation<Pred, projected<I1, Proj1>, projected<I2, Proj2>>,
+        mismatch_result<I1, I2>>
+    operator()(I1 first1, S1 last1, I2 first2, S2 last2, Pred pred = Pred{},
+               Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
+    {
+        return mismatch_fn::impl4(std::move(first1), std::move(last1),
+                                  std::move(first2), std::move(last2),
+                                  pred, proj1, proj2);
+    }
+
+    // two ranges
+    template <typename Rng1, typename Rng2, typename Proj1 = identity,
+              typename Proj2 = identity, typename Pred = ranges::equal_to>
+    constexpr std::enable_if_t<
+        input_range<Rng1> && input_range<Rng2> &&
+            indirect_relation<Pred, projected<iterator_t<Rng1>, Proj1>,
+                             projected<iterator_t<Rng2>, Proj2>>,
+        mismatch_result<borrowed_iterator_t<Rng1>, borrowed_iterator_t<Rng2>>>
+    operator()(Rng1&& rng1, Rng2&& rng2, Pred pred = Pred{},
+               Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
+    {
+        return mismatch_fn::range_impl(rng1, rng2, pred, proj1, proj2);
+    }
+};
+
+} // namespace detail
+
+NANO_INLINE_VAR(detail::mismatch_fn, mismatch)
+
+NANO_END_NAMESPACE
+
+#endif
+
+
+NANO_BEGIN_NAMESPACE
+
+namespace detail {
+
+struct is_permutation_fn {
+private:
+    template <typename I1, typename S1, typename I2, typename S2, typename Pred,
+              typename Proj1, typename Proj2>
+    static constexpr bool process_tail(I1 first1, S1 last1, I2 first2, S2 last2,
+                                       Pred& pred, Proj1& proj1, Proj2& proj2)
+    {
+        for (auto it = first1; it != last1; ++it) {
+            const auto comp = [&pred, val = nano::invoke(proj1, *it)]
+                    (const auto& t) { return nano::invoke(pred, t, val); };
+
+            // Check whether we have already seen this value
+            if (any_of_fn::impl(first1, it, comp, proj1)) {
+                continue;
+            }
+
+            // Count how many times *it appears in range2
+            const auto count1 = count_if_fn::impl(first2, last2, comp, proj2);
+
+            // If we have a count of zero, we know the ranges are different
+            if (count1 == 0) {
+                return false;
+            }
+
+            // Count how many times *it appears in the remainder of range1
+            // (we can start from one)
+            const auto count2 = iter_difference_t<I1>{1} +
+                count_if_fn::impl(nano::next(it), last1, comp, proj1);
+
+            if (count1 != count2) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    template <typename I1, typename S1, typename I2, typename Pred,
+        typename Proj1, typename Proj2>
+    static constexpr bool impl3(I1 first1, S1 last1, I2 first2,
+                                Pred& pred, Proj1& proj1, Proj2& proj2)
+    {
+        // Strip equal prefixes from both ranges
+        auto result = mismatch_fn::impl3(std::move(first1), last1,
+                                         std::move(first2),
+                                         pred, proj1, proj2);
+        first1 = std::move(result).in1;
+        first2 = std::move(result).in2;
+
+        if (first1 == last1) {
+            return true;
+        }
+
+        // If we have only one value left in range1, it can't be in range2
+        const auto d = nano::distance(first1, last1);
+        if (d == 1) {
+            return false;
+        }
+
+        auto last2 = nano::next(first2, d);
+
+        return is_permutation_fn::process_tail(std::move(first1), std::move(last1),
+                                               std::move(first2), std::move(last2),
+                                               pred, proj1, proj2);
+    }
+
+    template <typename I1, typename S1, typename I2, typename S2,
+              typename Pred, typename Proj1, typename Proj2>
+    static constexpr bool impl4(I1 first1, S1 last1, I2 first2, S2 last2,
+                                Pred& pred, Proj1& proj1, Proj2& proj2)
+    {
+        // Strip equal prefixes from both ranges
+        auto result = mismatch_fn::impl4(std::move(first1), last1,
+                                         std::move(first2), last2,
+                                         pred, proj1, proj2);
+        first1 = std::move(result).in1;
+        first2 = std::move(result).in2;
+
+        // If we have reached the end of both ranges, they were the same
+        if (first1 == last1 && first2 == last2) {
+            return true;
+        }
+
+        // If we have different numbers of elements left in the ranges,
+        // they are not permutations of one another
+        if (nano::distance(first1, last1) != nano::distance(first2, last2)) {
+            return false;
+        }
+
+        return is_permutation_fn::process_tail(std::move(first1), std::move(last1),
+                                               std::move(first2), std::move(last2),
+                                               pred, proj1, proj2);
+    }
+
+public:
+    // Four-legged
+    template <typename I1, typename S1, typename I2, typename S2,
+              typename Pred = ranges::equal_to, typename Proj1 = identity,
+              typename Proj2 = identity>
+    constexpr
+        std::enable_if_t<
+        forward_iterator<I1> && sentinel_for<S1, I1> && forward_iterator<I2> &&
+            sentinel_for<S2, I2> &&
+            indirectly_comparable<I1, I2, Pred, Proj1, Proj2>,
+                         bool>
+    operator()(I1 first1, S1 last1, I2 first2, S2 last2, Pred pred = Pred{},
+               Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
+    {
+        if constexpr (sized_sentinel_for<S1, I1> &&
+                      sized_sentinel_for<S2, I2>) {
+            if (nano::distance(first1, last1) != nano::distance(first2, last2)) {
+                return false;
+            }
+            return is_permutation_fn::impl3(std::move(first1), std::move(last1),
+                                            std::move(first2), pred,
+                                            proj1, proj2);
+        }
+
+        return is_permutation_fn::impl4(std::move(first1), std::move(last1),
+                                        std::move(first2), std::move(last2),
+                                        pred, proj1, proj2);
+    }
+
+    // Three-legged
+    template <typename I1, typename S1, typename I2,
+        typename Pred = ranges::equal_to, typename Proj1 = identity,
+        typename Proj2 = identity>
+    NANO_DEPRECATED
+    constexpr
+    std::enable_if_t<
+        forward_iterator<I1> && sentinel_for<S1, I1> && forward_iterator<I2> &&
+            indirectly_comparable<I1, I2, Pred, Proj1, Proj2>,
+        bool>
+    operator()(I1 first1, S1 last1, I2 first2, Pred pred = Pred{},
+               Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
+    {
+        return is_permutation_fn::impl3(std::move(first1), std::move(last1),
+                                        std::move(first2), pred,
+                                        proj1, proj2);
+
+    }
+
+    // Two ranges
+    template <typename Rng1, typename Rng2, typename Pred = ranges::equal_to,
+              typename Proj1 = identity, typename Proj2 = identity>
+    constexpr std::enable_if_t<
+        forward_range<Rng1> && forward_range<Rng2> &&
+            indirectly_comparable<iterator_t<Rng1>, iterator_t<Rng2>, Pred,
+                                 Proj1, Proj2>,
+        bool>
+    operator()(Rng1&& rng1, Rng2&& rng2, Pred pred = Pred{},
+               Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
+    {
+        if (sized_range<Rng1> && sized_range<Rng2>) {
+            if (nano::distance(rng1) != nano::distance(rng2)) {
+                return false;
+            }
+
+            return is_permutation_fn::impl3(nano::begin(rng1), nano::end(rng1),
+                                            nano::begin(rng2), pred,
+                                            proj1, proj2);
+        }
+
+        return is_permutation_fn::impl4(nano::begin(rng1), nano::end(rng1),
+                                        nano::begin(rng2), nano::end(rng2),
+                                        pred, proj1, proj2);
+    }
+
+    // Range and a half
+    template <typename Rng1, typename I2, typename Pred = ranges::equal_to,
+        typename Proj1 = identity, typename Proj2 = identity>
+    NANO_DEPRECATED
+    constexpr std::enable_if_t<
+        forward_range<Rng1> && forward_iterator<std::decay_t<I2>> &&
+        !range<I2> &&
+            indirectly_comparable<iterator_t<Rng1>, I2, Pred, Proj1, Proj2>,
+        bool>
+    operator()(Rng1&& rng1, I2&& first2, Pred pred = Pred{},
+               Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const {
+        return is_permutation_fn::impl3(nano::begin(rng1), nano::end(rng1),
+                                        std::forward<I2>(first2), pred,
+                                        proj1, proj2);
+    }
+};
+
+} // namespace detail
+
+NANO_INLINE_VAR(detail::is_permutation_fn, is_permutation)
+
+NANO_END_NAMESPACE
+
+#endif
+
+// nanorange/algorithm/is_sorted.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_ALGORITHM_IS_SORTED_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_IS_SORTED_HPP_INCLUDED
+
+// nanorange/algorithm/is_sorted_until.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_ALGORITHM_IS_SORTED_UNTIL_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_IS_SORTED_UNTIL_HPP_INCLUDED
+
+
+
+NANO_BEGIN_NAMESPACE
+
+namespace detail {
+
+struct is_sorted_until_fn {
+private:
+    friend struct is_sorted_fn;
+
+    template <typename I, typename S, typename Comp, typename Proj>
+    static constexpr I impl(I first, S last, Comp& comp, Proj& proj)
+    {
+        if (first == last) {
+            return first;
+        }
+
+        I n = next(first);
+
+        while (n != last) {
+            if (nano::invoke(comp, nano::invoke(proj, *n),
+                              nano::invoke(proj, *first))) {
+                return n;
+            }
+            ++first;
+            ++n;
+        }
+
+        return n;
+    }
+
+public:
+    template <typename I, typename S, typename Comp = ranges::less,
+              typename Proj = identity>
+    constexpr std::enable_if_t<
+        forward_iterator<I> && sentinel_for<S, I> &&
+            indirect_strict_weak_order<Comp, projected<I, Proj>>, I>
+    operator()(I first, S last, Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        return is_sorted_until_fn::impl(std::move(first), std::move(last),
+                                        comp, proj);
+    }
+
+    template <typename Rng, typename Comp = ranges::less, typename Proj = identity>
+    constexpr std::enable_if_t<
+        forward_range<Rng> &&
+            indirect_strict_weak_order<Comp, projected<iterator_t<Rng>, Proj>>,
+        borrowed_iterator_t<Rng>>
+    operator()(Rng&& rng, Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        return is_sorted_until_fn::impl(nano::begin(rng), nano::end(rng),
+                                        comp, proj);
+    }
+};
+
+}
+
+NANO_INLINE_VAR(detail::is_sorted_until_fn, is_sorted_until)
+
+NANO_END_NAMESPACE
+
+#endif
+
+
+NANO_BEGIN_NAMESPACE
+
+namespace detail {
+
+struct is_sorted_fn {
+    template <typename I, typename S, typename Comp = ranges::less,
+            typename Proj = identity>
+    constexpr std::enable_if_t<
+        forward_iterator<I> && sentinel_for<S, I> &&
+            indirect_strict_weak_order<Comp, projected<I, Proj>>, bool>
+    operator()(I first, S last, Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        return is_sorted_until_fn::impl(std::move(first), last,
+                                        comp, proj) == last;
+    }
+
+    template <typename Rng, typename Comp = ranges::less, typename Proj = identity>
+    constexpr std::enable_if_t<
+        forward_range<Rng> &&
+            indirect_strict_weak_order<Comp, projected<iterator_t<Rng>, Proj>>,
+        bool>
+    operator()(Rng&& rng, Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        return is_sorted_until_fn::impl(nano::begin(rng), nano::end(rng),
+                                        comp, proj) == nano::end(rng);
+    }
+};
+
+}
+
+NANO_INLINE_VAR(detail::is_sorted_fn, is_sorted)
+
+NANO_END_NAMESPACE
+
+#endif
+
+
+// nanorange/algorithm/stl/lexicographical_compare.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_ALGORITHM_LEXICOGRAPHICAL_COMPARE_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_LEXICOGRAPHICAL_COMPARE_HPP_INCLUDED
+
+
+
+NANO_BEGIN_NAMESPACE
+
+namespace detail {
+
+struct lexicographical_compare_fn {
+private:
+    template <typename I1, typename S1, typename I2, typename S2,
+              typename Comp, typename Proj1, typename Proj2>
+    static constexpr bool impl(I1 first1, S1 last1, I2 first2, S2 last2,
+                                Comp& comp, Proj1& proj1, Proj2& proj2)
+    {
+        while (first1 != last1 && first2 != last2) {
+            if (nano::invoke(comp, nano::invoke(proj1, *first1),
+                              nano::invoke(proj2, *first2))) {
+                return true;
+            }
+            if (nano::invoke(comp, nano::invoke(proj2, *first2),
+                             nano::invoke(proj1, *first1))) {
+                return false;
+            }
+            ++first1; ++first2;
+        }
+
+        return first1 == last1 && first2 != last2;
+    }
+
+public:
+    template <typename I1, typename S1, typename I2, typename S2,
+              typename Comp = ranges::less, typename Proj1 = identity,
+              typename Proj2 = identity>
+    constexpr std::enable_if_t<
+        input_iterator<I1> && sentinel_for<S1, I1> && input_iterator<I2> &&
+            sentinel_for<S2, I2> &&
+            indirect_strict_weak_order<Comp, projected<I1, Proj1>, projected<I2, Proj2>>,
+        bool>
+    operator()(I1 first1, S1 last1, I2 first2, S2 last2, Comp comp = Comp{},
+               Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
+    {
+        return lexicographical_compare_fn::impl(
+                std::move(first1), std::move(last1),
+                std::move(first2), std::move(last2),
+                comp, proj1, proj2);
+    }
+
+    template <typename Rng1, typename Rng2, typename Comp = ranges::less,
+              typename Proj1 = identity, typename Proj2 = identity>
+    constexpr std::enable_if_t<
+        input_range<Rng1> && input_range<Rng2> &&
+            indirect_strict_weak_order<Comp, projected<iterator_t<Rng1>, Proj1>,
+                                      projected<iterator_t<Rng2>, Proj2>>,
+            bool>
+    operator()(Rng1&& rng1, Rng2&& rng2, Comp comp = Comp{},
+               Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
+    {
+        return lexicographical_compare_fn::impl(
+                nano::begin(rng1), nano::end(rng1),
+                nano::begin(rng2), nano::end(rng2),
+                comp, proj1, proj2);
+    }
+};
+
+}
+
+NANO_INLINE_VAR(detail::lexicographical_compare_fn, lexicographical_compare)
+
+NANO_END_NAMESPACE
+
+#endif
+
+
+// nanorange/algorithm/lower_bound_batch.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_ALGORITHM_LOWER_BOUND_BATCH_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_LOWER_BOUND_BATCH_HPP_INCLUDED
+
+
+
+NANO_BEGIN_NAMESPACE
+
+// Extension: looks up each value in the range of queries in the sorted
+// random-access haystack, writing lower_bound(haystack, value, comp, proj)
+// to the output iterator for each in turn. The searches are run in groups,
+// in lockstep, so that their cache misses overlap; sorted runs of queries
+// are also searched for in successively narrower parts of the haystack.
+
+template <typename I, typename O>
+using lower_bound_batch_result = in_out_result<I, O>;
+
+NANO_INLINE_VAR(detail::bound_batch_fn<detail::bound_kind::lower>,
+                lower_bound_batch)
+
+NANO_END_NAMESPACE
+
+#endif
+
+
+// nanorange/algorithm/max.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_ALGORITHM_MAX_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_MAX_HPP_INCLUDED
+
+
+
+NANO_BEGIN_NAMESPACE
+
+namespace detail {
+
+struct max_fn {
+private:
+    template <typename Rng, typename Comp, typename Proj>
+    static constexpr iter_value_t<iterator_t<Rng>>
+    impl(Rng&& rng, Comp& comp, Proj& proj)
+    {
+        auto first = nano::begin(rng);
+        const auto last = nano::end(rng);
+
+        // Empty ranges not allowed
+        auto result = *first;
+
+        while(++first != last) {
+            auto&& val = *first;
+            if (nano::invoke(comp, nano::invoke(proj, result),
+                              nano::invoke(proj, val))) {
+                result = std::forward<decltype(val)>(val);
+            }
+        }
+
+        return result;
+    }
+
+public:
+    template <typename T, typename Comp = ranges::less, typename Proj = identity>
+    constexpr std::enable_if_t<
+        indirect_strict_weak_order<Comp, projected<const T*, Proj>>,
+    const T&>
+    operator()(const T& a, const T& b, Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        // *sigh*, this should be fixed in STL2
+        return !nano::invoke(comp, nano::invoke(proj, a),
+                            nano::invoke(proj, b)) ? a : b;
+    }
+
+    template <typename T, typename Comp = ranges::less, typename Proj = identity>
+    constexpr std::enable_if_t<
+        copyable<T> &&
+            indirect_strict_weak_order<Comp, projected<const T*, Proj>>,
+            T>
+    operator()(std::initializer_list<T> rng, Comp comp = Comp{},
+               Proj proj = Proj{}) const
+    {
+        return max_fn::impl(rng, comp, proj);
+    }
+
+    template <typename Rng, typename Comp = ranges::less, typename Proj = identity>
+    constexpr std::enable_if_t<
+        input_range<Rng> && copyable<iter_value_t<iterator_t<Rng>>> &&
+            indirect_strict_weak_order<Comp, projected<iterator_t<Rng>, Proj>>,
+    range_value_t<Rng>>
+    operator()(Rng&& rng, Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        return max_fn::impl(std::forward<Rng>(rng), comp, proj);
+    }
+};
+
+}
+
+NANO_INLINE_VAR(detail::max_fn, max)
+
+NANO_END_NAMESPACE
+
+#endif
+
+// nanorange/algorithm/max_element.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_ALGORITHM_MAX_ELEMENT_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_MAX_ELEMENT_HPP_INCLUDED
+
+
+
+NANO_BEGIN_NAMESPACE
+
+namespace detail {
+
+struct max_element_fn {
+    template <typename I, typename S, typename Comp, typename Proj>
+    static constexpr I impl(I first, S last, Comp& comp, Proj& proj)
+    {
+        if (first == last) {
+            return first;
+        }
+
+        I i = nano::next(first);
+        while (i != last) {
+            if (!nano::invoke(comp, nano::invoke(proj, *i),
+                              nano::invoke(proj, *first))) {
+                first = i;
+            }
+            ++i;
+        }
+
+        return first;
+    }
+
+public:
+    template <typename I, typename S, typename Comp = ranges::less,
+            typename Proj = identity>
+    constexpr std::enable_if_t<
+        forward_iterator<I> && sentinel_for<S, I> &&
+            indirect_strict_weak_order<Comp, projected<I, Proj>>, I>
+    operator()(I first, S last, Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        return max_element_fn::impl(std::move(first), std::move(last),
+                                    comp, proj);
+    }
+
+    template <typename Rng, typename Comp = ranges::less, typename Proj = identity>
+    constexpr std::enable_if_t<
+        forward_range<Rng> &&
+            indirect_strict_weak_order<Comp, projected<iterator_t<Rng>, Proj>>,
+        borrowed_iterator_t<Rng>>
+    operator()(Rng&& rng, Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        return max_element_fn::impl(nano::begin(rng), nano::end(rng),
+                                    comp, proj);
+    }
+};
+
+}
+
+NANO_INLINE_VAR(detail::max_element_fn, max_element)
+
+NANO_END_NAMESPACE
+
+#endif
+
+
+
+// nanorange/algorithm/min_element.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_ALGORITHM_MIN_ELEMENT_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_MIN_ELEMENT_HPP_INCLUDED
+
+
+
+NANO_BEGIN_NAMESPACE
+
+namespace detail {
+
+struct min_element_fn {
+private:
+    template <typename I, typename S, typename Comp, typename Proj>
+    static constexpr I impl(I first, S last, Comp& comp, Proj& proj)
+    {
+        if (first == last) {
+            return first;
+        }
+
+        I i = nano::next(first);
+        while (i != last) {
+            if (nano::invoke(comp, nano::invoke(proj, *i),
+                             nano::invoke(proj, *first))) {
+                first = i;
+            }
+            ++i;
+        }
+
+        return first;
+    }
+
+public:
+    template <typename I, typename S, typename Comp = ranges::less,
+              typename Proj = identity>
+    constexpr std::enable_if_t<
+        forward_iterator<I> && sentinel_for<S, I> &&
+            indirect_strict_weak_order<Comp, projected<I, Proj>>, I>
+    operator()(I first, S last, Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        return min_element_fn::impl(std::move(first), std::move(last),
+                                    comp, proj);
+    }
+
+    template <typename Rng, typename Comp = ranges::less, typename Proj = identity>
+    constexpr std::enable_if_t<
+        forward_range<Rng> &&
+            indirect_strict_weak_order<Comp, projected<iterator_t<Rng>, Proj>>,
+        borrowed_iterator_t<Rng>>
+    operator()(Rng&& rng, Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        return min_element_fn::impl(nano::begin(rng), nano::end(rng),
+                                    comp, proj);
+    }
+};
+
+}
+
+NANO_INLINE_VAR(detail::min_element_fn, min_element)
+
+NANO_END_NAMESPACE
+
+#endif
+
+// nanorange/algorithm/minmax.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Uses code from CMCSTL2
+// Copyright Casey Carter 2015
+
+#ifndef NANORANGE_ALGORITHM_MINMAX_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_MINMAX_HPP_INCLUDED
+
+
+
+
+NANO_BEGIN_NAMESPACE
+
+template <typename T>
+using minmax_result = min_max_result<T>;
+
+namespace detail {
+
+struct minmax_fn {
+private:
+    template <typename Rng, typename Comp, typename Proj,
+              typename T = iter_value_t<iterator_t<Rng>>>
+    static constexpr minmax_result<T>
     impl(Rng&& rng, Comp& comp, Proj& proj)
     {
         auto first = nano::begin(rng);
@@ -10265,69 +16439,6 @@ NANO_END_NAMESPACE
 #ifndef NANORANGE_ALGORITHM_NEXT_PERMUTATION_HPP_INCLUDED
 #define NANORANGE_ALGORITHM_NEXT_PERMUTATION_HPP_INCLUDED
 
-// nanorange/algorithm/reverse.hpp
-//
-// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
-// Distributed under the Boost Software License, Version 1.0. (See accompanying
-// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
-
-#ifndef NANORANGE_ALGORITHM_REVERSE_HPP_INCLUDED
-#define NANORANGE_ALGORITHM_REVERSE_HPP_INCLUDED
-
-
-
-NANO_BEGIN_NAMESPACE
-
-namespace detail {
-
-struct reverse_fn {
-private:
-    template <typename I>
-    static constexpr I impl(I first, I last)
-    {
-        I ret = last;
-        while (first != last && first !=  --last) {
-            nano::iter_swap(first, last);
-            ++first;
-        }
-
-        return ret;
-    }
-
-    template <typename I, typename S>
-    static constexpr std::enable_if_t<
-        !same_as<I, S>, I>
-    impl(I first, S bound)
-    {
-        I last = next(first, bound);
-        return reverse_fn::impl(std::move(first), std::move(last));
-    }
-
-public:
-    template <typename I, typename S>
-    constexpr std::enable_if_t<bidirectional_iterator<I> && sentinel_for<S, I>,
-        I>
-    operator()(I first, S last) const
-    {
-        return reverse_fn::impl(std::move(first), std::move(last));
-    }
-
-    template <typename Rng>
-    constexpr std::enable_if_t<bidirectional_range<Rng>,
-                               borrowed_iterator_t<Rng>>
-    operator()(Rng&& rng) const
-    {
-        return reverse_fn::impl(nano::begin(rng), nano::end(rng));
-    }
-};
-
-} // namespace detail
-
-NANO_INLINE_VAR(detail::reverse_fn, reverse)
-
-NANO_END_NAMESPACE
-
-#endif
 
 
 
@@ -10393,387 +16504,88 @@ public:
         bidirectional_range<Rng> && sortable<iterator_t<Rng>, Comp, Proj>,
         next_permutation_result<borrowed_iterator_t<Rng>>>
     operator()(Rng&& rng, Comp comp = Comp{}, Proj proj = Proj{}) const
-    {
-        return next_permutation_fn::impl(nano::begin(rng), nano::end(rng),
-                                         comp, proj);
-    }
-};
-
-}
-
-NANO_INLINE_VAR(detail::next_permutation_fn, next_permutation)
-
-NANO_END_NAMESPACE
-
-#endif
-
-// nanorange/algorithm/none_of.hpp
-//
-// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
-// Distributed under the Boost Software License, Version 1.0. (See accompanying
-// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
-
-#ifndef NANORANGE_ALGORITHM_NONE_OF_HPP_INCLUDED
-#define NANORANGE_ALGORITHM_NONE_OF_HPP_INCLUDED
-
-
-
-NANO_BEGIN_NAMESPACE
-
-// [ranges.alg.none_of]
-
-namespace detail {
-
-struct none_of_fn {
-
-    template <typename I, typename S, typename Proj = identity, typename Pred>
-    constexpr std::enable_if_t<
-        input_iterator<I> && sentinel_for<S, I> &&
-            indirect_unary_predicate<Pred, projected<I, Proj>>,
-        bool>
-    operator()(I first, S last, Pred pred, Proj proj = Proj{}) const
-    {
-        return !any_of_fn::impl(first, last, pred, proj);
-    }
-
-    template <typename Rng, typename Proj = identity, typename Pred>
-    constexpr std::enable_if_t<
-        input_range<Rng> &&
-            indirect_unary_predicate<Pred, projected<iterator_t<Rng>, Proj>>,
-        bool>
-    operator()(Rng&& rng, Pred pred, Proj proj = Proj{}) const
-    {
-        return !any_of_fn::impl(nano::begin(rng), nano::end(rng),
-                                pred, proj);
-    }
-};
-
-} // namespace detail
-
-NANO_INLINE_VAR(detail::none_of_fn, none_of)
-
-NANO_END_NAMESPACE
-
-#endif
-// nanorange/algorithm/nth_element.hpp
-//
-// Copyright (c) 2019 Tristan Brindle (tcbrindle at gmail dot com)
-// Distributed under the Boost Software License, Version 1.0. (See accompanying
-// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
-
-// Uses code from cmcstl2 - A concept-enabled C++ standard library
-//
-//  Copyright Eric Niebler 2014
-//  Copyright Casey Carter 2015
-//
-
-//
-//===----------------------------------------------------------------------===//
-//
-//                     The LLVM Compiler Infrastructure
-//
-// This file is dual licensed under the MIT and the University of Illinois Open
-// Source Licenses. See LICENSE.TXT for details.
-//
-//===----------------------------------------------------------------------===//
-
-#ifndef NANORANGE_ALGORITHM_NTH_ELEMENT_HPP_INCLUDED
-#define NANORANGE_ALGORITHM_NTH_ELEMENT_HPP_INCLUDED
-
-
-
-NANO_BEGIN_NAMESPACE
-
-namespace detail {
-
-struct nth_element_fn {
-private:
-    template <typename I, typename Comp, typename Proj>
-    static constexpr void impl(I first, I nth, I last, Comp& comp, Proj& proj)
-    {
-        constexpr iter_difference_t<I> limit = 7;
-
-        const auto pred = [&comp, &proj] (auto&& t, auto&& u) {
-            return nano::invoke(comp, nano::invoke(proj, std::forward<decltype(t)>(t)),
-                                nano::invoke(proj, std::forward<decltype(u)>(u)));
-        };
-
-        I end = last;
-
-        while (true) {
-            if (nth == end) return;
-
-            iter_difference_t<I> len = end - first;
-
-            switch (len) {
-            case 0:
-            case 1:
-                return;
-            case 2:
-                if (pred(*--end, *first)) iter_swap(first, end);
-                return;
-            case 3:
-            {
-                I m = first;
-                sort3(first, ++m, --end, comp, proj);
-                return;
-            }
-            default: break;
-            }
-            if (len <= limit) {
-                selection_sort(first, end, comp, proj);
-                return;
-            }
-            // Post: len > limit
-
-            I m = first + len / 2;
-            I lm1 = end;
-            unsigned n_swaps = sort3(first, m, --lm1, comp, proj);
-            // Post: *m is median
-
-            // partition [first, m) < *m and *m <= [m, end)
-            //(this inhibits tossing elements equivalent to m around unnecessarily)
-            I i = first;
-            I j = lm1;
-            // j points beyond range to be tested, *lm1 is known to be <= *m
-            // The search going up is known to be guarded but the search coming down isn't.
-            // Prime the downward search with a guard.
-            if (!pred(*i, *m)) {  // if *first == *m
-                // *first == *m, *first doesn't go in first part
-                // manually guard downward moving j against i
-                bool restart = false;
-                while (true) {
-                    if (i == --j) {
-                        // *first == *m, *m <= all other elements
-                        // Parition instead into [first, i) == *first and *first < [i, end)
-                        ++i;  // first + 1
-                        j = end;
-                        if (!pred(*first, *--j)) {  // we need a guard if *first == *(end-1)
-                            while (true) {
-                                if (i == j) {
-                                    return;  // [first, end) all equivalent elements
-                                }
-                                if (pred(*first, *i)) {
-                                    iter_swap(i, j);
-                                    ++n_swaps;
-                                    ++i;
-                                    break;
-                                }
-                                ++i;
-                            }
-                        }
-                        // [first, i) == *first and *first < [j, end) and j == end - 1
-                        if (i == j) return;
-
-                        while (true) {
-                            while (!pred(*first, *i)) { ++i; }
-                            while (pred(*first, *--j)) {}
-                            if (i >= j) break;
-                            iter_swap(i, j);
-                            ++n_swaps;
-                            ++i;
-                        }
-                        // [first, i) == *first and *first < [i, end)
-                        // The first part is sorted,
-                        if (nth < i) return;
-
-                        // nth_element the second part
-                        // nth_element<C>(i, nth, end, comp);
-                        restart = true;
-                        break;
-                    }
-                    if (pred(*j, *m)) {
-                        iter_swap(i, j);
-                        ++n_swaps;
-                        break;  // found guard for downward moving j, now use unguarded partition
-                    }
-                }
-                if (restart) {
-                    first = i;
-                    continue;
-                }
-            }
-            ++i;
-            // j points beyond range to be tested, *lm1 is known to be <= *m
-            // if not yet partitioned...
-            if (i < j) {
-                // known that *(i - 1) < *m
-                while (true) {
-                    // m still guards upward moving i
-                    while (pred(*i, *m)) { ++i; }
-                    // It is now known that a guard exists for downward moving j
-                    while (!pred(*--j, *m)) {}
-                    if (i >= j) break;
-                    iter_swap(i, j);
-                    ++n_swaps;
-                    // It is known that m != j
-                    // If m just moved, follow it
-                    if (m == i) m = j;
-                    ++i;
-                }
-            }
-            // [first, i) < *m and *m <= [i, end)
-            if (i != m && pred(*m, *i)) {
-                iter_swap(i, m);
-                ++n_swaps;
-            }
-            // [first, i) < *i and *i <= [i+1, end)
-            if (nth == i) return;
-
-            if (n_swaps == 0) {
-                // We were given a perfectly partitioned sequence.  Coincidence?
-                if (nth < i) {
-                    // Check for [first, i) already sorted
-                    j = m = first;
-                    while (true) {
-                        if (++j == i) {
-                            // [first, i) sorted
-                            return;
-                        }
-                        if (pred(*j, *m)) {
-                            // not yet sorted, so sort
-                            break;
-                        }
-                        m = j;
-                    }
-                } else {
-                    // Check for [i, end) already sorted
-                    j = m = i;
-                    while (true) {
-                        if (++j == end) {
-                            // [i, end) sorted
-                            return;
-                        }
-                        if (pred(*j, *m)) {
-                            // not yet sorted, so sort
-                            break;
-                        }
-                        m = j;
-                    }
-                }
-            }
-
-            // nth_element on range containing nth
-            if (nth < i) {
-                // nth_element<C>(first, nth, i, comp);
-                end = i;
-            } else {
-                // nth_element<C>(i+1, nth, end, comp);
-                first = ++i;
-            }
-        }
-    }
-
-    template <typename I, typename Comp, typename Proj>
-    static constexpr unsigned sort3(I x, I y, I z, Comp& comp, Proj& proj)
-    {
-        const auto pred = [&comp, &proj] (auto&& t, auto&& u) {
-            return nano::invoke(comp, nano::invoke(proj, std::forward<decltype(t)>(t)),
-                                nano::invoke(proj, std::forward<decltype(u)>(u)));
-        };
-
-        if (!pred(*y, *x)) {      // if x <= y
-            if (!pred(*z, *y)) {  // if y <= z
-                return 0;         // x <= y && y <= z
-            }
-            // x <= y && y > z
-            iter_swap(y, z);      // x <= z && y < z
-            if (pred(*y, *x)) {   // if x > y
-                iter_swap(x, y);  // x < y && y <= z
-                return 2;
-            }
-            return 1;             // x <= y && y < z
-        }
-        if (pred(*z, *y)) {       // x > y, if y > z
-            iter_swap(x, z);      // x < y && y < z
-            return 1;
-        }
-        iter_swap(x, y);          // x > y && y <= z
-        // x < y && x <= z
-        if (pred(*z, *y)) {       // if y > z
-            iter_swap(y, z);      // x <= y && y < z
-            return 2;
-        }
-        return 1;
-    }
-
-    template <typename I, typename Comp, typename Proj>
-    static constexpr void selection_sort(I first, I last, Comp& comp, Proj& proj)
-    {
-        for (I lm1 = prev(last); first != lm1; ++first) {
-            I i = min_element_fn::impl(first, last, comp, proj);
-            if (i != first) {
-                iter_swap(first, i);
-            }
-        }
-    }
-
-public:
-    template <typename I, typename S, typename Comp = ranges::less, typename Proj = identity>
-    std::enable_if_t<random_access_iterator<I> && sentinel_for<S, I> &&
-                         sortable<I, Comp, Proj>, I>
-    constexpr operator()(I first, I nth, S last,
-                         Comp comp = Comp{}, Proj proj = Proj{}) const
-    {
-        const I ilast = nano::next(nth, last);
-        impl(std::move(first), nth, std::move(ilast), comp, proj);
-        return ilast;
-    }
-
-    template <typename Rng, typename Comp = ranges::less, typename Proj = identity>
-    std::enable_if_t<random_access_range<Rng> &&
-                         sortable<iterator_t<Rng>, Comp, Proj>,
-                     borrowed_iterator_t<Rng>>
-    constexpr operator()(Rng&& rng, iterator_t<Rng> nth,
-                         Comp comp = Comp{}, Proj proj = Proj{}) const
-    {
-        const auto last = nano::next(nth, nano::end(rng));
-        impl(nano::begin(rng), std::move(nth), last, comp, proj);
-        return last;
+    {
+        return next_permutation_fn::impl(nano::begin(rng), nano::end(rng),
+                                         comp, proj);
     }
 };
 
 }
 
-NANO_INLINE_VAR(detail::nth_element_fn, nth_element)
+NANO_INLINE_VAR(detail::next_permutation_fn, next_permutation)
 
 NANO_END_NAMESPACE
 
 #endif
 
-// nanorange/algorithm/partial_sort.hpp
+// nanorange/algorithm/none_of.hpp
 //
 // Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
-// Copyright Eric Niebler 2014
-// Copyright Casey Carter 2015
-//
 // Distributed under the Boost Software License, Version 1.0. (See accompanying
 // file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
+#ifndef NANORANGE_ALGORITHM_NONE_OF_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_NONE_OF_HPP_INCLUDED
 
 
-#ifndef NANORANGE_ALGORITHM_PARTIAL_SORT_HPP_INCLUDED
-#define NANORANGE_ALGORITHM_PARTIAL_SORT_HPP_INCLUDED
 
+NANO_BEGIN_NAMESPACE
 
-// nanorange/algorithm/sort_heap.hpp
+// [ranges.alg.none_of]
+
+namespace detail {
+
+struct none_of_fn {
+
+    template <typename I, typename S, typename Proj = identity, typename Pred>
+    constexpr std::enable_if_t<
+        input_iterator<I> && sentinel_for<S, I> &&
+            indirect_unary_predicate<Pred, projected<I, Proj>>,
+        bool>
+    operator()(I first, S last, Pred pred, Proj proj = Proj{}) const
+    {
+        return !any_of_fn::impl(first, last, pred, proj);
+    }
+
+    template <typename Rng, typename Proj = identity, typename Pred>
+    constexpr std::enable_if_t<
+        input_range<Rng> &&
+            indirect_unary_predicate<Pred, projected<iterator_t<Rng>, Proj>>,
+        bool>
+    operator()(Rng&& rng, Pred pred, Proj proj = Proj{}) const
+    {
+        return !any_of_fn::impl(nano::begin(rng), nano::end(rng),
+                                pred, proj);
+    }
+};
+
+} // namespace detail
+
+NANO_INLINE_VAR(detail::none_of_fn, none_of)
+
+NANO_END_NAMESPACE
+
+#endif
+// nanorange/algorithm/nth_element.hpp
 //
-// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Copyright (c) 2019 Tristan Brindle (tcbrindle at gmail dot com)
 // Distributed under the Boost Software License, Version 1.0. (See accompanying
 // file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
-#ifndef NANORANGE_ALGORITHM_SORT_HEAP_HPP_INCLUDED
-#define NANORANGE_ALGORITHM_SORT_HEAP_HPP_INCLUDED
+#ifndef NANORANGE_ALGORITHM_NTH_ELEMENT_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_NTH_ELEMENT_HPP_INCLUDED
 
-// nanorange/algorithm/pop_heap.hpp
+// nanorange/detail/algorithm/pdqselect.hpp
 //
 // Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
 // Distributed under the Boost Software License, Version 1.0. (See accompanying
 // file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
-#ifndef NANORANGE_ALGORITHM_POP_HEAP_HPP_INCLUDED
-#define NANORANGE_ALGORITHM_POP_HEAP_HPP_INCLUDED
+// Selection using the partitioning machinery from pdqsort: like quickselect,
+// but recursing only into the side of each partition which contains nth
 
+#ifndef NANORANGE_DETAIL_ALGORITHM_PDQSELECT_HPP_INCLUDED
+#define NANORANGE_DETAIL_ALGORITHM_PDQSELECT_HPP_INCLUDED
 
 
 
@@ -10781,127 +16593,265 @@ NANO_BEGIN_NAMESPACE
 
 namespace detail {
 
-struct pop_heap_fn {
-private:
-    friend struct sort_heap_fn;
+// Partitions which are not highly unbalanced shrink the range geometrically,
+// while bad partitions may shrink it by as little as one element. Once
+// partitioning has examined this many times the size of the input, a bad
+// partition makes us switch to the median of medians, keeping the total work
+// linear. Random inputs rarely need more than half this budget.
+constexpr int pdqselect_work_factor = 8;
+
+// Rearranges [begin, end) so that *nth is the element which would be there if
+// the range were sorted, with no element before it greater and no element after
+// it less. Uses the median of medians to choose each pivot, guaranteeing O(n)
+// comparisons at the cost of a large constant factor. Used as the fallback for
+// pdqselect_loop().
+template <typename I, typename Comp, typename Proj>
+constexpr void median_of_medians_select(I begin, I nth, I end, Comp& comp,
+                                        Proj& proj)
+{
+    using diff_t = iter_difference_t<I>;
 
-    template <typename I, typename Comp, typename Proj>
-    static constexpr I impl(I first, iter_difference_t<I> n, Comp& comp,
-                            Proj& proj)
-    {
-        if (n > 1) {
-            nano::iter_swap(first, first + (n - 1));
-            detail::sift_down_n(first, n - 1, first, comp, proj);
+    while (true) {
+        diff_t size = end - begin;
+
+        if (size < pdqsort_insertion_sort_threshold) {
+            insertion_sort(begin, end, comp, proj);
+            return;
         }
 
-        return first + n;
-    }
+        // Sort each group of five elements and move its median to the front.
+        I medians = begin;
+        for (I group = begin; end - group >= 5; group += 5) {
+            insertion_sort(group, group + 5, comp, proj);
+            nano::iter_swap(medians, group + 2);
+            ++medians;
+        }
 
-public:
-    template <typename I, typename S, typename Comp = ranges::less,
-              typename Proj = identity>
-    constexpr std::enable_if_t<random_access_iterator<I> && sentinel_for<S, I> &&
-                                   sortable<I, Comp, Proj>, I>
-    operator()(I first, S last, Comp comp = Comp{}, Proj proj = Proj{}) const
-    {
-        const auto n = nano::distance(first, last);
-        return pop_heap_fn::impl(std::move(first), n, comp, proj);
-    }
+        // Use the median of those medians as the pivot. At least three tenths
+        // of the range is no less than it, so partition_right() will find an
+        // element to stop its first scan.
+        I mid = begin + (medians - begin) / 2;
+        detail::median_of_medians_select(begin, mid, medians, comp, proj);
+        nano::iter_swap(begin, mid);
 
-    template <typename Rng, typename Comp = ranges::less, typename Proj = identity>
-    constexpr std::enable_if_t<random_access_range<Rng> &&
-                                   sortable<iterator_t<Rng>, Comp, Proj>,
-                               borrowed_iterator_t<Rng>>
-    operator()(Rng&& rng, Comp comp = Comp{}, Proj proj = Proj{}) const
-    {
-        return pop_heap_fn::impl(nano::begin(rng), nano::distance(rng), comp,
-                                 proj);
+        I pivot_pos = partition_right(begin, end, comp, proj).first;
+        if (pivot_pos == nth) {
+            return;
+        }
+
+        if (nth < pivot_pos) {
+            end = pivot_pos;
+            continue;
+        }
+
+        // Elements equal to the pivot all went to the right, so gather them
+        // next to it; otherwise a run of equal elements would only shrink the
+        // range by one element per pass.
+        I equal_end = pivot_pos + 1;
+        for (I it = equal_end; it != end; ++it) {
+            if (!nano::invoke(comp, nano::invoke(proj, *pivot_pos),
+                              nano::invoke(proj, *it))) {
+                nano::iter_swap(it, equal_end);
+                ++equal_end;
+            }
+        }
+
+        if (nth < equal_end) {
+            return;
+        }
+        begin = equal_end;
     }
-};
+}
 
-} // namespace detail
+// The main selection loop, following pdqsort_loop() closely
+template <bool Branchless, typename I, typename Comp, typename Proj>
+constexpr void pdqselect_loop(I begin, I nth, I end, Comp& comp, Proj& proj)
+{
+    using diff_t = iter_difference_t<I>;
 
-NANO_INLINE_VAR(detail::pop_heap_fn, pop_heap)
+    diff_t work_allowed = (end - begin) * pdqselect_work_factor;
+    bool leftmost = true;
 
-NANO_END_NAMESPACE
+    while (true) {
+        diff_t size = end - begin;
 
-#endif
+        if (size < pdqsort_insertion_sort_threshold) {
+            if (leftmost) {
+                insertion_sort(begin, end, comp, proj);
+            } else {
+                unguarded_insertion_sort(begin, end, comp, proj);
+            }
+            return;
+        }
+
+        // Choose pivot as median of 3 or pseudomedian of 9.
+        diff_t s2 = size / 2;
+        if (size > pdqsort_ninther_threshold) {
+            sort3(begin, begin + s2, end - 1, comp, proj);
+            sort3(begin + 1, begin + (s2 - 1), end - 2, comp, proj);
+            sort3(begin + 2, begin + (s2 + 1), end - 3, comp, proj);
+            sort3(begin + (s2 - 1), begin + s2, begin + (s2 + 1), comp, proj);
+            nano::iter_swap(begin, begin + s2);
+        } else {
+            sort3(begin + s2, begin, end - 1, comp, proj);
+        }
 
+        work_allowed -= size;
 
-NANO_BEGIN_NAMESPACE
+        // As in pdqsort_loop(), if the pivot is equal to *(begin - 1) then
+        // gather the elements equal to it on the left. They are then in their
+        // final positions, so we are done if nth is among them.
+        if (!leftmost && !nano::invoke(comp, nano::invoke(proj, *(begin - 1)),
+                                       nano::invoke(proj, *begin))) {
+            begin = partition_left(begin, end, comp, proj) + 1;
+            if (nth < begin) {
+                return;
+            }
+            continue;
+        }
 
-namespace detail {
+        std::pair<I, bool> part_result =
+            Branchless ? partition_right_branchless(begin, end, comp, proj)
+                       : partition_right(begin, end, comp, proj);
+        I pivot_pos = part_result.first;
+        bool already_partitioned = part_result.second;
 
-struct sort_heap_fn {
-private:
-    template <typename I, typename Comp, typename Proj>
-    static constexpr I impl(I first, iter_difference_t<I> n, Comp& comp,
-                            Proj& proj)
-    {
-        if (n < 2) {
-            return first + n;
+        if (pivot_pos == nth) {
+            return;
         }
 
-        for (auto i = n; i > 1; --i) {
-            pop_heap_fn::impl(first, i, comp, proj);
+        diff_t l_size = pivot_pos - begin;
+        diff_t r_size = end - (pivot_pos + 1);
+        bool highly_unbalanced = l_size < size / 8 || r_size < size / 8;
+
+        // Continue with the partition containing nth
+        if (nth < pivot_pos) {
+            end = pivot_pos;
+            size = l_size;
+        } else {
+            begin = pivot_pos + 1;
+            size = r_size;
+            leftmost = false;
         }
 
-        return first + n;
+        if (highly_unbalanced) {
+            // If we have used up our budget, switch to the median of medians
+            // to guarantee O(n).
+            if (work_allowed <= 0) {
+                detail::median_of_medians_select(std::move(begin),
+                                                 std::move(nth),
+                                                 std::move(end), comp, proj);
+                return;
+            }
+
+            // Otherwise shuffle some elements to break up patterns
+            if (size >= pdqsort_insertion_sort_threshold) {
+                nano::iter_swap(begin, begin + size / 4);
+                nano::iter_swap(end - 1, end - size / 4);
+
+                if (size > pdqsort_ninther_threshold) {
+                    nano::iter_swap(begin + 1, begin + (size / 4 + 1));
+                    nano::iter_swap(begin + 2, begin + (size / 4 + 2));
+                    nano::iter_swap(end - 2, end - (size / 4 + 1));
+                    nano::iter_swap(end - 3, end - (size / 4 + 2));
+                }
+            }
+        } else if (already_partitioned &&
+                   partial_insertion_sort(begin, end, comp, proj)) {
+            // The partition was already sorted
+            return;
+        }
     }
+}
 
-public:
-    template <typename I, typename S, typename Comp = ranges::less,
-              typename Proj = identity>
-    constexpr std::enable_if_t<random_access_iterator<I> && sentinel_for<S, I> &&
-                                   sortable<I, Comp, Proj>, I>
-    operator()(I first, S last, Comp comp = Comp{}, Proj proj = Proj{}) const
+template <typename I, typename Comp, typename Proj,
+          bool Branchless = pdqsort_use_branchless<I, Comp, Proj>>
+constexpr void pdqselect(I begin, I nth, I end, Comp& comp, Proj& proj)
+{
+    if (nth == end) {
+        return;
+    }
+
+    detail::pdqselect_loop<Branchless>(std::move(begin), std::move(nth),
+                                       std::move(end), comp, proj);
+}
+
+} // namespace detail
+
+NANO_END_NAMESPACE
+
+#endif
+
+
+NANO_BEGIN_NAMESPACE
+
+namespace detail {
+
+struct nth_element_fn {
+    template <typename I, typename S, typename Comp = ranges::less, typename Proj = identity>
+    std::enable_if_t<random_access_iterator<I> && sentinel_for<S, I> &&
+                         sortable<I, Comp, Proj>, I>
+    constexpr operator()(I first, I nth, S last,
+                         Comp comp = Comp{}, Proj proj = Proj{}) const
     {
-        const auto n = nano::distance(first, last);
-        return sort_heap_fn::impl(std::move(first), n, comp, proj);
+        const I ilast = nano::next(nth, last);
+        detail::pdqselect(std::move(first), std::move(nth), ilast, comp, proj);
+        return ilast;
     }
 
     template <typename Rng, typename Comp = ranges::less, typename Proj = identity>
-    constexpr std::enable_if_t<random_access_range<Rng> &&
-                                   sortable<iterator_t<Rng>, Comp, Proj>,
-                               borrowed_iterator_t<Rng>>
-    operator()(Rng&& rng, Comp comp = Comp{}, Proj proj = Proj{}) const
+    std::enable_if_t<random_access_range<Rng> &&
+                         sortable<iterator_t<Rng>, Comp, Proj>,
+                     borrowed_iterator_t<Rng>>
+    constexpr operator()(Rng&& rng, iterator_t<Rng> nth,
+                         Comp comp = Comp{}, Proj proj = Proj{}) const
     {
-        return sort_heap_fn::impl(nano::begin(rng), nano::distance(rng), comp,
-                                  proj);
+        const auto last = nano::next(nth, nano::end(rng));
+        detail::pdqselect(nano::begin(rng), std::move(nth), last, comp, proj);
+        return last;
     }
 };
 
-} // namespace detail
+}
 
-NANO_INLINE_VAR(detail::sort_heap_fn, sort_heap)
+NANO_INLINE_VAR(detail::nth_element_fn, nth_element)
 
 NANO_END_NAMESPACE
 
 #endif
 
+// nanorange/algorithm/partial_sort.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Copyright Eric Niebler 2014
+// Copyright Casey Carter 2015
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+
+
+#ifndef NANORANGE_ALGORITHM_PARTIAL_SORT_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_PARTIAL_SORT_HPP_INCLUDED
+
+
 
 NANO_BEGIN_NAMESPACE
 
 namespace detail {
 
 struct partial_sort_fn {
-private:
-    template <typename I, typename S, typename Comp, typename Proj>
-    static constexpr I impl(I first, I middle, S last, Comp& comp, Proj& proj)
-    {
-        nano::make_heap(first, middle, comp, proj);
-        const auto len = nano::distance(first, middle);
-        I i = middle;
-
-        while (i != last) {
-            if (nano::invoke(comp, nano::invoke(proj, *i), nano::invoke(proj, *first))) {
-                nano::iter_swap(i, first);
-                detail::sift_down_n(first, len, first, comp, proj);
-            }
-            ++i;
-        }
-        nano::sort_heap(first, middle, comp, proj);
-        return i;
+private:
+    // Selects the elements which belong in [first, middle) and then sorts
+    // them, taking O(n + k log k) comparisons rather than the O(n log k) of
+    // the classic heap-based algorithm
+    template <typename I, typename S, typename Comp, typename Proj>
+    static constexpr I impl(I first, I middle, S last, Comp& comp, Proj& proj)
+    {
+        I ilast = nano::next(middle, last);
+        detail::pdqselect(first, middle, ilast, comp, proj);
+        detail::pdqsort(std::move(first), std::move(middle), comp, proj);
+        return ilast;
     }
 
 public:
@@ -11342,6 +17292,225 @@ NANO_END_NAMESPACE
 
 #endif
 
+// nanorange/algorithm/radix_sort.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_ALGORITHM_RADIX_SORT_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_RADIX_SORT_HPP_INCLUDED
+
+
+
+
+NANO_BEGIN_NAMESPACE
+
+// Extension: stably sorts a range of trivially copyable values whose
+// projected keys are integers or floating point numbers, in ascending
+// (ranges::less) or descending (ranges::greater) order. Takes O(n) time and
+// O(n) extra space; if the space is not available, falls back to
+// stable_sort().
+
+namespace detail {
+
+struct radix_sort_fn {
+private:
+    template <typename I, typename Comp, typename Proj>
+    static void impl(I first, I last, Comp& comp, Proj& proj)
+    {
+        if (!detail::radix_sort(first, last, comp, proj)) {
+            nano::stable_sort(std::move(first), std::move(last),
+                              std::ref(comp), std::ref(proj));
+        }
+    }
+
+public:
+    template <typename I, typename S, typename Comp = ranges::less,
+              typename Proj = identity>
+    std::enable_if_t<random_access_iterator<I> && sentinel_for<S, I> &&
+                         sortable<I, Comp, Proj> &&
+                         is_radix_sortable<I, Comp, Proj>,
+                     I>
+    operator()(I first, S last, Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        I last_it = nano::next(first, last);
+        radix_sort_fn::impl(std::move(first), last_it, comp, proj);
+        return last_it;
+    }
+
+    template <typename Rng, typename Comp = ranges::less,
+              typename Proj = identity>
+    std::enable_if_t<random_access_range<Rng> &&
+                         sortable<iterator_t<Rng>, Comp, Proj> &&
+                         is_radix_sortable<iterator_t<Rng>, Comp, Proj>,
+                     borrowed_iterator_t<Rng>>
+    operator()(Rng&& rng, Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        iterator_t<Rng> last_it = nano::next(nano::begin(rng), nano::end(rng));
+        radix_sort_fn::impl(nano::begin(rng), last_it, comp, proj);
+        return last_it;
+    }
+};
+
+} // namespace detail
+
+NANO_INLINE_VAR(detail::radix_sort_fn, radix_sort)
+
+NANO_END_NAMESPACE
+
+#endif
+
+// nanorange/algorithm/reduce.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_ALGORITHM_REDUCE_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_REDUCE_HPP_INCLUDED
+
+
+
+
+
+#include <functional>
+
+NANO_BEGIN_NAMESPACE
+
+// Extension: ranges versions of std::reduce() and std::transform_reduce().
+// As with the standard versions, op is assumed to be associative and
+// commutative. When given a parallel execution policy, sized random-access
+// ranges are reduced in chunks on the thread pool, and the partial results are
+// then combined from left to right.
+
+namespace detail {
+
+// Whether init = op(std::move(init), u) is valid
+template <typename Op, typename T, typename U, bool = invocable<Op&, T, U>>
+inline constexpr bool is_reduction_op = false;
+
+template <typename Op, typename T, typename U>
+inline constexpr bool is_reduction_op<Op, T, U, true> =
+    movable<T> && assignable_from<T&, invoke_result_t<Op&, T, U>>;
+
+// Additionally, a parallel reduction must be able to start from a single
+// element, and to combine partial results
+template <typename Op, typename T, typename U>
+inline constexpr bool is_parallel_reduction_op =
+    is_reduction_op<Op, T, U> && is_reduction_op<Op, T, T> &&
+    constructible_from<T, U>;
+
+// Whether [first, last) can be divided into chunks for a parallel algorithm
+template <typename EP, typename I, typename S>
+inline constexpr bool is_parallel_chunkable =
+    is_parallel_policy_v<EP> && random_access_iterator<I> &&
+    sized_sentinel_for<S, I>;
+
+struct reduce_fn {
+private:
+    friend struct transform_reduce_fn;
+
+    template <typename I, typename S, typename T, typename Op, typename Proj>
+    static constexpr T impl(I first, S last, T init, Op& op, Proj& proj)
+    {
+        while (first != last) {
+            init = nano::invoke(op, std::move(init), nano::invoke(proj, *first));
+            ++first;
+        }
+        return init;
+    }
+
+    template <typename EP, typename I, typename S, typename T, typename Op,
+              typename Proj>
+    static T impl(EP&&, I first, S last, T init, Op& op, Proj& proj)
+    {
+        if constexpr (is_parallel_chunkable<EP, I, S>) {
+            const auto n = static_cast<std::ptrdiff_t>(last - first);
+            constexpr auto chunk = parallel_chunk_size<iter_value_t<I>>;
+            if (detail::use_parallel_chunks(n, chunk)) {
+                return detail::parallel_reduce_chunks(
+                    n, chunk, std::move(init), op,
+                    [&first, &op, &proj](std::ptrdiff_t b, std::ptrdiff_t e) {
+                        I it = first + b;
+                        T acc(nano::invoke(proj, *it));
+                        return reduce_fn::impl(++it, first + e, std::move(acc),
+                                               op, proj);
+                    });
+            }
+        }
+        return reduce_fn::impl(std::move(first), std::move(last),
+                               std::move(init), op, proj);
+    }
+
+public:
+    template <typename I, typename S, typename Proj = identity,
+              typename T = iter_value_t<projected<I, Proj>>,
+              typename Op = std::plus<>>
+    constexpr std::enable_if_t<
+        input_iterator<I> && sentinel_for<S, I> &&
+            is_reduction_op<Op, T, iter_reference_t<projected<I, Proj>>>,
+        T>
+    operator()(I first, S last, T init = T{}, Op op = Op{},
+               Proj proj = Proj{}) const
+    {
+        return reduce_fn::impl(std::move(first), std::move(last),
+                               std::move(init), op, proj);
+    }
+
+    template <typename Rng, typename Proj = identity,
+              typename T = iter_value_t<projected<iterator_t<Rng>, Proj>>,
+              typename Op = std::plus<>>
+    constexpr std::enable_if_t<
+        input_range<Rng> &&
+            is_reduction_op<Op, T,
+                            iter_reference_t<projected<iterator_t<Rng>, Proj>>>,
+        T>
+    operator()(Rng&& rng, T init = T{}, Op op = Op{}, Proj proj = Proj{}) const
+    {
+        return reduce_fn::impl(nano::begin(rng), nano::end(rng),
+                               std::move(init), op, proj);
+    }
+
+    template <typename EP, typename I, typename S, typename Proj = identity,
+              typename T = iter_value_t<projected<I, Proj>>,
+              typename Op = std::plus<>>
+    std::enable_if_t<
+        is_execution_policy_v<remove_cvref_t<EP>> && forward_iterator<I> &&
+            sentinel_for<S, I> &&
+            is_parallel_reduction_op<Op, T, iter_reference_t<projected<I, Proj>>>,
+        T>
+    operator()(EP&& policy, I first, S last, T init = T{}, Op op = Op{},
+               Proj proj = Proj{}) const
+    {
+        return reduce_fn::impl(std::forward<EP>(policy), std::move(first),
+                               std::move(last), std::move(init), op, proj);
+    }
+
+    template <typename EP, typename Rng, typename Proj = identity,
+              typename T = iter_value_t<projected<iterator_t<Rng>, Proj>>,
+              typename Op = std::plus<>>
+    std::enable_if_t<
+        is_execution_policy_v<remove_cvref_t<EP>> && forward_range<Rng> &&
+            is_parallel_reduction_op<
+                Op, T, iter_reference_t<projected<iterator_t<Rng>, Proj>>>,
+        T>
+    operator()(EP&& policy, Rng&& rng, T init = T{}, Op op = Op{},
+               Proj proj = Proj{}) const
+    {
+        return reduce_fn::impl(std::forward<EP>(policy), nano::begin(rng),
+                               nano::end(rng), std::move(init), op, proj);
+    }
+};
+
+} // namespace detail
+
+NANO_INLINE_VAR(detail::reduce_fn, reduce)
+
+NANO_END_NAMESPACE
+
+#endif
+
 // nanorange/algorithm/remove.hpp
 //
 // Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
@@ -12025,39 +18194,372 @@ private:
         return ret;
     }
 
-public:
-    template <typename I, typename S, typename O>
-    constexpr std::enable_if_t<forward_iterator<I> && sentinel_for<S, I> &&
-        weakly_incrementable<O> &&
-                                   indirectly_copyable<I, O>,
-        rotate_copy_result<I, O>>
-    operator()(I first, I middle, S last, O result) const
+public:
+    template <typename I, typename S, typename O>
+    constexpr std::enable_if_t<forward_iterator<I> && sentinel_for<S, I> &&
+        weakly_incrementable<O> &&
+                                   indirectly_copyable<I, O>,
+        rotate_copy_result<I, O>>
+    operator()(I first, I middle, S last, O result) const
+    {
+        return rotate_copy_fn::impl(std::move(first), std::move(middle),
+                                    std::move(last), std::move(result));
+    }
+
+    template <typename Rng, typename O>
+    constexpr std::enable_if_t<forward_range<Rng> &&
+        weakly_incrementable<O> &&
+                                   indirectly_copyable<iterator_t<Rng>, O>,
+        rotate_copy_result<borrowed_iterator_t<Rng>, O>>
+    operator()(Rng&& rng, iterator_t<Rng> middle, O result) const
+    {
+        return rotate_copy_fn::impl(nano::begin(rng), std::move(middle),
+                                    nano::end(rng), std::move(result));
+    }
+};
+
+} // namespace detail
+
+NANO_INLINE_VAR(detail::rotate_copy_fn, rotate_copy)
+
+NANO_END_NAMESPACE
+
+#endif
+
+
+// nanorange/algorithm/search_any.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_ALGORITHM_SEARCH_ANY_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_SEARCH_ANY_HPP_INCLUDED
+
+
+
+
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+NANO_BEGIN_NAMESPACE
+
+// Extension: multi-pattern search. An aho_corasick_searcher<T> compiles a set
+// of patterns, each a range of T, into an Aho-Corasick automaton. search_any()
+// then runs the automaton over a haystack, writing a search_any_match to the
+// output iterator for every occurrence of every pattern (including
+// overlapping ones) in a single pass. Each element of the haystack costs one
+// table lookup however many patterns there are, plus the cost of reporting
+// any matches which end there.
+//
+// The haystack need only be an input range, as it is never rewound, so
+// matches are reported as offsets from its start. Matches are reported in
+// order of their end position; matches ending at the same position are
+// reported longest first, and then in the order of the patterns. Elements
+// are compared using std::hash<T> and operator==, except that one-byte
+// integral and enumeration types use a flat 256-entry table. Empty patterns
+// never match.
+
+struct search_any_match {
+    // Index of the pattern in the range passed to the searcher
+    std::size_t pattern;
+    // Offset of the start of the match from the start of the haystack
+    std::ptrdiff_t offset;
+    std::ptrdiff_t length;
+
+    friend constexpr bool operator==(const search_any_match& lhs,
+                                     const search_any_match& rhs)
+    {
+        return lhs.pattern == rhs.pattern && lhs.offset == rhs.offset &&
+               lhs.length == rhs.length;
+    }
+
+    friend constexpr bool operator!=(const search_any_match& lhs,
+                                     const search_any_match& rhs)
+    {
+        return !(lhs == rhs);
+    }
+};
+
+template <typename I, typename O>
+using search_any_result = in_out_result<I, O>;
+
+namespace detail {
+
+struct search_any_fn;
+
+// Maps each element value which occurs in some pattern to a distinct column
+// of the transition table. All other values map to column zero.
+template <typename T, bool = is_byte_like<T>>
+struct aho_corasick_alphabet {
+    std::uint32_t insert(const T& t)
+    {
+        return map_.try_emplace(t, static_cast<std::uint32_t>(map_.size() + 1))
+            .first->second;
+    }
+
+    std::uint32_t operator[](const T& t) const
+    {
+        const auto it = map_.find(t);
+        return it == map_.end() ? 0 : it->second;
+    }
+
+    std::uint32_t size() const
+    {
+        return static_cast<std::uint32_t>(map_.size() + 1);
+    }
+
+private:
+    std::unordered_map<T, std::uint32_t> map_{};
+};
+
+template <typename T>
+struct aho_corasick_alphabet<T, true> {
+    std::uint32_t insert(const T& t)
+    {
+        auto& col = columns_[static_cast<unsigned char>(t)];
+        if (col == 0) {
+            col = size_++;
+        }
+        return col;
+    }
+
+    std::uint32_t operator[](const T& t) const
+    {
+        return columns_[static_cast<unsigned char>(t)];
+    }
+
+    std::uint32_t size() const { return size_; }
+
+private:
+    std::array<std::uint32_t, 256> columns_{};
+    std::uint32_t size_ = 1;
+};
+
+} // namespace detail
+
+template <typename T>
+class aho_corasick_searcher {
+    using state_t = std::uint32_t;
+
+    static constexpr std::size_t no_pattern = std::size_t(-1);
+    static constexpr state_t report_tag = state_t(1) << 31;
+
+public:
+    template <typename Rng, typename Proj = identity,
+              std::enable_if_t<
+                  forward_range<Rng> && forward_range<range_reference_t<Rng>> &&
+                      same_as<iter_value_t<projected<
+                                  iterator_t<range_reference_t<Rng>>, Proj>>,
+                              T>,
+                  int> = 0>
+    explicit aho_corasick_searcher(Rng&& patterns, Proj proj = Proj{})
+    {
+        // Number the element values first, so that the trie can be built
+        // directly into a transition table of the right width
+        for (auto&& pattern : patterns) {
+            for (auto&& elem : pattern) {
+                alphabet_.insert(nano::invoke(proj, elem));
+            }
+        }
+        width_ = alphabet_.size();
+
+        // Build the trie. A zero entry in the table means "no child", as the
+        // root is never anyone's child.
+        add_state();
+        std::vector<state_t> pattern_end;
+        for (auto&& pattern : patterns) {
+            state_t s = 0;
+            std::ptrdiff_t len = 0;
+            for (auto&& elem : pattern) {
+                const auto col = alphabet_[nano::invoke(proj, elem)];
+                state_t t = next_[s * width_ + col];
+                if (t == 0) {
+                    t = add_state();
+                    next_[s * width_ + col] = t;
+                }
+                s = t;
+                ++len;
+            }
+            pattern_end.push_back(s);
+            lengths_.push_back(len);
+        }
+
+        // Renumber the states in breadth-first order. Most of the time is
+        // spent in the shallowest states, which then share as few cache lines
+        // as possible, and each state's failure state comes before it.
+        const std::size_t num_states = fail_.size();
+        std::vector<state_t> order{0};
+        order.reserve(num_states);
+        for (std::size_t i = 0; i < order.size(); ++i) {
+            for (std::size_t col = 0; col < width_; ++col) {
+                if (const state_t t = next_[order[i] * width_ + col]; t != 0) {
+                    order.push_back(t);
+                }
+            }
+        }
+
+        std::vector<state_t> new_id(num_states);
+        for (std::size_t i = 0; i < num_states; ++i) {
+            new_id[order[i]] = static_cast<state_t>(i);
+        }
+        std::vector<state_t> next(next_.size());
+        for (std::size_t i = 0; i < num_states; ++i) {
+            for (std::size_t col = 0; col < width_; ++col) {
+                next[i * width_ + col] = new_id[next_[order[i] * width_ + col]];
+            }
+        }
+        next_ = std::move(next);
+
+        // Chain together the patterns ending at each state, in order. Empty
+        // patterns end at the root, which is never reported.
+        next_same_.resize(pattern_end.size(), no_pattern);
+        for (std::size_t p = pattern_end.size(); p-- > 0;) {
+            if (const state_t s = new_id[pattern_end[p]]; s != 0) {
+                next_same_[p] = first_pattern_[s];
+                first_pattern_[s] = p;
+            }
+        }
+
+        // Compute the failure links, and at the same time turn the trie into
+        // a DFA by replacing each missing transition with the transition from
+        // the failure state. The root's children fail to the root, and its
+        // missing transitions already lead there.
+        for (std::size_t s = 1; s < num_states; ++s) {
+            const state_t f = fail_[s];
+            report_[s] = first_pattern_[s] != no_pattern ? static_cast<state_t>(s)
+                                                         : report_[f];
+
+            for (std::size_t col = 0; col < width_; ++col) {
+                state_t& t = next_[s * width_ + col];
+                if (t != 0) {
+                    fail_[t] = next_[f * width_ + col];
+                } else {
+                    t = next_[f * width_ + col];
+                }
+            }
+        }
+
+        // Finally, replace each transition with the offset of the target's
+        // row, tagged if there are matches to report there, so that the scan
+        // only needs a single load per element
+        for (auto& t : next_) {
+            t = static_cast<state_t>(t * width_) |
+                (report_[t] != 0 ? report_tag : 0);
+        }
+    }
+
+    // The number of patterns, including any empty ones
+    std::size_t size() const noexcept { return lengths_.size(); }
+
+private:
+    friend struct detail::search_any_fn;
+
+    state_t add_state()
+    {
+        if (next_.size() + width_ > report_tag) {
+            throw std::length_error(
+                "nano::aho_corasick_searcher: too many states");
+        }
+        const auto s = static_cast<state_t>(fail_.size());
+        next_.resize(next_.size() + width_, 0);
+        fail_.push_back(0);
+        report_.push_back(0);
+        first_pattern_.push_back(no_pattern);
+        return s;
+    }
+
+    template <typename I, typename S, typename O, typename Proj>
+    search_any_result<I, O> run(I first, S last, O out, Proj& proj) const
+    {
+        state_t t = 0;
+        std::ptrdiff_t pos = 0;
+
+        for (; first != last; ++first) {
+            t = next_[(t & ~report_tag) + alphabet_[nano::invoke(proj, *first)]];
+            ++pos;
+            if ((t & report_tag) == 0) {
+                continue;
+            }
+
+            // Walk the chain of states for the pattern suffixes ending here
+            const state_t s = (t & ~report_tag) / width_;
+            for (state_t r = report_[s]; r != 0; r = report_[fail_[r]]) {
+                for (auto p = first_pattern_[r]; p != no_pattern;
+                     p = next_same_[p]) {
+                    *out = search_any_match{p, pos - lengths_[p], lengths_[p]};
+                    ++out;
+                }
+            }
+        }
+
+        return {std::move(first), std::move(out)};
+    }
+
+    detail::aho_corasick_alphabet<T> alphabet_{};
+    std::size_t width_ = 0;
+    // Row-major transitions, width_ entries per state. Once construction is
+    // complete, each entry holds the offset of the target state's row, tagged
+    // with report_tag if some pattern ends there.
+    std::vector<state_t> next_{};
+    std::vector<state_t> fail_{};
+    // The nearest state (the state itself, or one on its chain of failure
+    // links) at which some pattern ends, or zero if there is none
+    std::vector<state_t> report_{};
+    std::vector<std::size_t> first_pattern_{};
+    std::vector<std::size_t> next_same_{};
+    std::vector<std::ptrdiff_t> lengths_{};
+};
+
+template <typename Rng, typename Proj = identity,
+          std::enable_if_t<forward_range<Rng> &&
+                               forward_range<range_reference_t<Rng>>, int> = 0>
+aho_corasick_searcher(Rng&&, Proj = Proj{})
+    -> aho_corasick_searcher<
+        iter_value_t<projected<iterator_t<range_reference_t<Rng>>, Proj>>>;
+
+namespace detail {
+
+struct search_any_fn {
+    template <typename I, typename S, typename T, typename O,
+              typename Proj = identity>
+    std::enable_if_t<input_iterator<I> && sentinel_for<S, I> &&
+                         weakly_incrementable<O> &&
+                         writable<O, const search_any_match&> &&
+                         same_as<iter_value_t<projected<I, Proj>>, T>,
+                     search_any_result<I, O>>
+    operator()(I first, S last, const aho_corasick_searcher<T>& searcher,
+               O out, Proj proj = Proj{}) const
     {
-        return rotate_copy_fn::impl(std::move(first), std::move(middle),
-                                    std::move(last), std::move(result));
+        return searcher.run(std::move(first), std::move(last), std::move(out),
+                            proj);
     }
 
-    template <typename Rng, typename O>
-    constexpr std::enable_if_t<forward_range<Rng> &&
-        weakly_incrementable<O> &&
-                                   indirectly_copyable<iterator_t<Rng>, O>,
-        rotate_copy_result<borrowed_iterator_t<Rng>, O>>
-    operator()(Rng&& rng, iterator_t<Rng> middle, O result) const
+    template <typename Rng, typename T, typename O, typename Proj = identity>
+    std::enable_if_t<
+        input_range<Rng> && weakly_incrementable<O> &&
+            writable<O, const search_any_match&> &&
+            same_as<iter_value_t<projected<iterator_t<Rng>, Proj>>, T>,
+        search_any_result<borrowed_iterator_t<Rng>, O>>
+    operator()(Rng&& rng, const aho_corasick_searcher<T>& searcher, O out,
+               Proj proj = Proj{}) const
     {
-        return rotate_copy_fn::impl(nano::begin(rng), std::move(middle),
-                                    nano::end(rng), std::move(result));
+        return searcher.run(nano::begin(rng), nano::end(rng), std::move(out),
+                            proj);
     }
 };
 
 } // namespace detail
 
-NANO_INLINE_VAR(detail::rotate_copy_fn, rotate_copy)
+NANO_INLINE_VAR(detail::search_any_fn, search_any)
 
 NANO_END_NAMESPACE
 
 #endif
 
-
 // nanorange/algorithm/search_n.hpp
 //
 // Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
@@ -12070,22 +18572,73 @@ NANO_END_NAMESPACE
 
 
 
-NANO_BEGIN_NAMESPACE
 
+NANO_BEGIN_NAMESPACE
 
 namespace detail {
 
+template <typename I, typename T, typename Pred, typename Proj>
+inline constexpr bool is_simd_search_n_candidate =
+    is_simd_find_candidate<I, T, Proj> &&
+    std::is_same<Pred, ranges::equal_to>::value;
+
 struct search_n_fn {
 private:
+    // With random access, we can check the last element of each candidate
+    // window first. If it doesn't match, no window containing it can either,
+    // so the next candidate starts just after it: when matches are rare, we
+    // only look at about one element in every count.
+    template <typename I, typename T, typename Pred, typename Proj>
+    static constexpr subrange<I>
+    random_access_impl(I first, iter_difference_t<I> n,
+                       iter_difference_t<I> count, const T& value, Pred& pred,
+                       Proj& proj)
+    {
+        // [start, checked) is known to match
+        iter_difference_t<I> start = 0;
+        iter_difference_t<I> checked = 0;
+
+        while (n - start >= count) {
+            iter_difference_t<I> i = start + count - 1;
+            while (i >= checked &&
+                   nano::invoke(pred, nano::invoke(proj, first[i]), value)) {
+                --i;
+            }
+
+            if (i < checked) {
+                return {first + start, first + (start + count)};
+            }
+
+            checked = start + count;
+            start = i + 1;
+        }
+
+        return {first + n, first + n};
+    }
+
     template <typename I, typename S, typename T, typename Pred, typename Proj>
     static constexpr subrange<I>
     impl(I first, S last, iter_difference_t<I> count, const T& value, Pred pred,
          Proj& proj)
     {
-        if (count == iter_difference_t<I>{0}) {
+        if (count <= iter_difference_t<I>{0}) {
             return {first, first};
         }
 
+        if constexpr (random_access_iterator<I> && sized_sentinel_for<S, I>) {
+            const auto n = last - first;
+            if constexpr (is_simd_search_n_candidate<I, T, Pred, Proj>) {
+                if (!detail::is_constant_evaluated() && n > 0) {
+                    const auto ptr = detail::to_address(first);
+                    const auto pos =
+                        detail::simd_search_n(ptr, ptr + n, count, value) - ptr;
+                    return {first + pos, first + (pos == n ? n : pos + count)};
+                }
+            }
+            return search_n_fn::random_access_impl(std::move(first), n, count,
+                                                   value, pred, proj);
+        }
+
         for (; first != last; ++first) {
             if (!nano::invoke(pred, nano::invoke(proj, *first), value)) {
                 continue;
@@ -12138,8 +18691,23 @@ public:
                 indirectly_comparable<iterator_t<Rng>, const T*, Pred, Proj>,
             borrowed_subrange_t<Rng>>
     {
-        return search_n_fn::impl(nano::begin(rng), nano::end(rng), count, value, pred,
-                                 proj);
+        using I = iterator_t<Rng>;
+        return detail::simd_range_dispatch<
+            is_simd_search_n_candidate<range_pointer_t<Rng>, T, Pred, Proj>>(
+            rng,
+            [&](auto ptr, auto n) -> subrange<I> {
+                if (count <= iter_difference_t<I>{0}) {
+                    return {nano::begin(rng), nano::begin(rng)};
+                }
+                const auto pos =
+                    detail::simd_search_n(ptr, ptr + n, count, value) - ptr;
+                return {nano::begin(rng) + pos,
+                        nano::begin(rng) + (pos == n ? n : pos + count)};
+            },
+            [&] {
+                return search_n_fn::impl(nano::begin(rng), nano::end(rng),
+                                         count, value, pred, proj);
+            });
     }
 };
 
@@ -12165,6 +18733,8 @@ NANO_END_NAMESPACE
 
 
 
+
+
 NANO_BEGIN_NAMESPACE
 
 template <typename I, typename O>
@@ -12180,6 +18750,18 @@ private:
     impl(I1 first1, S1 last1, I2 first2, S2 last2, O result,
          Comp& comp, Proj1& proj1, Proj2& proj2)
     {
+        // For sorted integers, the vectorised kernel does as much of the work
+        // as it can
+        detail::simd_set_prefix<Comp, Proj1, Proj2>(
+            first1, last1, first2, last2, result, [](auto... args) {
+                return detail::simd_set_match<false>(std::move(args)...);
+            });
+
+        // With random access, count how many elements in a row we take from
+        // each range so that we can gallop through long runs
+        [[maybe_unused]] std::ptrdiff_t run1 = 0;
+        [[maybe_unused]] std::ptrdiff_t run2 = 0;
+
         while (first1 != last1) {
             if (first2 == last2) {
                 // We've reached the end of range2, so copy all the remaining
@@ -12199,14 +18781,44 @@ private:
                 *result = *first1;
                 ++first1;
                 ++result;
+
+                if constexpr (is_gallop_candidate<I1, S1, I2, S2>) {
+                    run2 = 0;
+                    if (++run1 == gallop_threshold) {
+                        // Copy the rest of the elements of r1 which are less
+                        // than this element of r2 in one go
+                        const I1 mid1 = detail::gallop(first1, last1, [&](auto&& x) {
+                            return nano::invoke(comp, nano::invoke(proj1, x),
+                                                nano::invoke(proj2, *first2));
+                        });
+                        result = nano::copy(first1, mid1, std::move(result)).out;
+                        first1 = mid1;
+                        run1 = 0;
+                    }
+                }
             } else{
                 // We now know that !(r1 < r2). If !(r2 < r1) as well, then
                 // elements are equal and we can skip
-                if (!nano::invoke(comp, nano::invoke(proj2, *first2),
-                                  nano::invoke(proj1, *first1))) {
+                const bool equal = !nano::invoke(comp, nano::invoke(proj2, *first2),
+                                                 nano::invoke(proj1, *first1));
+                if (equal) {
                     ++first1;
                 }
                 ++first2;
+
+                if constexpr (is_gallop_candidate<I1, S1, I2, S2>) {
+                    run1 = 0;
+                    run2 = equal ? 0 : run2 + 1;
+                    if (run2 == gallop_threshold) {
+                        // Likewise, skip the rest of the elements of r2 which
+                        // are less than this element of r1
+                        first2 = detail::gallop(first2, last2, [&](auto&& y) {
+                            return nano::invoke(comp, nano::invoke(proj2, y),
+                                                nano::invoke(proj1, *first1));
+                        });
+                        run2 = 0;
+                    }
+                }
             }
         }
 
@@ -12228,76 +18840,389 @@ public:
     operator()(I1 first1, S1 last1, I2 first2, S2 last2, O result,
                Comp comp = Comp{}, Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
     {
-        return set_difference_fn::impl(std::move(first1), std::move(last1),
-                                       std::move(first2), std::move(last2),
-                                       std::move(result), comp,
-                                       proj1, proj2);
+        return set_difference_fn::impl(std::move(first1), std::move(last1),
+                                       std::move(first2), std::move(last2),
+                                       std::move(result), comp,
+                                       proj1, proj2);
+    }
+
+    template <typename Rng1, typename Rng2, typename O, typename Comp = ranges::less,
+              typename Proj1 = identity, typename Proj2 = identity>
+    constexpr std::enable_if_t<input_range<Rng1> &&
+        input_range<Rng2> &&
+        weakly_incrementable<O> &&
+        mergeable<iterator_t<Rng1>, iterator_t<Rng2>, O, Comp, Proj1, Proj2>,
+        set_difference_result<borrowed_iterator_t<Rng1>, O>>
+    operator()(Rng1&& rng1, Rng2&& rng2, O result, Comp comp = Comp{},
+               Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
+    {
+        return detail::simd_set_dispatch<Comp, Proj1, Proj2>(
+            rng1, rng2, [&](auto f1, auto l1, auto f2, auto l2) {
+                return set_difference_fn::impl(
+                    std::move(f1), std::move(l1), std::move(f2), std::move(l2),
+                    std::move(result), comp, proj1, proj2);
+            });
+    }
+};
+
+}
+
+NANO_INLINE_VAR(detail::set_difference_fn, set_difference)
+
+NANO_END_NAMESPACE
+
+#endif
+
+// nanorange/algorithm/set_intersection.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_ALGORITHM_SET_INTERSECTION_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_SET_INTERSECTION_HPP_INCLUDED
+
+
+
+
+
+NANO_BEGIN_NAMESPACE
+
+namespace detail {
+
+struct set_intersection_fn {
+private:
+    template <typename I1, typename S1, typename I2, typename S2, typename O,
+              typename Comp, typename Proj1, typename Proj2>
+    static constexpr O impl(I1 first1, S1 last1, I2 first2, S2 last2,
+                            O result, Comp& comp, Proj1& proj1, Proj2& proj2)
+    {
+        // For sorted integers, the vectorised kernel does as much of the work
+        // as it can
+        detail::simd_set_prefix<Comp, Proj1, Proj2>(
+            first1, last1, first2, last2, result, [](auto... args) {
+                return detail::simd_set_match<true>(std::move(args)...);
+            });
+
+        // With random access, count how many elements in a row we skip over
+        // in each range so that we can gallop through long runs
+        [[maybe_unused]] std::ptrdiff_t run1 = 0;
+        [[maybe_unused]] std::ptrdiff_t run2 = 0;
+
+        while (first1 != last1 && first2 != last2)
+        {
+            if (nano::invoke(comp, nano::invoke(proj1, *first1),
+                             nano::invoke(proj2, *first2))) {
+                ++first1;
+
+                if constexpr (is_gallop_candidate<I1, S1, I2, S2>) {
+                    run2 = 0;
+                    if (++run1 == gallop_threshold) {
+                        first1 = detail::gallop(first1, last1, [&](auto&& x) {
+                            return nano::invoke(comp, nano::invoke(proj1, x),
+                                                nano::invoke(proj2, *first2));
+                        });
+                        run1 = 0;
+                    }
+                }
+            } else {
+                const bool equal = !nano::invoke(comp, nano::invoke(proj2, *first2),
+                                                 nano::invoke(proj1, *first1));
+                if (equal) {
+                    *result = *first1;
+                    ++result;
+                    ++first1;
+                }
+                ++first2;
+
+                if constexpr (is_gallop_candidate<I1, S1, I2, S2>) {
+                    run1 = 0;
+                    run2 = equal ? 0 : run2 + 1;
+                    if (run2 == gallop_threshold) {
+                        first2 = detail::gallop(first2, last2, [&](auto&& y) {
+                            return nano::invoke(comp, nano::invoke(proj2, y),
+                                                nano::invoke(proj1, *first1));
+                        });
+                        run2 = 0;
+                    }
+                }
+            }
+        }
+
+        return result;
+    }
+
+public:
+    template <typename I1, typename S1, typename I2, typename S2, typename O,
+              typename Comp = ranges::less, typename Proj1 = identity,
+              typename Proj2 = identity>
+    constexpr std::enable_if_t<input_iterator<I1> &&
+        sentinel_for<S1, I1> &&
+        input_iterator<I2> &&
+        sentinel_for<S2, I2> &&
+        weakly_incrementable<O> &&
+        mergeable<I1, I2, O, Comp, Proj1, Proj2>, O>
+    operator()(I1 first1, S1 last1, I2 first2, S2 last2, O result,
+               Comp comp = Comp{}, Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
+    {
+        return set_intersection_fn::impl(std::move(first1), std::move(last1),
+                                         std::move(first2), std::move(last2),
+                                         std::move(result), comp, proj1, proj2);
+    }
+
+    template <typename Rng1, typename Rng2, typename O, typename Comp = ranges::less,
+              typename Proj1 = identity, typename Proj2 = identity>
+    constexpr std::enable_if_t<input_range<Rng1> &&
+        input_range<Rng2> &&
+        weakly_incrementable<O> &&
+        mergeable<iterator_t<Rng1>, iterator_t<Rng2>, O, Comp, Proj1, Proj2>,
+         O>
+    operator()(Rng1&& rng1, Rng2&& rng2, O result, Comp comp = Comp{},
+               Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
+    {
+        return detail::simd_set_dispatch<Comp, Proj1, Proj2>(
+            rng1, rng2, [&](auto f1, auto l1, auto f2, auto l2) {
+                return set_intersection_fn::impl(
+                    std::move(f1), std::move(l1), std::move(f2), std::move(l2),
+                    std::move(result), comp, proj1, proj2);
+            });
+    }
+};
+
+}
+
+NANO_INLINE_VAR(detail::set_intersection_fn, set_intersection)
+
+NANO_END_NAMESPACE
+
+#endif
+
+// nanorange/algorithm/set_symmetric_difference.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_ALGORITHM_SET_SYMMETRIC_DIFFERENCE_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_SET_SYMMETRIC_DIFFERENCE_HPP_INCLUDED
+
+
+
+
+NANO_BEGIN_NAMESPACE
+
+template <typename I1, typename I2, typename O>
+using set_symmetric_difference_result = in_in_out_result<I1, I2, O>;
+
+namespace detail {
+
+struct set_symmetric_difference_fn {
+private:
+    template <typename I1, typename S1, typename I2, typename S2, typename O,
+            typename Comp, typename Proj1, typename Proj2>
+    static constexpr set_symmetric_difference_result<I1, I2, O>
+    impl(I1 first1, S1 last1, I2 first2, S2 last2, O result,
+         Comp& comp, Proj1& proj1, Proj2& proj2)
+    {
+        while (true) {
+            if (first1 == last1) {
+                auto copy_res = nano::copy(std::move(first2), std::move(last2),
+                                           std::move(result));
+
+
+                return {std::move(first1), std::move(copy_res.in),
+                        std::move(copy_res.out)};
+            }
+
+            if (first2 == last2) {
+                auto copy_res = nano::copy(std::move(first1),  std::move(last1),
+                                           std::move(result));
+                return {std::move(copy_res.in), std::move(first2),
+                        std::move(copy_res.out)};
+            }
+
+            // If r1 is less than r2, copy it to the output
+            if (nano::invoke(comp, nano::invoke(proj1, *first1),
+                             nano::invoke(proj2, *first2))) {
+                *result = *first1;
+                ++result;
+                ++first1;
+            } else {
+                // We now know that !(r1 < r2). If !(r2 < r1) as well then
+                // the elements are equal -- so skip
+                if (!nano::invoke(comp, nano::invoke(proj2, *first2),
+                                  nano::invoke(proj1, *first1))) {
+                    ++first1;
+                } else {
+                    // Otherwise copy first2
+                    *result = *first2;
+                    ++result;
+                }
+                ++first2;
+            }
+        }
+    }
+
+public:
+    template <typename I1, typename S1, typename I2, typename S2, typename O,
+              typename Comp = ranges::less, typename Proj1 = identity,
+              typename Proj2 = identity>
+    constexpr std::enable_if_t<input_iterator<I1> &&
+        sentinel_for<S1, I1> &&
+        input_iterator<I2> &&
+        sentinel_for<S2, I2> &&
+        weakly_incrementable<O> &&
+        mergeable<I1, I2, O, Comp, Proj1, Proj2>,
+        set_symmetric_difference_result<I1, I2, O>>
+    operator()(I1 first1, S1 last1, I2 first2, S2 last2, O result, Comp comp = Comp{},
+               Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
+    {
+        return set_symmetric_difference_fn::impl(std::move(first1), std::move(last1),
+                                                 std::move(first2), std::move(last2),
+                                                 std::move(result), comp,
+                                                 proj1, proj2);
     }
 
     template <typename Rng1, typename Rng2, typename O, typename Comp = ranges::less,
               typename Proj1 = identity, typename Proj2 = identity>
-    constexpr std::enable_if_t<input_range<Rng1> &&
+    std::enable_if_t<input_range<Rng1> &&
         input_range<Rng2> &&
         weakly_incrementable<O> &&
         mergeable<iterator_t<Rng1>, iterator_t<Rng2>, O, Comp, Proj1, Proj2>,
-        set_difference_result<borrowed_iterator_t<Rng1>, O>>
+        set_symmetric_difference_result<borrowed_iterator_t<Rng1>,
+                                        borrowed_iterator_t<Rng2>, O>>
     operator()(Rng1&& rng1, Rng2&& rng2, O result, Comp comp = Comp{},
                Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
     {
-        return set_difference_fn::impl(nano::begin(rng1), nano::end(rng1),
-                                       nano::begin(rng2), nano::end(rng2),
-                                       std::move(result), comp,
-                                       proj1, proj2);
+        return set_symmetric_difference_fn::impl(nano::begin(rng1), nano::end(rng1),
+                                                 nano::begin(rng2), nano::end(rng2),
+                                                 std::move(result), comp,
+                                                 proj1, proj2);
     }
 };
 
 }
 
-NANO_INLINE_VAR(detail::set_difference_fn, set_difference)
+NANO_INLINE_VAR(detail::set_symmetric_difference_fn, set_symmetric_difference)
 
 NANO_END_NAMESPACE
 
 #endif
 
-// nanorange/algorithm/set_intersection.hpp
+// nanorange/algorithm/set_union.hpp
 //
 // Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
 // Distributed under the Boost Software License, Version 1.0. (See accompanying
 // file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
-#ifndef NANORANGE_ALGORITHM_SET_INTERSECTION_HPP_INCLUDED
-#define NANORANGE_ALGORITHM_SET_INTERSECTION_HPP_INCLUDED
+#ifndef NANORANGE_ALGORITHM_SET_UNION_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_SET_UNION_HPP_INCLUDED
+
+
+
 
 
 
 NANO_BEGIN_NAMESPACE
 
+template <typename I1, typename I2, typename O>
+using set_union_result = in_in_out_result<I1, I2, O>;
+
 namespace detail {
 
-struct set_intersection_fn {
+struct set_union_fn {
 private:
     template <typename I1, typename S1, typename I2, typename S2, typename O,
               typename Comp, typename Proj1, typename Proj2>
-    static constexpr O impl(I1 first1, S1 last1, I2 first2, S2 last2,
-                            O result, Comp& comp, Proj1& proj1, Proj2& proj2)
+    static constexpr set_union_result<I1, I2, O>
+    impl(I1 first1, S1 last1, I2 first2, S2 last2, O result, Comp& comp,
+         Proj1& proj1, Proj2& proj2)
     {
-        while (first1 != last1 && first2 != last2)
-        {
+        // For sorted integers, merge without branching on each comparison
+        // until one of the ranges runs out
+        detail::simd_set_prefix<Comp, Proj1, Proj2>(
+            first1, last1, first2, last2, result, [](auto... args) {
+                return detail::simd_set_union(std::move(args)...);
+            });
+
+        // With random access, count how many elements in a row we take from
+        // each range so that we can gallop through long runs
+        [[maybe_unused]] std::ptrdiff_t run1 = 0;
+        [[maybe_unused]] std::ptrdiff_t run2 = 0;
+
+        while (first1 != last1) {
+            // If we've reached the end of the second range, copy any remaining
+            // elements from the first range and quit
+            if (first2 == last2) {
+                auto copy_res = nano::copy(std::move(first1),  std::move(last1),
+                                           std::move(result));
+
+                first1 = std::move(copy_res.in);
+                result = std::move(copy_res.out);
+
+                break;
+            }
+
+            // If this element from r1 is less than the current element from r2,
+            // copy it and move on
             if (nano::invoke(comp, nano::invoke(proj1, *first1),
                              nano::invoke(proj2, *first2))) {
+                *result = *first1;
                 ++first1;
+                ++result;
+
+                if constexpr (is_gallop_candidate<I1, S1, I2, S2>) {
+                    run2 = 0;
+                    if (++run1 == gallop_threshold) {
+                        // Copy the rest of the elements of r1 which are less
+                        // than this element of r2 in one go
+                        const I1 mid1 = detail::gallop(first1, last1, [&](auto&& x) {
+                            return nano::invoke(comp, nano::invoke(proj1, x),
+                                                nano::invoke(proj2, *first2));
+                        });
+                        result = nano::copy(first1, mid1, std::move(result)).out;
+                        first1 = mid1;
+                        run1 = 0;
+                    }
+                }
             } else {
-                if (!nano::invoke(comp, nano::invoke(proj2, *first2),
-                                 nano::invoke(proj1, *first1))) {
-                    *result = *first1;
-                    ++result;
+                // Now, we know that !(r1 < r2). If we also have !(r2 < r1) then
+                // the elements compare equal, so skip it
+                const bool equal = !nano::invoke(comp, nano::invoke(proj2, *first2),
+                                                 nano::invoke(proj1, *first1));
+                if (equal) {
                     ++first1;
                 }
+                *result = *first2;
                 ++first2;
+                ++result;
+
+                if constexpr (is_gallop_candidate<I1, S1, I2, S2>) {
+                    run1 = 0;
+                    run2 = equal ? 0 : run2 + 1;
+                    if (run2 == gallop_threshold) {
+                        // Likewise, copy the rest of the elements of r2 which
+                        // are less than this element of r1
+                        const I2 mid2 = detail::gallop(first2, last2, [&](auto&& y) {
+                            return nano::invoke(comp, nano::invoke(proj2, y),
+                                                nano::invoke(proj1, *first1));
+                        });
+                        result = nano::copy(first2, mid2, std::move(result)).out;
+                        first2 = mid2;
+                        run2 = 0;
+                    }
+                }
             }
         }
 
-        return result;
+        // We've run out of elements of range1, so copy all the remaining
+        // elements of range2
+        auto copy_res = nano::copy(std::move(first2), std::move(last2),
+                                   std::move(result));
+
+
+        return {std::move(first1), std::move(copy_res.in),
+                std::move(copy_res.out)};
     }
 
 public:
@@ -12309,2102 +19234,2282 @@ public:
         input_iterator<I2> &&
         sentinel_for<S2, I2> &&
         weakly_incrementable<O> &&
-        mergeable<I1, I2, O, Comp, Proj1, Proj2>, O>
+        mergeable<I1, I2, O, Comp, Proj1, Proj2>,
+        set_union_result<I1, I2, O>>
     operator()(I1 first1, S1 last1, I2 first2, S2 last2, O result,
                Comp comp = Comp{}, Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
     {
-        return set_intersection_fn::impl(std::move(first1), std::move(last1),
-                                         std::move(first2), std::move(last2),
-                                         std::move(result), comp, proj1, proj2);
+        return set_union_fn::impl(std::move(first1), std::move(last1),
+                                  std::move(first2), std::move(last2),
+                                  std::move(result), comp,
+                                  proj1, proj2);
     }
 
     template <typename Rng1, typename Rng2, typename O, typename Comp = ranges::less,
               typename Proj1 = identity, typename Proj2 = identity>
-    constexpr std::enable_if_t<input_range<Rng1> &&
+    constexpr std::enable_if_t<
+        input_range<Rng1> &&
         input_range<Rng2> &&
         weakly_incrementable<O> &&
         mergeable<iterator_t<Rng1>, iterator_t<Rng2>, O, Comp, Proj1, Proj2>,
-         O>
+        set_union_result<borrowed_iterator_t<Rng1>,
+                                                borrowed_iterator_t<Rng2>, O>>
     operator()(Rng1&& rng1, Rng2&& rng2, O result, Comp comp = Comp{},
                Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
     {
-        return set_intersection_fn::impl(nano::begin(rng1), nano::end(rng1),
-                                         nano::begin(rng2), nano::end(rng2),
-                                         std::move(result), comp, proj1, proj2);
+        return detail::simd_set_dispatch<Comp, Proj1, Proj2>(
+            rng1, rng2, [&](auto f1, auto l1, auto f2, auto l2) {
+                return set_union_fn::impl(
+                    std::move(f1), std::move(l1), std::move(f2), std::move(l2),
+                    std::move(result), comp, proj1, proj2);
+            });
     }
 };
 
 }
 
-NANO_INLINE_VAR(detail::set_intersection_fn, set_intersection)
+NANO_INLINE_VAR(detail::set_union_fn, set_union)
 
 NANO_END_NAMESPACE
 
 #endif
 
-// nanorange/algorithm/set_symmetric_difference.hpp
+// nanorange/algorithm/sample.hpp
+//
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef NANORANGE_ALGORITHM_SAMPLE_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_SAMPLE_HPP_INCLUDED
+
+
+// nanorange/random.hpp
 //
 // Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
 // Distributed under the Boost Software License, Version 1.0. (See accompanying
 // file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
-#ifndef NANORANGE_ALGORITHM_SET_SYMMETRIC_DIFFERENCE_HPP_INCLUDED
-#define NANORANGE_ALGORITHM_SET_SYMMETRIC_DIFFERENCE_HPP_INCLUDED
+#ifndef NANORANGE_RANDOM_HPP_INCLUDED
+#define NANORANGE_RANDOM_HPP_INCLUDED
+
+// nanorange/concepts.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_CONCEPTS_HPP_INCLUDED
+#define NANORANGE_CONCEPTS_HPP_INCLUDED
+
 
 
 
 
+
+#endif
+
+
 NANO_BEGIN_NAMESPACE
 
-template <typename I1, typename I2, typename O>
-using set_symmetric_difference_result = in_in_out_result<I1, I2, O>;
+//  [rand.req.urng]
 
 namespace detail {
 
-struct set_symmetric_difference_fn {
+struct uniform_random_bit_generator_concept {
+    template <typename>
+    static auto test(long) -> std::false_type;
+
+    template <typename G>
+    static auto test(int) -> std::enable_if_t<
+        invocable<G&> &&
+        unsigned_integral<invoke_result_t<G&>> &&
+        detail::requires_<uniform_random_bit_generator_concept, G>,
+        std::true_type>;
+
+
+    template <typename G>
+    auto requires_() -> decltype(
+        requires_expr<same_as<decltype((G::min)()), invoke_result_t<G&>>>{},
+        requires_expr<same_as<decltype((G::max)()), invoke_result_t<G&>>>{}
+    );
+};
+
+} // namespace detail
+
+template <typename G>
+NANO_CONCEPT uniform_random_bit_generator =
+    decltype(detail::uniform_random_bit_generator_concept::test<G>(0))::value;
+
+NANO_END_NAMESPACE
+
+#endif
+
+
+
+#include <random>
+
+NANO_BEGIN_NAMESPACE
+
+namespace detail {
+
+struct sample_fn {
 private:
-    template <typename I1, typename S1, typename I2, typename S2, typename O,
-            typename Comp, typename Proj1, typename Proj2>
-    static constexpr set_symmetric_difference_result<I1, I2, O>
-    impl(I1 first1, S1 last1, I2 first2, S2 last2, O result,
-         Comp& comp, Proj1& proj1, Proj2& proj2)
+    template <typename I, typename S, typename O, typename Gen>
+    static O impl_fwd(I first, S last, O out, iter_difference_t<I> n, Gen& g)
     {
-        while (true) {
-            if (first1 == last1) {
-                auto copy_res = nano::copy(std::move(first2), std::move(last2),
-                                           std::move(result));
+        using diff_t = iter_difference_t<I>;
+        using distr_t = std::uniform_int_distribution<diff_t>;
+        using param_t = typename distr_t::param_type;
 
+        distr_t D;
 
-                return {std::move(first1), std::move(copy_res.in),
-                        std::move(copy_res.out)};
-            }
+        auto unsampled_size = nano::distance(first, last);
 
-            if (first2 == last2) {
-                auto copy_res = nano::copy(std::move(first1),  std::move(last1),
-                                           std::move(result));
-                return {std::move(copy_res.in), std::move(first2),
-                        std::move(copy_res.out)};
+        for (n = (nano::min)(n, unsampled_size); n != 0; ++first) {
+            if (D(g, param_t(0, --unsampled_size)) < n) {
+                *out++ = *first;
+                --n;
             }
+        }
 
-            // If r1 is less than r2, copy it to the output
-            if (nano::invoke(comp, nano::invoke(proj1, *first1),
-                             nano::invoke(proj2, *first2))) {
-                *result = *first1;
-                ++result;
-                ++first1;
-            } else {
-                // We now know that !(r1 < r2). If !(r2 < r1) as well then
-                // the elements are equal -- so skip
-                if (!nano::invoke(comp, nano::invoke(proj2, *first2),
-                                  nano::invoke(proj1, *first1))) {
-                    ++first1;
-                } else {
-                    // Otherwise copy first2
-                    *result = *first2;
-                    ++result;
-                }
-                ++first2;
+        return out;
+    }
+    template <typename I, typename S, typename O, typename Gen>
+    static O impl_ra(I first, S last, O out, iter_difference_t<I> n, Gen& g) {
+        using diff_t = iter_difference_t<I>;
+        using distr_t = std::uniform_int_distribution<diff_t>;
+        using param_t = typename distr_t::param_type;
+
+        distr_t D;
+        diff_t k = 0;
+
+        for(; first != last && k < n; ++first, (void) ++k) {
+            out[k] = *first;
+        }
+
+        diff_t size = k;
+        for (; first != last; ++first, (void) ++k) {
+            diff_t r = distr_t(0, k)(g);
+            if (D(g, param_t(0, k)) < size) {
+                out[r] = *first;
             }
         }
+
+        return out + (nano::min)(n, k);
+    }
+
+    template <typename I, typename S, typename O, typename Gen>
+    static O impl(I first, S last, O out, iter_difference_t<I> n, Gen& g)
+    {
+        if constexpr (nano::forward_iterator<I>) {
+            return impl_fwd(std::move(first), std::move(last), std::move(out), n, g);
+	} else {
+            return impl_ra(std::move(first), std::move(last), std::move(out), n, g);
+	}
     }
 
 public:
-    template <typename I1, typename S1, typename I2, typename S2, typename O,
-              typename Comp = ranges::less, typename Proj1 = identity,
-              typename Proj2 = identity>
-    constexpr std::enable_if_t<input_iterator<I1> &&
-        sentinel_for<S1, I1> &&
-        input_iterator<I2> &&
-        sentinel_for<S2, I2> &&
+    template <typename I, typename S, typename O, typename Gen>
+    std::enable_if_t<
+        input_iterator<I> &&
+        sentinel_for<S, I> &&
         weakly_incrementable<O> &&
-        mergeable<I1, I2, O, Comp, Proj1, Proj2>,
-        set_symmetric_difference_result<I1, I2, O>>
-    operator()(I1 first1, S1 last1, I2 first2, S2 last2, O result, Comp comp = Comp{},
-               Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
+        (forward_iterator<I> || random_access_iterator<O>) &&
+        indirectly_copyable<I, O> &&
+        uniform_random_bit_generator<std::remove_reference_t<Gen>>,
+        O>
+    operator()(I first, S last, O out, iter_difference_t<I> n, Gen&& gen) const
     {
-        return set_symmetric_difference_fn::impl(std::move(first1), std::move(last1),
-                                                 std::move(first2), std::move(last2),
-                                                 std::move(result), comp,
-                                                 proj1, proj2);
+        return sample_fn::impl(std::move(first), std::move(last),
+                               std::move(out), std::move(n),
+                               std::forward<Gen>(gen));
     }
 
-    template <typename Rng1, typename Rng2, typename O, typename Comp = ranges::less,
-              typename Proj1 = identity, typename Proj2 = identity>
-    std::enable_if_t<input_range<Rng1> &&
-        input_range<Rng2> &&
+    template <typename Rng, typename O, typename Gen>
+    std::enable_if_t<
+        input_range<Rng> &&
         weakly_incrementable<O> &&
-        mergeable<iterator_t<Rng1>, iterator_t<Rng2>, O, Comp, Proj1, Proj2>,
-        set_symmetric_difference_result<borrowed_iterator_t<Rng1>,
-                                        borrowed_iterator_t<Rng2>, O>>
-    operator()(Rng1&& rng1, Rng2&& rng2, O result, Comp comp = Comp{},
-               Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
+        (forward_range<Rng> || random_access_iterator<O> ) &&
+        indirectly_copyable<iterator_t<Rng>, O> &&
+        uniform_random_bit_generator<std::remove_reference_t<Gen>>,
+        O>
+    operator()(Rng&& rng, O out, range_difference_t<Rng> n, Gen&& gen) const
     {
-        return set_symmetric_difference_fn::impl(nano::begin(rng1), nano::end(rng1),
-                                                 nano::begin(rng2), nano::end(rng2),
-                                                 std::move(result), comp,
-                                                 proj1, proj2);
+        return sample_fn::impl(nano::begin(rng), nano::end(rng),
+                               std::move(out), std::move(n), std::forward<Gen>(gen));
     }
 };
 
 }
 
-NANO_INLINE_VAR(detail::set_symmetric_difference_fn, set_symmetric_difference)
+NANO_INLINE_VAR(detail::sample_fn, sample)
 
 NANO_END_NAMESPACE
 
 #endif
 
-// nanorange/algorithm/set_union.hpp
+// nanorange/algorithm/shuffle.hpp
 //
 // Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
 // Distributed under the Boost Software License, Version 1.0. (See accompanying
 // file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
-#ifndef NANORANGE_ALGORITHM_SET_UNION_HPP_INCLUDED
-#define NANORANGE_ALGORITHM_SET_UNION_HPP_INCLUDED
+#ifndef NANORANGE_ALGORITHM_SHUFFLE_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_SHUFFLE_HPP_INCLUDED
 
 
 
 
-NANO_BEGIN_NAMESPACE
+#include <random>
 
-template <typename I1, typename I2, typename O>
-using set_union_result = in_in_out_result<I1, I2, O>;
+NANO_BEGIN_NAMESPACE
 
 namespace detail {
 
-struct set_union_fn {
+struct shuffle_fn {
 private:
-    template <typename I1, typename S1, typename I2, typename S2, typename O,
-              typename Comp, typename Proj1, typename Proj2>
-    static constexpr set_union_result<I1, I2, O>
-    impl(I1 first1, S1 last1, I2 first2, S2 last2, O result, Comp& comp,
-         Proj1& proj1, Proj2& proj2)
+    template <typename I, typename S, typename Gen>
+    static constexpr I impl(I first, S last, Gen&& g)
     {
-        while (first1 != last1) {
-            // If we've reached the end of the second range, copy any remaining
-            // elements from the first range and quit
-            if (first2 == last2) {
-                auto copy_res = nano::copy(std::move(first1),  std::move(last1),
-                                           std::move(result));
-
-                first1 = std::move(copy_res.in);
-                result = std::move(copy_res.out);
+        using diff_t = iter_difference_t<I>;
+        using distr_t = std::uniform_int_distribution<diff_t>;
+        using param_t = typename distr_t::param_type;
 
-                break;
-            }
+        distr_t D;
+        const auto n = last - first; // OK, we have SizedSentinel
 
-            // If this element from r1 is less than the current element from r2,
-            // copy it and move on
-            if (nano::invoke(comp, nano::invoke(proj1, *first1),
-                             nano::invoke(proj2, *first2))) {
-                *result = *first1;
-                ++first1;
-            } else {
-                // Now, we know that !(r1 < r2). If we also have !(r2 < r1) then
-                // the elements compare equal, so skip it
-                if (!nano::invoke(comp, nano::invoke(proj2, *first2),
-                                  nano::invoke(proj1, *first1))) {
-                    ++first1;
-                }
-                *result = *first2;
-                ++first2;
-            }
-            ++result;
+        for (diff_t i = 0; i < n; i++) {
+            nano::iter_swap(first + i, first + D(g, param_t(0, i)));
         }
 
-        // We've run out of elements of range1, so copy all the remaining
-        // elements of range2
-        auto copy_res = nano::copy(std::move(first2), std::move(last2),
-                                   std::move(result));
-
-
-        return {std::move(first1), std::move(copy_res.in),
-                std::move(copy_res.out)};
+        return next(first, last);
     }
 
 public:
-    template <typename I1, typename S1, typename I2, typename S2, typename O,
-              typename Comp = ranges::less, typename Proj1 = identity,
-              typename Proj2 = identity>
-    constexpr std::enable_if_t<input_iterator<I1> &&
-        sentinel_for<S1, I1> &&
-        input_iterator<I2> &&
-        sentinel_for<S2, I2> &&
-        weakly_incrementable<O> &&
-        mergeable<I1, I2, O, Comp, Proj1, Proj2>,
-        set_union_result<I1, I2, O>>
-    operator()(I1 first1, S1 last1, I2 first2, S2 last2, O result,
-               Comp comp = Comp{}, Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
+    template <typename I, typename S, typename Gen>
+    constexpr std::enable_if_t<
+        random_access_iterator<I> && sentinel_for<S, I> &&
+            uniform_random_bit_generator<std::remove_reference_t<Gen>> &&
+        convertible_to<invoke_result_t<Gen&>, iter_difference_t<I>>,
+        I>
+    operator()(I first, S last, Gen&& gen) const
     {
-        return set_union_fn::impl(std::move(first1), std::move(last1),
-                                  std::move(first2), std::move(last2),
-                                  std::move(result), comp,
-                                  proj1, proj2);
+        return shuffle_fn::impl(std::move(first), std::move(last),
+                                std::forward<Gen>(gen));
     }
 
-    template <typename Rng1, typename Rng2, typename O, typename Comp = ranges::less,
-              typename Proj1 = identity, typename Proj2 = identity>
+    template <typename Rng, typename Gen>
     constexpr std::enable_if_t<
-        input_range<Rng1> &&
-        input_range<Rng2> &&
-        weakly_incrementable<O> &&
-        mergeable<iterator_t<Rng1>, iterator_t<Rng2>, O, Comp, Proj1, Proj2>,
-        set_union_result<borrowed_iterator_t<Rng1>,
-                                                borrowed_iterator_t<Rng2>, O>>
-    operator()(Rng1&& rng1, Rng2&& rng2, O result, Comp comp = Comp{},
-               Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
+        random_access_range<Rng> &&
+            uniform_random_bit_generator<std::remove_reference_t<Gen>> &&
+            convertible_to<invoke_result_t<Gen&>, iter_difference_t<iterator_t<Rng>>>,
+        borrowed_iterator_t<Rng>>
+    operator()(Rng&& rng, Gen&& gen) const
     {
-        return set_union_fn::impl(nano::begin(rng1), nano::end(rng1),
-                                  nano::begin(rng2), nano::end(rng2),
-                                  std::move(result), comp,
-                                  proj1, proj2);
+        return shuffle_fn::impl(nano::begin(rng), nano::end(rng),
+                                std::forward<Gen>(gen));
     }
 };
 
 }
 
-NANO_INLINE_VAR(detail::set_union_fn, set_union)
+NANO_INLINE_VAR(detail::shuffle_fn, shuffle)
 
 NANO_END_NAMESPACE
 
 #endif
 
-// nanorange/algorithm/sample.hpp
-//
-//===----------------------------------------------------------------------===//
-//
-// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
-// See https://llvm.org/LICENSE.txt for license information.
-// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
-//
-//===----------------------------------------------------------------------===//
-
-#ifndef NANORANGE_ALGORITHM_SAMPLE_HPP_INCLUDED
-#define NANORANGE_ALGORITHM_SAMPLE_HPP_INCLUDED
-
-
-// nanorange/random.hpp
+// nanorange/algorithm/sort.hpp
 //
 // Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
 // Distributed under the Boost Software License, Version 1.0. (See accompanying
 // file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
-#ifndef NANORANGE_RANDOM_HPP_INCLUDED
-#define NANORANGE_RANDOM_HPP_INCLUDED
+#ifndef NANORANGE_ALGORITHM_SORT_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_SORT_HPP_INCLUDED
+
 
-// nanorange/concepts.hpp
-//
-// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
-// Distributed under the Boost Software License, Version 1.0. (See accompanying
-// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
-#ifndef NANORANGE_CONCEPTS_HPP_INCLUDED
-#define NANORANGE_CONCEPTS_HPP_INCLUDED
 
 
 
 
+#include <array>
+
+NANO_BEGIN_NAMESPACE
+
+namespace detail {
+
+struct sort_fn {
+private:
+    // Large ranges with integer or floating point keys, sorted in their
+    // natural order, are radix sorted if we can get a buffer
+    template <typename I, typename Comp, typename Proj>
+    static constexpr void impl(I first, I last, Comp& comp, Proj& proj)
+    {
+        if constexpr (is_radix_sortable<I, Comp, Proj>) {
+            if (!detail::is_constant_evaluated() &&
+                last - first >= radix_sort_threshold<radix_key_t<I, Proj>> &&
+                detail::radix_sort(first, last, comp, proj)) {
+                return;
+            }
+        }
+
+        detail::pdqsort(std::move(first), std::move(last), comp, proj);
+    }
+
+    // Arrays small enough for a sorting network use the one for their size
+    template <std::size_t N, typename I, typename Comp, typename Proj>
+    static constexpr void fixed_size_impl(I first, Comp& comp, Proj& proj)
+    {
+        if constexpr (N <= std::size_t(sorting_network_max)) {
+            detail::sorting_network<pdqsort_use_branchless<I, Comp, Proj>, N>(
+                std::move(first), comp, proj);
+        } else {
+            sort_fn::impl(first, first + N, comp, proj);
+        }
+    }
+
+    template <typename EP, typename I, typename Comp, typename Proj>
+    static void impl(EP&&, I first, I last, Comp& comp, Proj& proj)
+    {
+        if constexpr (is_parallel_policy_v<EP>) {
+            detail::parallel_pdqsort(std::move(first), std::move(last), comp,
+                                     proj);
+        } else {
+            sort_fn::impl(std::move(first), std::move(last), comp, proj);
+        }
+    }
+
+public:
+    template <typename I, typename S, typename Comp = ranges::less, typename Proj = identity>
+    constexpr std::enable_if_t<random_access_iterator<I> && sentinel_for<S, I> &&
+                                   sortable<I, Comp, Proj>, I>
+    operator()(I first, S last, Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        I last_it = nano::next(first, last);
+        sort_fn::impl(std::move(first), last_it, comp, proj);
+        return last_it;
+    }
+
+    template <typename Rng, typename Comp = ranges::less, typename Proj = identity>
+    constexpr std::enable_if_t<random_access_range<Rng> &&
+                                   sortable<iterator_t<Rng>, Comp, Proj>,
+                               borrowed_iterator_t<Rng>>
+    operator()(Rng&& rng, Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        iterator_t<Rng> last_it = nano::next(nano::begin(rng), nano::end(rng));
+        sort_fn::impl(nano::begin(rng), last_it, comp, proj);
+        return last_it;
+    }
+
+    // Extension: arrays whose size is known at compile time, of up to 16
+    // elements, are sorted with a sorting network chosen for that size
+    template <typename T, std::size_t N, typename Comp = ranges::less,
+              typename Proj = identity>
+    constexpr std::enable_if_t<sortable<T*, Comp, Proj>, T*>
+    operator()(T (&arr)[N], Comp comp = Comp{}, Proj proj = Proj{}) const
+    {
+        sort_fn::fixed_size_impl<N>(arr + 0, comp, proj);
+        return arr + N;
+    }
+
+    template <typename T, std::size_t N, typename Comp = ranges::less,
+              typename Proj = identity>
+    constexpr std::enable_if_t<
+        sortable<typename std::array<T, N>::iterator, Comp, Proj>,
+        typename std::array<T, N>::iterator>
+    operator()(std::array<T, N>& arr, Comp comp = Comp{},
+               Proj proj = Proj{}) const
+    {
+        sort_fn::fixed_size_impl<N>(arr.begin(), comp, proj);
+        return arr.end();
+    }
+
+    template <typename EP, typename I, typename S, typename Comp = ranges::less,
+              typename Proj = identity>
+    std::enable_if_t<is_execution_policy_v<remove_cvref_t<EP>> &&
+                         random_access_iterator<I> && sentinel_for<S, I> &&
+                         sortable<I, Comp, Proj>, I>
+    operator()(EP&& policy, I first, S last, Comp comp = Comp{},
+               Proj proj = Proj{}) const
+    {
+        I last_it = nano::next(first, last);
+        sort_fn::impl(std::forward<EP>(policy), std::move(first), last_it, comp,
+                      proj);
+        return last_it;
+    }
+
+    template <typename EP, typename Rng, typename Comp = ranges::less,
+              typename Proj = identity>
+    std::enable_if_t<is_execution_policy_v<remove_cvref_t<EP>> &&
+                         random_access_range<Rng> &&
+                         sortable<iterator_t<Rng>, Comp, Proj>,
+                     borrowed_iterator_t<Rng>>
+    operator()(EP&& policy, Rng&& rng, Comp comp = Comp{},
+               Proj proj = Proj{}) const
+    {
+        iterator_t<Rng> last_it = nano::next(nano::begin(rng), nano::end(rng));
+        sort_fn::impl(std::forward<EP>(policy), nano::begin(rng), last_it, comp,
+                      proj);
+        return last_it;
+    }
+};
+
+}
+
+NANO_INLINE_VAR(detail::sort_fn, sort)
 
+NANO_END_NAMESPACE
 
 #endif
 
 
-NANO_BEGIN_NAMESPACE
+// nanorange/algorithm/stl/stable_partition.hpp
+//
+// Copyright (c) 2019 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
-//  [rand.req.urng]
+//===-------------------------- algorithm ---------------------------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is dual licensed under the MIT and the University of Illinois Open
+// Source Licenses. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
 
-namespace detail {
+#ifndef NANORANGE_ALGORITHM_STABLE_PARTITION_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_STABLE_PARTITION_HPP_INCLUDED
 
-struct uniform_random_bit_generator_concept {
-    template <typename>
-    static auto test(long) -> std::false_type;
 
-    template <typename G>
-    static auto test(int) -> std::enable_if_t<
-        invocable<G&> &&
-        unsigned_integral<invoke_result_t<G&>> &&
-        detail::requires_<uniform_random_bit_generator_concept, G>,
-        std::true_type>;
 
 
-    template <typename G>
-    auto requires_() -> decltype(
-        requires_expr<same_as<decltype((G::min)()), invoke_result_t<G&>>>{},
-        requires_expr<same_as<decltype((G::max)()), invoke_result_t<G&>>>{}
-    );
-};
 
-} // namespace detail
 
-template <typename G>
-NANO_CONCEPT uniform_random_bit_generator =
-    decltype(detail::uniform_random_bit_generator_concept::test<G>(0))::value;
 
-NANO_END_NAMESPACE
 
-#endif
 
 
 
-#include <random>
 
 NANO_BEGIN_NAMESPACE
 
 namespace detail {
 
-struct sample_fn {
+struct stable_partition_fn {
 private:
-    template <typename I, typename S, typename O, typename Gen>
-    static O impl_fwd(I first, S last, O out, iter_difference_t<I> n, Gen& g)
+    template <typename I, typename Buf, typename Pred, typename Proj>
+    static subrange<I> impl_buffered(I first, I last, Buf& buf, Pred& pred, Proj& proj)
     {
-        using diff_t = iter_difference_t<I>;
-        using distr_t = std::uniform_int_distribution<diff_t>;
-        using param_t = typename distr_t::param_type;
-
-        distr_t D;
+        // first is known to be false, so pop it straight into the buffer
+        buf.push_back(nano::iter_move(first));
 
-        auto unsampled_size = nano::distance(first, last);
+        const auto res = nano::partition_copy(
+                nano::make_move_iterator(nano::next(first)),
+                nano::make_move_sentinel(--last),
+                first, nano::back_inserter(buf),
+                std::ref(pred), std::ref(proj));
 
-        for (n = (nano::min)(n, unsampled_size); n != 0; ++first) {
-            if (D(g, param_t(0, --unsampled_size)) < n) {
-                *out++ = *first;
-                --n;
-            }
-        }
+        // last is known to be true, move that to the correct pos
+        first = std::move(res.out1);
+        *first = nano::iter_move(last);
+        ++first;
 
-        return out;
+        // Now move all the other elements from the buffer back into the sequence
+        nano::move(buf, first);
+        return {std::move(first), std::move(last)};
     }
-    template <typename I, typename S, typename O, typename Gen>
-    static O impl_ra(I first, S last, O out, iter_difference_t<I> n, Gen& g) {
-        using diff_t = iter_difference_t<I>;
-        using distr_t = std::uniform_int_distribution<diff_t>;
-        using param_t = typename distr_t::param_type;
 
-        distr_t D;
-        diff_t k = 0;
-
-        for(; first != last && k < n; ++first, (void) ++k) {
-            out[k] = *first;
-        }
+    // Note to self: this is a closed range, last is NOT past-the-end!
+    template <typename I, typename Pred, typename Proj>
+    static subrange<I> impl_unbuffered(I first, I last, iter_difference_t<I> dist,
+                             Pred& pred, Proj& proj)
+    {
+        using dist_t = iter_difference_t<I>;
 
-        diff_t size = k;
-        for (; first != last; ++first, (void) ++k) {
-            diff_t r = distr_t(0, k)(g);
-            if (D(g, param_t(0, k)) < size) {
-                out[r] = *first;
-            }
+        if (dist == 2) {
+            // We know first is false and last is true, so swap them
+            nano::iter_swap(first, last);
+            return {nano::next(first), nano::next(last)};
         }
 
-        return out + (nano::min)(n, k);
-    }
-
-    template <typename I, typename S, typename O, typename Gen>
-    static O impl(I first, S last, O out, iter_difference_t<I> n, Gen& g)
-    {
-        if constexpr (nano::forward_iterator<I>) {
-            return impl_fwd(std::move(first), std::move(last), std::move(out), n, g);
-	} else {
-            return impl_ra(std::move(first), std::move(last), std::move(out), n, g);
-	}
-    }
+        if (dist == 3) {
+            // We know first is false and last is true, so look at middle
+            I middle = nano::next(first);
 
-public:
-    template <typename I, typename S, typename O, typename Gen>
-    std::enable_if_t<
-        input_iterator<I> &&
-        sentinel_for<S, I> &&
-        weakly_incrementable<O> &&
-        (forward_iterator<I> || random_access_iterator<O>) &&
-        indirectly_copyable<I, O> &&
-        uniform_random_bit_generator<std::remove_reference_t<Gen>>,
-        O>
-    operator()(I first, S last, O out, iter_difference_t<I> n, Gen&& gen) const
-    {
-        return sample_fn::impl(std::move(first), std::move(last),
-                               std::move(out), std::move(n),
-                               std::forward<Gen>(gen));
-    }
+            if (nano::invoke(pred, nano::invoke(proj, *middle))) {
+                nano::iter_swap(first, middle);
+                nano::iter_swap(middle, last);
+                return {nano::next(first, 2), nano::next(last)};
+            }
 
-    template <typename Rng, typename O, typename Gen>
-    std::enable_if_t<
-        input_range<Rng> &&
-        weakly_incrementable<O> &&
-        (forward_range<Rng> || random_access_iterator<O> ) &&
-        indirectly_copyable<iterator_t<Rng>, O> &&
-        uniform_random_bit_generator<std::remove_reference_t<Gen>>,
-        O>
-    operator()(Rng&& rng, O out, range_difference_t<Rng> n, Gen&& gen) const
-    {
-        return sample_fn::impl(nano::begin(rng), nano::end(rng),
-                               std::move(out), std::move(n), std::forward<Gen>(gen));
-    }
-};
+            // middle is false
+            nano::iter_swap(middle, last);
+            nano::iter_swap(first, middle);
+            return {std::move(middle), std::next(last)};
+        }
 
-}
+        const dist_t half = dist/2;
+        const I middle = nano::next(first, half);
 
-NANO_INLINE_VAR(detail::sample_fn, sample)
+        I m1 = nano::prev(middle);
+        dist_t len_half = half;
 
-NANO_END_NAMESPACE
+        while (m1 != first && !nano::invoke(pred, nano::invoke(proj, *m1))) {
+            --len_half;
+            --m1;
+        }
 
-#endif
+        const I first_false = (m1 == first) ? first :
+                impl_unbuffered(first, m1, len_half, pred, proj).begin();
 
-// nanorange/algorithm/shuffle.hpp
-//
-// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
-// Distributed under the Boost Software License, Version 1.0. (See accompanying
-// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+        m1 = middle;
+        len_half = dist - half;
 
-#ifndef NANORANGE_ALGORITHM_SHUFFLE_HPP_INCLUDED
-#define NANORANGE_ALGORITHM_SHUFFLE_HPP_INCLUDED
+        while (nano::invoke(pred, nano::invoke(proj, *m1))) {
+            if (++m1 == last) {
+                auto rot = nano::rotate(first_false, middle, ++last);
+                return {std::move(rot.begin()), nano::next(last)};
+            }
+        }
 
+        const I last_false = impl_unbuffered(m1, last, len_half, pred, proj).begin();
 
+        auto rot = nano::rotate(first_false, middle, last_false);
+        return {rot.begin(), nano::next(last)};
+    }
 
+    template <typename I, typename Pred, typename Proj>
+    static subrange<I> impl(I first, I last, Pred& pred, Proj& proj,
+                            temporary_resource* resource = nullptr)
+    {
+        // Find the first non-true value
+        first = nano::find_if_not(std::move(first), last, std::ref(pred), std::ref(proj));
+        if (first == last) {
+            return {std::move(first), std::move(last)};
+        }
 
-#include <random>
+        // Find the last true value
+        I it = nano::find_if(nano::make_reverse_iterator(last),
+                             nano::make_reverse_iterator(first),
+                             std::ref(pred), std::ref(proj)).base();
+        if (it == first) {
+            return {std::move(first), std::move(it)};
+        }
 
-NANO_BEGIN_NAMESPACE
+        const auto dist = nano::distance(first, it);
 
-namespace detail {
+        auto buf = detail::temporary_vector<iter_value_t<I>>(dist, resource);
+        if (buf.capacity() < static_cast<std::size_t>(dist)) {
+            return {impl_unbuffered(first, --it, dist, pred, proj).begin(), last};
+        }
+        return {impl_buffered(first, it, buf, pred, proj).begin(), last};
+    }
 
-struct shuffle_fn {
-private:
-    template <typename I, typename S, typename Gen>
-    static constexpr I impl(I first, S last, Gen&& g)
+    template <typename I, typename S, typename Pred, typename Proj>
+    static std::enable_if_t<!same_as<I, S>, subrange<I>>
+    impl(I first, S last, Pred& pred, Proj& proj,
+         temporary_resource* resource = nullptr)
     {
-        using diff_t = iter_difference_t<I>;
-        using distr_t = std::uniform_int_distribution<diff_t>;
-        using param_t = typename distr_t::param_type;
-
-        distr_t D;
-        const auto n = last - first; // OK, we have SizedSentinel
+        return impl(first, nano::next(first, last), pred, proj, resource);
+    }
 
-        for (diff_t i = 0; i < n; i++) {
-            nano::iter_swap(first + i, first + D(g, param_t(0, i)));
-        }
+public:
+    template <typename I, typename S, typename Pred, typename Proj = identity>
+    std::enable_if_t<bidirectional_iterator<I> && sentinel_for<S, I> &&
+                         indirect_unary_predicate<Pred, projected<I, Proj>> &&
+                         permutable<I>, subrange<I>>
+    operator()(I first, S last, Pred pred, Proj proj = Proj{}) const
+    {
+        return stable_partition_fn::impl(std::move(first), std::move(last),
+                                         pred, proj);
+    }
 
-        return next(first, last);
+    template <typename Rng, typename Pred, typename Proj = identity>
+    std::enable_if_t<
+        bidirectional_range<Rng> &&
+            indirect_unary_predicate<Pred, projected<iterator_t<Rng>, Proj>> &&
+            permutable<iterator_t<Rng>>,
+        borrowed_subrange_t<Rng>>
+    operator()(Rng&& rng, Pred pred, Proj proj = Proj{}) const
+    {
+        return stable_partition_fn::impl(nano::begin(rng), nano::end(rng),
+                                         pred, proj);
     }
 
-public:
-    template <typename I, typename S, typename Gen>
-    constexpr std::enable_if_t<
-        random_access_iterator<I> && sentinel_for<S, I> &&
-            uniform_random_bit_generator<std::remove_reference_t<Gen>> &&
-        convertible_to<invoke_result_t<Gen&>, iter_difference_t<I>>,
-        I>
-    operator()(I first, S last, Gen&& gen) const
+#if NANO_HAS_MEMORY_RESOURCE
+    // Extension: as above, but any scratch space is obtained from resource
+    template <typename I, typename S, typename Pred, typename Proj = identity>
+    std::enable_if_t<bidirectional_iterator<I> && sentinel_for<S, I> &&
+                         indirect_unary_predicate<Pred, projected<I, Proj>> &&
+                         permutable<I>, subrange<I>>
+    operator()(std::pmr::memory_resource* resource, I first, S last, Pred pred,
+               Proj proj = Proj{}) const
     {
-        return shuffle_fn::impl(std::move(first), std::move(last),
-                                std::forward<Gen>(gen));
+        return stable_partition_fn::impl(std::move(first), std::move(last),
+                                         pred, proj, resource);
     }
 
-    template <typename Rng, typename Gen>
-    constexpr std::enable_if_t<
-        random_access_range<Rng> &&
-            uniform_random_bit_generator<std::remove_reference_t<Gen>> &&
-            convertible_to<invoke_result_t<Gen&>, iter_difference_t<iterator_t<Rng>>>,
-        borrowed_iterator_t<Rng>>
-    operator()(Rng&& rng, Gen&& gen) const
+    template <typename Rng, typename Pred, typename Proj = identity>
+    std::enable_if_t<
+        bidirectional_range<Rng> &&
+            indirect_unary_predicate<Pred, projected<iterator_t<Rng>, Proj>> &&
+            permutable<iterator_t<Rng>>,
+        borrowed_subrange_t<Rng>>
+    operator()(std::pmr::memory_resource* resource, Rng&& rng, Pred pred,
+               Proj proj = Proj{}) const
     {
-        return shuffle_fn::impl(nano::begin(rng), nano::end(rng),
-                                std::forward<Gen>(gen));
+        return stable_partition_fn::impl(nano::begin(rng), nano::end(rng),
+                                         pred, proj, resource);
     }
+#endif
 };
 
 }
 
-NANO_INLINE_VAR(detail::shuffle_fn, shuffle)
+NANO_INLINE_VAR(detail::stable_partition_fn, stable_partition)
 
 NANO_END_NAMESPACE
 
 #endif
 
-// nanorange/algorithm/sort.hpp
-//
-// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
-// Distributed under the Boost Software License, Version 1.0. (See accompanying
-// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
-
-#ifndef NANORANGE_ALGORITHM_SORT_HPP_INCLUDED
-#define NANORANGE_ALGORITHM_SORT_HPP_INCLUDED
 
-// nanorange/detail/algorithm/pqdsort.hpp
+// nanorange/algorithm/static_search_index.hpp
 //
-// Copyright Orson Peters 2017.
 // Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
 // Distributed under the Boost Software License, Version 1.0. (See accompanying
 // file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
-// Modified from Boost.Sort by Orson Peters
-// https://github.com/boostorg/sort/blob/develop/include/boost/sort/pdqsort/pdqsort.hpp
-
-#ifndef NANORANGE_DETAIL_ALGORITHM_PDQSORT_HPP_INCLUDED
-#define NANORANGE_DETAIL_ALGORITHM_PDQSORT_HPP_INCLUDED
-
+#ifndef NANORANGE_ALGORITHM_STATIC_SEARCH_INDEX_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_STATIC_SEARCH_INDEX_HPP_INCLUDED
 
 
 
 
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
 
 NANO_BEGIN_NAMESPACE
 
-namespace detail {
-
-// Partitions below this size are sorted using insertion sort.
-constexpr int pdqsort_insertion_sort_threshold = 24;
-
-// Partitions above this size use Tukey's ninther to select the pivot.
-constexpr int pdqsort_ninther_threshold = 128;
-
-// When we detect an already sorted partition, attempt an insertion sort that
-// allows this amount of element moves before giving up.
-constexpr int pqdsort_partial_insertion_sort_limit = 8;
+// Extension: a read-only copy of a sorted range of keys, laid out so that
+// lookups touch as few cache lines as possible. With the Eytzinger layout the
+// keys are stored in breadth-first order of the implicit binary search tree,
+// so the first few levels of every search share a handful of hot cache lines,
+// and the descendants several levels down are contiguous and can be
+// prefetched. With the B-tree layout, each node of an implicit B-tree holds a
+// cache line's worth of keys, and a lookup reads one node per level.
+//
+// Lookups return the position of the result in the original sorted range
+// (that is, the number of keys before it), so they can be used to index a
+// parallel array of values. The keys must be sorted with respect to comp.
 
-// Must be multiple of 8 due to loop unrolling, and < 256 to fit in unsigned
-// char.
-constexpr int pdqsort_block_size = 64;
+enum class search_index_layout { eytzinger, btree };
 
-// Cacheline size, assumes power of two.
-constexpr int pdqsort_cacheline_size = 64;
+namespace detail {
 
-template <typename>
-struct is_default_compare : std::false_type {};
-template <>
-struct is_default_compare<nano::less> : std::true_type {};
-template <>
-struct is_default_compare<nano::greater> : std::true_type {};
-template <typename T>
-struct is_default_compare<std::less<T>> : std::true_type {};
+// The number of keys in a node of the B-tree layout
 template <typename T>
-struct is_default_compare<std::greater<T>> : std::true_type {};
+constexpr std::size_t search_index_block =
+    sizeof(T) >= 32 ? 2 : sizeof(T) > 4 ? 64 / sizeof(T) : 16;
 
+// How far the Eytzinger search prefetches: node k's descendants this many
+// times further down the tree start at index k * search_index_ahead, and are
+// adjacent. This is four levels for keys of up to 16 bytes, and fewer for
+// larger keys, so that no more than a few cache lines are fetched per step.
 template <typename T>
-constexpr bool is_default_compare_v = is_default_compare<T>::value;
-
-// Returns floor(log2(n)), assumes n > 0.
-template <class T>
-constexpr int log2(T n)
-{
-    int log = 0;
-    while (n >>= 1)
-        ++log;
-    return log;
-}
+constexpr std::size_t search_index_ahead =
+    sizeof(T) <= 16 ? 16 : sizeof(T) <= 32 ? 4 : 2;
 
-// Sorts [begin, end) using insertion sort with the given comparison function.
-template <typename I, typename Comp, typename Proj>
-constexpr void insertion_sort(I begin, I end, Comp& comp, Proj& proj)
+// Returns floor(log2(n)) + 1 for n > 0, and 0 for n == 0
+inline std::size_t search_index_bit_width(std::size_t n)
 {
-    using T = iter_value_t<I>;
-
-    if (begin == end) {
-        return;
-    }
-
-    for (I cur = begin + 1; cur != end; ++cur) {
-        I sift = cur;
-        I sift_1 = cur - 1;
-
-        // Compare first so we can avoid 2 moves for an element already
-        // positioned correctly.
-        if (nano::invoke(comp, nano::invoke(proj, *sift),
-                         nano::invoke(proj, *sift_1))) {
-            T tmp = nano::iter_move(sift);
-
-            do {
-                *sift-- = nano::iter_move(sift_1);
-            } while (sift != begin &&
-                     nano::invoke(comp, nano::invoke(proj, tmp),
-                                  nano::invoke(proj, *--sift_1)));
-
-            *sift = std::move(tmp);
-        }
+#if defined(__GNUC__) || defined(__clang__)
+    return n == 0 ? 0
+                  : std::numeric_limits<unsigned long long>::digits -
+                        static_cast<std::size_t>(__builtin_clzll(n));
+#else
+    std::size_t w = 0;
+    for (; n != 0; n >>= 1) {
+        ++w;
     }
+    return w;
+#endif
 }
 
-// Sorts [begin, end) using insertion sort with the given comparison function.
-// Assumes
-// *(begin - 1) is an element smaller than or equal to any element in [begin,
-// end).
-template <typename I, typename Comp, typename Proj>
-constexpr void unguarded_insertion_sort(I begin, I end, Comp& comp, Proj& proj)
+// Returns n with its trailing one bits, and the zero bit above them, removed
+inline std::size_t search_index_strip_ones(std::size_t n)
 {
-    using T = iter_value_t<I>;
-
-    if (begin == end) {
-        return;
-    }
-
-    for (I cur = begin + 1; cur != end; ++cur) {
-        I sift = cur;
-        I sift_1 = cur - 1;
-
-        // Compare first so we can avoid 2 moves for an element already
-        // positioned correctly.
-        if (nano::invoke(comp, nano::invoke(proj, *sift),
-                         nano::invoke(proj, *sift_1))) {
-            T tmp = nano::iter_move(sift);
-
-            do {
-                *sift-- = nano::iter_move(sift_1);
-            } while (nano::invoke(comp, nano::invoke(proj, tmp),
-                                  nano::invoke(proj, *--sift_1)));
-
-            *sift = std::move(tmp);
-        }
+#if defined(__GNUC__) || defined(__clang__)
+    return n >> (__builtin_ctzll(~static_cast<unsigned long long>(n)) + 1);
+#else
+    while (n & 1) {
+        n >>= 1;
     }
+    return n >> 1;
+#endif
 }
 
-// Attempts to use insertion sort on [begin, end). Will return false if more
-// than partial_insertion_sort_limit elements were moved, and abort sorting.
-// Otherwise it will successfully sort and return true.
-template <typename I, typename Comp, typename Proj>
-constexpr bool partial_insertion_sort(I begin, I end, Comp& comp, Proj& proj)
-{
-    using T = iter_value_t<I>;
-
-    if (begin == end) {
-        return true;
-    }
-
-    iter_difference_t<I> limit = 0;
-    for (I cur = begin + 1; cur != end; ++cur) {
-        if (limit > pqdsort_partial_insertion_sort_limit) {
-            return false;
-        }
-
-        I sift = cur;
-        I sift_1 = cur - 1;
-
-        // Compare first so we can avoid 2 moves for an element already
-        // positioned correctly.
-        if (nano::invoke(comp, nano::invoke(proj, *sift),
-                         nano::invoke(proj, *sift_1))) {
-            T tmp = nano::iter_move(sift);
-
-            do {
-                *sift-- = nano::iter_move(sift_1);
-            } while (sift != begin &&
-                     nano::invoke(comp, nano::invoke(proj, tmp),
-                                  nano::invoke(proj, *--sift_1)));
-
-            *sift = std::move(tmp);
-            limit += cur - sift;
-        }
-    }
+} // namespace detail
 
-    return true;
-}
+template <typename T, typename Comp = ranges::less>
+class static_search_index {
+    using block_size = std::integral_constant<std::size_t,
+                                              detail::search_index_block<T>>;
 
-template <typename I, typename Comp, typename Proj>
-constexpr void sort2(I a, I b, Comp& comp, Proj& proj)
-{
-    if (nano::invoke(comp, nano::invoke(proj, *b), nano::invoke(proj, *a))) {
-        nano::iter_swap(a, b);
-    }
-}
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using key_compare = Comp;
 
-// Sorts the elements *a, *b and *c using comparison function comp.
-template <typename I, typename Comp, typename Proj>
-constexpr void sort3(I a, I b, I c, Comp& comp, Proj& proj)
-{
-    sort2(a, b, comp, proj);
-    sort2(b, c, comp, proj);
-    sort2(a, b, comp, proj);
-}
+    static_search_index() = default;
 
-template <typename I>
-constexpr void swap_offsets(I first, I last, unsigned char* offsets_l,
-                            unsigned char* offsets_r, int num, bool use_swaps)
-{
-    using T = iter_value_t<I>;
-    if (use_swaps) {
-        // This case is needed for the descending distribution, where we need
-        // to have proper swapping for pdqsort to remain O(n).
-        for (int i = 0; i < num; ++i) {
-            nano::iter_swap(first + offsets_l[i], last - offsets_r[i]);
+    template <typename I, typename S, typename Proj = identity,
+              std::enable_if_t<input_iterator<I> && sentinel_for<S, I> &&
+                                   constructible_from<
+                                       T, indirect_result_t<Proj&, I>>,
+                               int> = 0>
+    static_search_index(
+        I first, S last,
+        search_index_layout layout = search_index_layout::eytzinger,
+        Comp comp = Comp{}, Proj proj = Proj{})
+        : comp_(std::move(comp)), layout_(layout)
+    {
+        std::vector<T> sorted;
+        for (; first != last; ++first) {
+            sorted.emplace_back(nano::invoke(proj, *first));
         }
-    } else if (num > 0) {
-        I l = first + offsets_l[0];
-        I r = last - offsets_r[0];
-        T tmp(nano::iter_move(l));
-        *l = nano::iter_move(r);
+        n_ = sorted.size();
 
-        for (int i = 1; i < num; ++i) {
-            l = first + offsets_l[i];
-            *r = nano::iter_move(l);
-            r = last - offsets_r[i];
-            *l = nano::iter_move(r);
+        if (layout_ == search_index_layout::eytzinger) {
+            build_eytzinger(sorted);
+        } else {
+            build_btree(sorted);
         }
-        *r = std::move(tmp);
     }
-}
-
-// Partitions [begin, end) around pivot *begin using comparison function comp.
-// Elements equal to the pivot are put in the right-hand partition. Returns the
-// position of the pivot after partitioning and whether the passed sequence
-// already was correctly partitioned. Assumes the pivot is a median of at least
-// 3 elements and that [begin, end) is at least insertion_sort_threshold long.
-// Uses branchless partitioning.
-template <typename I, typename Comp, typename Pred>
-constexpr std::pair<I, bool> partition_right_branchless(I begin, I end,
-                                                        Comp& comp, Pred& pred)
-{
-    using T = iter_value_t<I>;
 
-    // Move pivot into local for speed.
-    T pivot(nano::iter_move(begin));
-    I first = begin;
-    I last = end;
+    template <typename Rng, typename Proj = identity,
+              std::enable_if_t<
+                  input_range<Rng> &&
+                      constructible_from<
+                          T, indirect_result_t<Proj&, iterator_t<Rng>>>,
+                  int> = 0>
+    explicit static_search_index(
+        Rng&& rng, search_index_layout layout = search_index_layout::eytzinger,
+        Comp comp = Comp{}, Proj proj = Proj{})
+        : static_search_index(nano::begin(rng), nano::end(rng), layout,
+                              std::move(comp), std::move(proj))
+    {}
 
-    // Find the first element greater than or equal than the pivot (the median
-    // of 3 guarantees this exists).
-    while (nano::invoke(comp, nano::invoke(pred, *++first),
-                        nano::invoke(pred, pivot)))
-        ;
+    size_type size() const noexcept { return n_; }
 
-    // Find the first element strictly smaller than the pivot. We have to guard
-    // this search if there was no element before *first.
-    if (first - 1 == begin) {
-        while (first < last && !nano::invoke(comp, nano::invoke(pred, *--last),
-                                             nano::invoke(pred, pivot)))
-            ;
-    } else {
-        while (!nano::invoke(comp, nano::invoke(pred, *--last),
-                             nano::invoke(pred, pivot)))
-            ;
+    bool empty() const noexcept { return n_ == 0; }
+
+    search_index_layout layout() const noexcept { return layout_; }
+
+    // Returns the position of the first key which is not less than value,
+    // or size() if there is none
+    template <typename U>
+    size_type lower_bound(const U& value) const
+    {
+        return search([&](const T& key) {
+            return nano::invoke(comp_, key, value);
+        }).pos;
     }
 
-    // If the first pair of elements that should be swapped to partition are the
-    // same element, the passed in sequence already was correctly partitioned.
-    bool already_partitioned = first >= last;
-    if (!already_partitioned) {
-        nano::iter_swap(first, last);
-        ++first;
+    // Returns the position of the first key which is greater than value,
+    // or size() if there is none
+    template <typename U>
+    size_type upper_bound(const U& value) const
+    {
+        return search([&](const T& key) {
+            return !nano::invoke(comp_, value, key);
+        }).pos;
     }
 
-    // The following branchless partitioning is derived from "BlockQuicksort:
-    // How Branch Mispredictions don't affect Quicksort" by Stefan Edelkamp and
-    // Armin Weiss.
-    alignas(pdqsort_cacheline_size) unsigned char
-        offsets_l_storage[pdqsort_block_size] = {};
-    alignas(pdqsort_cacheline_size) unsigned char
-        offsets_r_storage[pdqsort_block_size] = {};
-    unsigned char* offsets_l = offsets_l_storage;
-    unsigned char* offsets_r = offsets_r_storage;
-    int num_l = 0, num_r = 0, start_l = 0, start_r = 0;
+    template <typename U>
+    bool contains(const U& value) const
+    {
+        const auto res = search([&](const T& key) {
+            return nano::invoke(comp_, key, value);
+        });
+        return res.key != nullptr && !nano::invoke(comp_, value, *res.key);
+    }
 
-    while (last - first > 2 * pdqsort_block_size) {
-        // Fill up offset blocks with elements that are on the wrong side.
-        if (num_l == 0) {
-            start_l = 0;
-            I it = first;
-            for (unsigned char i = 0; i < pdqsort_block_size;) {
-                offsets_l[num_l] = i++;
-                num_l += !nano::invoke(comp, nano::invoke(pred, *it),
-                                       nano::invoke(pred, pivot));
-                ++it;
-                offsets_l[num_l] = i++;
-                num_l += !nano::invoke(comp, nano::invoke(pred, *it),
-                                       nano::invoke(pred, pivot));
-                ++it;
-                offsets_l[num_l] = i++;
-                num_l += !nano::invoke(comp, nano::invoke(pred, *it),
-                                       nano::invoke(pred, pivot));
-                ++it;
-                offsets_l[num_l] = i++;
-                num_l += !nano::invoke(comp, nano::invoke(pred, *it),
-                                       nano::invoke(pred, pivot));
-                ++it;
-                offsets_l[num_l] = i++;
-                num_l += !nano::invoke(comp, nano::invoke(pred, *it),
-                                       nano::invoke(pred, pivot));
-                ++it;
-                offsets_l[num_l] = i++;
-                num_l += !nano::invoke(comp, nano::invoke(pred, *it),
-                                       nano::invoke(pred, pivot));
-                ++it;
-                offsets_l[num_l] = i++;
-                num_l += !nano::invoke(comp, nano::invoke(pred, *it),
-                                       nano::invoke(pred, pivot));
-                ++it;
-                offsets_l[num_l] = i++;
-                num_l += !nano::invoke(comp, nano::invoke(pred, *it),
-                                       nano::invoke(pred, pivot));
-                ++it;
-            }
-        }
-        if (num_r == 0) {
-            start_r = 0;
-            I it = last;
-            for (unsigned char i = 0; i < pdqsort_block_size;) {
-                offsets_r[num_r] = ++i;
-                num_r += nano::invoke(comp, nano::invoke(pred, *--it),
-                                      nano::invoke(pred, pivot));
-                offsets_r[num_r] = ++i;
-                num_r += nano::invoke(comp, nano::invoke(pred, *--it),
-                                      nano::invoke(pred, pivot));
-                offsets_r[num_r] = ++i;
-                num_r += nano::invoke(comp, nano::invoke(pred, *--it),
-                                      nano::invoke(pred, pivot));
-                offsets_r[num_r] = ++i;
-                num_r += nano::invoke(comp, nano::invoke(pred, *--it),
-                                      nano::invoke(pred, pivot));
-                offsets_r[num_r] = ++i;
-                num_r += nano::invoke(comp, nano::invoke(pred, *--it),
-                                      nano::invoke(pred, pivot));
-                offsets_r[num_r] = ++i;
-                num_r += nano::invoke(comp, nano::invoke(pred, *--it),
-                                      nano::invoke(pred, pivot));
-                offsets_r[num_r] = ++i;
-                num_r += nano::invoke(comp, nano::invoke(pred, *--it),
-                                      nano::invoke(pred, pivot));
-                offsets_r[num_r] = ++i;
-                num_r += nano::invoke(comp, nano::invoke(pred, *--it),
-                                      nano::invoke(pred, pivot));
-            }
-        }
+private:
+    struct search_result {
+        size_type pos;
+        const T* key;
+    };
 
-        // Swap elements and update block sizes and first/last boundaries.
-        int num = (nano::min)(num_l, num_r);
-        swap_offsets(first, last, offsets_l + start_l, offsets_r + start_r, num,
-                     num_l == num_r);
-        num_l -= num;
-        num_r -= num;
-        start_l += num;
-        start_r += num;
-        if (num_l == 0)
-            first += pdqsort_block_size;
-        if (num_r == 0)
-            last -= pdqsort_block_size;
+    // Returns the position in the sorted keys of node k (counting from one)
+    // of the Eytzinger layout. This is its in-order position in a perfect
+    // tree of the same height, less the number of leaves missing from the
+    // bottom level before it.
+    size_type eytzinger_rank(size_type k) const
+    {
+        const size_type depth = detail::search_index_bit_width(k) - 1;
+        const size_type padded = ((2 * (k - (size_type(1) << depth)) + 1)
+                                  << (height_ - 1 - depth)) - 1;
+        const size_type before = (padded + 1) / 2;
+        return padded - (before > leaves_ ? before - leaves_ : 0);
     }
 
-    iter_difference_t<I> l_size = 0, r_size = 0;
-    iter_difference_t<I> unknown_left =
-        (last - first) - ((num_r || num_l) ? pdqsort_block_size : 0);
-    if (num_r) {
-        // Handle leftover block by assigning the unknown elements to the other
-        // block.
-        l_size = unknown_left;
-        r_size = pdqsort_block_size;
-    } else if (num_l) {
-        l_size = pdqsort_block_size;
-        r_size = unknown_left;
-    } else {
-        // No leftover block, split the unknown elements in two blocks.
-        l_size = unknown_left / 2;
-        r_size = unknown_left - l_size;
+    void build_eytzinger(const std::vector<T>& sorted)
+    {
+        if (n_ > 0) {
+            height_ = detail::search_index_bit_width(n_);
+            leaves_ = n_ - ((size_type(1) << (height_ - 1)) - 1);
+        }
+        keys_.reserve(n_);
+        for (size_type k = 1; k <= n_; ++k) {
+            keys_.push_back(sorted[eytzinger_rank(k)]);
+        }
     }
 
-    // Fill offset buffers if needed.
-    if (unknown_left && !num_l) {
-        start_l = 0;
-        I it = first;
-        for (unsigned char i = 0; i < l_size;) {
-            offsets_l[num_l] = i++;
-            num_l += !nano::invoke(comp, nano::invoke(pred, *it),
-                                   nano::invoke(pred, pivot));
-            ++it;
+    // Numbers the slots of the subtree rooted at node k in order
+    void number_btree(size_type k, size_type blocks, size_type& next)
+    {
+        constexpr size_type B = block_size::value;
+        if (k >= blocks) {
+            return;
         }
-    }
-    if (unknown_left && !num_r) {
-        start_r = 0;
-        I it = last;
-        for (unsigned char i = 0; i < r_size;) {
-            offsets_r[num_r] = ++i;
-            num_r += nano::invoke(comp, nano::invoke(pred, *--it),
-                                  nano::invoke(pred, pivot));
+        for (size_type i = 0; i < B; ++i) {
+            number_btree(k * (B + 1) + i + 1, blocks, next);
+            ranks_[k * B + i] = next++;
         }
+        number_btree(k * (B + 1) + B + 1, blocks, next);
     }
 
-    int num = (nano::min)(num_l, num_r);
-    swap_offsets(first, last, offsets_l + start_l, offsets_r + start_r, num,
-                 num_l == num_r);
-    num_l -= num;
-    num_r -= num;
-    start_l += num;
-    start_r += num;
-    if (num_l == 0)
-        first += l_size;
-    if (num_r == 0)
-        last -= r_size;
-
-    // We have now fully identified [first, last)'s proper position. Swap the
-    // last elements.
-    if (num_l) {
-        offsets_l += start_l;
-        while (num_l--)
-            nano::iter_swap(first + offsets_l[num_l], --last);
-        first = last;
-    }
-    if (num_r) {
-        offsets_r += start_r;
-        while (num_r--)
-            nano::iter_swap(last - offsets_r[num_r], first), ++first;
-        last = first;
-    }
+    // The slots at the end of the in-order numbering which are left over
+    // once the keys run out are filled with copies of the largest key. This
+    // keeps every node full without changing the result of any search.
+    void build_btree(const std::vector<T>& sorted)
+    {
+        constexpr size_type B = block_size::value;
+        const size_type blocks = (n_ + B - 1) / B;
+        ranks_.resize(blocks * B);
 
-    // Put the pivot in the right place.
-    I pivot_pos = first - 1;
-    *begin = nano::iter_move(pivot_pos);
-    *pivot_pos = std::move(pivot);
+        size_type next = 0;
+        number_btree(0, blocks, next);
 
-    return std::make_pair(std::move(pivot_pos), already_partitioned);
-}
+        keys_.reserve(ranks_.size());
+        for (size_type rank : ranks_) {
+            keys_.push_back(sorted[rank < n_ ? rank : n_ - 1]);
+        }
+    }
 
-// Partitions [begin, end) around pivot *begin using comparison function comp.
-// Elements equal to the pivot are put in the right-hand partition. Returns the
-// position of the pivot after partitioning and whether the passed sequence
-// already was correctly partitioned. Assumes the pivot is a median of at least
-// 3 elements and that [begin, end) is at least insertion_sort_threshold long.
-template <typename I, typename Comp, typename Proj>
-constexpr std::pair<I, bool> partition_right(I begin, I end, Comp& comp,
-                                             Proj& proj)
-{
-    using T = iter_value_t<I>;
+    template <typename Pred>
+    search_result search(Pred pred) const
+    {
+        return layout_ == search_index_layout::eytzinger
+                   ? search_eytzinger(pred)
+                   : search_btree(pred);
+    }
 
-    // Move pivot into local for speed.
-    T pivot(nano::iter_move(begin));
+    // Descends the tree without branching on the comparisons, prefetching
+    // the descendants of the current node a few levels down (see
+    // search_index_ahead). The path taken is recorded in the bits of k: the
+    // result is the last node at which we went left, which is found by
+    // stripping the trailing rights.
+    template <typename Pred>
+    search_result search_eytzinger(Pred& pred) const
+    {
+        constexpr size_type ahead = detail::search_index_ahead<T>;
+        constexpr size_type span = ahead * sizeof(T);
+        const T* const keys = keys_.data();
+
+        size_type k = 1;
+        while (k <= n_) {
+            // Past the bottom of the tree this points beyond the keys, which
+            // is harmless for a prefetch. Working in integers avoids forming
+            // an out-of-bounds pointer.
+            const auto descendants = reinterpret_cast<std::uintptr_t>(keys) +
+                                     (k * ahead - 1) * sizeof(T);
+            for (size_type i = 0; i < span; i += 64) {
+                detail::simd_prefetch(
+                    reinterpret_cast<const void*>(descendants + i));
+            }
+            detail::simd_prefetch(
+                reinterpret_cast<const void*>(descendants + span - 1));
+            k = 2 * k + (pred(keys[k - 1]) ? 1 : 0);
+        }
 
-    I first = begin;
-    I last = end;
+        k = detail::search_index_strip_ones(k);
 
-    // Find the first element greater than or equal than the pivot (the median
-    // of 3 guarantees this exists).
-    while (nano::invoke(comp, nano::invoke(proj, *++first),
-                        nano::invoke(proj, pivot))) {
+        if (k == 0) {
+            return {n_, nullptr};
+        }
+        return {eytzinger_rank(k), keys + (k - 1)};
     }
 
-    // Find the first element strictly smaller than the pivot. We have to guard
-    // this search if there was no element before *first.
-    if (first - 1 == begin) {
-        while (first < last && !nano::invoke(comp, nano::invoke(proj, *--last),
-                                             nano::invoke(proj, pivot))) {
+    // Counts the keys in each node which satisfy pred, without branching,
+    // and descends to the child between them and the rest
+    template <typename Pred>
+    search_result search_btree(Pred& pred) const
+    {
+        constexpr size_type B = block_size::value;
+        const T* const keys = keys_.data();
+        const size_type blocks = keys_.size() / B;
+
+        size_type slot = keys_.size();
+        size_type k = 0;
+        while (k < blocks) {
+            const T* const node = keys + k * B;
+            size_type i = 0;
+            for (size_type j = 0; j < B; ++j) {
+                i += pred(node[j]) ? 1 : 0;
+            }
+            slot = i < B ? k * B + i : slot;
+            k = k * (B + 1) + i + 1;
         }
-    } else {
-        while (!nano::invoke(comp, nano::invoke(proj, *--last),
-                             nano::invoke(proj, pivot))) {
+
+        // A padding slot is only found when every real key is before it
+        if (slot == keys_.size() || ranks_[slot] >= n_) {
+            return {n_, nullptr};
         }
+        return {ranks_[slot], keys + slot};
     }
 
-    // If the first pair of elements that should be swapped to partition are the
-    // same element, the passed in sequence already was correctly partitioned.
-    bool already_partitioned = first >= last;
+    std::vector<T> keys_{};
+    // For the B-tree layout, the position of each slot's key in the sorted
+    // keys. Padding slots are numbered from size() upwards.
+    std::vector<size_type> ranks_{};
+    size_type n_ = 0;
+    // For the Eytzinger layout, the height of the tree and the number of
+    // nodes on its bottom level
+    size_type height_ = 0;
+    size_type leaves_ = 0;
+    NANO_NO_UNIQUE_ADDRESS Comp comp_{};
+    search_index_layout layout_ = search_index_layout::eytzinger;
+};
+
+template <typename I, typename S, typename Comp = ranges::less,
+          typename Proj = identity,
+          std::enable_if_t<input_iterator<I> && sentinel_for<S, I>, int> = 0>
+static_search_index(I, S, search_index_layout = search_index_layout::eytzinger,
+                    Comp = Comp{}, Proj = Proj{})
+    -> static_search_index<iter_value_t<projected<I, Proj>>, Comp>;
+
+template <typename Rng, typename Comp = ranges::less, typename Proj = identity,
+          std::enable_if_t<input_range<Rng>, int> = 0>
+static_search_index(Rng&&, search_index_layout = search_index_layout::eytzinger,
+                    Comp = Comp{}, Proj = Proj{})
+    -> static_search_index<iter_value_t<projected<iterator_t<Rng>, Proj>>,
+                           Comp>;
+
+NANO_END_NAMESPACE
+
+#endif
 
-    // Keep swapping pairs of elements that are on the wrong side of the pivot.
-    // Previously swapped pairs guard the searches, which is why the first
-    // iteration is special-cased above.
-    while (first < last) {
-        nano::iter_swap(first, last);
-        while (nano::invoke(comp, nano::invoke(proj, *++first),
-                            nano::invoke(proj, pivot)))
-            ;
-        while (!nano::invoke(comp, nano::invoke(proj, *--last),
-                             nano::invoke(proj, pivot)))
-            ;
-    }
 
-    // Put the pivot in the right place.
-    I pivot_pos = first - 1;
-    *begin = nano::iter_move(pivot_pos);
-    *pivot_pos = std::move(pivot);
+// nanorange/algorithm/transform.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
-    return std::make_pair(std::move(pivot_pos), already_partitioned);
-}
+#ifndef NANORANGE_ALGORITHM_TRANSFORM_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_TRANSFORM_HPP_INCLUDED
 
-// Similar function to the one above, except elements equal to the pivot are put
-// to the left of the pivot and it doesn't check or return if the passed
-// sequence already was partitioned. Since this is rarely used (the many equal
-// case), and in that case pdqsort already has O(n) performance, no block
-// quicksort is applied here for simplicity.
-template <typename I, typename Comp, typename Proj>
-constexpr I partition_left(I begin, I end, Comp& comp, Proj& proj)
-{
-    using T = iter_value_t<I>;
 
-    T pivot(nano::iter_move(begin));
-    I first = begin;
-    I last = end;
 
-    while (nano::invoke(comp, nano::invoke(proj, pivot),
-                        nano::invoke(proj, *--last)))
-        ;
 
-    if (last + 1 == end) {
-        while (first < last && !nano::invoke(comp, nano::invoke(proj, pivot),
-                                             nano::invoke(proj, *++first)))
-            ;
-    } else {
-        while (!nano::invoke(comp, nano::invoke(proj, pivot),
-                             nano::invoke(proj, *++first)))
-            ;
-    }
 
-    while (first < last) {
-        nano::iter_swap(first, last);
-        while (nano::invoke(comp, nano::invoke(proj, pivot),
-                            nano::invoke(proj, *--last)))
-            ;
-        while (!nano::invoke(comp, nano::invoke(proj, pivot),
-                             nano::invoke(proj, *++first)))
-            ;
-    }
 
-    I pivot_pos = last;
-    *begin = nano::iter_move(pivot_pos);
-    *pivot_pos = std::move(pivot);
 
-    return pivot_pos;
-}
+NANO_BEGIN_NAMESPACE
 
-template <bool Branchless, typename I, typename Comp, typename Proj>
-constexpr void pdqsort_loop(I begin, I end, Comp& comp, Proj& proj,
-                            int bad_allowed, bool leftmost = true)
-{
-    using diff_t = iter_difference_t<I>;
+template <typename I, typename O>
+using unary_transform_result = in_out_result<I, O>;
 
-    // Use a while loop for tail recursion elimination.
-    while (true) {
-        diff_t size = nano::distance(begin, end);
+template <typename I1, typename I2, typename O>
+using binary_transform_result  = in_in_out_result<I1, I2, O>;
 
-        // Insertion sort is faster for small arrays.
-        if (size < pdqsort_insertion_sort_threshold) {
-            if (leftmost) {
-                insertion_sort(begin, end, comp, proj);
-            } else {
-                unguarded_insertion_sort(begin, end, comp, proj);
-            }
-            return;
-        }
+namespace detail {
 
-        // Choose pivot as median of 3 or pseudomedian of 9.
-        diff_t s2 = size / 2;
-        if (size > pdqsort_ninther_threshold) {
-            sort3(begin, begin + s2, end - 1, comp, proj);
-            sort3(begin + 1, begin + (s2 - 1), end - 2, comp, proj);
-            sort3(begin + 2, begin + (s2 + 1), end - 3, comp, proj);
-            sort3(begin + (s2 - 1), begin + s2, begin + (s2 + 1), comp, proj);
-            nano::iter_swap(begin, begin + s2);
-        } else {
-            sort3(begin + s2, begin, end - 1, comp, proj);
+struct transform_fn {
+private:
+    template <typename I, typename S, typename O, typename F, typename Proj>
+    static constexpr unary_transform_result<I, O>
+    unary_impl(I first, S last, O result, F& op, Proj& proj)
+    {
+        while (first != last) {
+            *result = nano::invoke(op, nano::invoke(proj, *first));
+            ++first;
+            ++result;
         }
 
-        // If *(begin - 1) is the end of the right partition of a previous
-        // partition operation there is no element in [begin, end) that is
-        // smaller than *(begin - 1). Then if our pivot compares equal to
-        // *(begin - 1) we change strategy, putting equal elements in the left
-        // partition, greater elements in the right partition. We do not have to
-        // recurse on the left partition, since it's sorted (all equal).
-        if (!leftmost && !nano::invoke(comp, nano::invoke(proj, *(begin - 1)),
-                                       nano::invoke(proj, *begin))) {
-            begin = partition_left(begin, end, comp, proj) + 1;
-            continue;
-        }
+        return {std::move(first), std::move(result)};
+    }
 
-        // Partition and get results.
-        std::pair<I, bool> part_result =
-            Branchless ? partition_right_branchless(begin, end, comp, proj)
-                       : partition_right(begin, end, comp, proj);
-        I pivot_pos = part_result.first;
-        bool already_partitioned = part_result.second;
+    template <typename I1, typename S1, typename I2, typename O, typename F,
+              typename Proj1, typename Proj2>
+    static constexpr binary_transform_result<I1, I2, O>
+    binary_impl3(I1 first1, S1 last1, I2 first2, O result, F& op, Proj1& proj1,
+                 Proj2& proj2)
+    {
+        while (first1 != last1) {
+            *result = nano::invoke(op, nano::invoke(proj1, *first1),
+                                   nano::invoke(proj2, *first2));
+            ++first1;
+            ++first2;
+            ++result;
+        }
 
-        // Check for a highly unbalanced partition.
-        diff_t l_size = pivot_pos - begin;
-        diff_t r_size = end - (pivot_pos + 1);
-        bool highly_unbalanced = l_size < size / 8 || r_size < size / 8;
+        return {std::move(first1), std::move(first2), std::move(result)};
+    }
 
-        // If we got a highly unbalanced partition we shuffle elements to break
-        // many patterns.
-        if (highly_unbalanced) {
-            // If we had too many bad partitions, switch to heapsort to
-            // guarantee O(n log n).
-            if (--bad_allowed == 0) {
-                nano::make_heap(begin, end, comp, proj);
-                nano::sort_heap(begin, end, comp, proj);
-                return;
-            }
+    template <typename I1, typename S1, typename I2, typename S2, typename O,
+              typename F, typename Proj1, typename Proj2>
+    static constexpr binary_transform_result<I1, I2, O>
+    binary_impl4(I1 first1, S1 last1, I2 first2, S2 last2, O result, F& op,
+                 Proj1& proj1, Proj2& proj2)
+    {
+        while (first1 != last1 && first2 != last2) {
+            *result = nano::invoke(op, nano::invoke(proj1, *first1),
+                                   nano::invoke(proj2, *first2));
+            ++first1;
+            ++first2;
+            ++result;
+        }
 
-            if (l_size >= pdqsort_insertion_sort_threshold) {
-                nano::iter_swap(begin, begin + l_size / 4);
-                nano::iter_swap(pivot_pos - 1, pivot_pos - l_size / 4);
+        return {std::move(first1), std::move(first2), std::move(result)};
+    }
 
-                if (l_size > pdqsort_ninther_threshold) {
-                    nano::iter_swap(begin + 1, begin + (l_size / 4 + 1));
-                    nano::iter_swap(begin + 2, begin + (l_size / 4 + 2));
-                    nano::iter_swap(pivot_pos - 2,
-                                    pivot_pos - (l_size / 4 + 1));
-                    nano::iter_swap(pivot_pos - 3,
-                                    pivot_pos - (l_size / 4 + 2));
-                }
+    // With a parallel policy, sized random-access ranges are split into
+    // chunks, each of which is processed using its own copy of op
+    template <typename EP, typename I, typename S, typename O, typename F,
+              typename Proj>
+    static unary_transform_result<I, O>
+    unary_impl(EP&&, I first, S last, O result, F& op, Proj& proj)
+    {
+        if constexpr (is_parallel_policy_v<EP> && random_access_iterator<I> &&
+                      sized_sentinel_for<S, I> && random_access_iterator<O>) {
+            const auto n = static_cast<std::ptrdiff_t>(last - first);
+            constexpr auto chunk = parallel_chunk_size<iter_value_t<I>>;
+            if (detail::use_parallel_chunks(n, chunk)) {
+                detail::parallel_for_chunks(
+                    n, chunk, [&](std::ptrdiff_t b, std::ptrdiff_t e) {
+                        F f = op;
+                        unary_impl(first + b, first + e, result + b, f, proj);
+                    });
+                return {first + n, result + n};
             }
-
-            if (r_size >= pdqsort_insertion_sort_threshold) {
-                nano::iter_swap(pivot_pos + 1, pivot_pos + (1 + r_size / 4));
-                nano::iter_swap(end - 1, end - r_size / 4);
-
-                if (r_size > pdqsort_ninther_threshold) {
-                    nano::iter_swap(pivot_pos + 2,
-                                    pivot_pos + (2 + r_size / 4));
-                    nano::iter_swap(pivot_pos + 3,
-                                    pivot_pos + (3 + r_size / 4));
-                    nano::iter_swap(end - 2, end - (1 + r_size / 4));
-                    nano::iter_swap(end - 3, end - (2 + r_size / 4));
-                }
+        }
+        return unary_impl(std::move(first), std::move(last), std::move(result),
+                          op, proj);
+    }
+
+    template <typename EP, typename I1, typename S1, typename I2, typename S2,
+              typename O, typename F, typename Proj1, typename Proj2>
+    static binary_transform_result<I1, I2, O>
+    binary_impl4(EP&&, I1 first1, S1 last1, I2 first2, S2 last2, O result,
+                 F& op, Proj1& proj1, Proj2& proj2)
+    {
+        if constexpr (is_parallel_policy_v<EP> && random_access_iterator<I1> &&
+                      sized_sentinel_for<S1, I1> &&
+                      random_access_iterator<I2> &&
+                      sized_sentinel_for<S2, I2> && random_access_iterator<O>) {
+            const auto n = (nano::min)(static_cast<std::ptrdiff_t>(last1 - first1),
+                                       static_cast<std::ptrdiff_t>(last2 - first2));
+            constexpr auto chunk = parallel_chunk_size<iter_value_t<I1>>;
+            if (detail::use_parallel_chunks(n, chunk)) {
+                detail::parallel_for_chunks(
+                    n, chunk, [&](std::ptrdiff_t b, std::ptrdiff_t e) {
+                        F f = op;
+                        binary_impl3(first1 + b, first1 + e, first2 + b,
+                                     result + b, f, proj1, proj2);
+                    });
+                return {first1 + n, first2 + n, result + n};
             }
-        } else {
-            // If we were decently balanced and we tried to sort an already
-            // partitioned sequence try to use insertion sort.
-            if (already_partitioned &&
-                partial_insertion_sort(begin, pivot_pos, comp, proj) &&
-                partial_insertion_sort(pivot_pos + 1, end, comp, proj))
-                return;
         }
+        return binary_impl4(std::move(first1), std::move(last1),
+                            std::move(first2), std::move(last2),
+                            std::move(result), op, proj1, proj2);
+    }
 
-        // Sort the left partition first using recursion and do tail recursion
-        // elimination for the right-hand partition.
-        detail::pdqsort_loop<Branchless>(begin, pivot_pos, comp, proj,
-                                         bad_allowed, leftmost);
-        begin = pivot_pos + 1;
-        leftmost = false;
+public:
+    // Unary op, iterators
+    template <typename I, typename S, typename O, typename F,
+              typename Proj = identity>
+    constexpr std::enable_if_t<
+        input_iterator<I> && sentinel_for<S, I> && weakly_incrementable<O> &&
+            copy_constructible<F> &&
+            writable<O, indirect_result_t<F&, projected<I, Proj>>>,
+        unary_transform_result<I, O>>
+    operator()(I first, S last, O result, F op, Proj proj = Proj{}) const
+    {
+        return transform_fn::unary_impl(std::move(first), std::move(last),
+                                        std::move(result), op, proj);
     }
-}
 
-template <typename I, typename Comp, typename Proj,
-          bool Branchless = is_default_compare_v<std::remove_const_t<Comp>>&&
-              same_as<Proj, identity>&& std::is_arithmetic<iter_value_t<I>>::value>
-constexpr void pdqsort(I begin, I end, Comp& comp, Proj& proj)
-{
-    if (begin == end) {
-        return;
+    // Unary op, range
+    template <typename Rng, typename O, typename F, typename Proj = identity>
+    constexpr std::enable_if_t<
+        input_range<Rng> && weakly_incrementable<O> && copy_constructible<F> &&
+            writable<O,
+                     indirect_result_t<F&, projected<iterator_t<Rng>, Proj>>>,
+        unary_transform_result<borrowed_iterator_t<Rng>, O>>
+    operator()(Rng&& rng, O result, F op, Proj proj = Proj{}) const
+    {
+        return transform_fn::unary_impl(nano::begin(rng), nano::end(rng),
+                                        std::move(result), op, proj);
+    }
+
+    // Binary op, four-legged
+    template <typename I1, typename S1, typename I2, typename S2, typename O,
+              typename F, typename Proj1 = identity, typename Proj2 = identity>
+    constexpr std::enable_if_t<
+        input_iterator<I1> && sentinel_for<S1, I1> && input_iterator<I2> &&
+            sentinel_for<S2, I2> && weakly_incrementable<O> &&
+            copy_constructible<F> &&
+            writable<O, indirect_result_t<F&, projected<I1, Proj1>,
+                                          projected<I2, Proj2>>>,
+        binary_transform_result<I1, I2, O>>
+    operator()(I1 first1, S1 last1, I2 first2, S2 last2, O result, F op,
+               Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
+    {
+        return transform_fn::binary_impl4(std::move(first1), std::move(last1),
+                                          std::move(first2), std::move(last2),
+                                          std::move(result), op, proj1, proj2);
+    }
+
+    // Binary op, two ranges
+    template <typename Rng1, typename Rng2, typename O, typename F,
+              typename Proj1 = identity, typename Proj2 = identity>
+    constexpr std::enable_if_t<
+        input_range<Rng1> && input_range<Rng2> && weakly_incrementable<O> &&
+            copy_constructible<F> &&
+            writable<O,
+                     indirect_result_t<F&, projected<iterator_t<Rng1>, Proj1>,
+                                       projected<iterator_t<Rng2>, Proj2>>>,
+        binary_transform_result<borrowed_iterator_t<Rng1>,
+                                borrowed_iterator_t<Rng2>, O>>
+    operator()(Rng1&& rng1, Rng2&& rng2, O result, F op, Proj1 proj1 = Proj1{},
+               Proj2 proj2 = Proj2{}) const
+    {
+        return transform_fn::binary_impl4(nano::begin(rng1), nano::end(rng1),
+                                          nano::begin(rng2), nano::end(rng2),
+                                          std::move(result), op, proj1, proj2);
     }
 
-    detail::pdqsort_loop<Branchless>(std::move(begin), std::move(end), comp,
-                                     proj,
-                                     detail::log2(nano::distance(begin, end)));
-}
-
-} // namespace detail
-
-NANO_END_NAMESPACE
+    // Binary op, three-legged
+    template <typename I1, typename S1, typename I2, typename O, typename F,
+              typename Proj1 = identity, typename Proj2 = identity>
+    NANO_DEPRECATED constexpr std::enable_if_t<
+        input_iterator<I1> && sentinel_for<S1, I1> &&
+            input_iterator<std::decay_t<I2>> &&
+            !input_range<I2> &&
+            weakly_incrementable<O> && copy_constructible<F> &&
+            writable<O, indirect_result_t<F&, projected<I1, Proj1>,
+                                          projected<std::decay_t<I2>, Proj2>>>,
+        binary_transform_result<I1, std::decay_t<I2>, O>>
+    operator()(I1 first1, S1 last1, I2&& first2, O result, F op,
+               Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
+    {
+        return transform_fn::binary_impl3(std::move(first1), std::move(last1),
+                                          std::forward<I2>(first2), std::move(result),
+                                          op, proj1, proj2);
+    }
 
-#endif
+    // binary op, range-and-a-half
+    template <typename Rng1, typename I2, typename O, typename F,
+              typename Proj1 = identity, typename Proj2 = identity>
+    NANO_DEPRECATED constexpr std::enable_if_t<
+        input_range<Rng1> && input_iterator<std::decay_t<I2>> &&
+                !input_range<I2> && weakly_incrementable<O> &&
+            copy_constructible<F> &&
+            writable<O,
+                     indirect_result_t<F&, projected<iterator_t<Rng1>, Proj1>,
+                                       projected<std::decay_t<I2>, Proj2>>>,
+        binary_transform_result<borrowed_iterator_t<Rng1>, std::decay_t<I2>, O>>
+    operator()(Rng1&& rng1, I2&& first2, O result, F op, Proj1 proj1 = Proj1{},
+               Proj2 proj2 = Proj2{}) const
+    {
+        return transform_fn::binary_impl3(nano::begin(rng1), nano::end(rng1),
+                                          std::forward<I2>(first2), std::move(result),
+                                          op, proj1, proj2);
+    }
 
-NANO_BEGIN_NAMESPACE
+    // Extension: unary op, policy and iterators
+    template <typename EP, typename I, typename S, typename O, typename F,
+              typename Proj = identity>
+    std::enable_if_t<
+        is_execution_policy_v<remove_cvref_t<EP>> && forward_iterator<I> &&
+            sentinel_for<S, I> && weakly_incrementable<O> &&
+            copy_constructible<F> &&
+            writable<O, indirect_result_t<F&, projected<I, Proj>>>,
+        unary_transform_result<I, O>>
+    operator()(EP&& policy, I first, S last, O result, F op,
+               Proj proj = Proj{}) const
+    {
+        return transform_fn::unary_impl(std::forward<EP>(policy),
+                                        std::move(first), std::move(last),
+                                        std::move(result), op, proj);
+    }
 
-namespace detail {
+    // Extension: unary op, policy and range
+    template <typename EP, typename Rng, typename O, typename F,
+              typename Proj = identity>
+    std::enable_if_t<
+        is_execution_policy_v<remove_cvref_t<EP>> && forward_range<Rng> &&
+            weakly_incrementable<O> && copy_constructible<F> &&
+            writable<O,
+                     indirect_result_t<F&, projected<iterator_t<Rng>, Proj>>>,
+        unary_transform_result<borrowed_iterator_t<Rng>, O>>
+    operator()(EP&& policy, Rng&& rng, O result, F op, Proj proj = Proj{}) const
+    {
+        return transform_fn::unary_impl(std::forward<EP>(policy),
+                                        nano::begin(rng), nano::end(rng),
+                                        std::move(result), op, proj);
+    }
 
-struct sort_fn {
-    template <typename I, typename S, typename Comp = ranges::less, typename Proj = identity>
-    constexpr std::enable_if_t<random_access_iterator<I> && sentinel_for<S, I> &&
-                                   sortable<I, Comp, Proj>, I>
-    operator()(I first, S last, Comp comp = Comp{}, Proj proj = Proj{}) const
+    // Extension: binary op, policy and four-legged
+    template <typename EP, typename I1, typename S1, typename I2, typename S2,
+              typename O, typename F, typename Proj1 = identity,
+              typename Proj2 = identity>
+    std::enable_if_t<
+        is_execution_policy_v<remove_cvref_t<EP>> && forward_iterator<I1> &&
+            sentinel_for<S1, I1> && forward_iterator<I2> &&
+            sentinel_for<S2, I2> && weakly_incrementable<O> &&
+            copy_constructible<F> &&
+            writable<O, indirect_result_t<F&, projected<I1, Proj1>,
+                                          projected<I2, Proj2>>>,
+        binary_transform_result<I1, I2, O>>
+    operator()(EP&& policy, I1 first1, S1 last1, I2 first2, S2 last2, O result,
+               F op, Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
     {
-        I last_it = nano::next(first, last);
-        detail::pdqsort(std::move(first), last_it, comp, proj);
-        return last_it;
+        return transform_fn::binary_impl4(std::forward<EP>(policy),
+                                          std::move(first1), std::move(last1),
+                                          std::move(first2), std::move(last2),
+                                          std::move(result), op, proj1, proj2);
     }
 
-    template <typename Rng, typename Comp = ranges::less, typename Proj = identity>
-    constexpr std::enable_if_t<random_access_range<Rng> &&
-                                   sortable<iterator_t<Rng>, Comp, Proj>,
-                               borrowed_iterator_t<Rng>>
-    operator()(Rng&& rng, Comp comp = Comp{}, Proj proj = Proj{}) const
+    // Extension: binary op, policy and two ranges
+    template <typename EP, typename Rng1, typename Rng2, typename O, typename F,
+              typename Proj1 = identity, typename Proj2 = identity>
+    std::enable_if_t<
+        is_execution_policy_v<remove_cvref_t<EP>> && forward_range<Rng1> &&
+            forward_range<Rng2> && weakly_incrementable<O> &&
+            copy_constructible<F> &&
+            writable<O,
+                     indirect_result_t<F&, projected<iterator_t<Rng1>, Proj1>,
+                                       projected<iterator_t<Rng2>, Proj2>>>,
+        binary_transform_result<borrowed_iterator_t<Rng1>,
+                                borrowed_iterator_t<Rng2>, O>>
+    operator()(EP&& policy, Rng1&& rng1, Rng2&& rng2, O result, F op,
+               Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
     {
-        iterator_t<Rng> last_it = nano::next(nano::begin(rng), nano::end(rng));
-        detail::pdqsort(nano::begin(rng), last_it, comp, proj);
-        return last_it;
+        return transform_fn::binary_impl4(std::forward<EP>(policy),
+                                          nano::begin(rng1), nano::end(rng1),
+                                          nano::begin(rng2), nano::end(rng2),
+                                          std::move(result), op, proj1, proj2);
     }
 };
 
-}
+} // namespace detail
 
-NANO_INLINE_VAR(detail::sort_fn, sort)
+NANO_INLINE_VAR(detail::transform_fn, transform)
 
 NANO_END_NAMESPACE
 
 #endif
 
-
-// nanorange/algorithm/stl/stable_partition.hpp
+// nanorange/algorithm/transform_reduce.hpp
 //
-// Copyright (c) 2019 Tristan Brindle (tcbrindle at gmail dot com)
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
 // Distributed under the Boost Software License, Version 1.0. (See accompanying
 // file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
-//===-------------------------- algorithm ---------------------------------===//
-//
-//                     The LLVM Compiler Infrastructure
-//
-// This file is dual licensed under the MIT and the University of Illinois Open
-// Source Licenses. See LICENSE.TXT for details.
-//
-//===----------------------------------------------------------------------===//
+#ifndef NANORANGE_ALGORITHM_TRANSFORM_REDUCE_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_TRANSFORM_REDUCE_HPP_INCLUDED
 
-#ifndef NANORANGE_ALGORITHM_STABLE_PARTITION_HPP_INCLUDED
-#define NANORANGE_ALGORITHM_STABLE_PARTITION_HPP_INCLUDED
 
 
 
+NANO_BEGIN_NAMESPACE
+
+// Extension: see reduce.hpp
 
+namespace detail {
 
+template <typename Void, typename ROp, typename T, typename TOp,
+          typename... Is>
+struct transform_reduce_traits {
+    static constexpr bool value = false;
+    static constexpr bool parallel = false;
+};
 
+// Whether init = rop(std::move(init), top(*i...)) is valid, where each i is
+// an iterator of the corresponding type in Is
+template <typename ROp, typename T, typename TOp, typename... Is>
+struct transform_reduce_traits<
+    std::enable_if_t<invocable<TOp&, iter_reference_t<Is>...>>, ROp, T, TOp,
+    Is...> {
+    using element_type = invoke_result_t<TOp&, iter_reference_t<Is>...>;
 
+    static constexpr bool value = is_reduction_op<ROp, T, element_type>;
+    static constexpr bool parallel =
+        is_parallel_reduction_op<ROp, T, element_type>;
+};
 
+struct transform_reduce_fn {
+private:
+    // Applies the transformation to the projected element, so that the
+    // unary form can be reduced with reduce_fn::impl()
+    template <typename TOp, typename Proj>
+    struct transform_proj {
+        TOp& op;
+        Proj& proj;
 
+        template <typename T>
+        constexpr decltype(auto) operator()(T&& t) const
+        {
+            return nano::invoke(op, nano::invoke(proj, std::forward<T>(t)));
+        }
+    };
 
+    template <typename I1, typename S1, typename I2, typename S2, typename T,
+              typename ROp, typename BOp, typename Proj1, typename Proj2>
+    static constexpr T binary_impl(I1 first1, S1 last1, I2 first2, S2 last2,
+                                   T init, ROp& rop, BOp& bop, Proj1& proj1,
+                                   Proj2& proj2)
+    {
+        while (first1 != last1 && first2 != last2) {
+            init = nano::invoke(rop, std::move(init),
+                                nano::invoke(bop, nano::invoke(proj1, *first1),
+                                             nano::invoke(proj2, *first2)));
+            ++first1;
+            ++first2;
+        }
+        return init;
+    }
+
+    template <typename EP, typename I1, typename S1, typename I2, typename S2,
+              typename T, typename ROp, typename BOp, typename Proj1,
+              typename Proj2>
+    static T binary_impl(EP&&, I1 first1, S1 last1, I2 first2, S2 last2,
+                         T init, ROp& rop, BOp& bop, Proj1& proj1, Proj2& proj2)
+    {
+        if constexpr (is_parallel_chunkable<EP, I1, S1> &&
+                      is_parallel_chunkable<EP, I2, S2>) {
+            const auto n = (nano::min)(static_cast<std::ptrdiff_t>(last1 - first1),
+                                       static_cast<std::ptrdiff_t>(last2 - first2));
+            constexpr auto chunk = parallel_chunk_size<iter_value_t<I1>>;
+            if (detail::use_parallel_chunks(n, chunk)) {
+                return detail::parallel_reduce_chunks(
+                    n, chunk, std::move(init), rop,
+                    [&](std::ptrdiff_t b, std::ptrdiff_t e) {
+                        I1 it1 = first1 + b;
+                        I2 it2 = first2 + b;
+                        T acc(nano::invoke(bop, nano::invoke(proj1, *it1),
+                                           nano::invoke(proj2, *it2)));
+                        return binary_impl(++it1, first1 + e, ++it2,
+                                           first2 + e, std::move(acc), rop,
+                                           bop, proj1, proj2);
+                    });
+            }
+        }
+        return binary_impl(std::move(first1), std::move(last1),
+                           std::move(first2), std::move(last2),
+                           std::move(init), rop, bop, proj1, proj2);
+    }
 
+public:
+    // Unary op, iterators
+    template <typename I, typename S, typename T, typename ROp, typename TOp,
+              typename Proj = identity>
+    constexpr std::enable_if_t<
+        input_iterator<I> && sentinel_for<S, I> &&
+            transform_reduce_traits<void, ROp, T, TOp,
+                                    projected<I, Proj>>::value,
+        T>
+    operator()(I first, S last, T init, ROp reduce_op, TOp transform_op,
+               Proj proj = Proj{}) const
+    {
+        transform_proj<TOp, Proj> tproj{transform_op, proj};
+        return reduce_fn::impl(std::move(first), std::move(last),
+                               std::move(init), reduce_op, tproj);
+    }
 
-NANO_BEGIN_NAMESPACE
+    // Unary op, range
+    template <typename Rng, typename T, typename ROp, typename TOp,
+              typename Proj = identity>
+    constexpr std::enable_if_t<
+        input_range<Rng> &&
+            transform_reduce_traits<void, ROp, T, TOp,
+                                    projected<iterator_t<Rng>, Proj>>::value,
+        T>
+    operator()(Rng&& rng, T init, ROp reduce_op, TOp transform_op,
+               Proj proj = Proj{}) const
+    {
+        transform_proj<TOp, Proj> tproj{transform_op, proj};
+        return reduce_fn::impl(nano::begin(rng), nano::end(rng),
+                               std::move(init), reduce_op, tproj);
+    }
 
-namespace detail {
+    // Binary op, iterators
+    template <typename I1, typename S1, typename I2, typename S2, typename T,
+              typename ROp = std::plus<>, typename BOp = std::multiplies<>,
+              typename Proj1 = identity, typename Proj2 = identity>
+    constexpr std::enable_if_t<
+        input_iterator<I1> && sentinel_for<S1, I1> && input_iterator<I2> &&
+            sentinel_for<S2, I2> &&
+            transform_reduce_traits<void, ROp, T, BOp, projected<I1, Proj1>,
+                                    projected<I2, Proj2>>::value,
+        T>
+    operator()(I1 first1, S1 last1, I2 first2, S2 last2, T init,
+               ROp reduce_op = ROp{}, BOp binary_op = BOp{},
+               Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
+    {
+        return transform_reduce_fn::binary_impl(
+            std::move(first1), std::move(last1), std::move(first2),
+            std::move(last2), std::move(init), reduce_op, binary_op, proj1,
+            proj2);
+    }
 
-struct stable_partition_fn {
-private:
-    template <typename I, typename Buf, typename Pred, typename Proj>
-    static subrange<I> impl_buffered(I first, I last, Buf& buf, Pred& pred, Proj& proj)
+    // Binary op, ranges
+    template <typename Rng1, typename Rng2, typename T,
+              typename ROp = std::plus<>, typename BOp = std::multiplies<>,
+              typename Proj1 = identity, typename Proj2 = identity>
+    constexpr std::enable_if_t<
+        input_range<Rng1> && input_range<Rng2> &&
+            transform_reduce_traits<void, ROp, T, BOp,
+                                    projected<iterator_t<Rng1>, Proj1>,
+                                    projected<iterator_t<Rng2>, Proj2>>::value,
+        T>
+    operator()(Rng1&& rng1, Rng2&& rng2, T init, ROp reduce_op = ROp{},
+               BOp binary_op = BOp{}, Proj1 proj1 = Proj1{},
+               Proj2 proj2 = Proj2{}) const
     {
-        // first is known to be false, so pop it straight into the buffer
-        buf.push_back(nano::iter_move(first));
+        return transform_reduce_fn::binary_impl(
+            nano::begin(rng1), nano::end(rng1), nano::begin(rng2),
+            nano::end(rng2), std::move(init), reduce_op, binary_op, proj1,
+            proj2);
+    }
 
-        const auto res = nano::partition_copy(
-                nano::make_move_iterator(nano::next(first)),
-                nano::make_move_sentinel(--last),
-                first, nano::back_inserter(buf),
-                std::ref(pred), std::ref(proj));
+    // Unary op, policy and iterators
+    template <typename EP, typename I, typename S, typename T, typename ROp,
+              typename TOp, typename Proj = identity>
+    std::enable_if_t<
+        is_execution_policy_v<remove_cvref_t<EP>> && forward_iterator<I> &&
+            sentinel_for<S, I> &&
+            transform_reduce_traits<void, ROp, T, TOp,
+                                    projected<I, Proj>>::parallel,
+        T>
+    operator()(EP&& policy, I first, S last, T init, ROp reduce_op,
+               TOp transform_op, Proj proj = Proj{}) const
+    {
+        transform_proj<TOp, Proj> tproj{transform_op, proj};
+        return reduce_fn::impl(std::forward<EP>(policy), std::move(first),
+                               std::move(last), std::move(init), reduce_op,
+                               tproj);
+    }
 
-        // last is known to be true, move that to the correct pos
-        first = std::move(res.out1);
-        *first = nano::iter_move(last);
-        ++first;
+    // Unary op, policy and range
+    template <typename EP, typename Rng, typename T, typename ROp,
+              typename TOp, typename Proj = identity>
+    std::enable_if_t<
+        is_execution_policy_v<remove_cvref_t<EP>> && forward_range<Rng> &&
+            transform_reduce_traits<void, ROp, T, TOp,
+                                    projected<iterator_t<Rng>, Proj>>::parallel,
+        T>
+    operator()(EP&& policy, Rng&& rng, T init, ROp reduce_op, TOp transform_op,
+               Proj proj = Proj{}) const
+    {
+        transform_proj<TOp, Proj> tproj{transform_op, proj};
+        return reduce_fn::impl(std::forward<EP>(policy), nano::begin(rng),
+                               nano::end(rng), std::move(init), reduce_op,
+                               tproj);
+    }
 
-        // Now move all the other elements from the buffer back into the sequence
-        nano::move(buf, first);
-        return {std::move(first), std::move(last)};
+    // Binary op, policy and iterators
+    template <typename EP, typename I1, typename S1, typename I2, typename S2,
+              typename T, typename ROp = std::plus<>,
+              typename BOp = std::multiplies<>, typename Proj1 = identity,
+              typename Proj2 = identity>
+    std::enable_if_t<
+        is_execution_policy_v<remove_cvref_t<EP>> && forward_iterator<I1> &&
+            sentinel_for<S1, I1> && forward_iterator<I2> &&
+            sentinel_for<S2, I2> &&
+            transform_reduce_traits<void, ROp, T, BOp, projected<I1, Proj1>,
+                                    projected<I2, Proj2>>::parallel,
+        T>
+    operator()(EP&& policy, I1 first1, S1 last1, I2 first2, S2 last2, T init,
+               ROp reduce_op = ROp{}, BOp binary_op = BOp{},
+               Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
+    {
+        return transform_reduce_fn::binary_impl(
+            std::forward<EP>(policy), std::move(first1), std::move(last1),
+            std::move(first2), std::move(last2), std::move(init), reduce_op,
+            binary_op, proj1, proj2);
     }
 
-    // Note to self: this is a closed range, last is NOT past-the-end!
-    template <typename I, typename Pred, typename Proj>
-    static subrange<I> impl_unbuffered(I first, I last, iter_difference_t<I> dist,
-                             Pred& pred, Proj& proj)
+    // Binary op, policy and ranges
+    template <typename EP, typename Rng1, typename Rng2, typename T,
+              typename ROp = std::plus<>, typename BOp = std::multiplies<>,
+              typename Proj1 = identity, typename Proj2 = identity>
+    std::enable_if_t<
+        is_execution_policy_v<remove_cvref_t<EP>> && forward_range<Rng1> &&
+            forward_range<Rng2> &&
+            transform_reduce_traits<void, ROp, T, BOp,
+                                    projected<iterator_t<Rng1>, Proj1>,
+                                    projected<iterator_t<Rng2>, Proj2>>::parallel,
+        T>
+    operator()(EP&& policy, Rng1&& rng1, Rng2&& rng2, T init,
+               ROp reduce_op = ROp{}, BOp binary_op = BOp{},
+               Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
     {
-        using dist_t = iter_difference_t<I>;
+        return transform_reduce_fn::binary_impl(
+            std::forward<EP>(policy), nano::begin(rng1), nano::end(rng1),
+            nano::begin(rng2), nano::end(rng2), std::move(init), reduce_op,
+            binary_op, proj1, proj2);
+    }
+};
 
-        if (dist == 2) {
-            // We know first is false and last is true, so swap them
-            nano::iter_swap(first, last);
-            return {nano::next(first), nano::next(last)};
-        }
+} // namespace detail
 
-        if (dist == 3) {
-            // We know first is false and last is true, so look at middle
-            I middle = nano::next(first);
+NANO_INLINE_VAR(detail::transform_reduce_fn, transform_reduce)
 
-            if (nano::invoke(pred, nano::invoke(proj, *middle))) {
-                nano::iter_swap(first, middle);
-                nano::iter_swap(middle, last);
-                return {nano::next(first, 2), nano::next(last)};
-            }
+NANO_END_NAMESPACE
 
-            // middle is false
-            nano::iter_swap(middle, last);
-            nano::iter_swap(first, middle);
-            return {std::move(middle), std::next(last)};
-        }
+#endif
 
-        const dist_t half = dist/2;
-        const I middle = nano::next(first, half);
+// nanorange/algorithm/unique.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_ALGORITHM_UNIQUE_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_UNIQUE_HPP_INCLUDED
 
-        I m1 = nano::prev(middle);
-        dist_t len_half = half;
 
-        while (m1 != first && !nano::invoke(pred, nano::invoke(proj, *m1))) {
-            --len_half;
-            --m1;
-        }
 
-        const I first_false = (m1 == first) ? first :
-                impl_unbuffered(first, m1, len_half, pred, proj).begin();
 
-        m1 = middle;
-        len_half = dist - half;
 
-        while (nano::invoke(pred, nano::invoke(proj, *m1))) {
-            if (++m1 == last) {
-                auto rot = nano::rotate(first_false, middle, ++last);
-                return {std::move(rot.begin()), nano::next(last)};
-            }
-        }
 
-        const I last_false = impl_unbuffered(m1, last, len_half, pred, proj).begin();
+NANO_BEGIN_NAMESPACE
 
-        auto rot = nano::rotate(first_false, middle, last_false);
-        return {rot.begin(), nano::next(last)};
-    }
+namespace detail {
 
-    template <typename I, typename Pred, typename Proj>
-    static subrange<I> impl(I first, I last, Pred& pred, Proj& proj)
+struct unique_fn {
+private:
+    template <typename I, typename S, typename R, typename Proj>
+    static constexpr subrange<I> impl(I first, S last, R& comp, Proj& proj)
     {
-        // Find the first non-true value
-        first = nano::find_if_not(std::move(first), last, std::ref(pred), std::ref(proj));
-        if (first == last) {
-            return {std::move(first), std::move(last)};
-        }
+        I it = adjacent_find_fn::impl(first, last, comp, proj);
 
-        // Find the last true value
-        I it = nano::find_if(nano::make_reverse_iterator(last),
-                             nano::make_reverse_iterator(first),
-                             std::ref(pred), std::ref(proj)).base();
-        if (it == first) {
-            return {std::move(first), std::move(it)};
+        if (it == last) {
+            return {it, std::move(it)};
         }
 
-        const auto dist = nano::distance(first, it);
-
-        auto buf = detail::temporary_vector<iter_value_t<I>>(dist);
-        if (buf.capacity() < static_cast<std::size_t>(dist)) {
-            return {impl_unbuffered(first, --it, dist, pred, proj).begin(), last};
+        I n = nano::next(it, 2, last);
+        for (; n != last; ++n) {
+            if (!nano::invoke(comp, nano::invoke(proj, *it),
+                              nano::invoke(proj, *n))) {
+                *++it = iter_move(n);
+            }
         }
-        return {impl_buffered(first, it, buf, pred, proj).begin(), last};
-    }
 
-    template <typename I, typename S, typename Pred, typename Proj>
-    static std::enable_if_t<!same_as<I, S>, subrange<I>>
-    impl(I first, S last, Pred& pred, Proj& proj)
-    {
-        return impl(first, nano::next(first, last), pred, proj);
+        return {nano::next(it), std::move(n)};
     }
 
 public:
-    template <typename I, typename S, typename Pred, typename Proj = identity>
-    std::enable_if_t<bidirectional_iterator<I> && sentinel_for<S, I> &&
-                         indirect_unary_predicate<Pred, projected<I, Proj>> &&
-                         permutable<I>, subrange<I>>
-    operator()(I first, S last, Pred pred, Proj proj = Proj{}) const
+    template <typename I, typename S, typename R = ranges::equal_to,
+              typename Proj = identity>
+    constexpr std::enable_if_t<forward_iterator<I> && sentinel_for<S, I> &&
+                                   indirect_relation<R, projected<I, Proj>> &&
+                                   permutable<I>, subrange<I>>
+    operator()(I first, S last, R comp = {}, Proj proj = Proj{}) const
     {
-        return stable_partition_fn::impl(std::move(first), std::move(last),
-                                         pred, proj);
+        return unique_fn::impl(std::move(first), std::move(last),
+                               comp, proj);
     }
 
-    template <typename Rng, typename Pred, typename Proj = identity>
-    std::enable_if_t<
-        bidirectional_range<Rng> &&
-            indirect_unary_predicate<Pred, projected<iterator_t<Rng>, Proj>> &&
+    template <typename Rng, typename R = ranges::equal_to, typename Proj = identity>
+    constexpr std::enable_if_t<
+        forward_range<Rng> &&
+            indirect_relation<R, projected<iterator_t<Rng>, Proj>> &&
             permutable<iterator_t<Rng>>,
         borrowed_subrange_t<Rng>>
-    operator()(Rng&& rng, Pred pred, Proj proj = Proj{}) const
+    operator()(Rng&& rng, R comp = {}, Proj proj = Proj{}) const
     {
-        return stable_partition_fn::impl(nano::begin(rng), nano::end(rng),
-                                         pred, proj);
+        return unique_fn::impl(nano::begin(rng), nano::end(rng),
+                               comp, proj);
     }
 };
 
 }
 
-NANO_INLINE_VAR(detail::stable_partition_fn, stable_partition)
+NANO_INLINE_VAR(detail::unique_fn, unique)
 
 NANO_END_NAMESPACE
 
 #endif
 
-// nanorange/algorithm/stable_sort.hpp
+// nanorange/algorithm/unique_copy.hpp
 //
-// Copyright (c) 2019 Tristan Brindle (tcbrindle at gmail dot com)
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
 // Distributed under the Boost Software License, Version 1.0. (See accompanying
 // file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
-// Uses code from cmcstl2 - A concept-enabled C++ standard library
-//
-//  Copyright Eric Niebler 2014
-//  Copyright Casey Carter 2015
-//
-
-//
-//  Copyright (c) 1994
-//  Hewlett-Packard Company
-//
-//  Permission to use, copy, modify, distribute and sell this software
-//  and its documentation for any purpose is hereby granted without fee,
-//  provided that the above copyright notice appear in all copies and
-//  that both that copyright notice and this permission notice appear
-//  in supporting documentation.  Hewlett-Packard Company makes no
-//  representations about the suitability of this software for any
-//  purpose.  It is provided "as is" without express or implied warranty.
-//
-//  Copyright (c) 1996
-//  Silicon Graphics Computer Systems, Inc.
-//
-//  Permission to use, copy, modify, distribute and sell this software
-//  and its documentation for any purpose is hereby granted without fee,
-//  provided that the above copyright notice appear in all copies and
-//  that both that copyright notice and this permission notice appear
-//  in supporting documentation.  Silicon Graphics makes no
-//  representations about the suitability of this software for any
-//  purpose.  It is provided "as is" without express or implied warranty.
-
-
-#ifndef NANORANGE_ALGORITHM_STABLE_SORT_HPP_INCLUDED
-#define NANORANGE_ALGORITHM_STABLE_SORT_HPP_INCLUDED
+#ifndef NANORANGE_ALGORITHM_UNIQUE_COPY_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_UNIQUE_COPY_HPP_INCLUDED
 
 
 
 
 NANO_BEGIN_NAMESPACE
 
+template <typename I, typename O>
+using unique_copy_result = in_out_result<I, O>;
+
 namespace detail {
 
-struct stable_sort_fn {
+struct unique_copy_fn {
 private:
-    static constexpr int merge_sort_chunk_size = 7;
-
-    template <typename I, typename Comp, typename Proj>
-    static void inplace_stable_sort(I first, I last, Comp& comp, Proj& proj)
-    {
-        if (last - first < 15) {
-            detail::insertion_sort(std::move(first), std::move(last), comp, proj);
-        } else {
-            I middle = first + iter_difference_t<I>(last - first) / 2;
-            inplace_stable_sort(first, middle, comp, proj);
-            inplace_stable_sort(middle, last, comp, proj);
-            inplace_merge_fn::impl_slow(first, middle, last,
-                                        middle - first, last - middle,
-                                        comp, proj);
-        }
-    }
-
-    template <typename I, typename Buf, typename Comp, typename Proj>
-    static void stable_sort_adaptive(I first, I last, Buf& buf, Comp& comp, Proj& proj)
+    template <typename I, typename S, typename O,
+              typename Comp, typename Proj>
+    static constexpr unique_copy_result<I, O>
+    impl(I first, S last, O result, Comp& comp, Proj& proj)
     {
-        auto len = iter_difference_t<I>((last - first + 1) / 2);
-        auto middle = first + len;
-        if (static_cast<std::size_t>(len) > buf.capacity()) {
-            stable_sort_adaptive(first, middle, buf, comp, proj);
-            stable_sort_adaptive(middle, last, buf, comp, proj);
-        } else {
-            merge_sort_with_buffer(first, middle, buf, comp, proj);
-            merge_sort_with_buffer(middle, last, buf, comp, proj);
-        }
-        inplace_merge_fn::impl_buffered(first, middle, last,
-                                        middle - first, last - middle, buf,
-                                        comp, proj);
-    }
+        if (first != last) {
+            iter_value_t<I> saved = *first;
+            *result = saved;
+            ++result;
 
-    template <typename I, typename Buf, typename Comp, typename Proj>
-    static void merge_sort_with_buffer(I first, I last, Buf& buf, Comp& comp, Proj& proj)
-    {
-        auto len = iter_difference_t<I>(last - first);
-        auto step_size = iter_difference_t<I>(merge_sort_chunk_size);
-        chunk_insertion_sort(first, last, step_size, comp, proj);
-        if (step_size >= len) {
-            return;
-        }
-        assert(buf.empty());
-        merge_sort_loop(first, last, nano::back_inserter(buf), step_size, comp, proj);
-        step_size *= 2;
-        while (true) {
-            merge_sort_loop(buf.begin(), buf.end(), first, step_size, comp, proj);
-            step_size *= 2;
-            if (step_size >= len) {
-                buf.clear();
-                return;
+            while (++first != last) {
+                auto&& v = *first;
+                if (!nano::invoke(comp, nano::invoke(proj, v), nano::invoke(proj, saved))) {
+                    saved = std::forward<decltype(v)>(v);
+                    *result = saved;
+                    ++result;
+                }
             }
-            merge_sort_loop(first, last, buf.begin(), step_size, comp, proj);
-            step_size *= 2;
         }
-        buf.clear();
+
+        return {std::move(first), std::move(result)};
     }
 
-    template <typename I, typename Comp, typename Proj>
-    static void chunk_insertion_sort(I first, I last, iter_difference_t<I> chunk_size,
-                                     Comp& comp, Proj& proj)
+    template <typename I, typename O>
+    static auto constraint_helper(priority_tag<2>) -> std::enable_if_t<forward_iterator<I>, std::true_type>;
+
+    template <typename I, typename O>
+    static auto constraint_helper(priority_tag<1>) -> std::enable_if_t<input_iterator<O> && same_as<iter_value_t<I>, iter_value_t<O>>,
+        std::true_type>;
+
+    template <typename I, typename O>
+    static auto constraint_helper(priority_tag<0>) -> std::enable_if_t<indirectly_copyable_storable<I, O>, std::true_type>;
+
+public:
+    template <typename I, typename S, typename O, typename Comp = ranges::equal_to,
+              typename Proj = identity>
+    constexpr auto operator()(I first, S last, O result,
+                              Comp comp = Comp{}, Proj proj = Proj{}) const
+        -> std::enable_if_t<
+            input_iterator<I> && sentinel_for<S, I> &&
+               weakly_incrementable<O> &&
+                indirect_relation<Comp, projected<I, Proj>> &&
+                indirectly_copyable<I, O> &&
+               decltype(constraint_helper<I, O>(priority_tag<2>{}))::value,
+        unique_copy_result<I, O>>
     {
-            while (last - first >= chunk_size) {
-                detail::insertion_sort(first, first + chunk_size, comp, proj);
-                first += chunk_size;
-            }
-            detail::insertion_sort(first, last, comp, proj);
+        return unique_copy_fn::impl(std::move(first), std::move(last),
+                                    std::move(result), comp, proj);
     }
 
-    template <typename I, typename O, typename Comp, typename Proj>
-    static void merge_sort_loop(I first, I last, O result, iter_difference_t<I> step_size,
-                                Comp& comp, Proj& proj)
+    template <typename Rng, typename O, typename Comp = ranges::equal_to,
+              typename Proj = identity>
+    constexpr auto
+    operator()(Rng&& rng, O result, Comp comp = Comp{}, Proj proj = Proj{}) const
+    -> std::enable_if_t<
+            input_range<Rng> &&
+            weakly_incrementable<O> &&
+                indirect_relation<Comp, projected<iterator_t<Rng>, Proj>> &&
+                indirectly_copyable<iterator_t<Rng>, O> &&
+            decltype(constraint_helper<iterator_t<Rng>, O>(priority_tag<2>{}))::value,
+       unique_copy_result<borrowed_iterator_t<Rng>, O>>
     {
-        auto two_step = iter_difference_t<I>(2 * step_size);
-        while (last - first >= two_step) {
-            result = nano::merge(
-                         nano::make_move_iterator(first),
-                         nano::make_move_iterator(first + step_size),
-                         nano::make_move_iterator(first + step_size),
-                         nano::make_move_iterator(first + two_step),
-                         result, std::ref(comp), std::ref(proj), std::ref(proj)).out;
-            first += two_step;
-        }
-        step_size = (nano::min)(iter_difference_t<I>(last - first), step_size);
-        nano::merge(
-                nano::make_move_iterator(first),
-                nano::make_move_iterator(first + step_size),
-                nano::make_move_iterator(first + step_size),
-                nano::make_move_iterator(last),
-                result, std::ref(comp), std::ref(proj), std::ref(proj));
+        return unique_copy_fn::impl(nano::begin(rng), nano::end(rng),
+                                    std::move(result), comp, proj);
     }
+};
 
-    template <typename I, typename Comp, typename Proj>
-    static void impl(I first, I last, Comp& comp, Proj& proj)
-    {
-        auto len = last - first;
-        if (len == 0) {
-            return;
-        }
+}
+
+NANO_INLINE_VAR(detail::unique_copy_fn, unique_copy)
+
+NANO_END_NAMESPACE
+
+#endif
+
+
+// nanorange/algorithm/upper_bound_batch.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_ALGORITHM_UPPER_BOUND_BATCH_HPP_INCLUDED
+#define NANORANGE_ALGORITHM_UPPER_BOUND_BATCH_HPP_INCLUDED
+
+
+
+NANO_BEGIN_NAMESPACE
+
+// Extension: as lower_bound_batch, but writes
+// upper_bound(haystack, value, comp, proj) for each query
+
+template <typename I, typename O>
+using upper_bound_batch_result = in_out_result<I, O>;
+
+NANO_INLINE_VAR(detail::bound_batch_fn<detail::bound_kind::upper>,
+                upper_bound_batch)
+
+NANO_END_NAMESPACE
+
+#endif
+
+
+#endif
+
+
+
+
+// nanorange/iterator.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_ITERATOR_HPP_INCLUDED
+#define NANORANGE_ITERATOR_HPP_INCLUDED
 
-        temporary_vector<iter_value_t<I>> buf(len > 256 ? len : 0);
 
-        if (buf.capacity() != 0) {
-            stable_sort_adaptive(std::move(first), std::move(last), buf, comp, proj);
-        } else {
-            inplace_stable_sort(std::move(first), std::move(last), comp, proj);
-        }
-    }
 
-public:
-    template <typename I, typename S, typename Comp = ranges::less, typename Proj = identity>
-    std::enable_if_t<random_access_iterator<I> && sentinel_for<S, I> &&
-                         sortable<I, Comp, Proj>, I>
-    operator()(I first, S last, Comp comp = Comp{}, Proj proj = Proj{}) const
-    {
-        const auto ilast = nano::next(first, last);
-        impl(std::move(first), ilast, comp, proj);
-        return ilast;
-    }
 
-    template <typename Rng, typename Comp = ranges::less, typename Proj = identity>
-    std::enable_if_t<random_access_range<Rng> &&
-                         sortable<iterator_t<Rng>, Comp, Proj>,
-                     borrowed_iterator_t<Rng>>
-    operator()(Rng&& rng, Comp comp = Comp{}, Proj proj = Proj{}) const
-    {
-        auto first = nano::begin(rng);
-        const auto last = nano::next(first, nano::end(rng));
-        impl(std::move(first), last, comp, proj);
-        return last;
-    }
-};
 
-}
 
-NANO_INLINE_VAR(detail::stable_sort_fn, stable_sort)
 
-NANO_END_NAMESPACE
 
-#endif
 
 
-// nanorange/algorithm/transform.hpp
+
+
+
+// nanorange/iterator/front_insert_iterator.hpp
 //
 // Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
 // Distributed under the Boost Software License, Version 1.0. (See accompanying
 // file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
-#ifndef NANORANGE_ALGORITHM_TRANSFORM_HPP_INCLUDED
-#define NANORANGE_ALGORITHM_TRANSFORM_HPP_INCLUDED
+#ifndef NANORANGE_ITERATOR_FRONT_INSERT_ITERATOR_HPP_INCLUDED
+#define NANORANGE_ITERATOR_FRONT_INSERT_ITERATOR_HPP_INCLUDED
 
 
 
+#include <iterator>
 
 NANO_BEGIN_NAMESPACE
 
-template <typename I, typename O>
-using unary_transform_result = in_out_result<I, O>;
+template <typename Container>
+struct front_insert_iterator {
+    using container_type = Container;
+    using difference_type = std::ptrdiff_t;
 
-template <typename I1, typename I2, typename O>
-using binary_transform_result  = in_in_out_result<I1, I2, O>;
+    constexpr front_insert_iterator() = default;
 
-namespace detail {
+    explicit front_insert_iterator(Container& x) : cont_(std::addressof(x)) {}
 
-struct transform_fn {
-private:
-    template <typename I, typename S, typename O, typename F, typename Proj>
-    static constexpr unary_transform_result<I, O>
-    unary_impl(I first, S last, O result, F& op, Proj& proj)
+    front_insert_iterator& operator=(const iter_value_t<Container>& value)
     {
-        while (first != last) {
-            *result = nano::invoke(op, nano::invoke(proj, *first));
-            ++first;
-            ++result;
-        }
-
-        return {std::move(first), std::move(result)};
+        cont_->push_front(value);
+        return *this;
     }
 
-    template <typename I1, typename S1, typename I2, typename O, typename F,
-              typename Proj1, typename Proj2>
-    static constexpr binary_transform_result<I1, I2, O>
-    binary_impl3(I1 first1, S1 last1, I2 first2, O result, F& op, Proj1& proj1,
-                 Proj2& proj2)
+    front_insert_iterator& operator=(iter_value_t<Container>&& value)
     {
-        while (first1 != last1) {
-            *result = nano::invoke(op, nano::invoke(proj1, *first1),
-                                   nano::invoke(proj2, *first2));
-            ++first1;
-            ++first2;
-            ++result;
-        }
-
-        return {std::move(first1), std::move(first2), std::move(result)};
+        cont_->push_front(std::move(value));
+        return *this;
     }
 
-    template <typename I1, typename S1, typename I2, typename S2, typename O,
-              typename F, typename Proj1, typename Proj2>
-    static constexpr binary_transform_result<I1, I2, O>
-    binary_impl4(I1 first1, S1 last1, I2 first2, S2 last2, O result, F& op,
-                 Proj1& proj1, Proj2& proj2)
-    {
-        while (first1 != last1 && first2 != last2) {
-            *result = nano::invoke(op, nano::invoke(proj1, *first1),
-                                   nano::invoke(proj2, *first2));
-            ++first1;
-            ++first2;
-            ++result;
-        }
+    front_insert_iterator& operator*() { return *this; }
+    front_insert_iterator& operator++() { return *this; }
+    front_insert_iterator& operator++(int) { return *this; }
 
-        return {std::move(first1), std::move(first2), std::move(result)};
-    }
+private:
+    container_type* cont_ = nullptr;
+};
 
-public:
-    // Unary op, iterators
-    template <typename I, typename S, typename O, typename F,
-              typename Proj = identity>
-    constexpr std::enable_if_t<
-        input_iterator<I> && sentinel_for<S, I> && weakly_incrementable<O> &&
-            copy_constructible<F> &&
-            writable<O, indirect_result_t<F&, projected<I, Proj>>>,
-        unary_transform_result<I, O>>
-    operator()(I first, S last, O result, F op, Proj proj = Proj{}) const
-    {
-        return transform_fn::unary_impl(std::move(first), std::move(last),
-                                        std::move(result), op, proj);
-    }
+template <typename Container>
+front_insert_iterator<Container> front_inserter(Container& x)
+{
+    return front_insert_iterator<Container>(x);
+}
 
-    // Unary op, range
-    template <typename Rng, typename O, typename F, typename Proj = identity>
-    constexpr std::enable_if_t<
-        input_range<Rng> && weakly_incrementable<O> && copy_constructible<F> &&
-            writable<O,
-                     indirect_result_t<F&, projected<iterator_t<Rng>, Proj>>>,
-        unary_transform_result<borrowed_iterator_t<Rng>, O>>
-    operator()(Rng&& rng, O result, F op, Proj proj = Proj{}) const
-    {
-        return transform_fn::unary_impl(nano::begin(rng), nano::end(rng),
-                                        std::move(result), op, proj);
-    }
+NANO_END_NAMESPACE
 
-    // Binary op, four-legged
-    template <typename I1, typename S1, typename I2, typename S2, typename O,
-              typename F, typename Proj1 = identity, typename Proj2 = identity>
-    constexpr std::enable_if_t<
-        input_iterator<I1> && sentinel_for<S1, I1> && input_iterator<I2> &&
-            sentinel_for<S2, I2> && weakly_incrementable<O> &&
-            copy_constructible<F> &&
-            writable<O, indirect_result_t<F&, projected<I1, Proj1>,
-                                          projected<I2, Proj2>>>,
-        binary_transform_result<I1, I2, O>>
-    operator()(I1 first1, S1 last1, I2 first2, S2 last2, O result, F op,
-               Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
-    {
-        return transform_fn::binary_impl4(std::move(first1), std::move(last1),
-                                          std::move(first2), std::move(last2),
-                                          std::move(result), op, proj1, proj2);
-    }
+namespace std {
 
-    // Binary op, two ranges
-    template <typename Rng1, typename Rng2, typename O, typename F,
-              typename Proj1 = identity, typename Proj2 = identity>
-    constexpr std::enable_if_t<
-        input_range<Rng1> && input_range<Rng2> && weakly_incrementable<O> &&
-            copy_constructible<F> &&
-            writable<O,
-                     indirect_result_t<F&, projected<iterator_t<Rng1>, Proj1>,
-                                       projected<iterator_t<Rng2>, Proj2>>>,
-        binary_transform_result<borrowed_iterator_t<Rng1>,
-                                borrowed_iterator_t<Rng2>, O>>
-    operator()(Rng1&& rng1, Rng2&& rng2, O result, F op, Proj1 proj1 = Proj1{},
-               Proj2 proj2 = Proj2{}) const
-    {
-        return transform_fn::binary_impl4(nano::begin(rng1), nano::end(rng1),
-                                          nano::begin(rng2), nano::end(rng2),
-                                          std::move(result), op, proj1, proj2);
-    }
+template <typename Cont>
+struct iterator_traits<::nano::front_insert_iterator<Cont>> {
+    using value_type = void;
+    using difference_type = ptrdiff_t;
+    using reference = void;
+    using pointer = void;
+    using iterator_category = output_iterator_tag;
+};
 
-    // Binary op, three-legged
-    template <typename I1, typename S1, typename I2, typename O, typename F,
-              typename Proj1 = identity, typename Proj2 = identity>
-    NANO_DEPRECATED constexpr std::enable_if_t<
-        input_iterator<I1> && sentinel_for<S1, I1> &&
-            input_iterator<std::decay_t<I2>> &&
-            !input_range<I2> &&
-            weakly_incrementable<O> && copy_constructible<F> &&
-            writable<O, indirect_result_t<F&, projected<I1, Proj1>,
-                                          projected<std::decay_t<I2>, Proj2>>>,
-        binary_transform_result<I1, std::decay_t<I2>, O>>
-    operator()(I1 first1, S1 last1, I2&& first2, O result, F op,
-               Proj1 proj1 = Proj1{}, Proj2 proj2 = Proj2{}) const
+} // namespace std
+
+#endif
+
+// nanorange/iterator/insert_iterator.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_ITERATOR_INSERT_ITERATOR_HPP_INCLUDED
+#define NANORANGE_ITERATOR_INSERT_ITERATOR_HPP_INCLUDED
+
+
+
+#include <iterator>
+
+NANO_BEGIN_NAMESPACE
+
+template <typename Container>
+struct insert_iterator {
+    using container_type = Container;
+    using difference_type = std::ptrdiff_t;
+
+    constexpr insert_iterator() = default;
+
+    explicit insert_iterator(Container& x, iterator_t<Container> i)
+        : cont_(std::addressof(x)), it_(i)
+    {}
+
+    insert_iterator& operator=(const iter_value_t<Container>& value)
     {
-        return transform_fn::binary_impl3(std::move(first1), std::move(last1),
-                                          std::forward<I2>(first2), std::move(result),
-                                          op, proj1, proj2);
+        cont_->insert(it_, value);
+        ++it_;
+        return *this;
     }
 
-    // binary op, range-and-a-half
-    template <typename Rng1, typename I2, typename O, typename F,
-              typename Proj1 = identity, typename Proj2 = identity>
-    NANO_DEPRECATED constexpr std::enable_if_t<
-        input_range<Rng1> && input_iterator<std::decay_t<I2>> &&
-                !input_range<I2> && weakly_incrementable<O> &&
-            copy_constructible<F> &&
-            writable<O,
-                     indirect_result_t<F&, projected<iterator_t<Rng1>, Proj1>,
-                                       projected<std::decay_t<I2>, Proj2>>>,
-        binary_transform_result<borrowed_iterator_t<Rng1>, std::decay_t<I2>, O>>
-    operator()(Rng1&& rng1, I2&& first2, O result, F op, Proj1 proj1 = Proj1{},
-               Proj2 proj2 = Proj2{}) const
+    insert_iterator& operator=(iter_value_t<Container>&& value)
     {
-        return transform_fn::binary_impl3(nano::begin(rng1), nano::end(rng1),
-                                          std::forward<I2>(first2), std::move(result),
-                                          op, proj1, proj2);
+        cont_->push_back(it_, std::move(value));
+        ++it_;
+        return *this;
     }
-};
 
-} // namespace detail
+    insert_iterator& operator*() { return *this; }
+    insert_iterator& operator++() { return *this; }
+    insert_iterator& operator++(int) { return *this; }
+
+private:
+    container_type* cont_ = nullptr;
+    iterator_t<container_type> it_{};
+};
 
-NANO_INLINE_VAR(detail::transform_fn, transform)
+template <typename Container>
+insert_iterator<Container> inserter(Container& x)
+{
+    return back_insert_iterator<Container>(x);
+}
 
 NANO_END_NAMESPACE
 
-#endif
+namespace std {
 
-// nanorange/algorithm/unique.hpp
+template <typename Container>
+struct iterator_traits<::nano::insert_iterator<Container>> {
+    using value_type = void;
+    using difference_type = ptrdiff_t;
+    using reference = void;
+    using pointer = void;
+    using iterator_category = output_iterator_tag;
+};
+
+} // namespace std
+
+#endif
+// nanorange/iterator/istream_iterator.hpp
 //
 // Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
 // Distributed under the Boost Software License, Version 1.0. (See accompanying
 // file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
-#ifndef NANORANGE_ALGORITHM_UNIQUE_HPP_INCLUDED
-#define NANORANGE_ALGORITHM_UNIQUE_HPP_INCLUDED
-
+#ifndef NANORANGE_ITERATOR_ISTREAM_ITERATOR_HPP_INCLUDED
+#define NANORANGE_ITERATOR_ISTREAM_ITERATOR_HPP_INCLUDED
 
 
 
 
+#include <iosfwd>
 
 NANO_BEGIN_NAMESPACE
 
-namespace detail {
+template <typename T, typename CharT = char, typename Traits = std::char_traits<CharT>,
+          typename Distance = std::ptrdiff_t>
+class istream_iterator {
+public:
+    using iterator_category = input_iterator_tag;
+    using difference_type = Distance;
+    using value_type = T;
+    using reference = const T&;
+    using pointer = const T*;
+    using char_type = CharT;
+    using traits_type = Traits;
+    using istream_type = std::basic_istream<CharT, Traits>;
 
-struct unique_fn {
-private:
-    template <typename I, typename S, typename R, typename Proj>
-    static constexpr subrange<I> impl(I first, S last, R& comp, Proj& proj)
+    constexpr istream_iterator() = default;
+
+    constexpr istream_iterator(default_sentinel_t) {}
+
+    istream_iterator(istream_type& s)
+        : in_stream_(std::addressof(s))
     {
-        I it = adjacent_find_fn::impl(first, last, comp, proj);
+        s >> value_;
+    }
 
-        if (it == last) {
-            return {it, std::move(it)};
-        }
+    istream_iterator(const istream_iterator& x) = default;
 
-        I n = nano::next(it, 2, last);
-        for (; n != last; ++n) {
-            if (!nano::invoke(comp, nano::invoke(proj, *it),
-                              nano::invoke(proj, *n))) {
-                *++it = iter_move(n);
-            }
+    ~istream_iterator() = default;
+
+    const T& operator*() const { return value_; }
+
+    const T* operator->() const { return std::addressof(value_); }
+
+    istream_iterator& operator++()
+    {
+        *in_stream_ >> value_;
+        if (in_stream_->fail()) {
+            in_stream_ = nullptr;
         }
+        return *this;
+    }
 
-        return {nano::next(it), std::move(n)};
+    istream_iterator operator++(int)
+    {
+        istream_iterator tmp = *this;
+        this->operator++();
+        return tmp;
     }
 
-public:
-    template <typename I, typename S, typename R = ranges::equal_to,
-              typename Proj = identity>
-    constexpr std::enable_if_t<forward_iterator<I> && sentinel_for<S, I> &&
-                                   indirect_relation<R, projected<I, Proj>> &&
-                                   permutable<I>, subrange<I>>
-    operator()(I first, S last, R comp = {}, Proj proj = Proj{}) const
+    friend bool operator==(const istream_iterator& x, const istream_iterator& y)
     {
-        return unique_fn::impl(std::move(first), std::move(last),
-                               comp, proj);
+        return x.in_stream_ == y.in_stream_;
     }
 
-    template <typename Rng, typename R = ranges::equal_to, typename Proj = identity>
-    constexpr std::enable_if_t<
-        forward_range<Rng> &&
-            indirect_relation<R, projected<iterator_t<Rng>, Proj>> &&
-            permutable<iterator_t<Rng>>,
-        borrowed_subrange_t<Rng>>
-    operator()(Rng&& rng, R comp = {}, Proj proj = Proj{}) const
+    friend bool operator==(default_sentinel_t, const istream_iterator y)
     {
-        return unique_fn::impl(nano::begin(rng), nano::end(rng),
-                               comp, proj);
+        return nullptr == y.in_stream_;
     }
-};
 
-}
+    friend bool operator==(const istream_iterator& x, default_sentinel_t)
+    {
+        return x.in_stream_ == nullptr;
+    }
 
-NANO_INLINE_VAR(detail::unique_fn, unique)
+    friend bool operator!=(const istream_iterator& x, const istream_iterator& y)
+    {
+        return !(x == y);
+    }
+
+    friend bool operator!=(default_sentinel_t x, const istream_iterator y)
+    {
+        return !(x == y);
+    }
+
+    friend bool operator!=(const istream_iterator& x, default_sentinel_t y)
+    {
+        return !(x == y);
+    }
+
+private:
+    istream_type* in_stream_ = nullptr;
+    T value_{};
+};
 
 NANO_END_NAMESPACE
 
 #endif
 
-// nanorange/algorithm/unique_copy.hpp
+// nanorange/iterator/istreambuf_iterator.hpp
 //
 // Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
 // Distributed under the Boost Software License, Version 1.0. (See accompanying
 // file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
-#ifndef NANORANGE_ALGORITHM_UNIQUE_COPY_HPP_INCLUDED
-#define NANORANGE_ALGORITHM_UNIQUE_COPY_HPP_INCLUDED
-
-
-
-
-NANO_BEGIN_NAMESPACE
-
-template <typename I, typename O>
-using unique_copy_result = in_out_result<I, O>;
+#ifndef NANORANGE_ITERATOR_ISTREAMBUF_ITERATOR_HPP_INCLUDED
+#define NANORANGE_ITERATOR_ISTREAMBUF_ITERATOR_HPP_INCLUDED
 
-namespace detail {
 
-struct unique_copy_fn {
-private:
-    template <typename I, typename S, typename O,
-              typename Comp, typename Proj>
-    static constexpr unique_copy_result<I, O>
-    impl(I first, S last, O result, Comp& comp, Proj& proj)
-    {
-        if (first != last) {
-            iter_value_t<I> saved = *first;
-            *result = saved;
-            ++result;
 
-            while (++first != last) {
-                auto&& v = *first;
-                if (!nano::invoke(comp, nano::invoke(proj, v), nano::invoke(proj, saved))) {
-                    saved = std::forward<decltype(v)>(v);
-                    *result = saved;
-                    ++result;
-                }
-            }
-        }
 
-        return {std::move(first), std::move(result)};
-    }
+#include <iosfwd>
 
-    template <typename I, typename O>
-    static auto constraint_helper(priority_tag<2>) -> std::enable_if_t<forward_iterator<I>, std::true_type>;
+NANO_BEGIN_NAMESPACE
 
-    template <typename I, typename O>
-    static auto constraint_helper(priority_tag<1>) -> std::enable_if_t<input_iterator<O> && same_as<iter_value_t<I>, iter_value_t<O>>,
-        std::true_type>;
+template <typename CharT, typename Traits = std::char_traits<CharT>>
+class istreambuf_iterator {
+    class proxy {
+        friend class istreambuf_iterator;
+        CharT keep_;
+        std::basic_streambuf<CharT, Traits>* sbuf_;
 
-    template <typename I, typename O>
-    static auto constraint_helper(priority_tag<0>) -> std::enable_if_t<indirectly_copyable_storable<I, O>, std::true_type>;
+        proxy(CharT c, std::basic_streambuf<CharT, Traits>* sbuf)
+            : keep_(c), sbuf_(sbuf)
+        {}
+    public:
+        CharT operator*() const { return keep_; }
+    };
 
 public:
-    template <typename I, typename S, typename O, typename Comp = ranges::equal_to,
-              typename Proj = identity>
-    constexpr auto operator()(I first, S last, O result,
-                              Comp comp = Comp{}, Proj proj = Proj{}) const
-        -> std::enable_if_t<
-            input_iterator<I> && sentinel_for<S, I> &&
-               weakly_incrementable<O> &&
-                indirect_relation<Comp, projected<I, Proj>> &&
-                indirectly_copyable<I, O> &&
-               decltype(constraint_helper<I, O>(priority_tag<2>{}))::value,
-        unique_copy_result<I, O>>
-    {
-        return unique_copy_fn::impl(std::move(first), std::move(last),
-                                    std::move(result), comp, proj);
-    }
+    using iterator_category = input_iterator_tag;
+    using value_type = CharT;
+    using difference_type = typename Traits::off_type;
+    using reference = CharT;
+    using pointer = CharT*;
+    using char_type = CharT;
+    using traits_type = Traits;
+    using int_type = typename Traits::int_type;
+    using streambuf_type = std::basic_streambuf<CharT, Traits>;
+    using istream_type = std::basic_istream<CharT, Traits>;
 
-    template <typename Rng, typename O, typename Comp = ranges::equal_to,
-              typename Proj = identity>
-    constexpr auto
-    operator()(Rng&& rng, O result, Comp comp = Comp{}, Proj proj = Proj{}) const
-    -> std::enable_if_t<
-            input_range<Rng> &&
-            weakly_incrementable<O> &&
-                indirect_relation<Comp, projected<iterator_t<Rng>, Proj>> &&
-                indirectly_copyable<iterator_t<Rng>, O> &&
-            decltype(constraint_helper<iterator_t<Rng>, O>(priority_tag<2>{}))::value,
-       unique_copy_result<borrowed_iterator_t<Rng>, O>>
-    {
-        return unique_copy_fn::impl(nano::begin(rng), nano::end(rng),
-                                    std::move(result), comp, proj);
-    }
-};
+    constexpr istreambuf_iterator() noexcept = default;
 
-}
+    constexpr istreambuf_iterator(default_sentinel_t) noexcept {}
 
-NANO_INLINE_VAR(detail::unique_copy_fn, unique_copy)
+    istreambuf_iterator(const istreambuf_iterator&) noexcept = default;
 
-NANO_END_NAMESPACE
+    ~istreambuf_iterator() = default;
 
-#endif
+    istreambuf_iterator(istream_type& s) noexcept
+        : sbuf_(s.rdbuf())
+    {}
 
+    istreambuf_iterator(streambuf_type* s) noexcept
+        : sbuf_(s)
+    {}
 
+    istreambuf_iterator(const proxy& p) noexcept
+        : sbuf_(p.sbuf_)
+    {}
 
-#endif
+    char_type operator*() const { return Traits::to_char_type(sbuf_->sgetc()); }
 
+    istreambuf_iterator& operator++()
+    {
+        sbuf_->sbumpc();
+        return *this;
+    }
 
+    proxy operator++(int)
+    {
+        return proxy(Traits::to_char_type(sbuf_->sbumpc()), sbuf_);
+    }
 
-// nanorange/iterator.hpp
-//
-// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
-// Distributed under the Boost Software License, Version 1.0. (See accompanying
-// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+    bool equal(const istreambuf_iterator& b) const
+    {
+        return  is_eof() == b.is_eof();
+    }
 
-#ifndef NANORANGE_ITERATOR_HPP_INCLUDED
-#define NANORANGE_ITERATOR_HPP_INCLUDED
+private:
+    bool is_eof() const
+    {
+        if (sbuf_ && sbuf_->sgetc() == Traits::eof()) {
+            sbuf_ = nullptr;
+            return true;
+        }
 
+        return sbuf_ == nullptr;
+    }
 
+    mutable streambuf_type* sbuf_ = nullptr;
+};
 
+template <typename CharT, typename Traits>
+bool operator==(const istreambuf_iterator<CharT, Traits>& a,
+                const istreambuf_iterator<CharT, Traits>& b)
+{
+    return a.equal(b);
+}
 
+template <typename CharT, typename Traits>
+bool operator==(default_sentinel_t,
+                const istreambuf_iterator<CharT, Traits>& b)
+{
+    return istreambuf_iterator<CharT, Traits>{}.equal(b);
+}
 
+template <typename CharT, typename Traits>
+bool operator==(const istreambuf_iterator<CharT, Traits>& a,
+                default_sentinel_t)
+{
+    return a.equal(istreambuf_iterator<CharT, Traits>{});
+}
 
+template <typename CharT, typename Traits>
+bool operator!=(const istreambuf_iterator<CharT, Traits>& a,
+                const istreambuf_iterator<CharT, Traits>& b)
+{
+    return !(a == b);
+}
 
+template <typename CharT, typename Traits>
+bool operator!=(default_sentinel_t a,
+                const istreambuf_iterator<CharT, Traits>& b)
+{
+    return !(a == b);
+}
 
+template <typename CharT, typename Traits>
+bool operator!=(const istreambuf_iterator<CharT, Traits>& a,
+                default_sentinel_t b)
+{
+    return !(a == b);
+}
 
+NANO_END_NAMESPACE
 
+#endif
 
 
 
-// nanorange/iterator/front_insert_iterator.hpp
+// nanorange/iterator/ostream_iterator.hpp
 //
 // Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
 // Distributed under the Boost Software License, Version 1.0. (See accompanying
 // file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
-#ifndef NANORANGE_ITERATOR_FRONT_INSERT_ITERATOR_HPP_INCLUDED
-#define NANORANGE_ITERATOR_FRONT_INSERT_ITERATOR_HPP_INCLUDED
+#ifndef NANORANGE_ITERATOR_OSTREAM_ITERATOR_HPP_INCLUDED
+#define NANORANGE_ITERATOR_OSTREAM_ITERATOR_HPP_INCLUDED
 
 
 
+#include <iosfwd>
 #include <iterator>
+#include <memory>
 
 NANO_BEGIN_NAMESPACE
 
-template <typename Container>
-struct front_insert_iterator {
-    using container_type = Container;
+template <typename T, typename CharT = char, typename Traits = std::char_traits<CharT>>
+struct ostream_iterator
+{
+    using char_type = CharT;
+    using traits_type = Traits;
+    using ostream_type = std::basic_ostream<CharT, Traits>;
     using difference_type = std::ptrdiff_t;
 
-    constexpr front_insert_iterator() = default;
-
-    explicit front_insert_iterator(Container& x) : cont_(std::addressof(x)) {}
+    constexpr ostream_iterator() noexcept = default;
 
-    front_insert_iterator& operator=(const iter_value_t<Container>& value)
-    {
-        cont_->push_front(value);
-        return *this;
-    }
+    ostream_iterator(ostream_type& os, const CharT* delim = nullptr) noexcept
+            : os_(std::addressof(os)), delim_(delim)
+    {}
 
-    front_insert_iterator& operator=(iter_value_t<Container>&& value)
+    ostream_iterator& operator=(const T& value)
     {
-        cont_->push_front(std::move(value));
+        *os_ << value;
+        if (delim_) {
+            *os_ << delim_;
+        }
         return *this;
     }
 
-    front_insert_iterator& operator*() { return *this; }
-    front_insert_iterator& operator++() { return *this; }
-    front_insert_iterator& operator++(int) { return *this; }
+    ostream_iterator& operator*() { return *this; }
+    ostream_iterator& operator++() { return *this; }
+    ostream_iterator& operator++(int) { return *this; }
 
 private:
-    container_type* cont_ = nullptr;
+    ostream_type* os_ = nullptr;
+    const char_type* delim_ = nullptr;
 };
 
-template <typename Container>
-front_insert_iterator<Container> front_inserter(Container& x)
-{
-    return front_insert_iterator<Container>(x);
-}
-
 NANO_END_NAMESPACE
 
 namespace std {
 
-template <typename Cont>
-struct iterator_traits<::nano::front_insert_iterator<Cont>> {
+template <typename T, typename C, typename Tr>
+struct iterator_traits<::nano::ranges::ostream_iterator<T, C, Tr>> {
     using value_type = void;
     using difference_type = ptrdiff_t;
     using reference = void;
     using pointer = void;
-    using iterator_category = output_iterator_tag;
+    using iterator_category = std::output_iterator_tag;
 };
 
-} // namespace std
+}
 
 #endif
-
-// nanorange/iterator/insert_iterator.hpp
+// nanorange/iterator/ostreambuf_iterator.hpp
 //
 // Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
 // Distributed under the Boost Software License, Version 1.0. (See accompanying
 // file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
-#ifndef NANORANGE_ITERATOR_INSERT_ITERATOR_HPP_INCLUDED
-#define NANORANGE_ITERATOR_INSERT_ITERATOR_HPP_INCLUDED
+#ifndef NANORANGE_ITERATOR_OSTREAMBUF_ITERATOR_HPP_INCLUDED
+#define NANORANGE_ITERATOR_OSTREAMBUF_ITERATOR_HPP_INCLUDED
 
 
 
+#include <iosfwd> // for basic_streambuf
 #include <iterator>
 
 NANO_BEGIN_NAMESPACE
 
-template <typename Container>
-struct insert_iterator {
-    using container_type = Container;
+template <typename CharT, typename Traits = std::char_traits<CharT>>
+struct ostreambuf_iterator {
+
+    using char_type = CharT;
+    using traits = Traits;
     using difference_type = std::ptrdiff_t;
+    using streambuf_type = std::basic_streambuf<CharT, Traits>;
+    using ostream_type = std::basic_ostream<CharT, Traits>;
 
-    constexpr insert_iterator() = default;
+    constexpr ostreambuf_iterator() = default;
 
-    explicit insert_iterator(Container& x, iterator_t<Container> i)
-        : cont_(std::addressof(x)), it_(i)
-    {}
+    ostreambuf_iterator(ostream_type& s) noexcept : sbuf_(s.rdbuf()) {}
 
-    insert_iterator& operator=(const iter_value_t<Container>& value)
-    {
-        cont_->insert(it_, value);
-        ++it_;
-        return *this;
-    }
+    ostreambuf_iterator(streambuf_type* s) noexcept : sbuf_(s) {}
 
-    insert_iterator& operator=(iter_value_t<Container>&& value)
+    ostreambuf_iterator& operator=(char_type c)
     {
-        cont_->push_back(it_, std::move(value));
-        ++it_;
+        if (!failed()) {
+            failed_ = (sbuf_->sputc(c) == traits::eof());
+        }
         return *this;
     }
 
-    insert_iterator& operator*() { return *this; }
-    insert_iterator& operator++() { return *this; }
-    insert_iterator& operator++(int) { return *this; }
+    ostreambuf_iterator& operator*() { return *this; }
+    ostreambuf_iterator& operator++() { return *this; }
+    ostreambuf_iterator& operator++(int) { return *this; }
+
+    bool failed() const noexcept { return failed_; }
 
 private:
-    container_type* cont_ = nullptr;
-    iterator_t<container_type> it_{};
+    streambuf_type* sbuf_ = nullptr;
+    bool failed_ = false;
 };
 
-template <typename Container>
-insert_iterator<Container> inserter(Container& x)
-{
-    return back_insert_iterator<Container>(x);
-}
-
 NANO_END_NAMESPACE
 
 namespace std {
 
-template <typename Container>
-struct iterator_traits<::nano::insert_iterator<Container>> {
+template <typename C, typename T>
+struct iterator_traits<::nano::ranges::ostreambuf_iterator<C, T>> {
     using value_type = void;
     using difference_type = ptrdiff_t;
     using reference = void;
@@ -14415,404 +21520,466 @@ struct iterator_traits<::nano::insert_iterator<Container>> {
 } // namespace std
 
 #endif
-// nanorange/iterator/istream_iterator.hpp
-//
-// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
-// Distributed under the Boost Software License, Version 1.0. (See accompanying
-// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
-
-#ifndef NANORANGE_ITERATOR_ISTREAM_ITERATOR_HPP_INCLUDED
-#define NANORANGE_ITERATOR_ISTREAM_ITERATOR_HPP_INCLUDED
-
 
 
 
-#include <iosfwd>
 
-NANO_BEGIN_NAMESPACE
+#endif
 
-template <typename T, typename CharT = char, typename Traits = std::char_traits<CharT>,
-          typename Distance = std::ptrdiff_t>
-class istream_iterator {
-public:
-    using iterator_category = input_iterator_tag;
-    using difference_type = Distance;
-    using value_type = T;
-    using reference = const T&;
-    using pointer = const T*;
-    using char_type = CharT;
-    using traits_type = Traits;
-    using istream_type = std::basic_istream<CharT, Traits>;
+// nanorange/memory.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
-    constexpr istream_iterator() = default;
+#ifndef NANORANGE_MEMORY_HPP_INCLUDED
 
-    constexpr istream_iterator(default_sentinel_t) {}
 
-    istream_iterator(istream_type& s)
-        : in_stream_(std::addressof(s))
-    {
-        s >> value_;
-    }
+// nanorange/memory/scratch_arena.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
-    istream_iterator(const istream_iterator& x) = default;
+#ifndef NANORANGE_MEMORY_SCRATCH_ARENA_HPP_INCLUDED
+#define NANORANGE_MEMORY_SCRATCH_ARENA_HPP_INCLUDED
 
-    ~istream_iterator() = default;
 
-    const T& operator*() const { return value_; }
 
-    const T* operator->() const { return std::addressof(value_); }
+#include <cassert>
+#include <cstddef>
 
-    istream_iterator& operator++()
-    {
-        *in_stream_ >> value_;
-        if (in_stream_->fail()) {
-            in_stream_ = nullptr;
-        }
-        return *this;
-    }
+#if NANO_HAS_MEMORY_RESOURCE
 
-    istream_iterator operator++(int)
-    {
-        istream_iterator tmp = *this;
-        this->operator++();
-        return tmp;
-    }
+NANO_BEGIN_NAMESPACE
 
-    friend bool operator==(const istream_iterator& x, const istream_iterator& y)
-    {
-        return x.in_stream_ == y.in_stream_;
-    }
+// Extension: a memory resource which holds on to a single block of memory
+// and hands it out again and again, so that repeated calls to algorithms
+// such as stable_sort() only go to the upstream resource when they need more
+// space than they did before. While the block is in use, further requests
+// are passed on to the upstream resource. Not thread-safe.
+class scratch_arena : public std::pmr::memory_resource {
+public:
+    explicit scratch_arena(
+        std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+        : upstream_(upstream)
+    {}
 
-    friend bool operator==(default_sentinel_t, const istream_iterator y)
+    explicit scratch_arena(
+        std::size_t initial_size,
+        std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+        : upstream_(upstream)
     {
-        return nullptr == y.in_stream_;
+        if (initial_size > 0) {
+            block_ = upstream_->allocate(initial_size, block_align);
+            size_ = initial_size;
+        }
     }
 
-    friend bool operator==(const istream_iterator& x, default_sentinel_t)
+    scratch_arena(const scratch_arena&) = delete;
+    scratch_arena& operator=(const scratch_arena&) = delete;
+
+    ~scratch_arena() override { release(); }
+
+    // Returns the block to the upstream resource. The block must not be in
+    // use.
+    void release()
     {
-        return x.in_stream_ == nullptr;
+        assert(!in_use_);
+        if (block_) {
+            upstream_->deallocate(block_, size_, block_align);
+            block_ = nullptr;
+            size_ = 0;
+        }
     }
 
-    friend bool operator!=(const istream_iterator& x, const istream_iterator& y)
+    std::size_t capacity() const { return size_; }
+
+    std::pmr::memory_resource* upstream_resource() const { return upstream_; }
+
+private:
+    static constexpr std::size_t block_align = alignof(std::max_align_t);
+
+    void* do_allocate(std::size_t bytes, std::size_t align) override
     {
-        return !(x == y);
+        if (in_use_ || align > block_align) {
+            return upstream_->allocate(bytes, align);
+        }
+
+        if (bytes > size_) {
+            release();
+            block_ = upstream_->allocate(bytes, block_align);
+            size_ = bytes;
+        }
+        in_use_ = true;
+        return block_;
     }
 
-    friend bool operator!=(default_sentinel_t x, const istream_iterator y)
+    void do_deallocate(void* p, std::size_t bytes, std::size_t align) override
     {
-        return !(x == y);
+        if (p == block_) {
+            in_use_ = false;
+        } else {
+            upstream_->deallocate(p, bytes, align);
+        }
     }
 
-    friend bool operator!=(const istream_iterator& x, default_sentinel_t y)
+    bool do_is_equal(const std::pmr::memory_resource& other) const
+        noexcept override
     {
-        return !(x == y);
+        return this == &other;
     }
 
-private:
-    istream_type* in_stream_ = nullptr;
-    T value_{};
+    std::pmr::memory_resource* upstream_;
+    void* block_ = nullptr;
+    std::size_t size_ = 0;
+    bool in_use_ = false;
 };
 
 NANO_END_NAMESPACE
 
+#endif // NANO_HAS_MEMORY_RESOURCE
+
 #endif
 
-// nanorange/iterator/istreambuf_iterator.hpp
+// nanorange/memory/uninitialized_copy.hpp
 //
 // Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
 // Distributed under the Boost Software License, Version 1.0. (See accompanying
 // file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
-#ifndef NANORANGE_ITERATOR_ISTREAMBUF_ITERATOR_HPP_INCLUDED
-#define NANORANGE_ITERATOR_ISTREAMBUF_ITERATOR_HPP_INCLUDED
-
+#ifndef NANORANGE_MEMORY_UNINITIALIZED_COPY_HPP_INCLUDED
+#define NANORANGE_MEMORY_UNINITIALIZED_COPY_HPP_INCLUDED
 
 
 
-#include <iosfwd>
 
 NANO_BEGIN_NAMESPACE
 
-template <typename CharT, typename Traits = std::char_traits<CharT>>
-class istreambuf_iterator {
-    class proxy {
-        friend class istreambuf_iterator;
-        CharT keep_;
-        std::basic_streambuf<CharT, Traits>* sbuf_;
-
-        proxy(CharT c, std::basic_streambuf<CharT, Traits>* sbuf)
-            : keep_(c), sbuf_(sbuf)
-        {}
-    public:
-        CharT operator*() const { return keep_; }
-    };
-
-public:
-    using iterator_category = input_iterator_tag;
-    using value_type = CharT;
-    using difference_type = typename Traits::off_type;
-    using reference = CharT;
-    using pointer = CharT*;
-    using char_type = CharT;
-    using traits_type = Traits;
-    using int_type = typename Traits::int_type;
-    using streambuf_type = std::basic_streambuf<CharT, Traits>;
-    using istream_type = std::basic_istream<CharT, Traits>;
-
-    constexpr istreambuf_iterator() noexcept = default;
-
-    constexpr istreambuf_iterator(default_sentinel_t) noexcept {}
-
-    istreambuf_iterator(const istreambuf_iterator&) noexcept = default;
-
-    ~istreambuf_iterator() = default;
-
-    istreambuf_iterator(istream_type& s) noexcept
-        : sbuf_(s.rdbuf())
-    {}
-
-    istreambuf_iterator(streambuf_type* s) noexcept
-        : sbuf_(s)
-    {}
+template <typename I, typename O>
+using uninitialized_copy_result = in_out_result<I, O>;
 
-    istreambuf_iterator(const proxy& p) noexcept
-        : sbuf_(p.sbuf_)
-    {}
+namespace detail {
 
-    char_type operator*() const { return Traits::to_char_type(sbuf_->sgetc()); }
+struct uninitialized_copy_fn {
+private:
+    friend struct uninitialized_copy_n_fn;
 
-    istreambuf_iterator& operator++()
+    template <typename I, typename S, typename O, typename S2>
+    static uninitialized_copy_result<I, O>
+    impl4(I ifirst, S ilast, O ofirst, S2 olast)
     {
-        sbuf_->sbumpc();
-        return *this;
+        O oit = ofirst;
+        try {
+            for (; ifirst != ilast && oit != olast; ++ifirst, (void) ++oit) {
+                ::new(detail::voidify(*oit))
+                        std::remove_reference_t<iter_reference_t<O>>(*ifirst);
+            }
+            return {std::move(ifirst), std::move(oit)};
+        } catch (...) {
+            nano::destroy(ofirst, ++oit);
+            throw;
+        }
     }
 
-    proxy operator++(int)
+    template <typename I, typename S, typename O>
+    static uninitialized_copy_result<I, O>
+    impl3(I ifirst, S ilast, O ofirst)
     {
-        return proxy(Traits::to_char_type(sbuf_->sbumpc()), sbuf_);
+        O oit = ofirst;
+        try {
+            for (; ifirst != ilast; ++ifirst, (void) ++oit) {
+                ::new(const_cast<void*>(static_cast<const volatile void*>(std::addressof(
+                        *oit))))
+                        std::remove_reference_t<iter_reference_t<O>>(*ifirst);
+            }
+            return {std::move(ifirst), std::move(oit)};
+        } catch (...) {
+            nano::destroy(ofirst, ++oit);
+            throw;
+        }
     }
 
-    bool equal(const istreambuf_iterator& b) const
+public:
+    // Four-legged
+    template <typename I, typename S, typename O, typename S2>
+    std::enable_if_t<
+        input_iterator<I> && sentinel_for<S, I> &&
+            no_throw_forward_iterator<O> &&
+            no_throw_sentinel<S2, O> &&
+        constructible_from<iter_value_t<O>, iter_reference_t<I>>,
+        uninitialized_copy_result<I, O>>
+    operator()(I ifirst, S ilast, O ofirst, S2 olast) const
     {
-        return  is_eof() == b.is_eof();
+        return uninitialized_copy_fn::impl4(
+                std::move(ifirst), std::move(ilast),
+                std::move(ofirst), std::move(olast));
     }
 
-private:
-    bool is_eof() const
+    // Two ranges
+    template <typename IRng, typename ORng>
+    std::enable_if_t<
+        input_range<IRng> && no_throw_forward_range<ORng> &&
+        constructible_from<iter_value_t<iterator_t<ORng>>, iter_reference_t<iterator_t<IRng>>>,
+        uninitialized_copy_result<borrowed_iterator_t<IRng>,
+                                               borrowed_iterator_t<ORng>>>
+    operator()(IRng&& irng, ORng&& orng) const
     {
-        if (sbuf_ && sbuf_->sgetc() == Traits::eof()) {
-            sbuf_ = nullptr;
-            return true;
-        }
+        return uninitialized_copy_fn::impl4(
+                nano::begin(irng), nano::end(irng),
+                nano::begin(orng), nano::end(orng));
+    }
 
-        return sbuf_ == nullptr;
+    // Three-legged
+    template <typename I, typename S, typename O>
+    NANO_DEPRECATED
+    std::enable_if_t<
+        input_iterator<I> && sentinel_for<S, I> &&
+            no_throw_forward_iterator<O> &&
+        constructible_from<iter_value_t<O>, iter_reference_t<I>>,
+        uninitialized_copy_result<I, O>>
+    operator()(I ifirst, S ilast, O ofirst) const
+    {
+        return uninitialized_copy_fn::impl3(std::move(ifirst), std::move(ilast),
+                                            std::move(ofirst));
     }
 
-    mutable streambuf_type* sbuf_ = nullptr;
+    // Range and a half
+    template <typename IRng, typename O>
+    NANO_DEPRECATED
+    std::enable_if_t<
+        input_range<IRng> && no_throw_forward_iterator<std::decay_t<O>> &&
+        !no_throw_forward_range<O> &&
+        constructible_from<iter_value_t<std::decay_t<O>>, iter_reference_t<iterator_t<IRng>>>,
+        uninitialized_copy_result<borrowed_iterator_t<IRng>, std::decay_t<O>>>
+    operator()(IRng&& irng, O&& ofirst) const
+    {
+        return uninitialized_copy_fn::impl3(
+                nano::begin(irng), nano::end(irng), std::forward<O>(ofirst));
+    }
 };
 
-template <typename CharT, typename Traits>
-bool operator==(const istreambuf_iterator<CharT, Traits>& a,
-                const istreambuf_iterator<CharT, Traits>& b)
-{
-    return a.equal(b);
 }
 
-template <typename CharT, typename Traits>
-bool operator==(default_sentinel_t,
-                const istreambuf_iterator<CharT, Traits>& b)
-{
-    return istreambuf_iterator<CharT, Traits>{}.equal(b);
-}
+NANO_INLINE_VAR(detail::uninitialized_copy_fn, uninitialized_copy)
 
-template <typename CharT, typename Traits>
-bool operator==(const istreambuf_iterator<CharT, Traits>& a,
-                default_sentinel_t)
-{
-    return a.equal(istreambuf_iterator<CharT, Traits>{});
-}
+template <typename I, typename O>
+using uninitialized_copy_n_result = in_out_result<I, O>;
 
-template <typename CharT, typename Traits>
-bool operator!=(const istreambuf_iterator<CharT, Traits>& a,
-                const istreambuf_iterator<CharT, Traits>& b)
-{
-    return !(a == b);
-}
+namespace detail {
 
-template <typename CharT, typename Traits>
-bool operator!=(default_sentinel_t a,
-                const istreambuf_iterator<CharT, Traits>& b)
-{
-    return !(a == b);
-}
+struct uninitialized_copy_n_fn {
+    template <typename I, typename O, typename S>
+    std::enable_if_t<
+        input_iterator<I> && no_throw_forward_iterator<O> &&
+            no_throw_sentinel<S, O> &&
+        constructible_from<iter_value_t<O>, iter_reference_t<I>>,
+        uninitialized_copy_n_result<I, O>>
+    operator()(I ifirst, iter_difference_t<I> n, O ofirst, S olast) const
+    {
+        auto t = uninitialized_copy_fn::impl4(
+                    make_counted_iterator(std::move(ifirst), n),
+                    default_sentinel, std::move(ofirst), std::move(olast));
+        return {std::move(t).in.base(), std::move(t).out};
+    }
+
+    template <typename I, typename O>
+    NANO_DEPRECATED
+    std::enable_if_t<
+        input_iterator<I> && no_throw_forward_iterator<O> &&
+        constructible_from<iter_value_t<O>, iter_reference_t<I>>,
+        uninitialized_copy_n_result<I, O>>
+    operator()(I ifirst, iter_difference_t<I> n, O ofirst) const
+    {
+        auto t = uninitialized_copy_fn::impl3(
+                make_counted_iterator(std::move(ifirst), n),
+                default_sentinel, std::move(ofirst));
+        return {std::move(t).in.base(), std::move(t).out};
+    }
+
+};
 
-template <typename CharT, typename Traits>
-bool operator!=(const istreambuf_iterator<CharT, Traits>& a,
-                default_sentinel_t b)
-{
-    return !(a == b);
 }
 
+NANO_INLINE_VAR(detail::uninitialized_copy_n_fn, uninitialized_copy_n)
+
 NANO_END_NAMESPACE
 
 #endif
 
-
-
-// nanorange/iterator/ostream_iterator.hpp
+// nanorange/memory/uninitialized_default_construct.hpp
 //
 // Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
 // Distributed under the Boost Software License, Version 1.0. (See accompanying
-// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
-
-#ifndef NANORANGE_ITERATOR_OSTREAM_ITERATOR_HPP_INCLUDED
-#define NANORANGE_ITERATOR_OSTREAM_ITERATOR_HPP_INCLUDED
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
+#ifndef NANORANGE_MEMORY_UNINITIALIZED_DEFAULT_CONSTRUCT_HPP_INCLUDED
+#define NANORANGE_MEMORY_UNINITIALIZED_DEFAULT_CONSTRUCT_HPP_INCLUDED
 
 
-#include <iosfwd>
-#include <iterator>
-#include <memory>
 
 NANO_BEGIN_NAMESPACE
 
-template <typename T, typename CharT = char, typename Traits = std::char_traits<CharT>>
-struct ostream_iterator
-{
-    using char_type = CharT;
-    using traits_type = Traits;
-    using ostream_type = std::basic_ostream<CharT, Traits>;
-    using difference_type = std::ptrdiff_t;
-
-    constexpr ostream_iterator() noexcept = default;
-
-    ostream_iterator(ostream_type& os, const CharT* delim = nullptr) noexcept
-            : os_(std::addressof(os)), delim_(delim)
-    {}
+namespace detail {
 
-    ostream_iterator& operator=(const T& value)
+struct uninitialized_default_construct_fn {
+private:
+    template <typename I, typename S>
+    static I impl(I first, S last)
     {
-        *os_ << value;
-        if (delim_) {
-            *os_ << delim_;
+        I it = first;
+        try {
+            for (; it != last; ++it) {
+                ::new(detail::voidify(*it)) std::remove_reference_t<iter_reference_t<I>>;
+            }
+            return it;
+        } catch (...) {
+            nano::destroy(first, ++it);
+            throw;
         }
-        return *this;
     }
 
-    ostream_iterator& operator*() { return *this; }
-    ostream_iterator& operator++() { return *this; }
-    ostream_iterator& operator++(int) { return *this; }
+public:
+    template <typename I, typename S>
+    std::enable_if_t<no_throw_forward_iterator<I> && no_throw_sentinel<S, I> &&
+                         default_initializable<iter_value_t<I>>, I>
+    operator()(I first, S last) const
+    {
+        return uninitialized_default_construct_fn::impl(
+                std::move(first), std::move(last));
+    }
 
-private:
-    ostream_type* os_ = nullptr;
-    const char_type* delim_ = nullptr;
+    template <typename Rng>
+    std::enable_if_t<no_throw_forward_range<Rng> &&
+                         default_initializable<iter_value_t<iterator_t<Rng>>>,
+                     borrowed_iterator_t<Rng>>
+    operator()(Rng&& rng) const
+    {
+        return uninitialized_default_construct_fn::impl(
+                nano::begin(rng), nano::end(rng));
+    }
 };
 
-NANO_END_NAMESPACE
+}
 
-namespace std {
+NANO_INLINE_VAR(detail::uninitialized_default_construct_fn,
+                uninitialized_default_construct)
+
+namespace detail {
+
+struct uninitialized_default_construct_n_fn {
+    template <typename I>
+    std::enable_if_t<no_throw_forward_iterator<I> &&
+                         default_initializable<iter_value_t<I>>, I>
+    operator()(I first, iter_difference_t<I> n) const
+    {
+        return nano::uninitialized_default_construct(
+                    make_counted_iterator(std::move(first), n),
+                    default_sentinel).base();
+    }
 
-template <typename T, typename C, typename Tr>
-struct iterator_traits<::nano::ranges::ostream_iterator<T, C, Tr>> {
-    using value_type = void;
-    using difference_type = ptrdiff_t;
-    using reference = void;
-    using pointer = void;
-    using iterator_category = std::output_iterator_tag;
 };
 
 }
 
+NANO_INLINE_VAR(detail::uninitialized_default_construct_n_fn,
+                uninitialized_default_construct_n)
+
+NANO_END_NAMESPACE
+
 #endif
-// nanorange/iterator/ostreambuf_iterator.hpp
+
+// nanorange/memory/uninitialized_fill.hpp
 //
 // Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
 // Distributed under the Boost Software License, Version 1.0. (See accompanying
 // file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
-#ifndef NANORANGE_ITERATOR_OSTREAMBUF_ITERATOR_HPP_INCLUDED
-#define NANORANGE_ITERATOR_OSTREAMBUF_ITERATOR_HPP_INCLUDED
-
+#ifndef NANORANGE_MEMORY_UNINITIALIZED_FILL_HPP_INCLUDED
+#define NANORANGE_MEMORY_UNINITIALIZED_FILL_HPP_INCLUDED
 
 
-#include <iosfwd> // for basic_streambuf
-#include <iterator>
 
 NANO_BEGIN_NAMESPACE
 
-template <typename CharT, typename Traits = std::char_traits<CharT>>
-struct ostreambuf_iterator {
-
-    using char_type = CharT;
-    using traits = Traits;
-    using difference_type = std::ptrdiff_t;
-    using streambuf_type = std::basic_streambuf<CharT, Traits>;
-    using ostream_type = std::basic_ostream<CharT, Traits>;
-
-    constexpr ostreambuf_iterator() = default;
-
-    ostreambuf_iterator(ostream_type& s) noexcept : sbuf_(s.rdbuf()) {}
+namespace detail {
 
-    ostreambuf_iterator(streambuf_type* s) noexcept : sbuf_(s) {}
+struct uninitialized_fill_fn {
+private:
+    friend struct uninitialized_fill_n_fn;
 
-    ostreambuf_iterator& operator=(char_type c)
+    template <typename I, typename S, typename T>
+    static I impl(I first, S last, const T& x)
     {
-        if (!failed()) {
-            failed_ = (sbuf_->sputc(c) == traits::eof());
+        I it = first;
+        try {
+            for (; it != last; ++it) {
+                ::new(detail::voidify(*it))
+                        std::remove_reference_t<iter_reference_t<I>>(x);
+            }
+            return it;
+        } catch (...) {
+            nano::destroy(first, ++it);
+            throw;
         }
-        return *this;
     }
 
-    ostreambuf_iterator& operator*() { return *this; }
-    ostreambuf_iterator& operator++() { return *this; }
-    ostreambuf_iterator& operator++(int) { return *this; }
-
-    bool failed() const noexcept { return failed_; }
+public:
+    template <typename I, typename S, typename T>
+    std::enable_if_t<no_throw_forward_iterator<I> && no_throw_sentinel<S, I> &&
+        constructible_from<iter_value_t<I>, const T&>,
+        I>
+    operator()(I first, S last, const T& x) const
+    {
+        return uninitialized_fill_fn::impl(std::move(first), std::move(last), x);
+    }
 
-private:
-    streambuf_type* sbuf_ = nullptr;
-    bool failed_ = false;
+    template <typename Rng, typename T>
+    std::enable_if_t<
+        no_throw_forward_range<Rng> &&
+        constructible_from<iter_value_t<iterator_t<Rng>>, const T&>,
+        borrowed_iterator_t<Rng>>
+    operator()(Rng&& rng, const T& x) const
+    {
+        return uninitialized_fill_fn::impl(nano::begin(rng), nano::end(rng), x);
+    }
 };
 
-NANO_END_NAMESPACE
-
-namespace std {
+}
 
-template <typename C, typename T>
-struct iterator_traits<::nano::ranges::ostreambuf_iterator<C, T>> {
-    using value_type = void;
-    using difference_type = ptrdiff_t;
-    using reference = void;
-    using pointer = void;
-    using iterator_category = output_iterator_tag;
-};
+NANO_INLINE_VAR(detail::uninitialized_fill_fn, uninitialized_fill)
 
-} // namespace std
+namespace detail {
 
-#endif
+struct uninitialized_fill_n_fn {
+    template <typename I, typename T>
+    std::enable_if_t<no_throw_forward_iterator<I> &&
+        constructible_from<iter_value_t<I>, const T&>,
+        I>
+    operator()(I first, iter_difference_t<I> n, const T& x) const
+    {
+        return uninitialized_fill_fn::impl(
+                    make_counted_iterator(std::move(first), n),
+                    default_sentinel, x).base();
+    }
+};
 
+}
 
+NANO_INLINE_VAR(detail::uninitialized_fill_n_fn, uninitialized_fill_n)
 
+NANO_END_NAMESPACE
 
 #endif
 
-// nanorange/memory.hpp
-//
-// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
-// Distributed under the Boost Software License, Version 1.0. (See accompanying
-// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
-
-#ifndef NANORANGE_MEMORY_HPP_INCLUDED
-
-
-// nanorange/memory/uninitialized_copy.hpp
+// nanorange/memory/uninitialized_move.hpp
 //
 // Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
 // Distributed under the Boost Software License, Version 1.0. (See accompanying
 // file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
-#ifndef NANORANGE_MEMORY_UNINITIALIZED_COPY_HPP_INCLUDED
-#define NANORANGE_MEMORY_UNINITIALIZED_COPY_HPP_INCLUDED
+#ifndef NANORANGE_MEMORY_UNINITIALIZED_MOVE_HPP_INCLUDED
+#define NANORANGE_MEMORY_UNINITIALIZED_MOVE_HPP_INCLUDED
 
 
 
@@ -14820,23 +21987,23 @@ struct iterator_traits<::nano::ranges::ostreambuf_iterator<C, T>> {
 NANO_BEGIN_NAMESPACE
 
 template <typename I, typename O>
-using uninitialized_copy_result = in_out_result<I, O>;
+using uninitialized_move_result = in_out_result<I, O>;
 
 namespace detail {
 
-struct uninitialized_copy_fn {
+struct uninitialized_move_fn {
 private:
-    friend struct uninitialized_copy_n_fn;
+    friend struct uninitialized_move_n_fn;
 
     template <typename I, typename S, typename O, typename S2>
-    static uninitialized_copy_result<I, O>
+    static uninitialized_move_result<I, O>
     impl4(I ifirst, S ilast, O ofirst, S2 olast)
     {
         O oit = ofirst;
         try {
             for (; ifirst != ilast && oit != olast; ++ifirst, (void) ++oit) {
                 ::new(detail::voidify(*oit))
-                        std::remove_reference_t<iter_reference_t<O>>(*ifirst);
+                        std::remove_reference_t<iter_reference_t<O>>(nano::iter_move(ifirst));
             }
             return {std::move(ifirst), std::move(oit)};
         } catch (...) {
@@ -14846,15 +22013,14 @@ private:
     }
 
     template <typename I, typename S, typename O>
-    static uninitialized_copy_result<I, O>
+    static uninitialized_move_result<I, O>
     impl3(I ifirst, S ilast, O ofirst)
     {
         O oit = ofirst;
         try {
             for (; ifirst != ilast; ++ifirst, (void) ++oit) {
-                ::new(const_cast<void*>(static_cast<const volatile void*>(std::addressof(
-                        *oit))))
-                        std::remove_reference_t<iter_reference_t<O>>(*ifirst);
+                ::new(detail::voidify(*oit))
+                        std::remove_reference_t<iter_reference_t<O>>(nano::iter_move(ifirst));
             }
             return {std::move(ifirst), std::move(oit)};
         } catch (...) {
@@ -14870,11 +22036,11 @@ public:
         input_iterator<I> && sentinel_for<S, I> &&
             no_throw_forward_iterator<O> &&
             no_throw_sentinel<S2, O> &&
-        constructible_from<iter_value_t<O>, iter_reference_t<I>>,
-        uninitialized_copy_result<I, O>>
+        constructible_from<iter_value_t<O>, iter_rvalue_reference_t<I>>,
+        uninitialized_move_result<I, O>>
     operator()(I ifirst, S ilast, O ofirst, S2 olast) const
     {
-        return uninitialized_copy_fn::impl4(
+        return uninitialized_move_fn::impl4(
                 std::move(ifirst), std::move(ilast),
                 std::move(ofirst), std::move(olast));
     }
@@ -14883,12 +22049,12 @@ public:
     template <typename IRng, typename ORng>
     std::enable_if_t<
         input_range<IRng> && no_throw_forward_range<ORng> &&
-        constructible_from<iter_value_t<iterator_t<ORng>>, iter_reference_t<iterator_t<IRng>>>,
-        uninitialized_copy_result<borrowed_iterator_t<IRng>,
-                                               borrowed_iterator_t<ORng>>>
+        constructible_from<iter_value_t<iterator_t<ORng>>, iter_rvalue_reference_t<iterator_t<IRng>>>,
+        uninitialized_move_result<borrowed_iterator_t<IRng>,
+                                  borrowed_iterator_t<ORng>>>
     operator()(IRng&& irng, ORng&& orng) const
     {
-        return uninitialized_copy_fn::impl4(
+        return uninitialized_move_fn::impl4(
                 nano::begin(irng), nano::end(irng),
                 nano::begin(orng), nano::end(orng));
     }
@@ -14899,11 +22065,11 @@ public:
     std::enable_if_t<
         input_iterator<I> && sentinel_for<S, I> &&
             no_throw_forward_iterator<O> &&
-        constructible_from<iter_value_t<O>, iter_reference_t<I>>,
-        uninitialized_copy_result<I, O>>
+        constructible_from<iter_value_t<O>, iter_rvalue_reference_t<I>>,
+        uninitialized_move_result<I, O>>
     operator()(I ifirst, S ilast, O ofirst) const
     {
-        return uninitialized_copy_fn::impl3(std::move(ifirst), std::move(ilast),
+        return uninitialized_move_fn::impl3(std::move(ifirst), std::move(ilast),
                                             std::move(ofirst));
     }
 
@@ -14913,34 +22079,34 @@ public:
     std::enable_if_t<
         input_range<IRng> && no_throw_forward_iterator<std::decay_t<O>> &&
         !no_throw_forward_range<O> &&
-        constructible_from<iter_value_t<std::decay_t<O>>, iter_reference_t<iterator_t<IRng>>>,
-        uninitialized_copy_result<borrowed_iterator_t<IRng>, std::decay_t<O>>>
+        constructible_from<iter_value_t<std::decay_t<O>>, iter_rvalue_reference_t<iterator_t<IRng>>>,
+        uninitialized_move_result<borrowed_iterator_t<IRng>, std::decay_t<O>>>
     operator()(IRng&& irng, O&& ofirst) const
     {
-        return uninitialized_copy_fn::impl3(
+        return uninitialized_move_fn::impl3(
                 nano::begin(irng), nano::end(irng), std::forward<O>(ofirst));
     }
 };
 
 }
 
-NANO_INLINE_VAR(detail::uninitialized_copy_fn, uninitialized_copy)
+NANO_INLINE_VAR(detail::uninitialized_move_fn, uninitialized_move)
 
 template <typename I, typename O>
-using uninitialized_copy_n_result = in_out_result<I, O>;
+using uninitialized_move_n_result = in_out_result<I, O>;
 
 namespace detail {
 
-struct uninitialized_copy_n_fn {
+struct uninitialized_move_n_fn {
     template <typename I, typename O, typename S>
     std::enable_if_t<
         input_iterator<I> && no_throw_forward_iterator<O> &&
             no_throw_sentinel<S, O> &&
-        constructible_from<iter_value_t<O>, iter_reference_t<I>>,
-        uninitialized_copy_n_result<I, O>>
+        constructible_from<iter_value_t<O>, iter_rvalue_reference_t<I>>,
+        uninitialized_move_n_result<I, O>>
     operator()(I ifirst, iter_difference_t<I> n, O ofirst, S olast) const
     {
-        auto t = uninitialized_copy_fn::impl4(
+        auto t = uninitialized_move_fn::impl4(
                     make_counted_iterator(std::move(ifirst), n),
                     default_sentinel, std::move(ofirst), std::move(olast));
         return {std::move(t).in.base(), std::move(t).out};
@@ -14950,11 +22116,11 @@ struct uninitialized_copy_n_fn {
     NANO_DEPRECATED
     std::enable_if_t<
         input_iterator<I> && no_throw_forward_iterator<O> &&
-        constructible_from<iter_value_t<O>, iter_reference_t<I>>,
-        uninitialized_copy_n_result<I, O>>
+        constructible_from<iter_value_t<O>, iter_rvalue_reference_t<I>>,
+        uninitialized_move_n_result<I, O>>
     operator()(I ifirst, iter_difference_t<I> n, O ofirst) const
     {
-        auto t = uninitialized_copy_fn::impl3(
+        auto t = uninitialized_move_fn::impl3(
                 make_counted_iterator(std::move(ifirst), n),
                 default_sentinel, std::move(ofirst));
         return {std::move(t).in.base(), std::move(t).out};
@@ -14964,20 +22130,20 @@ struct uninitialized_copy_n_fn {
 
 }
 
-NANO_INLINE_VAR(detail::uninitialized_copy_n_fn, uninitialized_copy_n)
+NANO_INLINE_VAR(detail::uninitialized_move_n_fn, uninitialized_move_n)
 
 NANO_END_NAMESPACE
 
 #endif
 
-// nanorange/memory/uninitialized_default_construct.hpp
+// nanorange/memory/uninitialized_value_construct.hpp
 //
 // Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
 // Distributed under the Boost Software License, Version 1.0. (See accompanying
 // file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
-#ifndef NANORANGE_MEMORY_UNINITIALIZED_DEFAULT_CONSTRUCT_HPP_INCLUDED
-#define NANORANGE_MEMORY_UNINITIALIZED_DEFAULT_CONSTRUCT_HPP_INCLUDED
+#ifndef NANORANGE_MEMORY_UNINITIALIZED_VALUE_CONSTRUCT_HPP_INCLUDED
+#define NANORANGE_MEMORY_UNINITIALIZED_VALUE_CONSTRUCT_HPP_INCLUDED
 
 
 
@@ -14985,7 +22151,7 @@ NANO_BEGIN_NAMESPACE
 
 namespace detail {
 
-struct uninitialized_default_construct_fn {
+struct uninitialized_value_construct_fn {
 private:
     template <typename I, typename S>
     static I impl(I first, S last)
@@ -14993,7 +22159,7 @@ private:
         I it = first;
         try {
             for (; it != last; ++it) {
-                ::new(detail::voidify(*it)) std::remove_reference_t<iter_reference_t<I>>;
+                ::new(detail::voidify(*it)) std::remove_reference_t<iter_reference_t<I>>();
             }
             return it;
         } catch (...) {
@@ -15008,7 +22174,7 @@ public:
                          default_initializable<iter_value_t<I>>, I>
     operator()(I first, S last) const
     {
-        return uninitialized_default_construct_fn::impl(
+        return uninitialized_value_construct_fn::impl(
                 std::move(first), std::move(last));
     }
 
@@ -15018,25 +22184,25 @@ public:
                      borrowed_iterator_t<Rng>>
     operator()(Rng&& rng) const
     {
-        return uninitialized_default_construct_fn::impl(
+        return uninitialized_value_construct_fn::impl(
                 nano::begin(rng), nano::end(rng));
     }
 };
 
 }
 
-NANO_INLINE_VAR(detail::uninitialized_default_construct_fn,
-                uninitialized_default_construct)
+NANO_INLINE_VAR(detail::uninitialized_value_construct_fn,
+                uninitialized_value_construct)
 
 namespace detail {
 
-struct uninitialized_default_construct_n_fn {
+struct uninitialized_value_construct_n_fn {
     template <typename I>
     std::enable_if_t<no_throw_forward_iterator<I> &&
                          default_initializable<iter_value_t<I>>, I>
     operator()(I first, iter_difference_t<I> n) const
     {
-        return nano::uninitialized_default_construct(
+        return nano::uninitialized_value_construct(
                     make_counted_iterator(std::move(first), n),
                     default_sentinel).base();
     }
@@ -15045,21 +22211,58 @@ struct uninitialized_default_construct_n_fn {
 
 }
 
-NANO_INLINE_VAR(detail::uninitialized_default_construct_n_fn,
-                uninitialized_default_construct_n)
+NANO_INLINE_VAR(detail::uninitialized_value_construct_n_fn,
+                uninitialized_value_construct_n)
 
 NANO_END_NAMESPACE
 
 #endif
 
-// nanorange/memory/uninitialized_fill.hpp
+
+#endif
+
+
+
+
+// nanorange/utility.hpp
 //
 // Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
 // Distributed under the Boost Software License, Version 1.0. (See accompanying
 // file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
-#ifndef NANORANGE_MEMORY_UNINITIALIZED_FILL_HPP_INCLUDED
-#define NANORANGE_MEMORY_UNINITIALIZED_FILL_HPP_INCLUDED
+#ifndef NANORANGE_UTILITY_HPP_INCLUDED
+#define NANORANGE_UTILITY_HPP_INCLUDED
+
+
+
+#endif
+
+// nanorange/range.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_VIEWS_HPP_INCLUDED
+#define NANORANGE_VIEWS_HPP_INCLUDED
+
+// nanorange/views/all.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_VIEWS_ALL_HPP_INCLUDED
+#define NANORANGE_VIEWS_ALL_HPP_INCLUDED
+
+// nanorange/detail/views/range_adaptors.hpp
+//
+// Copyright (c) 2019 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_DETAIL_VIEW_RANGE_ADAPTORS_HPP_INCLUDED
+#define NANORANGE_DETAIL_VIEW_RANGE_ADAPTORS_HPP_INCLUDED
 
 
 
@@ -15067,868 +22270,825 @@ NANO_BEGIN_NAMESPACE
 
 namespace detail {
 
-struct uninitialized_fill_fn {
-private:
-    friend struct uninitialized_fill_n_fn;
+template <typename>
+inline constexpr bool is_raco = false;
 
-    template <typename I, typename S, typename T>
-    static I impl(I first, S last, const T& x)
-    {
-        I it = first;
-        try {
-            for (; it != last; ++it) {
-                ::new(detail::voidify(*it))
-                        std::remove_reference_t<iter_reference_t<I>>(x);
-            }
-            return it;
-        } catch (...) {
-            nano::destroy(first, ++it);
-            throw;
-        }
-    }
+template <typename R, typename C,
+          typename = std::enable_if_t<
+              viewable_range<R> &&
+              !is_raco<remove_cvref_t<R>> && is_raco<remove_cvref_t<C>>>>
+constexpr auto operator|(R&& lhs, C&& rhs)
+    -> decltype(std::forward<C>(rhs)(std::forward<R>(lhs)))
+{
+    return std::forward<C>(rhs)(std::forward<R>(lhs));
+}
+
+template <typename LHS, typename RHS>
+struct raco_pipe {
+private:
+    LHS lhs_;
+    RHS rhs_;
 
 public:
-    template <typename I, typename S, typename T>
-    std::enable_if_t<no_throw_forward_iterator<I> && no_throw_sentinel<S, I> &&
-        constructible_from<iter_value_t<I>, const T&>,
-        I>
-    operator()(I first, S last, const T& x) const
+    constexpr raco_pipe(LHS&& lhs, RHS&& rhs)
+        : lhs_(std::move(lhs)),
+          rhs_(std::move(rhs))
+    {}
+
+    // FIXME: Do I need to do ref-qualified overloads of these too?
+
+    template <typename R, std::enable_if_t<viewable_range<R>, int> = 0>
+    constexpr auto operator()(R&& r)
+        -> decltype(rhs_(lhs_(std::forward<R>(r))))
     {
-        return uninitialized_fill_fn::impl(std::move(first), std::move(last), x);
+        return rhs_(lhs_(std::forward<R>(r)));
     }
 
-    template <typename Rng, typename T>
-    std::enable_if_t<
-        no_throw_forward_range<Rng> &&
-        constructible_from<iter_value_t<iterator_t<Rng>>, const T&>,
-        borrowed_iterator_t<Rng>>
-    operator()(Rng&& rng, const T& x) const
+
+    template <typename R, std::enable_if_t<viewable_range<R>, int> = 0>
+    constexpr auto operator()(R&& r) const
+        -> decltype(rhs_(lhs_(std::forward<R>(r))))
     {
-        return uninitialized_fill_fn::impl(nano::begin(rng), nano::end(rng), x);
+        return rhs_(lhs_(std::forward<R>(r)));
     }
 };
 
-}
-
-NANO_INLINE_VAR(detail::uninitialized_fill_fn, uninitialized_fill)
+template <typename LHS, typename RHS>
+inline constexpr bool is_raco<raco_pipe<LHS, RHS>> = true;
 
-namespace detail {
+template <typename LHS, typename RHS>
+constexpr auto operator|(LHS&& lhs, RHS&& rhs)
+    -> std::enable_if_t<
+        is_raco<remove_cvref_t<LHS>> && is_raco<remove_cvref_t<RHS>>,
+        raco_pipe<LHS, RHS>>
+{
+    return raco_pipe<LHS, RHS>{std::forward<LHS>(lhs), std::forward<RHS>(rhs)};
+}
 
-struct uninitialized_fill_n_fn {
-    template <typename I, typename T>
-    std::enable_if_t<no_throw_forward_iterator<I> &&
-        constructible_from<iter_value_t<I>, const T&>,
-        I>
-    operator()(I first, iter_difference_t<I> n, const T& x) const
-    {
-        return uninitialized_fill_fn::impl(
-                    make_counted_iterator(std::move(first), n),
-                    default_sentinel, x).base();
-    }
+template <typename Lambda>
+struct rao_proxy : Lambda {
+    constexpr explicit rao_proxy(Lambda&& l) : Lambda(std::move(l)) {}
 };
 
-}
+template <typename L>
+inline constexpr bool is_raco<rao_proxy<L>> = true;
 
-NANO_INLINE_VAR(detail::uninitialized_fill_n_fn, uninitialized_fill_n)
+} // namespace detail
 
 NANO_END_NAMESPACE
 
 #endif
 
-// nanorange/memory/uninitialized_move.hpp
+// nanorange/detail/views/ref.hpp
 //
 // Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
 // Distributed under the Boost Software License, Version 1.0. (See accompanying
 // file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
-#ifndef NANORANGE_MEMORY_UNINITIALIZED_MOVE_HPP_INCLUDED
-#define NANORANGE_MEMORY_UNINITIALIZED_MOVE_HPP_INCLUDED
-
+#ifndef NANORANGE_VIEWS_REF_HPP_INCLUDED
+#define NANORANGE_VIEWS_REF_HPP_INCLUDED
 
 
 
 NANO_BEGIN_NAMESPACE
 
-template <typename I, typename O>
-using uninitialized_move_result = in_out_result<I, O>;
+namespace ref_view_ {
 
-namespace detail {
+template <typename R>
+class ref_view : public view_interface<ref_view<R>> {
 
-struct uninitialized_move_fn {
-private:
-    friend struct uninitialized_move_n_fn;
+    static_assert(range<R> && std::is_object<R>::value, "");
 
-    template <typename I, typename S, typename O, typename S2>
-    static uninitialized_move_result<I, O>
-    impl4(I ifirst, S ilast, O ofirst, S2 olast)
-    {
-        O oit = ofirst;
-        try {
-            for (; ifirst != ilast && oit != olast; ++ifirst, (void) ++oit) {
-                ::new(detail::voidify(*oit))
-                        std::remove_reference_t<iter_reference_t<O>>(nano::iter_move(ifirst));
-            }
-            return {std::move(ifirst), std::move(oit)};
-        } catch (...) {
-            nano::destroy(ofirst, ++oit);
-            throw;
-        }
-    }
+    R* r_ = nullptr;
 
-    template <typename I, typename S, typename O>
-    static uninitialized_move_result<I, O>
-    impl3(I ifirst, S ilast, O ofirst)
-    {
-        O oit = ofirst;
-        try {
-            for (; ifirst != ilast; ++ifirst, (void) ++oit) {
-                ::new(detail::voidify(*oit))
-                        std::remove_reference_t<iter_reference_t<O>>(nano::iter_move(ifirst));
-            }
-            return {std::move(ifirst), std::move(oit)};
-        } catch (...) {
-            nano::destroy(ofirst, ++oit);
-            throw;
-        }
-    }
+    struct constructor_req {
+        static void FUN(R&);
+        static void FUN(R&&) = delete;
+
+        template <typename T>
+        auto requires_() -> decltype(FUN(std::declval<T>()));
+    };
 
 public:
-    // Four-legged
-    template <typename I, typename S, typename O, typename S2>
-    std::enable_if_t<
-        input_iterator<I> && sentinel_for<S, I> &&
-            no_throw_forward_iterator<O> &&
-            no_throw_sentinel<S2, O> &&
-        constructible_from<iter_value_t<O>, iter_rvalue_reference_t<I>>,
-        uninitialized_move_result<I, O>>
-    operator()(I ifirst, S ilast, O ofirst, S2 olast) const
-    {
-        return uninitialized_move_fn::impl4(
-                std::move(ifirst), std::move(ilast),
-                std::move(ofirst), std::move(olast));
-    }
+    constexpr ref_view() noexcept = default;
+
+    template <typename T,
+              std::enable_if_t<detail::not_same_as<T, ref_view>, int> = 0,
+              std::enable_if_t<detail::requires_<constructor_req, T>, int> = 0,
+              std::enable_if_t<convertible_to<T, R&>, int> = 0>
+    constexpr ref_view(T&& t)
+        : r_(std::addressof(static_cast<R&>(std::forward<T>(t))))
+    {}
 
-    // Two ranges
-    template <typename IRng, typename ORng>
-    std::enable_if_t<
-        input_range<IRng> && no_throw_forward_range<ORng> &&
-        constructible_from<iter_value_t<iterator_t<ORng>>, iter_rvalue_reference_t<iterator_t<IRng>>>,
-        uninitialized_move_result<borrowed_iterator_t<IRng>,
-                                  borrowed_iterator_t<ORng>>>
-    operator()(IRng&& irng, ORng&& orng) const
+    constexpr R& base() const { return *r_; }
+
+    constexpr iterator_t<R> begin() const { return ranges::begin(*r_); }
+
+    constexpr sentinel_t<R> end() const { return ranges::end(*r_); }
+
+    template <typename RR = R,
+              typename = decltype(ranges::empty(std::declval<RR&>()))>
+    constexpr bool empty() const
     {
-        return uninitialized_move_fn::impl4(
-                nano::begin(irng), nano::end(irng),
-                nano::begin(orng), nano::end(orng));
+        return ranges::empty(*r_);
     }
 
-    // Three-legged
-    template <typename I, typename S, typename O>
-    NANO_DEPRECATED
-    std::enable_if_t<
-        input_iterator<I> && sentinel_for<S, I> &&
-            no_throw_forward_iterator<O> &&
-        constructible_from<iter_value_t<O>, iter_rvalue_reference_t<I>>,
-        uninitialized_move_result<I, O>>
-    operator()(I ifirst, S ilast, O ofirst) const
+    template <typename RR = R, std::enable_if_t<sized_range<RR>, int> = 0>
+    constexpr auto size() const
     {
-        return uninitialized_move_fn::impl3(std::move(ifirst), std::move(ilast),
-                                            std::move(ofirst));
+        return ranges::size(*r_);
     }
 
-    // Range and a half
-    template <typename IRng, typename O>
-    NANO_DEPRECATED
-    std::enable_if_t<
-        input_range<IRng> && no_throw_forward_iterator<std::decay_t<O>> &&
-        !no_throw_forward_range<O> &&
-        constructible_from<iter_value_t<std::decay_t<O>>, iter_rvalue_reference_t<iterator_t<IRng>>>,
-        uninitialized_move_result<borrowed_iterator_t<IRng>, std::decay_t<O>>>
-    operator()(IRng&& irng, O&& ofirst) const
+    template <typename RR = R, std::enable_if_t<contiguous_range<RR>, int> = 0>
+    constexpr auto data() const
     {
-        return uninitialized_move_fn::impl3(
-                nano::begin(irng), nano::end(irng), std::forward<O>(ofirst));
+        return ranges::data(*r_);
     }
 };
 
-}
+template <typename R, std::enable_if_t<range<R> && std::is_object_v<R>, int> = 0>
+ref_view(R&) -> ref_view<R>;
 
-NANO_INLINE_VAR(detail::uninitialized_move_fn, uninitialized_move)
+} // namespace ref_view_
 
-template <typename I, typename O>
-using uninitialized_move_n_result = in_out_result<I, O>;
+using ref_view_::ref_view;
+
+template <typename R>
+inline constexpr bool enable_borrowed_range<ref_view<R>> = true;
+
+NANO_END_NAMESPACE
+
+#endif
+
+
+NANO_BEGIN_NAMESPACE
 
 namespace detail {
 
-struct uninitialized_move_n_fn {
-    template <typename I, typename O, typename S>
-    std::enable_if_t<
-        input_iterator<I> && no_throw_forward_iterator<O> &&
-            no_throw_sentinel<S, O> &&
-        constructible_from<iter_value_t<O>, iter_rvalue_reference_t<I>>,
-        uninitialized_move_n_result<I, O>>
-    operator()(I ifirst, iter_difference_t<I> n, O ofirst, S olast) const
+struct all_view_fn {
+private:
+    template <typename T>
+    static constexpr auto impl(T&& t, priority_tag<2>)
+        noexcept(noexcept(detail::decay_copy(std::forward<T>(t))))
+        -> std::enable_if_t<view<std::decay_t<T>>,
+                            decltype(detail::decay_copy(std::forward<T>(t)))>
     {
-        auto t = uninitialized_move_fn::impl4(
-                    make_counted_iterator(std::move(ifirst), n),
-                    default_sentinel, std::move(ofirst), std::move(olast));
-        return {std::move(t).in.base(), std::move(t).out};
+        return std::forward<T>(t);
     }
 
-    template <typename I, typename O>
-    NANO_DEPRECATED
-    std::enable_if_t<
-        input_iterator<I> && no_throw_forward_iterator<O> &&
-        constructible_from<iter_value_t<O>, iter_rvalue_reference_t<I>>,
-        uninitialized_move_n_result<I, O>>
-    operator()(I ifirst, iter_difference_t<I> n, O ofirst) const
+    template <typename T>
+    static constexpr auto impl(T&& t, priority_tag<1>) noexcept
+        -> decltype(ref_view(std::forward<T>(t)))
     {
-        auto t = uninitialized_move_fn::impl3(
-                make_counted_iterator(std::move(ifirst), n),
-                default_sentinel, std::move(ofirst));
-        return {std::move(t).in.base(), std::move(t).out};
+        return ref_view(std::forward<T>(t));
+    }
+
+    template <typename T>
+    static constexpr auto impl(T&& t, priority_tag<0>)
+        noexcept(noexcept(nano::subrange{std::forward<T>(t)}))
+        -> decltype(nano::subrange{std::forward<T>(t)})
+    {
+        return nano::subrange{std::forward<T>(t)};
     }
 
+public:
+    template <typename T>
+    constexpr auto operator()(T&& t) const
+        noexcept(noexcept(all_view_fn::impl(std::forward<T>(t), priority_tag<2>{})))
+        -> decltype(all_view_fn::impl(std::forward<T>(t), priority_tag<2>{}))
+    {
+        return all_view_fn::impl(std::forward<T>(t), priority_tag<2>{});
+    }
 };
 
+template <>
+inline constexpr bool is_raco<all_view_fn> = true;
+
+} // namespace detail
+
+namespace views {
+
+NANO_INLINE_VAR(nano::detail::all_view_fn, all)
+
 }
 
-NANO_INLINE_VAR(detail::uninitialized_move_n_fn, uninitialized_move_n)
+template <typename R>
+using all_view = std::enable_if_t<viewable_range<R>,
+                                  decltype(views::all(std::declval<R>()))>;
 
 NANO_END_NAMESPACE
 
 #endif
 
-// nanorange/memory/uninitialized_value_construct.hpp
+// nanorange/views/common.hpp
 //
-// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Copyright (c) 2019 Tristan Brindle (tcbrindle at gmail dot com)
 // Distributed under the Boost Software License, Version 1.0. (See accompanying
 // file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
-#ifndef NANORANGE_MEMORY_UNINITIALIZED_VALUE_CONSTRUCT_HPP_INCLUDED
-#define NANORANGE_MEMORY_UNINITIALIZED_VALUE_CONSTRUCT_HPP_INCLUDED
+#ifndef NANORANGE_VIEWS_COMMON_HPP_INCLUDED
+#define NANORANGE_VIEWS_COMMON_HPP_INCLUDED
+
 
 
 
 NANO_BEGIN_NAMESPACE
 
-namespace detail {
+template <typename V>
+class common_view : public view_interface<common_view<V>> {
 
-struct uninitialized_value_construct_fn {
-private:
-    template <typename I, typename S>
-    static I impl(I first, S last)
+    static_assert(view<V> && !common_range<V>, "");
+
+    template <typename VV>
+    using random_and_sized_t =
+            std::integral_constant<bool,
+                               random_access_range<VV> && sized_range<VV>>;
+
+
+    V base_ = V();
+
+    template <typename VV>
+    static constexpr auto do_begin(VV& base, std::true_type)
     {
-        I it = first;
-        try {
-            for (; it != last; ++it) {
-                ::new(detail::voidify(*it)) std::remove_reference_t<iter_reference_t<I>>();
-            }
-            return it;
-        } catch (...) {
-            nano::destroy(first, ++it);
-            throw;
-        }
+        return ranges::begin(base);
     }
 
-public:
-    template <typename I, typename S>
-    std::enable_if_t<no_throw_forward_iterator<I> && no_throw_sentinel<S, I> &&
-                         default_initializable<iter_value_t<I>>, I>
-    operator()(I first, S last) const
+    template <typename VV>
+    static constexpr auto do_begin(VV& base, std::false_type)
     {
-        return uninitialized_value_construct_fn::impl(
-                std::move(first), std::move(last));
+        return common_iterator<iterator_t<VV>, sentinel_t<VV>>(
+                ranges::begin(base));
     }
 
-    template <typename Rng>
-    std::enable_if_t<no_throw_forward_range<Rng> &&
-                         default_initializable<iter_value_t<iterator_t<Rng>>>,
-                     borrowed_iterator_t<Rng>>
-    operator()(Rng&& rng) const
+    template <typename VV>
+    static constexpr auto do_end(VV& base, std::true_type)
     {
-        return uninitialized_value_construct_fn::impl(
-                nano::begin(rng), nano::end(rng));
+        return ranges::begin(base) + ranges::size(base);
     }
-};
 
-}
+    template <typename VV>
+    static constexpr auto do_end(VV& base, std::false_type)
+    {
+        return common_iterator<iterator_t<VV>, sentinel_t<VV>>(
+                ranges::end(base));
+    }
 
-NANO_INLINE_VAR(detail::uninitialized_value_construct_fn,
-                uninitialized_value_construct)
 
-namespace detail {
+public:
+    common_view() = default;
 
-struct uninitialized_value_construct_n_fn {
-    template <typename I>
-    std::enable_if_t<no_throw_forward_iterator<I> &&
-                         default_initializable<iter_value_t<I>>, I>
-    operator()(I first, iter_difference_t<I> n) const
+    constexpr explicit common_view(V r)
+        : base_(std::move(r))
+    {}
+
+    template <typename R,
+        std::enable_if_t<detail::not_same_as<R, common_view>, int> = 0,
+        std::enable_if_t<viewable_range<R> &&
+                !common_range<R> &&
+                constructible_from<V, all_view<R>>, int> = 0>
+    constexpr explicit common_view(R&& r)
+        : base_(views::all(std::forward<R>(r)))
+    {}
+
+    constexpr V base() const { return base_; }
+
+    template <typename VV = V, std::enable_if_t<sized_range<VV>, int> = 0>
+    constexpr auto size() { return ranges::size(base_); }
+
+    template <typename VV = V, std::enable_if_t<sized_range<const VV>, int> = 0>
+    constexpr auto size() const { return ranges::size(base_); }
+
+    constexpr auto begin()
     {
-        return nano::uninitialized_value_construct(
-                    make_counted_iterator(std::move(first), n),
-                    default_sentinel).base();
+        return do_begin<V>(base_, random_and_sized_t<V>{});
     }
 
-};
+    template <typename VV = V, std::enable_if_t<range<const VV>, int> = 0>
+    constexpr auto begin() const
+    {
+        return do_begin<const V>(base_, random_and_sized_t<const V>{});
+    }
 
-}
+    constexpr auto end()
+    {
+        return do_end<V>(base_, random_and_sized_t<V>{});
+    }
+
+    template <typename VV = V, std::enable_if_t<range<const VV>, int> = 0>
+    constexpr auto end() const
+    {
+        return do_end<const V>(base_, random_and_sized_t<const V>{});
+    }
 
-NANO_INLINE_VAR(detail::uninitialized_value_construct_n_fn,
-                uninitialized_value_construct_n)
+};
 
-NANO_END_NAMESPACE
+template <typename R>
+common_view(R&&) -> common_view<all_view<R>>;
 
-#endif
+namespace detail {
 
+struct common_view_fn {
+private:
+    template <typename T>
+    static constexpr auto impl(T&& t, nano::detail::priority_tag<1>)
+        noexcept(noexcept(views::all(std::forward<T>(t))))
+        -> std::enable_if_t<common_range<T>,
+            decltype(views::all(std::forward<T>(t)))>
+    {
+        return views::all(std::forward<T>(t));
+    }
 
-#endif
+    template <typename T>
+    static constexpr auto impl(T&& t, nano::detail::priority_tag<0>)
+        -> common_view<all_view<T>>
+    {
+        return common_view<all_view<T>>{std::forward<T>(t)};
+    }
 
+public:
+    template <typename T>
+    constexpr auto operator()(T&& t) const
+        -> std::enable_if_t<
+        viewable_range<T>,
+        decltype(common_view_fn::impl(std::forward<T>(t),
+                                    nano::detail::priority_tag<1>{}))>
+    {
+        return common_view_fn::impl(std::forward<T>(t),
+                               nano::detail::priority_tag<1>{});
+    }
+};
 
+template <>
+inline constexpr bool is_raco<common_view_fn> = true;
 
+} // namespace detail
 
-// nanorange/utility.hpp
-//
-// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
-// Distributed under the Boost Software License, Version 1.0. (See accompanying
-// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+namespace views {
 
-#ifndef NANORANGE_UTILITY_HPP_INCLUDED
-#define NANORANGE_UTILITY_HPP_INCLUDED
+NANO_INLINE_VAR(::nano::detail::common_view_fn, common)
 
+} // namespace views
 
+NANO_END_NAMESPACE
 
 #endif
 
-// nanorange/range.hpp
-//
-// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
-// Distributed under the Boost Software License, Version 1.0. (See accompanying
-// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
-
-#ifndef NANORANGE_VIEWS_HPP_INCLUDED
-#define NANORANGE_VIEWS_HPP_INCLUDED
-
-// nanorange/views/all.hpp
+// nanorange/views/counted.hpp
 //
 // Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
 // Distributed under the Boost Software License, Version 1.0. (See accompanying
 // file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
-#ifndef NANORANGE_VIEWS_ALL_HPP_INCLUDED
-#define NANORANGE_VIEWS_ALL_HPP_INCLUDED
-
-// nanorange/detail/views/range_adaptors.hpp
-//
-// Copyright (c) 2019 Tristan Brindle (tcbrindle at gmail dot com)
-// Distributed under the Boost Software License, Version 1.0. (See accompanying
-// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+#ifndef NANORANGE_VIEWS_COUNTED_HPP_INCLUDED
+#define NANORANGE_VIEWS_COUNTED_HPP_INCLUDED
 
-#ifndef NANORANGE_DETAIL_VIEW_RANGE_ADAPTORS_HPP_INCLUDED
-#define NANORANGE_DETAIL_VIEW_RANGE_ADAPTORS_HPP_INCLUDED
 
 
 
 NANO_BEGIN_NAMESPACE
 
-namespace detail {
-
-template <typename>
-inline constexpr bool is_raco = false;
+namespace views {
 
-template <typename R, typename C,
-          typename = std::enable_if_t<
-              viewable_range<R> &&
-              !is_raco<remove_cvref_t<R>> && is_raco<remove_cvref_t<C>>>>
-constexpr auto operator|(R&& lhs, C&& rhs)
-    -> decltype(std::forward<C>(rhs)(std::forward<R>(lhs)))
-{
-    return std::forward<C>(rhs)(std::forward<R>(lhs));
-}
+namespace detail {
 
-template <typename LHS, typename RHS>
-struct raco_pipe {
+struct counted_fn {
 private:
-    LHS lhs_;
-    RHS rhs_;
-
-public:
-    constexpr raco_pipe(LHS&& lhs, RHS&& rhs)
-        : lhs_(std::move(lhs)),
-          rhs_(std::move(rhs))
-    {}
-
-    // FIXME: Do I need to do ref-qualified overloads of these too?
-
-    template <typename R, std::enable_if_t<viewable_range<R>, int> = 0>
-    constexpr auto operator()(R&& r)
-        -> decltype(rhs_(lhs_(std::forward<R>(r))))
+    template <typename I>
+    static constexpr auto impl(I i, iter_difference_t<I> n, nano::detail::priority_tag<1>)
+        noexcept(noexcept(nano::subrange{i, i + n}))
+        -> std::enable_if_t<random_access_iterator<I>, decltype(nano::subrange{i, i + n})>
     {
-        return rhs_(lhs_(std::forward<R>(r)));
+        return nano::subrange{i, i + n};
     }
 
+    template <typename I>
+    static constexpr auto impl(I i, iter_difference_t<I> n, nano::detail::priority_tag<0>)
+        noexcept(noexcept(nano::subrange{
+                nano::make_counted_iterator(std::move(i), n),
+                default_sentinel}))
+        -> decltype(nano::subrange{
+            nano::make_counted_iterator(std::move(i), n), default_sentinel})
+    {
+        return nano::subrange{nano::make_counted_iterator(std::move(i), n),
+                                   default_sentinel};
+    }
 
-    template <typename R, std::enable_if_t<viewable_range<R>, int> = 0>
-    constexpr auto operator()(R&& r) const
-        -> decltype(rhs_(lhs_(std::forward<R>(r))))
+public:
+    template <typename E, typename F, typename T = std::decay_t<E>>
+    constexpr auto operator()(E&& e, F&& f) const
+        noexcept(noexcept(impl(std::forward<E>(e),
+                               static_cast<iter_difference_t<T>>(std::forward<F>(f)),
+                               nano::detail::priority_tag<1>{})))
+        -> std::enable_if_t<
+            input_or_output_iterator<T> &&
+            convertible_to<F, iter_difference_t<T>>,
+            decltype(impl(std::forward<E>(e),
+                          static_cast<iter_difference_t<T>>(std::forward<F>(f)),
+                          nano::detail::priority_tag<1>{}))>
     {
-        return rhs_(lhs_(std::forward<R>(r)));
+        return impl(std::forward<E>(e),
+                    static_cast<iter_difference_t<T>>(std::forward<F>(f)),
+                    nano::detail::priority_tag<1>{});
     }
 };
 
-template <typename LHS, typename RHS>
-inline constexpr bool is_raco<raco_pipe<LHS, RHS>> = true;
-
-template <typename LHS, typename RHS>
-constexpr auto operator|(LHS&& lhs, RHS&& rhs)
-    -> std::enable_if_t<
-        is_raco<remove_cvref_t<LHS>> && is_raco<remove_cvref_t<RHS>>,
-        raco_pipe<LHS, RHS>>
-{
-    return raco_pipe<LHS, RHS>{std::forward<LHS>(lhs), std::forward<RHS>(rhs)};
-}
-
-template <typename Lambda>
-struct rao_proxy : Lambda {
-    constexpr explicit rao_proxy(Lambda&& l) : Lambda(std::move(l)) {}
-};
+} // namespace detail
 
-template <typename L>
-inline constexpr bool is_raco<rao_proxy<L>> = true;
+NANO_INLINE_VAR(detail::counted_fn, counted)
 
-} // namespace detail
+} // namespace views
 
 NANO_END_NAMESPACE
 
 #endif
 
-// nanorange/detail/views/ref.hpp
+// nanorange/views/drop.hpp
 //
-// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Copyright (c) 2019 Tristan Brindle (tcbrindle at gmail dot com)
 // Distributed under the Boost Software License, Version 1.0. (See accompanying
 // file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
-#ifndef NANORANGE_VIEWS_REF_HPP_INCLUDED
-#define NANORANGE_VIEWS_REF_HPP_INCLUDED
+#ifndef NANORANGE_VIEWS_DROP_HPP_INCLUDED
+#define NANORANGE_VIEWS_DROP_HPP_INCLUDED
 
 
 
+
+
+#include <optional>
+
 NANO_BEGIN_NAMESPACE
 
-namespace ref_view_ {
+namespace detail {
 
-template <typename R>
-class ref_view : public view_interface<ref_view<R>> {
+template <bool IsRandomAccess, typename>
+struct drop_view_cache {};
 
-    static_assert(range<R> && std::is_object<R>::value, "");
+template <typename I>
+struct drop_view_cache<false, I> {
+    std::optional<I> cached{};
+};
 
-    R* r_ = nullptr;
+}
 
-    struct constructor_req {
-        static void FUN(R&);
-        static void FUN(R&&) = delete;
+template <typename R>
+struct drop_view
+    : view_interface<drop_view<R>>,
+      private detail::drop_view_cache<random_access_range<R>, iterator_t<R>> {
 
-        template <typename T>
-        auto requires_() -> decltype(FUN(std::declval<T>()));
-    };
+    static_assert(view<R>);
 
-public:
-    constexpr ref_view() noexcept = default;
+    drop_view() = default;
 
-    template <typename T,
-              std::enable_if_t<detail::not_same_as<T, ref_view>, int> = 0,
-              std::enable_if_t<detail::requires_<constructor_req, T>, int> = 0,
-              std::enable_if_t<convertible_to<T, R&>, int> = 0>
-    constexpr ref_view(T&& t)
-        : r_(std::addressof(static_cast<R&>(std::forward<T>(t))))
+    constexpr drop_view(R base, range_difference_t<R> count)
+        : base_(std::move(base)),
+          count_(count)
     {}
 
-    constexpr R& base() const { return *r_; }
+    constexpr R base() const { return base_; }
 
-    constexpr iterator_t<R> begin() const { return ranges::begin(*r_); }
+    template <typename RR = R, std::enable_if_t<
+        !(detail::simple_view<RR> && random_access_range<RR>), int> = 0>
+    constexpr auto begin()
+    {
+        if constexpr (random_access_range<R>) {
+            return ranges::next(ranges::begin(base_), count_, ranges::end(base_));
+        } else {
+            auto& c = this->cached;
+            if (!c.has_value()) {
+                c = ranges::next(ranges::begin(base_), count_, ranges::end(base_));
+            }
+            return *c;
+        }
+    }
 
-    constexpr sentinel_t<R> end() const { return ranges::end(*r_); }
+    template <typename RR = R, std::enable_if_t<random_access_range<const RR>, int> = 0>
+    constexpr auto begin() const
+    {
+        return ranges::next(ranges::begin(base_), count_, ranges::end(base_));
+    }
 
-    template <typename RR = R,
-              typename = decltype(ranges::empty(std::declval<RR&>()))>
-    constexpr bool empty() const
+    template <typename RR = R, std::enable_if_t<!detail::simple_view<RR>, int> = 0>
+    constexpr auto end()
     {
-        return ranges::empty(*r_);
+        return ranges::end(base_);
     }
 
-    template <typename RR = R, std::enable_if_t<sized_range<RR>, int> = 0>
-    constexpr auto size() const
+    template <typename RR = R, std::enable_if_t<range<const RR>, int> = 0>
+    constexpr auto end()
     {
-        return ranges::size(*r_);
+        return ranges::end(base_);
     }
 
-    template <typename RR = R, std::enable_if_t<contiguous_range<RR>, int> = 0>
-    constexpr auto data() const
+    template <typename RR = R, std::enable_if_t<sized_range<RR>, int> = 0>
+    constexpr auto size()
     {
-        return ranges::data(*r_);
+        const auto s = ranges::size(base_);
+        const auto c = static_cast<decltype(s)>(count_);
+        return s < c ? 0 : s - c;
     }
-};
-
-template <typename R, std::enable_if_t<range<R> && std::is_object_v<R>, int> = 0>
-ref_view(R&) -> ref_view<R>;
 
-} // namespace ref_view_
+    template <typename RR = R, std::enable_if_t<sized_range<const RR>, int> = 0>
+    constexpr auto size() const
+    {
+        const auto s = ranges::size(base_);
+        const auto c = static_cast<decltype(s)>(count_);
+        return s < c ? 0 : s - c;
+    }
 
-using ref_view_::ref_view;
+private:
+    R base_ = R();
+    range_difference_t<R> count_ = 0;
+};
 
 template <typename R>
-inline constexpr bool enable_borrowed_range<ref_view<R>> = true;
-
-NANO_END_NAMESPACE
-
-#endif
-
-
-NANO_BEGIN_NAMESPACE
+drop_view(R&&, range_difference_t<R>) -> drop_view<all_view<R>>;
 
 namespace detail {
 
-struct all_view_fn {
-private:
-    template <typename T>
-    static constexpr auto impl(T&& t, priority_tag<2>)
-        noexcept(noexcept(detail::decay_copy(std::forward<T>(t))))
-        -> std::enable_if_t<view<std::decay_t<T>>,
-                            decltype(detail::decay_copy(std::forward<T>(t)))>
-    {
-        return std::forward<T>(t);
-    }
+struct drop_view_fn {
 
-    template <typename T>
-    static constexpr auto impl(T&& t, priority_tag<1>) noexcept
-        -> decltype(ref_view(std::forward<T>(t)))
+    template <typename E, typename F>
+    constexpr auto operator()(E&& e, F&& f) const
+        -> decltype(drop_view{std::forward<E>(e), std::forward<F>(f)})
     {
-        return ref_view(std::forward<T>(t));
+        return drop_view{std::forward<E>(e), std::forward<F>(f)};
     }
 
-    template <typename T>
-    static constexpr auto impl(T&& t, priority_tag<0>)
-        noexcept(noexcept(nano::subrange{std::forward<T>(t)}))
-        -> decltype(nano::subrange{std::forward<T>(t)})
+    template <typename C>
+    constexpr auto operator()(C c) const
     {
-        return nano::subrange{std::forward<T>(t)};
+        return detail::rao_proxy{[c = std::move(c)](auto&& r) mutable
+#ifndef NANO_MSVC_LAMBDA_PIPE_WORKAROUND
+            -> decltype(drop_view{std::forward<decltype(r)>(r), std::declval<C&&>()})
+#endif
+        {
+            return drop_view{std::forward<decltype(r)>(r), std::move(c)};
+        }};
     }
 
-public:
-    template <typename T>
-    constexpr auto operator()(T&& t) const
-        noexcept(noexcept(all_view_fn::impl(std::forward<T>(t), priority_tag<2>{})))
-        -> decltype(all_view_fn::impl(std::forward<T>(t), priority_tag<2>{}))
-    {
-        return all_view_fn::impl(std::forward<T>(t), priority_tag<2>{});
-    }
 };
 
-template <>
-inline constexpr bool is_raco<all_view_fn> = true;
-
-} // namespace detail
+}
 
 namespace views {
 
-NANO_INLINE_VAR(nano::detail::all_view_fn, all)
+NANO_INLINE_VAR(nano::detail::drop_view_fn, drop)
 
 }
 
-template <typename R>
-using all_view = std::enable_if_t<viewable_range<R>,
-                                  decltype(views::all(std::declval<R>()))>;
-
 NANO_END_NAMESPACE
 
 #endif
 
-// nanorange/views/common.hpp
+// nanorange/views/drop_while.hpp
 //
 // Copyright (c) 2019 Tristan Brindle (tcbrindle at gmail dot com)
 // Distributed under the Boost Software License, Version 1.0. (See accompanying
 // file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
-#ifndef NANORANGE_VIEWS_COMMON_HPP_INCLUDED
-#define NANORANGE_VIEWS_COMMON_HPP_INCLUDED
-
-
-
+#ifndef NANORANGE_VIEWS_DROP_WHILE_HPP_INCLUDED
+#define NANORANGE_VIEWS_DROP_WHILE_HPP_INCLUDED
 
-NANO_BEGIN_NAMESPACE
 
-template <typename V>
-class common_view : public view_interface<common_view<V>> {
 
-    static_assert(view<V> && !common_range<V>, "");
+// nanorange/detail/views/semiregular_box.hpp
+//
+// Copyright (c) 2019 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
-    template <typename VV>
-    using random_and_sized_t =
-            std::integral_constant<bool,
-                               random_access_range<VV> && sized_range<VV>>;
+#ifndef NANORANGE_DETAIL_VIEW_SEMIREGULAR_BOX_HPP_INCLUDED
+#define NANORANGE_DETAIL_VIEW_SEMIREGULAR_BOX_HPP_INCLUDED
 
 
-    V base_ = V();
 
-    template <typename VV>
-    static constexpr auto do_begin(VV& base, std::true_type)
-    {
-        return ranges::begin(base);
-    }
+#include <optional>
 
-    template <typename VV>
-    static constexpr auto do_begin(VV& base, std::false_type)
-    {
-        return common_iterator<iterator_t<VV>, sentinel_t<VV>>(
-                ranges::begin(base));
-    }
+NANO_BEGIN_NAMESPACE
 
-    template <typename VV>
-    static constexpr auto do_end(VV& base, std::true_type)
-    {
-        return ranges::begin(base) + ranges::size(base);
-    }
+namespace detail {
 
-    template <typename VV>
-    static constexpr auto do_end(VV& base, std::false_type)
-    {
-        return common_iterator<iterator_t<VV>, sentinel_t<VV>>(
-                ranges::end(base));
-    }
+template <typename T>
+struct semiregular_box : std::optional<T>
+{
+    static_assert(copy_constructible<T>);
+    static_assert(std::is_object_v<T>);
 
+private:
+    std::optional<T>& base() { return *this; }
+    std::optional<T> const& base() const { return *this; }
 
 public:
-    common_view() = default;
-
-    constexpr explicit common_view(V r)
-        : base_(std::move(r))
-    {}
-
-    template <typename R,
-        std::enable_if_t<detail::not_same_as<R, common_view>, int> = 0,
-        std::enable_if_t<viewable_range<R> &&
-                !common_range<R> &&
-                constructible_from<V, all_view<R>>, int> = 0>
-    constexpr explicit common_view(R&& r)
-        : base_(views::all(std::forward<R>(r)))
+    template <typename U = T,
+              std::enable_if_t<default_initializable<U>, int> = 0>
+    constexpr semiregular_box()
+        noexcept(std::is_nothrow_default_constructible_v<T>)
+        : semiregular_box{std::in_place}
     {}
 
-    constexpr V base() const { return base_; }
+    template <typename U = T,
+              std::enable_if_t<!default_initializable<U>, int> = 0>
+    constexpr semiregular_box() {}
 
-    template <typename VV = V, std::enable_if_t<sized_range<VV>, int> = 0>
-    constexpr auto size() { return ranges::size(base_); }
+    // All other constructors get forwarded to optional -- but don't hijack
+    // copy/move construct
+    template <typename Arg0, typename... Args,
+              std::enable_if_t<
+                  constructible_from<std::optional<T>, Arg0, Args...> &&
+                  !same_as<remove_cvref_t<Arg0>, semiregular_box>, int> = 0>
+    constexpr semiregular_box(Arg0&& arg0, Args&&... args)
+        : std::optional<T>{std::forward<Arg0>(arg0), std::forward<Args>(args)...}
+    {}
 
-    template <typename VV = V, std::enable_if_t<sized_range<const VV>, int> = 0>
-    constexpr auto size() const { return ranges::size(base_); }
+    constexpr semiregular_box(const semiregular_box&) = default;
+    constexpr semiregular_box(semiregular_box&&) = default;
 
-    constexpr auto begin()
+    semiregular_box& operator=(const semiregular_box& other)
     {
-        return do_begin<V>(base_, random_and_sized_t<V>{});
-    }
+        if constexpr (assignable_from<T&, const T&>) {
+            base() = other.base();
+        } else {
+            if (other) {
+                this->emplace(*other);
+            } else {
+                this->reset();
+            }
+        }
 
-    template <typename VV = V, std::enable_if_t<range<const VV>, int> = 0>
-    constexpr auto begin() const
-    {
-        return do_begin<const V>(base_, random_and_sized_t<const V>{});
+        return *this;
     }
 
-    constexpr auto end()
+    semiregular_box& operator=(semiregular_box&& other) noexcept
     {
-        return do_end<V>(base_, random_and_sized_t<V>{});
-    }
+        if constexpr (assignable_from<T&, T>) {
+            base() = std::move(other.base());
+        } else {
+            if (other) {
+                this->emplace(std::move(*other));
+            } else {
+                this->reset();
+            }
+        }
 
-    template <typename VV = V, std::enable_if_t<range<const VV>, int> = 0>
-    constexpr auto end() const
-    {
-        return do_end<const V>(base_, random_and_sized_t<const V>{});
+        return *this;
     }
-
 };
 
-template <typename R>
-common_view(R&&) -> common_view<all_view<R>>;
-
-namespace detail {
+} // namespace detail
 
-struct common_view_fn {
-private:
-    template <typename T>
-    static constexpr auto impl(T&& t, nano::detail::priority_tag<1>)
-        noexcept(noexcept(views::all(std::forward<T>(t))))
-        -> std::enable_if_t<common_range<T>,
-            decltype(views::all(std::forward<T>(t)))>
-    {
-        return views::all(std::forward<T>(t));
-    }
+NANO_END_NAMESPACE
 
-    template <typename T>
-    static constexpr auto impl(T&& t, nano::detail::priority_tag<0>)
-        -> common_view<all_view<T>>
-    {
-        return common_view<all_view<T>>{std::forward<T>(t)};
-    }
+#endif
 
-public:
-    template <typename T>
-    constexpr auto operator()(T&& t) const
-        -> std::enable_if_t<
-        viewable_range<T>,
-        decltype(common_view_fn::impl(std::forward<T>(t),
-                                    nano::detail::priority_tag<1>{}))>
-    {
-        return common_view_fn::impl(std::forward<T>(t),
-                               nano::detail::priority_tag<1>{});
-    }
-};
 
-template <>
-inline constexpr bool is_raco<common_view_fn> = true;
 
-} // namespace detail
 
-namespace views {
+NANO_BEGIN_NAMESPACE
 
-NANO_INLINE_VAR(::nano::detail::common_view_fn, common)
+template <typename R, typename Pred>
+struct drop_while_view : view_interface<drop_while_view<R, Pred>> {
 
-} // namespace views
+    static_assert(view<R>);
+    static_assert(input_range<R>);
+    static_assert(std::is_object_v<Pred>);
+    static_assert(indirect_unary_predicate<const Pred, iterator_t<R>>);
 
-NANO_END_NAMESPACE
+    drop_while_view() = default;
 
-#endif
+    constexpr drop_while_view(R base, Pred pred)
+        : base_(std::move(base)),
+          pred_(std::move(pred))
+    {}
 
-// nanorange/views/counted.hpp
-//
-// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
-// Distributed under the Boost Software License, Version 1.0. (See accompanying
-// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+    constexpr R base() const { return base_; }
 
-#ifndef NANORANGE_VIEWS_COUNTED_HPP_INCLUDED
-#define NANORANGE_VIEWS_COUNTED_HPP_INCLUDED
+    constexpr const Pred& pred() const { return *pred_; }
 
+    constexpr auto begin()
+    {
+        if (!cached_.has_value()) {
+            cached_ = ranges::find_if(base_,
+                [&p = pred()](auto&& arg)
+                {
+                    return !nano::invoke(p, std::forward<decltype(arg)>(arg));
+                });
+        }
 
+        return *cached_;
+    }
 
+    constexpr auto end()
+    {
+        return ranges::end(base_);
+    }
 
-NANO_BEGIN_NAMESPACE
+private:
+    R base_;
+    detail::semiregular_box<Pred> pred_;
+    std::optional<iterator_t<R>> cached_;
+};
 
-namespace views {
+template <typename R, typename Pred>
+drop_while_view(R&& r, Pred pred) -> drop_while_view<all_view<R>, Pred>;
 
 namespace detail {
 
-struct counted_fn {
-private:
-    template <typename I>
-    static constexpr auto impl(I i, iter_difference_t<I> n, nano::detail::priority_tag<1>)
-        noexcept(noexcept(nano::subrange{i, i + n}))
-        -> std::enable_if_t<random_access_iterator<I>, decltype(nano::subrange{i, i + n})>
-    {
-        return nano::subrange{i, i + n};
-    }
+struct drop_while_view_fn {
 
-    template <typename I>
-    static constexpr auto impl(I i, iter_difference_t<I> n, nano::detail::priority_tag<0>)
-        noexcept(noexcept(nano::subrange{
-                nano::make_counted_iterator(std::move(i), n),
-                default_sentinel}))
-        -> decltype(nano::subrange{
-            nano::make_counted_iterator(std::move(i), n), default_sentinel})
+    template <typename E, typename F>
+    constexpr auto operator()(E&& e, F&& f) const
+        -> decltype(drop_while_view{std::forward<E>(e), std::forward<F>(f)})
     {
-        return nano::subrange{nano::make_counted_iterator(std::move(i), n),
-                                   default_sentinel};
+        return drop_while_view{std::forward<E>(e), std::forward<F>(f)};
     }
 
-public:
-    template <typename E, typename F, typename T = std::decay_t<E>>
-    constexpr auto operator()(E&& e, F&& f) const
-        noexcept(noexcept(impl(std::forward<E>(e),
-                               static_cast<iter_difference_t<T>>(std::forward<F>(f)),
-                               nano::detail::priority_tag<1>{})))
-        -> std::enable_if_t<
-            input_or_output_iterator<T> &&
-            convertible_to<F, iter_difference_t<T>>,
-            decltype(impl(std::forward<E>(e),
-                          static_cast<iter_difference_t<T>>(std::forward<F>(f)),
-                          nano::detail::priority_tag<1>{}))>
+    template <typename Pred>
+    constexpr auto operator()(Pred&& pred) const
     {
-        return impl(std::forward<E>(e),
-                    static_cast<iter_difference_t<T>>(std::forward<F>(f)),
-                    nano::detail::priority_tag<1>{});
+        return detail::rao_proxy{[p = std::forward<Pred>(pred)](auto&& r) mutable
+#ifndef NANO_MSVC_LAMBDA_PIPE_WORKAROUND
+            -> decltype(drop_while_view{std::forward<decltype(r)>(r), std::declval<Pred&&>()})
+#endif
+        {
+            return drop_while_view{std::forward<decltype(r)>(r), std::move(p)};
+        }};
     }
+
 };
 
 } // namespace detail
 
-NANO_INLINE_VAR(detail::counted_fn, counted)
+namespace views {
 
-} // namespace views
+NANO_INLINE_VAR(nano::detail::drop_while_view_fn, drop_while)
+
+}
 
 NANO_END_NAMESPACE
 
 #endif
 
-// nanorange/views/drop.hpp
+// nanorange/views/elements.hpp
 //
 // Copyright (c) 2019 Tristan Brindle (tcbrindle at gmail dot com)
 // Distributed under the Boost Software License, Version 1.0. (See accompanying
 // file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
-#ifndef NANORANGE_VIEWS_DROP_HPP_INCLUDED
-#define NANORANGE_VIEWS_DROP_HPP_INCLUDED
-
+#ifndef NANORANGE_VIEWS_ELEMENTS_HPP_INCLUDED
+#define NANORANGE_VIEWS_ELEMENTS_HPP_INCLUDED
 
 
 
 
-#include <optional>
 
 NANO_BEGIN_NAMESPACE
 
 namespace detail {
 
-template <bool IsRandomAccess, typename>
-struct drop_view_cache {};
-
-template <typename I>
-struct drop_view_cache<false, I> {
-    std::optional<I> cached{};
+struct has_tuple_element_concept {
+    template <typename T, typename I,
+              std::size_t N = I::value,
+              typename = typename std::tuple_size<T>::type>
+    auto requires_(T t) -> decltype(
+        requires_expr<(N < std::tuple_size_v<T>)>{},
+        std::declval<std::tuple_element_t<N, T>>(),
+        requires_expr<convertible_to<decltype(std::get<N>(t)), std::tuple_element_t<N, T>>>{}
+    );
 };
 
-}
+template <typename T, std::size_t N>
+NANO_CONCEPT has_tuple_element =
+    detail::requires_<has_tuple_element_concept, T,
+                      std::integral_constant<std::size_t, N>>;
 
-template <typename R>
-struct drop_view
-    : view_interface<drop_view<R>>,
-      private detail::drop_view_cache<random_access_range<R>, iterator_t<R>> {
+} // namespace detail
+
+template <typename R, std::size_t N>
+struct elements_view : view_interface<elements_view<R, N>> {
 
+    static_assert(input_range<R>);
     static_assert(view<R>);
+    static_assert(detail::has_tuple_element<range_value_t<R>, N>);
+    static_assert(detail::has_tuple_element<
+        std::remove_reference_t<range_reference_t<R>>, N>);
 
-    drop_view() = default;
+    elements_view() = default;
 
-    constexpr drop_view(R base, range_difference_t<R> count)
-        : base_(std::move(base)),
-          count_(count)
+    constexpr explicit elements_view(R base)
+        : base_(std::move(base))
     {}
 
-    constexpr R base() const { return base_; }
-
-    template <typename RR = R, std::enable_if_t<
-        !(detail::simple_view<RR> && random_access_range<RR>), int> = 0>
+    template <typename RR = R, std::enable_if_t<!detail::simple_view<RR>, int> = 0>
     constexpr auto begin()
     {
-        if constexpr (random_access_range<R>) {
-            return ranges::next(ranges::begin(base_), count_, ranges::end(base_));
-        } else {
-            auto& c = this->cached;
-            if (!c.has_value()) {
-                c = ranges::next(ranges::begin(base_), count_, ranges::end(base_));
-            }
-            return *c;
-        }
+        return iterator<false>(ranges::begin(base_));
     }
 
-    template <typename RR = R, std::enable_if_t<random_access_range<const RR>, int> = 0>
+    template <typename RR = R, std::enable_if_t<detail::simple_view<RR>, int> = 0>
     constexpr auto begin() const
     {
-        return ranges::next(ranges::begin(base_), count_, ranges::end(base_));
+        return iterator<true>(ranges::begin(base_));
     }
 
     template <typename RR = R, std::enable_if_t<!detail::simple_view<RR>, int> = 0>
@@ -15937,8 +23097,8 @@ struct drop_view
         return ranges::end(base_);
     }
 
-    template <typename RR = R, std::enable_if_t<range<const RR>, int> = 0>
-    constexpr auto end()
+    template <typename RR = R, std::enable_if_t<detail::simple_view<RR>, int> = 0>
+    constexpr auto end() const
     {
         return ranges::end(base_);
     }
@@ -15946,745 +23106,710 @@ struct drop_view
     template <typename RR = R, std::enable_if_t<sized_range<RR>, int> = 0>
     constexpr auto size()
     {
-        const auto s = ranges::size(base_);
-        const auto c = static_cast<decltype(s)>(count_);
-        return s < c ? 0 : s - c;
+        return ranges::size(base_);
     }
 
     template <typename RR = R, std::enable_if_t<sized_range<const RR>, int> = 0>
     constexpr auto size() const
     {
-        const auto s = ranges::size(base_);
-        const auto c = static_cast<decltype(s)>(count_);
-        return s < c ? 0 : s - c;
+        return ranges::size(base_);
     }
 
 private:
-    R base_ = R();
-    range_difference_t<R> count_ = 0;
-};
+    template <bool Const>
+    struct iterator
+    {
+    private:
+        using base_t = detail::conditional_t<Const, const R, R>;
+        friend iterator<!Const>;
 
-template <typename R>
-drop_view(R&&, range_difference_t<R>) -> drop_view<all_view<R>>;
+        iterator_t<base_t> current_;
 
-namespace detail {
+    public:
+        using iterator_category = iterator_category_t<iterator_t<base_t>>;
+        using value_type =
+            remove_cvref_t<std::tuple_element_t<N, range_value_t<base_t>>>;
+        using difference_type = range_difference_t<base_t>;
 
-struct drop_view_fn {
+        iterator() = default;
 
-    template <typename E, typename F>
-    constexpr auto operator()(E&& e, F&& f) const
-        -> decltype(drop_view{std::forward<E>(e), std::forward<F>(f)})
-    {
-        return drop_view{std::forward<E>(e), std::forward<F>(f)};
-    }
+        constexpr explicit iterator(iterator_t<base_t> current)
+            : current_(std::move(current))
+        {}
 
-    template <typename C>
-    constexpr auto operator()(C c) const
-    {
-        return detail::rao_proxy{[c = std::move(c)](auto&& r) mutable
-#ifndef NANO_MSVC_LAMBDA_PIPE_WORKAROUND
-            -> decltype(drop_view{std::forward<decltype(r)>(r), std::declval<C&&>()})
-#endif
+        template <typename I,
+                  std::enable_if_t<same_as<I, iterator<!Const>>, int> = 0,
+                  bool C = Const, typename B = base_t,
+                  std::enable_if_t<C &&
+                      convertible_to<iterator_t<R>, iterator_t<B>>, int> = 0>
+        constexpr iterator(I i)
+            : current_(std::move(i.current_))
+        {}
+
+        constexpr iterator_t<base_t> base() const { return current_; }
+
+        constexpr decltype(auto) operator*() const
         {
-            return drop_view{std::forward<decltype(r)>(r), std::move(c)};
-        }};
-    }
+            return std::get<N>(*current_);
+        }
 
-};
+        constexpr iterator& operator++() { ++current_; return *this; }
+
+        constexpr auto operator++(int)
+        {
+            if constexpr (forward_range<base_t>) {
+                auto temp = *this;
+                ++*this;
+                return temp;
+            } else {
+                ++*this;
+            }
+        }
+
+        template <typename B = base_t>
+        constexpr auto operator--()
+            -> std::enable_if_t<bidirectional_range<B>, iterator&>
+        {
+            --current_;
+            return *this;
+        }
+
+        template <typename B = base_t>
+        constexpr auto operator--(int)
+            -> std::enable_if_t<bidirectional_range<B>, iterator>
+        {
+            auto temp = *this;
+            ++*this;
+            return temp;
+        }
 
-}
+        template <typename B = base_t>
+        constexpr auto operator+=(difference_type x)
+            -> std::enable_if_t<random_access_range<B>, iterator&>
+        {
+            current_ += x;
+            return *this;
+        }
 
-namespace views {
+        template <typename B = base_t>
+        constexpr auto operator-=(difference_type x)
+            -> std::enable_if_t<random_access_range<B>, iterator&>
+        {
+            current_ -= x;
+            return *this;
+        }
 
-NANO_INLINE_VAR(nano::detail::drop_view_fn, drop)
+        template <typename B = base_t,
+                  std::enable_if_t<random_access_range<B>, int> = 0>
+        constexpr decltype(auto) operator[](difference_type n) const
+        {
+            return std::get<N>(*(current_ + n));
+        }
 
-}
+        template <typename B = base_t>
+        friend constexpr auto operator==(const iterator& x, const iterator& y)
+            -> std::enable_if_t<equality_comparable<iterator_t<B>>, bool>
+        {
+            return x.current_ == y.current_;
+        }
 
-NANO_END_NAMESPACE
+        template <typename B = base_t>
+        friend constexpr auto operator!=(const iterator& x, const iterator& y)
+            -> std::enable_if_t<equality_comparable<iterator_t<B>>, bool>
+        {
+            return !(x == y);
+        }
 
+        // Make these friend functions templates to keep MSVC happy
+#if (defined(_MSC_VER) && _MSC_VER < 1922)
+        template <typename = void>
 #endif
+        friend constexpr bool operator==(const iterator& x, const sentinel_t<base_t>& y)
+        {
+            return x.current_ == y;
+        }
 
-// nanorange/views/drop_while.hpp
-//
-// Copyright (c) 2019 Tristan Brindle (tcbrindle at gmail dot com)
-// Distributed under the Boost Software License, Version 1.0. (See accompanying
-// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+#if (defined(_MSC_VER) && _MSC_VER < 1922)
+        template <typename = void>
+#endif
+        friend constexpr bool operator==(const sentinel_t<base_t>& y, const iterator& x)
+        {
+            return x.current_ == y;
+        }
 
-#ifndef NANORANGE_VIEWS_DROP_WHILE_HPP_INCLUDED
-#define NANORANGE_VIEWS_DROP_WHILE_HPP_INCLUDED
+#if (defined(_MSC_VER) && _MSC_VER < 1922)
+        template <typename = void>
+#endif
+        friend constexpr bool operator!=(const iterator& x, const sentinel_t<base_t>& y)
+        {
+            return !(x == y);
+        }
 
+#if (defined(_MSC_VER) && _MSC_VER < 1922)
+        template <typename = void>
+#endif
+        friend constexpr bool operator!=(const sentinel_t<base_t>& y, const iterator& x)
+        {
+            return !(x == y);
+        }
 
+        template <typename B = base_t>
+        friend constexpr auto operator<(const iterator& x, const iterator& y)
+            -> std::enable_if_t<random_access_range<B>, bool>
+        {
+            return x.current_ < y.current_;
+        }
 
-// nanorange/detail/views/semiregular_box.hpp
-//
-// Copyright (c) 2019 Tristan Brindle (tcbrindle at gmail dot com)
-// Distributed under the Boost Software License, Version 1.0. (See accompanying
-// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+        template <typename B = base_t>
+        friend constexpr auto operator>(const iterator& x, const iterator& y)
+            -> std::enable_if_t<random_access_range<B>, bool>
+        {
+            return (y < x);
+        }
 
-#ifndef NANORANGE_DETAIL_VIEW_SEMIREGULAR_BOX_HPP_INCLUDED
-#define NANORANGE_DETAIL_VIEW_SEMIREGULAR_BOX_HPP_INCLUDED
+        template <typename B = base_t>
+        friend constexpr auto operator<=(const iterator& x, const iterator& y)
+            -> std::enable_if_t<random_access_range<B>, bool>
+        {
+            return !(y < x);
+        }
 
+        template <typename B = base_t>
+        friend constexpr auto operator>=(const iterator& x, const iterator& y)
+            -> std::enable_if_t<random_access_range<B>, bool>
+        {
+            return !(x < y);
+        }
 
+        template <typename B = base_t>
+        friend constexpr auto operator+(const iterator& x, difference_type y)
+            -> std::enable_if_t<random_access_range<B>, iterator>
+        {
+            return iterator{x} += y;
+        }
 
-#include <optional>
+        template <typename B = base_t>
+        friend constexpr auto operator+(difference_type x, const iterator& y)
+            -> std::enable_if_t<random_access_range<B>, iterator>
+        {
+            return y + x;
+        }
 
-NANO_BEGIN_NAMESPACE
+        template <typename B = base_t>
+        friend constexpr auto operator-(const iterator& x, difference_type y)
+            -> std::enable_if_t<random_access_range<B>, iterator>
+        {
+            return iterator{x} -= y;
+        }
 
-namespace detail {
 
-template <typename T>
-struct semiregular_box : std::optional<T>
-{
-    static_assert(copy_constructible<T>);
-    static_assert(std::is_object_v<T>);
+        template <typename B = base_t>
+        friend constexpr auto operator-(const iterator& x, const iterator& y)
+            -> std::enable_if_t<random_access_range<B>, difference_type>
+        {
+            return x.current_ - y.current_;
+        }
 
-private:
-    std::optional<T>& base() { return *this; }
-    std::optional<T> const& base() const { return *this; }
+        template <typename B = base_t>
+        friend constexpr auto operator-(const iterator& x, const sentinel_t<base_t>& y)
+        -> std::enable_if_t<sized_sentinel_for<sentinel_t<B>, iterator_t<B>>,
+            difference_type>
+        {
+            return x.current_ - y;
+        }
 
-public:
-    template <typename U = T,
-              std::enable_if_t<default_initializable<U>, int> = 0>
-    constexpr semiregular_box()
-        noexcept(std::is_nothrow_default_constructible_v<T>)
-        : semiregular_box{std::in_place}
-    {}
+        template <typename B = base_t>
+        friend constexpr auto operator-(const sentinel_t<base_t>& x, const iterator& y)
+            -> std::enable_if_t<sized_sentinel_for<sentinel_t<B>, iterator_t<B>>,
+                                difference_type>
+        {
+            return -(y - x);
+        }
+    };
 
-    template <typename U = T,
-              std::enable_if_t<!default_initializable<U>, int> = 0>
-    constexpr semiregular_box() {}
+    R base_ = R();
+};
 
-    // All other constructors get forwarded to optional -- but don't hijack
-    // copy/move construct
-    template <typename Arg0, typename... Args,
-              std::enable_if_t<
-                  constructible_from<std::optional<T>, Arg0, Args...> &&
-                  !same_as<remove_cvref_t<Arg0>, semiregular_box>, int> = 0>
-    constexpr semiregular_box(Arg0&& arg0, Args&&... args)
-        : std::optional<T>{std::forward<Arg0>(arg0), std::forward<Args>(args)...}
-    {}
 
-    constexpr semiregular_box(const semiregular_box&) = default;
-    constexpr semiregular_box(semiregular_box&&) = default;
+template <typename R>
+using keys_view = elements_view<all_view<R>, 0>;
 
-    semiregular_box& operator=(const semiregular_box& other)
-    {
-        if constexpr (assignable_from<T&, const T&>) {
-            base() = other.base();
-        } else {
-            if (other) {
-                this->emplace(*other);
-            } else {
-                this->reset();
-            }
-        }
+template <typename R>
+using values_view = elements_view<all_view<R>, 1>;
 
-        return *this;
-    }
+namespace detail {
 
-    semiregular_box& operator=(semiregular_box&& other) noexcept
+template <std::size_t N>
+struct elements_view_fn {
+    template <typename E>
+    constexpr auto operator()(E&& e) const
+        -> decltype(elements_view<all_view<decltype(std::forward<E>(e))>, N>{std::forward<E>(e)})
     {
-        if constexpr (assignable_from<T&, T>) {
-            base() = std::move(other.base());
-        } else {
-            if (other) {
-                this->emplace(std::move(*other));
-            } else {
-                this->reset();
-            }
-        }
-
-        return *this;
+        return elements_view<all_view<decltype(std::forward<E>(e))>, N>{std::forward<E>(e)};
     }
 };
 
-} // namespace detail
-
-NANO_END_NAMESPACE
-
-#endif
+template <std::size_t N>
+inline constexpr bool is_raco<elements_view_fn<N>> = true;
 
+} // namespace detail
 
+namespace views {
 
+inline namespace function_objects {
 
-NANO_BEGIN_NAMESPACE
+template <std::size_t N>
+inline constexpr nano::detail::elements_view_fn<N> elements{};
 
-template <typename R, typename Pred>
-struct drop_while_view : view_interface<drop_while_view<R, Pred>> {
+inline constexpr nano::detail::elements_view_fn<0> keys{};
 
-    static_assert(view<R>);
-    static_assert(input_range<R>);
-    static_assert(std::is_object_v<Pred>);
-    static_assert(indirect_unary_predicate<const Pred, iterator_t<R>>);
+inline constexpr nano::detail::elements_view_fn<1> values{};
 
-    drop_while_view() = default;
+}
 
-    constexpr drop_while_view(R base, Pred pred)
-        : base_(std::move(base)),
-          pred_(std::move(pred))
-    {}
+}
 
-    constexpr R base() const { return base_; }
 
-    constexpr const Pred& pred() const { return *pred_; }
+NANO_END_NAMESPACE
 
-    constexpr auto begin()
-    {
-        if (!cached_.has_value()) {
-            cached_ = ranges::find_if(base_,
-                [&p = pred()](auto&& arg)
-                {
-                    return !nano::invoke(p, std::forward<decltype(arg)>(arg));
-                });
-        }
+#endif
 
-        return *cached_;
-    }
+// nanorange/views/empty.hpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
-    constexpr auto end()
-    {
-        return ranges::end(base_);
-    }
+#ifndef NANORANGE_VIEWS_EMPTY_HPP_INCLUDED
+#define NANORANGE_VIEWS_EMPTY_HPP_INCLUDED
 
-private:
-    R base_;
-    detail::semiregular_box<Pred> pred_;
-    std::optional<iterator_t<R>> cached_;
-};
 
-template <typename R, typename Pred>
-drop_while_view(R&& r, Pred pred) -> drop_while_view<all_view<R>, Pred>;
 
-namespace detail {
+NANO_BEGIN_NAMESPACE
 
-struct drop_while_view_fn {
+namespace empty_view_ {
 
-    template <typename E, typename F>
-    constexpr auto operator()(E&& e, F&& f) const
-        -> decltype(drop_while_view{std::forward<E>(e), std::forward<F>(f)})
-    {
-        return drop_while_view{std::forward<E>(e), std::forward<F>(f)};
-    }
+template <typename T>
+class empty_view : view_interface<empty_view<T>> {
+    static_assert(std::is_object<T>::value, "");
 
-    template <typename Pred>
-    constexpr auto operator()(Pred&& pred) const
-    {
-        return detail::rao_proxy{[p = std::forward<Pred>(pred)](auto&& r) mutable
-#ifndef NANO_MSVC_LAMBDA_PIPE_WORKAROUND
-            -> decltype(drop_while_view{std::forward<decltype(r)>(r), std::declval<Pred&&>()})
-#endif
-        {
-            return drop_while_view{std::forward<decltype(r)>(r), std::move(p)};
-        }};
-    }
+public:
+    static constexpr T* begin() noexcept { return nullptr; }
+    static constexpr T* end() noexcept { return nullptr; }
+    static constexpr std::ptrdiff_t size() noexcept { return 0; }
+    static constexpr T* data() noexcept { return nullptr; }
 
+    static constexpr bool empty() noexcept { return true; }
 };
 
-} // namespace detail
+}
+
+using empty_view_::empty_view;
+
+template <typename T>
+inline constexpr bool enable_borrowed_range<empty_view<T>> = true;
 
 namespace views {
 
-NANO_INLINE_VAR(nano::detail::drop_while_view_fn, drop_while)
+template <typename T, typename = std::enable_if_t<std::is_object<T>::value>>
+inline constexpr empty_view<T> empty{};
 
 }
 
+
 NANO_END_NAMESPACE
 
 #endif
 
-// nanorange/views/elements.hpp
+// nanorange/views/filter.hpp
 //
 // Copyright (c) 2019 Tristan Brindle (tcbrindle at gmail dot com)
 // Distributed under the Boost Software License, Version 1.0. (See accompanying
 // file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
-#ifndef NANORANGE_VIEWS_ELEMENTS_HPP_INCLUDED
-#define NANORANGE_VIEWS_ELEMENTS_HPP_INCLUDED
+#ifndef NANORANGE_VIEWS_FILTER_HPP_INCLUDED
+#define NANORANGE_VIEWS_FILTER_HPP_INCLUDED
+
 
 
 
 
+#include <cassert>
 
 NANO_BEGIN_NAMESPACE
 
 namespace detail {
 
-struct has_tuple_element_concept {
-    template <typename T, typename I,
-              std::size_t N = I::value,
-              typename = typename std::tuple_size<T>::type>
-    auto requires_(T t) -> decltype(
-        requires_expr<(N < std::tuple_size_v<T>)>{},
-        std::declval<std::tuple_element_t<N, T>>(),
-        requires_expr<convertible_to<decltype(std::get<N>(t)), std::tuple_element_t<N, T>>>{}
-    );
-};
-
-template <typename T, std::size_t N>
-NANO_CONCEPT has_tuple_element =
-    detail::requires_<has_tuple_element_concept, T,
-                      std::integral_constant<std::size_t, N>>;
-
-} // namespace detail
-
-template <typename R, std::size_t N>
-struct elements_view : view_interface<elements_view<R, N>> {
-
-    static_assert(input_range<R>);
-    static_assert(view<R>);
-    static_assert(detail::has_tuple_element<range_value_t<R>, N>);
-    static_assert(detail::has_tuple_element<
-        std::remove_reference_t<range_reference_t<R>>, N>);
-
-    elements_view() = default;
-
-    constexpr explicit elements_view(R base)
-        : base_(std::move(base))
-    {}
-
-    template <typename RR = R, std::enable_if_t<!detail::simple_view<RR>, int> = 0>
-    constexpr auto begin()
-    {
-        return iterator<false>(ranges::begin(base_));
+template <typename V>
+constexpr auto filter_view_iter_cat_helper()
+{
+    using C = iterator_category_t<iterator_t<V>>;
+    if constexpr (derived_from<C, bidirectional_iterator_tag>) {
+        return bidirectional_iterator_tag{};
+    } else if constexpr (derived_from<C, forward_iterator_tag>) {
+        return forward_iterator_tag{};
+    } else {
+        return input_iterator_tag{};
     }
+}
 
-    template <typename RR = R, std::enable_if_t<detail::simple_view<RR>, int> = 0>
-    constexpr auto begin() const
-    {
-        return iterator<true>(ranges::begin(base_));
-    }
+constexpr inline auto as_ref = [](auto& pred) {
+    return [&p = pred] (auto&& arg) {
+        return nano::invoke(p, std::forward<decltype(arg)>(arg));
+    };
+};
 
-    template <typename RR = R, std::enable_if_t<!detail::simple_view<RR>, int> = 0>
-    constexpr auto end()
-    {
-        return ranges::end(base_);
-    }
+}
 
-    template <typename RR = R, std::enable_if_t<detail::simple_view<RR>, int> = 0>
-    constexpr auto end() const
-    {
-        return ranges::end(base_);
-    }
+namespace filter_view_ {
 
-    template <typename RR = R, std::enable_if_t<sized_range<RR>, int> = 0>
-    constexpr auto size()
-    {
-        return ranges::size(base_);
-    }
+template <typename V, typename Pred>
+struct filter_view : view_interface<filter_view<V, Pred>> {
 
-    template <typename RR = R, std::enable_if_t<sized_range<const RR>, int> = 0>
-    constexpr auto size() const
-    {
-        return ranges::size(base_);
-    }
+    // FIXME: GCC9 recursive constraint (?) problems again
+    // static_assert(input_range<V>);
+    static_assert(input_iterator<iterator_t<V>>);
+    static_assert(indirect_unary_predicate<Pred, iterator_t<V>>);
+    static_assert(view<V>);
+    static_assert(std::is_object_v<Pred>);
 
 private:
-    template <bool Const>
-    struct iterator
-    {
-    private:
-        using base_t = detail::conditional_t<Const, const R, R>;
-        friend iterator<!Const>;
+    V base_ = V();
+    detail::semiregular_box<Pred> pred_;
 
-        iterator_t<base_t> current_;
+    struct iterator {
+    private:
+        iterator_t<V> current_ = iterator_t<V>();
+        filter_view* parent_ = nullptr;
 
     public:
-        using iterator_category = iterator_category_t<iterator_t<base_t>>;
-        using value_type =
-            remove_cvref_t<std::tuple_element_t<N, range_value_t<base_t>>>;
-        using difference_type = range_difference_t<base_t>;
+        // using iterator_concept = ...
+        using iterator_category =
+            decltype(detail::filter_view_iter_cat_helper<V>());
+        using value_type = iter_value_t<iterator_t<V>>;
+        using difference_type = iter_difference_t<iterator_t<V>>;
+        // Extension: legacy typedefs
+        using pointer = iterator_t<V>;
+        using reference = iter_reference_t<iterator_t<V>>;
 
         iterator() = default;
-
-        constexpr explicit iterator(iterator_t<base_t> current)
-            : current_(std::move(current))
+        constexpr iterator(filter_view& parent, iterator_t<V> current)
+            : current_(std::move(current)), parent_(std::addressof(parent))
         {}
 
-        template <typename I,
-                  std::enable_if_t<same_as<I, iterator<!Const>>, int> = 0,
-                  bool C = Const, typename B = base_t,
-                  std::enable_if_t<C &&
-                      convertible_to<iterator_t<R>, iterator_t<B>>, int> = 0>
-        constexpr iterator(I i)
-            : current_(std::move(i.current_))
-        {}
+        constexpr iterator_t<V> base() const { return current_; }
 
-        constexpr iterator_t<base_t> base() const { return current_; }
+        constexpr iter_reference_t<iterator_t<V>> operator*() const
+        {
+            return *current_;
+        }
 
-        constexpr decltype(auto) operator*() const
+        template <typename VV = V>
+        constexpr auto operator->() const
+            -> std::enable_if_t<detail::has_arrow<iterator_t<VV>>, iterator_t<V>>
         {
-            return std::get<N>(*current_);
+            return current_;
         }
 
-        constexpr iterator& operator++() { ++current_; return *this; }
+        constexpr iterator& operator++()
+        {
+            current_ = ranges::find_if(++current_,
+                                       ranges::end(parent_->base_),
+                                       detail::as_ref(*parent_->pred_));
+            return *this;
+        }
 
         constexpr auto operator++(int)
         {
-            if constexpr (forward_range<base_t>) {
-                auto temp = *this;
+            if constexpr (forward_range<V>) {
+                auto tmp = *this;
                 ++*this;
-                return temp;
+                return tmp;
             } else {
                 ++*this;
             }
         }
 
-        template <typename B = base_t>
+        template <typename VV = V>
         constexpr auto operator--()
-            -> std::enable_if_t<bidirectional_range<B>, iterator&>
+            -> std::enable_if_t<bidirectional_range<VV>, iterator&>
         {
-            --current_;
+            do {
+                --current_;
+            } while (!nano::invoke(*parent_->pred_, *current_));
             return *this;
         }
 
-        template <typename B = base_t>
+        template <typename VV = V>
         constexpr auto operator--(int)
-            -> std::enable_if_t<bidirectional_range<B>, iterator>
-        {
-            auto temp = *this;
-            ++*this;
-            return temp;
-        }
-
-        template <typename B = base_t>
-        constexpr auto operator+=(difference_type x)
-            -> std::enable_if_t<random_access_range<B>, iterator&>
-        {
-            current_ += x;
-            return *this;
-        }
-
-        template <typename B = base_t>
-        constexpr auto operator-=(difference_type x)
-            -> std::enable_if_t<random_access_range<B>, iterator&>
-        {
-            current_ -= x;
-            return *this;
-        }
-
-        template <typename B = base_t,
-                  std::enable_if_t<random_access_range<B>, int> = 0>
-        constexpr decltype(auto) operator[](difference_type n) const
+            -> std::enable_if_t<bidirectional_range<VV>, iterator>
         {
-            return std::get<N>(*(current_ + n));
+            auto tmp = *this;
+            --*this;
+            return tmp;
         }
 
-        template <typename B = base_t>
+        template <typename VV = V>
         friend constexpr auto operator==(const iterator& x, const iterator& y)
-            -> std::enable_if_t<equality_comparable<iterator_t<B>>, bool>
+            -> std::enable_if_t<equality_comparable<iterator_t<VV>>, bool>
         {
             return x.current_ == y.current_;
         }
 
-        template <typename B = base_t>
+        template <typename VV = V>
         friend constexpr auto operator!=(const iterator& x, const iterator& y)
-            -> std::enable_if_t<equality_comparable<iterator_t<B>>, bool>
+            -> std::enable_if_t<equality_comparable<iterator_t<VV>>, bool>
         {
             return !(x == y);
         }
 
+        friend constexpr iter_rvalue_reference_t<iterator_t<V>>
+        iter_move(const iterator& i) noexcept(
+            noexcept(ranges::iter_move(i.current_)))
+        {
+            return ranges::iter_move(i.current_);
+        }
+
+        template <typename VV = V>
+        friend constexpr auto
+        iter_swap(const iterator& x, const iterator& y) noexcept(
+            noexcept(ranges::iter_swap(x.current_, y.current_)))
+            -> std::enable_if_t<indirectly_swappable<iterator_t<VV>>>
+        {
+            ranges::iter_swap(x.current_, y.current_);
+        }
+    };
+
+    struct sentinel {
+    private:
+        sentinel_t<V> end_ = sentinel_t<V>();
+
+    public:
+        sentinel() = default;
+
+        constexpr explicit sentinel(filter_view& parent)
+            : end_(ranges::end(parent.base_))
+        {}
+
+        constexpr sentinel_t<V> base() const { return end_; }
+
         // Make these friend functions templates to keep MSVC happy
 #if (defined(_MSC_VER) && _MSC_VER < 1922)
         template <typename = void>
 #endif
-        friend constexpr bool operator==(const iterator& x, const sentinel_t<base_t>& y)
+        friend constexpr bool operator==(const iterator& i, const sentinel& s)
         {
-            return x.current_ == y;
+            return i.base() == s.end_;
         }
 
 #if (defined(_MSC_VER) && _MSC_VER < 1922)
         template <typename = void>
 #endif
-        friend constexpr bool operator==(const sentinel_t<base_t>& y, const iterator& x)
+        friend constexpr bool operator==(const sentinel& s, const iterator& i)
         {
-            return x.current_ == y;
+            return i == s;
         }
 
 #if (defined(_MSC_VER) && _MSC_VER < 1922)
         template <typename = void>
 #endif
-        friend constexpr bool operator!=(const iterator& x, const sentinel_t<base_t>& y)
+        friend constexpr bool operator!=(const iterator& i, const sentinel& s)
         {
-            return !(x == y);
+            return !(i == s);
         }
 
 #if (defined(_MSC_VER) && _MSC_VER < 1922)
         template <typename = void>
 #endif
-        friend constexpr bool operator!=(const sentinel_t<base_t>& y, const iterator& x)
-        {
-            return !(x == y);
-        }
-
-        template <typename B = base_t>
-        friend constexpr auto operator<(const iterator& x, const iterator& y)
-            -> std::enable_if_t<random_access_range<B>, bool>
-        {
-            return x.current_ < y.current_;
-        }
-
-        template <typename B = base_t>
-        friend constexpr auto operator>(const iterator& x, const iterator& y)
-            -> std::enable_if_t<random_access_range<B>, bool>
-        {
-            return (y < x);
-        }
-
-        template <typename B = base_t>
-        friend constexpr auto operator<=(const iterator& x, const iterator& y)
-            -> std::enable_if_t<random_access_range<B>, bool>
-        {
-            return !(y < x);
-        }
-
-        template <typename B = base_t>
-        friend constexpr auto operator>=(const iterator& x, const iterator& y)
-            -> std::enable_if_t<random_access_range<B>, bool>
-        {
-            return !(x < y);
-        }
-
-        template <typename B = base_t>
-        friend constexpr auto operator+(const iterator& x, difference_type y)
-            -> std::enable_if_t<random_access_range<B>, iterator>
-        {
-            return iterator{x} += y;
-        }
-
-        template <typename B = base_t>
-        friend constexpr auto operator+(difference_type x, const iterator& y)
-            -> std::enable_if_t<random_access_range<B>, iterator>
+        friend constexpr bool operator!=(const sentinel& s, const iterator& i)
         {
-            return y + x;
+            return !(i == s);
         }
+    };
 
-        template <typename B = base_t>
-        friend constexpr auto operator-(const iterator& x, difference_type y)
-            -> std::enable_if_t<random_access_range<B>, iterator>
-        {
-            return iterator{x} -= y;
-        }
+    std::optional<iterator> begin_cache_{};
 
+public:
+    filter_view() = default;
 
-        template <typename B = base_t>
-        friend constexpr auto operator-(const iterator& x, const iterator& y)
-            -> std::enable_if_t<random_access_range<B>, difference_type>
-        {
-            return x.current_ - y.current_;
-        }
+    constexpr filter_view(V base, Pred pred)
+        : base_(std::move(base)), pred_(std::move(pred))
+    {}
 
-        template <typename B = base_t>
-        friend constexpr auto operator-(const iterator& x, const sentinel_t<base_t>& y)
-        -> std::enable_if_t<sized_sentinel_for<sentinel_t<B>, iterator_t<B>>,
-            difference_type>
-        {
-            return x.current_ - y;
-        }
+    constexpr V base() const { return base_; }
 
-        template <typename B = base_t>
-        friend constexpr auto operator-(const sentinel_t<base_t>& x, const iterator& y)
-            -> std::enable_if_t<sized_sentinel_for<sentinel_t<B>, iterator_t<B>>,
-                                difference_type>
-        {
-            return -(y - x);
+    constexpr iterator begin()
+    {
+        if (begin_cache_) {
+            return *begin_cache_;
         }
-    };
-
-    R base_ = R();
-};
-
-
-template <typename R>
-using keys_view = elements_view<all_view<R>, 0>;
-
-template <typename R>
-using values_view = elements_view<all_view<R>, 1>;
 
-namespace detail {
+        assert(pred_.has_value());
+        begin_cache_ = std::optional<iterator>{
+            iterator{*this, nano::find_if(base_, detail::as_ref(*pred_))}};
+        return *begin_cache_;
+    }
 
-template <std::size_t N>
-struct elements_view_fn {
-    template <typename E>
-    constexpr auto operator()(E&& e) const
-        -> decltype(elements_view<all_view<decltype(std::forward<E>(e))>, N>{std::forward<E>(e)})
+    constexpr auto end()
     {
-        return elements_view<all_view<decltype(std::forward<E>(e))>, N>{std::forward<E>(e)};
+        if constexpr (common_range<V>) {
+            return iterator{*this, ranges::end(base_)};
+        } else {
+            return sentinel{*this};
+        }
     }
 };
 
-template <std::size_t N>
-inline constexpr bool is_raco<elements_view_fn<N>> = true;
-
-} // namespace detail
-
-namespace views {
-
-inline namespace function_objects {
-
-template <std::size_t N>
-inline constexpr nano::detail::elements_view_fn<N> elements{};
-
-inline constexpr nano::detail::elements_view_fn<0> keys{};
-
-inline constexpr nano::detail::elements_view_fn<1> values{};
-
-}
+template <typename R, typename Pred>
+filter_view(R&&, Pred)->filter_view<all_view<R>, Pred>;
 
 }
 
+using filter_view_::filter_view;
 
-NANO_END_NAMESPACE
+namespace detail {
 
+struct filter_view_fn {
+    template <typename Pred>
+    constexpr auto operator()(Pred pred) const
+    {
+        return detail::rao_proxy{[p = std::move(pred)] (auto&& r) mutable
+#ifndef NANO_MSVC_LAMBDA_PIPE_WORKAROUND
+            -> decltype(filter_view{std::forward<decltype(r)>(r), std::declval<Pred&&>()})
 #endif
+        {
+            return filter_view{std::forward<decltype(r)>(r), std::move(p)};
+        }};
+    }
 
-// nanorange/views/empty.hpp
-//
-// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
-// Distributed under the Boost Software License, Version 1.0. (See accompanying
-// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
-
-#ifndef NANORANGE_VIEWS_EMPTY_HPP_INCLUDED
-#define NANORANGE_VIEWS_EMPTY_HPP_INCLUDED
-
-
-
-NANO_BEGIN_NAMESPACE
-
-namespace empty_view_ {
-
-template <typename T>
-class empty_view : view_interface<empty_view<T>> {
-    static_assert(std::is_object<T>::value, "");
-
-public:
-    static constexpr T* begin() noexcept { return nullptr; }
-    static constexpr T* end() noexcept { return nullptr; }
-    static constexpr std::ptrdiff_t size() noexcept { return 0; }
-    static constexpr T* data() noexcept { return nullptr; }
+    template <typename R, typename Pred>
+    constexpr auto operator()(R&& r, Pred pred) const
+        noexcept(noexcept(filter_view{std::forward<R>(r), std::move(pred)}))
+        -> decltype(filter_view{std::forward<R>(r), std::move(pred)})
+    {
+        return filter_view{std::forward<R>(r), std::move(pred)};
+    }
 
-    static constexpr bool empty() noexcept { return true; }
 };
 
 }
 
-using empty_view_::empty_view;
-
-template <typename T>
-inline constexpr bool enable_borrowed_range<empty_view<T>> = true;
-
 namespace views {
 
-template <typename T, typename = std::enable_if_t<std::is_object<T>::value>>
-inline constexpr empty_view<T> empty{};
+NANO_INLINE_VAR(nano::detail::filter_view_fn, filter)
 
 }
 
-
 NANO_END_NAMESPACE
 
 #endif
 
-// nanorange/views/filter.hpp
+
+// nanorange/views/iota.hpp
 //
 // Copyright (c) 2019 Tristan Brindle (tcbrindle at gmail dot com)
 // Distributed under the Boost Software License, Version 1.0. (See accompanying
 // file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
-#ifndef NANORANGE_VIEWS_FILTER_HPP_INCLUDED
-#define NANORANGE_VIEWS_FILTER_HPP_INCLUDED
+#ifndef NANORANGE_VIEWS_IOTA_HPP_INCLUDED
+#define NANORANGE_VIEWS_IOTA_HPP_INCLUDED
+
 
 
 
 
+NANO_BEGIN_NAMESPACE
+
+namespace detail {
+
+struct decrementable_concept {
+    template <typename I>
+    auto requires_(I i) -> decltype(
+        requires_expr<same_as<decltype(--i), I&>>{},
+        requires_expr<same_as<decltype(i--), I>>{}
+    );
+};
+
+template <typename I>
+NANO_CONCEPT decrementable = incrementable<I> && requires_<decrementable_concept, I>;
 
-#include <cassert>
+template <typename W>
+using iota_diff_t = iter_difference_t<W>;
 
-NANO_BEGIN_NAMESPACE
+struct advanceable_concept {
+    template <typename I>
+    auto requires_(I i, const I j, const iota_diff_t<I> n) -> decltype(
+        requires_expr<same_as<decltype(i += n), I&>>{},
+        requires_expr<same_as<decltype(i -= n), I&>>{},
+        I(j + n),
+        I(n + j),
+        I(j - n),
+        requires_expr<convertible_to<decltype(j - j), iota_diff_t<I>>>{}
+    );
+};
 
-namespace detail {
+template <typename I>
+NANO_CONCEPT advanceable =
+    decrementable<I> && totally_ordered<I> &&
+    requires_<advanceable_concept, I>;
 
-template <typename V>
-constexpr auto filter_view_iter_cat_helper()
+template <typename W>
+constexpr auto iota_view_iter_cat_helper()
 {
-    using C = iterator_category_t<iterator_t<V>>;
-    if constexpr (derived_from<C, bidirectional_iterator_tag>) {
+    if constexpr (detail::advanceable<W>) {
+        return random_access_iterator_tag{};
+    } else if constexpr (detail::decrementable<W>) {
         return bidirectional_iterator_tag{};
-    } else if constexpr (derived_from<C, forward_iterator_tag>) {
+    } else if constexpr (incrementable<W>) {
         return forward_iterator_tag{};
     } else {
         return input_iterator_tag{};
     }
 }
 
-constexpr inline auto as_ref = [](auto& pred) {
-    return [&p = pred] (auto&& arg) {
-        return nano::invoke(p, std::forward<decltype(arg)>(arg));
-    };
-};
-
-}
-
-namespace filter_view_ {
-
-template <typename V, typename Pred>
-struct filter_view : view_interface<filter_view<V, Pred>> {
+} // namespace detail
 
-    // FIXME: GCC9 recursive constraint (?) problems again
-    // static_assert(input_range<V>);
-    static_assert(input_iterator<iterator_t<V>>);
-    static_assert(indirect_unary_predicate<Pred, iterator_t<V>>);
-    static_assert(view<V>);
-    static_assert(std::is_object_v<Pred>);
+template <typename W, typename Bound = unreachable_sentinel_t>
+struct iota_view : view_interface<iota_view<W, Bound>> {
+    static_assert(weakly_incrementable<W>);
+    static_assert(semiregular<Bound>);
+    static_assert(detail::weakly_equality_comparable_with<W, Bound>);
 
 private:
-    V base_ = V();
-    detail::semiregular_box<Pred> pred_;
+    struct sentinel;
 
     struct iterator {
     private:
-        iterator_t<V> current_ = iterator_t<V>();
-        filter_view* parent_ = nullptr;
+        friend struct sentinel;
+        W value_ = W();
 
     public:
-        // using iterator_concept = ...
-        using iterator_category =
-            decltype(detail::filter_view_iter_cat_helper<V>());
-        using value_type = iter_value_t<iterator_t<V>>;
-        using difference_type = iter_difference_t<iterator_t<V>>;
+        using iterator_category = decltype(detail::iota_view_iter_cat_helper<W>());
+        using value_type = W;
+        using difference_type = detail::iota_diff_t<W>;
         // Extension: legacy typedefs
-        using pointer = iterator_t<V>;
-        using reference = iter_reference_t<iterator_t<V>>;
+        using pointer = void;
+        using reference = W;
 
         iterator() = default;
-        constexpr iterator(filter_view& parent, iterator_t<V> current)
-            : current_(std::move(current)), parent_(std::addressof(parent))
-        {}
-
-        constexpr iterator_t<V> base() const { return current_; }
 
-        constexpr iter_reference_t<iterator_t<V>> operator*() const
-        {
-            return *current_;
-        }
+        constexpr explicit iterator(W value) : value_(value) {}
 
-        template <typename VV = V>
-        constexpr auto operator->() const
-            -> std::enable_if_t<detail::has_arrow<iterator_t<VV>>, iterator_t<V>>
+        constexpr W operator*() const
+            noexcept(std::is_nothrow_copy_constructible_v<W>)
         {
-            return current_;
+            return value_;
         }
 
         constexpr iterator& operator++()
         {
-            current_ = ranges::find_if(++current_,
-                                       ranges::end(parent_->base_),
-                                       detail::as_ref(*parent_->pred_));
+            ++value_;
             return *this;
         }
 
         constexpr auto operator++(int)
         {
-            if constexpr (forward_range<V>) {
+            if constexpr (incrementable<W>) {
                 auto tmp = *this;
                 ++*this;
                 return tmp;
@@ -16693,189 +23818,428 @@ private:
             }
         }
 
-        template <typename VV = V>
+        template <typename WW = W>
         constexpr auto operator--()
-            -> std::enable_if_t<bidirectional_range<VV>, iterator&>
+            -> std::enable_if_t<detail::decrementable<WW>, iterator&>
         {
-            do {
-                --current_;
-            } while (!nano::invoke(*parent_->pred_, *current_));
+            --value_;
             return *this;
         }
 
-        template <typename VV = V>
-        constexpr auto operator--(int)
-            -> std::enable_if_t<bidirectional_range<VV>, iterator>
+        constexpr iterator operator--(int)
         {
             auto tmp = *this;
-            --*this;
+            ++*this;
             return tmp;
         }
 
-        template <typename VV = V>
+        template <typename WW = W>
+        constexpr auto operator+=(difference_type n)
+            -> std::enable_if_t<detail::advanceable<WW>, iterator&>
+        {
+            if constexpr (integral<W> && !signed_integral<W>) {
+                if (n >= difference_type(0)) {
+                    value_ += static_cast<W>(n);
+                } else {
+                    value_ -= static_cast<W>(-n);
+                }
+            } else {
+                value_ += n;
+            }
+            return *this;
+        }
+
+        template <typename WW = W>
+        constexpr auto operator-=(difference_type n)
+            -> std::enable_if_t<detail::advanceable<WW>, iterator&>
+        {
+            if constexpr (integral<W> && !signed_integral<W>) {
+                if (n >= difference_type(0)) {
+                    value_ -= static_cast<W>(n);
+                } else {
+                    value_ += static_cast<W>(-n);
+                }
+            } else {
+                value_ -= n;
+            }
+            return *this;
+        }
+
+        template <typename WW = W>
+        constexpr auto operator[](difference_type n) const
+            -> std::enable_if_t<detail::advanceable<WW>, W>
+        {
+            return W(value_ + n);
+        }
+
+        template <typename WW = W>
         friend constexpr auto operator==(const iterator& x, const iterator& y)
-            -> std::enable_if_t<equality_comparable<iterator_t<VV>>, bool>
+            -> std::enable_if_t<equality_comparable<WW>, bool>
         {
-            return x.current_ == y.current_;
+            return x.value_ == y.value_;
         }
 
-        template <typename VV = V>
+        template <typename WW = W>
         friend constexpr auto operator!=(const iterator& x, const iterator& y)
-            -> std::enable_if_t<equality_comparable<iterator_t<VV>>, bool>
+            -> std::enable_if_t<equality_comparable<WW>, bool>
         {
             return !(x == y);
         }
 
-        friend constexpr iter_rvalue_reference_t<iterator_t<V>>
-        iter_move(const iterator& i) noexcept(
-            noexcept(ranges::iter_move(i.current_)))
+        template <typename WW = W>
+        friend constexpr auto operator<(const iterator& x, const iterator& y)
+            -> std::enable_if_t<totally_ordered<WW>, bool>
         {
-            return ranges::iter_move(i.current_);
+            return x.value_ < y.value_;
         }
 
-        template <typename VV = V>
-        friend constexpr auto
-        iter_swap(const iterator& x, const iterator& y) noexcept(
-            noexcept(ranges::iter_swap(x.current_, y.current_)))
-            -> std::enable_if_t<indirectly_swappable<iterator_t<VV>>>
+        template <typename WW = W>
+        friend constexpr auto operator>(const iterator& x, const iterator& y)
+            -> std::enable_if_t<totally_ordered<WW>, bool>
         {
-            ranges::iter_swap(x.current_, y.current_);
+            return y < x;
+        }
+
+        template <typename WW = W>
+        friend constexpr auto operator<=(const iterator& x, const iterator& y)
+            -> std::enable_if_t<totally_ordered<WW>, bool>
+        {
+            return !(y < x);
+        }
+
+        template <typename WW = W>
+        friend constexpr auto operator>=(const iterator& x, const iterator& y)
+            -> std::enable_if_t<totally_ordered<WW>, bool>
+        {
+            return !(x < y);
+        }
+
+        template <typename WW = W>
+        friend constexpr auto operator+(iterator i, difference_type n)
+            -> std::enable_if_t<detail::advanceable<WW>, iterator>
+        {
+            return i += n;
+        }
+
+        template <typename WW = W>
+        friend constexpr auto operator+(difference_type n, iterator i)
+            -> std::enable_if_t<detail::advanceable<WW>, iterator>
+        {
+            return i + n;
+        }
+
+        template <typename WW = W>
+        friend constexpr auto operator-(iterator i, difference_type n)
+            -> std::enable_if_t<detail::advanceable<WW>, iterator>
+        {
+            return i -= n;
+        }
+
+        template <typename WW = W>
+        friend constexpr auto operator-(const iterator& x, const iterator& y)
+            -> std::enable_if_t<detail::advanceable<WW>, difference_type>
+        {
+            using D = difference_type;
+            if constexpr (integral<D>) {
+                if constexpr (signed_integral<D>) {
+                    return D(D(x.value_) - D(y.value_));
+                } else {
+                    return (y.value_ > x.value)
+                        ? D(-D(y.value_ - x.value_))
+                        : D(x.value_ - y.value_);
+                }
+            } else {
+                return x.value_ - y.value_;
+            }
         }
     };
 
     struct sentinel {
     private:
-        sentinel_t<V> end_ = sentinel_t<V>();
+        Bound bound_ = Bound();
 
     public:
         sentinel() = default;
+        constexpr explicit sentinel(Bound bound) : bound_(bound) {}
 
-        constexpr explicit sentinel(filter_view& parent)
-            : end_(ranges::end(parent.base_))
-        {}
-
-        constexpr sentinel_t<V> base() const { return end_; }
-
-        // Make these friend functions templates to keep MSVC happy
-#if (defined(_MSC_VER) && _MSC_VER < 1922)
-        template <typename = void>
-#endif
         friend constexpr bool operator==(const iterator& i, const sentinel& s)
         {
-            return i.base() == s.end_;
+            return i.value_ == s.bound_;
         }
-
-#if (defined(_MSC_VER) && _MSC_VER < 1922)
-        template <typename = void>
-#endif
+
         friend constexpr bool operator==(const sentinel& s, const iterator& i)
         {
             return i == s;
         }
 
-#if (defined(_MSC_VER) && _MSC_VER < 1922)
-        template <typename = void>
-#endif
         friend constexpr bool operator!=(const iterator& i, const sentinel& s)
         {
             return !(i == s);
         }
 
-#if (defined(_MSC_VER) && _MSC_VER < 1922)
-        template <typename = void>
-#endif
         friend constexpr bool operator!=(const sentinel& s, const iterator& i)
         {
             return !(i == s);
         }
+
+        template <typename WW = W>
+        friend constexpr auto operator-(const iterator& i, const sentinel& s)
+            -> std::enable_if_t<sized_sentinel_for<Bound, WW>, iter_difference_t<WW>>
+        {
+            return i.value_ - s.bound_;
+        }
+
+        template <typename WW = W>
+        friend constexpr auto operator-(const sentinel& s, const iterator& i)
+            -> std::enable_if_t<sized_sentinel_for<Bound, WW>, iter_difference_t<WW>>
+        {
+            return -(i - s);
+        }
     };
 
-    std::optional<iterator> begin_cache_{};
+    W value_ = W();
+    Bound bound_ = Bound();
 
 public:
-    filter_view() = default;
+    iota_view() = default;
 
-    constexpr filter_view(V base, Pred pred)
-        : base_(std::move(base)), pred_(std::move(pred))
+    constexpr explicit iota_view(W value) : value_(value) {}
+
+    constexpr iota_view(type_identity_t<W> value, type_identity_t<Bound> bound)
+        : value_(value),
+          bound_(bound)
     {}
 
-    constexpr V base() const { return base_; }
+    constexpr iota_view(iterator first, sentinel last)
+        : iota_view(*first, last.bound_) {}
 
-    constexpr iterator begin()
+    constexpr iterator begin() const
     {
-        if (begin_cache_) {
-            return *begin_cache_;
+        return iterator{value_};
+    }
+
+    template <typename WW = W, std::enable_if_t<!same_as<WW, Bound>, int> = 0>
+    constexpr auto end() const
+    {
+        if constexpr (same_as<Bound, unreachable_sentinel_t>) {
+            return unreachable_sentinel;
+        } else {
+            return sentinel{bound_};
         }
+    }
 
-        assert(pred_.has_value());
-        begin_cache_ = std::optional<iterator>{
-            iterator{*this, nano::find_if(base_, detail::as_ref(*pred_))}};
-        return *begin_cache_;
+    template <typename WW = W, std::enable_if_t<same_as<WW, Bound>, int> = 0>
+    constexpr iterator end() const
+    {
+        return iterator{bound_};
     }
 
-    constexpr auto end()
+    template <typename WW = W, typename BB = Bound, std::enable_if_t<
+              (same_as<WW, BB> && detail::advanceable<W>) ||
+              (integral<WW> && integral<BB>) ||
+                                   sized_sentinel_for<BB, WW>, int> = 0>
+    constexpr auto size() const
     {
-        if constexpr (common_range<V>) {
-            return iterator{*this, ranges::end(base_)};
+        constexpr auto make_unsigned_like = [](auto i) {
+            return std::make_unsigned_t<decltype(i)>(i);
+        };
+
+        if constexpr (integral<W> && integral<Bound>) {
+            return (value_ < 0)
+                ? ((bound_ < 0)
+                  ? make_unsigned_like(-value_) - make_unsigned_like(-bound_)
+                  : make_unsigned_like(bound_) - make_unsigned_like(-value_))
+                : make_unsigned_like(bound_) - make_unsigned_like(value_);
         } else {
-            return sentinel{*this};
+            make_unsigned_like(bound_ - value_);
         }
     }
 };
 
-template <typename R, typename Pred>
-filter_view(R&&, Pred)->filter_view<all_view<R>, Pred>;
+template <typename W, typename Bound, std::enable_if_t<
+    !integral<W> || !integral<Bound> ||
+        (signed_integral<W> == signed_integral<Bound>), int> = 0>
+iota_view(W, Bound) -> iota_view<W, Bound>;
 
-}
+template <typename W, typename Bound>
+inline constexpr bool enable_borrowed_range<iota_view<W, Bound>> = true;
 
-using filter_view_::filter_view;
+namespace views {
 
 namespace detail {
 
-struct filter_view_fn {
-    template <typename Pred>
-    constexpr auto operator()(Pred pred) const
+struct iota_view_fn {
+    template <typename W>
+    constexpr auto operator()(W&& value) const
+        noexcept(noexcept(iota_view{std::forward<W>(value)}))
+        -> decltype(iota_view(std::forward<W>(value)))
     {
-        return detail::rao_proxy{[p = std::move(pred)] (auto&& r) mutable
-#ifndef NANO_MSVC_LAMBDA_PIPE_WORKAROUND
-            -> decltype(filter_view{std::forward<decltype(r)>(r), std::declval<Pred&&>()})
-#endif
-        {
-            return filter_view{std::forward<decltype(r)>(r), std::move(p)};
-        }};
+        return iota_view(std::forward<W>(value));
     }
 
-    template <typename R, typename Pred>
-    constexpr auto operator()(R&& r, Pred pred) const
-        noexcept(noexcept(filter_view{std::forward<R>(r), std::move(pred)}))
-        -> decltype(filter_view{std::forward<R>(r), std::move(pred)})
+    template <typename W, typename Bound>
+    constexpr auto operator()(W&& value, Bound&& bound) const
+        noexcept(noexcept(iota_view{std::forward<W>(value), std::forward<Bound>(bound)}))
+        -> decltype(iota_view(std::forward<W>(value), std::forward<Bound>(bound)))
     {
-        return filter_view{std::forward<R>(r), std::move(pred)};
+        return iota_view{std::forward<W>(value), std::forward<Bound>(bound)};
     }
-
 };
 
+} // namespace detail
+
+NANO_INLINE_VAR(detail::iota_view_fn, iota)
+
 }
 
-namespace views {
+NANO_END_NAMESPACE
 
-NANO_INLINE_VAR(nano::detail::filter_view_fn, filter)
+#endif
+
+// nanorange/views/istream.hpp
+//
+// Copyright (c) 2019 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NANORANGE_VIEWS_ISTREAM_HPP_INCLUDED
+#define NANORANGE_VIEWS_ISTREAM_HPP_INCLUDED
+
+
+
+
+
+#include <iosfwd>
+
+NANO_BEGIN_NAMESPACE
+
+namespace detail {
+
+struct StreamExtractable_req {
+    template <typename Val, typename CharT, typename Traits>
+    auto requires_(std::basic_istream<CharT, Traits>& is, Val& t)
+        -> decltype(is >> t);
+};
+
+template <typename Val, typename CharT, typename Traits>
+NANO_CONCEPT StreamExtractable =
+    requires_<StreamExtractable_req, Val, CharT, Traits>;
+
+} // namespace detail
+
+template <typename Val, typename CharT, typename Traits = std::char_traits<CharT>>
+struct basic_istream_view : view_interface<basic_istream_view<Val, CharT, Traits>> {
+
+    static_assert(movable<Val>);
+    static_assert(default_initializable<Val>);
+    static_assert(detail::StreamExtractable<Val, CharT, Traits>);
+
+    basic_istream_view() = default;
+
+    constexpr explicit basic_istream_view(std::basic_istream<CharT, Traits>& stream)
+        : stream_(std::addressof(stream))
+    {}
+
+    constexpr auto begin()
+    {
+        if (stream_) {
+            *stream_ >> object_;
+        }
+        return iterator{*this};
+    }
+
+    constexpr default_sentinel_t end() const noexcept
+    {
+        return default_sentinel;
+    }
+
+private:
+    struct iterator {
+        using iterator_category = input_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = Val;
+
+        iterator() = default;
+
+        constexpr explicit iterator(basic_istream_view& parent) noexcept
+            : parent_(std::addressof(parent))
+        {}
+
+        // Disable move-only iterator until views support them properly
+#if 0
+        iterator(const iterator&) = delete;
+        iterator(iterator&&) = default;
+
+        iterator& operator=(const iterator&) = delete;
+        iterator& operator=(iterator&&) = default;
+#endif
+        iterator& operator++()
+        {
+            *parent_->stream_ >> parent_->object_;
+            return *this;
+        }
+
+        void operator++(int)
+        {
+            ++*this;
+        }
+
+        Val& operator*() const { return parent_->object_; }
+
+        friend bool operator==(const iterator& x, default_sentinel_t)
+        {
+            return x.done();
+        }
+
+        friend bool operator==(default_sentinel_t s, const iterator& x)
+        {
+            return x == s;
+        }
+
+        friend bool operator!=(const iterator& x, default_sentinel_t s)
+        {
+            return !(x == s);
+        }
+
+        friend bool operator!=(default_sentinel_t s, const iterator& x)
+        {
+            return !(x == s);
+        }
+
+    private:
+        [[nodiscard]] bool done() const
+        {
+            return parent_ == nullptr
+                  || parent_->stream_ == nullptr
+                  || !*parent_->stream_;
+        }
+
+        basic_istream_view* parent_{};
+    };
+
+    std::basic_istream<CharT, Traits>* stream_{};
+    Val object_ = Val();
+};
 
+template <typename Val, typename CharT, typename Traits>
+auto istream_view(std::basic_istream<CharT, Traits>& s)
+    -> basic_istream_view<Val, CharT, Traits>
+{
+    return basic_istream_view<Val, CharT, Traits>{s};
 }
 
 NANO_END_NAMESPACE
 
 #endif
 
-
-// nanorange/views/iota.hpp
+// nanorange/views/join.hpp
 //
 // Copyright (c) 2019 Tristan Brindle (tcbrindle at gmail dot com)
 // Distributed under the Boost Software License, Version 1.0. (See accompanying
 // file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
-#ifndef NANORANGE_VIEWS_IOTA_HPP_INCLUDED
-#define NANORANGE_VIEWS_IOTA_HPP_INCLUDED
+#ifndef NANORANGE_VIEWS_JOIN_HPP_INCLUDED
+#define NANORANGE_VIEWS_JOIN_HPP_INCLUDED
 
 
 
@@ -16885,892 +24249,936 @@ NANO_BEGIN_NAMESPACE
 
 namespace detail {
 
-struct decrementable_concept {
-    template <typename I>
-    auto requires_(I i) -> decltype(
-        requires_expr<same_as<decltype(--i), I&>>{},
-        requires_expr<same_as<decltype(i--), I>>{}
-    );
+template <typename V, bool InnerIsReference>
+struct join_view_data {
+    V base_ = V();
 };
 
-template <typename I>
-NANO_CONCEPT decrementable = incrementable<I> && requires_<decrementable_concept, I>;
-
-template <typename W>
-using iota_diff_t = iter_difference_t<W>;
-
-struct advanceable_concept {
-    template <typename I>
-    auto requires_(I i, const I j, const iota_diff_t<I> n) -> decltype(
-        requires_expr<same_as<decltype(i += n), I&>>{},
-        requires_expr<same_as<decltype(i -= n), I&>>{},
-        I(j + n),
-        I(n + j),
-        I(j - n),
-        requires_expr<convertible_to<decltype(j - j), iota_diff_t<I>>>{}
-    );
+template <typename V>
+struct join_view_data<V, false> {
+    V base_ = V();
+    all_view<range_reference_t<V>> inner_ = all_view<range_reference_t<V>>();
 };
 
-template <typename I>
-NANO_CONCEPT advanceable =
-    decrementable<I> && totally_ordered<I> &&
-    requires_<advanceable_concept, I>;
-
-template <typename W>
-constexpr auto iota_view_iter_cat_helper()
+template <typename B>
+constexpr auto join_view_iter_cat_helper()
 {
-    if constexpr (detail::advanceable<W>) {
-        return random_access_iterator_tag{};
-    } else if constexpr (detail::decrementable<W>) {
-        return bidirectional_iterator_tag{};
-    } else if constexpr (incrementable<W>) {
-        return forward_iterator_tag{};
+    constexpr bool ref_is_glvalue = std::is_reference_v<range_reference_t<B>>;
+
+    if constexpr (ref_is_glvalue) {
+        using OuterCat = iterator_category_t<iterator_t<B>>;
+        using InnerCat = iterator_category_t<iterator_t<range_reference_t<B>>>;
+
+        if constexpr (derived_from<OuterCat, bidirectional_iterator_tag> &&
+                      derived_from<InnerCat, bidirectional_iterator_tag>) {
+            return bidirectional_iterator_tag{};
+        } else if constexpr(derived_from<OuterCat, forward_iterator_tag> &&
+                            derived_from<InnerCat, forward_iterator_tag>) {
+            return forward_iterator_tag{};
+        } else {
+            return input_iterator_tag{};
+        }
     } else {
         return input_iterator_tag{};
     }
 }
 
-} // namespace detail
+}
 
-template <typename W, typename Bound = unreachable_sentinel_t>
-struct iota_view : view_interface<iota_view<W, Bound>> {
-    static_assert(weakly_incrementable<W>);
-    static_assert(semiregular<Bound>);
-    static_assert(detail::weakly_equality_comparable_with<W, Bound>);
+namespace join_view_ {
 
+template <typename V>
+struct join_view : view_interface<join_view<V>> {
 private:
-    struct sentinel;
 
+    static_assert(input_range<V>);
+    static_assert(view<V>);
+    static_assert(input_range<range_reference_t<V>>);
+    static_assert(std::is_reference_v<range_reference_t<V>> ||
+                  view<range_value_t<V>>);
+
+    using InnerRng = range_reference_t<V>;
+
+    template<bool> struct sentinel;
+
+    template <bool Const>
     struct iterator {
-    private:
-        friend struct sentinel;
-        W value_ = W();
 
-    public:
-        using iterator_category = decltype(detail::iota_view_iter_cat_helper<W>());
-        using value_type = W;
-        using difference_type = detail::iota_diff_t<W>;
-        // Extension: legacy typedefs
-        using pointer = void;
-        using reference = W;
+        friend struct sentinel<Const>;
 
-        iterator() = default;
+        template <typename B>
+        static constexpr bool ref_is_glvalue =
+            std::is_reference_v<range_reference_t<B>>;
 
-        constexpr explicit iterator(W value) : value_(value) {}
+        using Base = detail::conditional_t<Const, const V, V>;
 
-        constexpr W operator*() const
-            noexcept(std::is_nothrow_copy_constructible_v<W>)
-        {
-            return value_;
-        }
+        // https://github.com/ericniebler/stl2/issues/604
+        using Parent = detail::conditional_t<Const && ref_is_glvalue<Base>,
+            const join_view, join_view>;
 
-        constexpr iterator& operator++()
-        {
-            ++value_;
-            return *this;
-        }
+        iterator_t<Base> outer_ = iterator_t<Base>();
+        iterator_t<range_reference_t<Base>> inner_
+            = iterator_t<range_reference_t<Base>>();
+        Parent* parent_ = nullptr;
 
-        constexpr auto operator++(int)
+        template <typename B = Base>
+        constexpr decltype(auto) update_inner(range_reference_t<Base> x)
         {
-            if constexpr (incrementable<W>) {
-                auto tmp = *this;
-                ++*this;
-                return tmp;
+            if constexpr (ref_is_glvalue<B>) {
+                return (x);
             } else {
-                ++*this;
+                return (parent_->data_.inner_ = views::all(x));
             }
         }
 
-        template <typename WW = W>
-        constexpr auto operator--()
-            -> std::enable_if_t<detail::decrementable<WW>, iterator&>
+        constexpr void satisfy()
         {
-            --value_;
-            return *this;
+            for (; outer_ !=  ranges::end(parent_->data_.base_); ++outer_) {
+                auto& inner = update_inner(*outer_);
+                inner_ = ranges::begin(inner);
+                if (inner_ != ranges::end(inner)) {
+                    return;
+                }
+            }
+
+            if constexpr (ref_is_glvalue<Base>) {
+                inner_ = iterator_t<range_reference_t<Base>>();
+            }
         }
 
-        constexpr iterator operator--(int)
+    public:
+        //using iterator_concept = ...
+        using iterator_category = decltype(detail::join_view_iter_cat_helper<Base>());
+        using value_type = range_value_t<range_reference_t<Base>>;
+        using difference_type = nano::common_type_t<
+            range_difference_t<Base>,
+            range_difference_t<range_reference_t<Base>>>;
+        // Extension: legacy typedefs
+        using pointer = iterator_t<Base>;
+        using reference = range_reference_t<range_reference_t<Base>>;
+
+        iterator() = default;
+
+        constexpr iterator(Parent& parent, iterator_t<Base> outer)
+            : outer_(std::move(outer)),
+              parent_(std::addressof(parent))
         {
-            auto tmp = *this;
-            ++*this;
-            return tmp;
+            satisfy();
         }
 
-        template <typename WW = W>
-        constexpr auto operator+=(difference_type n)
-            -> std::enable_if_t<detail::advanceable<WW>, iterator&>
+        // constexpr iterator(iterator<!Const>);
+
+        constexpr decltype(auto) operator*() const { return *inner_; }
+
+        template <typename B = Base>
+        constexpr auto operator->() const
+            -> std::enable_if_t<detail::has_arrow<B>, iterator_t<Base>>
         {
-            if constexpr (integral<W> && !signed_integral<W>) {
-                if (n >= difference_type(0)) {
-                    value_ += static_cast<W>(n);
-                } else {
-                    value_ -= static_cast<W>(-n);
-                }
-            } else {
-                value_ += n;
-            }
-            return *this;
+            return inner_;
         }
 
-        template <typename WW = W>
-        constexpr auto operator-=(difference_type n)
-            -> std::enable_if_t<detail::advanceable<WW>, iterator&>
+    private:
+        template <typename B = Base>
+        constexpr decltype(auto) get_inner_rng()
         {
-            if constexpr (integral<W> && !signed_integral<W>) {
-                if (n >= difference_type(0)) {
-                    value_ -= static_cast<W>(n);
-                } else {
-                    value_ += static_cast<W>(-n);
-                }
+            if constexpr (ref_is_glvalue<B>) {
+                return (*outer_);
             } else {
-                value_ -= n;
+                return (parent_->data_.inner_);
             }
-            return *this;
         }
 
-        template <typename WW = W>
-        constexpr auto operator[](difference_type n) const
-            -> std::enable_if_t<detail::advanceable<WW>, W>
+    public:
+        template <typename B = Base>
+        constexpr iterator& operator++()
         {
-            return W(value_ + n);
-        }
+            auto&& inner_rng = get_inner_rng();
 
-        template <typename WW = W>
-        friend constexpr auto operator==(const iterator& x, const iterator& y)
-            -> std::enable_if_t<equality_comparable<WW>, bool>
-        {
-            return x.value_ == y.value_;
-        }
+            if (++inner_ == ranges::end(inner_rng)) {
+                ++outer_;
+                satisfy();
+            }
 
-        template <typename WW = W>
-        friend constexpr auto operator!=(const iterator& x, const iterator& y)
-            -> std::enable_if_t<equality_comparable<WW>, bool>
-        {
-            return !(x == y);
+            return *this;
         }
 
-        template <typename WW = W>
-        friend constexpr auto operator<(const iterator& x, const iterator& y)
-            -> std::enable_if_t<totally_ordered<WW>, bool>
+        template <typename B = Base>
+        constexpr auto operator++(int)
+            -> std::enable_if_t<!(ref_is_glvalue<B> &&
+                                  forward_range<B> &&
+                                  forward_range<range_reference_t<B>>)>
         {
-            return x.value_ < y.value_;
+            ++*this;
         }
 
-        template <typename WW = W>
-        friend constexpr auto operator>(const iterator& x, const iterator& y)
-            -> std::enable_if_t<totally_ordered<WW>, bool>
+        template <typename B = Base>
+        constexpr auto operator++(int)
+            -> std::enable_if_t<ref_is_glvalue<B> &&
+                                forward_range<B> &&
+                                forward_range<range_reference_t<B>>,
+                                iterator>
         {
-            return y < x;
+            auto tmp = *this;
+            ++*this;
+            return tmp;
         }
 
-        template <typename WW = W>
-        friend constexpr auto operator<=(const iterator& x, const iterator& y)
-            -> std::enable_if_t<totally_ordered<WW>, bool>
+        template <typename B = Base>
+        constexpr auto operator--()
+            -> std::enable_if_t<ref_is_glvalue<B> &&
+                                bidirectional_range<B> &&
+                                bidirectional_range<range_reference_t<B>>,
+                                iterator&>
         {
-            return !(y < x);
+            if (outer_ == ranges::end(parent_->data_.base_)) {
+                inner_ = ranges::end(*outer_);
+            }
+
+            while (inner_ == ranges::begin(*outer_)) {
+                inner_ = ranges::end(*--outer_);
+            }
+            --inner_;
+            return *this;
         }
 
-        template <typename WW = W>
-        friend constexpr auto operator>=(const iterator& x, const iterator& y)
-            -> std::enable_if_t<totally_ordered<WW>, bool>
+        template <typename B = Base>
+        constexpr auto operator--(int)
+            -> std::enable_if_t<ref_is_glvalue<B> &&
+                                bidirectional_range<B> &&
+                                bidirectional_range<range_reference_t<B>>,
+                                iterator>
         {
-            return !(x < y);
+            auto tmp = *this;
+            --*this;
+            return *tmp;
         }
 
-        template <typename WW = W>
-        friend constexpr auto operator+(iterator i, difference_type n)
-            -> std::enable_if_t<detail::advanceable<WW>, iterator>
+        template <typename B = Base>
+        friend constexpr auto operator==(const iterator& x, const iterator& y)
+            -> std::enable_if_t<ref_is_glvalue<B> &&
+                                equality_comparable<iterator_t<B>> &&
+                                equality_comparable<iterator_t<range_reference_t<B>>>,
+                                bool>
         {
-            return i += n;
+            return x.outer_ == y.outer_ && x.inner_ == y.inner_;
         }
 
-        template <typename WW = W>
-        friend constexpr auto operator+(difference_type n, iterator i)
-            -> std::enable_if_t<detail::advanceable<WW>, iterator>
+        template <typename B = Base>
+        friend constexpr auto operator!=(const iterator& x, const iterator& y)
+            -> std::enable_if_t<ref_is_glvalue<B> &&
+                                equality_comparable<iterator_t<B>> &&
+                                equality_comparable<iterator_t<range_reference_t<B>>>,
+                                bool>
         {
-            return i + n;
+            return !(x == y);
         }
 
-        template <typename WW = W>
-        friend constexpr auto operator-(iterator i, difference_type n)
-            -> std::enable_if_t<detail::advanceable<WW>, iterator>
+        friend constexpr decltype(auto) iter_move(const iterator& i)
+            noexcept(noexcept(ranges::iter_move(i.inner_)))
         {
-            return i -= n;
+            return ranges::iter_move(i.inner_);
         }
 
-        template <typename WW = W>
-        friend constexpr auto operator-(const iterator& x, const iterator& y)
-            -> std::enable_if_t<detail::advanceable<WW>, difference_type>
+        friend constexpr void iter_swap(const iterator& x, const iterator& y)
+            noexcept(noexcept(ranges::iter_swap(x.inner_, y.inner_)))
         {
-            using D = difference_type;
-            if constexpr (integral<D>) {
-                if constexpr (signed_integral<D>) {
-                    return D(D(x.value_) - D(y.value_));
-                } else {
-                    return (y.value_ > x.value)
-                        ? D(-D(y.value_ - x.value_))
-                        : D(x.value_ - y.value_);
-                }
-            } else {
-                return x.value_ - y.value_;
-            }
+            ranges::iter_swap(x.inner_, y.inner_);
         }
     };
 
+    template <bool Const>
     struct sentinel {
     private:
-        Bound bound_ = Bound();
+        using Parent = detail::conditional_t<Const, const join_view, join_view>;
+        using Base = detail::conditional_t<Const, const V, V>;
+
+        sentinel_t<Base> end_ = sentinel_t<Base>();
 
     public:
         sentinel() = default;
-        constexpr explicit sentinel(Bound bound) : bound_(bound) {}
 
-        friend constexpr bool operator==(const iterator& i, const sentinel& s)
-        {
-            return i.value_ == s.bound_;
-        }
+        constexpr explicit sentinel(Parent& parent)
+            : end_(ranges::end(parent.data_.base_))
+        {}
 
-        friend constexpr bool operator==(const sentinel& s, const iterator& i)
-        {
-            return i == s;
-        }
+        // constexpr sentinel(sentinel<!Const> s);
 
-        friend constexpr bool operator!=(const iterator& i, const sentinel& s)
+        friend constexpr bool operator==(const iterator<Const>& x, const sentinel& y)
         {
-            return !(i == s);
+            return x.outer_ == y.end_;
         }
 
-        friend constexpr bool operator!=(const sentinel& s, const iterator& i)
+        friend constexpr bool operator!=(const iterator<Const>& x, const sentinel& y)
         {
-            return !(i == s);
+            return !(x == y);
         }
 
-        template <typename WW = W>
-        friend constexpr auto operator-(const iterator& i, const sentinel& s)
-            -> std::enable_if_t<sized_sentinel_for<Bound, WW>, iter_difference_t<WW>>
+        friend constexpr bool operator==(const sentinel& x, const iterator<Const>& y)
         {
-            return i.value_ - s.bound_;
+            return y == x;
         }
 
-        template <typename WW = W>
-        friend constexpr auto operator-(const sentinel& s, const iterator& i)
-            -> std::enable_if_t<sized_sentinel_for<Bound, WW>, iter_difference_t<WW>>
+        friend constexpr bool operator!=(const sentinel& x, const iterator<Const>& y)
         {
-            return -(i - s);
+            return !(y == x);
         }
     };
 
-    W value_ = W();
-    Bound bound_ = Bound();
+    detail::join_view_data<V, std::is_reference_v<InnerRng>> data_{};
 
 public:
-    iota_view() = default;
 
-    constexpr explicit iota_view(W value) : value_(value) {}
+    join_view() = default;
 
-    constexpr iota_view(type_identity_t<W> value, type_identity_t<Bound> bound)
-        : value_(value),
-          bound_(bound)
+    constexpr explicit join_view(V base)
+        : data_{std::move(base)}
     {}
 
-    constexpr iota_view(iterator first, sentinel last)
-        : iota_view(*first, last.bound_) {}
-
-    constexpr iterator begin() const
+    constexpr auto begin()
     {
-        return iterator{value_};
+        return iterator<detail::simple_view<V>>{*this, ranges::begin(data_.base_)};
     }
 
-    template <typename WW = W, std::enable_if_t<!same_as<WW, Bound>, int> = 0>
-    constexpr auto end() const
+    template <typename VV = V,
+              std::enable_if_t<input_range<const VV> &&
+                               std::is_reference_v<range_reference_t<const VV>>, int> = 0>
+    constexpr auto begin() const
     {
-        if constexpr (same_as<Bound, unreachable_sentinel_t>) {
-            return unreachable_sentinel;
-        } else {
-            return sentinel{bound_};
-        }
+        return iterator<true>{*this, ranges::begin(data_.base_)};
     }
 
-    template <typename WW = W, std::enable_if_t<same_as<WW, Bound>, int> = 0>
-    constexpr iterator end() const
+    constexpr auto end()
     {
-        return iterator{bound_};
+        if constexpr (forward_range<V> &&
+                      std::is_reference_v<InnerRng> && forward_range<InnerRng> &&
+                      common_range<V> && common_range<InnerRng>) {
+            return iterator<detail::simple_view<V>>{*this, ranges::end(data_.base_)};
+        } else {
+            return sentinel<detail::simple_view<V>>{*this};
+        }
     }
 
-    template <typename WW = W, typename BB = Bound, std::enable_if_t<
-              (same_as<WW, BB> && detail::advanceable<W>) ||
-              (integral<WW> && integral<BB>) ||
-                                   sized_sentinel_for<BB, WW>, int> = 0>
-    constexpr auto size() const
+    template <typename VV = V,
+              std::enable_if_t<input_range<const VV> &&
+                               std::is_reference_v<range_reference_t<const VV>>, int> = 0>
+    constexpr auto end() const
     {
-        constexpr auto make_unsigned_like = [](auto i) {
-            return std::make_unsigned_t<decltype(i)>(i);
-        };
-
-        if constexpr (integral<W> && integral<Bound>) {
-            return (value_ < 0)
-                ? ((bound_ < 0)
-                  ? make_unsigned_like(-value_) - make_unsigned_like(-bound_)
-                  : make_unsigned_like(bound_) - make_unsigned_like(-value_))
-                : make_unsigned_like(bound_) - make_unsigned_like(value_);
+        if constexpr (forward_range<const V> &&
+                      std::is_reference_v<range_reference_t<const V>> &&
+                      forward_range<range_reference_t<const V>> &&
+                      common_range<const V> &&
+                      common_range<range_reference_t<const V>>) {
+            return iterator<true>{*this, ranges::end(data_.base_)};
         } else {
-            make_unsigned_like(bound_ - value_);
+            return sentinel<true>{*this};
         }
     }
 };
 
-template <typename W, typename Bound, std::enable_if_t<
-    !integral<W> || !integral<Bound> ||
-        (signed_integral<W> == signed_integral<Bound>), int> = 0>
-iota_view(W, Bound) -> iota_view<W, Bound>;
+template <typename R>
+explicit join_view(R&&) -> join_view<all_view<R>>;
 
-template <typename W, typename Bound>
-inline constexpr bool enable_borrowed_range<iota_view<W, Bound>> = true;
+} // namespace join_view_
 
-namespace views {
+using join_view_::join_view;
 
 namespace detail {
 
-struct iota_view_fn {
-    template <typename W>
-    constexpr auto operator()(W&& value) const
-        noexcept(noexcept(iota_view{std::forward<W>(value)}))
-        -> decltype(iota_view(std::forward<W>(value)))
-    {
-        return iota_view(std::forward<W>(value));
-    }
+struct join_view_fn {
 
-    template <typename W, typename Bound>
-    constexpr auto operator()(W&& value, Bound&& bound) const
-        noexcept(noexcept(iota_view{std::forward<W>(value), std::forward<Bound>(bound)}))
-        -> decltype(iota_view(std::forward<W>(value), std::forward<Bound>(bound)))
+    template <typename E>
+    constexpr auto operator()(E&& e) const
+        -> decltype(join_view{std::forward<E>(e)})
     {
-        return iota_view{std::forward<W>(value), std::forward<Bound>(bound)};
+        return join_view{std::forward<E>(e)};
     }
-};
 
-} // namespace detail
+};
 
-NANO_INLINE_VAR(detail::iota_view_fn, iota)
+template <>
+inline constexpr bool is_raco<join_view_fn> = true;
 
 }
 
-NANO_END_NAMESPACE
-
-#endif
-
-// nanorange/views/istream.hpp
-//
-// Copyright (c) 2019 Tristan Brindle (tcbrindle at gmail dot com)
-// Distributed under the Boost Software License, Version 1.0. (See accompanying
-// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
-
-#ifndef NANORANGE_VIEWS_ISTREAM_HPP_INCLUDED
-#define NANORANGE_VIEWS_ISTREAM_HPP_INCLUDED
-
-
-
-
-
-#include <iosfwd>
-
-NANO_BEGIN_NAMESPACE
-
-namespace detail {
-
-struct StreamExtractable_req {
-    template <typename Val, typename CharT, typename Traits>
-    auto requires_(std::basic_istream<CharT, Traits>& is, Val& t)
-        -> decltype(is >> t);
-};
-
-template <typename Val, typename CharT, typename Traits>
-NANO_CONCEPT StreamExtractable =
-    requires_<StreamExtractable_req, Val, CharT, Traits>;
-
-} // namespace detail
+namespace views {
 
-template <typename Val, typename CharT, typename Traits = std::char_traits<CharT>>
-struct basic_istream_view : view_interface<basic_istream_view<Val, CharT, Traits>> {
+NANO_INLINE_VAR(nano::detail::join_view_fn, join)
 
-    static_assert(movable<Val>);
-    static_assert(default_initializable<Val>);
-    static_assert(detail::StreamExtractable<Val, CharT, Traits>);
+}
 
-    basic_istream_view() = default;
+NANO_END_NAMESPACE
 
-    constexpr explicit basic_istream_view(std::basic_istream<CharT, Traits>& stream)
-        : stream_(std::addressof(stream))
-    {}
+#endif
 
-    constexpr auto begin()
-    {
-        if (stream_) {
-            *stream_ >> object_;
-        }
-        return iterator{*this};
-    }
+// nanorange/views/mapped_file.hpp
+//
+// Copyright (c) 2019 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
-    constexpr default_sentinel_t end() const noexcept
-    {
-        return default_sentinel;
-    }
+#ifndef NANORANGE_VIEWS_MAPPED_FILE_HPP_INCLUDED
+#define NANORANGE_VIEWS_MAPPED_FILE_HPP_INCLUDED
 
-private:
-    struct iterator {
-        using iterator_category = input_iterator_tag;
-        using difference_type = std::ptrdiff_t;
-        using value_type = Val;
 
-        iterator() = default;
 
-        constexpr explicit iterator(basic_istream_view& parent) noexcept
-            : parent_(std::addressof(parent))
-        {}
+#include <cerrno>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
 
-        // Disable move-only iterator until views support them properly
-#if 0
-        iterator(const iterator&) = delete;
-        iterator(iterator&&) = default;
+#if defined(__has_include)
+#if __has_include(<sys/mman.h>) && __has_include(<sys/stat.h>) && \
+    __has_include(<fcntl.h>) && __has_include(<unistd.h>)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define NANO_HAS_MMAP 1
+#endif
+#endif
 
-        iterator& operator=(const iterator&) = delete;
-        iterator& operator=(iterator&&) = default;
+#ifndef NANO_HAS_MMAP
+#define NANO_HAS_MMAP 0
 #endif
-        iterator& operator++()
-        {
-            *parent_->stream_ >> parent_->object_;
-            return *this;
-        }
 
-        void operator++(int)
-        {
-            ++*this;
-        }
+#if NANO_HAS_MMAP
 
-        Val& operator*() const { return parent_->object_; }
+NANO_BEGIN_NAMESPACE
 
-        friend bool operator==(const iterator& x, default_sentinel_t)
-        {
-            return x.done();
-        }
+// Extension: memory-mapped files. A mapped_file owns a mapping of a whole
+// file, which is either read-only, or private and writable so that changes
+// are never written back to the file. A mapped_file_view<T> then presents the
+// mapping as a contiguous, borrowed range of T, without copying. As with
+// other borrowed ranges, the view (and its iterators) must not outlive the
+// mapped_file it refers to.
 
-        friend bool operator==(default_sentinel_t s, const iterator& x)
-        {
-            return x == s;
-        }
+enum class mapped_file_mode {
+    read_only,
+    copy_on_write
+};
 
-        friend bool operator!=(const iterator& x, default_sentinel_t s)
-        {
-            return !(x == s);
-        }
+template <typename T>
+class mapped_file_view;
 
-        friend bool operator!=(default_sentinel_t s, const iterator& x)
-        {
-            return !(x == s);
-        }
+class mapped_file {
+public:
+    mapped_file() = default;
 
-    private:
-        [[nodiscard]] bool done() const
-        {
-            return parent_ == nullptr
-                  || parent_->stream_ == nullptr
-                  || !*parent_->stream_;
+    // Throws std::system_error if the file cannot be opened or mapped
+    explicit mapped_file(const char* path,
+                         mapped_file_mode mode = mapped_file_mode::read_only)
+        : mode_(mode)
+    {
+        const int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            mapped_file::throw_error("open");
         }
 
-        basic_istream_view* parent_{};
-    };
+        struct ::stat st {};
+        if (::fstat(fd, &st) != 0) {
+            mapped_file::close_and_throw(fd, "fstat");
+        }
 
-    std::basic_istream<CharT, Traits>* stream_{};
-    Val object_ = Val();
-};
+        // mmap() rejects empty mappings, so empty files are left unmapped
+        size_ = static_cast<std::size_t>(st.st_size);
+        if (size_ > 0) {
+            const bool writable = mode == mapped_file_mode::copy_on_write;
+            void* const addr =
+                ::mmap(nullptr, size_,
+                       writable ? PROT_READ | PROT_WRITE : PROT_READ,
+                       writable ? MAP_PRIVATE : MAP_SHARED, fd, 0);
+            if (addr == MAP_FAILED) {
+                mapped_file::close_and_throw(fd, "mmap");
+            }
+            data_ = static_cast<std::byte*>(addr);
+        }
 
-template <typename Val, typename CharT, typename Traits>
-auto istream_view(std::basic_istream<CharT, Traits>& s)
-    -> basic_istream_view<Val, CharT, Traits>
-{
-    return basic_istream_view<Val, CharT, Traits>{s};
-}
+        // The mapping keeps its own reference to the file
+        ::close(fd);
+    }
 
-NANO_END_NAMESPACE
+    explicit mapped_file(const std::string& path,
+                         mapped_file_mode mode = mapped_file_mode::read_only)
+        : mapped_file(path.c_str(), mode)
+    {}
 
-#endif
+    mapped_file(mapped_file&& other) noexcept
+        : data_(std::exchange(other.data_, nullptr)),
+          size_(std::exchange(other.size_, 0)),
+          mode_(other.mode_)
+    {}
 
-// nanorange/views/join.hpp
-//
-// Copyright (c) 2019 Tristan Brindle (tcbrindle at gmail dot com)
-// Distributed under the Boost Software License, Version 1.0. (See accompanying
-// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+    mapped_file& operator=(mapped_file&& other) noexcept
+    {
+        if (this != std::addressof(other)) {
+            unmap();
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+            mode_ = other.mode_;
+        }
+        return *this;
+    }
 
-#ifndef NANORANGE_VIEWS_JOIN_HPP_INCLUDED
-#define NANORANGE_VIEWS_JOIN_HPP_INCLUDED
+    ~mapped_file() { unmap(); }
 
+    const std::byte* data() const noexcept { return data_; }
 
+    std::size_t size() const noexcept { return size_; }
 
+    mapped_file_mode mode() const noexcept { return mode_; }
 
+private:
+    template <typename T>
+    friend class mapped_file_view;
 
-NANO_BEGIN_NAMESPACE
+    [[noreturn]] static void throw_error(const char* what)
+    {
+        throw std::system_error(errno, std::generic_category(),
+                                std::string("nano::mapped_file: ") + what);
+    }
 
-namespace detail {
+    [[noreturn]] static void close_and_throw(int fd, const char* what)
+    {
+        const int err = errno;
+        ::close(fd);
+        errno = err;
+        mapped_file::throw_error(what);
+    }
 
-template <typename V, bool InnerIsReference>
-struct join_view_data {
-    V base_ = V();
-};
+    void unmap() noexcept
+    {
+        if (data_) {
+            ::munmap(data_, size_);
+        }
+    }
 
-template <typename V>
-struct join_view_data<V, false> {
-    V base_ = V();
-    all_view<range_reference_t<V>> inner_ = all_view<range_reference_t<V>>();
+    std::byte* data_ = nullptr;
+    std::size_t size_ = 0;
+    mapped_file_mode mode_ = mapped_file_mode::read_only;
 };
 
-template <typename B>
-constexpr auto join_view_iter_cat_helper()
-{
-    constexpr bool ref_is_glvalue = std::is_reference_v<range_reference_t<B>>;
+template <typename T = const std::byte>
+class mapped_file_view : public view_interface<mapped_file_view<T>> {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "mapped_file_view requires a trivially copyable type");
 
-    if constexpr (ref_is_glvalue) {
-        using OuterCat = iterator_category_t<iterator_t<B>>;
-        using InnerCat = iterator_category_t<iterator_t<range_reference_t<B>>>;
+public:
+    mapped_file_view() = default;
 
-        if constexpr (derived_from<OuterCat, bidirectional_iterator_tag> &&
-                      derived_from<InnerCat, bidirectional_iterator_tag>) {
-            return bidirectional_iterator_tag{};
-        } else if constexpr(derived_from<OuterCat, forward_iterator_tag> &&
-                            derived_from<InnerCat, forward_iterator_tag>) {
-            return forward_iterator_tag{};
-        } else {
-            return input_iterator_tag{};
+    // Views as many whole Ts as the file contains. A view of non-const T
+    // requires a copy-on-write mapping, and throws std::invalid_argument
+    // otherwise.
+    explicit mapped_file_view(mapped_file& file)
+        : data_(reinterpret_cast<T*>(file.data_)),
+          size_(static_cast<std::ptrdiff_t>(file.size_ / sizeof(T)))
+    {
+        if (!std::is_const<T>::value &&
+            file.mode() != mapped_file_mode::copy_on_write) {
+            throw std::invalid_argument(
+                "nano::mapped_file_view: a mutable view requires a "
+                "copy_on_write mapping");
         }
-    } else {
-        return input_iterator_tag{};
     }
-}
 
-}
+    template <typename U = T, std::enable_if_t<std::is_const<U>::value, int> = 0>
+    explicit mapped_file_view(const mapped_file& file)
+        : data_(reinterpret_cast<T*>(file.data_)),
+          size_(static_cast<std::ptrdiff_t>(file.size_ / sizeof(T)))
+    {}
 
-namespace join_view_ {
+    // The view would immediately dangle
+    mapped_file_view(mapped_file&&) = delete;
+
+    constexpr T* begin() const noexcept { return data_; }
+    constexpr T* end() const noexcept { return data_ + size_; }
+    constexpr T* data() const noexcept { return data_; }
+    constexpr std::ptrdiff_t size() const noexcept { return size_; }
 
-template <typename V>
-struct join_view : view_interface<join_view<V>> {
 private:
+    T* data_ = nullptr;
+    std::ptrdiff_t size_ = 0;
+};
 
-    static_assert(input_range<V>);
-    static_assert(view<V>);
-    static_assert(input_range<range_reference_t<V>>);
-    static_assert(std::is_reference_v<range_reference_t<V>> ||
-                  view<range_value_t<V>>);
+template <typename T>
+inline constexpr bool enable_borrowed_range<mapped_file_view<T>> = true;
 
-    using InnerRng = range_reference_t<V>;
+NANO_END_NAMESPACE
 
-    template<bool> struct sentinel;
+#endif // NANO_HAS_MMAP
 
-    template <bool Const>
-    struct iterator {
+#endif
 
-        friend struct sentinel<Const>;
+// nanorange/views/parse.hpp
+//
+// Copyright (c) 2019 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
-        template <typename B>
-        static constexpr bool ref_is_glvalue =
-            std::is_reference_v<range_reference_t<B>>;
+#ifndef NANORANGE_VIEWS_PARSE_HPP_INCLUDED
+#define NANORANGE_VIEWS_PARSE_HPP_INCLUDED
 
-        using Base = detail::conditional_t<Const, const V, V>;
 
-        // https://github.com/ericniebler/stl2/issues/604
-        using Parent = detail::conditional_t<Const && ref_is_glvalue<Base>,
-            const join_view, join_view>;
 
-        iterator_t<Base> outer_ = iterator_t<Base>();
-        iterator_t<range_reference_t<Base>> inner_
-            = iterator_t<range_reference_t<Base>>();
-        Parent* parent_ = nullptr;
 
-        template <typename B = Base>
-        constexpr decltype(auto) update_inner(range_reference_t<Base> x)
-        {
-            if constexpr (ref_is_glvalue<B>) {
-                return (x);
-            } else {
-                return (parent_->data_.inner_ = views::all(x));
-            }
-        }
 
-        constexpr void satisfy()
-        {
-            for (; outer_ !=  ranges::end(parent_->data_.base_); ++outer_) {
-                auto& inner = update_inner(*outer_);
-                inner_ = ranges::begin(inner);
-                if (inner_ != ranges::end(inner)) {
-                    return;
-                }
-            }
+#include <cerrno>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <istream>
+#include <streambuf>
+#include <vector>
 
-            if constexpr (ref_is_glvalue<Base>) {
-                inner_ = iterator_t<range_reference_t<Base>>();
-            }
-        }
+#if defined(__has_include)
+#if __has_include(<charconv>)
+#include <charconv>
+#define NANO_HAS_CHARCONV 1
+#endif
+#if __has_include(<unistd.h>)
+#include <unistd.h>
+#define NANO_HAS_POSIX_READ 1
+#endif
+#endif
 
-    public:
-        //using iterator_concept = ...
-        using iterator_category = decltype(detail::join_view_iter_cat_helper<Base>());
-        using value_type = range_value_t<range_reference_t<Base>>;
-        using difference_type = nano::common_type_t<
-            range_difference_t<Base>,
-            range_difference_t<range_reference_t<Base>>>;
-        // Extension: legacy typedefs
-        using pointer = iterator_t<Base>;
-        using reference = range_reference_t<range_reference_t<Base>>;
+#ifndef NANO_HAS_CHARCONV
+#define NANO_HAS_CHARCONV 0
+#endif
 
-        iterator() = default;
+#ifndef NANO_HAS_POSIX_READ
+#define NANO_HAS_POSIX_READ 0
+#endif
 
-        constexpr iterator(Parent& parent, iterator_t<Base> outer)
-            : outer_(std::move(outer)),
-              parent_(std::addressof(parent))
-        {
-            satisfy();
-        }
+// Standard libraries only define this once from_chars() supports floating
+// point types
+#if defined(__cpp_lib_to_chars)
+#define NANO_HAS_FLOAT_FROM_CHARS 1
+#else
+#define NANO_HAS_FLOAT_FROM_CHARS 0
+#endif
 
-        // constexpr iterator(iterator<!Const>);
+#if NANO_HAS_CHARCONV
 
-        constexpr decltype(auto) operator*() const { return *inner_; }
+NANO_BEGIN_NAMESPACE
 
-        template <typename B = Base>
-        constexpr auto operator->() const
-            -> std::enable_if_t<detail::has_arrow<B>, iterator_t<Base>>
-        {
-            return inner_;
-        }
+// Extension: a view of the whitespace-separated numbers in a stream buffer or
+// (on POSIX systems) a file descriptor, parsed with from_chars(). The input is
+// read in large blocks, bypassing the stream's formatted input functions and
+// locale altogether. Iteration stops at the end of the input, or at the first
+// token which is not a valid Val, after which failed() returns true.
+//
+// Like basic_istream_view, this is a single-pass view. As it reads ahead,
+// the stream's read position is unspecified once iteration has begun.
 
-    private:
-        template <typename B = Base>
-        constexpr decltype(auto) get_inner_rng()
-        {
-            if constexpr (ref_is_glvalue<B>) {
-                return (*outer_);
-            } else {
-                return (parent_->data_.inner_);
-            }
-        }
+struct from_fd_t {
+    explicit from_fd_t() = default;
+};
+
+inline constexpr from_fd_t from_fd{};
 
-    public:
-        template <typename B = Base>
-        constexpr iterator& operator++()
-        {
-            auto&& inner_rng = get_inner_rng();
+namespace detail {
 
-            if (++inner_ == ranges::end(inner_rng)) {
-                ++outer_;
-                satisfy();
-            }
+constexpr std::size_t parse_view_buffer_size = 1 << 16;
 
-            return *this;
-        }
+// Numbers up to this long can be parsed without first finding the end of the
+// token
+constexpr std::size_t parse_view_lookahead = 128;
 
-        template <typename B = Base>
-        constexpr auto operator++(int)
-            -> std::enable_if_t<!(ref_is_glvalue<B> &&
-                                  forward_range<B> &&
-                                  forward_range<range_reference_t<B>>)>
-        {
-            ++*this;
-        }
+template <typename T>
+NANO_CONCEPT parsable_number =
+    std::is_arithmetic<T>::value && !same_as<T, bool>;
 
-        template <typename B = Base>
-        constexpr auto operator++(int)
-            -> std::enable_if_t<ref_is_glvalue<B> &&
-                                forward_range<B> &&
-                                forward_range<range_reference_t<B>>,
-                                iterator>
-        {
-            auto tmp = *this;
-            ++*this;
-            return tmp;
-        }
+// The same characters as std::isspace() in the "C" locale
+constexpr bool is_parse_space(char c)
+{
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
 
-        template <typename B = Base>
-        constexpr auto operator--()
-            -> std::enable_if_t<ref_is_glvalue<B> &&
-                                bidirectional_range<B> &&
-                                bidirectional_range<range_reference_t<B>>,
-                                iterator&>
-        {
-            if (outer_ == ranges::end(parent_->data_.base_)) {
-                inner_ = ranges::end(*outer_);
-            }
+struct parse_source {
+    std::streambuf* buf = nullptr;
+    int fd = -1;
 
-            while (inner_ == ranges::begin(*outer_)) {
-                inner_ = ranges::end(*--outer_);
+    // Reads up to n bytes into out, returning the number read (zero at the
+    // end of the input) or -1 on error
+    std::ptrdiff_t read(char* out, std::size_t n) const
+    {
+        if (buf) {
+            return static_cast<std::ptrdiff_t>(
+                buf->sgetn(out, static_cast<std::streamsize>(n)));
+        }
+#if NANO_HAS_POSIX_READ
+        if (fd >= 0) {
+            while (true) {
+                const auto r = ::read(fd, out, n);
+                if (r >= 0 || errno != EINTR) {
+                    return static_cast<std::ptrdiff_t>(r);
+                }
             }
-            --inner_;
-            return *this;
         }
+#endif
+        return 0;
+    }
+};
 
-        template <typename B = Base>
-        constexpr auto operator--(int)
-            -> std::enable_if_t<ref_is_glvalue<B> &&
-                                bidirectional_range<B> &&
-                                bidirectional_range<range_reference_t<B>>,
-                                iterator>
-        {
-            auto tmp = *this;
-            --*this;
-            return *tmp;
-        }
+// Parses a T from the start of [first, last), returning a pointer to the
+// first character not consumed, or null if there is no valid T there. Like
+// operator>>, accepts a leading plus sign. Requires *last to be '\0'.
+template <typename T>
+const char* parse_number(const char* first, const char* last, T& value)
+{
+    if (*first == '+' && last - first > 1 && first[1] != '-' &&
+        first[1] != '+') {
+        ++first;
+    }
 
-        template <typename B = Base>
-        friend constexpr auto operator==(const iterator& x, const iterator& y)
-            -> std::enable_if_t<ref_is_glvalue<B> &&
-                                equality_comparable<iterator_t<B>> &&
-                                equality_comparable<iterator_t<range_reference_t<B>>>,
-                                bool>
-        {
-            return x.outer_ == y.outer_ && x.inner_ == y.inner_;
+    if constexpr (std::is_integral<T>::value || NANO_HAS_FLOAT_FROM_CHARS) {
+        const auto res = std::from_chars(first, last, value);
+        return res.ec == std::errc{} ? res.ptr : nullptr;
+    } else {
+        // Fall back to strtod() and friends, which stop at the terminator
+        char* end = nullptr;
+        errno = 0;
+        if constexpr (same_as<T, float>) {
+            value = std::strtof(first, &end);
+        } else if constexpr (same_as<T, double>) {
+            value = std::strtod(first, &end);
+        } else {
+            value = std::strtold(first, &end);
         }
+        return end != first && errno != ERANGE ? end : nullptr;
+    }
+}
 
-        template <typename B = Base>
-        friend constexpr auto operator!=(const iterator& x, const iterator& y)
-            -> std::enable_if_t<ref_is_glvalue<B> &&
-                                equality_comparable<iterator_t<B>> &&
-                                equality_comparable<iterator_t<range_reference_t<B>>>,
-                                bool>
-        {
-            return !(x == y);
-        }
+} // namespace detail
 
-        friend constexpr decltype(auto) iter_move(const iterator& i)
-            noexcept(noexcept(ranges::iter_move(i.inner_)))
-        {
-            return ranges::iter_move(i.inner_);
-        }
+template <typename Val>
+struct parse_view : view_interface<parse_view<Val>> {
 
-        friend constexpr void iter_swap(const iterator& x, const iterator& y)
-            noexcept(noexcept(ranges::iter_swap(x.inner_, y.inner_)))
-        {
-            ranges::iter_swap(x.inner_, y.inner_);
+    static_assert(detail::parsable_number<Val>,
+                  "parse_view requires an integer or floating point type");
+
+    parse_view() = default;
+
+    explicit parse_view(std::streambuf& buf,
+                        std::size_t buffer_size = detail::parse_view_buffer_size)
+        : buffer_size_(buffer_size > 0 ? buffer_size : 1)
+    {
+        source_.buf = std::addressof(buf);
+    }
+
+    explicit parse_view(std::istream& stream,
+                        std::size_t buffer_size = detail::parse_view_buffer_size)
+        : buffer_size_(buffer_size > 0 ? buffer_size : 1)
+    {
+        source_.buf = stream.rdbuf();
+    }
+
+#if NANO_HAS_POSIX_READ
+    parse_view(from_fd_t, int fd,
+               std::size_t buffer_size = detail::parse_view_buffer_size)
+        : buffer_size_(buffer_size > 0 ? buffer_size : 1)
+    {
+        source_.fd = fd;
+    }
+#endif
+
+    auto begin()
+    {
+        if (buffer_.empty()) {
+            // One spare byte, so that the contents can always be
+            // null-terminated
+            buffer_.resize(buffer_size_ + 1);
         }
-    };
+        read_next();
+        return iterator{*this};
+    }
 
-    template <bool Const>
-    struct sentinel {
-    private:
-        using Parent = detail::conditional_t<Const, const join_view, join_view>;
-        using Base = detail::conditional_t<Const, const V, V>;
+    default_sentinel_t end() const noexcept
+    {
+        return default_sentinel;
+    }
 
-        sentinel_t<Base> end_ = sentinel_t<Base>();
+    // Whether iteration stopped because of invalid input or a read error,
+    // rather than at the end of the input
+    bool failed() const noexcept
+    {
+        return failed_;
+    }
 
-    public:
-        sentinel() = default;
+private:
+    struct iterator {
+        using iterator_category = input_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = Val;
 
-        constexpr explicit sentinel(Parent& parent)
-            : end_(ranges::end(parent.data_.base_))
-        {}
+        iterator() = default;
 
-        // constexpr sentinel(sentinel<!Const> s);
+        explicit iterator(parse_view& parent) noexcept
+            : parent_(std::addressof(parent))
+        {}
 
-        friend constexpr bool operator==(const iterator<Const>& x, const sentinel& y)
+        iterator& operator++()
         {
-            return x.outer_ == y.end_;
+            parent_->read_next();
+            return *this;
         }
 
-        friend constexpr bool operator!=(const iterator<Const>& x, const sentinel& y)
+        void operator++(int)
         {
-            return !(x == y);
+            ++*this;
         }
 
-        friend constexpr bool operator==(const sentinel& x, const iterator<Const>& y)
+        Val& operator*() const { return parent_->value_; }
+
+        friend bool operator==(const iterator& x, default_sentinel_t)
         {
-            return y == x;
+            return x.done();
         }
 
-        friend constexpr bool operator!=(const sentinel& x, const iterator<Const>& y)
+        friend bool operator==(default_sentinel_t s, const iterator& x)
         {
-            return !(y == x);
+            return x == s;
         }
-    };
 
-    detail::join_view_data<V, std::is_reference_v<InnerRng>> data_{};
+        friend bool operator!=(const iterator& x, default_sentinel_t s)
+        {
+            return !(x == s);
+        }
 
-public:
+        friend bool operator!=(default_sentinel_t s, const iterator& x)
+        {
+            return !(x == s);
+        }
 
-    join_view() = default;
+    private:
+        [[nodiscard]] bool done() const
+        {
+            return parent_ == nullptr || parent_->done_;
+        }
 
-    constexpr explicit join_view(V base)
-        : data_{std::move(base)}
-    {}
+        parse_view* parent_{};
+    };
 
-    constexpr auto begin()
+    // Appends as much input as will fit to the buffer, returning false at the
+    // end of the input
+    bool read_more()
     {
-        return iterator<detail::simple_view<V>>{*this, ranges::begin(data_.base_)};
-    }
+        if (eof_) {
+            return false;
+        }
 
-    template <typename VV = V,
-              std::enable_if_t<input_range<const VV> &&
-                               std::is_reference_v<range_reference_t<const VV>>, int> = 0>
-    constexpr auto begin() const
-    {
-        return iterator<true>{*this, ranges::begin(data_.base_)};
+        const auto n = source_.read(buffer_.data() + end_,
+                                    buffer_.size() - 1 - end_);
+        if (n <= 0) {
+            eof_ = true;
+            failed_ = failed_ || n < 0;
+            return false;
+        }
+        end_ += static_cast<std::size_t>(n);
+        buffer_[end_] = '\0';
+        return true;
     }
 
-    constexpr auto end()
+    // Moves the unread part of the buffer to the front and reads some more,
+    // growing the buffer if it is already full
+    bool compact_and_read_more()
     {
-        if constexpr (forward_range<V> &&
-                      std::is_reference_v<InnerRng> && forward_range<InnerRng> &&
-                      common_range<V> && common_range<InnerRng>) {
-            return iterator<detail::simple_view<V>>{*this, ranges::end(data_.base_)};
-        } else {
-            return sentinel<detail::simple_view<V>>{*this};
+        if (pos_ == 0 && end_ == buffer_.size() - 1) {
+            buffer_.resize(2 * buffer_.size() - 1);
+        } else if (pos_ != 0) {
+            std::memmove(buffer_.data(), buffer_.data() + pos_, end_ - pos_);
+            end_ -= pos_;
+            pos_ = 0;
+            buffer_[end_] = '\0';
         }
+        return read_more();
     }
 
-    template <typename VV = V,
-              std::enable_if_t<input_range<const VV> &&
-                               std::is_reference_v<range_reference_t<const VV>>, int> = 0>
-    constexpr auto end() const
+    void read_next()
     {
-        if constexpr (forward_range<const V> &&
-                      std::is_reference_v<range_reference_t<const V>> &&
-                      forward_range<range_reference_t<const V>> &&
-                      common_range<const V> &&
-                      common_range<range_reference_t<const V>>) {
-            return iterator<true>{*this, ranges::end(data_.base_)};
-        } else {
-            return sentinel<true>{*this};
+        done_ = true;
+        if (failed_) {
+            return;
         }
-    }
-};
 
-template <typename R>
-explicit join_view(R&&) -> join_view<all_view<R>>;
+        // Skip leading whitespace
+        while (true) {
+            const char* const data = buffer_.data();
+            std::size_t pos = pos_;
+            while (pos != end_ && detail::is_parse_space(data[pos])) {
+                ++pos;
+            }
+            pos_ = pos;
+            if (pos_ != end_) {
+                break;
+            }
+            pos_ = end_ = 0;
+            if (!read_more()) {
+                return;
+            }
+        }
 
-} // namespace join_view_
+        // Make sure that the buffer holds at least as much as the longest
+        // number we expect to see
+        if (end_ - pos_ < detail::parse_view_lookahead && !eof_) {
+            compact_and_read_more();
+        }
 
-using join_view_::join_view;
+        // Parse straight out of the buffer. If the number is followed by
+        // whitespace, we're done.
+        const char* const first = buffer_.data() + pos_;
+        const char* const last = buffer_.data() + end_;
+        const char* stop = detail::parse_number(first, last, value_);
+        if (stop != nullptr && stop != last && detail::is_parse_space(*stop)) {
+            pos_ = static_cast<std::size_t>(stop - buffer_.data());
+            done_ = false;
+            return;
+        }
 
-namespace detail {
+        // Otherwise, either the token is invalid or it might continue past the
+        // end of the buffer. Read until we find its end, and try again.
+        std::size_t tok_end = pos_;
+        while (true) {
+            const char* const data = buffer_.data();
+            while (tok_end != end_ && !detail::is_parse_space(data[tok_end])) {
+                ++tok_end;
+            }
+            if (tok_end != end_ || eof_) {
+                break;
+            }
+            const std::size_t offset = tok_end - pos_;
+            compact_and_read_more();
+            tok_end = pos_ + offset;
+        }
 
-struct join_view_fn {
+        stop = detail::parse_number(buffer_.data() + pos_,
+                                    buffer_.data() + end_, value_);
+        if (stop != buffer_.data() + tok_end) {
+            failed_ = true;
+            return;
+        }
 
-    template <typename E>
-    constexpr auto operator()(E&& e) const
-        -> decltype(join_view{std::forward<E>(e)})
-    {
-        return join_view{std::forward<E>(e)};
+        pos_ = tok_end;
+        done_ = false;
     }
 
+    detail::parse_source source_{};
+    std::size_t buffer_size_ = detail::parse_view_buffer_size;
+    std::vector<char> buffer_{};
+    std::size_t pos_ = 0;
+    std::size_t end_ = 0;
+    bool eof_ = false;
+    bool done_ = true;
+    bool failed_ = false;
+    Val value_ = Val();
 };
 
-template <>
-inline constexpr bool is_raco<join_view_fn> = true;
-
-}
-
-namespace views {
-
-NANO_INLINE_VAR(nano::detail::join_view_fn, join)
-
-}
-
 NANO_END_NAMESPACE
 
+#endif // NANO_HAS_CHARCONV
+
 #endif
 
 
@@ -0,0 +1,157 @@
+// nanorange/test/algorithm/block_merge_sort.cpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <nanorange/algorithm/block_merge_sort.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "../catch.hpp"
+
+namespace {
+
+std::mt19937 gen;
+
+struct record {
+	int key;
+	int index;
+};
+
+std::vector<record> make_records(std::size_t n, unsigned keys, int pattern)
+{
+	std::vector<record> v(n);
+	for (std::size_t i = 0; i < n; ++i) {
+		int key = 0;
+		switch (pattern) {
+		case 0: key = static_cast<int>(gen() % keys); break;
+		case 1: key = static_cast<int>(i % keys); break;
+		case 2: key = static_cast<int>((n - i) % keys); break;
+		default: key = static_cast<int>(i * keys / (n + 1)) ^ (i % 7 == 0); break;
+		}
+		v[i] = record{key, static_cast<int>(i)};
+	}
+	return v;
+}
+
+template <typename Sort>
+void check_stable(std::vector<record> v, Sort sort)
+{
+	auto expected = v;
+	std::stable_sort(expected.begin(), expected.end(),
+	                 [](const record& a, const record& b) { return a.key < b.key; });
+	CHECK(sort(v) == v.end());
+	bool same = std::equal(v.begin(), v.end(), expected.begin(),
+	                       [](const record& a, const record& b) {
+		                       return a.key == b.key && a.index == b.index;
+	                       });
+	CHECK(same);
+}
+
+#if NANO_HAS_MEMORY_RESOURCE
+// Refuses any allocation larger than limit, and records the largest one
+struct limited_resource : std::pmr::memory_resource {
+	explicit limited_resource(std::size_t limit) : limit(limit) {}
+
+	std::size_t limit;
+	std::size_t largest = 0;
+
+private:
+	void* do_allocate(std::size_t bytes, std::size_t align) override
+	{
+		if (bytes > limit) {
+			throw std::bad_alloc{};
+		}
+		largest = (std::max)(largest, bytes);
+		return std::pmr::new_delete_resource()->allocate(bytes, align);
+	}
+
+	void do_deallocate(void* p, std::size_t bytes, std::size_t align) override
+	{
+		std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+	}
+
+	bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+	{
+		return this == &other;
+	}
+};
+#endif
+
+}
+
+TEST_CASE("alg.block_merge_sort")
+{
+	for (std::size_t n : {0, 1, 2, 31, 32, 33, 100, 256, 257, 1000, 4099, 50000}) {
+		for (unsigned keys : {1u, 2u, 10u, 1000u, 1000000u}) {
+			for (int pattern = 0; pattern < 4; ++pattern) {
+				check_stable(make_records(n, keys, pattern), [](auto& v) {
+					return nano::block_merge_sort(v, std::less<>{}, &record::key);
+				});
+			}
+		}
+	}
+
+	// Iterator/sentinel overload, with a comparator
+	{
+		std::vector<int> v(10000);
+		for (auto& x : v)
+			x = static_cast<int>(gen() % 100);
+		auto expected = v;
+		std::sort(expected.begin(), expected.end(), std::greater<>{});
+		CHECK(nano::block_merge_sort(v.begin(), v.end(), std::greater<>{}) == v.end());
+		CHECK(v == expected);
+	}
+
+	// Move-only types
+	{
+		std::vector<std::unique_ptr<int>> v(3000);
+		for (std::size_t i = 0; i < v.size(); ++i)
+			v[i] = std::make_unique<int>(static_cast<int>(gen() % 500));
+		nano::block_merge_sort(v, std::less<>{}, [](const auto& p) { return *p; });
+		CHECK(std::is_sorted(v.begin(), v.end(), [](const auto& a, const auto& b) {
+			return *a < *b;
+		}));
+	}
+}
+
+#if NANO_HAS_MEMORY_RESOURCE
+TEST_CASE("alg.block_merge_sort.memory_resource")
+{
+	const std::size_t n = 100000;
+	auto v = make_records(n, 5000, 0);
+
+	// Only O(sqrt(n)) extra space is used
+	{
+		limited_resource resource(std::size_t(-1));
+		check_stable(v, [&](auto& r) {
+			return nano::block_merge_sort(&resource, r, std::less<>{}, &record::key);
+		});
+		CHECK(resource.largest > 0);
+		CHECK(resource.largest <= 400 * sizeof(record));
+	}
+
+	// Without even that, the sort is still done, in place
+	{
+		limited_resource resource(0);
+		check_stable(v, [&](auto& r) {
+			return nano::block_merge_sort(&resource, r.begin(), r.end(),
+			                              std::less<>{}, &record::key);
+		});
+	}
+
+	// stable_sort() falls back to the block merge if it can't get the space
+	// it would like
+	{
+		limited_resource resource(n / 10 * sizeof(record));
+		check_stable(v, [&](auto& r) {
+			return nano::stable_sort(&resource, r, std::less<>{}, &record::key);
+		});
+		CHECK(resource.largest > 0);
+	}
+}
+#endif
@@ -0,0 +1,187 @@
+// nanorange/test/algorithm/bound_batch.cpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <nanorange/algorithm/lower_bound_batch.hpp>
+#include <nanorange/algorithm/upper_bound_batch.hpp>
+#include <nanorange/iterator/back_insert_iterator.hpp>
+
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <list>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "../catch.hpp"
+
+namespace {
+
+std::mt19937 gen;
+
+// lower_bound_batch and upper_bound_batch share their implementation, so each
+// test runs for both, checking against the corresponding std algorithm
+
+struct lower {
+    static constexpr const auto& batch = nano::lower_bound_batch;
+
+    template <typename I, typename T, typename Comp = std::less<>>
+    static I single(I first, I last, const T& value, Comp comp = Comp{})
+    {
+        return std::lower_bound(first, last, value, comp);
+    }
+};
+
+struct upper {
+    static constexpr const auto& batch = nano::upper_bound_batch;
+
+    template <typename I, typename T, typename Comp = std::less<>>
+    static I single(I first, I last, const T& value, Comp comp = Comp{})
+    {
+        return std::upper_bound(first, last, value, comp);
+    }
+};
+
+template <typename Test>
+void for_each_bound(Test test)
+{
+    test(lower{});
+    test(upper{});
+}
+
+template <typename Bound, typename Haystack, typename Queries>
+void check_batch(Bound, const Haystack& haystack, const Queries& queries)
+{
+    std::vector<typename Haystack::const_iterator> out;
+    const auto res =
+        Bound::batch(haystack, queries, nano::back_inserter(out));
+    CHECK(res.in == queries.end());
+    REQUIRE(out.size() == queries.size());
+
+    auto it = out.begin();
+    for (const auto& q : queries) {
+        CHECK(*it++ == Bound::single(haystack.begin(), haystack.end(), q));
+    }
+}
+
+std::vector<int> make_haystack(int n, int max)
+{
+    std::vector<int> vec(n);
+    std::uniform_int_distribution<int> dist(0, max);
+    std::generate(vec.begin(), vec.end(), [&] { return dist(gen); });
+    std::sort(vec.begin(), vec.end());
+    return vec;
+}
+
+std::vector<int> make_queries(int n, int max)
+{
+    std::vector<int> vec(n);
+    std::uniform_int_distribution<int> dist(-1, max + 1);
+    std::generate(vec.begin(), vec.end(), [&] { return dist(gen); });
+    return vec;
+}
+
+}
+
+TEST_CASE("alg.bound_batch")
+{
+    for_each_bound([](auto bound) {
+        for (int n : {0, 1, 2, 15, 16, 17, 100, 1000}) {
+            for (int max : {3, 1000, 100000}) {
+                const auto haystack = make_haystack(n, max);
+                const std::deque<int> deq(haystack.begin(), haystack.end());
+
+                for (int nq : {0, 1, 15, 16, 17, 50, 500}) {
+                    auto queries = make_queries(nq, max);
+                    check_batch(bound, haystack, queries);
+                    check_batch(bound, deq, queries);
+
+                    // Sorted queries take the narrowing path
+                    std::sort(queries.begin(), queries.end());
+                    check_batch(bound, haystack, queries);
+                    check_batch(bound, deq, queries);
+
+                    // ...unless they are sorted the other way
+                    std::reverse(queries.begin(), queries.end());
+                    check_batch(bound, haystack, queries);
+                }
+            }
+        }
+    });
+}
+
+TEST_CASE("alg.bound_batch.partly_sorted")
+{
+    // Sorted groups which don't follow on from each other, and unsorted
+    // groups between sorted ones
+    const auto haystack = make_haystack(1000, 500);
+    std::vector<int> queries;
+    for (int i = 0; i < 10; ++i) {
+        auto group = make_queries(16, 500);
+        if (i % 3 != 2) {
+            std::sort(group.begin(), group.end());
+        }
+        queries.insert(queries.end(), group.begin(), group.end());
+    }
+    const std::list<int> list(queries.begin(), queries.end());
+
+    for_each_bound([&](auto bound) {
+        check_batch(bound, haystack, queries);
+        check_batch(bound, haystack, list);
+    });
+}
+
+TEST_CASE("alg.bound_batch.iterators")
+{
+    const auto haystack = make_haystack(300, 100);
+    const auto queries = make_queries(40, 100);
+
+    for_each_bound([&](auto bound) {
+        using Bound = decltype(bound);
+        const int* const first = haystack.data();
+        const int* const last = first + haystack.size();
+
+        std::vector<const int*> out(queries.size());
+        const auto res = Bound::batch(first, last, queries.begin(),
+                                      queries.end(), out.begin());
+        CHECK(res.in == queries.end());
+        CHECK(res.out == out.end());
+
+        for (std::size_t i = 0; i < queries.size(); ++i) {
+            CHECK(out[i] == Bound::single(first, last, queries[i]));
+        }
+    });
+}
+
+TEST_CASE("alg.bound_batch.comparator_and_projection")
+{
+    std::vector<std::pair<int, int>> haystack;
+    std::vector<int> keys;
+    for (int i = 0; i < 200; ++i) {
+        haystack.emplace_back(i / 4, i);
+        keys.push_back(i / 4);
+    }
+    std::reverse(haystack.begin(), haystack.end());
+    std::reverse(keys.begin(), keys.end());
+
+    auto queries = make_queries(64, 50);
+    std::sort(queries.begin(), queries.end(), std::greater<>{});
+
+    for_each_bound([&](auto bound) {
+        using Bound = decltype(bound);
+        std::vector<decltype(haystack)::iterator> out;
+        Bound::batch(haystack, queries, nano::back_inserter(out),
+                     nano::greater{}, &std::pair<int, int>::first);
+        REQUIRE(out.size() == queries.size());
+
+        for (std::size_t i = 0; i < queries.size(); ++i) {
+            const auto pos = Bound::single(keys.begin(), keys.end(),
+                                           queries[i], std::greater<>{}) -
+                             keys.begin();
+            CHECK(out[i] == haystack.begin() + pos);
+        }
+    });
+}
@@ -0,0 +1,124 @@
+// nanorange/test/algorithm/boyer_moore_horspool_searcher.cpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <nanorange/algorithm/boyer_moore_horspool_searcher.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../catch.hpp"
+
+namespace {
+
+std::mt19937 gen;
+
+std::string make_random(std::size_t n, char alphabet)
+{
+	std::uniform_int_distribution<int> dist('a', 'a' + alphabet - 1);
+	std::string s(n, ' ');
+	for (auto& c : s) {
+		c = static_cast<char>(dist(gen));
+	}
+	return s;
+}
+
+struct record {
+	int key;
+	int value;
+};
+
+}
+
+TEST_CASE("alg.search.boyer_moore_horspool")
+{
+	// Reuse each searcher across many haystacks
+	for (char alphabet : {1, 2, 4, 26}) {
+		for (std::size_t m : {0, 1, 2, 5, 17, 40}) {
+			const std::string needle = make_random(m, alphabet);
+			const nano::boyer_moore_horspool_searcher searcher{needle};
+			for (int k = 0; k < 20; ++k) {
+				const std::string hay = make_random(200, alphabet);
+				const auto expected =
+				    std::search(hay.begin(), hay.end(), needle.begin(), needle.end());
+				const auto res = nano::search(hay, searcher);
+				CHECK(res.begin() == expected);
+				CHECK(res.end() == (expected == hay.end() ? hay.end()
+				                                          : expected + m));
+			}
+		}
+	}
+
+	// Haystacks shorter than the needle
+	{
+		const std::string needle = "needle";
+		const auto searcher = nano::boyer_moore_horspool_searcher(needle.begin(),
+		                                                          needle.end());
+		const std::string hay = "need";
+		const auto res = nano::search(hay.begin(), hay.end(), searcher);
+		CHECK(res.begin() == hay.end());
+		CHECK(res.empty());
+	}
+}
+
+TEST_CASE("alg.search.boyer_moore_horspool.value_types")
+{
+	// Bytes use the flat table, including values with the top bit set
+	{
+		const std::vector<std::byte> needle{std::byte{0xff}, std::byte{0x80},
+		                                    std::byte{0x00}};
+		const nano::boyer_moore_horspool_searcher searcher{needle};
+		std::vector<std::byte> hay(100, std::byte{0x80});
+		hay[60] = std::byte{0xff};
+		hay[62] = std::byte{0x00};
+		CHECK(nano::search(hay, searcher).begin() == hay.begin() + 60);
+	}
+
+	// Wider values use a hash map
+	{
+		const std::vector<int> needle{-1, 1000000, 3, -1};
+		const nano::boyer_moore_horspool_searcher searcher{needle};
+		std::vector<int> hay{5, -1, 1000000, 3, 3, -1, 1000000, 3, -1, 7};
+		const auto res = nano::search(hay, searcher);
+		CHECK(res.begin() == hay.begin() + 5);
+		CHECK(res.end() == hay.begin() + 9);
+
+		hay[8] = 0;
+		CHECK(nano::search(hay, searcher).begin() == hay.end());
+	}
+}
+
+TEST_CASE("alg.search.boyer_moore_horspool.projections")
+{
+	const std::vector<record> hay{{1, 0}, {2, 1}, {3, 2}, {2, 3}, {3, 4}, {4, 5}};
+
+	// Projection of the haystack
+	{
+		const std::vector<int> needle{2, 3, 4};
+		const nano::boyer_moore_horspool_searcher searcher{needle};
+		const auto res = nano::search(hay, searcher, &record::key);
+		CHECK(res.begin() == hay.begin() + 3);
+		CHECK(res.end() == hay.end());
+	}
+
+	// Projection of the needle as well
+	{
+		const std::vector<std::string> needle{"aa", "aaa"};
+		const nano::boyer_moore_horspool_searcher searcher{
+		    needle, [](const std::string& s) { return static_cast<int>(s.size()); }};
+		CHECK(nano::search(hay, searcher, &record::key).begin() == hay.begin() + 1);
+	}
+
+	// Searching an rvalue range gives dangling
+	{
+		const std::vector<int> needle{2, 3};
+		const nano::boyer_moore_horspool_searcher searcher{needle};
+		static_assert(nano::same_as<
+			decltype(nano::search(std::vector<int>{}, searcher)), nano::dangling>);
+	}
+}
@@ -12,6 +12,7 @@
 #include <cstring>
 #include <utility>
 #include <algorithm>
+#include <vector>
 #include <nanorange/algorithm/copy.hpp>
 
 #include "../catch.hpp"
@@ -68,3 +69,92 @@ TEST_CASE("alg.copy")
     }
 #endif
 }
+
+namespace {
+
+constexpr int constexpr_copy()
+{
+    int a[] = {1, 2, 3, 4};
+    int b[4] = {};
+    ranges::copy(a, b);
+    ranges::copy_n(a, 2, b + 2);
+    return b[0] + b[1] + b[2] + b[3];
+}
+
+static_assert(constexpr_copy() == 1 + 2 + 1 + 2, "");
+
+}
+
+TEST_CASE("alg.copy.trivial")
+{
+    std::vector<int> src(1000);
+    for (int i = 0; i < 1000; i++) {
+        src[i] = i;
+    }
+
+    SECTION("pointers")
+    {
+        std::vector<int> dst(1000);
+        auto res = ranges::copy(src.data(), src.data() + src.size(), dst.data());
+        REQUIRE(res.in == src.data() + src.size());
+        REQUIRE(res.out == dst.data() + dst.size());
+        REQUIRE(src == dst);
+    }
+
+    SECTION("contiguous range")
+    {
+        std::vector<int> dst(1000);
+        auto res = ranges::copy(src, dst.data());
+        REQUIRE(res.in == src.end());
+        REQUIRE(res.out == dst.data() + dst.size());
+        REQUIRE(src == dst);
+    }
+
+    SECTION("standard library iterators")
+    {
+#if defined(__GLIBCXX__) || defined(_LIBCPP_VERSION)
+        static_assert(nano::detail::is_memmove_copyable<
+                      std::vector<int>::const_iterator,
+                      std::vector<int>::iterator>);
+#endif
+        std::vector<int> dst(1000);
+        auto res = ranges::copy(src, dst.begin());
+        REQUIRE(res.in == src.end());
+        REQUIRE(res.out == dst.end());
+        REQUIRE(src == dst);
+
+        std::vector<int> dst2(1000);
+        auto res2 = ranges::copy_backward(src.cbegin(), src.cend(), dst2.end());
+        REQUIRE(res2.in == src.cend());
+        REQUIRE(res2.out == dst2.begin());
+        REQUIRE(src == dst2);
+    }
+
+    SECTION("copy_n")
+    {
+        std::vector<int> dst(1000);
+        auto res = ranges::copy_n(src.data(), 500, dst.data());
+        REQUIRE(res.in == src.data() + 500);
+        REQUIRE(res.out == dst.data() + 500);
+        REQUIRE(std::equal(src.begin(), src.begin() + 500, dst.begin()));
+        REQUIRE(dst[500] == 0);
+    }
+
+    SECTION("overlapping")
+    {
+        auto res = ranges::copy(src.data() + 1, src.data() + src.size(),
+                                src.data());
+        REQUIRE(res.out == src.data() + 999);
+        for (int i = 0; i < 999; i++) {
+            REQUIRE(src[i] == i + 1);
+        }
+    }
+
+    SECTION("empty")
+    {
+        int* p = nullptr;
+        auto res = ranges::copy(p, p, p);
+        REQUIRE(res.in == nullptr);
+        REQUIRE(res.out == nullptr);
+    }
+}
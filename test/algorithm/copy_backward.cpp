@@ -91,3 +91,32 @@ TEST_CASE("alg.copy_backward")
 	//test_repeat_view();
 	test_initializer_list();
 }
+
+namespace {
+
+constexpr int constexpr_copy_backward()
+{
+	int a[] = {1, 2, 3, 4};
+	ranges::copy_backward(a, a + 3, a + 4);
+	return a[0] * 1000 + a[1] * 100 + a[2] * 10 + a[3];
+}
+
+static_assert(constexpr_copy_backward() == 1123, "");
+
+}
+
+TEST_CASE("alg.copy_backward.trivial")
+{
+	int a[100];
+	for (int i = 0; i < 100; i++) {
+		a[i] = i;
+	}
+
+	// Overlapping, with the destination after the source
+	auto res = ranges::copy_backward(a, a + 90, a + 100);
+	CHECK(res.in == a + 90);
+	CHECK(res.out == a + 10);
+	for (int i = 0; i < 90; i++) {
+		CHECK(a[i + 10] == i);
+	}
+}
@@ -10,6 +10,8 @@
 // Project home: https://github.com/ericniebler/range-v3
 
 #include <nanorange/algorithm/count.hpp>
+#include <cstdint>
+#include <vector>
 #include "../catch.hpp"
 #include "../test_iterators.hpp"
 #include "../test_utils.hpp"
@@ -69,3 +71,42 @@ TEST_CASE("alg.count")
 		CHECK(count(std::move(l), 7) == 0);
 	}
 }
+
+namespace {
+
+constexpr int constexpr_count()
+{
+	const int a[] = {0, 1, 2, 1};
+	return static_cast<int>(nano::count(a, 1));
+}
+
+static_assert(constexpr_count() == 2, "");
+
+template <typename T>
+void test_count_integral()
+{
+	std::vector<T> v(10000);
+	for (int i = 0; i < 10000; i++) {
+		v[i] = T(i % 3);
+	}
+
+	CHECK(nano::count(v, T(0)) == 3334);
+	CHECK(nano::count(v, T(1)) == 3333);
+	CHECK(nano::count(v.data(), v.data() + 99, T(2)) == 33);
+	CHECK(nano::count(v, T(3)) == 0);
+}
+
+}
+
+TEST_CASE("alg.count.integral")
+{
+	test_count_integral<char>();
+	test_count_integral<unsigned char>();
+	test_count_integral<short>();
+	test_count_integral<int>();
+	test_count_integral<std::int64_t>();
+
+	std::vector<unsigned char> u(50, 255);
+	CHECK(nano::count(u, -1) == 0);
+	CHECK(nano::count(u, 255) == 50);
+}
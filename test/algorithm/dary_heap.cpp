@@ -0,0 +1,178 @@
+// nanorange/test/algorithm/dary_heap.cpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <nanorange/algorithm/dary_heap.hpp>
+#include <nanorange/views/subrange.hpp>
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../catch.hpp"
+
+namespace {
+
+std::mt19937 gen;
+
+// Checks the heap property directly, independently of is_dary_heap_until
+template <std::ptrdiff_t D, typename T, typename Comp = std::less<>>
+bool check_dary_heap(const std::vector<T>& v, Comp comp = Comp{})
+{
+    for (std::size_t c = 1; c < v.size(); ++c) {
+        if (comp(v[(c - 1) / D], v[c])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<int> make_input(int n, int max)
+{
+    std::vector<int> v(n);
+    std::uniform_int_distribution<int> dist(0, max);
+    std::generate(v.begin(), v.end(), [&] { return dist(gen); });
+    return v;
+}
+
+template <std::ptrdiff_t D>
+void test_heap_ops()
+{
+    constexpr int d = static_cast<int>(D);
+    for (int n : {0, 1, 2, 3, d, d + 1, 2 * d + 3, 100, 1000}) {
+        for (int max : {3, 1000000}) {
+            const auto input = make_input(n, max);
+
+            // make, then pop everything
+            auto v = input;
+            CHECK(nano::make_dary_heap<D>(v) == v.end());
+            REQUIRE(check_dary_heap<D>(v));
+            CHECK(nano::is_dary_heap<D>(v));
+            CHECK(nano::is_dary_heap_until<D>(v) == v.end());
+
+            for (auto i = v.size(); i > 0; --i) {
+                const auto top = v.front();
+                CHECK(nano::pop_dary_heap<D>(v.begin(), v.begin() + i) ==
+                      v.begin() + i);
+                CHECK(v[i - 1] == top);
+                CHECK(std::all_of(v.begin(), v.begin() + (i - 1),
+                                  [&](int x) { return x <= top; }));
+                std::vector<int> rest(v.begin(), v.begin() + (i - 1));
+                REQUIRE(check_dary_heap<D>(rest));
+            }
+            CHECK(std::is_sorted(v.begin(), v.end()));
+
+            // push one at a time
+            v = input;
+            for (std::size_t i = 1; i <= v.size(); ++i) {
+                CHECK(nano::push_dary_heap<D>(nano::subrange(v.begin(),
+                                                             v.begin() + i)) ==
+                      v.begin() + i);
+                std::vector<int> heap(v.begin(), v.begin() + i);
+                REQUIRE(check_dary_heap<D>(heap));
+            }
+
+            // sort
+            CHECK(nano::sort_dary_heap<D>(v.begin(), v.end()) == v.end());
+            auto sorted = input;
+            std::sort(sorted.begin(), sorted.end());
+            CHECK(v == sorted);
+        }
+    }
+}
+
+}
+
+TEST_CASE("alg.dary_heap")
+{
+    test_heap_ops<2>();
+    test_heap_ops<3>();
+    test_heap_ops<4>();
+    test_heap_ops<8>();
+}
+
+TEST_CASE("alg.dary_heap.binary")
+{
+    // A 2-ary heap is a binary heap
+    auto v = make_input(1000, 1000);
+    nano::make_dary_heap<2>(v);
+    CHECK(std::is_heap(v.begin(), v.end()));
+}
+
+TEST_CASE("alg.dary_heap.is_dary_heap_until")
+{
+    std::vector<int> v{9, 5, 6, 7, 8, 1, 2, 3, 4, 10, 0};
+    CHECK(nano::is_dary_heap_until<4>(v) == v.begin() + 9);
+    CHECK(!nano::is_dary_heap<4>(v));
+    CHECK(nano::is_dary_heap_until<2>(v) == v.begin() + 3);
+
+    // a sorted-descending range is a heap of any arity
+    std::sort(v.begin(), v.end(), std::greater<>{});
+    CHECK(nano::is_dary_heap<3>(v));
+    CHECK(nano::is_dary_heap<8>(v.begin(), v.end()));
+}
+
+TEST_CASE("alg.dary_heap.comparator_projection")
+{
+    struct S {
+        int i;
+        std::string s;
+    };
+
+    std::vector<S> v;
+    for (int i : make_input(200, 50)) {
+        v.push_back({i, std::to_string(i)});
+    }
+
+    nano::make_dary_heap<4>(v, std::greater<>{}, &S::i);
+    CHECK(nano::is_dary_heap<4>(v, std::greater<>{}, &S::i));
+    nano::sort_dary_heap<4>(v, std::greater<>{}, &S::i);
+    CHECK(std::is_sorted(v.begin(), v.end(), [](const S& a, const S& b) {
+        return a.i > b.i;
+    }));
+    for (const auto& e : v) {
+        CHECK(e.s == std::to_string(e.i));
+    }
+}
+
+TEST_CASE("alg.dary_heap.move_only")
+{
+    std::vector<std::unique_ptr<int>> v;
+    for (int i : make_input(100, 1000)) {
+        v.push_back(std::make_unique<int>(i));
+    }
+
+    const auto deref = [](const std::unique_ptr<int>& p) { return *p; };
+    nano::make_dary_heap<4>(v, nano::less{}, deref);
+    nano::sort_dary_heap<4>(v, nano::less{}, deref);
+    CHECK(std::is_sorted(v.begin(), v.end(),
+                         [](const auto& a, const auto& b) { return *a < *b; }));
+}
+
+namespace {
+
+constexpr bool test_constexpr()
+{
+    std::array<int, 10> a{3, 1, 4, 1, 5, 9, 2, 6, 5, 3};
+    nano::make_dary_heap<4>(a);
+    if (!nano::is_dary_heap<4>(a)) {
+        return false;
+    }
+    nano::sort_dary_heap<4>(a);
+    for (std::size_t i = 1; i < a.size(); ++i) {
+        if (a[i] < a[i - 1]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static_assert(test_constexpr(), "");
+
+}
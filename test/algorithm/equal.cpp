@@ -19,6 +19,7 @@
 //===----------------------------------------------------------------------===//
 
 #include <nanorange/algorithm/equal.hpp>
+#include <vector>
 #include "../catch.hpp"
 #include "../test_iterators.hpp"
 #include "../test_utils.hpp"
@@ -300,3 +301,30 @@ TEST_CASE("alg.equal")
 		CHECK(ranges::equal(ranges::begin(a), ranges::end(a), ranges::begin(b)));
 	}
 }
+
+namespace {
+
+constexpr bool constexpr_equal()
+{
+	const int a[] = {0, 1, 2, 3};
+	const int b[] = {0, 1, 2, 3};
+	return ranges::equal(a, b);
+}
+
+static_assert(constexpr_equal(), "");
+
+}
+
+TEST_CASE("alg.equal.integral")
+{
+	std::vector<long> v1(100, 1);
+	std::vector<long> v2(100, 1);
+
+	CHECK(ranges::equal(v1, v2));
+	CHECK(ranges::equal(v1.data(), v1.data() + 100, v2.data(), v2.data() + 100));
+	CHECK(!ranges::equal(v1.data(), v1.data() + 100, v2.data(), v2.data() + 99));
+	v2[99] = 2;
+	CHECK(!ranges::equal(v1, v2));
+	CHECK(ranges::equal(v1.data(), v1.data() + 99, v2.data(), v2.data() + 99));
+	CHECK(ranges::equal(std::vector<long>{}, std::vector<long>{}));
+}
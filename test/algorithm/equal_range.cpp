@@ -20,6 +20,8 @@
 //===----------------------------------------------------------------------===//
 
 #include <nanorange/algorithm/equal_range.hpp>
+#include <algorithm>
+#include <deque>
 #include <vector>
 #include <iterator>
 #include "../catch.hpp"
@@ -113,3 +115,27 @@ TEST_CASE("alg.equal_range")
 		test(some_foos, some_foos + 3, 2, &foo::i);
 	}
 }
+
+TEST_CASE("alg.equal_range.random_access")
+{
+	// With random access, the end of the equal elements is found with an
+	// exponential search from the lower bound; try runs of all lengths
+	for (int run = 1; run < 40; run += 3) {
+		std::vector<int> vec;
+		for (int i = 0; i < 200; ++i) {
+			vec.push_back(i / run);
+		}
+		const std::deque<int> deq(vec.begin(), vec.end());
+
+		for (int x = -1; x <= vec.back() + 1; ++x) {
+			const auto expected = std::equal_range(vec.begin(), vec.end(), x);
+			const auto res = ranges::equal_range(vec, x);
+			CHECK(res.begin() == expected.first);
+			CHECK(res.end() == expected.second);
+
+			const auto res2 = ranges::equal_range(deq, x);
+			CHECK(res2.begin() - deq.begin() == expected.first - vec.begin());
+			CHECK(res2.end() - deq.begin() == expected.second - vec.begin());
+		}
+	}
+}
@@ -0,0 +1,98 @@
+// nanorange/test/algorithm/equal_range_batch.cpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <nanorange/algorithm/equal_range_batch.hpp>
+#include <nanorange/iterator/back_insert_iterator.hpp>
+
+#include <algorithm>
+#include <deque>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "../catch.hpp"
+
+namespace {
+
+std::mt19937 gen;
+
+template <typename Haystack, typename Queries>
+void check_batch(const Haystack& haystack, const Queries& queries)
+{
+    std::vector<nano::subrange<typename Haystack::const_iterator>> out;
+    const auto res =
+        nano::equal_range_batch(haystack, queries, nano::back_inserter(out));
+    CHECK(res.in == queries.end());
+    REQUIRE(out.size() == queries.size());
+
+    auto it = out.begin();
+    for (const auto& q : queries) {
+        const auto expected =
+            std::equal_range(haystack.begin(), haystack.end(), q);
+        CHECK(it->begin() == expected.first);
+        CHECK(it->end() == expected.second);
+        ++it;
+    }
+}
+
+}
+
+TEST_CASE("alg.equal_range_batch")
+{
+    for (int n : {0, 1, 17, 100, 1000}) {
+        // Long runs of equal elements, and no repeats at all
+        for (int max : {3, 50, 100000}) {
+            std::vector<int> haystack(n);
+            std::uniform_int_distribution<int> dist(0, max);
+            std::generate(haystack.begin(), haystack.end(),
+                          [&] { return dist(gen); });
+            std::sort(haystack.begin(), haystack.end());
+            const std::deque<int> deq(haystack.begin(), haystack.end());
+
+            for (int nq : {0, 1, 16, 50, 500}) {
+                std::vector<int> queries(nq);
+                std::uniform_int_distribution<int> qdist(-1, max + 1);
+                std::generate(queries.begin(), queries.end(),
+                              [&] { return qdist(gen); });
+                check_batch(haystack, queries);
+                check_batch(deq, queries);
+
+                std::sort(queries.begin(), queries.end());
+                check_batch(haystack, queries);
+                check_batch(deq, queries);
+            }
+        }
+    }
+}
+
+TEST_CASE("alg.equal_range_batch.projection")
+{
+    std::vector<std::pair<int, int>> haystack;
+    for (int i = 0; i < 300; ++i) {
+        haystack.emplace_back(i / 7, i);
+    }
+    const std::vector<int> queries{5, 0, -1, 42, 42, 43, 10, 11, 12};
+
+    std::vector<nano::subrange<std::pair<int, int>*>> out(
+        queries.size());
+    const auto res = nano::equal_range_batch(
+        haystack.data(), haystack.data() + haystack.size(), queries.begin(),
+        queries.end(), out.begin(), nano::less{}, &std::pair<int, int>::first);
+    CHECK(res.in == queries.end());
+    CHECK(res.out == out.end());
+
+    for (std::size_t i = 0; i < queries.size(); ++i) {
+        const auto q = queries[i];
+        const auto size = q >= 0 && q < 42 ? 7 : q == 42 ? 6 : 0;
+        CHECK(out[i].size() == size);
+        for (const auto& p : out[i]) {
+            CHECK(p.first == q);
+        }
+        if (q >= 0 && q <= 42) {
+            CHECK(out[i].begin() == haystack.data() + q * 7);
+        }
+    }
+}
@@ -19,6 +19,8 @@
 //===----------------------------------------------------------------------===//
 
 #include <nanorange/algorithm/find.hpp>
+#include <cstdint>
+#include <vector>
 #include "../catch.hpp"
 #include "../test_iterators.hpp"
 
@@ -60,3 +62,51 @@ TEST_CASE("alg.find")
 	ps = find(sa, 10, &S::i_);
 	CHECK(ps == nano::end(sa));
 }
+
+namespace {
+
+constexpr int constexpr_find()
+{
+	const int a[] = {0, 1, 2, 3};
+	return *nano::find(a, 2);
+}
+
+static_assert(constexpr_find() == 2, "");
+
+template <typename T>
+void test_find_integral()
+{
+	// Long enough to exercise both the vectorised loop and the tail
+	std::vector<T> v(100, T(1));
+
+	for (int i = 0; i < 100; i++) {
+		v[i] = T(2);
+		CHECK(nano::find(v, T(2)) - v.begin() == i);
+		CHECK(nano::find(v.data(), v.data() + 100, T(2)) == v.data() + i);
+		v[i] = T(1);
+	}
+
+	CHECK(nano::find(v, T(3)) == v.end());
+	CHECK(nano::find(v.data(), v.data(), T(1)) == v.data());
+}
+
+}
+
+TEST_CASE("alg.find.integral")
+{
+	test_find_integral<char>();
+	test_find_integral<unsigned char>();
+	test_find_integral<short>();
+	test_find_integral<int>();
+	test_find_integral<unsigned>();
+	test_find_integral<std::int64_t>();
+
+	// The value is compared after the usual arithmetic conversions
+	std::vector<unsigned char> u(50, 255);
+	CHECK(nano::find(u, -1) == u.end());
+	CHECK(nano::find(u, 255) == u.begin());
+	std::vector<int> i(50, 0);
+	i[40] = -1;
+	CHECK(nano::find(i, 0xFFFFFFFFu) - i.begin() == 40);
+	CHECK(nano::find(i, std::int64_t{0xFFFFFFFF}) == i.end());
+}
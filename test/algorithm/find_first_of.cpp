@@ -19,6 +19,11 @@
 //===----------------------------------------------------------------------===//
 
 #include <nanorange/algorithm/find_first_of.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <string>
+#include <vector>
 namespace rng = nano::ranges;
 
 #include "../catch.hpp"
@@ -240,3 +245,60 @@ TEST_CASE("alg.find_first_of")
 	::test_rng_pred();
 	::test_rng_pred_proj();
 }
+
+TEST_CASE("alg.find_first_of.bytes")
+{
+	std::mt19937 gen;
+	std::uniform_int_distribution<int> byte(0, 255);
+
+	// Sets of many sizes, including ones with more than eight distinct high
+	// nibbles, and haystacks which contain every byte value
+	for (std::size_t k : {0, 1, 3, 4, 5, 8, 9, 16, 40}) {
+		for (int trial = 0; trial < 20; ++trial) {
+			std::string needles;
+			for (std::size_t i = 0; i < k; ++i) {
+				needles.push_back(static_cast<char>(byte(gen)));
+			}
+			std::string hay;
+			for (int i = 0; i < 300; ++i) {
+				char c = static_cast<char>(byte(gen));
+				if (needles.find(c) == std::string::npos) {
+					hay.push_back(c);
+				}
+			}
+			const auto pos = gen() % (hay.size() + 1);
+			if (k > 0 && pos < hay.size()) {
+				hay[pos] = needles[gen() % k];
+			}
+
+			const auto expected = std::find_first_of(hay.begin(), hay.end(),
+			                                         needles.begin(), needles.end());
+			CHECK(rng::find_first_of(hay, needles) == expected);
+			CHECK(rng::find_first_of(hay.data(), hay.data() + hay.size(),
+			                          needles.begin(), needles.end()) ==
+			      hay.data() + (expected - hay.begin()));
+		}
+	}
+
+	{
+		const std::string hay = "a,b;c\td";
+		CHECK(rng::find_first_of(hay, std::string(";\t")) == hay.begin() + 3);
+		CHECK(rng::find_first_of(hay, std::string("xyz")) == hay.end());
+	}
+
+	// Needle values are converted to the element type, if they can be
+	{
+		const std::vector<unsigned char> hay{1, 2, 255, 3, 44};
+		CHECK(rng::find_first_of(hay, std::vector<int>{-1, 300, 44}) == hay.end() - 1);
+		CHECK(rng::find_first_of(hay, std::vector<int>{255}) == hay.begin() + 2);
+
+		const std::vector<signed char> shay{1, -2, 3, -128};
+		CHECK(rng::find_first_of(shay, std::vector<int>{128, -128}) == shay.end() - 1);
+	}
+
+	{
+		const std::vector<std::byte> hay{std::byte{1}, std::byte{0x80}, std::byte{7}};
+		const std::byte needles[] = {std::byte{7}, std::byte{0x80}};
+		CHECK(rng::find_first_of(hay, needles) == hay.begin() + 1);
+	}
+}
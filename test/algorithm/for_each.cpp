@@ -11,6 +11,8 @@
 
 #include <nanorange/algorithm/for_each.hpp>
 #include <nanorange/views/subrange.hpp>
+#include <forward_list>
+#include <numeric>
 #include <vector>
 #include "../catch.hpp"
 #include "../test_utils.hpp"
@@ -75,3 +77,29 @@ TEST_CASE("alg.for_each")
 	stl2::for_each(matrix, [](int(&)[4]){});
 #endif
 }
+
+TEST_CASE("alg.for_each.parallel")
+{
+	std::vector<int> v(200'000);
+	std::iota(v.begin(), v.end(), 0);
+	auto inc = [](int& i) { ++i; };
+
+	CHECK(stl2::for_each(stl2::execution::par, v, inc) == v.end());
+	CHECK(stl2::for_each(stl2::execution::par_unseq, v.begin(), v.end(), inc) == v.end());
+	CHECK(stl2::for_each(stl2::execution::seq, v, inc) == v.end());
+	for (int i = 0; i < static_cast<int>(v.size()); ++i)
+		REQUIRE(v[static_cast<std::size_t>(i)] == i + 3);
+
+	std::vector<S> v2(100'000);
+	int sum = 0;
+	for (auto& s : v2)
+		s = S{&sum, 1};
+	// Each element refers to the same counter, so this must be sequential
+	CHECK(stl2::for_each(stl2::execution::seq, v2, &S::p) == v2.end());
+	CHECK(sum == 100'000);
+
+	// Not random-access, so processed sequentially
+	std::forward_list<int> l{1, 2, 3};
+	CHECK(stl2::for_each(stl2::execution::par, l, inc) == l.end());
+	CHECK(l == std::forward_list<int>{2, 3, 4});
+}
@@ -19,10 +19,15 @@
 //===----------------------------------------------------------------------===//
 
 #include <nanorange/algorithm/includes.hpp>
+#include <algorithm>
 #include <functional>
+#include <iterator>
+#include <random>
+#include <vector>
 #include "../catch.hpp"
 #include "../test_utils.hpp"
 #include "../test_iterators.hpp"
+#include "skewed.hpp"
 
 namespace stl2 = nano;
 
@@ -164,3 +169,36 @@ TEST_CASE("alg.includes")
 		CHECK(stl2::includes(ia, id, std::less<int>(), &S::i, &T::j));
 	}
 }
+
+TEST_CASE("alg.includes.skewed")
+{
+	// The smaller range is a sample of the larger one, so the larger one
+	// includes it but not the other way round
+	test_skewed(
+		[](const auto& r1, const auto& r2, auto comp) {
+			return stl2::includes(r1, r2, comp);
+		},
+		[](const auto& r1, const auto& r2, auto comp) {
+			return std::includes(r1.begin(), r1.end(), r2.begin(), r2.end(),
+			                     comp);
+		},
+		[](std::size_t n1, std::size_t n2) { return 2 * (n1 + n2) - 1; });
+
+	// Neither is a sample with an extra element, or an extra duplicate
+	std::mt19937 gen;
+	std::uniform_int_distribution<int> dist(0, 5000);
+	std::vector<int> big(10000);
+	for (auto& x : big) { x = dist(gen); }
+	std::sort(big.begin(), big.end());
+
+	for (std::size_t small : {0, 1, 10, 100}) {
+		std::vector<int> sub;
+		std::sample(big.begin(), big.end(), std::back_inserter(sub), small, gen);
+		for (int extra : {-1, 2500, big.back(), 5001}) {
+			auto sub2 = sub;
+			sub2.insert(std::upper_bound(sub2.begin(), sub2.end(), extra), extra);
+			CHECK(stl2::includes(big, sub2) ==
+			      std::includes(big.begin(), big.end(), sub2.begin(), sub2.end()));
+		}
+	}
+}
@@ -19,9 +19,12 @@
 //===----------------------------------------------------------------------===//
 
 #include <nanorange/algorithm/inplace_merge.hpp>
+#include <nanorange/memory/scratch_arena.hpp>
 #include <cassert>
 #include <algorithm>
 #include <random>
+#include <string>
+#include <vector>
 #include "../catch.hpp"
 #include "../test_utils.hpp"
 #include "../test_iterators.hpp"
@@ -138,3 +141,39 @@ TEST_CASE("alg.inplace_merge")
 	test<random_access_iterator<int*> >();
 	test<int*>();
 }
+
+TEST_CASE("alg.inplace_merge.non_trivial")
+{
+	// Elements which are already in their final position must not be moved
+	// onto themselves
+	std::vector<std::string> v{"a", "c", "e", "b", "d", "f", "g", "h"};
+	stl2::inplace_merge(v, v.begin() + 3);
+	CHECK(v == std::vector<std::string>{"a", "b", "c", "d", "e", "f", "g", "h"});
+
+	v = {"e", "f", "g", "h", "a", "b", "c"};
+	stl2::inplace_merge(v, v.begin() + 4);
+	CHECK(v == std::vector<std::string>{"a", "b", "c", "e", "f", "g", "h"});
+
+	v = {"a", "b", "c", "d", "e", "f"};
+	stl2::inplace_merge(v, v.begin() + 2);
+	CHECK(v == std::vector<std::string>{"a", "b", "c", "d", "e", "f"});
+	stl2::inplace_merge(v, v.begin() + 4);
+	CHECK(v == std::vector<std::string>{"a", "b", "c", "d", "e", "f"});
+}
+
+#if NANO_HAS_MEMORY_RESOURCE
+TEST_CASE("alg.inplace_merge.memory_resource")
+{
+	nano::scratch_arena arena;
+
+	std::vector<std::string> v{"a", "c", "e", "b", "d", "f", "g", "h"};
+	CHECK(stl2::inplace_merge(&arena, v, v.begin() + 3) == v.end());
+	CHECK(v == std::vector<std::string>{"a", "b", "c", "d", "e", "f", "g", "h"});
+	CHECK(arena.capacity() == 3 * sizeof(std::string));
+
+	std::vector<int> ints{1, 3, 5, 7, 2, 4};
+	CHECK(stl2::inplace_merge(&arena, ints.begin(), ints.begin() + 4, ints.end()) == ints.end());
+	CHECK(ints == std::vector<int>{1, 2, 3, 4, 5, 7});
+	CHECK(arena.capacity() == 3 * sizeof(std::string));
+}
+#endif
@@ -16,6 +16,8 @@
 #include <nanorange/algorithm/lower_bound.hpp>
 #include <nanorange/views/iota.hpp>
 #include <nanorange/views/subrange.hpp>
+#include <algorithm>
+#include <deque>
 #include <vector>
 #include <utility>
 #include "../catch.hpp"
@@ -77,3 +79,25 @@ TEST_CASE("alg.lower_bound")
 	//CHECK(*stl2::lower_bound(stl2::iota_view<int>{}, 42) == 42);
 	(void) stl2::lower_bound(stl2::iota_view<int>{}, 42);
 }
+
+TEST_CASE("alg.lower_bound.random_access")
+{
+	// Random-access ranges take a branchless path; check every length and
+	// every position against std::lower_bound
+	for (int n = 0; n < 70; ++n) {
+		std::vector<int> vec;
+		for (int i = 0; i < n; ++i) {
+			vec.push_back(i / 3);
+		}
+		const std::deque<int> deq(vec.begin(), vec.end());
+
+		for (int x = -1; x <= n / 3 + 1; ++x) {
+			const auto expected =
+				std::lower_bound(vec.begin(), vec.end(), x) - vec.begin();
+			CHECK(stl2::lower_bound(vec, x) - vec.begin() == expected);
+			CHECK(stl2::lower_bound(deq, x) - deq.begin() == expected);
+			CHECK(stl2::lower_bound(vec.data(), vec.data() + n, x) - vec.data() ==
+			      expected);
+		}
+	}
+}
@@ -15,10 +15,14 @@
 
 #include <nanorange/algorithm/merge.hpp>
 #include <algorithm>
+#include <iterator>
 #include <memory>
+#include <random>
 #include <utility>
+#include <vector>
 #include "../catch.hpp"
 #include "../test_utils.hpp"
+#include "skewed.hpp"
 
 namespace stl2 = nano;
 
@@ -84,3 +88,69 @@ TEST_CASE("alg.merge")
 		CHECK(std::is_sorted(ic.get(), ic.get() + 2 * N));
 	}
 }
+
+TEST_CASE("alg.merge.skewed")
+{
+	// Elements from the first range must still come before equivalent ones
+	// from the second
+	test_skewed(
+		[](const auto& r1, const auto& r2, auto comp) {
+			std::vector<skewed_element> out(r1.size() + r2.size());
+			auto r = stl2::merge(r1, r2, out.begin(), comp);
+			CHECK(r.in1 == r1.end());
+			CHECK(r.in2 == r2.end());
+			CHECK(r.out == out.end());
+			return out;
+		},
+		[](const auto& r1, const auto& r2, auto comp) {
+			std::vector<skewed_element> out;
+			std::merge(r1.begin(), r1.end(), r2.begin(), r2.end(),
+			           std::back_inserter(out), comp);
+			return out;
+		},
+		[](std::size_t n1, std::size_t n2) { return n1 + n2 - 1; });
+}
+
+TEST_CASE("alg.merge.clustered")
+{
+	// Galloping mustn't take us over the N - 1 comparisons that merge is
+	// allowed, even when the runs are only a little longer than the point at
+	// which we start to gallop
+	const auto test = [](const std::vector<int>& a, const std::vector<int>& b) {
+		std::size_t count = 0;
+		const auto comp = [&count](int x, int y) {
+			++count;
+			return x < y;
+		};
+		std::vector<int> out(a.size() + b.size());
+		auto r = stl2::merge(a, b, out.begin(), comp);
+		CHECK(r.out == out.end());
+		CHECK(std::is_sorted(out.begin(), out.end()));
+		CHECK(count <= out.size() - 1);
+	};
+
+	// Alternating runs of the same length...
+	for (int len = 1; len <= 40; ++len) {
+		std::vector<int> a, b;
+		for (int i = 0; i < 180000; ++i) {
+			(i / len % 2 == 0 ? a : b).push_back(i);
+		}
+		test(a, b);
+		test(b, a);
+	}
+
+	// ...and of random lengths
+	std::mt19937 gen;
+	for (int max_len : {4, 8, 16, 32, 64, 256}) {
+		std::uniform_int_distribution<int> dist(1, max_len);
+		std::vector<int> a, b;
+		for (int i = 0, run = 0; i < 200000; ++run) {
+			auto& v = run % 2 == 0 ? a : b;
+			for (int n = dist(gen); n > 0; --n) {
+				v.push_back(i++);
+			}
+		}
+		test(a, b);
+		test(b, a);
+	}
+}
@@ -20,6 +20,7 @@
 
 #include <nanorange/algorithm/mismatch.hpp>
 #include <memory>
+#include <vector>
 #include <algorithm>
 #include "../catch.hpp"
 #include "../test_iterators.hpp"
@@ -162,3 +163,25 @@ TEST_CASE("alg.mismatch")
 		CHECK(ps2.in2->i == 5);
 	}
 }
+
+TEST_CASE("alg.mismatch.integral")
+{
+	std::vector<short> v1(100, 1);
+	std::vector<short> v2(80, 1);
+
+	for (int i = 0; i < 80; i++) {
+		v2[i] = 2;
+		auto res = ranges::mismatch(v1, v2);
+		CHECK(res.in1 - v1.begin() == i);
+		CHECK(res.in2 - v2.begin() == i);
+		auto res2 = ranges::mismatch(v1.data(), v1.data() + 100,
+		                             v2.data(), v2.data() + 80);
+		CHECK(res2.in1 == v1.data() + i);
+		CHECK(res2.in2 == v2.data() + i);
+		v2[i] = 1;
+	}
+
+	auto res = ranges::mismatch(v1, v2);
+	CHECK(res.in1 - v1.begin() == 80);
+	CHECK(res.in2 == v2.end());
+}
@@ -21,6 +21,7 @@
 #include <nanorange/algorithm/move.hpp>
 #include <memory>
 #include <algorithm>
+#include <vector>
 #include "../catch.hpp"
 #include "../test_iterators.hpp"
 #include "../test_utils.hpp"
@@ -238,3 +239,40 @@ TEST_CASE("alg.move")
 	test1<random_access_iterator<std::unique_ptr<int>*>, bidirectional_iterator<std::unique_ptr<int>*>, sentinel<std::unique_ptr<int>*> >();
 	test1<random_access_iterator<std::unique_ptr<int>*>, random_access_iterator<std::unique_ptr<int>*>, sentinel<std::unique_ptr<int>*> >();
 }
+
+namespace {
+
+constexpr int constexpr_move()
+{
+	int a[] = {1, 2, 3, 4};
+	int b[4] = {};
+	stl2::move(a, b);
+	stl2::move_backward(b, b + 2, b + 4);
+	return b[0] * 1000 + b[1] * 100 + b[2] * 10 + b[3];
+}
+
+static_assert(constexpr_move() == 1212, "");
+
+}
+
+TEST_CASE("alg.move.trivial")
+{
+	std::vector<double> src(100);
+	for (int i = 0; i < 100; i++) {
+		src[i] = i;
+	}
+
+	std::vector<double> dst(100);
+	auto res = stl2::move(src, dst.data());
+	CHECK(res.in == src.end());
+	CHECK(res.out == dst.data() + 100);
+	CHECK(src == dst);
+
+	auto res2 = stl2::move_backward(dst.data(), dst.data() + 50,
+	                                  dst.data() + 100);
+	CHECK(res2.in == dst.data() + 50);
+	CHECK(res2.out == dst.data() + 50);
+	for (int i = 0; i < 50; i++) {
+		CHECK(dst[i + 50] == i);
+	}
+}
@@ -23,6 +23,9 @@
 #include <memory>
 #include <random>
 #include <algorithm>
+#include <array>
+#include <string>
+#include <vector>
 #include "../catch.hpp"
 #include "../test_utils.hpp"
 #include "../test_iterators.hpp"
@@ -73,6 +76,40 @@ struct S
 	int i,j;
 };
 
+// Checks that [first, last) is partitioned around nth, with *nth in its
+// sorted position
+template <typename I>
+bool is_nth_element(I first, I nth, I last)
+{
+	for (I i = first; i != nth; ++i)
+		if (*nth < *i) return false;
+	for (I i = nth; i != last; ++i)
+		if (*i < *nth) return false;
+	return true;
+}
+
+// Inputs which defeat naive pivot selection
+std::vector<std::vector<int>> make_patterns(int n)
+{
+	std::vector<std::vector<int>> patterns(6, std::vector<int>(n));
+	for (int i = 0; i < n; ++i) {
+		patterns[0][i] = i;
+		patterns[1][i] = n - i;
+		patterns[2][i] = i < n / 2 ? 2 * i : 2 * (n - i) + 1;
+		patterns[3][i] = int(gen() % 4);
+		patterns[4][i] = 7;
+		patterns[5][i] = i % 2 ? n + i : i;
+	}
+	return patterns;
+}
+
+constexpr int constexpr_median()
+{
+	std::array<int, 9> a{5, 8, 1, 9, 3, 7, 2, 6, 4};
+	stl2::nth_element(a, a.begin() + 4);
+	return a[4];
+}
+
 }
 
 TEST_CASE("alg.nth_element")
@@ -99,3 +136,49 @@ TEST_CASE("alg.nth_element")
 	CHECK(ia[M].i == M);
 	CHECK(ia[M].j == M);
 }
+
+TEST_CASE("alg.nth_element.patterns")
+{
+	for (int n : {24, 100, 129, 1000, 10000}) {
+		for (const auto& pattern : make_patterns(n)) {
+			for (int m : {0, 1, n / 3, n / 2, n - 2, n - 1}) {
+				auto v = pattern;
+				stl2::nth_element(v, v.begin() + m);
+				CHECK(is_nth_element(v.begin(), v.begin() + m, v.end()));
+				auto sorted = pattern;
+				std::sort(sorted.begin(), sorted.end());
+				CHECK(v[m] == sorted[m]);
+
+				// Non-arithmetic type, using the branching partition
+				std::vector<std::string> strs(pattern.size());
+				std::transform(pattern.begin(), pattern.end(), strs.begin(),
+							   [](int i) { return std::to_string(i); });
+				stl2::nth_element(strs, strs.begin() + m);
+				CHECK(is_nth_element(strs.begin(), strs.begin() + m, strs.end()));
+			}
+		}
+	}
+}
+
+TEST_CASE("alg.nth_element.median_of_medians")
+{
+	// The O(n) fallback is not reachable from ordinary inputs, so test it
+	// directly
+	auto comp = stl2::less{};
+	auto proj = stl2::identity{};
+	for (int n : {1, 23, 24, 25, 257, 1000}) {
+		for (const auto& pattern : make_patterns(n)) {
+			for (int m : {0, n / 2, n - 1}) {
+				auto v = pattern;
+				nano::detail::median_of_medians_select(v.begin(), v.begin() + m,
+													   v.end(), comp, proj);
+				CHECK(is_nth_element(v.begin(), v.begin() + m, v.end()));
+			}
+		}
+	}
+}
+
+TEST_CASE("alg.nth_element.constexpr")
+{
+	static_assert(constexpr_median() == 5);
+}
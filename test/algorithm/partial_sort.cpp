@@ -23,6 +23,8 @@
 #include <memory>
 #include <random>
 #include <algorithm>
+#include <array>
+#include <string>
 #include <vector>
 #include "../catch.hpp"
 #include "../test_utils.hpp"
@@ -142,6 +144,13 @@ struct S {
 	int i, j;
 };
 
+constexpr std::array<int, 3> constexpr_smallest()
+{
+	std::array<int, 9> a{5, 8, 1, 9, 3, 7, 2, 6, 4};
+	stl2::partial_sort(a, a.begin() + 3);
+	return {a[0], a[1], a[2]};
+}
+
 }
 
 TEST_CASE("alg.partial_sort")
@@ -185,3 +194,28 @@ TEST_CASE("alg.partial_sort")
 		}
 	}
 }
+
+TEST_CASE("alg.partial_sort.patterns")
+{
+	const int n = 5000;
+	std::vector<std::vector<std::string>> patterns(4);
+	for (int i = 0; i < n; ++i) {
+		patterns[0].push_back(std::to_string(100000 + i));
+		patterns[1].push_back(std::to_string(100000 + n - i));
+		patterns[2].push_back(std::to_string(gen() % 8));
+		patterns[3].push_back(std::to_string(100000 + gen() % n));
+	}
+
+	for (const auto& pattern : patterns) {
+		auto sorted = pattern;
+		std::sort(sorted.begin(), sorted.end());
+		for (int m : {0, 1, 10, n / 2, n}) {
+			auto v = pattern;
+			CHECK(stl2::partial_sort(v, v.begin() + m) == v.end());
+			CHECK(std::equal(v.begin(), v.begin() + m, sorted.begin()));
+		}
+	}
+
+	constexpr auto smallest = constexpr_smallest();
+	static_assert(smallest[0] == 1 && smallest[1] == 2 && smallest[2] == 3);
+}
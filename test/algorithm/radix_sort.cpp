@@ -0,0 +1,140 @@
+// nanorange/test/algorithm/radix_sort.cpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <nanorange/algorithm/radix_sort.hpp>
+#include <nanorange/algorithm/sort.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../catch.hpp"
+
+namespace {
+
+std::mt19937 gen;
+
+template <typename T>
+std::vector<T> make_random(std::size_t n)
+{
+	std::vector<T> v(n);
+	for (auto& x : v) {
+		if constexpr (std::is_floating_point<T>::value) {
+			x = std::uniform_real_distribution<T>(-1000, 1000)(gen);
+		} else {
+			x = static_cast<T>(gen());
+		}
+	}
+	return v;
+}
+
+template <typename T>
+void test_radix_sort()
+{
+	for (std::size_t n : {0, 1, 2, 100, 5000}) {
+		auto v = make_random<T>(n);
+		auto expected = v;
+
+		std::sort(expected.begin(), expected.end());
+		CHECK(nano::radix_sort(v) == v.end());
+		CHECK(v == expected);
+
+		std::sort(expected.begin(), expected.end(), std::greater<T>{});
+		CHECK(nano::radix_sort(v.begin(), v.end(), nano::greater{}) == v.end());
+		CHECK(v == expected);
+	}
+}
+
+struct record {
+	int key;
+	int index;
+};
+
+template <typename, typename = void>
+constexpr bool can_radix_sort = false;
+
+template <typename T>
+constexpr bool can_radix_sort<T, std::void_t<decltype(nano::radix_sort(std::declval<T&>()))>> = true;
+
+static_assert(can_radix_sort<std::vector<int>>, "");
+static_assert(can_radix_sort<std::vector<double>>, "");
+static_assert(!can_radix_sort<std::vector<std::string>>, "");
+static_assert(!can_radix_sort<std::vector<record>>, "");
+
+}
+
+TEST_CASE("alg.radix_sort")
+{
+	test_radix_sort<std::int8_t>();
+	test_radix_sort<std::uint8_t>();
+	test_radix_sort<std::int16_t>();
+	test_radix_sort<std::int32_t>();
+	test_radix_sort<std::uint32_t>();
+	test_radix_sort<std::int64_t>();
+	test_radix_sort<std::uint64_t>();
+	test_radix_sort<float>();
+	test_radix_sort<double>();
+}
+
+TEST_CASE("alg.radix_sort.special_values")
+{
+	using lim = std::numeric_limits<double>;
+	std::vector<double> v = {3.0, -lim::infinity(), -0.5, lim::max(),
+	                         lim::lowest(), lim::infinity(), 0.0, -2.0,
+	                         lim::min(), lim::denorm_min()};
+	auto expected = v;
+	std::sort(expected.begin(), expected.end());
+	nano::radix_sort(v);
+	CHECK(v == expected);
+
+	std::vector<int> i = {0, -1, std::numeric_limits<int>::min(), 1,
+	                      std::numeric_limits<int>::max()};
+	nano::radix_sort(i, std::greater<>{});
+	CHECK(i == std::vector<int>{std::numeric_limits<int>::max(), 1, 0, -1,
+	                            std::numeric_limits<int>::min()});
+}
+
+TEST_CASE("alg.radix_sort.stable")
+{
+	std::vector<record> v(100000);
+	for (int i = 0; i < 100000; i++) {
+		v[i] = record{static_cast<int>(gen() % 100) - 50, i};
+	}
+
+	nano::radix_sort(v, nano::less{}, &record::key);
+	CHECK(std::is_sorted(v.begin(), v.end(), [](const record& a, const record& b) {
+		return a.key < b.key || (a.key == b.key && a.index < b.index);
+	}));
+}
+
+TEST_CASE("alg.sort.radix")
+{
+	// nano::sort() should give the same results whether or not it chooses
+	// to radix sort
+	auto v = make_random<std::uint64_t>(100000);
+	auto expected = v;
+	std::sort(expected.begin(), expected.end());
+	nano::sort(v);
+	CHECK(v == expected);
+
+	auto f = make_random<float>(100000);
+	auto f_expected = f;
+	std::sort(f_expected.begin(), f_expected.end(), std::greater<>{});
+	nano::sort(f, nano::greater{});
+	CHECK(f == f_expected);
+
+	std::vector<record> r(100000);
+	for (int i = 0; i < 100000; i++) {
+		r[i] = record{static_cast<int>(gen()), i};
+	}
+	nano::sort(r, std::less<int>{}, &record::key);
+	CHECK(std::is_sorted(r.begin(), r.end(), [](const record& a, const record& b) {
+		return a.key < b.key;
+	}));
+}
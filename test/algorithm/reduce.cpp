@@ -0,0 +1,79 @@
+// nanorange/test/algorithm/reduce.cpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <nanorange/algorithm/reduce.hpp>
+
+#include <forward_list>
+#include <functional>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "../catch.hpp"
+
+namespace {
+
+struct S {
+	int i;
+};
+
+constexpr int reduce_array()
+{
+	int arr[] = {1, 2, 3, 4, 5};
+	return nano::reduce(arr) + nano::reduce(arr, 10, std::multiplies<>{});
+}
+
+static_assert(reduce_array() == 15 + 1200);
+
+}
+
+TEST_CASE("alg.reduce")
+{
+	std::vector<int> v(1000);
+	std::iota(v.begin(), v.end(), 1);
+
+	CHECK(nano::reduce(v.begin(), v.end()) == 500'500);
+	CHECK(nano::reduce(v) == 500'500);
+	CHECK(nano::reduce(v, 1) == 500'501);
+	CHECK(nano::reduce(v, 0LL, std::plus<>{}, [](int i) { return i * 1'000'000LL; }) ==
+	      500'500'000'000LL);
+
+	std::vector<S> vs{{1}, {2}, {3}};
+	CHECK(nano::reduce(vs, 0, std::plus<>{}, &S::i) == 6);
+
+	std::forward_list<std::string> l{"a", "b", "c"};
+	CHECK(nano::reduce(l, std::string{}) == "abc");
+	CHECK(nano::reduce(l.begin(), l.end(), std::string{"x"}) == "xabc");
+
+	std::vector<int> empty;
+	CHECK(nano::reduce(empty, 42) == 42);
+}
+
+TEST_CASE("alg.reduce.parallel")
+{
+	std::vector<int> v(1'000'000);
+	std::iota(v.begin(), v.end(), 0);
+	const long long expected = 999'999LL * 1'000'000LL / 2;
+
+	CHECK(nano::reduce(nano::execution::par, v, 0LL) == expected);
+	CHECK(nano::reduce(nano::execution::par_unseq, v.begin(), v.end(), 0LL) == expected);
+	CHECK(nano::reduce(nano::execution::seq, v, 0LL) == expected);
+	CHECK(nano::reduce(nano::execution::par, v, 0LL, std::plus<>{},
+	                   [](int i) { return i % 2; }) == 500'000);
+
+	// Partial results are combined in order
+	std::vector<std::string> strs(100'000, "a");
+	strs.back() = "b";
+	auto s = nano::reduce(nano::execution::par, strs, std::string{});
+	CHECK(s.size() == strs.size());
+	CHECK(s.back() == 'b');
+
+	std::vector<int> empty;
+	CHECK(nano::reduce(nano::execution::par, empty, 42) == 42);
+
+	std::forward_list<int> l{1, 2, 3};
+	CHECK(nano::reduce(nano::execution::par, l) == 6);
+}
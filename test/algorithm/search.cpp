@@ -24,8 +24,12 @@
 
 #include <nanorange/algorithm/search.hpp>
 #include <nanorange/iterator/counted_iterator.hpp>
+#include <algorithm>
 #include <array>
 #include <initializer_list>
+#include <random>
+#include <string>
+#include <vector>
 #include "../catch.hpp"
 #include "../test_iterators.hpp"
 #include "../test_utils.hpp"
@@ -34,6 +38,28 @@ namespace stl2 = nano;
 
 namespace {
 
+// Returns the offset of the result of nano::search(), checking that it agrees
+// with std::search()
+template <typename Hay, typename Needle>
+std::ptrdiff_t checked_search(const Hay& hay, const Needle& needle)
+{
+	const auto res = stl2::search(hay, needle);
+	const auto expected = std::search(hay.begin(), hay.end(), needle.begin(),
+									  needle.end());
+	CHECK(res.begin() == expected);
+	CHECK(res.end() == (expected == hay.end() ? hay.end()
+											  : expected + needle.size()));
+	return res.begin() - hay.begin();
+}
+
+constexpr std::ptrdiff_t constexpr_search()
+{
+	std::array<int, 20> hay{1, 1, 1, 2, 1, 1, 1, 1, 1, 1,
+							1, 1, 1, 1, 1, 1, 2, 3, 1, 1};
+	std::array<int, 9> needle{1, 1, 1, 1, 1, 1, 1, 2, 3};
+	return stl2::search(hay, needle).begin() - hay.begin();
+}
+
 // FIXME: Properly update tests for subrange return type
 
 template <typename T>
@@ -269,3 +295,48 @@ TEST_CASE("alg.search")
 		static_assert(stl2::same_as<decltype(r), stl2::dangling>);
 	}
 }
+
+TEST_CASE("alg.search.two_way")
+{
+	// Repetitive inputs, which take quadratic time with the naive algorithm
+	{
+		std::string hay(100000, 'A');
+		std::string needle(5000, 'A');
+		needle.back() = 'B';
+		CHECK(stl2::search(hay, needle).begin() == hay.end());
+		hay[hay.size() - 10] = 'B';
+		CHECK(stl2::search(hay, needle).begin() == hay.end() - 5009);
+	}
+
+	// Periodic and non-periodic needles over small alphabets
+	std::mt19937 gen;
+	for (int alphabet : {1, 2, 3, 26}) {
+		for (int i = 0; i < 300; ++i) {
+			std::string hay(gen() % 300, ' ');
+			for (char& c : hay) c = char('a' + gen() % alphabet);
+			std::string needle(gen() % 20 + 1, ' ');
+			for (char& c : needle) c = char('a' + gen() % alphabet);
+			if (i % 2 == 0 && needle.size() <= hay.size()) {
+				const auto pos = gen() % (hay.size() - needle.size() + 1);
+				hay.replace(pos, needle.size(), needle);
+			}
+			checked_search(hay, needle);
+		}
+	}
+
+	// Non-character types and projections
+	{
+		std::vector<std::string> hay{"a", "b", "a", "b", "a", "b", "a", "b",
+									 "a", "b", "c", "a", "b", "a", "b"};
+		std::vector<std::string> needle{"b", "a", "b", "a", "b", "a", "b", "c"};
+		CHECK(checked_search(hay, needle) == 3);
+
+		std::vector<int> lengths{1, 1, 1, 1, 1, 1, 1, 1};
+		auto res = stl2::search(hay, lengths, std::equal_to<>{},
+								&std::string::size);
+		CHECK(res.begin() == hay.begin());
+		CHECK(res.end() == hay.begin() + 8);
+	}
+
+	static_assert(constexpr_search() == 9);
+}
@@ -0,0 +1,155 @@
+// nanorange/test/algorithm/search_any.cpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <nanorange/algorithm/search_any.hpp>
+#include <nanorange/iterator/back_insert_iterator.hpp>
+#include <nanorange/views/istream.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "../catch.hpp"
+
+namespace {
+
+std::mt19937 gen;
+
+std::string make_random(std::size_t n, char alphabet)
+{
+	std::uniform_int_distribution<int> dist('a', 'a' + alphabet - 1);
+	std::string s(n, ' ');
+	for (auto& c : s) {
+		c = static_cast<char>(dist(gen));
+	}
+	return s;
+}
+
+// Every match of every pattern, found with std::search, in the order
+// search_any() reports them
+std::vector<nano::search_any_match>
+naive_search_any(const std::string& hay, const std::vector<std::string>& patterns)
+{
+	std::vector<nano::search_any_match> matches;
+	for (std::size_t p = 0; p < patterns.size(); ++p) {
+		const auto& pat = patterns[p];
+		if (pat.empty()) {
+			continue;
+		}
+		auto it = hay.begin();
+		while ((it = std::search(it, hay.end(), pat.begin(), pat.end())) != hay.end()) {
+			matches.push_back({p, it - hay.begin(),
+			                   static_cast<std::ptrdiff_t>(pat.size())});
+			++it;
+		}
+	}
+
+	std::sort(matches.begin(), matches.end(), [](const auto& a, const auto& b) {
+		return std::make_tuple(a.offset + a.length, -a.length, a.pattern) <
+		       std::make_tuple(b.offset + b.length, -b.length, b.pattern);
+	});
+	return matches;
+}
+
+}
+
+TEST_CASE("alg.search_any")
+{
+	{
+		const std::vector<std::string> patterns{"he", "she", "his", "hers"};
+		const nano::aho_corasick_searcher searcher{patterns};
+		CHECK(searcher.size() == 4);
+
+		const std::string hay = "ushers";
+		std::vector<nano::search_any_match> matches;
+		const auto res = nano::search_any(hay, searcher, nano::back_inserter(matches));
+		CHECK(res.in == hay.end());
+		CHECK(matches == std::vector<nano::search_any_match>{
+			{1, 1, 3}, {0, 2, 2}, {3, 2, 4}});
+	}
+
+	// Duplicate and empty patterns
+	{
+		const std::vector<std::string> patterns{"ab", "", "b", "ab"};
+		const nano::aho_corasick_searcher searcher{patterns};
+		const std::string hay = "abab";
+		std::vector<nano::search_any_match> matches;
+		nano::search_any(hay.begin(), hay.end(), searcher, nano::back_inserter(matches));
+		CHECK(matches == naive_search_any(hay, patterns));
+		CHECK(matches.size() == 6);
+	}
+
+	// Compare with searching for each pattern in turn
+	for (char alphabet : {2, 4, 26}) {
+		for (std::size_t k : {1, 10, 200}) {
+			std::vector<std::string> patterns;
+			for (std::size_t i = 0; i < k; ++i) {
+				patterns.push_back(make_random(1 + gen() % 6, alphabet));
+			}
+			const nano::aho_corasick_searcher searcher{patterns};
+			const std::string hay = make_random(500, alphabet);
+
+			std::vector<nano::search_any_match> matches;
+			nano::search_any(hay, searcher, nano::back_inserter(matches));
+			CHECK(matches == naive_search_any(hay, patterns));
+		}
+	}
+}
+
+TEST_CASE("alg.search_any.input_range")
+{
+	const std::vector<std::string> patterns{"cat", "at", "dog"};
+	const nano::aho_corasick_searcher searcher{patterns};
+
+	// istreambuf_iterator can't be rewound
+	{
+		std::istringstream ss{"concatenate dogs"};
+		std::vector<nano::search_any_match> matches;
+		nano::search_any(std::istreambuf_iterator<char>{ss},
+		                 std::istreambuf_iterator<char>{}, searcher,
+		                 nano::back_inserter(matches));
+		CHECK(matches == std::vector<nano::search_any_match>{
+			{0, 3, 3}, {1, 4, 2}, {1, 8, 2}, {2, 12, 3}});
+	}
+
+	// Nor can istream_view; offsets count elements rather than characters
+	{
+		std::istringstream ss{"c a t d o g"};
+		std::vector<nano::search_any_match> matches;
+		nano::search_any(nano::istream_view<char>(ss), searcher,
+		                 nano::back_inserter(matches));
+		CHECK(matches == std::vector<nano::search_any_match>{
+			{0, 0, 3}, {1, 1, 2}, {2, 3, 3}});
+	}
+}
+
+TEST_CASE("alg.search_any.projections")
+{
+	struct token {
+		int kind;
+	};
+
+	const std::vector<std::vector<int>> patterns{{1, 2}, {2, 1000, 2}};
+	const nano::aho_corasick_searcher searcher{patterns};
+	const std::vector<token> hay{{1}, {2}, {1000}, {2}, {1}};
+
+	std::vector<nano::search_any_match> matches;
+	nano::search_any(hay, searcher, nano::back_inserter(matches), &token::kind);
+	CHECK(matches == std::vector<nano::search_any_match>{{0, 0, 2}, {1, 1, 3}});
+
+	// Projection of the patterns
+	const std::vector<std::string> words{"ab", "b"};
+	const nano::aho_corasick_searcher upper{
+		words, [](char c) { return static_cast<char>(c - 'a' + 'A'); }};
+	const std::string caps = "xABy";
+	matches.clear();
+	nano::search_any(caps, upper, nano::back_inserter(matches));
+	CHECK(matches == std::vector<nano::search_any_match>{{0, 1, 2}, {1, 2, 1}});
+}
@@ -25,7 +25,11 @@
 #include <nanorange/algorithm/search_n.hpp>
 #include <nanorange/iterator/counted_iterator.hpp>
 #include <nanorange/views/subrange.hpp>
+#include <algorithm>
 #include <array>
+#include <cstdint>
+#include <random>
+#include <vector>
 #include "../catch.hpp"
 #include "../test_iterators.hpp"
 #include "../test_utils.hpp"
@@ -163,6 +167,56 @@ struct S {
 	int i;
 };
 
+std::mt19937 gen;
+
+// Sparse runs of zeros of random lengths, in otherwise random data
+template <typename T>
+std::vector<T> make_gappy(std::size_t n, int zero_percent)
+{
+	std::vector<T> v(n);
+	std::uniform_int_distribution<int> dist(1, 100);
+	std::geometric_distribution<int> run_length(0.1);
+	for (std::size_t i = 0; i < n;) {
+		if (dist(gen) <= zero_percent) {
+			const auto len = std::min<std::size_t>(run_length(gen) + 1, n - i);
+			std::fill_n(v.begin() + i, len, T(0));
+			i += len;
+		} else {
+			v[i++] = static_cast<T>(dist(gen));
+		}
+	}
+	return v;
+}
+
+template <typename T>
+void test_random_search_n()
+{
+	for (int zero_percent : {0, 1, 10, 50, 100}) {
+		const auto v = make_gappy<T>(2000, zero_percent);
+		for (std::ptrdiff_t count : {1, 2, 3, 7, 15, 16, 17, 40, 100, 2000, 2001}) {
+			const auto expected = std::search_n(v.begin(), v.end(), count, T(0));
+			const auto expected_end = expected == v.end() ? v.end() : expected + count;
+
+			// Via data(), with the vectorised kernels
+			const auto r1 = stl2::search_n(v, count, 0);
+			CHECK(r1.begin() == expected);
+			CHECK(r1.end() == expected_end);
+
+			// Random-access but not contiguous
+			using RA = random_access_iterator<const T*>;
+			const auto r2 = stl2::search_n(RA(v.data()), RA(v.data() + v.size()),
+			                               count, T(0));
+			CHECK(base(r2.begin()) == v.data() + (expected - v.begin()));
+			CHECK(base(r2.end()) == v.data() + (expected_end - v.begin()));
+
+			// Projections disable the vectorised kernels too
+			const auto r3 = stl2::search_n(v, count, 1, stl2::equal_to{},
+			                               [](T t) { return t + 1; });
+			CHECK(r3.begin() == expected);
+		}
+	}
+}
+
 }
 
 TEST_CASE("alg.search_n")
@@ -207,3 +261,26 @@ TEST_CASE("alg.search_n")
 		static_assert(stl2::same_as<decltype(r), stl2::dangling>);
 	}
 }
+
+TEST_CASE("alg.search_n.random_access")
+{
+	test_random_search_n<char>();
+	test_random_search_n<std::uint16_t>();
+	test_random_search_n<int>();
+	test_random_search_n<std::int64_t>();
+	test_random_search_n<double>();
+
+	// Values which can't be represented in the element type never match
+	{
+		const std::vector<unsigned char> v(10, 255);
+		CHECK(stl2::search_n(v, 2, -1).begin() == v.end());
+		CHECK(stl2::search_n(v, 2, 255).begin() == v.begin());
+	}
+
+	// Negative counts match at the beginning
+	{
+		const std::vector<int> v{1, 2, 3};
+		CHECK(stl2::search_n(v, -1, 7).begin() == v.begin());
+		CHECK(stl2::search_n(v.begin(), v.end(), -1, 7).empty());
+	}
+}
@@ -11,6 +11,12 @@
 //
 
 #include "set_difference.hpp"
+#include "skewed.hpp"
+
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <vector>
 
 TEST_CASE("alg.set_difference1")
 {
@@ -44,3 +50,69 @@ TEST_CASE("alg.set_difference1")
 	test<input_iterator<const int*>, const int*, random_access_iterator<int*> >();
 	test<input_iterator<const int*>, const int*, int*>();
 }
+
+TEST_CASE("alg.set_difference.skewed")
+{
+	test_skewed(
+		[](const auto& r1, const auto& r2, auto comp) {
+			std::vector<skewed_element> out(r1.size() + r2.size());
+			auto r = stl2::set_difference(r1, r2, out.begin(), comp);
+			CHECK(r.in == r1.end());
+			out.erase(r.out, out.end());
+			return out;
+		},
+		[](const auto& r1, const auto& r2, auto comp) {
+			std::vector<skewed_element> out;
+			std::set_difference(r1.begin(), r1.end(), r2.begin(), r2.end(),
+			                    std::back_inserter(out), comp);
+			return out;
+		},
+		[](std::size_t n1, std::size_t n2) { return 2 * (n1 + n2) - 1; });
+}
+
+TEST_CASE("alg.set_difference.integers")
+{
+	// Sorted integers of four or eight bytes go through a vectorised kernel,
+	// which hands over to the scalar loop when it meets a repeated value
+	std::mt19937 gen;
+	const auto test = [&](auto tag, std::size_t n1, std::size_t n2,
+	                      int spread, bool distinct) {
+		using T = decltype(tag);
+		std::uniform_int_distribution<int> dist(-spread, spread);
+		const auto make = [&](std::size_t n) {
+			std::vector<T> v(n);
+			for (auto& x : v) { x = static_cast<T>(dist(gen)); }
+			std::sort(v.begin(), v.end());
+			if (distinct) {
+				v.erase(std::unique(v.begin(), v.end()), v.end());
+			}
+			return v;
+		};
+		const auto a = make(n1);
+		const auto b = make(n2);
+
+		std::vector<T> expected;
+		std::set_difference(a.begin(), a.end(), b.begin(), b.end(),
+		                    std::back_inserter(expected));
+
+		std::vector<T> out(a.size() + b.size());
+		auto res = stl2::set_difference(a, b, out.begin());
+		CHECK(res.in == a.end());
+		CHECK(std::vector<T>(out.begin(), res.out) == expected);
+
+		auto res2 = stl2::set_difference(a.data(), a.data() + a.size(), b.data(),
+		                                 b.data() + b.size(), out.data());
+		CHECK(std::vector<T>(out.data(), res2.out) == expected);
+	};
+
+	for (std::size_t n : {1, 7, 9, 17, 100, 1000}) {
+		for (int spread : {int(n), int(n) * 10}) {
+			for (bool distinct : {true, false}) {
+				test(std::uint32_t{}, n, n, spread, distinct);
+				test(std::uint64_t{}, n, n, spread, distinct);
+				test(0, n, n / 2 + 1, spread, distinct);
+				test(0LL, n / 3, n, spread, distinct);
+			}
+		}
+	}
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <iterator>
+#include <random>
+#include <utility>
+#include <vector>
+#include "../catch.hpp"
+
+// The merge-like algorithms gallop through long runs taken from one range, so
+// that combining m elements with n takes O(m log(n/m)) comparisons rather
+// than O(m + n).
+//
+// Elements are (key, range) pairs compared by key, so that checking the
+// results also checks which range equivalent elements were taken from.
+using skewed_element = std::pair<int, int>;
+
+inline std::vector<int> skewed_keys(const std::vector<skewed_element>& v)
+{
+	std::vector<int> keys;
+	for (const auto& x : v) { keys.push_back(x.first); }
+	return keys;
+}
+
+// Calls run(r1, r2, comp) on sorted ranges of m and 1,000,000 elements, in
+// both orders, where the smaller range is a sample of the larger one and comp
+// counts its calls. Checks that the result matches reference(r1, r2, comp),
+// that the comparisons are within standard_bound(n1, n2), and that they are
+// within a small multiple of m log2(n/m).
+template <typename Run, typename Reference, typename Bound>
+void test_skewed(Run run, Reference reference, Bound standard_bound)
+{
+	const std::size_t n = 1000000;
+
+	std::mt19937 gen;
+	std::uniform_int_distribution<int> dist(0, n / 4);
+	std::vector<skewed_element> big(n);
+	for (auto& x : big) { x = {dist(gen), 1}; }
+	std::sort(big.begin(), big.end());
+
+	for (std::size_t m : {1, 100}) {
+		std::vector<skewed_element> small;
+		std::sample(big.begin(), big.end(), std::back_inserter(small), m, gen);
+		for (auto& x : small) { x.second = 2; }
+
+		for (bool swapped : {false, true}) {
+			const auto& r1 = swapped ? big : small;
+			const auto& r2 = swapped ? small : big;
+
+			std::size_t count = 0;
+			const auto comp = [&count](const skewed_element& x,
+			                           const skewed_element& y) {
+				++count;
+				return x.first < y.first;
+			};
+			const auto key_less = [](const skewed_element& x,
+			                         const skewed_element& y) {
+				return x.first < y.first;
+			};
+
+			CHECK(run(r1, r2, comp) == reference(r1, r2, key_less));
+			CHECK(count <= standard_bound(r1.size(), r2.size()));
+			CHECK(count <= 4 * m * (std::log2(double(n) / m) + 1));
+		}
+	}
+}
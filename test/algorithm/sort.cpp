@@ -21,7 +21,9 @@
 #include <nanorange/algorithm/sort.hpp>
 #include <nanorange/algorithm/copy.hpp>
 #include <algorithm>
+#include <array>
 #include <cassert>
+#include <cmath>
 #include <memory>
 #include <random>
 #include <vector>
@@ -228,6 +230,46 @@ struct Int
 	}
 };
 
+// Checks the sorting network for N elements on every sequence of zeros and
+// ones, which by the 0-1 principle shows that it sorts everything
+template <typename T, std::size_t N>
+void test_network_zero_one()
+{
+	for (unsigned long bits = 0; bits < (1ul << N); ++bits)
+	{
+		std::array<T, N> a{};
+		for (std::size_t i = 0; i < N; ++i)
+			a[i] = static_cast<T>((bits >> i) & 1);
+		CHECK(stl2::sort(a) == a.end());
+		CHECK(std::is_sorted(a.begin(), a.end()));
+	}
+}
+
+template <typename T, std::size_t... Ns>
+void test_networks(std::index_sequence<Ns...>)
+{
+	(test_network_zero_one<T, Ns>(), ...);
+}
+
+constexpr bool constexpr_sorted()
+{
+	std::array<int, 7> a{4, -1, 7, 7, 0, 3, 2};
+	stl2::sort(a);
+	const int expected[] = {-1, 0, 2, 3, 4, 7, 7};
+	for (std::size_t i = 0; i < a.size(); ++i)
+		if (a[i] != expected[i])
+			return false;
+	return true;
+}
+
+constexpr bool constexpr_sorted_desc()
+{
+	double a[5] = {0.5, -2.0, 8.0, 1.0, 1.0};
+	stl2::sort(a, stl2::greater{});
+	return a[0] == 8.0 && a[1] == 1.0 && a[2] == 1.0 && a[3] == 0.5 &&
+	       a[4] == -2.0;
+}
+
 }
 
 TEST_CASE("alg.sort")
@@ -325,3 +367,116 @@ TEST_CASE("alg.sort")
 	}
 #endif
 }
+
+TEST_CASE("alg.sort.small")
+{
+	// Fixed-size arrays use sorting networks
+	test_networks<int>(std::make_index_sequence<17>{});
+	test_networks<double>(std::make_index_sequence<17>{});
+	test_networks<unsigned char>(std::make_index_sequence<12>{});
+
+	static_assert(constexpr_sorted());
+	static_assert(constexpr_sorted_desc());
+
+	{
+		int a[12] = {5, 3, 9, -4, 0, 3, 11, 2, 2, 7, 1, -8};
+		int* r = stl2::sort(a, std::greater<int>{});
+		CHECK(r == a + 12);
+		CHECK(std::is_sorted(a, a + 12, std::greater<int>{}));
+	}
+
+	{
+		std::array<float, 9> a{0.0f, -0.0f, 3.5f, -1.0f, 0.0f, 2.0f, -0.0f, 1e30f, -1e30f};
+		stl2::sort(a);
+		CHECK(std::is_sorted(a.begin(), a.end()));
+		CHECK(std::count_if(a.begin(), a.end(), [](float f) {
+			return f == 0.0f && std::signbit(f);
+		}) == 2);
+	}
+
+	// Other types, and arrays too large for a network
+	{
+		std::array<S, 10> a{};
+		for (int i = 0; i < 10; ++i)
+			a[i] = S{(i * 7) % 10, i};
+		stl2::sort(a, std::less<int>{}, &S::i);
+		for (int i = 0; i < 10; ++i)
+			CHECK(a[i].i == i);
+
+		std::array<std::unique_ptr<int>, 6> p;
+		for (int i = 0; i < 6; ++i)
+			p[i].reset(new int(5 - i));
+		stl2::sort(p, indirect_less());
+		for (int i = 0; i < 6; ++i)
+			CHECK(*p[i] == i);
+
+		std::array<int, 40> b{};
+		for (auto& x : b)
+			x = static_cast<int>(gen() % 20);
+		CHECK(stl2::sort(b) == b.end());
+		CHECK(std::is_sorted(b.begin(), b.end()));
+	}
+
+	// Small partitions of arithmetic values in pdqsort
+	for (int n = 0; n < 64; ++n)
+	{
+		std::vector<double> v(n);
+		for (auto& x : v)
+			x = static_cast<double>(gen() % 16) - 8.0;
+		auto expected = v;
+		std::sort(expected.begin(), expected.end(), std::greater<>{});
+		stl2::sort(v, std::greater<>{});
+		CHECK(v == expected);
+	}
+}
+
+TEST_CASE("alg.sort.parallel")
+{
+	const worker_count_guard workers(4);
+	REQUIRE(nano::detail::task_pool::instance().concurrency() == 5);
+
+	std::vector<int> v(100'000);
+	for (int& i : v)
+		i = static_cast<int>(gen() % 5000);
+	auto expected = v;
+	std::sort(expected.begin(), expected.end());
+
+	{
+		auto v2 = v;
+		CHECK(stl2::sort(stl2::execution::par, v2) == v2.end());
+		CHECK(v2 == expected);
+	}
+
+	{
+		auto v2 = v;
+		CHECK(stl2::sort(stl2::execution::par_unseq, v2.begin(), v2.end()) == v2.end());
+		CHECK(v2 == expected);
+	}
+
+	{
+		auto v2 = v;
+		CHECK(stl2::sort(stl2::execution::seq, v2) == v2.end());
+		CHECK(v2 == expected);
+	}
+
+	// Check comparators and projections
+	{
+		std::vector<S> v2(v.size());
+		for (std::size_t i = 0; i < v.size(); ++i)
+			v2[i] = S{v[i], static_cast<int>(i)};
+		stl2::sort(stl2::execution::par, v2, std::greater<int>{}, &S::i);
+		CHECK(std::is_sorted(v2.begin(), v2.end(), [](const S& a, const S& b) {
+			return a.i > b.i;
+		}));
+	}
+
+	// Check move-only types
+	{
+		std::vector<std::unique_ptr<int>> v2(v.size());
+		for (std::size_t i = 0; i < v.size(); ++i)
+			v2[i].reset(new int(v[i]));
+		stl2::sort(stl2::execution::par, v2, indirect_less());
+		for (std::size_t i = 0; i < v.size(); ++i)
+			CHECK(*v2[i] == expected[i]);
+	}
+}
@@ -27,6 +27,8 @@
 #include <random>
 #include <algorithm>
 #include <functional>
+#include <numeric>
+#include <vector>
 #include "../catch.hpp"
 #include "../test_utils.hpp"
 #include "../test_iterators.hpp"
@@ -209,3 +211,23 @@ TEST_CASE("alg.sort_heap")
 	test_9(1000);
 	test_10(1000);
 }
+
+TEST_CASE("alg.sort_heap.comparisons")
+{
+	// The bottom-up pop takes about n log2 n comparisons in all, where
+	// sifting down from the top takes about 2 n log2 n
+	const int N = 1 << 14;
+	std::vector<int> v(N);
+	std::iota(v.begin(), v.end(), 0);
+	std::shuffle(v.begin(), v.end(), gen);
+	std::make_heap(v.begin(), v.end());
+
+	long count = 0;
+	auto counting_less = [&count](int a, int b) {
+		++count;
+		return a < b;
+	};
+	stl2::sort_heap(v, counting_less);
+	CHECK(std::is_sorted(v.begin(), v.end()));
+	CHECK(count < 1.2 * N * 14);
+}
@@ -23,6 +23,7 @@
 //===----------------------------------------------------------------------===//
 
 #include <nanorange/algorithm/stable_partition.hpp>
+#include <nanorange/memory/scratch_arena.hpp>
 #include <array>
 #include <memory>
 #include <utility>
@@ -628,3 +629,32 @@ TEST_CASE("alg.stable_partition")
 		CHECK(std::is_partitioned(first, last, even));
 	}
 }
+
+#if NANO_HAS_MEMORY_RESOURCE
+TEST_CASE("alg.stable_partition.memory_resource")
+{
+	using P = std::pair<int, int>;
+	nano::scratch_arena arena;
+
+	P ap[] = { {0, 1}, {0, 2}, {1, 1}, {1, 2}, {2, 1}, {2, 2}, {3, 1}, {3, 2}, {4, 1}, {4, 2} };
+	auto r = ranges::stable_partition(&arena, ap, odd_first());
+	CHECK(r.begin() == ap + 4);
+	CHECK(r.end() == ap + 10);
+	CHECK(ap[0] == P{1, 1});
+	CHECK(ap[1] == P{1, 2});
+	CHECK(ap[2] == P{3, 1});
+	CHECK(ap[3] == P{3, 2});
+	CHECK(ap[4] == P{0, 1});
+	CHECK(ap[5] == P{0, 2});
+	CHECK(ap[6] == P{2, 1});
+	CHECK(ap[7] == P{2, 2});
+	CHECK(ap[8] == P{4, 1});
+	CHECK(ap[9] == P{4, 2});
+	CHECK(arena.capacity() != 0);
+
+	const auto cap = arena.capacity();
+	auto r2 = ranges::stable_partition(&arena, ap + 0, ap + 10, odd_first());
+	CHECK(r2.begin() == ap + 4);
+	CHECK(arena.capacity() == cap);
+}
+#endif
@@ -19,9 +19,12 @@
 //===----------------------------------------------------------------------===//
 
 #include <nanorange/algorithm/stable_sort.hpp>
+#include <nanorange/memory/scratch_arena.hpp>
 #include <cassert>
 #include <memory>
+#include <numeric>
 #include <random>
+#include <string>
 #include <vector>
 #include <algorithm>
 #include "../catch.hpp"
@@ -239,3 +242,175 @@ TEST_CASE("alg.stable_sort")
 		}
 	}
 }
+
+TEST_CASE("alg.stable_sort.runs")
+{
+	const int N = 10'000;
+	long comparisons = 0;
+	auto counting_less = [&](int a, int b) {
+		++comparisons;
+		return a < b;
+	};
+
+	// A single run, in either direction, is found with N - 1 comparisons
+	std::vector<int> v(N);
+	std::iota(v.begin(), v.end(), 0);
+	stl2::stable_sort(v, counting_less);
+	CHECK(comparisons == N - 1);
+	CHECK(std::is_sorted(v.begin(), v.end()));
+
+	comparisons = 0;
+	std::reverse(v.begin(), v.end());
+	stl2::stable_sort(v, counting_less);
+	CHECK(comparisons == N - 1);
+	CHECK(std::is_sorted(v.begin(), v.end()));
+
+	// Alternating ascending and descending runs of varying lengths, with
+	// plenty of equal keys both within and across runs. Only strictly
+	// descending runs may be reversed, or equal keys would change order.
+	std::vector<S> runs;
+	for (int len = 1, dir = 0; runs.size() < std::size_t(N); len = len * 3 % 997 + 1, dir ^= 1)
+	{
+		const int base = static_cast<int>(gen() % 100);
+		for (int k = 0; k < len; ++k)
+		{
+			const int key = dir ? base - k / 3 : base + k / 3;
+			runs.push_back(S{key, static_cast<int>(runs.size())});
+		}
+	}
+	auto expected = runs;
+	std::stable_sort(expected.begin(), expected.end(), [](const S& a, const S& b) {
+		return a.i < b.i;
+	});
+	stl2::stable_sort(runs, std::less<int>{}, &S::i);
+	for (std::size_t i = 0; i < runs.size(); ++i)
+	{
+		CHECK(runs[i].i == expected[i].i);
+		CHECK(runs[i].j == expected[i].j);
+	}
+
+	// A sorted sequence with a few elements out of place needs only a few
+	// comparisons more than a sorted one
+	std::iota(v.begin(), v.end(), 0);
+	for (int i = 0; i < 10; ++i)
+		std::swap(v[gen() % N], v[gen() % N]);
+	comparisons = 0;
+	stl2::stable_sort(v, counting_less);
+	CHECK(std::is_sorted(v.begin(), v.end()));
+	CHECK(comparisons < 2 * N);
+}
+
+TEST_CASE("alg.stable_sort.parallel")
+{
+	const worker_count_guard workers(4);
+	REQUIRE(nano::detail::task_pool::instance().concurrency() == 5);
+
+	std::vector<S> v(100'000, S{});
+	for (int i = 0; (std::size_t)i < v.size(); ++i)
+	{
+		v[i].i = static_cast<int>(gen() % 1000);
+		v[i].j = i;
+	}
+	auto expected = v;
+	std::stable_sort(expected.begin(), expected.end(), [](const S& a, const S& b) {
+		return a.i < b.i;
+	});
+
+	auto check_stable = [&](const std::vector<S>& result) {
+		REQUIRE(result.size() == expected.size());
+		for (std::size_t i = 0; i < result.size(); ++i)
+		{
+			CHECK(result[i].i == expected[i].i);
+			CHECK(result[i].j == expected[i].j);
+		}
+	};
+
+	{
+		auto v2 = v;
+		CHECK(stl2::stable_sort(stl2::execution::par, v2, std::less<int>{}, &S::i) == v2.end());
+		check_stable(v2);
+	}
+
+	{
+		auto v2 = v;
+		CHECK(stl2::stable_sort(stl2::execution::par_unseq, v2.begin(), v2.end(),
+		                        std::less<int>{}, &S::i) == v2.end());
+		check_stable(v2);
+	}
+
+	{
+		auto v2 = v;
+		CHECK(stl2::stable_sort(stl2::execution::seq, v2, std::less<int>{}, &S::i) == v2.end());
+		check_stable(v2);
+	}
+
+	// Check non-trivial types
+	{
+		std::vector<std::string> strs(50'000);
+		for (auto& s : strs)
+			s = std::to_string(gen() % 10000);
+		auto expected_strs = strs;
+		std::stable_sort(expected_strs.begin(), expected_strs.end());
+		stl2::stable_sort(stl2::execution::par, strs);
+		CHECK(strs == expected_strs);
+	}
+}
+
+#if NANO_HAS_MEMORY_RESOURCE
+TEST_CASE("alg.stable_sort.memory_resource")
+{
+	std::mt19937 gen;
+	std::vector<S> v(1000);
+	for (std::size_t i = 0; i < v.size(); ++i)
+	{
+		v[i].i = static_cast<int>(gen() % 10);
+		v[i].j = static_cast<int>(i);
+	}
+
+	nano::scratch_arena arena;
+	for (int n = 0; n < 3; ++n)
+	{
+		auto v2 = v;
+		CHECK(stl2::stable_sort(&arena, v2, std::less<int>{}, &S::i) == v2.end());
+		CHECK(std::is_sorted(v2.begin(), v2.end(), [](const S& a, const S& b) {
+			return a.i < b.i || (a.i == b.i && a.j < b.j);
+		}));
+		CHECK(arena.capacity() == v.size() / 2 * sizeof(S));
+	}
+
+	{
+		auto v2 = v;
+		CHECK(stl2::stable_sort(stl2::execution::par, &arena, v2.begin(), v2.end(),
+		                        std::less<int>{}, &S::i) == v2.end());
+		CHECK(std::is_sorted(v2.begin(), v2.end(), [](const S& a, const S& b) {
+			return a.i < b.i || (a.i == b.i && a.j < b.j);
+		}));
+		CHECK(arena.capacity() == v.size() / 2 * sizeof(S));
+	}
+
+	// If the parallel sort can't get room for every element, the sequential
+	// sort it falls back to still takes its buffer from the resource
+	{
+		const worker_count_guard workers(4);
+		std::vector<S> big(50'000);
+		for (std::size_t i = 0; i < big.size(); ++i)
+		{
+			big[i].i = static_cast<int>(gen() % 1000);
+			big[i].j = static_cast<int>(i);
+		}
+
+		const std::size_t half = big.size() / 2 * sizeof(S);
+		std::vector<unsigned char> storage(half + alignof(std::max_align_t));
+		std::pmr::monotonic_buffer_resource upstream(
+			storage.data(), storage.size(), std::pmr::null_memory_resource());
+		nano::scratch_arena small_arena(&upstream);
+
+		CHECK(stl2::stable_sort(stl2::execution::par, &small_arena, big,
+		                        std::less<int>{}, &S::i) == big.end());
+		CHECK(std::is_sorted(big.begin(), big.end(), [](const S& a, const S& b) {
+			return a.i < b.i || (a.i == b.i && a.j < b.j);
+		}));
+		CHECK(small_arena.capacity() == half);
+	}
+}
+#endif
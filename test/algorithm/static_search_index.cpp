@@ -0,0 +1,157 @@
+// nanorange/test/algorithm/static_search_index.cpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <nanorange/algorithm/static_search_index.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <list>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../catch.hpp"
+
+namespace {
+
+std::mt19937 gen;
+
+constexpr nano::search_index_layout layouts[] = {
+    nano::search_index_layout::eytzinger, nano::search_index_layout::btree};
+
+template <typename T>
+void check_index(const std::vector<T>& keys, const std::vector<T>& queries)
+{
+    for (auto layout : layouts) {
+        const nano::static_search_index index(keys, layout);
+        REQUIRE(index.size() == keys.size());
+        CHECK(index.layout() == layout);
+
+        for (const auto& q : queries) {
+            const auto lb = std::lower_bound(keys.begin(), keys.end(), q);
+            const auto ub = std::upper_bound(keys.begin(), keys.end(), q);
+            CHECK(index.lower_bound(q) ==
+                  static_cast<std::size_t>(lb - keys.begin()));
+            CHECK(index.upper_bound(q) ==
+                  static_cast<std::size_t>(ub - keys.begin()));
+            CHECK(index.contains(q) == (lb != ub));
+        }
+    }
+}
+
+}
+
+TEST_CASE("alg.static_search_index")
+{
+    // Every tree shape up to a few levels of each layout, so that every
+    // node of the incomplete bottom levels is looked up
+    for (int n = 0; n < 300; ++n) {
+        std::vector<int> keys(n);
+        for (int i = 0; i < n; ++i) {
+            keys[i] = 2 * i;
+        }
+        std::vector<int> queries(2 * n + 3);
+        for (int i = 0; i < 2 * n + 3; ++i) {
+            queries[i] = i - 1;
+        }
+        check_index(keys, queries);
+    }
+}
+
+TEST_CASE("alg.static_search_index.duplicates")
+{
+    for (int n : {1, 17, 100, 1000, 5000}) {
+        for (int max : {0, 3, 100}) {
+            std::vector<int> keys(n);
+            std::uniform_int_distribution<int> dist(0, max);
+            std::generate(keys.begin(), keys.end(), [&] { return dist(gen); });
+            std::sort(keys.begin(), keys.end());
+
+            std::vector<int> queries;
+            for (int q = -1; q <= max + 1; ++q) {
+                queries.push_back(q);
+            }
+            check_index(keys, queries);
+        }
+    }
+}
+
+TEST_CASE("alg.static_search_index.types")
+{
+    // Keys of several sizes, which use different B-tree node widths
+    std::vector<long long> wide(1000);
+    std::vector<std::string> strings(1000);
+    for (int i = 0; i < 1000; ++i) {
+        wide[i] = 3LL * i;
+        strings[i] = std::to_string(100000 + 3 * i);
+    }
+    std::vector<long long> wide_queries;
+    std::vector<std::string> string_queries;
+    for (int i = -1; i < 3001; ++i) {
+        wide_queries.push_back(i);
+        string_queries.push_back(std::to_string(100000 + i));
+    }
+    check_index(wide, wide_queries);
+    check_index(strings, string_queries);
+}
+
+TEST_CASE("alg.static_search_index.comparator")
+{
+    std::vector<int> keys{9, 7, 7, 5, 3, 1};
+
+    for (auto layout : layouts) {
+        const nano::static_search_index index(keys, layout, std::greater<>{});
+        CHECK(index.lower_bound(10) == 0);
+        CHECK(index.lower_bound(7) == 1);
+        CHECK(index.upper_bound(7) == 3);
+        CHECK(index.lower_bound(4) == 4);
+        CHECK(index.lower_bound(0) == 6);
+        CHECK(index.contains(5));
+        CHECK(!index.contains(6));
+    }
+}
+
+TEST_CASE("alg.static_search_index.projection")
+{
+    // Positions map back into the original range, so they can be used to
+    // find the rest of the record
+    struct record {
+        int id;
+        std::string name;
+    };
+    const std::list<record> records{{1, "one"}, {3, "three"}, {4, "four"},
+                                    {8, "eight"}};
+    const std::vector<record> vec(records.begin(), records.end());
+
+    for (auto layout : layouts) {
+        const nano::static_search_index index(records, layout, nano::less{},
+                                              &record::id);
+        static_assert(std::is_same<decltype(index),
+                                   const nano::static_search_index<int>>::value,
+                      "");
+        CHECK(vec[index.lower_bound(4)].name == "four");
+        CHECK(vec[index.lower_bound(5)].name == "eight");
+        CHECK(index.lower_bound(9) == index.size());
+        CHECK(!index.contains(2));
+    }
+}
+
+TEST_CASE("alg.static_search_index.empty")
+{
+    const nano::static_search_index<int> def;
+    CHECK(def.empty());
+    CHECK(def.lower_bound(1) == 0);
+    CHECK(!def.contains(1));
+
+    for (auto layout : layouts) {
+        const nano::static_search_index index(std::vector<int>{}, layout);
+        CHECK(index.empty());
+        CHECK(index.lower_bound(1) == 0);
+        CHECK(index.upper_bound(1) == 0);
+        CHECK(!index.contains(1));
+    }
+}
@@ -10,6 +10,9 @@
 // Project home: https://github.com/caseycarter/cmcstl2
 //
 #include <nanorange/algorithm/transform.hpp>
+#include <forward_list>
+#include <numeric>
+#include <vector>
 #include "../test_utils.hpp"
 
 #include "../catch.hpp"
@@ -50,3 +53,62 @@ TEST_CASE("alg.transform") {
 		}
 	}
 }
+
+TEST_CASE("alg.transform.parallel")
+{
+	std::vector<int> in1(200'000);
+	std::iota(in1.begin(), in1.end(), 0);
+	std::vector<long> in2(in1.rbegin(), in1.rend());
+	auto twice = [](int i) { return 2L * i; };
+
+	{
+		std::vector<long> out(in1.size());
+		auto result = ranges::transform(ranges::execution::par, in1, out.begin(), twice);
+		CHECK(result.in == in1.end());
+		CHECK(result.out == out.end());
+		for (std::size_t i = 0; i < out.size(); ++i)
+			REQUIRE(out[i] == 2L * in1[i]);
+	}
+
+	{
+		std::vector<long> out(in1.size());
+		auto result = ranges::transform(ranges::execution::par_unseq, in1.begin(), in1.end(),
+		                                out.begin(), twice);
+		CHECK(result.in == in1.end());
+		CHECK(result.out == out.end());
+		for (std::size_t i = 0; i < out.size(); ++i)
+			REQUIRE(out[i] == 2L * in1[i]);
+	}
+
+	{
+		// The shorter input determines the length
+		std::vector<long> out(in1.size());
+		auto result = ranges::transform(ranges::execution::par, in1.begin(), in1.end(),
+		                                in2.begin(), in2.end() - 10, out.begin(), std::plus<>{});
+		CHECK(result.in1 == in1.end() - 10);
+		CHECK(result.in2 == in2.end() - 10);
+		CHECK(result.out == out.end() - 10);
+		for (std::size_t i = 0; i + 10 < out.size(); ++i)
+			REQUIRE(out[i] == static_cast<long>(in1.size()) - 1);
+		CHECK(out.back() == 0);
+	}
+
+	{
+		std::vector<long> out(in1.size());
+		auto result = ranges::transform(ranges::execution::seq, in1, in2, out.begin(), std::minus<>{});
+		CHECK(result.in1 == in1.end());
+		CHECK(result.in2 == in2.end());
+		CHECK(result.out == out.end());
+		CHECK(out.front() == -(static_cast<long>(in1.size()) - 1));
+		CHECK(out.back() == static_cast<long>(in1.size()) - 1);
+	}
+
+	{
+		// Not random-access, so processed sequentially
+		std::forward_list<int> l{1, 2, 3};
+		std::vector<long> out(3);
+		auto result = ranges::transform(ranges::execution::par, l, out.begin(), twice);
+		CHECK(result.in == l.end());
+		CHECK(out == std::vector<long>{2, 4, 6});
+	}
+}
@@ -0,0 +1,76 @@
+// nanorange/test/algorithm/transform_reduce.cpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <nanorange/algorithm/transform_reduce.hpp>
+
+#include <forward_list>
+#include <functional>
+#include <numeric>
+#include <vector>
+
+#include "../catch.hpp"
+
+namespace {
+
+struct S {
+	int i;
+};
+
+constexpr int square(int i) { return i * i; }
+
+constexpr int inner_product()
+{
+	int a[] = {1, 2, 3};
+	int b[] = {4, 5, 6};
+	return nano::transform_reduce(a, b, 0) +
+	       nano::transform_reduce(a, 0, std::plus<>{}, square);
+}
+
+static_assert(inner_product() == 32 + 14);
+
+}
+
+TEST_CASE("alg.transform_reduce")
+{
+	std::vector<int> a{1, 2, 3, 4};
+	std::vector<int> b{5, 6, 7};
+
+	// Unary
+	CHECK(nano::transform_reduce(a.begin(), a.end(), 0, std::plus<>{}, square) == 30);
+	CHECK(nano::transform_reduce(a, 1, std::multiplies<>{}, square) == 576);
+
+	std::vector<S> vs{{1}, {2}, {3}};
+	CHECK(nano::transform_reduce(vs, 0, std::plus<>{}, square, &S::i) == 14);
+
+	// Binary, stopping at the end of the shorter range
+	CHECK(nano::transform_reduce(a.begin(), a.end(), b.begin(), b.end(), 0) == 38);
+	CHECK(nano::transform_reduce(a, b, 0) == 38);
+	CHECK(nano::transform_reduce(a, b, 0, std::plus<>{}, std::plus<>{}) == 24);
+	CHECK(nano::transform_reduce(vs, a, 0, std::plus<>{}, std::multiplies<>{}, &S::i) == 14);
+
+	std::forward_list<int> l{1, 2, 3};
+	CHECK(nano::transform_reduce(l, a, 10) == 24);
+}
+
+TEST_CASE("alg.transform_reduce.parallel")
+{
+	std::vector<int> a(1'000'000);
+	std::iota(a.begin(), a.end(), 0);
+	std::vector<long long> b(a.size(), 2);
+	const long long sum = 999'999LL * 1'000'000LL / 2;
+
+	auto widen = [](int i) { return static_cast<long long>(i); };
+	CHECK(nano::transform_reduce(nano::execution::par, a, 0LL, std::plus<>{}, widen) == sum);
+	CHECK(nano::transform_reduce(nano::execution::par_unseq, a.begin(), a.end(), 0LL,
+	                             std::plus<>{}, widen) == sum);
+	CHECK(nano::transform_reduce(nano::execution::par, a, b, 0LL) == 2 * sum);
+	CHECK(nano::transform_reduce(nano::execution::par, a.begin(), a.end(), b.begin(),
+	                             b.end() - 1, 0LL) == 2 * (sum - 999'999));
+	CHECK(nano::transform_reduce(nano::execution::seq, a, b, 0LL) == 2 * sum);
+
+	std::forward_list<int> l{1, 2, 3};
+	CHECK(nano::transform_reduce(nano::execution::par, l, a, 0LL) == 8);
+}
@@ -0,0 +1,93 @@
+// nanorange/test/memory/scratch_arena.cpp
+//
+// Copyright (c) 2018 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <nanorange/memory/scratch_arena.hpp>
+#include "../catch.hpp"
+
+#if NANO_HAS_MEMORY_RESOURCE
+
+namespace {
+
+struct counting_resource : std::pmr::memory_resource {
+	int allocations = 0;
+	int deallocations = 0;
+
+private:
+	void* do_allocate(std::size_t bytes, std::size_t align) override
+	{
+		++allocations;
+		return std::pmr::new_delete_resource()->allocate(bytes, align);
+	}
+
+	void do_deallocate(void* p, std::size_t bytes, std::size_t align) override
+	{
+		++deallocations;
+		std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+	}
+
+	bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+	{
+		return this == &other;
+	}
+};
+
+}
+
+TEST_CASE("memory.scratch_arena")
+{
+	counting_resource upstream;
+
+	{
+		nano::scratch_arena arena(&upstream);
+		CHECK(arena.capacity() == 0);
+		CHECK(arena.upstream_resource() == &upstream);
+
+		// The first allocation goes upstream, and the block is then reused
+		void* p = arena.allocate(100);
+		CHECK(upstream.allocations == 1);
+		CHECK(arena.capacity() == 100);
+		arena.deallocate(p, 100);
+		CHECK(upstream.deallocations == 0);
+
+		void* q = arena.allocate(50);
+		CHECK(q == p);
+		CHECK(upstream.allocations == 1);
+
+		// While the block is in use, other requests are passed upstream
+		void* r = arena.allocate(10);
+		CHECK(r != q);
+		CHECK(upstream.allocations == 2);
+		arena.deallocate(r, 10);
+		CHECK(upstream.deallocations == 1);
+		arena.deallocate(q, 50);
+
+		// A larger request replaces the block
+		p = arena.allocate(200);
+		CHECK(upstream.allocations == 3);
+		CHECK(upstream.deallocations == 2);
+		CHECK(arena.capacity() == 200);
+		arena.deallocate(p, 200);
+
+		arena.release();
+		CHECK(arena.capacity() == 0);
+		CHECK(upstream.deallocations == 3);
+
+		arena.deallocate(arena.allocate(10), 10);
+		CHECK(upstream.allocations == 4);
+	}
+	CHECK(upstream.deallocations == 4);
+
+	{
+		nano::scratch_arena arena(64, &upstream);
+		CHECK(arena.capacity() == 64);
+		CHECK(upstream.allocations == 5);
+		arena.deallocate(arena.allocate(64), 64);
+		CHECK(upstream.allocations == 5);
+	}
+	CHECK(upstream.deallocations == 5);
+}
+
+#endif
@@ -1,6 +1,7 @@
 
 #pragma once
 
+#include <nanorange/detail/execution/task_pool.hpp>
 #include <nanorange/views/subrange.hpp>
 
 #include "catch.hpp"
@@ -121,4 +122,19 @@ template <bool RvalueOK1 = false, bool RvalueOK2 = false, typename Algo>
 test_range_algo_2<Algo, RvalueOK1, RvalueOK2> make_testable_2(Algo algo)
 {
     return test_range_algo_2<Algo, RvalueOK1, RvalueOK2>{algo};
-}
\ No newline at end of file
+}
+
+// Gives the thread pool used by the parallel algorithms the given number of
+// worker threads for the lifetime of the guard, so that they run concurrently
+// even on a single-core machine
+struct worker_count_guard {
+    explicit worker_count_guard(std::ptrdiff_t workers)
+    {
+        nano::detail::task_pool::set_worker_count(workers);
+    }
+
+    worker_count_guard(const worker_count_guard&) = delete;
+    worker_count_guard& operator=(const worker_count_guard&) = delete;
+
+    ~worker_count_guard() { nano::detail::task_pool::set_worker_count(-1); }
+};
@@ -0,0 +1,145 @@
+// nanorange/test/views/mapped_file_view.cpp
+//
+// Copyright (c) 2019 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <nanorange/views/mapped_file.hpp>
+#include <nanorange/algorithm/count.hpp>
+#include <nanorange/algorithm/find.hpp>
+#include <nanorange/algorithm/is_sorted.hpp>
+#include <nanorange/algorithm/search.hpp>
+#include <nanorange/algorithm/sort.hpp>
+#include <nanorange/views/split.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <system_error>
+#include <vector>
+#include "../catch.hpp"
+#include "../test_utils.hpp"
+
+#if NANO_HAS_MMAP
+
+using namespace nano;
+
+namespace {
+
+// Writes the given bytes to a new temporary file, which is removed again when
+// the object is destroyed
+struct temp_file {
+    explicit temp_file(const void* bytes, std::size_t size)
+    {
+        const int fd = ::mkstemp(&path[0]);
+        REQUIRE(fd >= 0);
+        REQUIRE(::write(fd, bytes, size) == static_cast<ssize_t>(size));
+        ::close(fd);
+    }
+
+    explicit temp_file(const std::string& contents)
+        : temp_file(contents.data(), contents.size())
+    {}
+
+    ~temp_file() { std::remove(path.c_str()); }
+
+    std::string path = "/tmp/nanorange_mapped_file_XXXXXX";
+};
+
+}
+
+static_assert(contiguous_range<mapped_file_view<const char>>, "");
+static_assert(sized_range<mapped_file_view<const char>>, "");
+static_assert(borrowed_range<mapped_file_view<const char>>, "");
+static_assert(view<mapped_file_view<>>, "");
+static_assert(same_as<range_value_t<mapped_file_view<>>, std::byte>, "");
+static_assert(!constructible_from<mapped_file_view<const char>, mapped_file>, "");
+
+TEST_CASE("views.mapped_file")
+{
+    const std::string text = "first line\nsecond line\nthird\n";
+    temp_file file{text};
+
+    mapped_file map{file.path};
+    CHECK(map.size() == text.size());
+    CHECK(map.mode() == mapped_file_mode::read_only);
+
+    mapped_file_view<const char> chars{map};
+    CHECK(chars.size() == static_cast<std::ptrdiff_t>(text.size()));
+    ::check_equal(chars, text);
+
+    CHECK(nano::find(chars, 's') == chars.begin() + text.find('s'));
+    CHECK(nano::count(chars, '\n') == 3);
+    const std::string needle = "line";
+    CHECK(nano::search(chars, needle).begin() ==
+          chars.begin() + text.find(needle));
+
+    std::vector<std::string> lines;
+    for (auto line : chars | views::split('\n')) {
+        std::string str;
+        for (char c : line) {
+            str.push_back(c);
+        }
+        lines.push_back(str);
+    }
+    CHECK(lines == std::vector<std::string>{"first line", "second line",
+                                            "third"});
+
+    // Moving the mapped_file leaves views valid
+    mapped_file moved = std::move(map);
+    CHECK(map.data() == nullptr);
+    CHECK(moved.data() == reinterpret_cast<const std::byte*>(chars.data()));
+    CHECK(mapped_file_view<const char>{moved}.front() == 'f');
+}
+
+TEST_CASE("views.mapped_file.copy_on_write")
+{
+    const std::vector<int> ints{5, 3, 9, 1, 7, 2};
+    temp_file file{ints.data(), ints.size() * sizeof(int)};
+
+    // Only copy-on-write mappings can be viewed as mutable
+    {
+        mapped_file map{file.path};
+        CHECK_THROWS_AS(mapped_file_view<int>{map}, std::invalid_argument);
+    }
+
+    {
+        mapped_file map{file.path, mapped_file_mode::copy_on_write};
+        mapped_file_view<int> view{map};
+        CHECK(view.size() == 6);
+        nano::sort(view);
+        CHECK(nano::is_sorted(view));
+        CHECK(view.front() == 1);
+        CHECK(view.back() == 9);
+    }
+
+    // The file itself is unchanged
+    mapped_file map{file.path};
+    ::check_equal(mapped_file_view<const int>{map}, ints);
+}
+
+TEST_CASE("views.mapped_file.edge_cases")
+{
+    // Empty files give empty views
+    {
+        temp_file file{""};
+        mapped_file map{file.path};
+        CHECK(map.size() == 0);
+        CHECK(mapped_file_view<const int>{map}.empty());
+    }
+
+    // Trailing bytes which do not make up a whole element are ignored
+    {
+        temp_file file{"abcdefghij"};
+        mapped_file map{file.path};
+        CHECK(mapped_file_view<const std::int32_t>{map}.size() == 2);
+    }
+
+    // Default-constructed views are empty
+    CHECK(mapped_file_view<>{}.empty());
+
+    CHECK_THROWS_AS(mapped_file{"/nonexistent/nanorange"}, std::system_error);
+}
+
+#endif // NANO_HAS_MMAP
@@ -0,0 +1,140 @@
+// nanorange/test/views/parse_view.cpp
+//
+// Copyright (c) 2019 Tristan Brindle (tcbrindle at gmail dot com)
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <nanorange/views/parse.hpp>
+#include <nanorange/views/take.hpp>
+#include <nanorange/views/transform.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../catch.hpp"
+#include "../test_utils.hpp"
+
+#if NANO_HAS_CHARCONV
+
+using namespace nano;
+
+namespace {
+
+template <typename T, typename Rng>
+std::vector<T> to_vector(Rng&& rng)
+{
+    std::vector<T> vec;
+    for (auto&& t : rng) {
+        vec.push_back(t);
+    }
+    return vec;
+}
+
+}
+
+static_assert(input_range<parse_view<int>>, "");
+static_assert(view<parse_view<double>>, "");
+static_assert(!forward_range<parse_view<int>>, "");
+
+TEST_CASE("views.parse")
+{
+    // Any whitespace separates numbers
+    {
+        std::istringstream ss{"  1 -2\t+3\n\n40\r\n 500 "};
+        parse_view<int> view{ss};
+        CHECK(to_vector<int>(view) == std::vector<int>{1, -2, 3, 40, 500});
+        CHECK_FALSE(view.failed());
+    }
+
+    {
+        std::istringstream ss{"1.5 -0.25 1e3 +2"};
+        parse_view<double> view{ss};
+        CHECK(to_vector<double>(view) ==
+              std::vector<double>{1.5, -0.25, 1000.0, 2.0});
+    }
+
+    // Tokens can straddle reads, and may be longer than the buffer
+    {
+        std::string input;
+        std::vector<long long> expected;
+        for (long long i = 0; i < 1000; ++i) {
+            expected.push_back(i * i * 7919);
+            input += std::to_string(expected.back()) + (i % 3 ? " " : "\n");
+        }
+        std::istringstream ss{input};
+        parse_view<long long> view{ss, 3};
+        CHECK(to_vector<long long>(view) == expected);
+        CHECK_FALSE(view.failed());
+    }
+
+    {
+        std::istringstream ss{"1.5e3 -2.5E-1 12345.0625 +7"};
+        parse_view<double> view{ss, 4};
+        CHECK(to_vector<double>(view) ==
+              std::vector<double>{1500.0, -0.25, 12345.0625, 7.0});
+    }
+
+    // Iteration stops at the first invalid token
+    {
+        std::istringstream ss{"1 2 -"};
+        parse_view<int> view{ss, 2};
+        CHECK(to_vector<int>(view) == std::vector<int>{1, 2});
+        CHECK(view.failed());
+    }
+
+    {
+        std::istringstream ss{"1 2 3x 4"};
+        parse_view<int> view{ss};
+        CHECK(to_vector<int>(view) == std::vector<int>{1, 2});
+        CHECK(view.failed());
+    }
+
+    {
+        std::istringstream ss{"100 300"};
+        parse_view<std::int8_t> view{ss};
+        CHECK(to_vector<int>(view) == std::vector<int>{100});
+        CHECK(view.failed());
+    }
+
+    // Default-constructed parse_views are empty
+    {
+        parse_view<int> view{};
+        CHECK(nano::distance(view) == 0);
+        CHECK_FALSE(view.failed());
+    }
+
+    // Works with other views
+    {
+        std::istringstream ss{"1 2 3 4 5"};
+        auto rng = parse_view<int>{ss} | views::transform([](int i) { return i * 10; })
+                   | views::take(3);
+        CHECK(to_vector<int>(rng) == std::vector<int>{10, 20, 30});
+    }
+
+    // Reads from a streambuf directly
+    {
+        std::stringbuf buf{"7 8 9"};
+        ::check_equal(parse_view<unsigned>{buf}, {7u, 8u, 9u});
+    }
+}
+
+#if NANO_HAS_POSIX_READ
+TEST_CASE("views.parse.fd")
+{
+    std::FILE* file = std::tmpfile();
+    REQUIRE(file != nullptr);
+    std::fputs("3.25\n-1\n   8e-1", file);
+    std::fflush(file);
+    std::rewind(file);
+
+    parse_view<float> view{from_fd, fileno(file), 4};
+    CHECK(to_vector<float>(view) == std::vector<float>{3.25f, -1.0f, 0.8f});
+    CHECK_FALSE(view.failed());
+
+    std::fclose(file);
+}
+#endif
+
+#endif // NANO_HAS_CHARCONV